@@ -101,14 +101,47 @@ size_t count_if(InputIter first, InputIter last, UnaryPredicate unary_pred)
 // 在[first, last)区间内找到等于 value 的元素，返回指向该元素的迭代器
 /*****************************************************************************************/
 template <class InputIter, class T>
-InputIter//返回值
-find(InputIter first, InputIter last, const T& value)
+InputIter
+find_dispatch(InputIter first, InputIter last, const T& value, m_false_type)
 {
   while (first != last && *first != value)
     ++first;
   return first;
 }
 
+// 分段迭代器逐段在原生指针上查找，找到后再还原成迭代器
+template <class InputIter, class T>
+InputIter
+find_dispatch(InputIter first, InputIter last, const T& value, m_true_type)
+{
+  typedef segmented_iterator_traits<InputIter> traits;
+  auto sfirst = traits::segment(first);
+  const auto slast = traits::segment(last);
+  if (sfirst == slast)
+  {
+    auto p = find_dispatch(traits::local(first), traits::local(last), value, m_false_type());
+    return p == traits::local(last) ? last : traits::compose(sfirst, p);
+  }
+  auto p = find_dispatch(traits::local(first), traits::end(sfirst), value, m_false_type());
+  if (p != traits::end(sfirst))
+    return traits::compose(sfirst, p);
+  for (++sfirst; sfirst != slast; ++sfirst)
+  {
+    p = find_dispatch(traits::begin(sfirst), traits::end(sfirst), value, m_false_type());
+    if (p != traits::end(sfirst))
+      return traits::compose(sfirst, p);
+  }
+  p = find_dispatch(traits::begin(slast), traits::local(last), value, m_false_type());
+  return p == traits::local(last) ? last : traits::compose(slast, p);
+}
+
+template <class InputIter, class T>
+InputIter//返回值
+find(InputIter first, InputIter last, const T& value)
+{
+  return find_dispatch(first, last, value, is_segmented_iterator<InputIter>());
+}
+
 /*****************************************************************************************/
 // find_if
 // 在[first, last)区间内找到第一个令一元操作 unary_pred 为 true 的元素并返回指向该元素的迭代器
@@ -479,7 +512,7 @@ find_first_of(InputIter first1, InputIter last1,
 // f() 可返回一个值，但该值会被忽略
 /*****************************************************************************************/
 template <class InputIter, class Function>
-Function for_each(InputIter first, InputIter last, Function f)//迭代器不会对元素进行写操作，只会通过f操作
+Function for_each_dispatch(InputIter first, InputIter last, Function f, m_false_type)
 {
   for (; first != last; ++first)
   {
@@ -488,6 +521,40 @@ Function for_each(InputIter first, InputIter last, Function f)//迭代器不会
   return f;
 }
 
+// 分段迭代器逐段在原生指针上执行，lambda 不能赋值，所以段内以引用传递 f
+template <class LocalIter, class Function>
+void for_each_segment(LocalIter first, LocalIter last, Function& f)
+{
+  for (; first != last; ++first)
+  {
+    f(*first);
+  }
+}
+
+template <class InputIter, class Function>
+Function for_each_dispatch(InputIter first, InputIter last, Function f, m_true_type)
+{
+  typedef segmented_iterator_traits<InputIter> traits;
+  auto sfirst = traits::segment(first);
+  const auto slast = traits::segment(last);
+  if (sfirst == slast)
+  {
+    for_each_segment(traits::local(first), traits::local(last), f);
+    return f;
+  }
+  for_each_segment(traits::local(first), traits::end(sfirst), f);
+  for (++sfirst; sfirst != slast; ++sfirst)
+    for_each_segment(traits::begin(sfirst), traits::end(sfirst), f);
+  for_each_segment(traits::begin(slast), traits::local(last), f);
+  return f;
+}
+
+template <class InputIter, class Function>
+Function for_each(InputIter first, InputIter last, Function f)//迭代器不会对元素进行写操作，只会通过f操作
+{
+  return for_each_dispatch(first, last, f, is_segmented_iterator<InputIter>());
+}
+
 /*****************************************************************************************/
 // adjacent_find
 // 找出第一对匹配的相邻元素，缺省使用 operator== 比较，如果找到返回一个迭代器，指向这对元素的第一个元素
@@ -1543,7 +1610,7 @@ rotate_dispatch(RandomIter first, RandomIter middle,
   auto cycle_times = rgcd(n, l);
   for (auto i = 0; i < cycle_times; ++i)
   {
-    auto tmp = *first;
+    typename iterator_traits<RandomIter>::value_type tmp = *first;
     auto p = first;
     if (l < r)
     {
@@ -1613,8 +1680,8 @@ bool is_permutation_aux(ForwardIter1 first1, ForwardIter1 last1,
     && mystl::is_random_access_iterator<ForwardIter2>::value;
   if (is_ra_it)
   {
-    auto len1 = last1 - first1;
-    auto len2 = last2 - first2;
+    auto len1 = mystl::distance(first1, last1);
+    auto len2 = mystl::distance(first2, last2);
     if (len1 != len2)
       return false;
   }
@@ -2194,7 +2261,7 @@ void partial_sort(RandomIter first, RandomIter middle,
   {
     if (*i < *first)
     {
-      mystl::pop_heap_aux(first, middle, i, *i, distance_type(first));
+      mystl::pop_heap_aux(first, middle, i, typename iterator_traits<RandomIter>::value_type(*i), distance_type(first));
     }
   }
   mystl::sort_heap(first, middle);
@@ -2210,7 +2277,8 @@ void partial_sort(RandomIter first, RandomIter middle,
   {
     if (comp(*i, *first))
     {
-      mystl::pop_heap_aux(first, middle, i, *i, distance_type(first), comp);
+      mystl::pop_heap_aux(first, middle, i, typename iterator_traits<RandomIter>::value_type(*i),
+                          distance_type(first), comp);
     }
   }
   mystl::sort_heap(first, middle, comp);
@@ -2400,7 +2468,8 @@ void intro_sort(RandomIter first, RandomIter last, Size depth_limit)
       return;
     }
     --depth_limit;
-    auto mid = mystl::median(*(first), *(first + (last - first) / 2), *(last - 1));
+    typename iterator_traits<RandomIter>::value_type mid =
+      mystl::median(*(first), *(first + (last - first) / 2), *(last - 1));
     auto cut = mystl::unchecked_partition(first, last, mid);
     mystl::intro_sort(cut, last, depth_limit);
     last = cut;
@@ -2427,8 +2496,9 @@ template <class RandomIter>
 void unchecked_insertion_sort(RandomIter first, RandomIter last)
 {
   for (auto i = first; i != last; ++i)
-  {
-    mystl::unchecked_linear_insert(i, *i);
+  { // 先复制出来，后移元素时会覆盖 *i
+    typename iterator_traits<RandomIter>::value_type value = *i;
+    mystl::unchecked_linear_insert(i, value);
   }
 }
 
@@ -2440,7 +2510,7 @@ void insertion_sort(RandomIter first, RandomIter last)
     return;
   for (auto i = first + 1; i != last; ++i)
   {
-    auto value = *i;
+    typename iterator_traits<RandomIter>::value_type value = *i;
     if (value < *first)
     {
       mystl::copy_backward(first, i, i + 1);
@@ -2513,7 +2583,8 @@ void intro_sort(RandomIter first, RandomIter last,
       return;
     }
     --depth_limit;
-    auto mid = mystl::median(*(first), *(first + (last - first) / 2), *(last - 1));
+    typename iterator_traits<RandomIter>::value_type mid =
+      mystl::median(*(first), *(first + (last - first) / 2), *(last - 1), comp);
     auto cut = mystl::unchecked_partition(first, last, mid, comp);
     mystl::intro_sort(cut, last, depth_limit, comp);
     last = cut;
@@ -2542,7 +2613,8 @@ void unchecked_insertion_sort(RandomIter first, RandomIter last,
 {
   for (auto i = first; i != last; ++i)
   {
-    mystl::unchecked_linear_insert(i, *i, comp);
+    typename iterator_traits<RandomIter>::value_type value = *i;
+    mystl::unchecked_linear_insert(i, value, comp);
   }
 }
 
@@ -2554,7 +2626,7 @@ void insertion_sort(RandomIter first, RandomIter last, Compared comp)
     return;
   for (auto i = first + 1; i != last; ++i)
   {
-    auto value = *i;
+    typename iterator_traits<RandomIter>::value_type value = *i;
     if (comp(value, *first))
     {
       mystl::copy_backward(first, i, i + 1);
@@ -2662,7 +2734,7 @@ OutputIter
 unique_copy_dispatch(InputIter first, InputIter last,
                      OutputIter result, output_iterator_tag)
 {
-  auto value = *first;
+  typename iterator_traits<InputIter>::value_type value = *first;
   *result = value;
   while (++first != last)
   {
@@ -2707,7 +2779,7 @@ OutputIter
 unique_copy_dispatch(InputIter first, InputIter last,
                      OutputIter result, output_iterator_tag, Compared comp)
 {
-  auto value = *first;
+  typename iterator_traits<InputIter>::value_type value = *first;
   *result = value;
   while (++first != last)
   {
@@ -60,11 +60,25 @@ const T& min(const T& lhs, const T& rhs, Compare comp)
 // 将两个迭代器所指对象对调
 /*****************************************************************************************/
 template <class FIter1, class FIter2>
-void iter_swap(FIter1 lhs, FIter2 rhs)
+void iter_swap_dispatch(FIter1 lhs, FIter2 rhs, m_true_type)
 {
   mystl::swap(*lhs, *rhs);
 }
 
+// 解引用得到的是代理对象（如 soa_vector 的迭代器）而不是左值，由代理对象的 swap 交换所指的元素
+template <class FIter1, class FIter2>
+void iter_swap_dispatch(FIter1 lhs, FIter2 rhs, m_false_type)
+{
+  (*lhs).swap(*rhs);
+}
+
+template <class FIter1, class FIter2>
+void iter_swap(FIter1 lhs, FIter2 rhs)
+{
+  mystl::iter_swap_dispatch(lhs, rhs, m_bool_constant<
+    std::is_lvalue_reference<decltype(*lhs)>::value>());
+}
+
 /*****************************************************************************************/
 // copy
 // 把 [first, last)区间内的元素拷贝到 [result, result + (last - first))内
@@ -128,10 +142,83 @@ unchecked_copy(Tp* first, Tp* last, Up* result)
   return result + n;
 }
 
+// 输出为分段迭代器时，若输入是随机迭代器，按输出的每一段切分输入，每段内写入原生指针
 template <class InputIter, class OutputIter>
-OutputIter copy(InputIter first, InputIter last, OutputIter result)
+OutputIter 
+copy_to_segments_cat(InputIter first, InputIter last, OutputIter result,
+                     mystl::input_iterator_tag)
 {
   return unchecked_copy(first, last, result);
+}
+
+template <class RandomIter, class OutputIter>
+OutputIter 
+copy_to_segments_cat(RandomIter first, RandomIter last, OutputIter result,
+                     mystl::random_access_iterator_tag)
+{
+  typedef segmented_iterator_traits<OutputIter> traits;
+  auto n = last - first;
+  if (n <= 0)
+    return result;
+  auto seg = traits::segment(result);
+  auto cur = traits::local(result);
+  for (;;)
+  {
+    const auto room = traits::end(seg) - cur;
+    const auto len = n < room ? n : room;
+    cur = unchecked_copy(first, first + len, cur);
+    first += len;
+    n -= len;
+    if (n == 0)
+      break;
+    ++seg;
+    cur = traits::begin(seg);
+  }
+  return traits::compose(seg, cur);
+}
+
+template <class InputIter, class OutputIter>
+OutputIter 
+copy_to_segments(InputIter first, InputIter last, OutputIter result, m_false_type)
+{
+  return unchecked_copy(first, last, result);
+}
+
+template <class InputIter, class OutputIter>
+OutputIter 
+copy_to_segments(InputIter first, InputIter last, OutputIter result, m_true_type)
+{
+  return copy_to_segments_cat(first, last, result, iterator_category(first));
+}
+
+// 输入为分段迭代器时，逐段拷贝，每段的输入都是原生指针
+template <class InputIter, class OutputIter>
+OutputIter 
+copy_from_segments(InputIter first, InputIter last, OutputIter result, m_false_type)
+{
+  return copy_to_segments(first, last, result, is_segmented_iterator<OutputIter>());
+}
+
+template <class InputIter, class OutputIter>
+OutputIter 
+copy_from_segments(InputIter first, InputIter last, OutputIter result, m_true_type)
+{
+  typedef segmented_iterator_traits<InputIter> traits;
+  typedef is_segmented_iterator<OutputIter>    out_segmented;
+  auto sfirst = traits::segment(first);
+  const auto slast = traits::segment(last);
+  if (sfirst == slast)
+    return copy_to_segments(traits::local(first), traits::local(last), result, out_segmented());
+  result = copy_to_segments(traits::local(first), traits::end(sfirst), result, out_segmented());
+  for (++sfirst; sfirst != slast; ++sfirst)
+    result = copy_to_segments(traits::begin(sfirst), traits::end(sfirst), result, out_segmented());
+  return copy_to_segments(traits::begin(slast), traits::local(last), result, out_segmented());
+}
+
+template <class InputIter, class OutputIter>
+OutputIter copy(InputIter first, InputIter last, OutputIter result)
+{
+  return copy_from_segments(first, last, result, is_segmented_iterator<InputIter>());
   //通过判断 迭代器指向类型（OutputIter） 有没有定义拷贝赋值运算符（通过const/volatile，CV修饰符限定的对象都不能有拷贝赋值运算符）
   //如果没有定义直接通过memmove拷贝效率最高，定义了的话就调用unchecked_copy_cat，通过=号逐个拷贝
 }
@@ -295,12 +382,84 @@ unchecked_move(Tp* first, Tp* last, Up* result)
   return result + n;
 }
 
+// 分段迭代器的处理与 copy 相同
 template <class InputIter, class OutputIter>
-OutputIter move(InputIter first, InputIter last, OutputIter result)
+OutputIter 
+move_to_segments_cat(InputIter first, InputIter last, OutputIter result,
+                     mystl::input_iterator_tag)
 {
   return unchecked_move(first, last, result);
 }
 
+template <class RandomIter, class OutputIter>
+OutputIter 
+move_to_segments_cat(RandomIter first, RandomIter last, OutputIter result,
+                     mystl::random_access_iterator_tag)
+{
+  typedef segmented_iterator_traits<OutputIter> traits;
+  auto n = last - first;
+  if (n <= 0)
+    return result;
+  auto seg = traits::segment(result);
+  auto cur = traits::local(result);
+  for (;;)
+  {
+    const auto room = traits::end(seg) - cur;
+    const auto len = n < room ? n : room;
+    cur = unchecked_move(first, first + len, cur);
+    first += len;
+    n -= len;
+    if (n == 0)
+      break;
+    ++seg;
+    cur = traits::begin(seg);
+  }
+  return traits::compose(seg, cur);
+}
+
+template <class InputIter, class OutputIter>
+OutputIter 
+move_to_segments(InputIter first, InputIter last, OutputIter result, m_false_type)
+{
+  return unchecked_move(first, last, result);
+}
+
+template <class InputIter, class OutputIter>
+OutputIter 
+move_to_segments(InputIter first, InputIter last, OutputIter result, m_true_type)
+{
+  return move_to_segments_cat(first, last, result, iterator_category(first));
+}
+
+template <class InputIter, class OutputIter>
+OutputIter 
+move_from_segments(InputIter first, InputIter last, OutputIter result, m_false_type)
+{
+  return move_to_segments(first, last, result, is_segmented_iterator<OutputIter>());
+}
+
+template <class InputIter, class OutputIter>
+OutputIter 
+move_from_segments(InputIter first, InputIter last, OutputIter result, m_true_type)
+{
+  typedef segmented_iterator_traits<InputIter> traits;
+  typedef is_segmented_iterator<OutputIter>    out_segmented;
+  auto sfirst = traits::segment(first);
+  const auto slast = traits::segment(last);
+  if (sfirst == slast)
+    return move_to_segments(traits::local(first), traits::local(last), result, out_segmented());
+  result = move_to_segments(traits::local(first), traits::end(sfirst), result, out_segmented());
+  for (++sfirst; sfirst != slast; ++sfirst)
+    result = move_to_segments(traits::begin(sfirst), traits::end(sfirst), result, out_segmented());
+  return move_to_segments(traits::begin(slast), traits::local(last), result, out_segmented());
+}
+
+template <class InputIter, class OutputIter>
+OutputIter move(InputIter first, InputIter last, OutputIter result)
+{
+  return move_from_segments(first, last, result, is_segmented_iterator<InputIter>());
+}
+
 /*****************************************************************************************/
 // move_backward
 // 将 [first, last)区间内的元素移动到 [result - (last - first), result)内
@@ -444,12 +603,36 @@ void fill_cat(RandomIter first, RandomIter last, const T& value,
   fill_n(first, last - first, value);
 }
 
+// 分段迭代器逐段填充，每段都是原生指针，单字节类型可以直接 memset
 template <class ForwardIter, class T>
-void fill(ForwardIter first, ForwardIter last, const T& value)
+void fill_dispatch(ForwardIter first, ForwardIter last, const T& value, m_false_type)
 {
   fill_cat(first, last, value, iterator_category(first));
 }
 
+template <class ForwardIter, class T>
+void fill_dispatch(ForwardIter first, ForwardIter last, const T& value, m_true_type)
+{
+  typedef segmented_iterator_traits<ForwardIter> traits;
+  auto sfirst = traits::segment(first);
+  const auto slast = traits::segment(last);
+  if (sfirst == slast)
+  {
+    fill_n(traits::local(first), traits::local(last) - traits::local(first), value);
+    return;
+  }
+  fill_n(traits::local(first), traits::end(sfirst) - traits::local(first), value);
+  for (++sfirst; sfirst != slast; ++sfirst)
+    fill_n(traits::begin(sfirst), traits::end(sfirst) - traits::begin(sfirst), value);
+  fill_n(traits::begin(slast), traits::local(last) - traits::begin(slast), value);
+}
+
+template <class ForwardIter, class T>
+void fill(ForwardIter first, ForwardIter last, const T& value)
+{
+  fill_dispatch(first, last, value, is_segmented_iterator<ForwardIter>());
+}
+
 /*****************************************************************************************/
 // lexicographical_compare
 // 以字典序排列对两个序列进行比较，当在某个位置发现第一组不相等元素时，有下列几种情况：
@@ -0,0 +1,102 @@
+#ifndef MYTINYSTL_ALIGNED_ALLOCATOR_H_
+#define MYTINYSTL_ALIGNED_ALLOCATOR_H_
+
+// 这个头文件包含一个模板类 aligned_allocator，分配的内存按指定的边界对齐
+//
+// aligned_allocator<T>      : 按 64 字节（缓存行）对齐
+// aligned_allocator<T, 32>  : 按 32 字节对齐，可用于 AVX2 的对齐读写
+
+// notes:
+//
+// 1. 实际的对齐取 Align 与 alignof(T) 中较大的一个，Align 必须是 2 的幂
+// 2. 申请的字节数上调到对齐的整数倍，缓冲区的最后一个缓存行不会与其他分配共享，
+//    按缓存行对齐时，不同线程各自使用的缓冲区之间不会出现伪共享
+// 3. 以 aligned_allocator 为配置器的 vector 可以使用别名 aligned_vector<T, Align>
+
+#include <cstddef>
+
+#include "allocator.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// 缓存行的大小
+enum { ECacheLineSize = 64 };
+
+// 模板类：aligned_allocator
+// 模板参数 T 代表数据类型，Align 代表对齐的字节数
+template <class T, size_t Align = ECacheLineSize>
+class aligned_allocator
+{
+  static_assert(Align != 0 && (Align & (Align - 1)) == 0, "Align must be a power of 2");
+
+public:
+  typedef T            value_type;
+  typedef T*           pointer;
+  typedef const T*     const_pointer;
+  typedef T&           reference;
+  typedef const T&     const_reference;
+  typedef size_t       size_type;
+  typedef ptrdiff_t    difference_type;
+
+  typedef m_true_type  propagate_on_container_move_assignment;
+  typedef m_true_type  is_always_equal;
+
+  static const size_t alignment = Align < alignof(T) ? alignof(T) : Align;
+
+  template <class U>
+  struct rebind
+  {
+    typedef aligned_allocator<U, Align> other;
+  };
+
+public:
+  aligned_allocator() noexcept {}
+  template <class U>
+  aligned_allocator(const aligned_allocator<U, Align>&) noexcept {}
+
+public:
+  static T* allocate(size_type n)
+  {
+    if (n == 0)
+      return nullptr;
+    THROW_LENGTH_ERROR_IF(n > max_size(), "aligned_allocator<T>'s size too big");
+    return static_cast<T*>(mystl::aligned_allocate(padded_size(n), alignment));
+  }
+
+  static void deallocate(T* ptr, size_type)
+  {
+    if (ptr == nullptr)
+      return;
+    mystl::aligned_deallocate(ptr, alignment);
+  }
+
+  static size_type max_size() noexcept
+  { return (static_cast<size_type>(-1) - alignment) / sizeof(T); }
+
+private:
+  static size_type padded_size(size_type n) noexcept
+  { return (n * sizeof(T) + alignment - 1) & ~(alignment - 1); }
+};
+
+template <class T, size_t Align>
+const size_t aligned_allocator<T, Align>::alignment;
+
+/*****************************************************************************************/
+
+template <class T, class U, size_t Align>
+bool operator==(const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&) noexcept
+{
+  return true;
+}
+
+template <class T, class U, size_t Align>
+bool operator!=(const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&) noexcept
+{
+  return false;
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_ALIGNED_ALLOCATOR_H_
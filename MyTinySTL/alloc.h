@@ -1,21 +1,33 @@
 #ifndef MYTINYSTL_ALLOC_H_
 #define MYTINYSTL_ALLOC_H_
 
-// 这个头文件包含一个类 alloc，用于分配和回收内存，以内存池的方式实现
+// 这个头文件包含一个类 alloc 和一个模板类 pool_allocator，以内存池的方式分配和回收小块内存
 //
-// 从 v2.0.0 版本开始，将不再使用内存池，这个文件将被弃用，但暂时保留
+// alloc          : 按大小分级的小对象内存池，每个线程拥有自己的缓存，线程之间通过中心自由链表交换内存块
+// pool_allocator : 以 alloc 为底层的配置器，接口与 mystl::allocator 相同，可作为节点容器的配置器
+
+// notes:
 //
-// 注意！！！
-// 我知道这个文件里很多实现是错的，这是很久很久前写的了，后面已经不用这个东西了，
-// 所以我也没再维护，有诸多问题，已经有人在issue中都提了，free_list的修改，
-// 指针作为参数时没实际修改到原指针，等等。相信会看这么仔细的，大部分都是
-// 初学C++的朋友，大佬都不会看这些玩具了，所以其中的错误，就留给对内存池实现
-// 感兴趣的朋友去修改啦！
+// 1. 小于等于 4096 bytes 的请求按大小分成 56 个等级，每个等级维护一条自由链表，
+//    大于 4096 bytes 的请求直接调用 std::malloc / std::free
+// 2. 每个线程有一份 thread_local 缓存，分配与回收都只操作本线程的自由链表，不需要加锁
+// 3. 本线程缓存为空时，一次从中心自由链表批量取出若干内存块；中心链表也为空时，向系统申请一大块内存切分
+// 4. 在 A 线程分配、在 B 线程回收的内存块会进入 B 线程的缓存，缓存过长时批量归还中心链表，
+//    线程结束时缓存中的全部内存块也会归还中心链表，因此跨线程回收不会造成内存只增不减
+// 5. 向系统申请的大块内存不会归还系统，会一直在各级自由链表中复用
+// 6. 内存块只保证 8 字节对齐，对齐要求更高的类型由 pool_allocator 转交 aligned_allocate 处理
+// 7. 回收时必须给出与分配时相同的大小
 
 #include <new>
+#include <mutex>
 
 #include <cstddef>
-#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "allocator.h"
+#include "construct.h"
+#include "util.h"
 
 namespace mystl
 {
@@ -24,20 +36,19 @@ namespace mystl
 // 采用链表的方式管理内存碎片，分配与回收小内存（<=4K）区块
 union FreeList
 {
-  union FreeList* next;  // 指向下一个区块1
+  union FreeList* next;  // 指向下一个区块
   char data[1];          // 储存本块内存的首地址
-
 };
 
 // 不同内存范围的上调大小
-//通过EFreeListsNumber个链表来管理申请的内存。而且分配的倍数是8(_ALIGN)的倍数，就算你申请1byte它也会给你分配8byte。
-//56 * 8 = 128(_MAX_BYTES)。所以可以看到这16个链表节点分别是大小为8，16，24，... ... ，128bytes.
+// [1, 128] 按 8 字节上调，(128, 256] 按 16 字节上调，(256, 512] 按 32 字节上调，
+// (512, 1024] 按 64 字节上调，(1024, 2048] 按 128 字节上调，(2048, 4096] 按 256 字节上调
 enum
 {
-  EAlign128 = 8, 
-  EAlign256 = 16, 
+  EAlign128 = 8,
+  EAlign256 = 16,
   EAlign512 = 32,
-  EAlign1024 = 64, 
+  EAlign1024 = 64,
   EAlign2048 = 128,
   EAlign4096 = 256
 };
@@ -48,63 +59,99 @@ enum { ESmallObjectBytes = 4096 };
 // free lists 个数
 enum { EFreeListsNumber = 56 };
 
+// 线程缓存与中心链表之间一次搬运的字节数，以及线程缓存中每级最多保留的批次数
+enum { EBatchBytes = 8192, EMaxBatchObjects = 128, EMinBatchObjects = 4, ECacheBatches = 4 };
+
+// 一个线程的缓存，只包含平凡类型的成员，可以零开销地作为 thread_local 变量
+struct alloc_thread_cache
+{
+  FreeList* free_list[EFreeListsNumber];  // 本线程的自由链表
+  size_t    count[EFreeListsNumber];      // 每条自由链表上的区块个数
+  bool      registered;                   // 是否已经注册线程退出时的回收
+  bool      dead;                         // 线程缓存是否已经回收，之后的请求直接走中心链表
+};
+
+// 中心自由链表，所有线程共享，每个等级一把锁
+struct alloc_central_list
+{
+  std::mutex lock[EFreeListsNumber];
+  FreeList*  free_list[EFreeListsNumber];
+  size_t     count[EFreeListsNumber];
+};
+
 // 空间配置类 alloc
 // 如果内存较大，超过 4096 bytes，直接调用 std::malloc, std::free
 // 当内存较小时，以内存池管理，每次配置一大块内存，并维护对应的自由链表
 class alloc
 {
-private:
-  static char*  start_free;                      // 内存池起始位置
-  static char*  end_free;                        // 内存池结束位置
-  static size_t heap_size;                       // 申请 heap 空间附加值大小
-  
-  static FreeList* free_list[EFreeListsNumber];  // 自由链表
-
 public:
   static void* allocate(size_t n);
   static void  deallocate(void* p, size_t n);
   static void* reallocate(void* p, size_t old_size, size_t new_size);
 
+  // 把本线程缓存中的全部区块归还中心链表
+  static void  release_thread_cache() noexcept;
+
+  // 中心链表中大小为 n 的区块个数，n 不超过 4096
+  static size_t central_free_count(size_t n);
+
 private:
   static size_t M_align(size_t bytes);
   static size_t M_round_up(size_t bytes);
   static size_t M_freelist_index(size_t bytes);
-  static void*  M_refill(size_t n);
-  static char*  M_chunk_alloc(size_t size, size_t &nobj);
+  static size_t M_class_size(size_t index);
+  static size_t M_batch(size_t index);
+
+  // 线程退出时回收本线程缓存
+  struct thread_cache_guard
+  {
+    ~thread_cache_guard() { alloc::release_thread_cache(); alloc::M_local().dead = true; }
+  };
+
+  static alloc_thread_cache& M_local() noexcept;
+  static alloc_central_list& M_central() noexcept;
+  static void   M_register(alloc_thread_cache& cache);
+  static void*  M_refill(size_t index);
+  static void   M_release(size_t index, size_t nobj);
+  static void   M_central_free(FreeList* first, FreeList* last, size_t index, size_t nobj);
+  static FreeList* M_chunk_alloc(size_t index, size_t& nobj);
 };
 
-// 静态成员变量初始化
+/*****************************************************************************************/
 
-char*  alloc::start_free = nullptr;
-char*  alloc::end_free = nullptr;
-size_t alloc::heap_size = 0;
+// 本线程的缓存，零初始化，不需要构造也不需要析构
+inline alloc_thread_cache& alloc::M_local() noexcept
+{
+  static thread_local alloc_thread_cache cache;
+  return cache;
+}
 
-FreeList* alloc::free_list[EFreeListsNumber] = {
-  nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-  nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-  nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-  nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-  nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-  nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,
-  nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr,nullptr
-  };//56个小内存的首地址？
+// 中心链表，函数内的静态变量保证各个翻译单元共享同一份
+inline alloc_central_list& alloc::M_central() noexcept
+{
+  static alloc_central_list central;
+  return central;
+}
 
 // 分配大小为 n 字节的空间， n > 0
 inline void* alloc::allocate(size_t n)
 {
-  FreeList* my_free_list;
-  FreeList* result;
   if (n > static_cast<size_t>(ESmallObjectBytes))
-    return std::malloc(n);//如果申请的内存过大，利用malloc分配
-  my_free_list = free_list[M_freelist_index(n)];// 根据区块大小，选择第 n 个 free lists
-  //my_free_list就是这个内存链表的头结点
-  result = my_free_list;//先记录头结点，再顺着链表往后找
+  {
+    void* p = std::malloc(n);
+    if (p == nullptr)
+      throw std::bad_alloc();
+    return p;
+  }
+  const size_t index = M_freelist_index(n);
+  alloc_thread_cache& cache = M_local();
+  FreeList* result = cache.free_list[index];
   if (result == nullptr)
-  {//头结点为空，说明之前还没分配过这个多大小的内存
-    void* r = M_refill(M_round_up(n));
-    return r;
+  { // 本线程缓存为空，从中心链表批量取
+    return M_refill(index);
   }
-  my_free_list = result->next;//似乎没什么用
+  cache.free_list[index] = result->next;
+  --cache.count[index];
   return result;
 }
 
@@ -116,19 +163,75 @@ inline void alloc::deallocate(void* p, size_t n)
     std::free(p);
     return;
   }
-  FreeList* q = reinterpret_cast<FreeList*>(p);
-  FreeList* my_free_list;
-  my_free_list = free_list[M_freelist_index(n)];
-  q->next = my_free_list;
-  my_free_list = q;
+  const size_t index = M_freelist_index(n);
+  alloc_thread_cache& cache = M_local();
+  FreeList* q = static_cast<FreeList*>(p);
+  if (cache.dead)
+  { // 线程缓存已经回收，直接还给中心链表
+    M_central_free(q, q, index, 1);
+    return;
+  }
+  // 只回收不分配的线程（跨线程回收的一方）也要在退出时归还缓存
+  M_register(cache);
+  q->next = cache.free_list[index];
+  cache.free_list[index] = q;
+  if (++cache.count[index] > ECacheBatches * M_batch(index))
+  { // 缓存过长，多半是在回收其他线程分配的内存，归还一批给中心链表
+    M_release(index, M_batch(index));
+  }
 }
 
-// 重新分配空间，接受三个参数，参数一为指向新空间的指针，参数二为原来空间的大小，参数三为申请空间的大小
+// 重新分配空间，接受三个参数，参数一为原来空间的指针，参数二为原来空间的大小，参数三为申请空间的大小
 inline void* alloc::reallocate(void* p, size_t old_size, size_t new_size)
 {
+  if (old_size <= static_cast<size_t>(ESmallObjectBytes) &&
+      new_size <= static_cast<size_t>(ESmallObjectBytes) &&
+      M_freelist_index(old_size) == M_freelist_index(new_size))
+  { // 处于同一等级，原区块就足够大
+    return p;
+  }
+  if (old_size > static_cast<size_t>(ESmallObjectBytes) &&
+      new_size > static_cast<size_t>(ESmallObjectBytes))
+  {
+    void* r = std::realloc(p, new_size);
+    if (r == nullptr)
+      throw std::bad_alloc();
+    return r;
+  }
+  void* r = allocate(new_size);
+  std::memcpy(r, p, old_size < new_size ? old_size : new_size);
   deallocate(p, old_size);
-  p = allocate(new_size);
-  return p;
+  return r;
+}
+
+// 把本线程缓存中的全部区块归还中心链表
+inline void alloc::release_thread_cache() noexcept
+{
+  alloc_thread_cache& cache = M_local();
+  for (size_t i = 0; i < EFreeListsNumber; ++i)
+  {
+    if (cache.count[i] != 0)
+      M_release(i, cache.count[i]);
+  }
+}
+
+inline size_t alloc::central_free_count(size_t n)
+{
+  const size_t index = M_freelist_index(n);
+  alloc_central_list& central = M_central();
+  std::lock_guard<std::mutex> lk(central.lock[index]);
+  return central.count[index];
+}
+
+// 第一次把区块放入本线程缓存时，注册线程退出时的回收
+inline void alloc::M_register(alloc_thread_cache& cache)
+{
+  if (!cache.registered && !cache.dead)
+  {
+    cache.registered = true;
+    static thread_local thread_cache_guard guard;
+    (void)guard;
+  }
 }
 
 // bytes 对应上调大小
@@ -147,137 +250,306 @@ inline size_t alloc::M_align(size_t bytes)
 
 // 将 bytes 上调至对应区间大小
 inline size_t alloc::M_round_up(size_t bytes)
-{//比如申请1，就分配8，申请12，就分配16，申请157，就分配160...
-    //https://blog.csdn.net/weixin_45768137/article/details/127266001
+{
   return ((bytes + M_align(bytes) - 1) & ~(M_align(bytes) - 1));
 }
 
 // 根据区块大小，选择第 n 个 free lists
+// 下标 0-15 按 8 字节递增，16-23 按 16 字节递增，24-31 按 32 字节递增，
+// 32-39 按 64 字节递增，40-47 按 128 字节递增，48-55 按 256 字节递增
 inline size_t alloc::M_freelist_index(size_t bytes)
 {
   if (bytes <= 512)
   {
     return bytes <= 256
-      ? bytes <= 128 
-        ? ((bytes + EAlign128 - 1) / EAlign128 - 1) 
-        //这里返回的是链表头在数组free_list中的下标，[0:128]的时候会用 8 的倍数去分配，
-        //因为下标是0开始的，所以最后还要-1。如要分配是22byte，因为实际应该分配24（3*8）byte，
-        //它的链表下标是2（下标0对应8byte，下标1对应16byte，2-24，最大下标是15），所以是（22+8-1）/ 8 -1=2
+      ? bytes <= 128
+        ? ((bytes + EAlign128 - 1) / EAlign128 - 1)
         : (15 + (bytes + EAlign256 - 129) / EAlign256)
-        //[129:256]的时候会用 16 的倍数去分配，如要分配是156byte，因为实际应该分配 160（128+16*2）byte，
-        //它的链表下标是17（下标0-15是8倍内存，16-23是16倍内存），所以前面要加15，减去的起始值是129，注意这里不用-1
-        //因为15里面已经减去了，所以是15+（156+16-129）/ 16=17
       : (23 + (bytes + EAlign512 - 257) / EAlign512);
-      //[257:512]的时候会用 32 的倍数去分配，如要分配是 347 byte，因为实际应该分配 352（256+32*3）byte，
-      //它的链表下标是26（下标0-15是8倍内存，16-23是16倍内存,24-31是32倍内存），所以前面要加23，减去的起始值是257
-      //所以是23+（347+32-257）/ 32=26
   }
   return bytes <= 2048
-    ? bytes <= 1024 //下标32-39是64倍内存，40-47是128倍内存,48-55是512倍内存
+    ? bytes <= 1024
       ? (31 + (bytes + EAlign1024 - 513) / EAlign1024)
       : (39 + (bytes + EAlign2048 - 1025) / EAlign2048)
     : (47 + (bytes + EAlign4096 - 2049) / EAlign4096);
 }
 
-// 重新填充 free list
-void* alloc::M_refill(size_t n)
-{//如果想申请n字节的空间，会直接分配1个或多个n字节大小的区块
-  size_t nblock = 10;
-  char* c = M_chunk_alloc(n, nblock);
-  FreeList* my_free_list;
-  FreeList* result, *cur, *next;
-  // 如果只有一个区块，就把这个区块返回给调用者，free list 没有增加新节点
-  if (nblock == 1)
-    return c;
-  // 否则把一个区块给调用者，剩下的纳入 free list 作为新节点
-  my_free_list = free_list[M_freelist_index(n)];
-  result = (FreeList*)c;//仍然是返回第一个区块
-  my_free_list = next = (FreeList*)(c + n);//c + n是第一个区块空间的下一个地址，也就是第二个区块的起始地址
-  for (size_t i = 1; ; ++i)
-  {//逐个放入链表中
-    cur = next;
-    next = (FreeList*)((char*)next + n);//下一个区块的起始地址
-    if (nblock - 1 == i)
-    {//cur已经是最后一个区块了
-      cur->next = nullptr;
-      break;
+// 第 index 个 free list 上区块的大小，是 M_freelist_index 的逆运算
+inline size_t alloc::M_class_size(size_t index)
+{
+  if (index < 16)  return (index + 1) * EAlign128;
+  if (index < 24)  return 128 + (index - 15) * EAlign256;
+  if (index < 32)  return 256 + (index - 23) * EAlign512;
+  if (index < 40)  return 512 + (index - 31) * EAlign1024;
+  if (index < 48)  return 1024 + (index - 39) * EAlign2048;
+  return 2048 + (index - 47) * EAlign4096;
+}
+
+// 第 index 个 free list 一次搬运的区块个数，小区块多搬，大区块少搬
+inline size_t alloc::M_batch(size_t index)
+{
+  const size_t n = EBatchBytes / M_class_size(index);
+  return n < EMinBatchObjects ? static_cast<size_t>(EMinBatchObjects)
+    : n > EMaxBatchObjects ? static_cast<size_t>(EMaxBatchObjects) : n;
+}
+
+// 重新填充本线程的 free list，返回其中一个区块给调用者
+inline void* alloc::M_refill(size_t index)
+{
+  alloc_thread_cache& cache = M_local();
+  M_register(cache);
+  size_t nobj = M_batch(index);
+  FreeList* result = nullptr;
+  {
+    alloc_central_list& central = M_central();
+    std::lock_guard<std::mutex> lk(central.lock[index]);
+    if (central.free_list[index] != nullptr)
+    { // 从中心链表取出至多 nobj 个区块
+      FreeList* last = central.free_list[index];
+      size_t got = 1;
+      for (; got < nobj && last->next != nullptr; ++got)
+        last = last->next;
+      result = central.free_list[index];
+      central.free_list[index] = last->next;
+      central.count[index] -= got;
+      last->next = nullptr;
+      nobj = got;
     }
-    else
-    {//链接起来
-      cur->next = next;
+  }
+  if (result == nullptr)
+    result = M_chunk_alloc(index, nobj);
+  // 一个区块给调用者，剩下的纳入本线程的 free list
+  if (cache.dead)
+  {
+    if (nobj > 1)
+    {
+      FreeList* last = result->next;
+      while (last->next != nullptr)
+        last = last->next;
+      M_central_free(result->next, last, index, nobj - 1);
     }
+    return result;
   }
+  cache.free_list[index] = result->next;
+  cache.count[index] = nobj - 1;
   return result;
 }
 
-// 从内存池中取空间给 free list 使用，条件不允许时，会调整 nblock
-char* alloc::M_chunk_alloc(size_t size, size_t& nblock)
-{//整个内存分配的逻辑是：先向内存池申请内存，不够的话向堆申请，堆不够的话，在空闲链表上找，这个链表是用来存储内存池未用的所有
-    //内存块的，有可能之前剩余了一个非常大的内存块，可以满足这一次需求
-    //堆够的话分配两倍大小的空间，再分配给用户。内存池够得话，直接分配给用户
-  char* result;
-  size_t need_bytes = size * nblock;//最好是直接分配10个区块，每一个大小都是n byte
-  size_t pool_bytes = end_free - start_free;
+// 把本线程 free list 头部的 nobj 个区块归还中心链表
+inline void alloc::M_release(size_t index, size_t nobj)
+{
+  alloc_thread_cache& cache = M_local();
+  FreeList* first = cache.free_list[index];
+  FreeList* last = first;
+  for (size_t i = 1; i < nobj; ++i)
+    last = last->next;
+  cache.free_list[index] = last->next;
+  cache.count[index] -= nobj;
+  M_central_free(first, last, index, nobj);
+}
 
-  // 如果内存池剩余大小完全满足需求量，返回它
-  if (pool_bytes >= need_bytes)
-  {
-    result = start_free;
-    start_free += need_bytes;
-    return result;
-  }
+// 把 [first, last] 这一段共 nobj 个区块挂到中心链表上
+inline void alloc::M_central_free(FreeList* first, FreeList* last, size_t index, size_t nobj)
+{
+  alloc_central_list& central = M_central();
+  std::lock_guard<std::mutex> lk(central.lock[index]);
+  last->next = central.free_list[index];
+  central.free_list[index] = first;
+  central.count[index] += nobj;
+}
 
-  // 如果内存池剩余大小不能完全满足需求量，但至少可以分配一个或一个以上的区块，就返回它
-  else if (pool_bytes >= size)
+// 向系统申请一大块内存并切分成第 index 级的区块，前 nobj 个连成链表返回，其余放入中心链表
+inline FreeList* alloc::M_chunk_alloc(size_t index, size_t& nobj)
+{
+  const size_t size = M_class_size(index);
+  const size_t total = nobj * ECacheBatches;
+  char* chunk = static_cast<char*>(std::malloc(size * total));
+  if (chunk == nullptr)
+  { // 申请不到那么多，退而求其次只申请一批
+    chunk = static_cast<char*>(std::malloc(size * nobj));
+    if (chunk == nullptr)
+      throw std::bad_alloc();
+    for (size_t i = 0; i + 1 < nobj; ++i)
+      reinterpret_cast<FreeList*>(chunk + i * size)->next =
+      reinterpret_cast<FreeList*>(chunk + (i + 1) * size);
+    reinterpret_cast<FreeList*>(chunk + (nobj - 1) * size)->next = nullptr;
+    return reinterpret_cast<FreeList*>(chunk);
+  }
+  for (size_t i = 0; i + 1 < total; ++i)
   {
-    nblock = pool_bytes / size;//能分配几个区块就分配几个
-    need_bytes = size * nblock;
-    result = start_free;
-    start_free += need_bytes;
-    return result;
+    reinterpret_cast<FreeList*>(chunk + i * size)->next =
+      reinterpret_cast<FreeList*>(chunk + (i + 1) * size);
   }
+  reinterpret_cast<FreeList*>(chunk + (total - 1) * size)->next = nullptr;
+  // 断开成两段：[0, nobj) 给本线程，[nobj, total) 给中心链表
+  FreeList* rest = reinterpret_cast<FreeList*>(chunk + nobj * size);
+  reinterpret_cast<FreeList*>(chunk + (nobj - 1) * size)->next = nullptr;
+  M_central_free(rest, reinterpret_cast<FreeList*>(chunk + (total - 1) * size),
+                 index, total - nobj);
+  return reinterpret_cast<FreeList*>(chunk);
+}
+
+/*****************************************************************************************/
 
-  // 如果内存池剩余大小连一个区块都无法满足
-  else
+// 模板类：pool_allocator
+// 以 alloc 内存池作为底层的配置器，接口与 mystl::allocator 相同
+// 适合频繁分配、回收单个节点的容器，例如 mystl::map<K, V, Compare, pool_allocator<pair<const K, V>>>
+template <class T>
+class pool_allocator
+{
+public:
+  typedef T            value_type;
+  typedef T*           pointer;
+  typedef const T*     const_pointer;
+  typedef T&           reference;
+  typedef const T&     const_reference;
+  typedef size_t       size_type;
+  typedef ptrdiff_t    difference_type;
+
+  typedef m_true_type  propagate_on_container_move_assignment;
+  typedef m_true_type  is_always_equal;
+
+  template <class U>
+  struct rebind
   {
-    if (pool_bytes > 0)
-    { // 如果内存池还有剩余，把剩余的空间加入到 free list 中
-      FreeList* my_free_list = free_list[M_freelist_index(pool_bytes)];//先找到剩余空间能够存放的链表在数组中的下标
-      //然后取出头结点my_free_list
-      ((FreeList*)start_free)->next = my_free_list;
-      //将剩下的空间首地址先强转成一个节点指针，然后插入头部，现在剩余地址成了头结点
-      my_free_list = (FreeList*)start_free;
-    }
-    // 申请 heap 空间
-    size_t bytes_to_get = (need_bytes << 1) + M_round_up(heap_size >> 4);
-    //M_chunk_alloc的职责就是负责内存池的所有内存的生产，在生产的时候他为了保证下次能有内存用，所以会将空间 * 2去申请
-    start_free = (char*)std::malloc(bytes_to_get);
-    if (!start_free)
-    { // heap 空间也不够
-      FreeList* my_free_list, *p;
-      // 试着查找有无未用区块，且区块足够大的 free list
-      for (size_t i = size; i <= ESmallObjectBytes; i += M_align(i))
-      {//size是我们需要的大小，他一定符合标准尺寸，
-        my_free_list = free_list[M_freelist_index(i)];//i大小是不小于size的
-        p = my_free_list;
-        if (p)
-        {//有空闲块，那么可以分配给用户
-          my_free_list = p->next;//似乎没什么用
-          start_free = (char*)p;//把这一块内存重新放入内存池，递归调用本函数去分配
-          end_free = start_free + i;
-          return M_chunk_alloc(size, nblock);
-        }
-        //没有空闲块，寻找更大的空间
-      }
-      //如果前面一直没有返回说明链表里面也没有足够空间
-      std::printf("out of memory");
-      end_free = nullptr;
-      throw std::bad_alloc();//抛出异常
-    }
-    end_free = start_free + bytes_to_get;//堆空间够得话，直接进入下一层递归分配
-    heap_size += bytes_to_get;
-    return M_chunk_alloc(size, nblock);
-  }
+    typedef pool_allocator<U> other;
+  };
+
+public:
+  pool_allocator() noexcept {}
+  template <class U>
+  pool_allocator(const pool_allocator<U>&) noexcept {}
+
+public:
+  static T*   allocate();
+  static T*   allocate(size_type n);
+
+  static void deallocate(T* ptr);
+  static void deallocate(T* ptr, size_type n);
+
+  static void construct(T* ptr);
+  static void construct(T* ptr, const T& value);
+  static void construct(T* ptr, T&& value);
+
+  template <class... Args>
+  static void construct(T* ptr, Args&& ...args);
+
+  static void destroy(T* ptr);
+  static void destroy(T* first, T* last);
+
+private:
+  // 内存池的区块只保证 8 字节对齐
+  typedef m_bool_constant<(alignof(T) <= EAlign128)> use_pool;
+
+  static T*   allocate_aux(size_type n, m_true_type);
+  static T*   allocate_aux(size_type n, m_false_type);
+  static void deallocate_aux(T* ptr, size_type n, m_true_type);
+  static void deallocate_aux(T* ptr, size_type n, m_false_type);
+};
+
+template <class T>
+T* pool_allocator<T>::allocate()
+{
+  return allocate_aux(1, use_pool());
+}
+
+template <class T>
+T* pool_allocator<T>::allocate(size_type n)
+{
+  if (n == 0)
+    return nullptr;
+  return allocate_aux(n, use_pool());
+}
+
+// 不带大小的版本只能回收 allocate() 或 allocate(1) 得到的空间
+template <class T>
+void pool_allocator<T>::deallocate(T* ptr)
+{
+  if (ptr == nullptr)
+    return;
+  deallocate_aux(ptr, 1, use_pool());
+}
+
+template <class T>
+void pool_allocator<T>::deallocate(T* ptr, size_type n)
+{
+  if (ptr == nullptr)
+    return;
+  deallocate_aux(ptr, n, use_pool());
+}
+
+template <class T>
+void pool_allocator<T>::construct(T* ptr)
+{
+  mystl::construct(ptr);
+}
+
+template <class T>
+void pool_allocator<T>::construct(T* ptr, const T& value)
+{
+  mystl::construct(ptr, value);
+}
+
+template <class T>
+void pool_allocator<T>::construct(T* ptr, T&& value)
+{
+  mystl::construct(ptr, mystl::move(value));
+}
+
+template <class T>
+template <class ...Args>
+void pool_allocator<T>::construct(T* ptr, Args&& ...args)
+{
+  mystl::construct(ptr, mystl::forward<Args>(args)...);
+}
+
+template <class T>
+void pool_allocator<T>::destroy(T* ptr)
+{
+  mystl::destroy(ptr);
+}
+
+template <class T>
+void pool_allocator<T>::destroy(T* first, T* last)
+{
+  mystl::destroy(first, last);
+}
+
+template <class T>
+T* pool_allocator<T>::allocate_aux(size_type n, m_true_type)
+{
+  return static_cast<T*>(alloc::allocate(n * sizeof(T)));
+}
+
+template <class T>
+T* pool_allocator<T>::allocate_aux(size_type n, m_false_type)
+{
+  return static_cast<T*>(mystl::aligned_allocate(n * sizeof(T), alignof(T)));
+}
+
+template <class T>
+void pool_allocator<T>::deallocate_aux(T* ptr, size_type n, m_true_type)
+{
+  alloc::deallocate(ptr, n * sizeof(T));
+}
+
+template <class T>
+void pool_allocator<T>::deallocate_aux(T* ptr, size_type, m_false_type)
+{
+  mystl::aligned_deallocate(ptr, alignof(T));
+}
+
+// 所有 pool_allocator 共用同一个内存池，总是相等
+template <class T, class U>
+bool operator==(const pool_allocator<T>&, const pool_allocator<U>&) noexcept
+{
+  return true;
+}
+
+template <class T, class U>
+bool operator!=(const pool_allocator<T>&, const pool_allocator<U>&) noexcept
+{
+  return false;
 }
 
 } // namespace mystl
@@ -2,6 +2,12 @@
 #define MYTINYSTL_ALLOCATOR_H_
 
 // 这个头文件包含一个模板类 allocator，用于管理内存的分配、释放，对象的构造、析构
+// 以及模板类 allocator_traits 和 alloc_holder，供容器使用自定义配置器
+
+#include <new>
+
+#include <cstddef>
+#include <cstdint>
 
 #include "construct.h"
 #include "util.h"
@@ -9,6 +15,35 @@
 namespace mystl
 {
 
+// 按 align 对齐申请 bytes 字节的内存，align 必须是 2 的幂
+// align 不超过 max_align_t 的对齐时直接使用 ::operator new，
+// 否则多申请 align 字节，在返回地址之前保存原始地址，回收时必须给出相同的 align
+inline void* aligned_allocate(size_t bytes, size_t align)
+{
+  if (align <= alignof(std::max_align_t))
+    return ::operator new(bytes);
+  char* raw = static_cast<char*>(::operator new(bytes + align));
+  char* p = raw + align - (reinterpret_cast<uintptr_t>(raw) & (align - 1));
+  reinterpret_cast<void**>(p)[-1] = raw;
+  return p;
+}
+
+inline void aligned_deallocate(void* p, size_t align) noexcept
+{
+  if (align <= alignof(std::max_align_t))
+    ::operator delete(p);
+  else
+    ::operator delete(static_cast<void**>(p)[-1]);
+}
+
+// allocate_at_least 的返回值：申请到的空间与它实际可以容纳的元素个数
+template <class Pointer, class SizeType = size_t>
+struct allocation_result
+{
+  Pointer  ptr;
+  SizeType count;
+};
+
 // 模板类：allocator
 // 模板函数代表数据类型
 template <class T>
@@ -23,10 +58,28 @@ public:
   typedef size_t       size_type;
   typedef ptrdiff_t    difference_type;
 
+  typedef m_true_type  propagate_on_container_move_assignment;
+  typedef m_true_type  is_always_equal;
+
+  template <class U>
+  struct rebind
+  {
+    typedef allocator<U> other;
+  };
+
+public:
+  allocator() noexcept {}
+  template <class U>
+  allocator(const allocator<U>&) noexcept {}
+
 public:
   static T*   allocate();
   static T*   allocate(size_type n);
 
+  // ::operator new 可能被程序替换，不能查询它实际给出的大小，返回的个数就是 n
+  // 需要利用 malloc 上调的空间时使用 malloc_allocator
+  static allocation_result<T*> allocate_at_least(size_type n);
+
   static void deallocate(T* ptr);
   static void deallocate(T* ptr, size_type n);
 
@@ -48,7 +101,8 @@ T* allocator<T>::allocate()
   //在类中重载形式 void* A::operator new(size_t size)。
   //事实上系统默认的全局::operator new(size_t size)也只是调用malloc分配内存，并且返回一个void* 指针。
   //而构造函数的调用(如果需要)是在new运算符中完成的；
-  return static_cast<T*>(::operator new(sizeof(T)));//分配对象T大小的空间，返回空指针并强制转换成T类型指针
+  return static_cast<T*>(mystl::aligned_allocate(sizeof(T), alignof(T)));//分配对象T大小的空间，返回空指针并强制转换成T类型指针
+  //对齐要求超过 max_align_t 的类型，::operator new 不能保证对齐，由 aligned_allocate 处理
 }
 
 template <class T>
@@ -56,7 +110,13 @@ T* allocator<T>::allocate(size_type n)
 {//申请n个T对象大小的空间
   if (n == 0)
     return nullptr;
-  return static_cast<T*>(::operator new(n * sizeof(T)));
+  return static_cast<T*>(mystl::aligned_allocate(n * sizeof(T), alignof(T)));
+}
+
+template <class T>
+allocation_result<T*> allocator<T>::allocate_at_least(size_type n)
+{
+  return { allocate(n), n };
 }
 
 template <class T>
@@ -64,7 +124,7 @@ void allocator<T>::deallocate(T* ptr)
 {//释放ptr所指向的内存
   if (ptr == nullptr)
     return;
-  ::operator delete(ptr);
+  mystl::aligned_deallocate(ptr, alignof(T));
 }
 
 template <class T>
@@ -75,7 +135,7 @@ void allocator<T>::deallocate(T* ptr, size_type /*size*/)
     //并返回偏移量 + 4的指针。在free时，从指针的 - 4偏移量读4个字节作为内存块的大小，然后释放。
   if (ptr == nullptr)
     return;
-  ::operator delete(ptr);
+  mystl::aligned_deallocate(ptr, alignof(T));
 }
 
 template <class T>
@@ -115,6 +175,287 @@ void allocator<T>::destroy(T* first, T* last)
   mystl::destroy(first, last);
 }
 
+// allocator 没有状态，任意两个 allocator 都相等
+template <class T, class U>
+bool operator==(const allocator<T>&, const allocator<U>&) noexcept
+{
+  return true;
+}
+
+template <class T, class U>
+bool operator!=(const allocator<T>&, const allocator<U>&) noexcept
+{
+  return false;
+}
+
+/*****************************************************************************************/
+// allocator_traits
+
+// 萃取配置器的嵌套型别，配置器没有定义时使用缺省型别
+template <class Alloc>
+struct alloc_pocca
+{
+  template <class A>
+  static typename A::propagate_on_container_copy_assignment test(int);
+  template <class A>
+  static m_false_type test(...);
+  typedef decltype(test<Alloc>(0)) type;
+};
+
+template <class Alloc>
+struct alloc_pocma
+{
+  template <class A>
+  static typename A::propagate_on_container_move_assignment test(int);
+  template <class A>
+  static m_false_type test(...);
+  typedef decltype(test<Alloc>(0)) type;
+};
+
+template <class Alloc>
+struct alloc_pocs
+{
+  template <class A>
+  static typename A::propagate_on_container_swap test(int);
+  template <class A>
+  static m_false_type test(...);
+  typedef decltype(test<Alloc>(0)) type;
+};
+
+// 没有定义 is_always_equal 时，空的配置器视为总是相等
+template <class Alloc>
+struct alloc_always_equal
+{
+  template <class A>
+  static typename A::is_always_equal test(int);
+  template <class A>
+  static m_bool_constant<std::is_empty<A>::value> test(...);
+  typedef decltype(test<Alloc>(0)) type;
+};
+
+// 配置器是否提供 reallocate(p, old_n, new_n)
+template <class Alloc>
+struct alloc_has_reallocate
+{
+  template <class A>
+  static auto test(int)
+    -> decltype(std::declval<A&>().reallocate(nullptr, size_t(), size_t()), m_true_type());
+  template <class A>
+  static m_false_type test(...);
+  typedef decltype(test<Alloc>(0)) type;
+};
+
+// rebind：优先使用配置器自己的 rebind，否则把 Alloc<T, Args...> 替换成 Alloc<U, Args...>
+template <class Alloc, class U>
+struct alloc_rebind_helper;
+
+template <template <class, class...> class Alloc, class T, class... Args, class U>
+struct alloc_rebind_helper<Alloc<T, Args...>, U>
+{
+  typedef Alloc<U, Args...> type;
+};
+
+template <class Alloc, class U>
+struct alloc_rebind
+{
+  template <class A>
+  static typename A::template rebind<U>::other test(int);
+  template <class A>
+  static typename alloc_rebind_helper<A, U>::type test(...);
+  typedef decltype(test<Alloc>(0)) type;
+};
+
+// 模板类 : allocator_traits
+// 容器通过它使用配置器，配置器只需要提供 value_type、allocate、deallocate，其余成员都有缺省实现
+// 注意：容器内部使用原生指针，不支持 fancy pointer
+template <class Alloc>
+struct allocator_traits
+{
+  typedef Alloc                           allocator_type;
+  typedef typename Alloc::value_type      value_type;
+  typedef value_type*                     pointer;
+  typedef const value_type*               const_pointer;
+  typedef size_t                          size_type;
+  typedef ptrdiff_t                       difference_type;
+
+  typedef typename alloc_pocca<Alloc>::type        propagate_on_container_copy_assignment;
+  typedef typename alloc_pocma<Alloc>::type        propagate_on_container_move_assignment;
+  typedef typename alloc_pocs<Alloc>::type         propagate_on_container_swap;
+  typedef typename alloc_always_equal<Alloc>::type is_always_equal;
+
+  template <class U>
+  using rebind_alloc = typename alloc_rebind<Alloc, U>::type;
+
+  // 配置器是否提供 reallocate(p, old_n, new_n)，可以把一块内存原地扩展或收缩
+  typedef typename alloc_has_reallocate<Alloc>::type has_reallocate;
+
+  static pointer allocate(Alloc& a, size_type n)
+  { return a.allocate(n); }
+
+  static void deallocate(Alloc& a, pointer p, size_type n)
+  { a.deallocate(p, n); }
+
+  // 配置器提供 allocate_at_least 时返回实际可以容纳的个数，否则就是 n
+  // 容器可以把多出的部分作为容量，回收时给出返回的个数
+  static allocation_result<pointer, size_type> allocate_at_least(Alloc& a, size_type n)
+  { return allocate_at_least_aux(0, a, n); }
+
+  // 配置器有可用的 construct 就调用它，否则直接在 p 上构造
+  template <class U, class... Args>
+  static void construct(Alloc& a, U* p, Args&& ...args)
+  { construct_aux(0, a, p, mystl::forward<Args>(args)...); }
+
+  template <class U>
+  static void destroy(Alloc& a, U* p)
+  { destroy_aux(0, a, p); }
+
+  // 只适用于平凡可复制的元素，失败时抛出异常，原来的内存保持不变
+  static pointer reallocate(Alloc& a, pointer p, size_type old_n, size_type new_n)
+  { return a.reallocate(p, old_n, new_n); }
+
+  static size_type max_size(const Alloc& a) noexcept
+  { return max_size_aux(0, a); }
+
+  static Alloc select_on_container_copy_construction(const Alloc& a)
+  { return select_aux(0, a); }
+
+private:
+  template <class A>
+  static auto allocate_at_least_aux(int, A& a, size_type n)
+    -> decltype(a.allocate_at_least(n), allocation_result<pointer, size_type>())
+  {
+    auto r = a.allocate_at_least(n);
+    return { r.ptr, r.count };
+  }
+
+  template <class A>
+  static allocation_result<pointer, size_type> allocate_at_least_aux(long, A& a, size_type n)
+  { return { a.allocate(n), n }; }
+
+  template <class A, class U, class... Args>
+  static auto construct_aux(int, A& a, U* p, Args&& ...args)
+    -> decltype(a.construct(p, mystl::forward<Args>(args)...), void())
+  { a.construct(p, mystl::forward<Args>(args)...); }
+
+  template <class A, class U, class... Args>
+  static void construct_aux(long, A&, U* p, Args&& ...args)
+  { mystl::construct(p, mystl::forward<Args>(args)...); }
+
+  template <class A, class U>
+  static auto destroy_aux(int, A& a, U* p) -> decltype(a.destroy(p), void())
+  { a.destroy(p); }
+
+  template <class A, class U>
+  static void destroy_aux(long, A&, U* p)
+  { mystl::destroy(p); }
+
+  template <class A>
+  static auto max_size_aux(int, const A& a) -> decltype(a.max_size(), size_type())
+  { return a.max_size(); }
+
+  template <class A>
+  static size_type max_size_aux(long, const A&)
+  { return static_cast<size_type>(-1) / sizeof(value_type); }
+
+  template <class A>
+  static auto select_aux(int, const A& a) -> decltype(a.select_on_container_copy_construction())
+  { return a.select_on_container_copy_construction(); }
+
+  template <class A>
+  static A select_aux(long, const A& a)
+  { return a; }
+};
+
+// 容器赋值、交换时按 propagate_on_container_* 决定是否传播配置器
+
+template <class Alloc>
+void alloc_on_copy_aux(Alloc& lhs, const Alloc& rhs, m_true_type)
+{ lhs = rhs; }
+
+template <class Alloc>
+void alloc_on_copy_aux(Alloc&, const Alloc&, m_false_type) {}
+
+template <class Alloc>
+void alloc_on_copy(Alloc& lhs, const Alloc& rhs)
+{
+  typedef typename allocator_traits<Alloc>::propagate_on_container_copy_assignment pocca;
+  alloc_on_copy_aux(lhs, rhs, m_bool_constant<pocca::value>());
+}
+
+template <class Alloc>
+void alloc_on_move_aux(Alloc& lhs, Alloc& rhs, m_true_type)
+{ lhs = mystl::move(rhs); }
+
+template <class Alloc>
+void alloc_on_move_aux(Alloc&, Alloc&, m_false_type) {}
+
+template <class Alloc>
+void alloc_on_move(Alloc& lhs, Alloc& rhs)
+{
+  typedef typename allocator_traits<Alloc>::propagate_on_container_move_assignment pocma;
+  alloc_on_move_aux(lhs, rhs, m_bool_constant<pocma::value>());
+}
+
+template <class Alloc>
+void alloc_on_swap_aux(Alloc& lhs, Alloc& rhs, m_true_type)
+{ mystl::swap(lhs, rhs); }
+
+template <class Alloc>
+void alloc_on_swap_aux(Alloc&, Alloc&, m_false_type) {}
+
+template <class Alloc>
+void alloc_on_swap(Alloc& lhs, Alloc& rhs)
+{
+  typedef typename allocator_traits<Alloc>::propagate_on_container_swap pocs;
+  alloc_on_swap_aux(lhs, rhs, m_bool_constant<pocs::value>());
+}
+
+// 移动赋值时能否直接接管对方的内存：配置器会随之移动，或者两者总是相等
+template <class Alloc>
+struct alloc_move_steals : m_bool_constant<
+  allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+  allocator_traits<Alloc>::is_always_equal::value> {};
+
+// 模板类 : alloc_holder
+// 容器以它为基类保存配置器，配置器为空类时利用空基类优化，不占用额外空间
+template <class Alloc, bool = std::is_empty<Alloc>::value>
+class alloc_holder : private Alloc
+{
+public:
+  alloc_holder() : Alloc() {}
+  explicit alloc_holder(const Alloc& a) : Alloc(a) {}
+  explicit alloc_holder(Alloc&& a) : Alloc(mystl::move(a)) {}
+
+  Alloc&       get_alloc() noexcept       { return *this; }
+  const Alloc& get_alloc() const noexcept { return *this; }
+};
+
+template <class Alloc>
+class alloc_holder<Alloc, false>
+{
+private:
+  Alloc alloc_;
+
+public:
+  alloc_holder() : alloc_() {}
+  explicit alloc_holder(const Alloc& a) : alloc_(a) {}
+  explicit alloc_holder(Alloc&& a) : alloc_(mystl::move(a)) {}
+
+  Alloc&       get_alloc() noexcept       { return alloc_; }
+  const Alloc& get_alloc() const noexcept { return alloc_; }
+};
+
+// 容器的 memory_usage() 返回的堆内存占用，不含容器对象本身
+// payload  : 元素本身占用的字节数
+// overhead : 其余的字节数，包括未使用的容量、deque 的 map、hashtable 的 bucket 数组、节点中的指针以及哨兵节点
+struct memory_usage_info
+{
+  size_t payload;
+  size_t overhead;
+
+  size_t total() const noexcept { return payload + overhead; }
+};
+
 } // namespace mystl
 #endif // !MYTINYSTL_ALLOCATOR_H_
 
@@ -2,13 +2,14 @@
 #define MYTINYSTL_BASIC_STRING_H_
 
 // 这个头文件包含一个模板类 basic_string
-// 用于表示字符串类型
+// 用于表示字符串类型，扩容的方式由模板参数 Growth 决定，缺省使用 string_growth（1.5 倍增长，初始容量 STRING_INIT_SIZE）
 
 #include <iostream>
 
 #include "iterator.h"
 #include "memory.h"
 #include "functional.h"
+#include "growth_policy.h"
 #include "exceptdef.h"
 
 namespace mystl
@@ -268,41 +269,42 @@ struct char_traits<char32_t>
   }
 };
 
-// 初始化 basic_string 尝试分配的最小 buffer 大小，可能被忽略
-#define STRING_INIT_SIZE 32
-
 // 模板类 basic_string
-// 参数一代表字符类型，参数二代表萃取字符类型的方式，缺省使用 mystl::char_traits
-template <class CharType, class CharTraits = mystl::char_traits<CharType>>
-class basic_string
+// 参数一代表字符类型，参数二代表萃取字符类型的方式，缺省使用 mystl::char_traits，参数四代表扩容策略
+template <class CharType, class CharTraits = mystl::char_traits<CharType>,
+          class Alloc = mystl::allocator<CharType>, class Growth = mystl::string_growth>
+class basic_string : private mystl::alloc_holder<Alloc>
 {
 public:
   typedef CharTraits                               traits_type;
   typedef CharTraits                               char_traits;
 
-  typedef mystl::allocator<CharType>               allocator_type;//对于不同的对象，内存分配器的类型也不相同
-  typedef mystl::allocator<CharType>               data_allocator;
+  typedef Alloc                                    allocator_type;//对于不同的对象，内存分配器的类型也不相同
+  typedef mystl::allocator_traits<Alloc>           alloc_traits;
+  typedef Growth                                   growth_policy_type;
 
-  typedef typename allocator_type::value_type      value_type;//实际上就是CharType
-  typedef typename allocator_type::pointer         pointer;
-  typedef typename allocator_type::const_pointer   const_pointer;
-  typedef typename allocator_type::reference       reference;
-  typedef typename allocator_type::const_reference const_reference;
-  typedef typename allocator_type::size_type       size_type;
-  typedef typename allocator_type::difference_type difference_type;
+  typedef CharType                                 value_type;
+  typedef CharType*                                pointer;
+  typedef const CharType*                          const_pointer;
+  typedef CharType&                                reference;
+  typedef const CharType&                          const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
 
   typedef value_type*                              iterator;//把底层指针命名为迭代器
   typedef const value_type*                        const_iterator;
   typedef mystl::reverse_iterator<iterator>        reverse_iterator;
   typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
 
-  allocator_type get_allocator() { return allocator_type(); }//allocator_type是实例化的类，加括号以后就是构造一个对象
+  allocator_type get_allocator() const { return this->get_alloc(); }
   //这里用的是合成的构造函数
   //assert是运行时断言，只有在执行到assert时才会进行判断。而static_assert是在编译时进行断言。所以断言的条件必须是编译时即可确定
   static_assert(std::is_pod<CharType>::value, "Character type of basic_string must be a POD");
   //对于同一个string，其底层字符类型必须和萃取字符方法所获得的字符类型相同
   static_assert(std::is_same<CharType, typename traits_type::char_type>::value,
                 "CharType must be same as traits_type::char_type");
+  static_assert(std::is_same<CharType, typename Alloc::value_type>::value,
+                "CharType must be same as Alloc::value_type");
 
 public:
   // 末尾位置的值，例:
@@ -310,6 +312,8 @@ public:
   static constexpr size_type npos = static_cast<size_type>(-1);
 
 private://注意这里是私有的，对象无法访问
+  typedef mystl::alloc_holder<Alloc>               base_holder;
+
   iterator  buffer_;  // 储存字符串的起始位置，其实是个指针
   size_type size_;    // 大小
   size_type cap_;     // 容量
@@ -320,8 +324,12 @@ public:
   basic_string() noexcept
   { try_init(); }
 
-  basic_string(size_type n, value_type ch)
-    :buffer_(nullptr), size_(0), cap_(0)
+  explicit basic_string(const allocator_type& alloc) noexcept
+    :base_holder(alloc)
+  { try_init(); }
+
+  basic_string(size_type n, value_type ch, const allocator_type& alloc = allocator_type())
+    :base_holder(alloc), buffer_(nullptr), size_(0), cap_(0)
   {
     fill_init(n, ch);
   }
@@ -337,13 +345,13 @@ public:
     init_from(other.buffer_, pos, count);
   }
 
-  basic_string(const_pointer str)
-    :buffer_(nullptr), size_(0), cap_(0)
+  basic_string(const_pointer str, const allocator_type& alloc = allocator_type())
+    :base_holder(alloc), buffer_(nullptr), size_(0), cap_(0)
   {//init_from需要指定开始位置和字符个数，这里是完全复制
     init_from(str, 0, char_traits::length(str));
   }
-  basic_string(const_pointer str, size_type count)
-    :buffer_(nullptr), size_(0), cap_(0)
+  basic_string(const_pointer str, size_type count, const allocator_type& alloc = allocator_type())
+    :base_holder(alloc), buffer_(nullptr), size_(0), cap_(0)
   {
     init_from(str, 0, count);
   }
@@ -352,24 +360,49 @@ public:
   //注意这是一个构造函数，没有返回值，这是用两个迭代器之间的值去初始化basic_string
   //Iter是模板构造函数的模板参数，另一个参数是一个类型，如果Iter迭代器是输入迭代器，那么类型为int，并且有默认值0
   //否则的话另一个参数不存在
-  basic_string(Iter first, Iter last)
+  basic_string(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+    :base_holder(alloc)
   { copy_init(first, last, iterator_category(first)); }
 
   basic_string(const basic_string& rhs) 
-    :buffer_(nullptr), size_(0), cap_(0)
+    :base_holder(alloc_traits::select_on_container_copy_construction(rhs.get_alloc())),
+    buffer_(nullptr), size_(0), cap_(0)
+  {
+    init_from(rhs.buffer_, 0, rhs.size_);
+  }
+  basic_string(const basic_string& rhs, const allocator_type& alloc)
+    :base_holder(alloc), buffer_(nullptr), size_(0), cap_(0)
   {
     init_from(rhs.buffer_, 0, rhs.size_);
   }
   basic_string(basic_string&& rhs) noexcept
-    :buffer_(rhs.buffer_), size_(rhs.size_), cap_(rhs.cap_)
+    :base_holder(mystl::move(rhs.get_alloc())),
+    buffer_(rhs.buffer_), size_(rhs.size_), cap_(rhs.cap_)
   {//转移构造函数，临时对象会被销毁
     rhs.buffer_ = nullptr;
     rhs.size_ = 0;
     rhs.cap_ = 0;
   }
+  basic_string(basic_string&& rhs, const allocator_type& alloc)
+    :base_holder(alloc), buffer_(nullptr), size_(0), cap_(0)
+  {//配置器不相等时只能复制字符
+    if (this->get_alloc() == rhs.get_alloc())
+    {
+      buffer_ = rhs.buffer_;
+      size_ = rhs.size_;
+      cap_ = rhs.cap_;
+      rhs.buffer_ = nullptr;
+      rhs.size_ = 0;
+      rhs.cap_ = 0;
+    }
+    else
+    {
+      init_from(rhs.buffer_, 0, rhs.size_);
+    }
+  }
 
   basic_string& operator=(const basic_string& rhs);//拷贝赋值
-  basic_string& operator=(basic_string&& rhs) noexcept;//移动赋值
+  basic_string& operator=(basic_string&& rhs) noexcept(alloc_move_steals<Alloc>::value);//移动赋值
 
   basic_string& operator=(const_pointer str);
   basic_string& operator=(value_type ch);
@@ -418,6 +451,8 @@ public:
   { return size_; }
   size_type capacity() const noexcept
   { return cap_; }
+  memory_usage_info memory_usage() const noexcept
+  { return memory_usage_info{ size_ * sizeof(CharType), (cap_ - size_) * sizeof(CharType) }; }
   size_type max_size() const noexcept
   { return static_cast<size_type>(-1); }//-1的二进制表示全都是1，将其转换为size_type就能得到最大的值，这样在各种机器上都能适用
 
@@ -530,6 +565,14 @@ public:
   { resize(count, value_type()); }//默认构造一个value_type对象？
   void resize(size_type count, value_type ch);
 
+  // 增加的字符不初始化，由调用者随后写入
+  void resize_default_init(size_type count);
+
+  // 把空间扩大到至少 count 个字符，调用 op(data(), count) 直接写入，
+  // op 返回写入后的长度（不超过 count），作为新的 size
+  template <class Operation>
+  void resize_and_overwrite(size_type count, Operation op);
+
   void     clear() noexcept
   { size_ = 0; }//只是把size变成0了
 
@@ -711,6 +754,9 @@ private:
   // shrink_to_fit
   void          reinsert(size_type size);
 
+  // deallocate
+  void          deallocate_buffer(pointer p, size_type n);
+
   // append
   template <class Iter>
   basic_string& append_range(Iter first, Iter last);
@@ -724,6 +770,14 @@ private:
   template <class Iter>
   basic_string& replace_copy(const_iterator first, const_iterator last, Iter first2, Iter last2);
 
+  // 申请至少 n 个字符的空间，n 更新为实际可以容纳的个数
+  pointer       allocate_space(size_type& n)
+  {
+    auto r = alloc_traits::allocate_at_least(this->get_alloc(), n);
+    n = r.count;
+    return r.ptr;
+  }
+
   // reallocate
   void          reallocate(size_type need);
   iterator      reallocate_and_fill(iterator pos, size_type n, value_type ch);
@@ -733,14 +787,20 @@ private:
 /*****************************************************************************************/
 
 // 复制赋值操作符
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>&//返回值
-basic_string<CharType, CharTraits>:://表明是哪个类的成员函数
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>&//返回值
+basic_string<CharType, CharTraits, Alloc, Growth>:://表明是哪个类的成员函数
 operator=(const basic_string& rhs)
 {
   if (this != &rhs)//避免自赋值
   {
-    basic_string tmp(rhs);//调用构造函数
+    if (alloc_traits::propagate_on_container_copy_assignment::value &&
+        this->get_alloc() != rhs.get_alloc())
+    { // 配置器要随之复制，旧的内存必须先用旧的配置器释放
+      destroy_buffer();
+      mystl::alloc_on_copy(this->get_alloc(), rhs.get_alloc());
+    }
+    basic_string tmp(rhs, this->get_alloc());//用当前的配置器复制一份
     swap(tmp);//调用move函数转移资源，相当于先把this给转移出去，再把rhs转移给this，再把转移出去的给rhs，
               //这里就要求不能自赋值，因为this转移出去后对象就不存在了，rhs不存在
   }
@@ -748,12 +808,21 @@ operator=(const basic_string& rhs)
 }
 
 // 移动赋值操作符
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::
-operator=(basic_string&& rhs) noexcept
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>&
+basic_string<CharType, CharTraits, Alloc, Growth>::
+operator=(basic_string&& rhs) noexcept(alloc_move_steals<Alloc>::value)
 {
-  destroy_buffer();//先销毁this，这里不需要考虑自赋值，因为销毁是绝对安全的
+  if (this == &rhs)
+    return *this;
+  if (!alloc_move_steals<Alloc>::value && this->get_alloc() != rhs.get_alloc())
+  { // 配置器不传播且不相等，不能接管 rhs 的内存，只能复制字符
+    basic_string tmp(rhs.buffer_, rhs.size_, this->get_alloc());
+    swap(tmp);
+    return *this;
+  }
+  destroy_buffer();//先销毁this
+  mystl::alloc_on_move(this->get_alloc(), rhs.get_alloc());
   buffer_ = rhs.buffer_;//然后赋值
   size_ = rhs.size_;
   cap_ = rhs.cap_;
@@ -764,18 +833,19 @@ operator=(basic_string&& rhs) noexcept
 }
 
 // 用一个字符串赋值
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>&
+basic_string<CharType, CharTraits, Alloc, Growth>::
 operator=(const_pointer str)
 {
   const size_type len = char_traits::length(str);
   if (cap_ < len)
   {
-    auto new_buffer = data_allocator::allocate(len + 1);//新申请一块内存
-    data_allocator::deallocate(buffer_);//销毁当前内存
+    size_type new_cap = len + 1;
+    auto new_buffer = allocate_space(new_cap);//新申请一块内存
+    deallocate_buffer(buffer_, cap_);//销毁当前内存
     buffer_ = new_buffer;//变成新的内存地址
-    cap_ = len + 1;
+    cap_ = new_cap;
   }
   char_traits::copy(buffer_, str, len);//内存拷贝
   size_ = len;
@@ -783,17 +853,18 @@ operator=(const_pointer str)
 }
 
 // 用一个字符赋值
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>&
+basic_string<CharType, CharTraits, Alloc, Growth>::
 operator=(value_type ch)
 {//和上面的一样
   if (cap_ < 1)
   {
-    auto new_buffer = data_allocator::allocate(2);
-    data_allocator::deallocate(buffer_);
+    size_type new_cap = 2;
+    auto new_buffer = allocate_space(new_cap);
+    deallocate_buffer(buffer_, cap_);
     buffer_ = new_buffer;
-    cap_ = 2;
+    cap_ = new_cap;
   }
   *buffer_ = ch;
   size_ = 1;
@@ -801,36 +872,37 @@ operator=(value_type ch)
 }
 
 // 预留储存空间
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>:://返回值为空
+template <class CharType, class CharTraits, class Alloc, class Growth>
+void basic_string<CharType, CharTraits, Alloc, Growth>:://返回值为空
 reserve(size_type n)
 {
   if (cap_ < n)
   {
     THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size()"
                           "in basic_string<Char,Traits>::reserve(n)");
-    auto new_buffer = data_allocator::allocate(n);//申请一块新内存
+    auto new_buffer = allocate_space(n);//申请一块新内存，n 变为实际的容量
     char_traits::move(new_buffer, buffer_, size_);//把内容转移过去，move是内存操作，更快
+    deallocate_buffer(buffer_, cap_);//释放原有内存
     buffer_ = new_buffer;//新地址
     cap_ = n;
   }
 }
 
 // 减少不用的空间
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+void basic_string<CharType, CharTraits, Alloc, Growth>::
 shrink_to_fit()
 {
-  if (size_ != cap_)
-  {
-    reinsert(size_);
+  if (size_ + 1 < cap_)
+  {//保留一个位置给末尾的 \0
+    reinsert(size_ + 1);
   }
 }
 
 // 在 pos 处插入一个元素
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator//返回一个迭代器
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::iterator//返回一个迭代器
+basic_string<CharType, CharTraits, Alloc, Growth>::
 insert(const_iterator pos, value_type ch)
 {
   iterator r = const_cast<iterator>(pos);//强行去掉const
@@ -845,9 +917,9 @@ insert(const_iterator pos, value_type ch)
 }
 
 // 在 pos 处插入 n 个元素
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::iterator
+basic_string<CharType, CharTraits, Alloc, Growth>::
 insert(const_iterator pos, size_type count, value_type ch)
 {
   iterator r = const_cast<iterator>(pos);
@@ -870,10 +942,10 @@ insert(const_iterator pos, size_type count, value_type ch)
 }
 
 // 在 pos 处插入 [first, last) 内的元素
-template <class CharType, class CharTraits>
+template <class CharType, class CharTraits, class Alloc, class Growth>
 template <class Iter>//模板函数本身的模板参数
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::
+typename basic_string<CharType, CharTraits, Alloc, Growth>::iterator
+basic_string<CharType, CharTraits, Alloc, Growth>::
 insert(const_iterator pos, Iter first, Iter last)
 {
   iterator r = const_cast<iterator>(pos);
@@ -897,9 +969,9 @@ insert(const_iterator pos, Iter first, Iter last)
 }
 
 // 在末尾添加 count 个 ch
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>& 
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>& 
+basic_string<CharType, CharTraits, Alloc, Growth>::
 append(size_type count, value_type ch)
 {
   THROW_LENGTH_ERROR_IF(size_ > max_size() - count,//这里为什么不是和cap比较？意思是申请所有内存都不够才会报错？
@@ -914,9 +986,9 @@ append(size_type count, value_type ch)
 }
 
 // 在末尾添加 [str[pos] str[pos+count]) 一段
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>& 
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>& 
+basic_string<CharType, CharTraits, Alloc, Growth>::
 append(const basic_string& str, size_type pos, size_type count)
 {
   THROW_LENGTH_ERROR_IF(size_ > max_size() - count,
@@ -933,9 +1005,9 @@ append(const basic_string& str, size_type pos, size_type count)
 }
 
 // 在末尾添加 [s, s+count) 一段
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>& 
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>& 
+basic_string<CharType, CharTraits, Alloc, Growth>::
 append(const_pointer s, size_type count)
 {
   THROW_LENGTH_ERROR_IF(size_ > max_size() - count,
@@ -950,9 +1022,9 @@ append(const_pointer s, size_type count)
 }
 
 // 删除 pos 处的元素
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::iterator
+basic_string<CharType, CharTraits, Alloc, Growth>::
 erase(const_iterator pos)
 {
   MYSTL_DEBUG(pos != end());//pos不能等于end，因为这里没有元素
@@ -963,9 +1035,9 @@ erase(const_iterator pos)
 }
 
 // 删除 [first, last) 的元素
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::iterator
+basic_string<CharType, CharTraits, Alloc, Growth>::
 erase(const_iterator first, const_iterator last)
 {
   if (first == begin() && last == end())
@@ -983,8 +1055,8 @@ erase(const_iterator first, const_iterator last)
 }
 
 // 重置容器大小
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+void basic_string<CharType, CharTraits, Alloc, Growth>::
 resize(size_type count, value_type ch)
 {
   if (count < size_)
@@ -997,17 +1069,46 @@ resize(size_type count, value_type ch)
   }
 }
 
+template <class CharType, class CharTraits, class Alloc, class Growth>
+void basic_string<CharType, CharTraits, Alloc, Growth>::
+resize_default_init(size_type count)
+{
+  if (count > cap_)
+  {
+    THROW_LENGTH_ERROR_IF(count > max_size(),
+                          "basic_string<Char, Tratis>'s size too big");
+    reallocate(count - size_);
+  }
+  size_ = count;
+}
+
+template <class CharType, class CharTraits, class Alloc, class Growth>
+template <class Operation>
+void basic_string<CharType, CharTraits, Alloc, Growth>::
+resize_and_overwrite(size_type count, Operation op)
+{
+  if (count > cap_)
+  {
+    THROW_LENGTH_ERROR_IF(count > max_size(),
+                          "basic_string<Char, Tratis>'s size too big");
+    reallocate(count - size_);
+  }
+  const auto r = static_cast<size_type>(op(buffer_, count));
+  MYSTL_DEBUG(r <= count);
+  size_ = r;
+}
+
 // 比较两个 basic_string，小于返回 -1，大于返回 1，等于返回 0
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+int basic_string<CharType, CharTraits, Alloc, Growth>::
 compare(const basic_string& other) const
 {//其实就是比较字符数组
   return compare_cstr(buffer_, size_, other.buffer_, other.size_);
 }
 
 // 从 pos1 下标开始的 count1 个字符跟另一个 basic_string 比较
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+int basic_string<CharType, CharTraits, Alloc, Growth>::
 compare(size_type pos1, size_type count1, const basic_string& other) const
 {
   auto n1 = mystl::min(count1, size_ - pos1);//最多比较这么多字符
@@ -1015,8 +1116,8 @@ compare(size_type pos1, size_type count1, const basic_string& other) const
 }
 
 // 从 pos1 下标开始的 count1 个字符跟另一个 basic_string 下标 pos2 开始的 count2 个字符比较
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+int basic_string<CharType, CharTraits, Alloc, Growth>::
 compare(size_type pos1, size_type count1, const basic_string& other,
         size_type pos2, size_type count2) const
 {
@@ -1026,8 +1127,8 @@ compare(size_type pos1, size_type count1, const basic_string& other,
 }
 
 // 跟一个字符串比较
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+int basic_string<CharType, CharTraits, Alloc, Growth>::
 compare(const_pointer s) const
 {
   auto n2 = char_traits::length(s);
@@ -1035,8 +1136,8 @@ compare(const_pointer s) const
 }
 
 // 从下标 pos1 开始的 count1 个字符跟另一个字符串比较
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+int basic_string<CharType, CharTraits, Alloc, Growth>::
 compare(size_type pos1, size_type count1, const_pointer s) const
 {
   auto n1 = mystl::min(count1, size_ - pos1);
@@ -1045,8 +1146,8 @@ compare(size_type pos1, size_type count1, const_pointer s) const
 }
 
 // 从下标 pos1 开始的 count1 个字符跟另一个字符串的前 count2 个字符比较
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+int basic_string<CharType, CharTraits, Alloc, Growth>::
 compare(size_type pos1, size_type count1, const_pointer s, size_type count2) const
 {
   auto n1 = mystl::min(count1, size_ - pos1);
@@ -1054,8 +1155,8 @@ compare(size_type pos1, size_type count1, const_pointer s, size_type count2) con
 }
 
 // 反转 basic_string
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+void basic_string<CharType, CharTraits, Alloc, Growth>::
 reverse() noexcept
 {
   for (auto i = begin(), j = end(); i < j;)
@@ -1065,12 +1166,15 @@ reverse() noexcept
 }
 
 // 交换两个 basic_string
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+void basic_string<CharType, CharTraits, Alloc, Growth>::
 swap(basic_string& rhs) noexcept
 {
   if (this != &rhs)
   {//防止自交换，因为mystl::swap会现将lhs给转成右值转移给临时对象
+    MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value ||
+                this->get_alloc() == rhs.get_alloc());
+    mystl::alloc_on_swap(this->get_alloc(), rhs.get_alloc());
     mystl::swap(buffer_, rhs.buffer_);
     mystl::swap(size_, rhs.size_);
     mystl::swap(cap_, rhs.cap_);
@@ -1078,9 +1182,9 @@ swap(basic_string& rhs) noexcept
 }
 
 // 从下标 pos 开始查找字符为 ch 的元素，若找到返回其下标，否则返回 npos
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type//返回一个size_type的下标
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type//返回一个size_type的下标
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find(value_type ch, size_type pos) const noexcept
 {
   for (auto i = pos; i < size_; ++i)
@@ -1092,9 +1196,9 @@ find(value_type ch, size_type pos) const noexcept
 }
 
 // 从下标 pos 开始查找字符串 str，若找到返回起始位置的下标，否则返回 npos
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find(const_pointer str, size_type pos) const noexcept
 {
   const auto len = char_traits::length(str);//注意str是一个数组指针，因此需要专门针对指针进行操作
@@ -1121,9 +1225,9 @@ find(const_pointer str, size_type pos) const noexcept
 }
 
 // 从下标 pos 开始查找字符串 str 的前 count 个字符，若找到返回起始位置的下标，否则返回 npos
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find(const_pointer str, size_type pos, size_type count) const noexcept
 {
   if (count == 0)
@@ -1149,9 +1253,9 @@ find(const_pointer str, size_type pos, size_type count) const noexcept
 }
 
 // 从下标 pos 开始查找字符串 str，若找到返回起始位置的下标，否则返回 npos
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find(const basic_string& str, size_type pos) const noexcept//上面字符串用指针表示，这里用string表示
 {
   const size_type count = str.size_;//这里就不需要对指针操作了
@@ -1178,9 +1282,9 @@ find(const basic_string& str, size_type pos) const noexcept//上面字符串用
 }
 
 // 从下标 pos 开始反向查找值为 ch 的元素，与 find 类似
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 rfind(value_type ch, size_type pos) const noexcept
 {
   if (pos >= size_)
@@ -1195,9 +1299,9 @@ rfind(value_type ch, size_type pos) const noexcept
 }
 
 // 从下标 pos 开始反向查找字符串 str，与 find 类似
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 rfind(const_pointer str, size_type pos) const noexcept
 {
   if (pos >= size_)
@@ -1239,9 +1343,9 @@ rfind(const_pointer str, size_type pos) const noexcept
 }
 
 // 从下标 pos 开始反向查找字符串 str 前 count 个字符，与 find 类似
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 rfind(const_pointer str, size_type pos, size_type count) const noexcept
 {
   if (count == 0)
@@ -1268,9 +1372,9 @@ rfind(const_pointer str, size_type pos, size_type count) const noexcept
 }
 
 // 从下标 pos 开始反向查找字符串 str，与 find 类似
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 rfind(const basic_string& str, size_type pos) const noexcept
 {
   const size_type count = str.size_;
@@ -1298,9 +1402,9 @@ rfind(const basic_string& str, size_type pos) const noexcept
 }
 
 // 从下标 pos 开始查找 ch 出现的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find_first_of(value_type ch, size_type pos) const noexcept
 {
   for (auto i = pos; i < size_; ++i)
@@ -1312,9 +1416,9 @@ find_first_of(value_type ch, size_type pos) const noexcept
 }
 
 // 从下标 pos 开始查找字符串 s 其中的一个字符出现的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find_first_of(const_pointer s, size_type pos) const noexcept
 {
   const size_type len = char_traits::length(s);
@@ -1331,9 +1435,9 @@ find_first_of(const_pointer s, size_type pos) const noexcept
 }
 
 // 从下标 pos 开始查找字符串 s 的[0:count)个其中的一个字符出现的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find_first_of(const_pointer s, size_type pos, size_type count) const noexcept
 {
   for (auto i = pos; i < size_; ++i)
@@ -1349,9 +1453,9 @@ find_first_of(const_pointer s, size_type pos, size_type count) const noexcept
 }
 
 // 从下标 pos 开始查找字符串 str 其中一个字符出现的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find_first_of(const basic_string& str, size_type pos) const noexcept
 {
   for (auto i = pos; i < size_; ++i)
@@ -1367,9 +1471,9 @@ find_first_of(const basic_string& str, size_type pos) const noexcept
 }
 
 // 从下标 pos 开始查找与 ch 不相等的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find_first_not_of(value_type ch, size_type pos) const noexcept
 {
   for (auto i = pos; i < size_; ++i)
@@ -1381,9 +1485,9 @@ find_first_not_of(value_type ch, size_type pos) const noexcept
 }
 
 // 从下标 pos 开始查找与字符串 s 其中一个字符不相等的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find_first_not_of(const_pointer s, size_type pos) const noexcept
 {
   const size_type len = char_traits::length(s);
@@ -1400,9 +1504,9 @@ find_first_not_of(const_pointer s, size_type pos) const noexcept
 }
 
 // 从下标 pos 开始查找与字符串 s 前 count 个字符中不相等的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find_first_not_of(const_pointer s, size_type pos, size_type count) const noexcept
 {
   for (auto i = pos; i < size_; ++i)
@@ -1418,9 +1522,9 @@ find_first_not_of(const_pointer s, size_type pos, size_type count) const noexcep
 }
 
 // 从下标 pos 开始查找与字符串 str 的字符中不相等的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find_first_not_of(const basic_string& str, size_type pos) const noexcept
 {
   for (auto i = pos; i < size_; ++i)
@@ -1436,9 +1540,9 @@ find_first_not_of(const basic_string& str, size_type pos) const noexcept
 }
 
 // 从下标 pos 开始查找与 ch 相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find_last_of(value_type ch, size_type pos) const noexcept//和rfind差不多
 {
   for (auto i = size_ - 1; i >= pos; --i)
@@ -1450,9 +1554,9 @@ find_last_of(value_type ch, size_type pos) const noexcept//和rfind差不多
 }
 
 // 从下标 pos 开始查找与字符串 s 其中一个字符相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find_last_of(const_pointer s, size_type pos) const noexcept
 {
   const size_type len = char_traits::length(s);
@@ -1469,9 +1573,9 @@ find_last_of(const_pointer s, size_type pos) const noexcept
 }
 
 // 从下标 pos 开始查找与字符串 s 前 count 个字符中相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find_last_of(const_pointer s, size_type pos, size_type count) const noexcept
 {
   for (auto i = size_ - 1; i >= pos; --i)
@@ -1487,9 +1591,9 @@ find_last_of(const_pointer s, size_type pos, size_type count) const noexcept
 }
 
 // 从下标 pos 开始查找与字符串 str 字符中相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find_last_of(const basic_string& str, size_type pos) const noexcept
 {
   for (auto i = size_ - 1; i >= pos; --i)
@@ -1505,9 +1609,9 @@ find_last_of(const basic_string& str, size_type pos) const noexcept
 }
 
 // 从下标 pos 开始查找与 ch 字符不相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find_last_not_of(value_type ch, size_type pos) const noexcept
 {
   for (auto i = size_ - 1; i >= pos; --i)
@@ -1519,9 +1623,9 @@ find_last_not_of(value_type ch, size_type pos) const noexcept
 }
 
 // 从下标 pos 开始查找与字符串 s 的字符中不相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find_last_not_of(const_pointer s, size_type pos) const noexcept
 {
   const size_type len = char_traits::length(s);
@@ -1538,9 +1642,9 @@ find_last_not_of(const_pointer s, size_type pos) const noexcept
 }
 
 // 从下标 pos 开始查找与字符串 s 前 count 个字符中不相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find_last_not_of(const_pointer s, size_type pos, size_type count) const noexcept
 {
   for (auto i = size_ - 1; i >= pos; --i)
@@ -1556,9 +1660,9 @@ find_last_not_of(const_pointer s, size_type pos, size_type count) const noexcept
 }
 
 // 从下标 pos 开始查找与字符串 str 字符中不相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 find_last_not_of(const basic_string& str, size_type pos) const noexcept
 {
   for (auto i = size_ - 1; i >= pos; --i)
@@ -1574,9 +1678,9 @@ find_last_not_of(const basic_string& str, size_type pos) const noexcept
 }
 
 // 返回从下标 pos 开始字符为 ch 的元素出现的次数
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::size_type
+basic_string<CharType, CharTraits, Alloc, Growth>::
 count(value_type ch, size_type pos) const noexcept
 {
   size_type n = 0;
@@ -1592,15 +1696,16 @@ count(value_type ch, size_type pos) const noexcept
 // helper function
 
 // 尝试初始化一段 buffer，若分配失败则忽略，不会抛出异常
-template <class CharType, class CharTraits>//模板类的成员函数必须要写成这样
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>//模板类的成员函数必须要写成这样
+void basic_string<CharType, CharTraits, Alloc, Growth>::
 try_init() noexcept
 {
   try
   {
-    buffer_ = data_allocator::allocate(static_cast<size_type>(STRING_INIT_SIZE));//尝试分配32字节大小的空间
-    size_ = 0;//分配成功为什么size和cap还是0？因为调用这个函数只有是默认构造函数里面，没有任何初始化工作
-    cap_ = 0;
+    size_type cap = Growth::initial_capacity();
+    buffer_ = cap == 0 ? nullptr : allocate_space(cap);//尝试分配初始容量大小的空间
+    size_ = 0;//分配成功后还没有任何字符
+    cap_ = cap;//容量要和分配的大小一致，释放时按这个大小归还
   }
   catch (...)
   {
@@ -1612,29 +1717,29 @@ try_init() noexcept
 }
 
 // fill_init 函数
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+void basic_string<CharType, CharTraits, Alloc, Growth>::
 fill_init(size_type n, value_type ch)
 {
-  const auto init_size = mystl::max(static_cast<size_type>(STRING_INIT_SIZE), n + 1);//最后一个空间用来存放\0
+  auto init_size = mystl::max(static_cast<size_type>(Growth::initial_capacity()), n + 1);//最后一个空间用来存放\0
   //如果申请的空间小于32字节，那么仍然申请32字节大小的空间
-  buffer_ = data_allocator::allocate(init_size);
+  buffer_ = allocate_space(init_size);
   char_traits::fill(buffer_, ch, n);//调用的是20-210那些char_traits中的fill函数
   size_ = n;//size是实际容量，而cap是总容量
   cap_ = init_size;
 }
 
 // copy_init 函数
-template <class CharType, class CharTraits>//函数在模板类外定义，需要加上模板参数
+template <class CharType, class CharTraits, class Alloc, class Growth>//函数在模板类外定义，需要加上模板参数
 template <class Iter>//模板构造函数的第二个模板参数不一定存在，所以这里没有写
-void basic_string<CharType, CharTraits>::
+void basic_string<CharType, CharTraits, Alloc, Growth>::
 copy_init(Iter first, Iter last, mystl::input_iterator_tag)
 {
   size_type n = mystl::distance(first, last);
-  const auto init_size = mystl::max(static_cast<size_type>(STRING_INIT_SIZE), n + 1);
+  auto init_size = mystl::max(static_cast<size_type>(Growth::initial_capacity()), n + 1);
   try
   {
-    buffer_ = data_allocator::allocate(init_size);//这里只是申请内存，有可能会有异常，所以要写到try里面
+    buffer_ = allocate_space(init_size);//这里只是申请内存，有可能会有异常，所以要写到try里面
     size_ = n;//为什么这里就不是0了？因为这里初始化了，需要往内存里构造对象
     cap_ = init_size;
   }
@@ -1649,16 +1754,16 @@ copy_init(Iter first, Iter last, mystl::input_iterator_tag)
     append(*first);//拷贝过来初始化？这里调用的是哪个函数？似乎是没有实现输入迭代器版本的append
 }
 
-template <class CharType, class CharTraits>
+template <class CharType, class CharTraits, class Alloc, class Growth>
 template <class Iter>
-void basic_string<CharType, CharTraits>::
+void basic_string<CharType, CharTraits, Alloc, Growth>::
 copy_init(Iter first, Iter last, mystl::forward_iterator_tag)//常用的是这个前向迭代器版本的
 {
   const size_type n = mystl::distance(first, last);
-  const auto init_size = mystl::max(static_cast<size_type>(STRING_INIT_SIZE), n + 1);
+  auto init_size = mystl::max(static_cast<size_type>(Growth::initial_capacity()), n + 1);
   try
   {
-    buffer_ = data_allocator::allocate(init_size);
+    buffer_ = allocate_space(init_size);
     size_ = n;
     cap_ = init_size;
     mystl::uninitialized_copy(first, last, buffer_);
@@ -1673,13 +1778,13 @@ copy_init(Iter first, Iter last, mystl::forward_iterator_tag)//常用的是这
 }
 
 // init_from 函数
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+void basic_string<CharType, CharTraits, Alloc, Growth>::
 init_from(const_pointer src, size_type pos, size_type count)
 {//可以给一个常量形参传入非常量，就比如这里我们给const_pointer传入的是other.buffer_，只是一个普通的指针
     //从别的basic_string的内存中拷贝字符，src就是原地址，pos是从原地址的哪个字符开始拷贝，count是拷贝字符的个数
-  const auto init_size = mystl::max(static_cast<size_type>(STRING_INIT_SIZE), count + 1);
-  buffer_ = data_allocator::allocate(init_size);
+  auto init_size = mystl::max(static_cast<size_type>(Growth::initial_capacity()), count + 1);
+  buffer_ = allocate_space(init_size);
   //allocate返回的指针指向开始(最低的字节地址)分配的存储地址
   char_traits::copy(buffer_, src + pos, count);//从src+pos的地址开始，拷贝count个字符到buffer_这块新申请的内存上
   size_ = count;//实际大小是count个字符
@@ -1687,23 +1792,32 @@ init_from(const_pointer src, size_type pos, size_type count)
 }
 
 // destroy_buffer 函数
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+void basic_string<CharType, CharTraits, Alloc, Growth>::
 destroy_buffer()
 {
   if (buffer_ != nullptr)
   {
-    data_allocator::deallocate(buffer_, cap_);//销毁内存空间
+    alloc_traits::deallocate(this->get_alloc(), buffer_, cap_);//销毁内存空间
     buffer_ = nullptr;
     size_ = 0;
     cap_ = 0;
   }
 }
 
+// deallocate_buffer 函数，释放一块由当前配置器分配的内存
+template <class CharType, class CharTraits, class Alloc, class Growth>
+void basic_string<CharType, CharTraits, Alloc, Growth>::
+deallocate_buffer(pointer p, size_type n)
+{
+  if (p != nullptr)
+    alloc_traits::deallocate(this->get_alloc(), p, n);
+}
+
 // to_raw_pointer 函数
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::const_pointer//返回值是一个类型
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::const_pointer//返回值是一个类型
+basic_string<CharType, CharTraits, Alloc, Growth>::
 to_raw_pointer() const
 {
   *(buffer_ + size_) = value_type();//在末尾的位置构造一个默认对象（就是字符数组末尾默认的/0），如果没有这个构造，转换成指针后，如果用指针去访问内存，那么最后一个内存
@@ -1713,29 +1827,22 @@ to_raw_pointer() const
 }
 
 // reinsert 函数，只用来缩小空间？没找到其他用法，为什么不直接合并？
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+void basic_string<CharType, CharTraits, Alloc, Growth>::
 reinsert(size_type size)
 {
-  auto new_buffer = data_allocator::allocate(size);//申请新内存
-  try
-  {
-    char_traits::move(new_buffer, buffer_, size);//尝试转移
-  }
-  catch (...)
-  {
-    data_allocator::deallocate(new_buffer);//抛出任何异常都把新内存释放掉，然后结束此函数运行
-  }
-  buffer_ = new_buffer;//没有发生异常就把新地址换过去，数据已经在try里面转移了
-  size_ = size;
+  auto new_buffer = allocate_space(size);//申请新内存
+  char_traits::move(new_buffer, buffer_, size_);//转移数据，字符的移动不会抛出异常
+  deallocate_buffer(buffer_, cap_);//释放原有内存
+  buffer_ = new_buffer;
   cap_ = size;
 }
 
 // append_range，末尾追加一段 [first, last) 内的字符
-template <class CharType, class CharTraits>//模板类的模板参数
+template <class CharType, class CharTraits, class Alloc, class Growth>//模板类的模板参数
 template <class Iter>//模板类的模板函数的模板参数
-basic_string<CharType, CharTraits>&//返回值，basic_string<CharType, CharTraits>用来实例化模板，生成类
-basic_string<CharType, CharTraits>:://表明这个函数是属于哪个类的成员函数
+basic_string<CharType, CharTraits, Alloc, Growth>&//返回值，basic_string<CharType, CharTraits, Alloc, Growth>用来实例化模板，生成类
+basic_string<CharType, CharTraits, Alloc, Growth>:://表明这个函数是属于哪个类的成员函数
 append_range(Iter first, Iter last)
 {
   const size_type n = mystl::distance(first, last);
@@ -1750,8 +1857,8 @@ append_range(Iter first, Iter last)
   return *this;
 }
 
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+int basic_string<CharType, CharTraits, Alloc, Growth>::
 compare_cstr(const_pointer s1, size_type n1, const_pointer s2, size_type n2) const
 {
   auto rlen = mystl::min(n1, n2);
@@ -1763,9 +1870,9 @@ compare_cstr(const_pointer s1, size_type n1, const_pointer s2, size_type n2) con
 }
 
 // 把 first 开始的 count1 个字符替换成 str 开始的 count2 个字符
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>& 
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>& 
+basic_string<CharType, CharTraits, Alloc, Growth>::
 replace_cstr(const_iterator first, size_type count1, const_pointer str, size_type count2)
 {
   if (static_cast<size_type>(cend() - first) < count1)
@@ -1777,9 +1884,11 @@ replace_cstr(const_iterator first, size_type count1, const_pointer str, size_typ
     const size_type add = count2 - count1;//需要补充的字符个数
     THROW_LENGTH_ERROR_IF(size_ > max_size() - add,//补充的字符太多以至于超过了最大长度
                           "basic_string<Char, Traits>'s size too big");
-    if (size_ > cap_ - add)
+    if (cap_ - size_ < add)
     {//补充的字符太多以至于超过了字符串容量，那么就需要重新申请一块内存
+      const auto pos = first - buffer_;//重新申请内存后 first 会失效
       reallocate(add);
+      first = buffer_ + pos;
     }
     pointer r = const_cast<pointer>(first);//去掉const属性，因为下面要修改
     char_traits::move(r + count2, first + count1, end() - (first + count1));
@@ -1797,9 +1906,9 @@ replace_cstr(const_iterator first, size_type count1, const_pointer str, size_typ
 }
 
 // 把 first 开始的 count1 个字符替换成 count2 个 ch 字符
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>&
+basic_string<CharType, CharTraits, Alloc, Growth>::
 replace_fill(const_iterator first, size_type count1, size_type count2, value_type ch)
 {
   if (static_cast<size_type>(cend() - first) < count1)
@@ -1811,9 +1920,11 @@ replace_fill(const_iterator first, size_type count1, size_type count2, value_typ
     const size_type add = count2 - count1;
     THROW_LENGTH_ERROR_IF(size_ > max_size() - add,
                           "basic_string<Char, Traits>'s size too big");
-    if (size_ > cap_ - add)
+    if (cap_ - size_ < add)
     {
+      const auto pos = first - buffer_;//重新申请内存后 first 会失效
       reallocate(add);
+      first = buffer_ + pos;
     }
     pointer r = const_cast<pointer>(first);
     char_traits::move(r + count2, first + count1, end() - (first + count1));
@@ -1831,10 +1942,10 @@ replace_fill(const_iterator first, size_type count1, size_type count2, value_typ
 }
 
 // 把 [first, last) 的字符替换成 [first2, last2)
-template <class CharType, class CharTraits>
+template <class CharType, class CharTraits, class Alloc, class Growth>
 template <class Iter>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::
+basic_string<CharType, CharTraits, Alloc, Growth>&
+basic_string<CharType, CharTraits, Alloc, Growth>::
 replace_copy(const_iterator first, const_iterator last, Iter first2, Iter last2)
 {
   size_type len1 = last - first;
@@ -1844,9 +1955,11 @@ replace_copy(const_iterator first, const_iterator last, Iter first2, Iter last2)
     const size_type add = len2 - len1;
     THROW_LENGTH_ERROR_IF(size_ > max_size() - add,
                           "basic_string<Char, Traits>'s size too big");
-    if (size_ > cap_ - add)
+    if (cap_ - size_ < add)
     {
+      const auto pos = first - buffer_;//重新申请内存后 first 会失效
       reallocate(add);
+      first = buffer_ + pos;
     }
     pointer r = const_cast<pointer>(first);
     char_traits::move(r + len2, first + len1, end() - (first + len1));
@@ -1864,32 +1977,32 @@ replace_copy(const_iterator first, const_iterator last, Iter first2, Iter last2)
 }
 
 // reallocate 函数，重新申请一块内存
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+void basic_string<CharType, CharTraits, Alloc, Growth>::
 reallocate(size_type need)
 {
-  const auto new_cap = mystl::max(cap_ + need, cap_ + (cap_ >> 1));
-  auto new_buffer = data_allocator::allocate(new_cap);//新内存的地址
+  auto new_cap = Growth::next_capacity(cap_, need, max_size());
+  auto new_buffer = allocate_space(new_cap);//新内存的地址
   char_traits::move(new_buffer, buffer_, size_);//转移数据
-  data_allocator::deallocate(buffer_);//释放原有内存
+  deallocate_buffer(buffer_, cap_);//释放原有内存
   buffer_ = new_buffer;
   cap_ = new_cap;
 }
 
 // reallocate_and_fill 函数
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::iterator
+basic_string<CharType, CharTraits, Alloc, Growth>::
 reallocate_and_fill(iterator pos, size_type n, value_type ch)
 {//重新申请内存，并在pos的地方插入n个ch
   const auto r = pos - buffer_;
   const auto old_cap = cap_;
-  const auto new_cap = mystl::max(old_cap + n, old_cap + (old_cap >> 1));//如果n小于old_cap的一半，则直接申请一半的内存
-  auto new_buffer = data_allocator::allocate(new_cap);
+  auto new_cap = Growth::next_capacity(old_cap, n, max_size());//至少增加 n，通常按策略的倍数增长
+  auto new_buffer = allocate_space(new_cap);
   auto e1 = char_traits::move(new_buffer, buffer_, r) + r;//move把原始数据的r个元素移动到新内存，返回的是新地址的首迭代器，再加上r
   auto e2 = char_traits::fill(e1, ch, n) + n;//然后填充n个ch到新内存的末尾
   char_traits::move(e2, buffer_ + r, size_ - r);//再把原始数据剩余的元素移动到新内存
-  data_allocator::deallocate(buffer_, old_cap);//析构原内存
+  deallocate_buffer(buffer_, old_cap);//析构原内存
   buffer_ = new_buffer;
   size_ += n;
   cap_ = new_cap;
@@ -1897,20 +2010,20 @@ reallocate_and_fill(iterator pos, size_type n, value_type ch)
 }
 
 // reallocate_and_copy 函数
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::
+template <class CharType, class CharTraits, class Alloc, class Growth>
+typename basic_string<CharType, CharTraits, Alloc, Growth>::iterator
+basic_string<CharType, CharTraits, Alloc, Growth>::
 reallocate_and_copy(iterator pos, const_iterator first, const_iterator last)
 {//重新申请内存，并在pos的地方拷贝[first,last)
   const auto r = pos - buffer_;
   const auto old_cap = cap_;
   const size_type n = mystl::distance(first, last);
-  const auto new_cap = mystl::max(old_cap + n, old_cap + (old_cap >> 1));
-  auto new_buffer = data_allocator::allocate(new_cap);
+  auto new_cap = Growth::next_capacity(old_cap, n, max_size());
+  auto new_buffer = allocate_space(new_cap);
   auto e1 = char_traits::move(new_buffer, buffer_, r) + r;
   auto e2 = mystl::uninitialized_copy_n(first, n, e1) + n;
   char_traits::move(e2, buffer_ + r, size_ - r);
-  data_allocator::deallocate(buffer_, old_cap);
+  deallocate_buffer(buffer_, old_cap);
   buffer_ = new_buffer;
   size_ += n;
   cap_ = new_cap;
@@ -1921,191 +2034,196 @@ reallocate_and_copy(iterator pos, const_iterator first, const_iterator last)
 // 重载全局操作符
 
 // 重载 operator+，这是函数重载，不是成员函数，string+string
-template <class CharType, class CharTraits>//函数模板参数
-basic_string<CharType, CharTraits>//返回值是basic_string的对象，不是指针、引用
-operator+(const basic_string<CharType, CharTraits>& lhs, 
-          const basic_string<CharType, CharTraits>& rhs)//两个参数
+template <class CharType, class CharTraits, class Alloc, class Growth>//函数模板参数
+basic_string<CharType, CharTraits, Alloc, Growth>//返回值是basic_string的对象，不是指针、引用
+operator+(const basic_string<CharType, CharTraits, Alloc, Growth>& lhs, 
+          const basic_string<CharType, CharTraits, Alloc, Growth>& rhs)//两个参数
 {
-  basic_string<CharType, CharTraits> tmp(lhs);//拷贝构造一个临时对象
+  basic_string<CharType, CharTraits, Alloc, Growth> tmp(lhs);//拷贝构造一个临时对象
   tmp.append(rhs);//加到后面
   return tmp;//临时对象不能返回指针、引用
 }
 
 //const char数组 + string
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>//仍然返回一个string
-operator+(const CharType* lhs, const basic_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>//仍然返回一个string
+operator+(const CharType* lhs, const basic_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
-  basic_string<CharType, CharTraits> tmp(lhs);//注意lhs是一个数组的首地址，这里调用的是340行的构造函数
+  basic_string<CharType, CharTraits, Alloc, Growth> tmp(lhs);//注意lhs是一个数组的首地址，这里调用的是340行的构造函数
   tmp.append(rhs);
   return tmp;
 }
 
 //char + string
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(CharType ch, const basic_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>
+operator+(CharType ch, const basic_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
-  basic_string<CharType, CharTraits> tmp(1, ch);//注意ch是一个字符，这里调用的是323行的构造函数
+  basic_string<CharType, CharTraits, Alloc, Growth> tmp(1, ch);//注意ch是一个字符，这里调用的是323行的构造函数
   tmp.append(rhs);
   return tmp;
 }
 
 //string + const char数组
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(const basic_string<CharType, CharTraits>& lhs, const CharType* rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>
+operator+(const basic_string<CharType, CharTraits, Alloc, Growth>& lhs, const CharType* rhs)
 {
-  basic_string<CharType, CharTraits> tmp(lhs);//拷贝构造
+  basic_string<CharType, CharTraits, Alloc, Growth> tmp(lhs);//拷贝构造
   tmp.append(rhs);//注意rhs是指针，调用的是515行的append
   return tmp;
 }
 
 //string + char
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(const basic_string<CharType, CharTraits>& lhs, CharType ch)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>
+operator+(const basic_string<CharType, CharTraits, Alloc, Growth>& lhs, CharType ch)
 {
-  basic_string<CharType, CharTraits> tmp(lhs);
+  basic_string<CharType, CharTraits, Alloc, Growth> tmp(lhs);
   tmp.append(1, ch);
   return tmp;
 }
 
 //右值string+string，调用形式：res=string("abcde")+str1，前面是临时对象，后面是左值
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(basic_string<CharType, CharTraits>&& lhs,
-          const basic_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>
+operator+(basic_string<CharType, CharTraits, Alloc, Growth>&& lhs,
+          const basic_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
-  basic_string<CharType, CharTraits> tmp(mystl::move(lhs));//转移构造
+  basic_string<CharType, CharTraits, Alloc, Growth> tmp(mystl::move(lhs));//转移构造
   tmp.append(rhs);
   return tmp;
 }
 
 //string+右值string，调用形式：res=str1+string("abcde")，前面是左值，后面是临时对象
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(const basic_string<CharType, CharTraits>& lhs,
-          basic_string<CharType, CharTraits>&& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>
+operator+(const basic_string<CharType, CharTraits, Alloc, Growth>& lhs,
+          basic_string<CharType, CharTraits, Alloc, Growth>&& rhs)
 {
-  basic_string<CharType, CharTraits> tmp(mystl::move(rhs));
+  basic_string<CharType, CharTraits, Alloc, Growth> tmp(mystl::move(rhs));
   tmp.insert(tmp.begin(), lhs.begin(), lhs.end());//这里用的就是插入了，可能是为了避免拷贝构造
   return tmp;
 }
 
 //右值string+右值string，调用形式：res=string("ab")+string("cde")
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(basic_string<CharType, CharTraits>&& lhs,
-          basic_string<CharType, CharTraits>&& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>
+operator+(basic_string<CharType, CharTraits, Alloc, Growth>&& lhs,
+          basic_string<CharType, CharTraits, Alloc, Growth>&& rhs)
 {
-  basic_string<CharType, CharTraits> tmp(mystl::move(lhs));
+  basic_string<CharType, CharTraits, Alloc, Growth> tmp(mystl::move(lhs));
   tmp.append(rhs);
   return tmp;
 }
 
 //const char数组+右值string，调用形式：res="ab"+string("cde")
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(const CharType* lhs, basic_string<CharType, CharTraits>&& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>
+operator+(const CharType* lhs, basic_string<CharType, CharTraits, Alloc, Growth>&& rhs)
 {
-  basic_string<CharType, CharTraits> tmp(mystl::move(rhs));
+  basic_string<CharType, CharTraits, Alloc, Growth> tmp(mystl::move(rhs));
   tmp.insert(tmp.begin(), lhs, lhs + char_traits<CharType>::length(lhs));
   return tmp;
 }
 
 //char+右值string，调用形式：res='a'+string("cde")
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(CharType ch, basic_string<CharType, CharTraits>&& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>
+operator+(CharType ch, basic_string<CharType, CharTraits, Alloc, Growth>&& rhs)
 {
-  basic_string<CharType, CharTraits> tmp(mystl::move(rhs));
+  basic_string<CharType, CharTraits, Alloc, Growth> tmp(mystl::move(rhs));
   tmp.insert(tmp.begin(), ch);
   return tmp;
 }
 
 //右值string+const char数组，调用形式：res=string("cde")+"ab"
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(basic_string<CharType, CharTraits>&& lhs, const CharType* rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>
+operator+(basic_string<CharType, CharTraits, Alloc, Growth>&& lhs, const CharType* rhs)
 {
-  basic_string<CharType, CharTraits> tmp(mystl::move(lhs));
+  basic_string<CharType, CharTraits, Alloc, Growth> tmp(mystl::move(lhs));
   tmp.append(rhs);
   return tmp;
 }
 
 //右值string+char，调用形式：res=string("cde")+'a'
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>
-operator+(basic_string<CharType, CharTraits>&& lhs, CharType ch)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+basic_string<CharType, CharTraits, Alloc, Growth>
+operator+(basic_string<CharType, CharTraits, Alloc, Growth>&& lhs, CharType ch)
 {
-  basic_string<CharType, CharTraits> tmp(mystl::move(lhs));
+  basic_string<CharType, CharTraits, Alloc, Growth> tmp(mystl::move(lhs));
   tmp.append(1, ch);
   return tmp;
 }
 
 // 重载比较操作符
-template <class CharType, class CharTraits>
-bool operator==(const basic_string<CharType, CharTraits>& lhs,
-                const basic_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+bool operator==(const basic_string<CharType, CharTraits, Alloc, Growth>& lhs,
+                const basic_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
   return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
 }
 
-template <class CharType, class CharTraits>
-bool operator!=(const basic_string<CharType, CharTraits>& lhs,
-                const basic_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+bool operator!=(const basic_string<CharType, CharTraits, Alloc, Growth>& lhs,
+                const basic_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
   return lhs.size() != rhs.size() || lhs.compare(rhs) != 0;
 }
 
-template <class CharType, class CharTraits>
-bool operator<(const basic_string<CharType, CharTraits>& lhs,
-               const basic_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+bool operator<(const basic_string<CharType, CharTraits, Alloc, Growth>& lhs,
+               const basic_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
   return lhs.compare(rhs) < 0;
 }
 
-template <class CharType, class CharTraits>
-bool operator<=(const basic_string<CharType, CharTraits>& lhs,
-                const basic_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+bool operator<=(const basic_string<CharType, CharTraits, Alloc, Growth>& lhs,
+                const basic_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
   return lhs.compare(rhs) <= 0;
 }
 
-template <class CharType, class CharTraits>
-bool operator>(const basic_string<CharType, CharTraits>& lhs,
-               const basic_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+bool operator>(const basic_string<CharType, CharTraits, Alloc, Growth>& lhs,
+               const basic_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
   return lhs.compare(rhs) > 0;
 }
 
-template <class CharType, class CharTraits>
-bool operator>=(const basic_string<CharType, CharTraits>& lhs,
-                const basic_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+bool operator>=(const basic_string<CharType, CharTraits, Alloc, Growth>& lhs,
+                const basic_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
   return lhs.compare(rhs) >= 0;
 }
 
 // 重载 mystl 的 swap，也就是当调用swap(str1,str2)的时候，就会调用这个函数
-template <class CharType, class CharTraits>
-void swap(basic_string<CharType, CharTraits>& lhs,
-          basic_string<CharType, CharTraits>& rhs) noexcept
+template <class CharType, class CharTraits, class Alloc, class Growth>
+void swap(basic_string<CharType, CharTraits, Alloc, Growth>& lhs,
+          basic_string<CharType, CharTraits, Alloc, Growth>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
 
 // 特化 mystl::hash
-template <class CharType, class CharTraits>
-struct hash<basic_string<CharType, CharTraits>>
+template <class CharType, class CharTraits, class Alloc, class Growth>
+struct hash<basic_string<CharType, CharTraits, Alloc, Growth>>
 {
-  size_t operator()(const basic_string<CharType, CharTraits>& str)
+  size_t operator()(const basic_string<CharType, CharTraits, Alloc, Growth>& str) const noexcept
   {
     return bitwise_hash((const unsigned char*)str.c_str(),
                         str.size() * sizeof(CharType));
   }
 };//这是一个特例化的类，后面要加上分号
 
+// 字符保存在堆上，对象本身不含指向自身的指针，Alloc 可以平凡重定位时容器也可以平凡重定位
+template <class CharType, class CharTraits, class Alloc, class Growth>
+struct is_trivially_relocatable<basic_string<CharType, CharTraits, Alloc, Growth>>
+  : m_bool_constant<is_trivially_relocatable<Alloc>::value> {};
+
 } // namespace mystl
 #endif // !MYTINYSTL_BASIC_STRING_H_
 
@@ -0,0 +1,954 @@
+#ifndef MYTINYSTL_CIRCULAR_BUFFER_H_
+#define MYTINYSTL_CIRCULAR_BUFFER_H_
+
+// 这个头文件包含一个模板类 circular_buffer
+// circular_buffer : 环形缓冲区，元素保存在一块连续的空间中，首尾相接，两端的插入、弹出都是 O(1)
+
+// notes:
+//
+// 1. 容器已满时的行为由 circular_buffer_policy 决定，可以在构造时指定，也可以用 set_policy 修改：
+//      grow      : 按 Growth 扩容（缺省），与 deque 一样可以无限增长
+//      overwrite : push_back 覆盖最旧的元素（头部），push_front 覆盖尾部，容量即窗口的大小
+//      fixed     : 抛出 std::length_error，容器保持不变
+//    try_push_back、try_emplace_back 等在容器已满时总是返回 false，既不扩容也不覆盖
+// 2. 与 vector 一样，构造函数 (n) 与 (n, value) 构造 n 个元素，容量为 n；
+//    reserve、set_capacity 精确地设定容量，set_capacity 缩小容量时丢弃最旧的元素
+// 3. 迭代器记录元素的逻辑位置，是随机迭代器，也是分段迭代器（最多两段），
+//    copy、fill、find 等算法逐段在原生指针上执行；array_one、array_two 直接给出这两段，
+//    linearize 把元素搬成一段连续的空间
+// 4. 可以作为 mystl::queue、mystl::stack 的底层容器
+//
+// 异常保证：
+// mystl::circular_buffer<T> 满足基本异常保证，对以下函数做强异常安全保证：
+//   * emplace_front
+//   * emplace_back
+//   * push_front
+//   * push_back
+
+#include <initializer_list>
+
+#include <cstring>
+
+#include "growth_policy.h"
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "algo.h"
+
+namespace mystl
+{
+
+// 容器已满时的行为
+enum class circular_buffer_policy
+{
+  grow,       // 扩容
+  overwrite,  // 覆盖另一端的元素
+  fixed       // 抛出 std::length_error
+};
+
+// circular_buffer 的迭代器设计，记录缓冲区的位置、容量、头部的下标和迭代器的逻辑位置
+template <class T, class Ref, class Ptr>
+struct circular_buffer_iterator : public iterator<random_access_iterator_tag, T>
+{
+  typedef circular_buffer_iterator<T, T&, T*>             iterator;
+  typedef circular_buffer_iterator<T, const T&, const T*> const_iterator;
+  typedef circular_buffer_iterator                        self;
+
+  typedef T            value_type;
+  typedef Ptr          pointer;
+  typedef Ref          reference;
+  typedef size_t       size_type;
+  typedef ptrdiff_t    difference_type;
+
+  Ptr       buf;   // 缓冲区的起始位置
+  size_type cap;   // 缓冲区的容量
+  size_type head;  // 第一个元素在缓冲区中的下标
+  size_type pos;   // 迭代器的逻辑位置，第一个元素为 0
+
+  circular_buffer_iterator() noexcept
+    :buf(nullptr), cap(0), head(0), pos(0) {}
+
+  circular_buffer_iterator(Ptr b, size_type c, size_type h, size_type p) noexcept
+    :buf(b), cap(c), head(h), pos(p) {}
+
+  circular_buffer_iterator(const iterator& rhs) noexcept
+    :buf(rhs.buf), cap(rhs.cap), head(rhs.head), pos(rhs.pos) {}
+
+  self& operator=(const self& rhs) = default;
+
+  // 逻辑位置对应的元素地址，head + pos 不超过 2 * cap，最多减一次 cap
+  pointer   ptr() const
+  {
+    const size_type i = head + pos;
+    return buf + (i >= cap ? i - cap : i);
+  }
+
+  reference operator*()  const { return *ptr(); }
+  pointer   operator->() const { return ptr(); }
+
+  self& operator++()    { ++pos; return *this; }
+  self  operator++(int) { self tmp = *this; ++pos; return tmp; }
+  self& operator--()    { --pos; return *this; }
+  self  operator--(int) { self tmp = *this; --pos; return tmp; }
+
+  self& operator+=(difference_type n) { pos += n; return *this; }
+  self& operator-=(difference_type n) { pos -= n; return *this; }
+  self  operator+(difference_type n) const { self tmp = *this; return tmp += n; }
+  self  operator-(difference_type n) const { self tmp = *this; return tmp -= n; }
+  difference_type operator-(const self& x) const
+  { return static_cast<difference_type>(pos) - static_cast<difference_type>(x.pos); }
+
+  reference operator[](difference_type n) const { return *(*this + n); }
+
+  bool operator==(const self& rhs) const { return pos == rhs.pos; }
+  bool operator!=(const self& rhs) const { return pos != rhs.pos; }
+  bool operator< (const self& rhs) const { return pos <  rhs.pos; }
+  bool operator> (const self& rhs) const { return pos >  rhs.pos; }
+  bool operator<=(const self& rhs) const { return pos <= rhs.pos; }
+  bool operator>=(const self& rhs) const { return pos >= rhs.pos; }
+};
+
+template <class T, class Ref, class Ptr>
+circular_buffer_iterator<T, Ref, Ptr>
+operator+(ptrdiff_t n, const circular_buffer_iterator<T, Ref, Ptr>& it)
+{
+  return it + n;
+}
+
+// circular_buffer 的段：第 0 段为 [head, cap)，第 1 段为 [0, head)
+template <class Ptr>
+struct circular_buffer_segment
+{
+  Ptr    buf;
+  size_t cap;
+  size_t head;
+  size_t index;
+
+  circular_buffer_segment& operator++() { ++index; return *this; }
+  bool operator==(const circular_buffer_segment& rhs) const { return index == rhs.index; }
+  bool operator!=(const circular_buffer_segment& rhs) const { return index != rhs.index; }
+};
+
+// circular_buffer_iterator 是分段迭代器
+template <class T, class Ref, class Ptr>
+struct segmented_iterator_traits<circular_buffer_iterator<T, Ref, Ptr>>
+{
+  typedef m_true_type                           is_segmented_iterator;
+  typedef circular_buffer_iterator<T, Ref, Ptr> iterator;
+  typedef circular_buffer_segment<Ptr>          segment_iterator;
+  typedef Ptr                                   local_iterator;
+
+  static segment_iterator segment(const iterator& it)
+  {
+    return segment_iterator{ it.buf, it.cap, it.head, it.head + it.pos >= it.cap ? 1u : 0u };
+  }
+  static local_iterator local(const iterator& it) { return it.ptr(); }
+  static local_iterator begin(const segment_iterator& seg)
+  { return seg.index == 0 ? seg.buf + seg.head : seg.buf; }
+  static local_iterator end(const segment_iterator& seg)
+  { return seg.index == 0 ? seg.buf + seg.cap : seg.buf + seg.head; }
+
+  static iterator compose(const segment_iterator& seg, local_iterator local)
+  {
+    const size_t pos = seg.index == 0
+      ? static_cast<size_t>(local - (seg.buf + seg.head))
+      : seg.cap - seg.head + static_cast<size_t>(local - seg.buf);
+    return iterator(seg.buf, seg.cap, seg.head, pos);
+  }
+};
+
+// 模板类: circular_buffer
+// 模板参数 T 代表类型，Alloc 代表空间配置器，Growth 代表 grow 策略下的扩容策略
+template <class T, class Alloc = mystl::allocator<T>, class Growth = mystl::vector_growth>
+class circular_buffer : private mystl::alloc_holder<Alloc>
+{
+  static_assert(std::is_same<T, typename Alloc::value_type>::value,
+                "Alloc::value_type must be the same as T");
+public:
+  // circular_buffer 的嵌套型别定义
+  typedef Alloc                                    allocator_type;
+  typedef mystl::allocator_traits<Alloc>           alloc_traits;
+  typedef Growth                                   growth_policy_type;
+
+  typedef T                                        value_type;
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  typedef circular_buffer_iterator<T, T&, T*>             iterator;
+  typedef circular_buffer_iterator<T, const T&, const T*> const_iterator;
+  typedef mystl::reverse_iterator<iterator>               reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>         const_reverse_iterator;
+
+  allocator_type get_allocator() const { return this->get_alloc(); }
+
+private:
+  typedef mystl::alloc_holder<Alloc>               base_holder;
+
+  // 元素可以平凡重定位时，换用新空间时直接复制内存
+  typedef m_bool_constant<mystl::is_trivially_relocatable<T>::value> relocatable;
+
+  pointer                buf_;     // 缓冲区
+  size_type              cap_;     // 容量
+  size_type              head_;    // 第一个元素的下标
+  size_type              size_;    // 元素个数
+  circular_buffer_policy policy_;  // 已满时的行为
+
+public:
+  // 构造、复制、移动、析构函数
+  circular_buffer() noexcept
+    :buf_(nullptr), cap_(0), head_(0), size_(0), policy_(circular_buffer_policy::grow)
+  {
+  }
+
+  explicit circular_buffer(const allocator_type& alloc) noexcept
+    :base_holder(alloc), buf_(nullptr), cap_(0), head_(0), size_(0),
+    policy_(circular_buffer_policy::grow)
+  {
+  }
+
+  // 构造一个空的、容量为 capacity 的缓冲区
+  circular_buffer(circular_buffer_policy policy, size_type capacity,
+                  const allocator_type& alloc = allocator_type())
+    :base_holder(alloc), buf_(nullptr), cap_(0), head_(0), size_(0), policy_(policy)
+  {
+    reserve(capacity);
+  }
+
+  explicit circular_buffer(size_type n, const allocator_type& alloc = allocator_type())
+    :base_holder(alloc), buf_(nullptr), cap_(0), head_(0), size_(0),
+    policy_(circular_buffer_policy::grow)
+  {
+    fill_init(n, value_type());
+  }
+
+  circular_buffer(size_type n, const value_type& value,
+                  const allocator_type& alloc = allocator_type())
+    :base_holder(alloc), buf_(nullptr), cap_(0), head_(0), size_(0),
+    policy_(circular_buffer_policy::grow)
+  {
+    fill_init(n, value);
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  circular_buffer(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+    :base_holder(alloc), buf_(nullptr), cap_(0), head_(0), size_(0),
+    policy_(circular_buffer_policy::grow)
+  {
+    range_init(first, last, iterator_category(first));
+  }
+
+  circular_buffer(std::initializer_list<value_type> ilist,
+                  const allocator_type& alloc = allocator_type())
+    :base_holder(alloc), buf_(nullptr), cap_(0), head_(0), size_(0),
+    policy_(circular_buffer_policy::grow)
+  {
+    range_init(ilist.begin(), ilist.end(), mystl::forward_iterator_tag());
+  }
+
+  // 复制时保留容量与策略
+  circular_buffer(const circular_buffer& rhs)
+    :base_holder(alloc_traits::select_on_container_copy_construction(rhs.get_alloc())),
+    buf_(nullptr), cap_(0), head_(0), size_(0), policy_(rhs.policy_)
+  {
+    try
+    {
+      copy_from(rhs);
+    }
+    catch (...)
+    {
+      free_storage();
+      throw;
+    }
+  }
+
+  circular_buffer(circular_buffer&& rhs) noexcept
+    :base_holder(mystl::move(rhs.get_alloc())),
+    buf_(rhs.buf_), cap_(rhs.cap_), head_(rhs.head_), size_(rhs.size_), policy_(rhs.policy_)
+  {
+    rhs.buf_ = nullptr;
+    rhs.cap_ = rhs.head_ = rhs.size_ = 0;
+  }
+
+  circular_buffer& operator=(const circular_buffer& rhs);
+  circular_buffer& operator=(circular_buffer&& rhs) noexcept(alloc_move_steals<Alloc>::value);
+
+  circular_buffer& operator=(std::initializer_list<value_type> ilist)
+  {
+    clear();
+    if (cap_ < ilist.size())
+      reallocate(ilist.size());
+    for (auto& x : ilist)
+      emplace_back(x);
+    return *this;
+  }
+
+  ~circular_buffer()
+  { free_storage(); }
+
+public:
+  // 迭代器相关操作
+  iterator               begin()         noexcept
+  { return iterator(buf_, cap_, head_, 0); }
+  const_iterator         begin()   const noexcept
+  { return const_iterator(buf_, cap_, head_, 0); }
+  iterator               end()           noexcept
+  { return iterator(buf_, cap_, head_, size_); }
+  const_iterator         end()     const noexcept
+  { return const_iterator(buf_, cap_, head_, size_); }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 容量相关操作
+  bool      empty()    const noexcept { return size_ == 0; }
+  bool      full()     const noexcept { return size_ == cap_; }
+  size_type size()     const noexcept { return size_; }
+  size_type capacity() const noexcept { return cap_; }
+  size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(T); }
+
+  circular_buffer_policy policy() const noexcept { return policy_; }
+  void      set_policy(circular_buffer_policy policy) noexcept { policy_ = policy; }
+
+  // 容量至少为 n
+  void      reserve(size_type n)
+  {
+    if (cap_ < n)
+      reallocate(n);
+  }
+  // 容量恰好为 n，元素多于 n 个时丢弃最旧的元素
+  void      set_capacity(size_type n)
+  {
+    if (cap_ != n)
+      reallocate(n);
+  }
+  void      shrink_to_fit()
+  {
+    if (cap_ != size_)
+      reallocate(size_);
+  }
+  // 未使用的容量计入 overhead
+  memory_usage_info memory_usage() const noexcept
+  { return memory_usage_info{ size_ * sizeof(T), (cap_ - size_) * sizeof(T) }; }
+
+  // 访问元素相关操作
+  reference       operator[](size_type n)
+  {
+    MYSTL_DEBUG(n < size_);
+    return buf_[index(n)];
+  }
+  const_reference operator[](size_type n) const
+  {
+    MYSTL_DEBUG(n < size_);
+    return buf_[index(n)];
+  }
+  reference       at(size_type n)
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size_), "circular_buffer<T>::at() subscript out of range");
+    return (*this)[n];
+  }
+  const_reference at(size_type n) const
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size_), "circular_buffer<T>::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  reference       front()
+  {
+    MYSTL_DEBUG(!empty());
+    return buf_[head_];
+  }
+  const_reference front() const
+  {
+    MYSTL_DEBUG(!empty());
+    return buf_[head_];
+  }
+  reference       back()
+  {
+    MYSTL_DEBUG(!empty());
+    return buf_[index(size_ - 1)];
+  }
+  const_reference back()  const
+  {
+    MYSTL_DEBUG(!empty());
+    return buf_[index(size_ - 1)];
+  }
+
+  // 元素所在的两段连续空间：第一段从头部开始，第二段从缓冲区起始处开始，没有回绕时第二段为空
+  mystl::pair<pointer, size_type> array_one() noexcept
+  { return mystl::pair<pointer, size_type>(buf_ + head_, first_segment()); }
+  mystl::pair<pointer, size_type> array_two() noexcept
+  { return mystl::pair<pointer, size_type>(buf_, size_ - first_segment()); }
+  mystl::pair<const_pointer, size_type> array_one() const noexcept
+  { return mystl::pair<const_pointer, size_type>(buf_ + head_, first_segment()); }
+  mystl::pair<const_pointer, size_type> array_two() const noexcept
+  { return mystl::pair<const_pointer, size_type>(buf_, size_ - first_segment()); }
+
+  // 把元素搬成一段连续的空间，返回第一个元素的地址
+  pointer   linearize();
+
+  // 修改容器相关操作
+
+  // emplace_front / emplace_back
+
+  template <class ...Args>
+  void      emplace_front(Args&& ...args);
+  template <class ...Args>
+  void      emplace_back(Args&& ...args);
+
+  // push_front / push_back
+
+  void      push_front(const value_type& value) { emplace_front(value); }
+  void      push_front(value_type&& value)      { emplace_front(mystl::move(value)); }
+  void      push_back(const value_type& value)  { emplace_back(value); }
+  void      push_back(value_type&& value)       { emplace_back(mystl::move(value)); }
+
+  // 已满时返回 false，不扩容也不覆盖
+  template <class ...Args>
+  bool      try_emplace_front(Args&& ...args)
+  {
+    if (size_ == cap_)
+      return false;
+    emplace_front_aux(mystl::forward<Args>(args)...);
+    return true;
+  }
+  template <class ...Args>
+  bool      try_emplace_back(Args&& ...args)
+  {
+    if (size_ == cap_)
+      return false;
+    emplace_back_aux(mystl::forward<Args>(args)...);
+    return true;
+  }
+  bool      try_push_front(const value_type& value) { return try_emplace_front(value); }
+  bool      try_push_front(value_type&& value)      { return try_emplace_front(mystl::move(value)); }
+  bool      try_push_back(const value_type& value)  { return try_emplace_back(value); }
+  bool      try_push_back(value_type&& value)       { return try_emplace_back(mystl::move(value)); }
+
+  // pop_front / pop_back
+
+  void      pop_front();
+  void      pop_back();
+
+  // clear / swap
+
+  void      clear() noexcept;
+  void      swap(circular_buffer& rhs) noexcept;
+
+private:
+  // helper functions
+
+  // 逻辑位置 n 对应的下标
+  size_type index(size_type n) const noexcept
+  {
+    n += head_;
+    return n >= cap_ ? n - cap_ : n;
+  }
+  size_type first_segment() const noexcept
+  { return cap_ - head_ < size_ ? cap_ - head_ : size_; }
+  size_type prev(size_type i) const noexcept
+  { return i == 0 ? cap_ - 1 : i - 1; }
+  size_type next(size_type i) const noexcept
+  { return i + 1 == cap_ ? 0 : i + 1; }
+
+  // initialize / destroy
+  void      fill_init(size_type n, const value_type& value);
+  template <class IIter>
+  void      range_init(IIter first, IIter last, input_iterator_tag);
+  template <class FIter>
+  void      range_init(FIter first, FIter last, forward_iterator_tag);
+  void      copy_from(const circular_buffer& rhs);
+  void      free_storage() noexcept;
+
+  // 不检查容量的插入
+  template <class ...Args>
+  void      emplace_front_aux(Args&& ...args);
+  template <class ...Args>
+  void      emplace_back_aux(Args&& ...args);
+
+  // 已满时的处理
+  template <class ...Args>
+  void      grow_emplace(bool front, Args&& ...args);
+
+  // reallocate
+  void      reallocate(size_type new_cap);
+  void      relocate_to(pointer dst, size_type first, size_type n, m_true_type) noexcept;
+  void      relocate_to(pointer dst, size_type first, size_type n, m_false_type);
+  void      replace_storage(pointer new_buf, size_type new_cap, size_type new_head, size_type new_size);
+
+  // move assign
+  void      move_assign(circular_buffer& rhs, m_true_type) noexcept;
+  void      move_assign(circular_buffer& rhs, m_false_type);
+};
+
+/*****************************************************************************************/
+
+// 复制赋值运算符，保留 rhs 的容量与策略
+template <class T, class Alloc, class Growth>
+circular_buffer<T, Alloc, Growth>&
+circular_buffer<T, Alloc, Growth>::operator=(const circular_buffer& rhs)
+{
+  if (this != &rhs)
+  {
+    if (alloc_traits::propagate_on_container_copy_assignment::value &&
+        this->get_alloc() != rhs.get_alloc())
+    { // 配置器要随之复制，旧的空间必须先用旧的配置器释放
+      free_storage();
+      mystl::alloc_on_copy(this->get_alloc(), rhs.get_alloc());
+    }
+    clear();
+    policy_ = rhs.policy_;
+    copy_from(rhs);
+  }
+  return *this;
+}
+
+// 移动赋值运算符
+template <class T, class Alloc, class Growth>
+circular_buffer<T, Alloc, Growth>&
+circular_buffer<T, Alloc, Growth>::operator=(circular_buffer&& rhs)
+noexcept(alloc_move_steals<Alloc>::value)
+{
+  if (this != &rhs)
+    move_assign(rhs, alloc_move_steals<Alloc>());
+  return *this;
+}
+
+// 把元素搬成一段连续的空间
+template <class T, class Alloc, class Growth>
+typename circular_buffer<T, Alloc, Growth>::pointer
+circular_buffer<T, Alloc, Growth>::linearize()
+{
+  if (first_segment() != size_)
+    reallocate(cap_);
+  return buf_ + head_;
+}
+
+// 在头部就地构建元素
+template <class T, class Alloc, class Growth>
+template <class ...Args>
+void circular_buffer<T, Alloc, Growth>::emplace_front(Args&& ...args)
+{
+  if (size_ != cap_)
+  {
+    emplace_front_aux(mystl::forward<Args>(args)...);
+    return;
+  }
+  switch (policy_)
+  {
+  case circular_buffer_policy::grow:
+    grow_emplace(true, mystl::forward<Args>(args)...);
+    break;
+  case circular_buffer_policy::overwrite:
+    if (cap_ != 0)
+    { // 覆盖尾部的元素，参数可能引用它，先构造
+      value_type tmp(mystl::forward<Args>(args)...);
+      const size_type i = prev(head_);
+      buf_[i] = mystl::move(tmp);
+      head_ = i;
+    }
+    break;
+  default:
+    THROW_LENGTH_ERROR_IF(true, "circular_buffer<T>::emplace_front() on a full fixed buffer");
+  }
+}
+
+// 在尾部就地构建元素
+template <class T, class Alloc, class Growth>
+template <class ...Args>
+void circular_buffer<T, Alloc, Growth>::emplace_back(Args&& ...args)
+{
+  if (size_ != cap_)
+  {
+    emplace_back_aux(mystl::forward<Args>(args)...);
+    return;
+  }
+  switch (policy_)
+  {
+  case circular_buffer_policy::grow:
+    grow_emplace(false, mystl::forward<Args>(args)...);
+    break;
+  case circular_buffer_policy::overwrite:
+    if (cap_ != 0)
+    { // 覆盖最旧的元素，参数可能引用它，先构造
+      value_type tmp(mystl::forward<Args>(args)...);
+      buf_[head_] = mystl::move(tmp);
+      head_ = next(head_);
+    }
+    break;
+  default:
+    THROW_LENGTH_ERROR_IF(true, "circular_buffer<T>::emplace_back() on a full fixed buffer");
+  }
+}
+
+// 弹出头部元素，弹空后回到缓冲区的起始处，之后的元素尽量不回绕
+template <class T, class Alloc, class Growth>
+void circular_buffer<T, Alloc, Growth>::pop_front()
+{
+  MYSTL_DEBUG(!empty());
+  alloc_traits::destroy(this->get_alloc(), buf_ + head_);
+  head_ = --size_ == 0 ? 0 : next(head_);
+}
+
+// 弹出尾部元素
+template <class T, class Alloc, class Growth>
+void circular_buffer<T, Alloc, Growth>::pop_back()
+{
+  MYSTL_DEBUG(!empty());
+  alloc_traits::destroy(this->get_alloc(), buf_ + index(size_ - 1));
+  if (--size_ == 0)
+    head_ = 0;
+}
+
+// 清空容器，保留容量
+template <class T, class Alloc, class Growth>
+void circular_buffer<T, Alloc, Growth>::clear() noexcept
+{
+  const size_type n1 = first_segment();
+  mystl::destroy(buf_ + head_, buf_ + head_ + n1);
+  mystl::destroy(buf_, buf_ + (size_ - n1));
+  head_ = 0;
+  size_ = 0;
+}
+
+// 交换两个 circular_buffer
+template <class T, class Alloc, class Growth>
+void circular_buffer<T, Alloc, Growth>::swap(circular_buffer& rhs) noexcept
+{
+  if (this != &rhs)
+  {
+    MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value ||
+                this->get_alloc() == rhs.get_alloc());
+    mystl::alloc_on_swap(this->get_alloc(), rhs.get_alloc());
+    mystl::swap(buf_, rhs.buf_);
+    mystl::swap(cap_, rhs.cap_);
+    mystl::swap(head_, rhs.head_);
+    mystl::swap(size_, rhs.size_);
+    mystl::swap(policy_, rhs.policy_);
+  }
+}
+
+/*****************************************************************************************/
+// helper function
+
+// fill_init 函数
+template <class T, class Alloc, class Growth>
+void circular_buffer<T, Alloc, Growth>::fill_init(size_type n, const value_type& value)
+{
+  reserve(n);
+  try
+  {
+    for (; size_ < n; ++size_)
+      alloc_traits::construct(this->get_alloc(), buf_ + size_, value);
+  }
+  catch (...)
+  {
+    free_storage();
+    throw;
+  }
+}
+
+// range_init 函数
+template <class T, class Alloc, class Growth>
+template <class IIter>
+void circular_buffer<T, Alloc, Growth>::
+range_init(IIter first, IIter last, input_iterator_tag)
+{
+  try
+  {
+    for (; first != last; ++first)
+      emplace_back(*first);
+  }
+  catch (...)
+  {
+    free_storage();
+    throw;
+  }
+}
+
+template <class T, class Alloc, class Growth>
+template <class FIter>
+void circular_buffer<T, Alloc, Growth>::
+range_init(FIter first, FIter last, forward_iterator_tag)
+{
+  reserve(static_cast<size_type>(mystl::distance(first, last)));
+  try
+  {
+    for (; first != last; ++first, ++size_)
+      alloc_traits::construct(this->get_alloc(), buf_ + size_, *first);
+  }
+  catch (...)
+  {
+    free_storage();
+    throw;
+  }
+}
+
+// copy_from 函数，容器为空时复制 rhs 的容量与元素
+template <class T, class Alloc, class Growth>
+void circular_buffer<T, Alloc, Growth>::copy_from(const circular_buffer& rhs)
+{
+  MYSTL_DEBUG(empty());
+  if (cap_ != rhs.cap_)
+    reallocate(rhs.cap_);
+  for (size_type i = 0; i < rhs.size_; ++i, ++size_)
+    alloc_traits::construct(this->get_alloc(), buf_ + i, rhs[i]);
+}
+
+// free_storage 函数，销毁所有元素并释放空间
+template <class T, class Alloc, class Growth>
+void circular_buffer<T, Alloc, Growth>::free_storage() noexcept
+{
+  clear();
+  if (buf_ != nullptr)
+    alloc_traits::deallocate(this->get_alloc(), buf_, cap_);
+  buf_ = nullptr;
+  cap_ = 0;
+}
+
+// emplace_front_aux 函数
+template <class T, class Alloc, class Growth>
+template <class ...Args>
+void circular_buffer<T, Alloc, Growth>::emplace_front_aux(Args&& ...args)
+{
+  const size_type i = prev(head_);
+  alloc_traits::construct(this->get_alloc(), buf_ + i, mystl::forward<Args>(args)...);
+  head_ = i;
+  ++size_;
+}
+
+// emplace_back_aux 函数
+template <class T, class Alloc, class Growth>
+template <class ...Args>
+void circular_buffer<T, Alloc, Growth>::emplace_back_aux(Args&& ...args)
+{
+  alloc_traits::construct(this->get_alloc(), buf_ + index(size_), mystl::forward<Args>(args)...);
+  ++size_;
+}
+
+// grow_emplace 函数，扩容后在头部（尾部）构造元素
+// 参数可能引用容器中的元素，先在新空间构造新元素，再搬移原有的元素
+template <class T, class Alloc, class Growth>
+template <class ...Args>
+void circular_buffer<T, Alloc, Growth>::grow_emplace(bool front, Args&& ...args)
+{
+  THROW_LENGTH_ERROR_IF(size_ == max_size(), "circular_buffer<T>'s size too big");
+  const size_type new_cap = Growth::next_capacity(cap_, 1, max_size());
+  pointer new_buf = alloc_traits::allocate(this->get_alloc(), new_cap);
+  // 原有的元素放在 [0, size_)，新元素在头部时放在缓冲区的最后
+  const size_type pos = front ? new_cap - 1 : size_;
+  try
+  {
+    alloc_traits::construct(this->get_alloc(), new_buf + pos, mystl::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    alloc_traits::deallocate(this->get_alloc(), new_buf, new_cap);
+    throw;
+  }
+  try
+  {
+    relocate_to(new_buf, 0, size_, relocatable());
+  }
+  catch (...)
+  {
+    alloc_traits::destroy(this->get_alloc(), new_buf + pos);
+    alloc_traits::deallocate(this->get_alloc(), new_buf, new_cap);
+    throw;
+  }
+  replace_storage(new_buf, new_cap, front ? pos : 0, size_ + 1);
+}
+
+// reallocate 函数，换用容量恰好为 new_cap 的空间，元素放在起始处，放不下时丢弃最旧的元素
+template <class T, class Alloc, class Growth>
+void circular_buffer<T, Alloc, Growth>::reallocate(size_type new_cap)
+{
+  THROW_LENGTH_ERROR_IF(new_cap > max_size(), "circular_buffer<T>'s capacity too big");
+  pointer new_buf = new_cap == 0 ? nullptr : alloc_traits::allocate(this->get_alloc(), new_cap);
+  const size_type n = size_ < new_cap ? size_ : new_cap;
+  try
+  {
+    relocate_to(new_buf, size_ - n, n, relocatable());
+  }
+  catch (...)
+  {
+    if (new_buf != nullptr)
+      alloc_traits::deallocate(this->get_alloc(), new_buf, new_cap);
+    throw;
+  }
+  // 丢弃最旧的元素
+  while (size_ != n)
+  {
+    alloc_traits::destroy(this->get_alloc(), buf_ + head_);
+    head_ = next(head_);
+    --size_;
+  }
+  replace_storage(new_buf, new_cap, 0, n);
+}
+
+// relocate_to 函数，把逻辑位置 [first, first + n) 的元素搬到 dst 开始的连续空间
+template <class T, class Alloc, class Growth>
+void circular_buffer<T, Alloc, Growth>::
+relocate_to(pointer dst, size_type first, size_type n, m_true_type) noexcept
+{
+  if (n == 0)
+    return;
+  const size_type i = index(first);
+  const size_type n1 = cap_ - i < n ? cap_ - i : n;
+  std::memcpy(static_cast<void*>(dst), static_cast<const void*>(buf_ + i), n1 * sizeof(T));
+  if (n1 != n)
+    std::memcpy(static_cast<void*>(dst + n1), static_cast<const void*>(buf_), (n - n1) * sizeof(T));
+}
+
+template <class T, class Alloc, class Growth>
+void circular_buffer<T, Alloc, Growth>::
+relocate_to(pointer dst, size_type first, size_type n, m_false_type)
+{
+  if (n == 0)
+    return;
+  const size_type i = index(first);
+  const size_type n1 = cap_ - i < n ? cap_ - i : n;
+  auto mid = mystl::uninitialized_move(buf_ + i, buf_ + i + n1, dst);
+  try
+  {
+    mystl::uninitialized_move(buf_, buf_ + (n - n1), mid);
+  }
+  catch (...)
+  {
+    mystl::destroy(dst, mid);
+    throw;
+  }
+}
+
+// replace_storage 函数，原有的元素已经搬走，释放原来的空间并换用新空间
+template <class T, class Alloc, class Growth>
+void circular_buffer<T, Alloc, Growth>::
+replace_storage(pointer new_buf, size_type new_cap, size_type new_head, size_type new_size)
+{
+  if (!relocatable::value)
+  { // 按字节搬走的元素不能再析构，移动走的元素还要析构
+    const size_type n1 = first_segment();
+    mystl::destroy(buf_ + head_, buf_ + head_ + n1);
+    mystl::destroy(buf_, buf_ + (size_ - n1));
+  }
+  if (buf_ != nullptr)
+    alloc_traits::deallocate(this->get_alloc(), buf_, cap_);
+  buf_ = new_buf;
+  cap_ = new_cap;
+  head_ = new_head;
+  size_ = new_size;
+}
+
+// move_assign 函数，可以直接接管 rhs 的空间
+template <class T, class Alloc, class Growth>
+void circular_buffer<T, Alloc, Growth>::move_assign(circular_buffer& rhs, m_true_type) noexcept
+{
+  free_storage();
+  mystl::alloc_on_move(this->get_alloc(), rhs.get_alloc());
+  buf_ = rhs.buf_;
+  cap_ = rhs.cap_;
+  head_ = rhs.head_;
+  size_ = rhs.size_;
+  policy_ = rhs.policy_;
+  rhs.buf_ = nullptr;
+  rhs.cap_ = rhs.head_ = rhs.size_ = 0;
+}
+
+// move_assign 函数，配置器不传播时，只有两者相等才能接管空间，否则逐个移动元素
+template <class T, class Alloc, class Growth>
+void circular_buffer<T, Alloc, Growth>::move_assign(circular_buffer& rhs, m_false_type)
+{
+  if (this->get_alloc() == rhs.get_alloc())
+  {
+    move_assign(rhs, m_true_type());
+  }
+  else
+  {
+    clear();
+    policy_ = rhs.policy_;
+    if (cap_ != rhs.cap_)
+      reallocate(rhs.cap_);
+    for (size_type i = 0; i < rhs.size_; ++i, ++size_)
+      alloc_traits::construct(this->get_alloc(), buf_ + i, mystl::move(rhs[i]));
+    rhs.clear();
+  }
+}
+
+// 重载比较操作符
+template <class T, class Alloc, class Growth>
+bool operator==(const circular_buffer<T, Alloc, Growth>& lhs,
+                const circular_buffer<T, Alloc, Growth>& rhs)
+{
+  return lhs.size() == rhs.size() &&
+    mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, class Alloc, class Growth>
+bool operator<(const circular_buffer<T, Alloc, Growth>& lhs,
+               const circular_buffer<T, Alloc, Growth>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, class Alloc, class Growth>
+bool operator!=(const circular_buffer<T, Alloc, Growth>& lhs,
+                const circular_buffer<T, Alloc, Growth>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T, class Alloc, class Growth>
+bool operator>(const circular_buffer<T, Alloc, Growth>& lhs,
+               const circular_buffer<T, Alloc, Growth>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T, class Alloc, class Growth>
+bool operator<=(const circular_buffer<T, Alloc, Growth>& lhs,
+                const circular_buffer<T, Alloc, Growth>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T, class Alloc, class Growth>
+bool operator>=(const circular_buffer<T, Alloc, Growth>& lhs,
+                const circular_buffer<T, Alloc, Growth>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, class Alloc, class Growth>
+void swap(circular_buffer<T, Alloc, Growth>& lhs, circular_buffer<T, Alloc, Growth>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+// 元素在堆上，对象本身不含指向自身的指针，Alloc 可以平凡重定位时容器也可以平凡重定位
+template <class T, class Alloc, class Growth>
+struct is_trivially_relocatable<circular_buffer<T, Alloc, Growth>>
+  : m_bool_constant<is_trivially_relocatable<Alloc>::value> {};
+
+} // namespace mystl
+#endif // !MYTINYSTL_CIRCULAR_BUFFER_H_
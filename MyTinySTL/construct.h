@@ -9,6 +9,7 @@
 
 #include "type_traits.h"
 #include "iterator.h"
+#include "util.h"
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -56,6 +57,9 @@ void destroy_one(Ty* pointer, std::false_type)
   }
 }
 
+template <class Ty>
+void destroy(Ty* pointer);
+
 template <class ForwardIter>
 void destroy_cat(ForwardIter , ForwardIter , std::true_type) {}
 
@@ -6,6 +6,12 @@
 
 // notes:
 //
+// 1. pop_front / pop_back / erase 空出的缓冲区先放入一个小的缓存（最多 DEQUE_SPARE_BUFFERS 个），
+//    再次需要缓冲区时优先从缓存中取用，作为 FIFO 队列在缓冲区边界来回时不会反复申请、释放内存
+// 2. map 空间不足时，若 map 足够大，就在原来的 map 上把已用的部分搬到中央，不必重新申请 map，
+//    头尾预留的缓冲区会随之一起搬移；reserve_front / reserve_back 可以预先准备好 map 与缓冲区
+// 3. shrink_to_fit / clear 会释放缓存与预留的缓冲区
+//
 // 异常保证：
 // mystl::deque<T> 满足基本异常保证，部分函数无异常保证，并对以下等函数做强异常安全保证：
 //   * emplace_front
@@ -17,6 +23,8 @@
 
 #include <initializer_list>
 
+#include <cstring>
+
 #include "iterator.h"
 #include "memory.h"
 #include "util.h"
@@ -43,19 +51,33 @@ namespace mystl
 #define DEQUE_MAP_INIT_SIZE 8
 #endif
 
+// deque 缓存的空闲缓冲区的最大数目
+#ifndef DEQUE_SPARE_BUFFERS
+#define DEQUE_SPARE_BUFFERS 2
+#endif
+
+// 不超过 n 的最大的 2 的幂
+constexpr size_t deque_floor_pow2(size_t n, size_t p = 1)
+{
+  return p > n / 2 ? p : deque_floor_pow2(n, p * 2);
+}
+
+// deque 缓冲区的缺省大小：不超过 4096 字节的最大的 2 的幂个元素，元素较大时为 16 个
+// 缓冲区大小为 2 的幂时，迭代器随机访问中的除法与取余都会编译成移位与掩码
+// 也可以通过 deque 的第三个模板参数指定其他的大小
 template <class T>
 struct deque_buf_size
 {
-  static constexpr size_t value = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;//这是一个静态常量，最小值是16，不能用全局吗？
+  static constexpr size_t value = sizeof(T) < 256 ? deque_floor_pow2(4096 / sizeof(T)) : 16;
 };
 
 // deque 的迭代器设计，注意和string的区别，string的迭代器实际上就是简单地把元素指针重命名为 迭代器，而这里迭代器进行了许多封装，
 //所以容器deque的迭代器要比string的迭代器复杂得多，也支持更多的操作，比如自增，自减之类的，string的迭代器只能像指针那样操作
-template <class T, class Ref, class Ptr>
+template <class T, class Ref, class Ptr, size_t BufSize = deque_buf_size<T>::value>
 struct deque_iterator : public iterator<random_access_iterator_tag, T>//deque的迭代器是随机迭代器，所以会继承
 {
-  typedef deque_iterator<T, T&, T*>             iterator;//这里声明别名，deque_iterator<T, T&, T*>在模板类内来说是一个类名（相当于实例化模板了），给这个类起个别名叫iterator
-  typedef deque_iterator<T, const T&, const T*> const_iterator;//常量类的别名
+  typedef deque_iterator<T, T&, T*, BufSize>             iterator;//这里声明别名，deque_iterator<T, T&, T*>在模板类内来说是一个类名（相当于实例化模板了），给这个类起个别名叫iterator
+  typedef deque_iterator<T, const T&, const T*, BufSize> const_iterator;//常量类的别名
   typedef deque_iterator                        self;//感觉和上面的是不是一样的？上面的好像是特例化出来的一个类，更具体一些？
 
   typedef T            value_type;
@@ -67,7 +89,7 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T>//deque的
   typedef T**          map_pointer;//指向指针的指针，也就是指向缓冲区的指针，用来找到缓冲区的位置，map中控里面保存的是value_pointer，
                                     //而迭代器需要保存一个指向map中控里面value_pointer的指针，用来找到map中控里面的value_pointer，从而找到缓冲区的位置
   //https://blog.csdn.net/oneNYT/article/details/107724892
-  static const size_type buffer_size = deque_buf_size<T>::value;//只读静态常量成员，所有对象共享，且不能修改，所有迭代器指向的缓冲区大小都是buffer_size
+  static constexpr size_type buffer_size = BufSize;//只读静态常量成员，所有对象共享，且不能修改，所有迭代器指向的缓冲区大小都是buffer_size
 
   // 迭代器所含成员数据
   value_pointer cur;    // 指向所在缓冲区的当前元素，这里直接用的指针，迭代器为什么要这么多指针？因为deque的内存映像和vector不一样，是由不连续的缓冲区组成的，需要知道缓冲区的实际位置。
@@ -179,16 +201,16 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T>//deque的
 
   self& operator+=(difference_type n)//n是可以小于0的，所以下面要判断
   {//随机迭代器可以随意加减
-    const auto offset = n + (cur - first);
-    if (offset >= 0 && offset < static_cast<difference_type>(buffer_size))
-    { // 仍在当前缓冲区
+    const difference_type offset = n + (cur - first);
+    if (static_cast<size_type>(offset) < buffer_size)
+    { // 仍在当前缓冲区，offset 为负时转为无符号数后一定不小于 buffer_size
       cur += n;
     }
     else
-    { // 要跳到其他的缓冲区
-      const auto node_offset = offset > 0
-        ? offset / static_cast<difference_type>(buffer_size)//首先看看需要跳过多少个buffer
-        : -static_cast<difference_type>((-offset - 1) / buffer_size) - 1;
+    { // 要跳到其他的缓冲区，用无符号数做除法，buffer_size 为 2 的幂时就是移位
+      const difference_type node_offset = offset > 0
+        ? static_cast<difference_type>(static_cast<size_type>(offset) / buffer_size)//首先看看需要跳过多少个buffer
+        : -static_cast<difference_type>((static_cast<size_type>(-offset) - 1) / buffer_size) - 1;
       set_node(node + node_offset);
       cur = first + (offset - node_offset * static_cast<difference_type>(buffer_size));
     }
@@ -221,44 +243,97 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T>//deque的
   bool operator>=(const self& rhs) const { return !(*this < rhs); }
 };
 
+// deque_iterator 是分段迭代器，每个缓冲区是一段，算法可以逐个缓冲区在原生指针上执行
+template <class T, class Ref, class Ptr, size_t BufSize>
+struct segmented_iterator_traits<deque_iterator<T, Ref, Ptr, BufSize>>
+{
+  typedef m_true_type                          is_segmented_iterator;
+  typedef deque_iterator<T, Ref, Ptr, BufSize> iterator;
+  typedef typename iterator::map_pointer       segment_iterator;
+  typedef Ptr                                  local_iterator;
+
+  static segment_iterator segment(const iterator& it) { return it.node; }
+  static local_iterator   local(const iterator& it)   { return it.cur; }
+  static local_iterator   begin(segment_iterator seg) { return *seg; }
+  static local_iterator   end(segment_iterator seg)   { return *seg + BufSize; }
+
+  static iterator compose(segment_iterator seg, local_iterator local)
+  {
+    // 与 operator++ 一致，停在缓冲区尾部时转到下一个缓冲区的头部
+    if (local == end(seg))
+    {
+      ++seg;
+      local = *seg;
+    }
+    return iterator(const_cast<T*>(local), seg);
+  }
+};
+
+// deque 的空闲缓冲区缓存
+template <class Pointer, size_t N>
+struct deque_spare_buffers
+{
+  static_assert(N > 0, "DEQUE_SPARE_BUFFERS must be greater than 0");
+
+  Pointer buf[N];
+  size_t  count;
+
+  deque_spare_buffers() noexcept :count(0) {}
+};
+
 // 模板类 deque
-// 模板参数代表数据类型
-template <class T>
-class deque
+// 参数一代表数据类型，参数二代表空间配置器，参数三代表每个缓冲区的元素个数
+template <class T, class Alloc = mystl::allocator<T>, size_t BufSize = deque_buf_size<T>::value>
+class deque : private mystl::alloc_holder<Alloc>
 {
+  static_assert(BufSize > 0, "deque<T, Alloc, BufSize> requires BufSize > 0");
+
+  static_assert(std::is_same<typename Alloc::value_type, T>::value,
+                "deque<T, Alloc> requires Alloc::value_type to be T");
+
 public:
   // deque 的型别定义
-  typedef mystl::allocator<T>                      allocator_type;//申请内存空间，也就是上面说的buffer
-  typedef mystl::allocator<T>                      data_allocator;
-  typedef mystl::allocator<T*>                     map_allocator;//map中控，里面存的是指针，也是一段内存空间
-
-  typedef typename allocator_type::value_type      value_type;//其实就是T，为什么不直接用呢？
-  typedef typename allocator_type::pointer         pointer;//这个就是map_allocator里面存的东西，指向buffer数据的指针
-  typedef typename allocator_type::const_pointer   const_pointer;
-  typedef typename allocator_type::reference       reference;
-  typedef typename allocator_type::const_reference const_reference;
-  typedef typename allocator_type::size_type       size_type;
-  typedef typename allocator_type::difference_type difference_type;
+  typedef Alloc                                    allocator_type;//申请内存空间，也就是上面说的buffer
+  typedef mystl::allocator_traits<Alloc>           alloc_traits;
+  typedef typename alloc_traits::template
+    rebind_alloc<T*>                               map_allocator;//map中控，里面存的是指针，也是一段内存空间
+  typedef mystl::allocator_traits<map_allocator>   map_alloc_traits;
+
+  typedef T                                        value_type;
+  typedef T*                                       pointer;//这个就是map_allocator里面存的东西，指向buffer数据的指针
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
   typedef pointer*                                 map_pointer;//这个是指向map中控map_allocator的指针，就是T**，用来找到map中控
   typedef const_pointer*                           const_map_pointer;//只读deque的map中控里面的指针不能改变，也就是这个指针所指向的对象不能
                                                                      //改变，因此定义成const_pointer,而const pointer是修饰这个指针是个只读量
                                                                      //无法改变指向，而可以修改对象的值
 
-  typedef deque_iterator<T, T&, T*>                iterator;//上面那个迭代器类
-  typedef deque_iterator<T, const T&, const T*>    const_iterator;
+  typedef deque_iterator<T, T&, T*, BufSize>       iterator;//上面那个迭代器类
+  typedef deque_iterator<T, const T&, const T*, BufSize> const_iterator;
   typedef mystl::reverse_iterator<iterator>        reverse_iterator;
   typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
 
-  allocator_type get_allocator() { return allocator_type(); }//申请一个对象大小的空间，并返回这个空间对象
+  allocator_type get_allocator() const { return this->get_alloc(); }
 
-  static const size_type buffer_size = deque_buf_size<T>::value;//buffer大小，和迭代器那个定义是一样的
+  static constexpr size_type buffer_size = BufSize;//buffer大小，和迭代器那个定义是一样的
 
 private:
+  typedef mystl::alloc_holder<Alloc>               base_holder;
+
+  // 元素可以平凡重定位时，插入、删除时的搬移直接复制内存，不需要逐个移动、析构元素
+  typedef m_bool_constant<mystl::is_trivially_relocatable<T>::value> relocatable;
+
+  typedef deque_spare_buffers<pointer, DEQUE_SPARE_BUFFERS> spare_buffers;
+
   // 用以下四个数据来表现一个 deque
   iterator       begin_;     // 指向第一个节点
   iterator       end_;       // 指向最后一个结点
   map_pointer    map_;       // 指向一块 map，map 中的每个元素都是一个指针，指向一个缓冲区
   size_type      map_size_;  // map 内指针的数目
+  spare_buffers  spare_;     // 空出的缓冲区，再次需要缓冲区时优先取用
 
 public:
   // 构造、复制、移动、析构函数
@@ -266,57 +341,66 @@ public:
   deque()
   { fill_init(0, value_type()); }
 
-  explicit deque(size_type n)
+  explicit deque(const allocator_type& alloc)
+    :base_holder(alloc)
+  { map_init(0); }
+
+  explicit deque(size_type n, const allocator_type& alloc = allocator_type())
+    :base_holder(alloc)
   { fill_init(n, value_type()); }
 
-  deque(size_type n, const value_type& value)
+  deque(size_type n, const value_type& value, const allocator_type& alloc = allocator_type())
+    :base_holder(alloc)
   { fill_init(n, value); }
 
   template <class IIter, typename std::enable_if<
     mystl::is_input_iterator<IIter>::value, int>::type = 0>
-  deque(IIter first, IIter last)
+  deque(IIter first, IIter last, const allocator_type& alloc = allocator_type())
+    :base_holder(alloc)
   { copy_init(first, last, iterator_category(first)); }
 
-  deque(std::initializer_list<value_type> ilist)
+  deque(std::initializer_list<value_type> ilist, const allocator_type& alloc = allocator_type())
+    :base_holder(alloc)
   {
     copy_init(ilist.begin(), ilist.end(), mystl::forward_iterator_tag());
   }
 
   deque(const deque& rhs)
+    :base_holder(alloc_traits::select_on_container_copy_construction(rhs.get_alloc()))
+  {
+    copy_init(rhs.begin(), rhs.end(), mystl::forward_iterator_tag());
+  }
+  deque(const deque& rhs, const allocator_type& alloc)
+    :base_holder(alloc)
   {
     copy_init(rhs.begin(), rhs.end(), mystl::forward_iterator_tag());
   }
   deque(deque&& rhs) noexcept
-    :begin_(mystl::move(rhs.begin_)),
+    :base_holder(mystl::move(rhs.get_alloc())),
+    begin_(mystl::move(rhs.begin_)),
     end_(mystl::move(rhs.end_)),
     map_(rhs.map_),
-    map_size_(rhs.map_size_)
+    map_size_(rhs.map_size_),
+    spare_(rhs.spare_)
   {
     rhs.map_ = nullptr;
     rhs.map_size_ = 0;
+    rhs.spare_.count = 0;
   }
+  deque(deque&& rhs, const allocator_type& alloc);
 
   deque& operator=(const deque& rhs);
-  deque& operator=(deque&& rhs);
+  deque& operator=(deque&& rhs) noexcept(alloc_move_steals<Alloc>::value);
 
   deque& operator=(std::initializer_list<value_type> ilist)
   {
-    deque tmp(ilist);
+    deque tmp(ilist, this->get_alloc());
     swap(tmp);
     return *this;
   }
 
   ~deque()
-  {
-    if (map_ != nullptr)
-    {
-      clear();
-      data_allocator::deallocate(*begin_.node, buffer_size);
-      *begin_.node = nullptr;
-      map_allocator::deallocate(map_, map_size_);
-      map_ = nullptr;
-    }
-  }
+  { free_storage(); }
 
 public:
   // 迭代器相关操作
@@ -356,17 +440,25 @@ public:
   void      resize(size_type new_size) { resize(new_size, value_type()); }
   void      resize(size_type new_size, const value_type& value);
   void      shrink_to_fit() noexcept;
+  memory_usage_info memory_usage() const noexcept;
+
+  // 保证之后在头部（尾部）插入 n 个元素时不会再申请 map 与缓冲区
+  void      reserve_front(size_type n) { require_capacity(n, true); }
+  void      reserve_back(size_type n)  { require_capacity(n, false); }
 
   // 访问元素相关操作 
+  // n 从 begin_ 起一定向后，直接由 map 算出所在的缓冲区与位置，不必构造迭代器
   reference       operator[](size_type n)
   {
     MYSTL_DEBUG(n < size());
-    return begin_[n];
+    const size_type i = n + static_cast<size_type>(begin_.cur - begin_.first);
+    return begin_.node[i / buffer_size][i % buffer_size];
   }
   const_reference operator[](size_type n) const
   {
     MYSTL_DEBUG(n < size());
-    return begin_[n];
+    const size_type i = n + static_cast<size_type>(begin_.cur - begin_.first);
+    return begin_.node[i / buffer_size][i % buffer_size];
   }
 
   reference       at(size_type n)      
@@ -463,8 +555,13 @@ private:
 
   // create node / destroy node
   map_pointer create_map(size_type size);
+  void        destroy_map(map_pointer mp, size_type size);
+  void        free_storage();
   void        create_buffer(map_pointer nstart, map_pointer nfinish);
   void        destroy_buffer(map_pointer nstart, map_pointer nfinish);
+  pointer     acquire_buffer();
+  void        release_buffer(pointer buf) noexcept;
+  void        free_spare() noexcept;
 
   // initialize
   void        map_init(size_type nelem);
@@ -492,21 +589,60 @@ private:
   template <class FIter>
   void        insert_dispatch(iterator, FIter, FIter, forward_iterator_tag);
 
+  // relocate
+  iterator    open_gap(iterator position, size_type n);
+  void        close_gap(iterator gap, size_type n) noexcept;
+  void        relocate_forward(iterator first, iterator last, iterator result) noexcept;
+  void        relocate_backward(iterator first, iterator last, iterator result) noexcept;
+
   // reallocate
   void        require_capacity(size_type n, bool front);
-  void        reallocate_map_at_front(size_type need);
-  void        reallocate_map_at_back(size_type need);
+  void        reallocate_map(size_type need_buffer, bool front);
+
+  // move assign
+  void        move_assign(deque& rhs, m_true_type);
+  void        move_assign(deque& rhs, m_false_type);
 
 };
 
 /*****************************************************************************************/
 
+// 使用另一个配置器的移动构造函数，配置器不相等时只能逐个移动元素
+template <class T, class Alloc, size_t BufSize>
+deque<T, Alloc, BufSize>::deque(deque&& rhs, const allocator_type& alloc)
+  :base_holder(alloc)
+{
+  if (this->get_alloc() == rhs.get_alloc())
+  {
+    begin_ = rhs.begin_;
+    end_ = rhs.end_;
+    map_ = rhs.map_;
+    map_size_ = rhs.map_size_;
+    spare_ = rhs.spare_;
+    rhs.map_ = nullptr;
+    rhs.map_size_ = 0;
+    rhs.spare_.count = 0;
+  }
+  else
+  {
+    map_init(0);
+    move_assign(rhs, m_false_type());
+  }
+}
+
 // 复制赋值运算符
-template <class T>
-deque<T>& deque<T>::operator=(const deque& rhs)
+template <class T, class Alloc, size_t BufSize>
+deque<T, Alloc, BufSize>& deque<T, Alloc, BufSize>::operator=(const deque& rhs)
 {
   if (this != &rhs)
   {
+    if (alloc_traits::propagate_on_container_copy_assignment::value &&
+        this->get_alloc() != rhs.get_alloc())
+    { // 配置器要随之复制，旧的空间必须先用旧的配置器释放
+      free_storage();
+      mystl::alloc_on_copy(this->get_alloc(), rhs.get_alloc());
+      map_init(0);
+    }
     const auto len = size();
     if (len >= rhs.size())
     {
@@ -514,31 +650,27 @@ deque<T>& deque<T>::operator=(const deque& rhs)
     }
     else
     {
-      iterator mid = rhs.begin() + static_cast<difference_type>(len);
-      mystl::copy(rhs.begin_, mid, begin_);
-      insert(end_, mid, rhs.end_);
+      const_iterator mid = rhs.begin() + static_cast<difference_type>(len);
+      mystl::copy(rhs.begin(), mid, begin_);
+      insert(end_, mid, rhs.end());
     }
   }
   return *this;
 }
 
 // 移动赋值运算符
-template <class T>
-deque<T>& deque<T>::operator=(deque&& rhs)
+template <class T, class Alloc, size_t BufSize>
+deque<T, Alloc, BufSize>& deque<T, Alloc, BufSize>::operator=(deque&& rhs)
+noexcept(alloc_move_steals<Alloc>::value)
 {
-  clear();
-  begin_ = mystl::move(rhs.begin_);
-  end_ = mystl::move(rhs.end_);
-  map_ = rhs.map_;
-  map_size_ = rhs.map_size_;
-  rhs.map_ = nullptr;
-  rhs.map_size_ = 0;
+  if (this != &rhs)
+    move_assign(rhs, alloc_move_steals<Alloc>());
   return *this;
 }
 
 // 重置容器大小
-template <class T>
-void deque<T>::resize(size_type new_size, const value_type& value)
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::resize(size_type new_size, const value_type& value)
 {
   const auto len = size();
   if (new_size < len)
@@ -552,30 +684,48 @@ void deque<T>::resize(size_type new_size, const value_type& value)
 }
 
 // 减小容器容量
-template <class T>
-void deque<T>::shrink_to_fit() noexcept
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::shrink_to_fit() noexcept
 {
   // 至少会留下头部缓冲区
   for (auto cur = map_; cur < begin_.node; ++cur)
   {
-    data_allocator::deallocate(*cur, buffer_size);
+    if (*cur != nullptr)
+      alloc_traits::deallocate(this->get_alloc(), *cur, buffer_size);
     *cur = nullptr;
   }
   for (auto cur = end_.node + 1; cur < map_ + map_size_; ++cur)
   {
-    data_allocator::deallocate(*cur, buffer_size);
+    if (*cur != nullptr)
+      alloc_traits::deallocate(this->get_alloc(), *cur, buffer_size);
     *cur = nullptr;
   }
+  free_spare();
+}
+
+// 堆内存占用：所有已分配的缓冲区（包括缓存的空闲缓冲区）与 map
+template <class T, class Alloc, size_t BufSize>
+memory_usage_info deque<T, Alloc, BufSize>::memory_usage() const noexcept
+{
+  size_type buffers = spare_.count;
+  for (size_type i = 0; i < map_size_; ++i)
+  {
+    if (map_[i] != nullptr)
+      ++buffers;
+  }
+  const size_type payload = size() * sizeof(T);
+  return memory_usage_info{ payload,
+    buffers * buffer_size * sizeof(T) - payload + map_size_ * sizeof(pointer) };
 }
 
 // 在头部就地构建元素
-template <class T>
+template <class T, class Alloc, size_t BufSize>
 template <class ...Args>
-void deque<T>::emplace_front(Args&& ...args)
+void deque<T, Alloc, BufSize>::emplace_front(Args&& ...args)
 {
   if (begin_.cur != begin_.first)
   {
-    data_allocator::construct(begin_.cur - 1, mystl::forward<Args>(args)...);
+    alloc_traits::construct(this->get_alloc(), begin_.cur - 1, mystl::forward<Args>(args)...);
     --begin_.cur;
   }
   else
@@ -584,7 +734,7 @@ void deque<T>::emplace_front(Args&& ...args)
     try
     {
       --begin_;
-      data_allocator::construct(begin_.cur, mystl::forward<Args>(args)...);
+      alloc_traits::construct(this->get_alloc(), begin_.cur, mystl::forward<Args>(args)...);
     }
     catch (...)
     {
@@ -595,27 +745,27 @@ void deque<T>::emplace_front(Args&& ...args)
 }
 
 // 在尾部就地构建元素
-template <class T>
+template <class T, class Alloc, size_t BufSize>
 template <class ...Args>
-void deque<T>::emplace_back(Args&& ...args)
+void deque<T, Alloc, BufSize>::emplace_back(Args&& ...args)
 {
   if (end_.cur != end_.last - 1)
   {
-    data_allocator::construct(end_.cur, mystl::forward<Args>(args)...);
+    alloc_traits::construct(this->get_alloc(), end_.cur, mystl::forward<Args>(args)...);
     ++end_.cur;
   }
   else
   {
     require_capacity(1, false);
-    data_allocator::construct(end_.cur, mystl::forward<Args>(args)...);
+    alloc_traits::construct(this->get_alloc(), end_.cur, mystl::forward<Args>(args)...);
     ++end_;
   }
 }
 
 // 在 pos 位置就地构建元素
-template <class T>
+template <class T, class Alloc, size_t BufSize>
 template <class ...Args>
-typename deque<T>::iterator deque<T>::emplace(iterator pos, Args&& ...args)
+typename deque<T, Alloc, BufSize>::iterator deque<T, Alloc, BufSize>::emplace(iterator pos, Args&& ...args)
 {
   if (pos.cur == begin_.cur)
   {
@@ -631,12 +781,12 @@ typename deque<T>::iterator deque<T>::emplace(iterator pos, Args&& ...args)
 }
 
 // 在头部插入元素
-template <class T>
-void deque<T>::push_front(const value_type& value)
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::push_front(const value_type& value)
 {
   if (begin_.cur != begin_.first)
   {
-    data_allocator::construct(begin_.cur - 1, value);
+    alloc_traits::construct(this->get_alloc(), begin_.cur - 1, value);
     --begin_.cur;
   }
   else
@@ -645,7 +795,7 @@ void deque<T>::push_front(const value_type& value)
     try
     {
       --begin_;
-      data_allocator::construct(begin_.cur, value);
+      alloc_traits::construct(this->get_alloc(), begin_.cur, value);
     }
     catch (...)
     {
@@ -656,62 +806,62 @@ void deque<T>::push_front(const value_type& value)
 }
 
 // 在尾部插入元素
-template <class T>
-void deque<T>::push_back(const value_type& value)
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::push_back(const value_type& value)
 {
   if (end_.cur != end_.last - 1)
   {
-    data_allocator::construct(end_.cur, value);
+    alloc_traits::construct(this->get_alloc(), end_.cur, value);
     ++end_.cur;
   }
   else
   {
     require_capacity(1, false);
-    data_allocator::construct(end_.cur, value);
+    alloc_traits::construct(this->get_alloc(), end_.cur, value);
     ++end_;
   }
 }
 
 // 弹出头部元素
-template <class T>
-void deque<T>::pop_front()
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::pop_front()
 {
   MYSTL_DEBUG(!empty());
   if (begin_.cur != begin_.last - 1)
   {
-    data_allocator::destroy(begin_.cur);
+    alloc_traits::destroy(this->get_alloc(), begin_.cur);
     ++begin_.cur;
   }
   else
   {
-    data_allocator::destroy(begin_.cur);
+    alloc_traits::destroy(this->get_alloc(), begin_.cur);
     ++begin_;
     destroy_buffer(begin_.node - 1, begin_.node - 1);
   }
 }
 
 // 弹出尾部元素
-template <class T>
-void deque<T>::pop_back()
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::pop_back()
 {
   MYSTL_DEBUG(!empty());
   if (end_.cur != end_.first)
   {
     --end_.cur;
-    data_allocator::destroy(end_.cur);
+    alloc_traits::destroy(this->get_alloc(), end_.cur);
   }
   else
   {
     --end_;
-    data_allocator::destroy(end_.cur);
+    alloc_traits::destroy(this->get_alloc(), end_.cur);
     destroy_buffer(end_.node + 1, end_.node + 1);
   }
 }
 
 // 在 position 处插入元素
-template <class T>
-typename deque<T>::iterator
-deque<T>::insert(iterator position, const value_type& value)
+template <class T, class Alloc, size_t BufSize>
+typename deque<T, Alloc, BufSize>::iterator
+deque<T, Alloc, BufSize>::insert(iterator position, const value_type& value)
 {
   if (position.cur == begin_.cur)
   {
@@ -731,9 +881,9 @@ deque<T>::insert(iterator position, const value_type& value)
   }
 }
 
-template <class T>
-typename deque<T>::iterator
-deque<T>::insert(iterator position, value_type&& value)
+template <class T, class Alloc, size_t BufSize>
+typename deque<T, Alloc, BufSize>::iterator
+deque<T, Alloc, BufSize>::insert(iterator position, value_type&& value)
 {
   if (position.cur == begin_.cur)
   {
@@ -754,8 +904,8 @@ deque<T>::insert(iterator position, value_type&& value)
 }
 
 // 在 position 位置插入 n 个元素
-template <class T>
-void deque<T>::insert(iterator position, size_type n, const value_type& value)
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::insert(iterator position, size_type n, const value_type& value)
 {
   if (position.cur == begin_.cur)
   {
@@ -778,13 +928,19 @@ void deque<T>::insert(iterator position, size_type n, const value_type& value)
 }
 
 // 删除 position 处的元素
-template <class T>
-typename deque<T>::iterator
-deque<T>::erase(iterator position)
+template <class T, class Alloc, size_t BufSize>
+typename deque<T, Alloc, BufSize>::iterator
+deque<T, Alloc, BufSize>::erase(iterator position)
 {
+  const size_type elems_before = position - begin_;
+  if (relocatable::value)
+  {
+    alloc_traits::destroy(this->get_alloc(), position.cur);
+    close_gap(position, 1);
+    return begin_ + elems_before;
+  }
   auto next = position;
   ++next;
-  const size_type elems_before = position - begin_;
   if (elems_before < (size() / 2))
   {
     mystl::copy_backward(begin_, position, next);
@@ -799,9 +955,9 @@ deque<T>::erase(iterator position)
 }
 
 // 删除[first, last)上的元素
-template <class T>
-typename deque<T>::iterator
-deque<T>::erase(iterator first, iterator last)
+template <class T, class Alloc, size_t BufSize>
+typename deque<T, Alloc, BufSize>::iterator
+deque<T, Alloc, BufSize>::erase(iterator first, iterator last)
 {
   if (first == begin_ && last == end_)
   {
@@ -812,18 +968,23 @@ deque<T>::erase(iterator first, iterator last)
   {
     const size_type len = last - first;
     const size_type elems_before = first - begin_;
-    if (elems_before < ((size() - len) / 2))
+    if (relocatable::value)
+    {
+      mystl::destroy(first, last);
+      close_gap(first, len);
+    }
+    else if (elems_before < ((size() - len) / 2))
     {
       mystl::copy_backward(begin_, first, last);
       auto new_begin = begin_ + len;
-      data_allocator::destroy(begin_.cur, new_begin.cur);
+      mystl::destroy(begin_, new_begin);
       begin_ = new_begin;
     }
     else
     {
       mystl::copy(last, end_, first);
       auto new_end = end_ - len;
-      data_allocator::destroy(new_end.cur, end_.cur);
+      mystl::destroy(new_end, end_);
       end_ = new_end;
     }
     return begin_ + elems_before;
@@ -831,13 +992,13 @@ deque<T>::erase(iterator first, iterator last)
 }
 
 // 清空 deque
-template <class T>
-void deque<T>::clear()
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::clear()
 {
   // clear 会保留头部的缓冲区
   for (map_pointer cur = begin_.node + 1; cur < end_.node; ++cur)
   {
-    data_allocator::destroy(*cur, *cur + buffer_size);
+    mystl::destroy(*cur, *cur + buffer_size);
   }
   if (begin_.node != end_.node)
   { // 有两个以上的缓冲区
@@ -848,48 +1009,77 @@ void deque<T>::clear()
   {
     mystl::destroy(begin_.cur, end_.cur);
   }
+  end_ = begin_;  // 先收缩到头部缓冲区，中间的缓冲区才会被释放
   shrink_to_fit();
-  end_ = begin_;
 }
 
 // 交换两个 deque
-template <class T>
-void deque<T>::swap(deque& rhs) noexcept
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::swap(deque& rhs) noexcept
 {
   if (this != &rhs)
   {
+    MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value ||
+                this->get_alloc() == rhs.get_alloc());
+    mystl::alloc_on_swap(this->get_alloc(), rhs.get_alloc());
     mystl::swap(begin_, rhs.begin_);
     mystl::swap(end_, rhs.end_);
     mystl::swap(map_, rhs.map_);
     mystl::swap(map_size_, rhs.map_size_);
+    mystl::swap(spare_, rhs.spare_);
   }
 }
 
 /*****************************************************************************************/
 // helper function
 
-template <class T>
-typename deque<T>::map_pointer
-deque<T>::create_map(size_type size)
+template <class T, class Alloc, size_t BufSize>
+typename deque<T, Alloc, BufSize>::map_pointer
+deque<T, Alloc, BufSize>::create_map(size_type size)
 {
   map_pointer mp = nullptr;
-  mp = map_allocator::allocate(size);
+  map_allocator alloc(this->get_alloc());
+  mp = map_alloc_traits::allocate(alloc, size);
   for (size_type i = 0; i < size; ++i)
     *(mp + i) = nullptr;
   return mp;
 }
 
+// destroy_map 函数
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::destroy_map(map_pointer mp, size_type size)
+{
+  map_allocator alloc(this->get_alloc());
+  map_alloc_traits::deallocate(alloc, mp, size);
+}
+
+// free_storage 函数，销毁所有元素并释放全部空间
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::free_storage()
+{
+  if (map_ != nullptr)
+  {
+    clear();
+    alloc_traits::deallocate(this->get_alloc(), *begin_.node, buffer_size);
+    *begin_.node = nullptr;
+    destroy_map(map_, map_size_);
+    map_ = nullptr;
+    map_size_ = 0;
+  }
+}
+
 // create_buffer 函数
-template <class T>
-void deque<T>::
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::
 create_buffer(map_pointer nstart, map_pointer nfinish)
 {
   map_pointer cur;
   try
   {
     for (cur = nstart; cur <= nfinish; ++cur)
-    {
-      *cur = data_allocator::allocate(buffer_size);
+    { // 之前收缩时留下的缓冲区可以直接沿用
+      if (*cur == nullptr)
+        *cur = acquire_buffer();
     }
   }
   catch (...)
@@ -897,7 +1087,7 @@ create_buffer(map_pointer nstart, map_pointer nfinish)
     while (cur != nstart)
     {
       --cur;
-      data_allocator::deallocate(*cur, buffer_size);
+      release_buffer(*cur);
       *cur = nullptr;
     }
     throw;
@@ -905,20 +1095,48 @@ create_buffer(map_pointer nstart, map_pointer nfinish)
 }
 
 // destroy_buffer 函数
-template <class T>
-void deque<T>::
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::
 destroy_buffer(map_pointer nstart, map_pointer nfinish)
 {
   for (map_pointer n = nstart; n <= nfinish; ++n)
   {
-    data_allocator::deallocate(*n, buffer_size);
+    release_buffer(*n);
     *n = nullptr;
   }
 }
 
+// acquire_buffer 函数，优先取用缓存的缓冲区
+template <class T, class Alloc, size_t BufSize>
+typename deque<T, Alloc, BufSize>::pointer
+deque<T, Alloc, BufSize>::acquire_buffer()
+{
+  if (spare_.count != 0)
+    return spare_.buf[--spare_.count];
+  return alloc_traits::allocate(this->get_alloc(), buffer_size);
+}
+
+// release_buffer 函数，缓存未满时留下缓冲区，否则释放
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::release_buffer(pointer buf) noexcept
+{
+  if (spare_.count != DEQUE_SPARE_BUFFERS)
+    spare_.buf[spare_.count++] = buf;
+  else
+    alloc_traits::deallocate(this->get_alloc(), buf, buffer_size);
+}
+
+// free_spare 函数，释放缓存的全部缓冲区
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::free_spare() noexcept
+{
+  while (spare_.count != 0)
+    alloc_traits::deallocate(this->get_alloc(), spare_.buf[--spare_.count], buffer_size);
+}
+
 // map_init 函数
-template <class T>
-void deque<T>::
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::
 map_init(size_type nElem)
 {
   const size_type nNode = nElem / buffer_size + 1;  // 需要分配的缓冲区个数
@@ -943,7 +1161,7 @@ map_init(size_type nElem)
   }
   catch (...)
   {
-    map_allocator::deallocate(map_, map_size_);
+    destroy_map(map_, map_size_);
     map_ = nullptr;
     map_size_ = 0;
     throw;
@@ -955,8 +1173,8 @@ map_init(size_type nElem)
 }
 
 // fill_init 函数
-template <class T>
-void deque<T>::
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::
 fill_init(size_type n, const value_type& value)
 {
   map_init(n);
@@ -971,9 +1189,9 @@ fill_init(size_type n, const value_type& value)
 }
 
 // copy_init 函数
-template <class T>
+template <class T, class Alloc, size_t BufSize>
 template <class IIter>
-void deque<T>::
+void deque<T, Alloc, BufSize>::
 copy_init(IIter first, IIter last, input_iterator_tag)
 {
   const size_type n = mystl::distance(first, last);
@@ -982,9 +1200,9 @@ copy_init(IIter first, IIter last, input_iterator_tag)
     emplace_back(*first);
 }
 
-template <class T>
+template <class T, class Alloc, size_t BufSize>
 template <class FIter>
-void deque<T>::
+void deque<T, Alloc, BufSize>::
 copy_init(FIter first, FIter last, forward_iterator_tag)
 {
   const size_type n = mystl::distance(first, last);
@@ -1000,8 +1218,8 @@ copy_init(FIter first, FIter last, forward_iterator_tag)
 }
 
 // fill_assign 函数
-template <class T>
-void deque<T>::
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::
 fill_assign(size_type n, const value_type& value)
 {
   if (n > size())
@@ -1017,9 +1235,9 @@ fill_assign(size_type n, const value_type& value)
 }
 
 // copy_assign 函数
-template <class T>
+template <class T, class Alloc, size_t BufSize>
 template <class IIter>
-void deque<T>::
+void deque<T, Alloc, BufSize>::
 copy_assign(IIter first, IIter last, input_iterator_tag)
 {
   auto first1 = begin();
@@ -1038,9 +1256,9 @@ copy_assign(IIter first, IIter last, input_iterator_tag)
   }
 }
 
-template <class T>
+template <class T, class Alloc, size_t BufSize>
 template <class FIter>
-void deque<T>::
+void deque<T, Alloc, BufSize>::
 copy_assign(FIter first, FIter last, forward_iterator_tag)
 {  
   const size_type len1 = size();
@@ -1059,14 +1277,28 @@ copy_assign(FIter first, FIter last, forward_iterator_tag)
 }
 
 // insert_aux 函数
-template <class T>
+template <class T, class Alloc, size_t BufSize>
 template <class... Args>
-typename deque<T>::iterator
-deque<T>::
+typename deque<T, Alloc, BufSize>::iterator
+deque<T, Alloc, BufSize>::
 insert_aux(iterator position, Args&& ...args)
 {
   const size_type elems_before = position - begin_;
   value_type value_copy = value_type(mystl::forward<Args>(args)...);
+  if (relocatable::value)
+  {
+    auto gap = open_gap(position, 1);
+    try
+    {
+      alloc_traits::construct(this->get_alloc(), gap.cur, mystl::move(value_copy));
+    }
+    catch (...)
+    {
+      close_gap(gap, 1);
+      throw;
+    }
+    return gap;
+  }
   if (elems_before < (size() / 2))
   { // 在前半段插入
     emplace_front(front());
@@ -1094,13 +1326,27 @@ insert_aux(iterator position, Args&& ...args)
 }
 
 // fill_insert 函数
-template <class T>
-void deque<T>::
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::
 fill_insert(iterator position, size_type n, const value_type& value)
 {
   const size_type elems_before = position - begin_;
   const size_type len = size();
   auto value_copy = value;
+  if (relocatable::value)
+  {
+    auto gap = open_gap(position, n);
+    try
+    {
+      mystl::uninitialized_fill(gap, gap + n, value_copy);
+    }
+    catch (...)
+    {
+      close_gap(gap, n);
+      throw;
+    }
+    return;
+  }
   if (elems_before < (len / 2))
   {
     require_capacity(n, true);
@@ -1169,13 +1415,27 @@ fill_insert(iterator position, size_type n, const value_type& value)
 }
 
 // copy_insert
-template <class T>
+template <class T, class Alloc, size_t BufSize>
 template <class FIter>
-void deque<T>::
+void deque<T, Alloc, BufSize>::
 copy_insert(iterator position, FIter first, FIter last, size_type n)
 {
   const size_type elems_before = position - begin_;
   auto len = size();
+  if (relocatable::value)
+  {
+    auto gap = open_gap(position, n);
+    try
+    {
+      mystl::uninitialized_copy(first, last, gap);
+    }
+    catch (...)
+    {
+      close_gap(gap, n);
+      throw;
+    }
+    return;
+  }
   if (elems_before < (len / 2))
   {
     require_capacity(n, true);
@@ -1248,9 +1508,9 @@ copy_insert(iterator position, FIter first, FIter last, size_type n)
 }
 
 // insert_dispatch 函数
-template <class T>
+template <class T, class Alloc, size_t BufSize>
 template <class IIter>
-void deque<T>::
+void deque<T, Alloc, BufSize>::
 insert_dispatch(iterator position, IIter first, IIter last, input_iterator_tag)
 {
   if (last <= first)  return;
@@ -1272,9 +1532,9 @@ insert_dispatch(iterator position, IIter first, IIter last, input_iterator_tag)
   }
 }
 
-template <class T>
+template <class T, class Alloc, size_t BufSize>
 template <class FIter>
-void deque<T>::
+void deque<T, Alloc, BufSize>::
 insert_dispatch(iterator position, FIter first, FIter last, forward_iterator_tag)
 {
   if (last <= first)  return;
@@ -1317,16 +1577,110 @@ insert_dispatch(iterator position, FIter first, FIter last, forward_iterator_tag
   }
 }
 
+// open_gap 函数，元素可以平凡重定位时使用
+// 把 position 前面或后面较少的一侧按字节搬开，在 position 处空出 n 个未初始化的位置，返回空位的起始
+template <class T, class Alloc, size_t BufSize>
+typename deque<T, Alloc, BufSize>::iterator
+deque<T, Alloc, BufSize>::open_gap(iterator position, size_type n)
+{
+  const size_type elems_before = position - begin_;
+  if (elems_before < (size() / 2))
+  {
+    require_capacity(n, true);
+    // 原来的迭代器可能会失效
+    auto new_begin = begin_ - n;
+    relocate_forward(begin_, begin_ + elems_before, new_begin);
+    begin_ = new_begin;
+  }
+  else
+  {
+    require_capacity(n, false);
+    relocate_backward(begin_ + elems_before, end_, end_ + n);
+    end_ += n;
+  }
+  return begin_ + elems_before;
+}
+
+// close_gap 函数，[gap, gap + n) 上没有元素，把较少的一侧按字节搬过来填上
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::close_gap(iterator gap, size_type n) noexcept
+{
+  const size_type elems_before = gap - begin_;
+  if (elems_before < ((size() - n) / 2))
+  {
+    relocate_backward(begin_, gap, gap + n);
+    begin_ += n;
+  }
+  else
+  {
+    relocate_forward(gap + n, end_, gap);
+    end_ -= n;
+  }
+}
+
+// relocate_forward 函数，把 [first, last) 按字节搬到以 result 为起始的位置，result 在 first 之前
+// 逐段调用 memmove，每一段都不跨越源与目标的缓冲区
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::
+relocate_forward(iterator first, iterator last, iterator result) noexcept
+{
+  size_type n = last - first;
+  pointer src = first.cur;
+  pointer dst = result.cur;
+  map_pointer snode = first.node;
+  map_pointer dnode = result.node;
+  while (n > 0)
+  {
+    if (src == *snode + buffer_size)
+      src = *++snode;
+    if (dst == *dnode + buffer_size)
+      dst = *++dnode;
+    const size_type len = mystl::min(n, mystl::min(
+      static_cast<size_type>(*snode + buffer_size - src),
+      static_cast<size_type>(*dnode + buffer_size - dst)));
+    std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), len * sizeof(T));
+    src += len;
+    dst += len;
+    n -= len;
+  }
+}
+
+// relocate_backward 函数，把 [first, last) 按字节搬到以 result 为结尾的位置，result 在 last 之后
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::
+relocate_backward(iterator first, iterator last, iterator result) noexcept
+{
+  size_type n = last - first;
+  pointer src = last.cur;
+  pointer dst = result.cur;
+  map_pointer snode = last.node;
+  map_pointer dnode = result.node;
+  while (n > 0)
+  {
+    if (src == *snode)
+      src = *--snode + buffer_size;
+    if (dst == *dnode)
+      dst = *--dnode + buffer_size;
+    const size_type len = mystl::min(n, mystl::min(
+      static_cast<size_type>(src - *snode),
+      static_cast<size_type>(dst - *dnode)));
+    src -= len;
+    dst -= len;
+    std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), len * sizeof(T));
+    n -= len;
+  }
+}
+
 // require_capacity 函数
-template <class T>
-void deque<T>::require_capacity(size_type n, bool front)
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::require_capacity(size_type n, bool front)
 {
   if (front && (static_cast<size_type>(begin_.cur - begin_.first) < n))
   {
     const size_type need_buffer = (n - (begin_.cur - begin_.first)) / buffer_size + 1;
     if (need_buffer > static_cast<size_type>(begin_.node - map_))
     {
-      reallocate_map_at_front(need_buffer);
+      reallocate_map(need_buffer, true);
       return;
     }
     create_buffer(begin_.node - need_buffer, begin_.node - 1);
@@ -1336,111 +1690,172 @@ void deque<T>::require_capacity(size_type n, bool front)
     const size_type need_buffer = (n - (end_.last - end_.cur - 1)) / buffer_size + 1;
     if (need_buffer > static_cast<size_type>((map_ + map_size_) - end_.node - 1))
     {
-      reallocate_map_at_back(need_buffer);
+      reallocate_map(need_buffer, false);
       return;
     }
     create_buffer(end_.node + 1, end_.node + need_buffer);
   }
 }
 
-// reallocate_map_at_front 函数
-template <class T>
-void deque<T>::reallocate_map_at_front(size_type need_buffer)
+// reallocate_map 函数，让 map 在头部（尾部）留出 need_buffer 个缓冲区并准备好缓冲区
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::reallocate_map(size_type need_buffer, bool front)
 {
-  const size_type new_map_size = mystl::max(map_size_ << 1,
-                                            map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
-  map_pointer new_map = create_map(new_map_size);
+  // 紧挨着已用部分的缓冲区是预留的，随已用部分一起搬移，其余的空闲缓冲区放回缓存
+  map_pointer lo = begin_.node;
+  map_pointer hi = end_.node;
+  while (lo != map_ && *(lo - 1) != nullptr)
+    --lo;
+  while (hi + 1 != map_ + map_size_ && *(hi + 1) != nullptr)
+    ++hi;
+  for (auto cur = map_; cur < lo; ++cur)
+  {
+    if (*cur != nullptr)
+    {
+      release_buffer(*cur);
+      *cur = nullptr;
+    }
+  }
+  for (auto cur = hi + 1; cur < map_ + map_size_; ++cur)
+  {
+    if (*cur != nullptr)
+    {
+      release_buffer(*cur);
+      *cur = nullptr;
+    }
+  }
+
+  const size_type front_buffer = front
+    ? mystl::max(need_buffer, static_cast<size_type>(begin_.node - lo))
+    : static_cast<size_type>(begin_.node - lo);
+  const size_type back_buffer = front
+    ? static_cast<size_type>(hi - end_.node)
+    : mystl::max(need_buffer, static_cast<size_type>(hi - end_.node));
   const size_type old_buffer = end_.node - begin_.node + 1;
-  const size_type new_buffer = old_buffer + need_buffer;
-
-  // 另新的 map 中的指针指向原来的 buffer，并开辟新的 buffer
-  auto begin = new_map + (new_map_size - new_buffer) / 2;
-  auto mid = begin + need_buffer;
-  auto end = mid + old_buffer;
-  create_buffer(begin, mid - 1);
-  for (auto begin1 = mid, begin2 = begin_.node; begin1 != end; ++begin1, ++begin2)
-    *begin1 = *begin2;
-
-  // 更新数据
-  map_allocator::deallocate(map_, map_size_);
-  map_ = new_map;
-  map_size_ = new_map_size;
-  begin_ = iterator(*mid + (begin_.cur - begin_.first), mid);
-  end_ = iterator(*(end - 1) + (end_.cur - end_.first), end - 1);
+  const size_type new_buffer = front_buffer + old_buffer + back_buffer;
+  const size_type keep = hi - lo + 1;
+
+  map_pointer new_begin = nullptr;
+  if (map_size_ > 2 * new_buffer)
+  { // map 足够大，在原来的 map 上把要保留的部分搬到中央，不必重新申请 map
+    new_begin = map_ + (map_size_ - new_buffer) / 2 + front_buffer;
+    map_pointer dst = new_begin - (begin_.node - lo);
+    std::memmove(static_cast<void*>(dst), static_cast<const void*>(lo), keep * sizeof(pointer));
+    for (auto cur = map_; cur < dst; ++cur)
+      *cur = nullptr;
+    for (auto cur = dst + keep; cur < map_ + map_size_; ++cur)
+      *cur = nullptr;
+  }
+  else
+  {
+    const size_type new_map_size = mystl::max(map_size_ << 1,
+                                              map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
+    map_pointer new_map = create_map(new_map_size);
+    new_begin = new_map + (new_map_size - new_buffer) / 2 + front_buffer;
+    map_pointer dst = new_begin - (begin_.node - lo);
+    for (auto cur = lo; cur <= hi; ++cur, ++dst)
+      *dst = *cur;
+    destroy_map(map_, map_size_);
+    map_ = new_map;
+    map_size_ = new_map_size;
+  }
+
+  // 更新数据，再准备好需要的缓冲区
+  map_pointer new_end = new_begin + old_buffer - 1;
+  begin_ = iterator(*new_begin + (begin_.cur - begin_.first), new_begin);
+  end_ = iterator(*new_end + (end_.cur - end_.first), new_end);
+  if (front)
+    create_buffer(new_begin - need_buffer, new_begin - 1);
+  else
+    create_buffer(new_end + 1, new_end + need_buffer);
 }
 
-// reallocate_map_at_back 函数
-template <class T>
-void deque<T>::reallocate_map_at_back(size_type need_buffer)
+// move_assign 函数，可以直接接管 rhs 的空间
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::move_assign(deque& rhs, m_true_type)
 {
-  const size_type new_map_size = mystl::max(map_size_ << 1,
-                                            map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
-  map_pointer new_map = create_map(new_map_size);
-  const size_type old_buffer = end_.node - begin_.node + 1;
-  const size_type new_buffer = old_buffer + need_buffer;
-
-  // 另新的 map 中的指针指向原来的 buffer，并开辟新的 buffer
-  auto begin = new_map + ((new_map_size - new_buffer) / 2);
-  auto mid = begin + old_buffer;
-  auto end = mid + need_buffer;
-  for (auto begin1 = begin, begin2 = begin_.node; begin1 != mid; ++begin1, ++begin2)
-    *begin1 = *begin2;
-  create_buffer(mid, end - 1);
-
-  // 更新数据
-  map_allocator::deallocate(map_, map_size_);
-  map_ = new_map;
-  map_size_ = new_map_size;
-  begin_ = iterator(*begin + (begin_.cur - begin_.first), begin);
-  end_ = iterator(*(mid - 1) + (end_.cur - end_.first), mid - 1);
+  free_storage();
+  mystl::alloc_on_move(this->get_alloc(), rhs.get_alloc());
+  begin_ = rhs.begin_;
+  end_ = rhs.end_;
+  map_ = rhs.map_;
+  map_size_ = rhs.map_size_;
+  spare_ = rhs.spare_;
+  rhs.map_ = nullptr;
+  rhs.map_size_ = 0;
+  rhs.spare_.count = 0;
+}
+
+// move_assign 函数，配置器不传播时，只有两者相等才能接管空间，否则逐个移动元素
+template <class T, class Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>::move_assign(deque& rhs, m_false_type)
+{
+  if (this->get_alloc() == rhs.get_alloc())
+  {
+    move_assign(rhs, m_true_type());
+  }
+  else
+  {
+    if (map_ == nullptr)
+      map_init(0);
+    clear();
+    for (auto it = rhs.begin(); it != rhs.end(); ++it)
+      emplace_back(mystl::move(*it));
+    rhs.clear();
+  }
 }
 
 // 重载比较操作符
-template <class T>
-bool operator==(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc, size_t BufSize>
+bool operator==(const deque<T, Alloc, BufSize>& lhs, const deque<T, Alloc, BufSize>& rhs)
 {
   return lhs.size() == rhs.size() && 
     mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class T>
-bool operator<(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc, size_t BufSize>
+bool operator<(const deque<T, Alloc, BufSize>& lhs, const deque<T, Alloc, BufSize>& rhs)
 {
   return mystl::lexicographical_compare(
     lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
-template <class T>
-bool operator!=(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc, size_t BufSize>
+bool operator!=(const deque<T, Alloc, BufSize>& lhs, const deque<T, Alloc, BufSize>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class T>
-bool operator>(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc, size_t BufSize>
+bool operator>(const deque<T, Alloc, BufSize>& lhs, const deque<T, Alloc, BufSize>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class T>
-bool operator<=(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc, size_t BufSize>
+bool operator<=(const deque<T, Alloc, BufSize>& lhs, const deque<T, Alloc, BufSize>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class T>
-bool operator>=(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc, size_t BufSize>
+bool operator>=(const deque<T, Alloc, BufSize>& lhs, const deque<T, Alloc, BufSize>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class T>
-void swap(deque<T>& lhs, deque<T>& rhs)
+template <class T, class Alloc, size_t BufSize>
+void swap(deque<T, Alloc, BufSize>& lhs, deque<T, Alloc, BufSize>& rhs)
 {
   lhs.swap(rhs);
 }
 
+// map 与缓冲区都在堆上，对象本身不含指向自身的指针，Alloc 可以平凡重定位时容器也可以平凡重定位
+template <class T, class Alloc, size_t BufSize>
+struct is_trivially_relocatable<deque<T, Alloc, BufSize>>
+  : m_bool_constant<is_trivially_relocatable<Alloc>::value> {};
+
 } // namespace mystl
 #endif // !MYTINYSTL_DEQUE_H_
 
@@ -0,0 +1,521 @@
+#ifndef MYTINYSTL_DYNAMIC_BITSET_H_
+#define MYTINYSTL_DYNAMIC_BITSET_H_
+
+// 这个头文件包含一个模板类 dynamic_bitset
+// dynamic_bitset : 长度可变的位集合，每个 64 位的字保存 64 个 bool
+
+// notes:
+//
+// 1. mystl 不提供 vector<bool>，需要按位保存的 bool 序列时使用 dynamic_bitset，内存只有 vector<char> 的 1/8
+// 2. count、any、all、none、find_first、find_next、位运算以及 set、reset、flip 都按字处理，
+//    计数与查找使用 popcount 与 ctz，位运算是对字数组的简单循环，编译器可以把它向量化
+// 3. 最后一个字中超出 size() 的位始终为 0，按字计数、比较时不需要额外处理
+// 4. blocks() 返回保存各字的数组，可以直接交给按字处理的循环
+//
+// 异常保证：
+// mystl::dynamic_bitset<Alloc> 满足基本异常保证，push_back、resize 满足强异常安全保证
+
+#include <cstdint>
+
+#include "vector.h"
+#include "exceptdef.h"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace mystl
+{
+
+// 64 位字中 1 的个数
+// 编译器声明支持 popcnt 指令时直接使用，否则用 SWAR 的方法逐步累加，避免调用按字节查表的库函数
+inline unsigned bit_popcount(uint64_t x) noexcept
+{
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__POPCNT__)
+  return static_cast<unsigned>(__builtin_popcountll(x));
+#elif defined(_MSC_VER) && defined(_M_X64) && defined(__AVX__)
+  return static_cast<unsigned>(__popcnt64(x));
+#else
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return static_cast<unsigned>((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// 64 位字中最低的 1 所在的位置，x 不能为 0
+inline unsigned bit_ctz(uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctzll(x));
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanForward64(&index, x);
+  return static_cast<unsigned>(index);
+#else
+  unsigned n = 0;
+  while ((x & 1) == 0)
+  {
+    x >>= 1;
+    ++n;
+  }
+  return n;
+#endif
+}
+
+// 模板类: dynamic_bitset
+// 模板参数 Alloc 代表保存字数组的空间配置器
+template <class Alloc = mystl::allocator<uint64_t>>
+class dynamic_bitset
+{
+public:
+  // dynamic_bitset 的嵌套型别定义
+  typedef uint64_t                                 block_type;
+  typedef Alloc                                    allocator_type;
+  typedef mystl::vector<block_type, Alloc>         block_vector;
+  typedef typename block_vector::size_type         size_type;
+
+  static constexpr size_type bits_per_block = 64;
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+  // 指向一位的代理对象
+  class reference
+  {
+    friend class dynamic_bitset;
+
+    block_type* block_;
+    block_type  mask_;
+
+    reference(block_type* block, size_type bit) noexcept
+      :block_(block), mask_(block_type(1) << bit)
+    {
+    }
+
+  public:
+    reference(const reference&) = default;
+
+    operator bool() const noexcept
+    { return (*block_ & mask_) != 0; }
+    bool operator~() const noexcept
+    { return (*block_ & mask_) == 0; }
+
+    reference& operator=(bool value) noexcept
+    {
+      if (value)
+        *block_ |= mask_;
+      else
+        *block_ &= ~mask_;
+      return *this;
+    }
+    reference& operator=(const reference& rhs) noexcept
+    { return *this = static_cast<bool>(rhs); }
+
+    reference& flip() noexcept
+    {
+      *block_ ^= mask_;
+      return *this;
+    }
+  };
+
+  typedef bool                                     const_reference;
+
+private:
+  block_vector words_;  // 保存各位的字数组
+  size_type    nbits_;  // 位数
+
+public:
+  // 构造、复制、移动、析构函数
+  dynamic_bitset() noexcept
+    :words_(), nbits_(0)
+  {
+  }
+
+  explicit dynamic_bitset(size_type n, bool value = false,
+                          const allocator_type& alloc = allocator_type())
+    :words_(blocks_for(n), value ? ~block_type(0) : block_type(0), alloc), nbits_(n)
+  {
+    clear_unused_bits();
+  }
+
+  dynamic_bitset(const dynamic_bitset& rhs) = default;
+  dynamic_bitset(dynamic_bitset&& rhs) noexcept
+    :words_(mystl::move(rhs.words_)), nbits_(rhs.nbits_)
+  {
+    rhs.nbits_ = 0;
+  }
+
+  dynamic_bitset& operator=(const dynamic_bitset& rhs) = default;
+  dynamic_bitset& operator=(dynamic_bitset&& rhs) noexcept
+  {
+    words_ = mystl::move(rhs.words_);
+    nbits_ = rhs.nbits_;
+    rhs.nbits_ = 0;
+    return *this;
+  }
+
+  ~dynamic_bitset() = default;
+
+public:
+  // 容量相关操作
+  bool      empty()      const noexcept { return nbits_ == 0; }
+  size_type size()       const noexcept { return nbits_; }
+  size_type num_blocks() const noexcept { return words_.size(); }
+  size_type max_size()   const noexcept
+  {
+    return words_.max_size() < npos / bits_per_block
+      ? words_.max_size() * bits_per_block : npos - bits_per_block;
+  }
+  size_type capacity()   const noexcept { return words_.capacity() * bits_per_block; }
+  void      reserve(size_type n)        { words_.reserve(blocks_for(n)); }
+  void      shrink_to_fit()             { words_.shrink_to_fit(); }
+  memory_usage_info memory_usage() const noexcept
+  { return words_.memory_usage(); }
+
+  // 字数组
+  block_type*       blocks()       noexcept { return words_.data(); }
+  const block_type* blocks() const noexcept { return words_.data(); }
+
+  // 访问元素相关操作
+  reference operator[](size_type pos)
+  {
+    MYSTL_DEBUG(pos < nbits_);
+    return reference(words_.data() + pos / bits_per_block, pos % bits_per_block);
+  }
+  bool operator[](size_type pos) const
+  {
+    MYSTL_DEBUG(pos < nbits_);
+    return get_bit(pos);
+  }
+  bool test(size_type pos) const
+  {
+    THROW_OUT_OF_RANGE_IF(!(pos < nbits_), "dynamic_bitset<Alloc>::test() subscript out of range");
+    return get_bit(pos);
+  }
+
+  // 修改容器相关操作
+
+  dynamic_bitset& set() noexcept
+  {
+    fill(true);
+    return *this;
+  }
+  dynamic_bitset& set(size_type pos, bool value = true)
+  {
+    THROW_OUT_OF_RANGE_IF(!(pos < nbits_), "dynamic_bitset<Alloc>::set() subscript out of range");
+    (*this)[pos] = value;
+    return *this;
+  }
+  dynamic_bitset& reset() noexcept
+  {
+    fill(false);
+    return *this;
+  }
+  dynamic_bitset& reset(size_type pos)
+  { return set(pos, false); }
+  dynamic_bitset& flip() noexcept;
+  dynamic_bitset& flip(size_type pos)
+  {
+    THROW_OUT_OF_RANGE_IF(!(pos < nbits_), "dynamic_bitset<Alloc>::flip() subscript out of range");
+    (*this)[pos].flip();
+    return *this;
+  }
+
+  // 把所有位设为 value
+  void fill(bool value) noexcept;
+
+  void push_back(bool value)
+  {
+    if (nbits_ % bits_per_block == 0)
+      words_.push_back(block_type(0));
+    ++nbits_;
+    (*this)[nbits_ - 1] = value;
+  }
+  void pop_back()
+  {
+    MYSTL_DEBUG(!empty());
+    (*this)[nbits_ - 1] = false;
+    --nbits_;
+    if (nbits_ % bits_per_block == 0)
+      words_.pop_back();
+  }
+
+  void resize(size_type n, bool value = false);
+  void clear() noexcept
+  {
+    words_.clear();
+    nbits_ = 0;
+  }
+
+  void swap(dynamic_bitset& rhs) noexcept
+  {
+    words_.swap(rhs.words_);
+    mystl::swap(nbits_, rhs.nbits_);
+  }
+
+  // 按字统计与查找
+  size_type count() const noexcept;
+  bool      any()   const noexcept;
+  bool      none()  const noexcept { return !any(); }
+  bool      all()   const noexcept;
+
+  // 第一个为 1 的位，没有时返回 npos
+  size_type find_first() const noexcept
+  { return find_from_block(0); }
+  // pos 之后第一个为 1 的位，没有时返回 npos
+  size_type find_next(size_type pos) const noexcept;
+
+  // 位运算，两者的长度必须相同
+  dynamic_bitset& operator&=(const dynamic_bitset& rhs) noexcept;
+  dynamic_bitset& operator|=(const dynamic_bitset& rhs) noexcept;
+  dynamic_bitset& operator^=(const dynamic_bitset& rhs) noexcept;
+  // 清除 rhs 中为 1 的位
+  dynamic_bitset& operator-=(const dynamic_bitset& rhs) noexcept;
+
+  dynamic_bitset operator~() const
+  {
+    dynamic_bitset tmp(*this);
+    tmp.flip();
+    return tmp;
+  }
+
+  bool operator==(const dynamic_bitset& rhs) const noexcept
+  {
+    return nbits_ == rhs.nbits_ &&
+      mystl::equal(words_.begin(), words_.end(), rhs.words_.begin());
+  }
+  bool operator!=(const dynamic_bitset& rhs) const noexcept
+  { return !(*this == rhs); }
+
+private:
+  // helper functions
+
+  static size_type blocks_for(size_type n) noexcept
+  { return n / bits_per_block + (n % bits_per_block != 0); }
+
+  bool get_bit(size_type pos) const noexcept
+  { return (words_[pos / bits_per_block] >> (pos % bits_per_block)) & 1; }
+
+  // 最后一个字中超出 size() 的位清零
+  void clear_unused_bits() noexcept
+  {
+    const size_type extra = nbits_ % bits_per_block;
+    if (extra != 0)
+      words_.back() &= (block_type(1) << extra) - 1;
+  }
+
+  size_type find_from_block(size_type first_block) const noexcept;
+};
+
+/*****************************************************************************************/
+
+template <class Alloc>
+constexpr typename dynamic_bitset<Alloc>::size_type dynamic_bitset<Alloc>::bits_per_block;
+
+template <class Alloc>
+constexpr typename dynamic_bitset<Alloc>::size_type dynamic_bitset<Alloc>::npos;
+
+// 翻转所有位
+template <class Alloc>
+dynamic_bitset<Alloc>& dynamic_bitset<Alloc>::flip() noexcept
+{
+  block_type* w = words_.data();
+  const size_type n = words_.size();
+  for (size_type i = 0; i < n; ++i)
+    w[i] = ~w[i];
+  clear_unused_bits();
+  return *this;
+}
+
+template <class Alloc>
+void dynamic_bitset<Alloc>::fill(bool value) noexcept
+{
+  const block_type v = value ? ~block_type(0) : block_type(0);
+  block_type* w = words_.data();
+  const size_type n = words_.size();
+  for (size_type i = 0; i < n; ++i)
+    w[i] = v;
+  clear_unused_bits();
+}
+
+// 重置位数，新增的位为 value
+template <class Alloc>
+void dynamic_bitset<Alloc>::resize(size_type n, bool value)
+{
+  const size_type old_bits = nbits_;
+  const block_type v = value ? ~block_type(0) : block_type(0);
+  words_.resize(blocks_for(n), v);
+  nbits_ = n;
+  if (n > old_bits && value && old_bits % bits_per_block != 0)
+  { // 原来最后一个字中未使用的位补为 1
+    words_[old_bits / bits_per_block] |= ~block_type(0) << (old_bits % bits_per_block);
+  }
+  clear_unused_bits();
+}
+
+template <class Alloc>
+typename dynamic_bitset<Alloc>::size_type
+dynamic_bitset<Alloc>::count() const noexcept
+{
+  const block_type* w = words_.data();
+  const size_type n = words_.size();
+  size_type result = 0;
+  for (size_type i = 0; i < n; ++i)
+    result += mystl::bit_popcount(w[i]);
+  return result;
+}
+
+template <class Alloc>
+bool dynamic_bitset<Alloc>::any() const noexcept
+{
+  const block_type* w = words_.data();
+  const size_type n = words_.size();
+  for (size_type i = 0; i < n; ++i)
+  {
+    if (w[i] != 0)
+      return true;
+  }
+  return false;
+}
+
+template <class Alloc>
+bool dynamic_bitset<Alloc>::all() const noexcept
+{
+  const size_type full = nbits_ / bits_per_block;
+  const block_type* w = words_.data();
+  for (size_type i = 0; i < full; ++i)
+  {
+    if (w[i] != ~block_type(0))
+      return false;
+  }
+  const size_type extra = nbits_ % bits_per_block;
+  return extra == 0 || w[full] == (block_type(1) << extra) - 1;
+}
+
+template <class Alloc>
+typename dynamic_bitset<Alloc>::size_type
+dynamic_bitset<Alloc>::find_next(size_type pos) const noexcept
+{
+  if (pos == npos || pos + 1 >= nbits_)
+    return npos;
+  ++pos;
+  const size_type b = pos / bits_per_block;
+  const block_type rest = words_[b] >> (pos % bits_per_block);
+  if (rest != 0)
+    return pos + mystl::bit_ctz(rest);
+  return find_from_block(b + 1);
+}
+
+template <class Alloc>
+dynamic_bitset<Alloc>& dynamic_bitset<Alloc>::operator&=(const dynamic_bitset& rhs) noexcept
+{
+  MYSTL_DEBUG(nbits_ == rhs.nbits_);
+  block_type* w = words_.data();
+  const block_type* r = rhs.words_.data();
+  const size_type n = words_.size();
+  for (size_type i = 0; i < n; ++i)
+    w[i] &= r[i];
+  return *this;
+}
+
+template <class Alloc>
+dynamic_bitset<Alloc>& dynamic_bitset<Alloc>::operator|=(const dynamic_bitset& rhs) noexcept
+{
+  MYSTL_DEBUG(nbits_ == rhs.nbits_);
+  block_type* w = words_.data();
+  const block_type* r = rhs.words_.data();
+  const size_type n = words_.size();
+  for (size_type i = 0; i < n; ++i)
+    w[i] |= r[i];
+  return *this;
+}
+
+template <class Alloc>
+dynamic_bitset<Alloc>& dynamic_bitset<Alloc>::operator^=(const dynamic_bitset& rhs) noexcept
+{
+  MYSTL_DEBUG(nbits_ == rhs.nbits_);
+  block_type* w = words_.data();
+  const block_type* r = rhs.words_.data();
+  const size_type n = words_.size();
+  for (size_type i = 0; i < n; ++i)
+    w[i] ^= r[i];
+  return *this;
+}
+
+template <class Alloc>
+dynamic_bitset<Alloc>& dynamic_bitset<Alloc>::operator-=(const dynamic_bitset& rhs) noexcept
+{
+  MYSTL_DEBUG(nbits_ == rhs.nbits_);
+  block_type* w = words_.data();
+  const block_type* r = rhs.words_.data();
+  const size_type n = words_.size();
+  for (size_type i = 0; i < n; ++i)
+    w[i] &= ~r[i];
+  return *this;
+}
+
+/*****************************************************************************************/
+// helper function
+
+// 从第 first_block 个字开始找第一个不为 0 的字
+template <class Alloc>
+typename dynamic_bitset<Alloc>::size_type
+dynamic_bitset<Alloc>::find_from_block(size_type first_block) const noexcept
+{
+  const block_type* w = words_.data();
+  const size_type n = words_.size();
+  for (size_type i = first_block; i < n; ++i)
+  {
+    if (w[i] != 0)
+      return i * bits_per_block + mystl::bit_ctz(w[i]);
+  }
+  return npos;
+}
+
+/*****************************************************************************************/
+// 重载位运算操作符
+
+template <class Alloc>
+dynamic_bitset<Alloc> operator&(const dynamic_bitset<Alloc>& lhs, const dynamic_bitset<Alloc>& rhs)
+{
+  dynamic_bitset<Alloc> tmp(lhs);
+  tmp &= rhs;
+  return tmp;
+}
+
+template <class Alloc>
+dynamic_bitset<Alloc> operator|(const dynamic_bitset<Alloc>& lhs, const dynamic_bitset<Alloc>& rhs)
+{
+  dynamic_bitset<Alloc> tmp(lhs);
+  tmp |= rhs;
+  return tmp;
+}
+
+template <class Alloc>
+dynamic_bitset<Alloc> operator^(const dynamic_bitset<Alloc>& lhs, const dynamic_bitset<Alloc>& rhs)
+{
+  dynamic_bitset<Alloc> tmp(lhs);
+  tmp ^= rhs;
+  return tmp;
+}
+
+template <class Alloc>
+dynamic_bitset<Alloc> operator-(const dynamic_bitset<Alloc>& lhs, const dynamic_bitset<Alloc>& rhs)
+{
+  dynamic_bitset<Alloc> tmp(lhs);
+  tmp -= rhs;
+  return tmp;
+}
+
+// 重载 mystl 的 swap
+template <class Alloc>
+void swap(dynamic_bitset<Alloc>& lhs, dynamic_bitset<Alloc>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+template <class Alloc>
+struct is_trivially_relocatable<dynamic_bitset<Alloc>>
+  : m_bool_constant<is_trivially_relocatable<mystl::vector<uint64_t, Alloc>>::value> {};
+
+} // namespace mystl
+#endif // !MYTINYSTL_DYNAMIC_BITSET_H_
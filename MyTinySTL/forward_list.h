@@ -0,0 +1,1003 @@
+#ifndef MYTINYSTL_FORWARD_LIST_H_
+#define MYTINYSTL_FORWARD_LIST_H_
+
+// 这个头文件包含了一个模板类 forward_list
+// forward_list : 单向链表
+
+// notes:
+//
+// 1. 节点只有一个 next 指针，链表以 nullptr 结尾，before_begin 是保存在容器对象内部的头节点，
+//    节点不会指向容器对象本身，所以容器可以平凡重定位
+// 2. 模板参数 CountSize 为 false 时容器不保存大小，对象只有一个指针大小（配置器为空类时），
+//    此时 size() 需要遍历链表，为 O(n)
+// 3. 节点逐个向配置器申请，不使用 node_pool，splice_after 在两个容器之间直接转移节点，不需要移动元素，
+//    两个容器的配置器必须相等
+// 4. sort 为非递归的原地归并排序，与 list::sort 一样是稳定的
+//
+// 异常保证：
+// mystl::forward_list<T> 满足基本异常保证，部分函数无异常保证，并对以下等函数做强异常安全保证：
+//   * emplace_front
+//   * emplace_after
+//   * push_front
+//   * insert_after
+
+#include <initializer_list>
+
+#include "iterator.h"
+#include "memory.h"
+#include "functional.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// forward_list 的节点结构
+
+struct forward_list_node_base
+{
+  forward_list_node_base* next;  // 下一节点
+};
+
+template <class T>
+struct forward_list_node : public forward_list_node_base
+{
+  T value;  // 数据域
+};
+
+// forward_list 的迭代器设计
+template <class T, class Ref, class Ptr>
+struct forward_list_iterator : public mystl::iterator<mystl::forward_iterator_tag, T>
+{
+  typedef forward_list_iterator<T, T&, T*>             iterator;
+  typedef forward_list_iterator<T, const T&, const T*> const_iterator;
+  typedef forward_list_iterator                        self;
+
+  typedef T                        value_type;
+  typedef Ptr                      pointer;
+  typedef Ref                      reference;
+  typedef ptrdiff_t                difference_type;
+  typedef forward_list_node_base*  base_ptr;
+  typedef forward_list_node<T>*    node_ptr;
+
+  base_ptr node_;  // 指向当前节点
+
+  // 构造、复制函数
+  forward_list_iterator() noexcept
+    :node_(nullptr) {}
+  explicit forward_list_iterator(base_ptr x) noexcept
+    :node_(x) {}
+  forward_list_iterator(const iterator& rhs) noexcept
+    :node_(rhs.node_) {}
+
+  self& operator=(const self& rhs) = default;
+
+  // 重载操作符
+  reference operator*()  const { return static_cast<node_ptr>(node_)->value; }
+  pointer   operator->() const { return &(operator*()); }
+
+  self& operator++()
+  {
+    MYSTL_DEBUG(node_ != nullptr);
+    node_ = node_->next;
+    return *this;
+  }
+  self operator++(int)
+  {
+    self tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  // 重载比较操作符
+  bool operator==(const self& rhs) const { return node_ == rhs.node_; }
+  bool operator!=(const self& rhs) const { return node_ != rhs.node_; }
+};
+
+// 模板类: forward_list_size
+// 按 CountSize 决定是否保存容器的大小，不保存时为空类
+template <bool CountSize>
+struct forward_list_size
+{
+  size_t size_;  // 大小
+
+  forward_list_size() noexcept :size_(0) {}
+
+  static constexpr bool counted = true;
+
+  size_t get() const noexcept    { return size_; }
+  void   set(size_t n) noexcept  { size_ = n; }
+  void   add(size_t n) noexcept  { size_ += n; }
+  void   sub(size_t n) noexcept  { size_ -= n; }
+};
+
+template <>
+struct forward_list_size<false>
+{
+  static constexpr bool counted = false;
+
+  size_t get() const noexcept    { return 0; }
+  void   set(size_t) noexcept    {}
+  void   add(size_t) noexcept    {}
+  void   sub(size_t) noexcept    {}
+};
+
+// 模板类: forward_list
+// 模板参数 T 代表数据类型，Alloc 代表空间配置器，缺省使用 mystl::allocator
+// CountSize 代表是否保存容器的大小
+template <class T, class Alloc = mystl::allocator<T>, bool CountSize = true>
+class forward_list : private mystl::alloc_holder<
+  typename mystl::allocator_traits<Alloc>::template rebind_alloc<forward_list_node<T>>>,
+  private forward_list_size<CountSize>
+{
+public:
+  // forward_list 的嵌套型别定义
+  typedef Alloc                                    allocator_type;
+  typedef typename mystl::allocator_traits<Alloc>::template
+    rebind_alloc<forward_list_node<T>>             node_allocator;
+  typedef mystl::allocator_traits<node_allocator>  node_alloc_traits;
+
+  typedef T                                        value_type;
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  typedef forward_list_iterator<T, T&, T*>             iterator;
+  typedef forward_list_iterator<T, const T&, const T*> const_iterator;
+
+  typedef forward_list_node_base*                  base_ptr;
+  typedef forward_list_node<T>*                    node_ptr;
+
+  allocator_type get_allocator() const { return allocator_type(this->get_alloc()); }
+
+private:
+  typedef mystl::alloc_holder<node_allocator>      base_holder;
+  typedef forward_list_size<CountSize>             size_holder;
+
+  forward_list_node_base head_;  // 头节点，head_.next 指向第一个元素
+
+public:
+  // 构造、复制、移动、析构函数
+  forward_list() noexcept
+  { head_.next = nullptr; }
+
+  explicit forward_list(const allocator_type& alloc)
+    :base_holder(node_allocator(alloc))
+  { head_.next = nullptr; }
+
+  explicit forward_list(size_type n, const allocator_type& alloc = allocator_type())
+    :base_holder(node_allocator(alloc))
+  {
+    head_.next = nullptr;
+    insert_after(cbefore_begin(), n, value_type());
+  }
+
+  forward_list(size_type n, const T& value, const allocator_type& alloc = allocator_type())
+    :base_holder(node_allocator(alloc))
+  {
+    head_.next = nullptr;
+    insert_after(cbefore_begin(), n, value);
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  forward_list(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+    :base_holder(node_allocator(alloc))
+  {
+    head_.next = nullptr;
+    insert_after(cbefore_begin(), first, last);
+  }
+
+  forward_list(std::initializer_list<T> ilist, const allocator_type& alloc = allocator_type())
+    :base_holder(node_allocator(alloc))
+  {
+    head_.next = nullptr;
+    insert_after(cbefore_begin(), ilist.begin(), ilist.end());
+  }
+
+  forward_list(const forward_list& rhs)
+    :base_holder(node_alloc_traits::select_on_container_copy_construction(rhs.get_alloc()))
+  {
+    head_.next = nullptr;
+    insert_after(cbefore_begin(), rhs.cbegin(), rhs.cend());
+  }
+
+  forward_list(const forward_list& rhs, const allocator_type& alloc)
+    :base_holder(node_allocator(alloc))
+  {
+    head_.next = nullptr;
+    insert_after(cbefore_begin(), rhs.cbegin(), rhs.cend());
+  }
+
+  forward_list(forward_list&& rhs) noexcept
+    :base_holder(mystl::move(rhs.get_alloc())), size_holder(rhs)
+  {
+    head_.next = rhs.head_.next;
+    rhs.head_.next = nullptr;
+    rhs.set(0);
+  }
+
+  forward_list(forward_list&& rhs, const allocator_type& alloc)
+    :base_holder(node_allocator(alloc))
+  {
+    head_.next = nullptr;
+    if (this->get_alloc() == rhs.get_alloc())
+    {
+      take(rhs);
+    }
+    else
+    {
+      auto pos = cbefore_begin();
+      for (auto& value : rhs)
+        pos = emplace_after(pos, mystl::move(value));
+    }
+  }
+
+  forward_list& operator=(const forward_list& rhs)
+  {
+    if (this != &rhs)
+    {
+      if (node_alloc_traits::propagate_on_container_copy_assignment::value &&
+          this->get_alloc() != rhs.get_alloc())
+      { // 配置器要随之复制，旧节点必须先用旧的配置器释放
+        clear();
+        mystl::alloc_on_copy(this->get_alloc(), rhs.get_alloc());
+      }
+      assign(rhs.begin(), rhs.end());
+    }
+    return *this;
+  }
+
+  forward_list& operator=(forward_list&& rhs) noexcept(alloc_move_steals<node_allocator>::value)
+  {
+    if (this != &rhs)
+      move_assign(rhs, alloc_move_steals<node_allocator>());
+    return *this;
+  }
+
+  forward_list& operator=(std::initializer_list<T> ilist)
+  {
+    assign(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  ~forward_list()
+  { clear(); }
+
+public:
+  // 迭代器相关操作
+  iterator               before_begin()        noexcept
+  { return iterator(&head_); }
+  const_iterator         before_begin()  const noexcept
+  { return const_iterator(const_cast<base_ptr>(&head_)); }
+  iterator               begin()               noexcept
+  { return iterator(head_.next); }
+  const_iterator         begin()         const noexcept
+  { return const_iterator(head_.next); }
+  iterator               end()                 noexcept
+  { return iterator(nullptr); }
+  const_iterator         end()           const noexcept
+  { return const_iterator(nullptr); }
+
+  const_iterator         cbefore_begin() const noexcept
+  { return before_begin(); }
+  const_iterator         cbegin()        const noexcept
+  { return begin(); }
+  const_iterator         cend()          const noexcept
+  { return end(); }
+
+  // 容量相关操作
+  bool      empty()    const noexcept
+  { return head_.next == nullptr; }
+
+  // 不保存大小时需要遍历链表
+  size_type size()     const noexcept
+  { return size_holder::counted ? this->get() : count_nodes(head_.next, nullptr); }
+
+  size_type max_size() const noexcept
+  { return static_cast<size_type>(-1); }
+
+  // 节点中的 next 指针计入 overhead
+  memory_usage_info memory_usage() const noexcept
+  {
+    const size_type n = size();
+    return memory_usage_info{ n * sizeof(T), n * (sizeof(forward_list_node<T>) - sizeof(T)) };
+  }
+
+  // 访问元素相关操作
+  reference       front()
+  {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+
+  const_reference front() const
+  {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+
+  // 调整容器相关操作
+
+  // assign
+
+  void     assign(size_type n, const value_type& value)
+  { fill_assign(n, value); }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void     assign(Iter first, Iter last)
+  { copy_assign(first, last); }
+
+  void     assign(std::initializer_list<T> ilist)
+  { copy_assign(ilist.begin(), ilist.end()); }
+
+  // emplace_front / emplace_after
+
+  template <class ...Args>
+  void     emplace_front(Args&& ...args)
+  { emplace_after(cbefore_begin(), mystl::forward<Args>(args)...); }
+
+  template <class ...Args>
+  iterator emplace_after(const_iterator pos, Args&& ...args)
+  {
+    MYSTL_DEBUG(pos.node_ != nullptr);
+    auto node = create_node(mystl::forward<Args>(args)...);
+    link_after(pos.node_, node, node);
+    this->add(1);
+    return iterator(node);
+  }
+
+  // push_front / pop_front
+
+  void     push_front(const value_type& value)
+  { emplace_after(cbefore_begin(), value); }
+
+  void     push_front(value_type&& value)
+  { emplace_after(cbefore_begin(), mystl::move(value)); }
+
+  void     pop_front()
+  {
+    MYSTL_DEBUG(!empty());
+    erase_after(cbefore_begin());
+  }
+
+  // insert_after，返回指向最后一个插入元素的迭代器，没有插入元素时返回 pos
+
+  iterator insert_after(const_iterator pos, const value_type& value)
+  { return emplace_after(pos, value); }
+
+  iterator insert_after(const_iterator pos, value_type&& value)
+  { return emplace_after(pos, mystl::move(value)); }
+
+  iterator insert_after(const_iterator pos, size_type n, const value_type& value);
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  iterator insert_after(const_iterator pos, Iter first, Iter last);
+
+  iterator insert_after(const_iterator pos, std::initializer_list<T> ilist)
+  { return insert_after(pos, ilist.begin(), ilist.end()); }
+
+  // erase_after / clear
+
+  iterator erase_after(const_iterator pos);
+  iterator erase_after(const_iterator first, const_iterator last);
+
+  void     clear() noexcept
+  {
+    destroy_chain(head_.next);
+    head_.next = nullptr;
+    this->set(0);
+  }
+
+  // resize
+
+  void     resize(size_type new_size) { resize(new_size, value_type()); }
+  void     resize(size_type new_size, const value_type& value);
+
+  void     swap(forward_list& rhs) noexcept
+  {
+    MYSTL_DEBUG(node_alloc_traits::propagate_on_container_swap::value ||
+                this->get_alloc() == rhs.get_alloc());
+    mystl::alloc_on_swap(this->get_alloc(), rhs.get_alloc());
+    mystl::swap(head_.next, rhs.head_.next);
+    mystl::swap(static_cast<size_holder&>(*this), static_cast<size_holder&>(rhs));
+  }
+
+  // forward_list 相关操作
+
+  void splice_after(const_iterator pos, forward_list& other);
+  void splice_after(const_iterator pos, forward_list& other, const_iterator it);
+  void splice_after(const_iterator pos, forward_list& other,
+                    const_iterator first, const_iterator last);
+
+  void remove(const value_type& value)
+  { remove_if([&](const value_type& v) {return v == value; }); }
+  template <class UnaryPredicate>
+  void remove_if(UnaryPredicate pred);
+
+  void unique()
+  { unique(mystl::equal_to<T>()); }
+  template <class BinaryPredicate>
+  void unique(BinaryPredicate pred);
+
+  void merge(forward_list& x)
+  { merge(x, mystl::less<T>()); }
+  template <class Compare>
+  void merge(forward_list& x, Compare comp);
+
+  void sort()
+  { flist_sort(mystl::less<T>()); }
+  template <class Compared>
+  void sort(Compared comp)
+  { flist_sort(comp); }
+
+  void reverse() noexcept;
+
+private:
+  // helper functions
+
+  // create / destroy node
+  template <class ...Args>
+  node_ptr  create_node(Args&& ...args);
+  void      destroy_node(base_ptr p) noexcept;
+  void      destroy_chain(base_ptr first) noexcept;
+
+  static size_type count_nodes(base_ptr first, base_ptr last) noexcept
+  {
+    size_type n = 0;
+    for (; first != last; first = first->next)
+      ++n;
+    return n;
+  }
+
+  // 在 pos 之后连接 [first, last] 的节点，这些节点已经依次相连
+  static void link_after(base_ptr pos, base_ptr first, base_ptr last) noexcept
+  {
+    last->next = pos->next;
+    pos->next = first;
+  }
+
+  // 把 (before, last] 的节点从 before 之后断开并连接到 pos 之后
+  static void splice_nodes(base_ptr pos, base_ptr before, base_ptr last) noexcept
+  {
+    base_ptr first = before->next;
+    before->next = last->next;
+    link_after(pos, first, last);
+  }
+
+  void      take(forward_list& rhs) noexcept
+  {
+    head_.next = rhs.head_.next;
+    this->set(rhs.get());
+    rhs.head_.next = nullptr;
+    rhs.set(0);
+  }
+
+  // assign
+  void      fill_assign(size_type n, const value_type& value);
+  template <class Iter>
+  void      copy_assign(Iter first, Iter last);
+
+  // sort
+  template <class Compared>
+  void      flist_sort(Compared comp);
+  template <class Compared>
+  static void merge_chains(base_ptr& result, base_ptr first, base_ptr second, Compared& comp);
+
+  // move assign
+  void      move_assign(forward_list& rhs, m_true_type);
+  void      move_assign(forward_list& rhs, m_false_type);
+};
+
+/*****************************************************************************************/
+
+// 在 pos 之后插入 n 个元素，先创建好整条链再连接，创建时抛出异常容器不变
+template <class T, class Alloc, bool CountSize>
+typename forward_list<T, Alloc, CountSize>::iterator
+forward_list<T, Alloc, CountSize>::
+insert_after(const_iterator pos, size_type n, const value_type& value)
+{
+  MYSTL_DEBUG(pos.node_ != nullptr);
+  if (n == 0)
+    return iterator(pos.node_);
+  THROW_LENGTH_ERROR_IF(size() > max_size() - n, "forward_list<T>'s size too big");
+  base_ptr first = create_node(value);
+  base_ptr last = first;
+  try
+  {
+    for (size_type i = 1; i < n; ++i)
+    {
+      last->next = create_node(value);
+      last = last->next;
+    }
+  }
+  catch (...)
+  {
+    destroy_chain(first);
+    throw;
+  }
+  link_after(pos.node_, first, last);
+  this->add(n);
+  return iterator(last);
+}
+
+// 在 pos 之后插入 [first, last) 的元素
+template <class T, class Alloc, bool CountSize>
+template <class Iter, typename std::enable_if<
+  mystl::is_input_iterator<Iter>::value, int>::type>
+typename forward_list<T, Alloc, CountSize>::iterator
+forward_list<T, Alloc, CountSize>::
+insert_after(const_iterator pos, Iter first, Iter last)
+{
+  MYSTL_DEBUG(pos.node_ != nullptr);
+  if (first == last)
+    return iterator(pos.node_);
+  base_ptr head = create_node(*first);
+  base_ptr tail = head;
+  size_type n = 1;
+  try
+  {
+    for (++first; first != last; ++first, ++n)
+    {
+      tail->next = create_node(*first);
+      tail = tail->next;
+    }
+  }
+  catch (...)
+  {
+    destroy_chain(head);
+    throw;
+  }
+  link_after(pos.node_, head, tail);
+  this->add(n);
+  return iterator(tail);
+}
+
+// 删除 pos 之后的元素，返回指向被删除元素之后的迭代器
+template <class T, class Alloc, bool CountSize>
+typename forward_list<T, Alloc, CountSize>::iterator
+forward_list<T, Alloc, CountSize>::erase_after(const_iterator pos)
+{
+  MYSTL_DEBUG(pos.node_ != nullptr && pos.node_->next != nullptr);
+  base_ptr n = pos.node_->next;
+  pos.node_->next = n->next;
+  destroy_node(n);
+  this->sub(1);
+  return iterator(pos.node_->next);
+}
+
+// 删除 (first, last) 内的元素
+template <class T, class Alloc, bool CountSize>
+typename forward_list<T, Alloc, CountSize>::iterator
+forward_list<T, Alloc, CountSize>::erase_after(const_iterator first, const_iterator last)
+{
+  MYSTL_DEBUG(first.node_ != nullptr);
+  base_ptr cur = first.node_->next;
+  first.node_->next = last.node_;
+  while (cur != last.node_)
+  {
+    base_ptr next = cur->next;
+    destroy_node(cur);
+    this->sub(1);
+    cur = next;
+  }
+  return iterator(last.node_);
+}
+
+// 重置容器大小
+template <class T, class Alloc, bool CountSize>
+void forward_list<T, Alloc, CountSize>::resize(size_type new_size, const value_type& value)
+{
+  base_ptr prev = &head_;
+  size_type len = 0;
+  while (prev->next != nullptr && len < new_size)
+  {
+    prev = prev->next;
+    ++len;
+  }
+  if (len == new_size)
+    erase_after(const_iterator(prev), cend());
+  else
+    insert_after(const_iterator(prev), new_size - len, value);
+}
+
+// 将 x 的所有节点接合于 pos 之后
+template <class T, class Alloc, bool CountSize>
+void forward_list<T, Alloc, CountSize>::splice_after(const_iterator pos, forward_list& x)
+{
+  MYSTL_DEBUG(this != &x && this->get_alloc() == x.get_alloc());
+  if (x.empty())
+    return;
+  base_ptr last = &x.head_;
+  while (last->next != nullptr)
+    last = last->next;
+  splice_nodes(pos.node_, &x.head_, last);
+  this->add(x.get());
+  x.set(0);
+}
+
+// 将 it 之后的一个节点接合于 pos 之后
+template <class T, class Alloc, bool CountSize>
+void forward_list<T, Alloc, CountSize>::
+splice_after(const_iterator pos, forward_list& x, const_iterator it)
+{
+  MYSTL_DEBUG(this->get_alloc() == x.get_alloc());
+  base_ptr n = it.node_->next;
+  if (pos.node_ == it.node_ || pos.node_ == n)
+    return;
+  splice_nodes(pos.node_, it.node_, n);
+  x.sub(1);
+  this->add(1);
+}
+
+// 将 x 的 (first, last) 内的节点接合于 pos 之后
+template <class T, class Alloc, bool CountSize>
+void forward_list<T, Alloc, CountSize>::
+splice_after(const_iterator pos, forward_list& x, const_iterator first, const_iterator last)
+{
+  MYSTL_DEBUG(this->get_alloc() == x.get_alloc());
+  if (first == last || first.node_->next == last.node_)
+    return;
+  base_ptr tail = first.node_->next;
+  size_type n = 1;
+  while (tail->next != last.node_)
+  {
+    tail = tail->next;
+    ++n;
+  }
+  splice_nodes(pos.node_, first.node_, tail);
+  if (this != &x)
+  {
+    x.sub(n);
+    this->add(n);
+  }
+}
+
+// 将另一元操作 pred 为 true 的所有元素移除
+template <class T, class Alloc, bool CountSize>
+template <class UnaryPredicate>
+void forward_list<T, Alloc, CountSize>::remove_if(UnaryPredicate pred)
+{
+  base_ptr prev = &head_;
+  while (prev->next != nullptr)
+  {
+    if (pred(static_cast<node_ptr>(prev->next)->value))
+      erase_after(const_iterator(prev));
+    else
+      prev = prev->next;
+  }
+}
+
+// 移除 forward_list 中满足 pred 为 true 的相邻重复元素
+template <class T, class Alloc, bool CountSize>
+template <class BinaryPredicate>
+void forward_list<T, Alloc, CountSize>::unique(BinaryPredicate pred)
+{
+  base_ptr cur = head_.next;
+  if (cur == nullptr)
+    return;
+  while (cur->next != nullptr)
+  {
+    if (pred(static_cast<node_ptr>(cur)->value, static_cast<node_ptr>(cur->next)->value))
+      erase_after(const_iterator(cur));
+    else
+      cur = cur->next;
+  }
+}
+
+// 与另一个 forward_list 合并，按照 comp 为 true 的顺序
+// 比较时抛出异常，x 的节点全部转移到本容器中，元素的顺序不确定
+template <class T, class Alloc, bool CountSize>
+template <class Compare>
+void forward_list<T, Alloc, CountSize>::merge(forward_list& x, Compare comp)
+{
+  if (this == &x)
+    return;
+  MYSTL_DEBUG(this->get_alloc() == x.get_alloc());
+  base_ptr first = head_.next;
+  base_ptr second = x.head_.next;
+  x.head_.next = nullptr;
+  this->add(x.get());
+  x.set(0);
+  merge_chains(head_.next, first, second, comp);
+}
+
+// 将 forward_list 反转
+template <class T, class Alloc, bool CountSize>
+void forward_list<T, Alloc, CountSize>::reverse() noexcept
+{
+  base_ptr prev = nullptr;
+  base_ptr cur = head_.next;
+  while (cur != nullptr)
+  {
+    base_ptr next = cur->next;
+    cur->next = prev;
+    prev = cur;
+    cur = next;
+  }
+  head_.next = prev;
+}
+
+/*****************************************************************************************/
+// helper function
+
+// 创建结点
+template <class T, class Alloc, bool CountSize>
+template <class ...Args>
+typename forward_list<T, Alloc, CountSize>::node_ptr
+forward_list<T, Alloc, CountSize>::create_node(Args&& ...args)
+{
+  node_ptr p = node_alloc_traits::allocate(this->get_alloc(), 1);
+  try
+  {
+    node_alloc_traits::construct(this->get_alloc(), mystl::address_of(p->value),
+                                 mystl::forward<Args>(args)...);
+    p->next = nullptr;
+  }
+  catch (...)
+  {
+    node_alloc_traits::deallocate(this->get_alloc(), p, 1);
+    throw;
+  }
+  return p;
+}
+
+// 销毁结点
+template <class T, class Alloc, bool CountSize>
+void forward_list<T, Alloc, CountSize>::destroy_node(base_ptr p) noexcept
+{
+  node_ptr n = static_cast<node_ptr>(p);
+  node_alloc_traits::destroy(this->get_alloc(), mystl::address_of(n->value));
+  node_alloc_traits::deallocate(this->get_alloc(), n, 1);
+}
+
+// 销毁以 first 开头、以 nullptr 结尾的链
+template <class T, class Alloc, bool CountSize>
+void forward_list<T, Alloc, CountSize>::destroy_chain(base_ptr first) noexcept
+{
+  while (first != nullptr)
+  {
+    base_ptr next = first->next;
+    destroy_node(first);
+    first = next;
+  }
+}
+
+// 用 n 个元素为容器赋值
+template <class T, class Alloc, bool CountSize>
+void forward_list<T, Alloc, CountSize>::fill_assign(size_type n, const value_type& value)
+{
+  base_ptr prev = &head_;
+  for (; n > 0 && prev->next != nullptr; --n, prev = prev->next)
+    static_cast<node_ptr>(prev->next)->value = value;
+  if (n > 0)
+    insert_after(const_iterator(prev), n, value);
+  else
+    erase_after(const_iterator(prev), cend());
+}
+
+// 复制 [first, last) 为容器赋值
+template <class T, class Alloc, bool CountSize>
+template <class Iter>
+void forward_list<T, Alloc, CountSize>::copy_assign(Iter first, Iter last)
+{
+  base_ptr prev = &head_;
+  for (; first != last && prev->next != nullptr; ++first, prev = prev->next)
+    static_cast<node_ptr>(prev->next)->value = *first;
+  if (first == last)
+    erase_after(const_iterator(prev), cend());
+  else
+    insert_after(const_iterator(prev), first, last);
+}
+
+// 对 forward_list 进行非递归的归并排序，做法与 list::sort 相同
+// 用显式的栈模拟按长度对半划分的归并树：每一层只记录待排序的长度与已排好的左半部分，
+// 叶子为一个或两个节点，直接从链上依次取下
+template <class T, class Alloc, bool CountSize>
+template <class Compared>
+void forward_list<T, Alloc, CountSize>::flist_sort(Compared comp)
+{
+  if (head_.next == nullptr || head_.next->next == nullptr)
+    return;
+  base_ptr rest = head_.next;
+  head_.next = nullptr;
+  // 每层至少减半，层数不超过 size_type 的位数加一
+  size_type len[sizeof(size_type) * 8 + 1];
+  base_ptr  left[sizeof(size_type) * 8 + 1] = {};
+  size_type depth = 0;
+  base_ptr cur = nullptr;
+  len[0] = size_holder::counted ? this->get() : count_nodes(rest, nullptr);
+  try
+  {
+    while (true)
+    {
+      while (len[depth] > 2)
+      { // 先处理左半部分
+        len[depth + 1] = len[depth] / 2;
+        ++depth;
+      }
+      cur = rest;
+      rest = rest->next;
+      if (len[depth] == 1)
+      {
+        cur->next = nullptr;
+      }
+      else
+      {
+        base_ptr second = rest;
+        rest = rest->next;
+        second->next = nullptr;
+        cur->next = second;
+        if (comp(static_cast<node_ptr>(second)->value, static_cast<node_ptr>(cur)->value))
+        {
+          second->next = cur;
+          cur->next = nullptr;
+          cur = second;
+        }
+      }
+      while (depth != 0 && left[depth - 1] != nullptr)
+      { // 右半部分已排好，与左半部分合并后继续向上
+        --depth;
+        base_ptr first = left[depth];
+        base_ptr second = cur;
+        left[depth] = cur = nullptr;
+        merge_chains(cur, first, second, comp);
+      }
+      if (depth == 0)
+        break;
+      // 左半部分已排好，转去处理右半部分
+      left[depth - 1] = cur;
+      cur = nullptr;
+      len[depth] = len[depth - 1] - len[depth];
+    }
+  }
+  catch (...)
+  { // 比较时抛出异常，把所有节点连回链表，元素的顺序不确定
+    base_ptr tail = &head_;
+    auto append = [&](base_ptr chain) {
+      tail->next = chain;
+      while (tail->next != nullptr)
+        tail = tail->next;
+    };
+    for (auto chain : left)
+      append(chain);
+    append(cur);
+    append(rest);
+    throw;
+  }
+  head_.next = cur;
+}
+
+// 合并两条以 nullptr 结尾的有序链，结果写入 result；second 中的节点只有严格小于 first 中的节点时才排在前面
+// 比较时抛出异常，result 为所有节点首尾相连的链
+template <class T, class Alloc, bool CountSize>
+template <class Compared>
+void forward_list<T, Alloc, CountSize>::
+merge_chains(base_ptr& result, base_ptr first, base_ptr second, Compared& comp)
+{
+  forward_list_node_base head;
+  base_ptr tail = &head;
+  try
+  {
+    while (first != nullptr && second != nullptr)
+    {
+      if (comp(static_cast<node_ptr>(second)->value, static_cast<node_ptr>(first)->value))
+      {
+        tail->next = second;
+        second = second->next;
+      }
+      else
+      {
+        tail->next = first;
+        first = first->next;
+      }
+      tail = tail->next;
+    }
+  }
+  catch (...)
+  {
+    tail->next = first;
+    while (tail->next != nullptr)
+      tail = tail->next;
+    tail->next = second;
+    result = head.next;
+    throw;
+  }
+  tail->next = first != nullptr ? first : second;
+  result = head.next;
+}
+
+// 配置器随之移动，或者两者总是相等，直接接管 rhs 的节点
+template <class T, class Alloc, bool CountSize>
+void forward_list<T, Alloc, CountSize>::move_assign(forward_list& rhs, m_true_type)
+{
+  clear();
+  mystl::alloc_on_move(this->get_alloc(), rhs.get_alloc());
+  take(rhs);
+}
+
+// 配置器不传播，只有两者相等时才能接管节点，否则逐个移动元素
+template <class T, class Alloc, bool CountSize>
+void forward_list<T, Alloc, CountSize>::move_assign(forward_list& rhs, m_false_type)
+{
+  if (this->get_alloc() == rhs.get_alloc())
+  {
+    move_assign(rhs, m_true_type());
+    return;
+  }
+  clear();
+  auto pos = cbefore_begin();
+  for (auto& value : rhs)
+    pos = emplace_after(pos, mystl::move(value));
+  rhs.clear();
+}
+
+// 重载比较操作符
+template <class T, class Alloc, bool CountSize>
+bool operator==(const forward_list<T, Alloc, CountSize>& lhs,
+                const forward_list<T, Alloc, CountSize>& rhs)
+{
+  auto f1 = lhs.cbegin();
+  auto f2 = rhs.cbegin();
+  auto l1 = lhs.cend();
+  auto l2 = rhs.cend();
+  for (; f1 != l1 && f2 != l2 && *f1 == *f2; ++f1, ++f2)
+    ;
+  return f1 == l1 && f2 == l2;
+}
+
+template <class T, class Alloc, bool CountSize>
+bool operator<(const forward_list<T, Alloc, CountSize>& lhs,
+               const forward_list<T, Alloc, CountSize>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+}
+
+template <class T, class Alloc, bool CountSize>
+bool operator!=(const forward_list<T, Alloc, CountSize>& lhs,
+                const forward_list<T, Alloc, CountSize>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T, class Alloc, bool CountSize>
+bool operator>(const forward_list<T, Alloc, CountSize>& lhs,
+               const forward_list<T, Alloc, CountSize>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T, class Alloc, bool CountSize>
+bool operator<=(const forward_list<T, Alloc, CountSize>& lhs,
+                const forward_list<T, Alloc, CountSize>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T, class Alloc, bool CountSize>
+bool operator>=(const forward_list<T, Alloc, CountSize>& lhs,
+                const forward_list<T, Alloc, CountSize>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, class Alloc, bool CountSize>
+void swap(forward_list<T, Alloc, CountSize>& lhs,
+          forward_list<T, Alloc, CountSize>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+// 头节点在对象内部，但没有节点指向它，配置器可以平凡重定位时容器也可以平凡重定位
+template <class T, class Alloc, bool CountSize>
+struct is_trivially_relocatable<forward_list<T, Alloc, CountSize>>
+  : m_bool_constant<is_trivially_relocatable<Alloc>::value> {};
+
+} // namespace mystl
+#endif // !MYTINYSTL_FORWARD_LIST_H_
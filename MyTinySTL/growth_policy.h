@@ -0,0 +1,57 @@
+#ifndef MYTINYSTL_GROWTH_POLICY_H_
+#define MYTINYSTL_GROWTH_POLICY_H_
+
+// 这个头文件包含一个模板类 growth_policy，决定 vector、basic_string 扩容时的新容量
+//
+// growth_policy<Num, Den, InitCap> : 按 Num / Den 倍增长，第一次分配至少 InitCap 个元素
+// vector_growth                    : vector 缺省的策略，1.5 倍增长，初始容量 16
+// string_growth                    : basic_string 缺省的策略，1.5 倍增长，初始容量 STRING_INIT_SIZE
+// double_growth                    : 2 倍增长，重新分配与搬移的次数更少
+// compact_growth                   : 1.25 倍增长，多余的容量更少，适合内存紧张的场合
+
+// notes:
+//
+// 1. 策略作为容器的模板参数，只需要提供 initial_capacity() 与 next_capacity(old_cap, add, max_cap)，
+//    可以自行定义其他的策略
+// 2. next_capacity 的结果至少为 old_cap + add，不超过 max_cap；容器在调用前已检查 old_cap + add 不超过 max_cap
+// 3. 配置器提供 allocate_at_least 时（如 malloc_allocator），容器把实际得到的空间全部作为容量，容量可能略大于策略给出的值
+
+#include <cstddef>
+
+namespace mystl
+{
+
+// 模板类 : growth_policy
+// 参数一、二代表增长倍数的分子与分母，参数三代表第一次分配的最小容量
+template <size_t Num, size_t Den, size_t InitCap>
+struct growth_policy
+{
+  static_assert(Den != 0 && Num > Den, "growth factor must be greater than 1");
+
+  static constexpr size_t initial_capacity() noexcept
+  { return InitCap; }
+
+  static size_t next_capacity(size_t old_cap, size_t add, size_t max_cap) noexcept
+  {
+    const size_t need = old_cap + add;
+    if (old_cap == 0)
+      return need > InitCap ? need : (InitCap < max_cap ? InitCap : max_cap);
+    // 分两部分计算 old_cap * (Num - Den) / Den，避免溢出
+    const size_t inc = old_cap / Den * (Num - Den) + old_cap % Den * (Num - Den) / Den;
+    const size_t grown = inc > max_cap - old_cap ? max_cap : old_cap + inc;
+    return grown > need ? grown : need;
+  }
+};
+
+// 初始化 basic_string 尝试分配的最小 buffer 大小
+#ifndef STRING_INIT_SIZE
+#define STRING_INIT_SIZE 32
+#endif
+
+typedef growth_policy<3, 2, 16>                vector_growth;
+typedef growth_policy<3, 2, STRING_INIT_SIZE>  string_growth;
+typedef growth_policy<2, 1, 16>                double_growth;
+typedef growth_policy<5, 4, 16>                compact_growth;
+
+} // namespace mystl
+#endif // !MYTINYSTL_GROWTH_POLICY_H_
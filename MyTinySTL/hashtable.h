@@ -9,6 +9,7 @@
 #include "algo.h"
 #include "functional.h"
 #include "memory.h"
+#include "node_pool.h"
 #include "vector.h"
 #include "util.h"
 #include "exceptdef.h"
@@ -101,13 +102,13 @@ struct ht_value_traits
 
 // forward declaration
 
-template <class T, class HashFun, class KeyEqual>
+template <class T, class HashFun, class KeyEqual, class Alloc = mystl::allocator<T>>
 class hashtable;
 
-template <class T, class HashFun, class KeyEqual>
+template <class T, class HashFun, class KeyEqual, class Alloc>
 struct ht_iterator;
 
-template <class T, class HashFun, class KeyEqual>
+template <class T, class HashFun, class KeyEqual, class Alloc>
 struct ht_const_iterator;
 
 template <class T>
@@ -118,13 +119,13 @@ struct ht_const_local_iterator;
 
 // ht_iterator
 
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
 struct ht_iterator_base :public mystl::iterator<mystl::forward_iterator_tag, T>
 {
-  typedef mystl::hashtable<T, Hash, KeyEqual>         hashtable;
-  typedef ht_iterator_base<T, Hash, KeyEqual>         base;
-  typedef mystl::ht_iterator<T, Hash, KeyEqual>       iterator;
-  typedef mystl::ht_const_iterator<T, Hash, KeyEqual> const_iterator;
+  typedef mystl::hashtable<T, Hash, KeyEqual, Alloc>         hashtable;
+  typedef ht_iterator_base<T, Hash, KeyEqual, Alloc>         base;
+  typedef mystl::ht_iterator<T, Hash, KeyEqual, Alloc>       iterator;
+  typedef mystl::ht_const_iterator<T, Hash, KeyEqual, Alloc> const_iterator;
   typedef hashtable_node<T>*                          node_ptr;
   typedef hashtable*                                  contain_ptr;
   typedef const node_ptr                              const_node_ptr;
@@ -142,10 +143,10 @@ struct ht_iterator_base :public mystl::iterator<mystl::forward_iterator_tag, T>
   bool operator!=(const base& rhs) const { return node != rhs.node; }
 };
 
-template <class T, class Hash, class KeyEqual>
-struct ht_iterator :public ht_iterator_base<T, Hash, KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
+struct ht_iterator :public ht_iterator_base<T, Hash, KeyEqual, Alloc>
 {
-  typedef ht_iterator_base<T, Hash, KeyEqual> base;
+  typedef ht_iterator_base<T, Hash, KeyEqual, Alloc> base;
   typedef typename base::hashtable            hashtable;
   typedef typename base::iterator             iterator;
   typedef typename base::const_iterator       const_iterator;
@@ -220,10 +221,10 @@ struct ht_iterator :public ht_iterator_base<T, Hash, KeyEqual>
   }
 };
 
-template <class T, class Hash, class KeyEqual>
-struct ht_const_iterator :public ht_iterator_base<T, Hash, KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
+struct ht_const_iterator :public ht_iterator_base<T, Hash, KeyEqual, Alloc>
 {
-  typedef ht_iterator_base<T, Hash, KeyEqual> base;
+  typedef ht_iterator_base<T, Hash, KeyEqual, Alloc> base;
   typedef typename base::hashtable            hashtable;
   typedef typename base::iterator             iterator;
   typedef typename base::const_iterator       const_iterator;
@@ -468,13 +469,15 @@ inline size_t ht_next_prime(size_t n)
 }
 
 // 模板类 hashtable
-// 参数一代表数据类型，参数二代表哈希函数，参数三代表键值相等的比较函数
-template <class T, class Hash, class KeyEqual>
-class hashtable
+// 参数一代表数据类型，参数二代表哈希函数，参数三代表键值相等的比较函数，参数四代表空间配置器
+// 容器保存的是 rebind 到节点类型的配置器，bucket 数组使用 rebind 到节点指针的配置器
+template <class T, class Hash, class KeyEqual, class Alloc>
+class hashtable : private mystl::alloc_holder<
+  typename mystl::allocator_traits<Alloc>::template rebind_alloc<hashtable_node<T>>>
 {  
 
-  friend struct mystl::ht_iterator<T, Hash, KeyEqual>;
-  friend struct mystl::ht_const_iterator<T, Hash, KeyEqual>;
+  friend struct mystl::ht_iterator<T, Hash, KeyEqual, Alloc>;
+  friend struct mystl::ht_const_iterator<T, Hash, KeyEqual, Alloc>;
 
 public:
   // hashtable 的型别定义
@@ -487,27 +490,32 @@ public:
 
   typedef hashtable_node<T>                           node_type;
   typedef node_type*                                  node_ptr;
-  typedef mystl::vector<node_ptr>                     bucket_type;
 
-  typedef mystl::allocator<T>                         allocator_type;
-  typedef mystl::allocator<T>                         data_allocator;
-  typedef mystl::allocator<node_type>                 node_allocator;
-
-  typedef typename allocator_type::pointer            pointer;
-  typedef typename allocator_type::const_pointer      const_pointer;
-  typedef typename allocator_type::reference          reference;
-  typedef typename allocator_type::const_reference    const_reference;
-  typedef typename allocator_type::size_type          size_type;
-  typedef typename allocator_type::difference_type    difference_type;
+  typedef Alloc                                       allocator_type;
+  typedef typename mystl::allocator_traits<Alloc>::template
+    rebind_alloc<node_type>                           node_allocator;
+  typedef typename mystl::allocator_traits<Alloc>::template
+    rebind_alloc<node_ptr>                            bucket_allocator;
+  typedef mystl::allocator_traits<node_allocator>     node_alloc_traits;
+  typedef mystl::vector<node_ptr, bucket_allocator>   bucket_type;
+
+  typedef T*                                          pointer;
+  typedef const T*                                    const_pointer;
+  typedef T&                                          reference;
+  typedef const T&                                    const_reference;
+  typedef size_t                                      size_type;
+  typedef ptrdiff_t                                   difference_type;
 
-  typedef mystl::ht_iterator<T, Hash, KeyEqual>       iterator;
-  typedef mystl::ht_const_iterator<T, Hash, KeyEqual> const_iterator;
+  typedef mystl::ht_iterator<T, Hash, KeyEqual, Alloc>       iterator;
+  typedef mystl::ht_const_iterator<T, Hash, KeyEqual, Alloc> const_iterator;
   typedef mystl::ht_local_iterator<T>                 local_iterator;
   typedef mystl::ht_const_local_iterator<T>           const_local_iterator;
 
-  allocator_type get_allocator() const { return allocator_type(); }
+  allocator_type get_allocator() const { return allocator_type(this->get_alloc()); }
 
 private:
+  typedef mystl::alloc_holder<node_allocator>         base_holder;
+
   // 用以下六个参数来表现 hashtable
   bucket_type buckets_;
   size_type   bucket_size_;
@@ -516,6 +524,8 @@ private:
   hasher      hash_;
   key_equal   equal_;
 
+  mystl::node_pool<node_type, node_allocator> pool_;  // 节点池
+
 private:
   bool is_equal(const key_type& key1, const key_type& key2)
   {
@@ -556,8 +566,10 @@ public:
   // 构造、复制、移动、析构函数
   explicit hashtable(size_type bucket_count,
                      const Hash& hash = Hash(),
-                     const KeyEqual& equal = KeyEqual())
-    :size_(0), mlf_(1.0f), hash_(hash), equal_(equal)
+                     const KeyEqual& equal = KeyEqual(),
+                     const allocator_type& alloc = allocator_type())
+    :base_holder(node_allocator(alloc)), buckets_(bucket_allocator(alloc)),
+    size_(0), mlf_(1.0f), hash_(hash), equal_(equal)
   {
     init(bucket_count);
   }
@@ -567,32 +579,45 @@ public:
     hashtable(Iter first, Iter last,
               size_type bucket_count,
               const Hash& hash = Hash(),
-              const KeyEqual& equal = KeyEqual())
-    :size_(mystl::distance(first, last)), mlf_(1.0f), hash_(hash), equal_(equal)
+              const KeyEqual& equal = KeyEqual(),
+              const allocator_type& alloc = allocator_type())
+    :base_holder(node_allocator(alloc)), buckets_(bucket_allocator(alloc)),
+    size_(mystl::distance(first, last)), mlf_(1.0f), hash_(hash), equal_(equal)
   {
     init(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))));
   }
 
   hashtable(const hashtable& rhs)
-    :hash_(rhs.hash_), equal_(rhs.equal_)
+    :base_holder(node_alloc_traits::select_on_container_copy_construction(rhs.get_alloc())),
+    buckets_(bucket_allocator(this->get_alloc())),
+    hash_(rhs.hash_), equal_(rhs.equal_)
+  {
+    copy_init(rhs);
+  }
+  hashtable(const hashtable& rhs, const allocator_type& alloc)
+    :base_holder(node_allocator(alloc)), buckets_(bucket_allocator(alloc)),
+    hash_(rhs.hash_), equal_(rhs.equal_)
   {
     copy_init(rhs);
   }
   hashtable(hashtable&& rhs) noexcept
-    : bucket_size_(rhs.bucket_size_), 
+    : base_holder(mystl::move(rhs.get_alloc())),
+    buckets_(mystl::move(rhs.buckets_)),
+    bucket_size_(rhs.bucket_size_), 
     size_(rhs.size_),
     mlf_(rhs.mlf_),
     hash_(rhs.hash_),
-    equal_(rhs.equal_)
+    equal_(rhs.equal_),
+    pool_(mystl::move(rhs.pool_))
   {
-    buckets_ = mystl::move(rhs.buckets_);
     rhs.bucket_size_ = 0;
     rhs.size_ = 0;
     rhs.mlf_ = 0.0f;
   }
+  hashtable(hashtable&& rhs, const allocator_type& alloc);
 
   hashtable& operator=(const hashtable& rhs);
-  hashtable& operator=(hashtable&& rhs) noexcept;
+  hashtable& operator=(hashtable&& rhs) noexcept(alloc_move_steals<node_allocator>::value);
 
   ~hashtable() { clear(); }
 
@@ -616,6 +641,14 @@ public:
   size_type size()     const noexcept { return size_; }
   size_type max_size() const noexcept { return static_cast<size_type>(-1); }
 
+  // 节点池中的全部 slab 与 bucket 数组，节点中的指针和未使用的节点计入 overhead
+  memory_usage_info memory_usage() const noexcept
+  {
+    const size_type payload = size_ * sizeof(T);
+    return memory_usage_info{ payload,
+      pool_.allocated_bytes() - payload + buckets_.memory_usage().total() };
+  }
+
   // 修改容器相关操作
 
   // emplace / empalce_hint
@@ -689,6 +722,10 @@ public:
 
   void      swap(hashtable& rhs) noexcept;
 
+  // 比较两个 hashtable 所含的元素是否相同
+  bool      equal_to_multi(const hashtable& other) const;
+  bool      equal_to_unique(const hashtable& other) const;
+
   // 查找相关操作
 
   size_type                            count(const key_type& key) const;
@@ -803,44 +840,62 @@ private:
   void erase_bucket(size_type n, node_ptr first, node_ptr last);
   void erase_bucket(size_type n, node_ptr last);
 
-  // comparision
-  bool equal_to_multi(const hashtable& other);
-  bool equal_to_unique(const hashtable& other);
+  // move assign
+  void move_assign(hashtable& rhs, m_true_type);
+  void move_assign(hashtable& rhs, m_false_type);
 };
 
 /*****************************************************************************************/
 
+// 使用另一个配置器的移动构造函数，配置器不相等时只能逐个移动元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+hashtable<T, Hash, KeyEqual, Alloc>::
+hashtable(hashtable&& rhs, const allocator_type& alloc)
+  :base_holder(node_allocator(alloc)), buckets_(bucket_allocator(alloc)),
+  bucket_size_(0), size_(0), mlf_(rhs.mlf_), hash_(rhs.hash_), equal_(rhs.equal_)
+{
+  move_assign(rhs, m_false_type());
+}
+
 // 复制赋值运算符
-template <class T, class Hash, class KeyEqual>
-hashtable<T, Hash, KeyEqual>&
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+hashtable<T, Hash, KeyEqual, Alloc>&
+hashtable<T, Hash, KeyEqual, Alloc>::
 operator=(const hashtable& rhs)
 {
   if (this != &rhs)
   {
-    hashtable tmp(rhs);
-    swap(tmp);
+    clear();
+    if (node_alloc_traits::propagate_on_container_copy_assignment::value &&
+        this->get_alloc() != rhs.get_alloc())
+    { // 节点已经用旧的配置器释放，bucket 数组随 vector 的复制赋值一起换掉配置器
+      mystl::alloc_on_copy(this->get_alloc(), rhs.get_alloc());
+      buckets_ = rhs.buckets_;
+    }
+    hash_ = rhs.hash_;
+    equal_ = rhs.equal_;
+    copy_init(rhs);
   }
   return *this;
 }
 
 // 移动赋值运算符
-template <class T, class Hash, class KeyEqual>
-hashtable<T, Hash, KeyEqual>&
-hashtable<T, Hash, KeyEqual>::
-operator=(hashtable&& rhs) noexcept
+template <class T, class Hash, class KeyEqual, class Alloc>
+hashtable<T, Hash, KeyEqual, Alloc>&
+hashtable<T, Hash, KeyEqual, Alloc>::
+operator=(hashtable&& rhs) noexcept(alloc_move_steals<node_allocator>::value)
 {
-  hashtable tmp(mystl::move(rhs));
-  swap(tmp);
+  if (this != &rhs)
+    move_assign(rhs, alloc_move_steals<node_allocator>());
   return *this;
 }
 
 // 就地构造元素，键值允许重复
 // 强异常安全保证
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
 template <class ...Args>
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::
+typename hashtable<T, Hash, KeyEqual, Alloc>::iterator
+hashtable<T, Hash, KeyEqual, Alloc>::
 emplace_multi(Args&& ...args)
 {
   auto np = create_node(mystl::forward<Args>(args)...);
@@ -859,10 +914,10 @@ emplace_multi(Args&& ...args)
 
 // 就地构造元素，键值允许重复
 // 强异常安全保证
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
 template <class ...Args>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool> 
-hashtable<T, Hash, KeyEqual>::
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::iterator, bool> 
+hashtable<T, Hash, KeyEqual, Alloc>::
 emplace_unique(Args&& ...args)
 {
   auto np = create_node(mystl::forward<Args>(args)...);
@@ -876,13 +931,16 @@ emplace_unique(Args&& ...args)
     destroy_node(np);
     throw;
   }
-  return insert_node_unique(np);
+  auto res = insert_node_unique(np);
+  if (!res.second)  // 键值已存在，新节点没有挂到表上
+    destroy_node(np);
+  return res;
 }
 
 // 在不需要重建表格的情况下插入新节点，键值不允许重复
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::iterator, bool>
+hashtable<T, Hash, KeyEqual, Alloc>::
 insert_unique_noresize(const value_type& value)
 {
   const auto n = hash(value_traits::get_key(value));
@@ -901,9 +959,9 @@ insert_unique_noresize(const value_type& value)
 }
 
 // 在不需要重建表格的情况下插入新节点，键值允许重复
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::iterator
+hashtable<T, Hash, KeyEqual, Alloc>::
 insert_multi_noresize(const value_type& value)
 {
   const auto n = hash(value_traits::get_key(value));
@@ -927,8 +985,8 @@ insert_multi_noresize(const value_type& value)
 }
 
 // 删除迭代器所指的节点
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::
 erase(const_iterator position)
 {
   auto p = position.node;
@@ -965,8 +1023,8 @@ erase(const_iterator position)
 }
 
 // 删除[first, last)内的节点
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::
 erase(const_iterator first, const_iterator last)
 {
   if (first.node == last.node)
@@ -997,9 +1055,9 @@ erase(const_iterator first, const_iterator last)
 }
 
 // 删除键值为 key 的节点
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Alloc>::
 erase_multi(const key_type& key)
 {
   auto p = equal_range_multi(key);
@@ -1011,9 +1069,9 @@ erase_multi(const key_type& key)
   return 0;
 }
 
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Alloc>::
 erase_unique(const key_type& key)
 {
   const auto n = hash(key);
@@ -1048,8 +1106,8 @@ erase_unique(const key_type& key)
 }
 
 // 清空 hashtable
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::
 clear()
 {
   if (size_ != 0)
@@ -1067,12 +1125,14 @@ clear()
     }
     size_ = 0;
   }
+  // 节点都已销毁，整个 slab 归还配置器
+  pool_.release(this->get_alloc());
 }
 
 // 在某个 bucket 节点的个数
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Alloc>::
 bucket_size(size_type n) const noexcept
 {
   size_type result = 0;
@@ -1084,8 +1144,8 @@ bucket_size(size_type n) const noexcept
 }
 
 // 重新对元素进行一遍哈希，插入到新的位置
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::
 rehash(size_type count)
 {
   auto n = ht_next_prime(count);
@@ -1104,9 +1164,9 @@ rehash(size_type count)
 }
 
 // 查找键值为 key 的节点，返回其迭代器
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::iterator
+hashtable<T, Hash, KeyEqual, Alloc>::
 find(const key_type& key)
 {
   const auto n = hash(key);
@@ -1115,9 +1175,9 @@ find(const key_type& key)
   return iterator(first, this);
 }
 
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::const_iterator
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::const_iterator
+hashtable<T, Hash, KeyEqual, Alloc>::
 find(const key_type& key) const
 {
   const auto n = hash(key);
@@ -1127,9 +1187,9 @@ find(const key_type& key) const
 }
 
 // 查找键值为 key 出现的次数
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Alloc>::
 count(const key_type& key) const
 {
   const auto n = hash(key);
@@ -1143,10 +1203,10 @@ count(const key_type& key) const
 }
 
 // 查找与键值 key 相等的区间，返回一个 pair，指向相等区间的首尾
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator,
-  typename hashtable<T, Hash, KeyEqual>::iterator>
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::iterator,
+  typename hashtable<T, Hash, KeyEqual, Alloc>::iterator>
+hashtable<T, Hash, KeyEqual, Alloc>::
 equal_range_multi(const key_type& key)
 {
   const auto n = hash(key);
@@ -1170,10 +1230,10 @@ equal_range_multi(const key_type& key)
   return mystl::make_pair(end(), end());
 }
 
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::const_iterator,
-  typename hashtable<T, Hash, KeyEqual>::const_iterator>
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::const_iterator,
+  typename hashtable<T, Hash, KeyEqual, Alloc>::const_iterator>
+hashtable<T, Hash, KeyEqual, Alloc>::
 equal_range_multi(const key_type& key) const
 {
   const auto n = hash(key);
@@ -1197,10 +1257,10 @@ equal_range_multi(const key_type& key) const
   return mystl::make_pair(cend(), cend());
 }
 
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator,
-  typename hashtable<T, Hash, KeyEqual>::iterator>
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::iterator,
+  typename hashtable<T, Hash, KeyEqual, Alloc>::iterator>
+hashtable<T, Hash, KeyEqual, Alloc>::
 equal_range_unique(const key_type& key)
 {
   const auto n = hash(key);
@@ -1221,10 +1281,10 @@ equal_range_unique(const key_type& key)
   return mystl::make_pair(end(), end());
 }
 
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::const_iterator,
-  typename hashtable<T, Hash, KeyEqual>::const_iterator>
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::const_iterator,
+  typename hashtable<T, Hash, KeyEqual, Alloc>::const_iterator>
+hashtable<T, Hash, KeyEqual, Alloc>::
 equal_range_unique(const key_type& key) const
 {
   const auto n = hash(key);
@@ -1246,18 +1306,22 @@ equal_range_unique(const key_type& key) const
 }
 
 // 交换 hashtable
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::
 swap(hashtable& rhs) noexcept
 {
   if (this != &rhs)
   {
+    MYSTL_DEBUG(node_alloc_traits::propagate_on_container_swap::value ||
+                this->get_alloc() == rhs.get_alloc());
+    mystl::alloc_on_swap(this->get_alloc(), rhs.get_alloc());
     buckets_.swap(rhs.buckets_);
     mystl::swap(bucket_size_, rhs.bucket_size_);
     mystl::swap(size_, rhs.size_);
     mystl::swap(mlf_, rhs.mlf_);
     mystl::swap(hash_, rhs.hash_);
     mystl::swap(equal_, rhs.equal_);
+    pool_.swap(rhs.pool_);
   }
 }
 
@@ -1265,8 +1329,8 @@ swap(hashtable& rhs) noexcept
 // helper function
 
 // init 函数
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::
 init(size_type n)
 {
   const auto bucket_nums = next_size(n);
@@ -1285,8 +1349,8 @@ init(size_type n)
 }
 
 // copy_init 函数
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::
 copy_init(const hashtable& ht)
 {
   bucket_size_ = 0;
@@ -1320,64 +1384,64 @@ copy_init(const hashtable& ht)
 }
 
 // create_node 函数
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
 template <class ...Args>
-typename hashtable<T, Hash, KeyEqual>::node_ptr
-hashtable<T, Hash, KeyEqual>::
+typename hashtable<T, Hash, KeyEqual, Alloc>::node_ptr
+hashtable<T, Hash, KeyEqual, Alloc>::
 create_node(Args&& ...args)
 {
-  node_ptr tmp = node_allocator::allocate(1);
+  node_ptr tmp = pool_.allocate(this->get_alloc());
   try
   {
-    data_allocator::construct(mystl::address_of(tmp->value), mystl::forward<Args>(args)...);
+    node_alloc_traits::construct(this->get_alloc(), mystl::address_of(tmp->value),
+                                 mystl::forward<Args>(args)...);
     tmp->next = nullptr;
   }
   catch (...)
   {
-    node_allocator::deallocate(tmp);
+    pool_.deallocate(tmp);
     throw;
   }
   return tmp;
 }
 
 // destroy_node 函数
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::
 destroy_node(node_ptr node)
 {
-  data_allocator::destroy(mystl::address_of(node->value));
-  node_allocator::deallocate(node);
-  node = nullptr;
+  node_alloc_traits::destroy(this->get_alloc(), mystl::address_of(node->value));
+  pool_.deallocate(node);
 }
 
 // next_size 函数
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::next_size(size_type n) const
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Alloc>::next_size(size_type n) const
 {
   return ht_next_prime(n);
 }
 
 // hash 函数
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Alloc>::
 hash(const key_type& key, size_type n) const
 {
   return hash_(key) % n;
 }
 
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Alloc>::
 hash(const key_type& key) const
 {
   return hash_(key) % bucket_size_;
 }
 
 // rehash_if_need 函数
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::
 rehash_if_need(size_type n)
 {
   if (static_cast<float>(size_ + n) > (float)bucket_size_ * max_load_factor())
@@ -1385,9 +1449,9 @@ rehash_if_need(size_type n)
 }
 
 // copy_insert
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
 template <class InputIter>
-void hashtable<T, Hash, KeyEqual>::
+void hashtable<T, Hash, KeyEqual, Alloc>::
 copy_insert_multi(InputIter first, InputIter last, mystl::input_iterator_tag)
 {
   rehash_if_need(mystl::distance(first, last));
@@ -1395,9 +1459,9 @@ copy_insert_multi(InputIter first, InputIter last, mystl::input_iterator_tag)
     insert_multi_noresize(*first);
 }
 
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
 template <class ForwardIter>
-void hashtable<T, Hash, KeyEqual>::
+void hashtable<T, Hash, KeyEqual, Alloc>::
 copy_insert_multi(ForwardIter first, ForwardIter last, mystl::forward_iterator_tag)
 {
   size_type n = mystl::distance(first, last);
@@ -1406,9 +1470,9 @@ copy_insert_multi(ForwardIter first, ForwardIter last, mystl::forward_iterator_t
     insert_multi_noresize(*first);
 }
 
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
 template <class InputIter>
-void hashtable<T, Hash, KeyEqual>::
+void hashtable<T, Hash, KeyEqual, Alloc>::
 copy_insert_unique(InputIter first, InputIter last, mystl::input_iterator_tag)
 {
   rehash_if_need(mystl::distance(first, last));
@@ -1416,9 +1480,9 @@ copy_insert_unique(InputIter first, InputIter last, mystl::input_iterator_tag)
     insert_unique_noresize(*first);
 }
 
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
 template <class ForwardIter>
-void hashtable<T, Hash, KeyEqual>::
+void hashtable<T, Hash, KeyEqual, Alloc>::
 copy_insert_unique(ForwardIter first, ForwardIter last, mystl::forward_iterator_tag)
 {
   size_type n = mystl::distance(first, last);
@@ -1428,9 +1492,9 @@ copy_insert_unique(ForwardIter first, ForwardIter last, mystl::forward_iterator_
 }
 
 // insert_node 函数
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::iterator
+hashtable<T, Hash, KeyEqual, Alloc>::
 insert_node_multi(node_ptr np)
 {
   const auto n = hash(value_traits::get_key(np->value));
@@ -1458,9 +1522,9 @@ insert_node_multi(node_ptr np)
 }
 
 // insert_node_unique 函数
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
-hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::iterator, bool>
+hashtable<T, Hash, KeyEqual, Alloc>::
 insert_node_unique(node_ptr np)
 {
   const auto n = hash(value_traits::get_key(np->value));
@@ -1485,24 +1549,26 @@ insert_node_unique(node_ptr np)
 }
 
 // replace_bucket 函数
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+// 把所有节点重新挂到新的 bucket 数组上，节点本身不需要重新分配
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::
 replace_bucket(size_type bucket_count)
 {
-  bucket_type bucket(bucket_count);
+  bucket_type bucket(bucket_count, nullptr, buckets_.get_allocator());
   if (size_ != 0)
   {
     for (size_type i = 0; i < bucket_size_; ++i)
     {
-      for (auto first = buckets_[i]; first; first = first->next)
+      for (auto first = buckets_[i]; first; )
       {
-        auto tmp = create_node(first->value);
-        const auto n = hash(value_traits::get_key(first->value), bucket_count);
+        auto tmp = first;
+        first = first->next;
+        const auto n = hash(value_traits::get_key(tmp->value), bucket_count);
         auto f = bucket[n];
         bool is_inserted = false;
         for (auto cur = f; cur; cur = cur->next)
         {
-          if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(first->value)))
+          if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(tmp->value)))
           {
             tmp->next = cur->next;
             cur->next = tmp;
@@ -1516,6 +1582,7 @@ replace_bucket(size_type bucket_count)
           bucket[n] = tmp;
         }
       }
+      buckets_[i] = nullptr;
     }
   }
   buckets_.swap(bucket);
@@ -1524,8 +1591,8 @@ replace_bucket(size_type bucket_count)
 
 // erase_bucket 函数
 // 在第 n 个 bucket 内，删除 [first, last) 的节点
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::
 erase_bucket(size_type n, node_ptr first, node_ptr last)
 {
   auto cur = buckets_[n];
@@ -1549,8 +1616,8 @@ erase_bucket(size_type n, node_ptr first, node_ptr last)
 
 // erase_bucket 函数
 // 在第 n 个 bucket 内，删除 [buckets_[n], last) 的节点
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::
 erase_bucket(size_type n, node_ptr last)
 {
   auto cur = buckets_[n];
@@ -1565,8 +1632,8 @@ erase_bucket(size_type n, node_ptr last)
 }
 
 // equal_to 函数
-template <class T, class Hash, class KeyEqual>
-bool hashtable<T, Hash, KeyEqual>::equal_to_multi(const hashtable& other)
+template <class T, class Hash, class KeyEqual, class Alloc>
+bool hashtable<T, Hash, KeyEqual, Alloc>::equal_to_multi(const hashtable& other) const
 {
   if (size_ != other.size_)
     return false;
@@ -1574,16 +1641,16 @@ bool hashtable<T, Hash, KeyEqual>::equal_to_multi(const hashtable& other)
   {
     auto p1 = equal_range_multi(value_traits::get_key(*f));
     auto p2 = other.equal_range_multi(value_traits::get_key(*f));
-    if (mystl::distance(p1.first, p1.last) != mystl::distance(p2.first, p2.last) ||
-        !mystl::is_permutation(p1.first, p2.last, p2.first, p2.last))
+    if (mystl::distance(p1.first, p1.second) != mystl::distance(p2.first, p2.second) ||
+        !mystl::is_permutation(p1.first, p1.second, p2.first, p2.second))
       return false;
-    f = p1.last;
+    f = p1.second;
   }
   return true;
 }
 
-template <class T, class Hash, class KeyEqual>
-bool hashtable<T, Hash, KeyEqual>::equal_to_unique(const hashtable& other)
+template <class T, class Hash, class KeyEqual, class Alloc>
+bool hashtable<T, Hash, KeyEqual, Alloc>::equal_to_unique(const hashtable& other) const
 {
   if (size_ != other.size_)
     return false;
@@ -1596,14 +1663,64 @@ bool hashtable<T, Hash, KeyEqual>::equal_to_unique(const hashtable& other)
   return true;
 }
 
+// move_assign 函数，可以直接接管 rhs 的节点和 bucket 数组
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::
+move_assign(hashtable& rhs, m_true_type)
+{
+  clear();
+  mystl::alloc_on_move(this->get_alloc(), rhs.get_alloc());
+  buckets_ = mystl::move(rhs.buckets_);
+  bucket_size_ = rhs.bucket_size_;
+  size_ = rhs.size_;
+  mlf_ = rhs.mlf_;
+  hash_ = rhs.hash_;
+  equal_ = rhs.equal_;
+  pool_.swap(rhs.pool_);
+  rhs.bucket_size_ = 0;
+  rhs.size_ = 0;
+  rhs.mlf_ = 0.0f;
+}
+
+// move_assign 函数，配置器不传播时，只有两者相等才能接管节点，否则逐个移动元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::
+move_assign(hashtable& rhs, m_false_type)
+{
+  if (this->get_alloc() == rhs.get_alloc())
+  {
+    move_assign(rhs, m_true_type());
+  }
+  else
+  {
+    clear();
+    hash_ = rhs.hash_;
+    equal_ = rhs.equal_;
+    mlf_ = rhs.mlf_;
+    if (bucket_size_ == 0)
+      init(rhs.bucket_size_);
+    rehash_if_need(rhs.size_);
+    for (auto it = rhs.begin(); it != rhs.end(); ++it)
+      insert_node_multi(create_node(mystl::move(*it)));
+    rhs.clear();
+  }
+}
+
 // 重载 mystl 的 swap
-template <class T, class Hash, class KeyEqual>
-void swap(hashtable<T, Hash, KeyEqual>& lhs,
-          hashtable<T, Hash, KeyEqual>& rhs) noexcept
+template <class T, class Hash, class KeyEqual, class Alloc>
+void swap(hashtable<T, Hash, KeyEqual, Alloc>& lhs,
+          hashtable<T, Hash, KeyEqual, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
 
+// bucket 数组与节点都在堆上，节点不会指向 hashtable 对象本身，Hash、KeyEqual、Alloc 可以平凡重定位时容器也可以平凡重定位
+template <class T, class Hash, class KeyEqual, class Alloc>
+struct is_trivially_relocatable<hashtable<T, Hash, KeyEqual, Alloc>>
+  : m_bool_constant<is_trivially_relocatable<Hash>::value &&
+    is_trivially_relocatable<KeyEqual>::value &&
+    is_trivially_relocatable<Alloc>::value> {};
+
 } // namespace mystl
 #endif // !MYTINYSTL_HASHTABLE_H_
 
@@ -2,6 +2,7 @@
 #define MYTINYSTL_HEAP_ALGO_H_
 
 // 这个头文件包含 heap 的四个算法 : push_heap, pop_heap, sort_heap, make_heap
+// 取出的元素都先复制为 value_type，迭代器返回代理引用（如 soa_vector）时也不会被后续的赋值改写
 
 #include "iterator.h"
 
@@ -29,7 +30,8 @@ void push_heap_aux(RandomIter first, Distance holeIndex, Distance topIndex, T va
 template <class RandomIter, class Distance>
 void push_heap_d(RandomIter first, RandomIter last, Distance*)
 {
-  mystl::push_heap_aux(first, (last - first) - 1, static_cast<Distance>(0), *(last - 1));
+  mystl::push_heap_aux(first, (last - first) - 1, static_cast<Distance>(0),
+                       typename iterator_traits<RandomIter>::value_type(*(last - 1)));
 }
 
 template <class RandomIter>
@@ -57,7 +59,7 @@ template <class RandomIter, class Compared, class Distance>
 void push_heap_d(RandomIter first, RandomIter last, Distance*, Compared comp)
 {
   mystl::push_heap_aux(first, (last - first) - 1, static_cast<Distance>(0),
-                       *(last - 1), comp);
+                       typename iterator_traits<RandomIter>::value_type(*(last - 1)), comp);
 }
 
 template <class RandomIter, class Compared>
@@ -105,7 +107,8 @@ void pop_heap_aux(RandomIter first, RandomIter last, RandomIter result, T value,
 template <class RandomIter>
 void pop_heap(RandomIter first, RandomIter last)
 {
-  mystl::pop_heap_aux(first, last - 1, last - 1, *(last - 1), distance_type(first));
+  mystl::pop_heap_aux(first, last - 1, last - 1,
+                      typename iterator_traits<RandomIter>::value_type(*(last - 1)), distance_type(first));
 }
 
 // 重载版本使用函数对象 comp 代替比较操作
@@ -143,8 +146,8 @@ void pop_heap_aux(RandomIter first, RandomIter last, RandomIter result,
 template <class RandomIter, class Compared>
 void pop_heap(RandomIter first, RandomIter last, Compared comp)
 {
-  mystl::pop_heap_aux(first, last - 1, last - 1, *(last - 1),
-                      distance_type(first), comp);
+  mystl::pop_heap_aux(first, last - 1, last - 1,
+                      typename iterator_traits<RandomIter>::value_type(*(last - 1)), distance_type(first), comp);
 }
 
 /*****************************************************************************************/
@@ -185,7 +188,8 @@ void make_heap_aux(RandomIter first, RandomIter last, Distance*)
   while (true)
   {
     // 重排以 holeIndex 为首的子树
-    mystl::adjust_heap(first, holeIndex, len, *(first + holeIndex));
+    mystl::adjust_heap(first, holeIndex, len,
+                       typename iterator_traits<RandomIter>::value_type(*(first + holeIndex)));
     if (holeIndex == 0)
       return;
     holeIndex--;
@@ -209,7 +213,8 @@ void make_heap_aux(RandomIter first, RandomIter last, Distance*, Compared comp)
   while (true)
   {
     // 重排以 holeIndex 为首的子树
-    mystl::adjust_heap(first, holeIndex, len, *(first + holeIndex), comp);
+    mystl::adjust_heap(first, holeIndex, len,
+                       typename iterator_traits<RandomIter>::value_type(*(first + holeIndex)), comp);
     if (holeIndex == 0)
       return;
     holeIndex--;
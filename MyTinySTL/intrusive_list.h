@@ -0,0 +1,430 @@
+#ifndef MYTINYSTL_INTRUSIVE_LIST_H_
+#define MYTINYSTL_INTRUSIVE_LIST_H_
+
+// 这个头文件包含一个模板类 intrusive_list
+// intrusive_list : 侵入式双向链表，连接用的指针保存在元素对象自身的 hook 中，容器不复制也不分配任何东西
+
+// notes:
+//
+// 1. 元素类型以 intrusive_list_hook<Tag> 为基类，Tag 用来区分同一个对象上的多个 hook，
+//    一个对象有几个不同 Tag 的 hook，就可以同时放进几个 intrusive_list<T, Tag>
+// 2. 容器只保存元素的地址，元素的生命期由使用者管理：对象在容器中时不能销毁或移动，
+//    erase、clear 以及容器析构只把元素取下，不会销毁元素
+// 3. 连接与断开节点使用 list.h 中的 list_link_nodes 与 list_unlink_nodes
+// 4. 由元素得到迭代器的 iterator_to 为 O(1)，可以直接删除已知的元素，不需要先查找
+// 5. 哨兵节点保存在容器对象内部，移动容器时修正首尾元素的指针，容器不能平凡重定位
+//
+// 异常保证：
+// mystl::intrusive_list<T> 的所有操作都不抛出异常
+
+#include "iterator.h"
+#include "list.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "algobase.h"
+
+namespace mystl
+{
+
+// intrusive_list 的节点结构，只有前后两个指针
+
+struct intrusive_list_node
+{
+  intrusive_list_node* prev;  // 前一节点
+  intrusive_list_node* next;  // 下一节点
+};
+
+// 模板类: intrusive_list_hook
+// 元素以它为基类，Tag 区分同一个对象上的多个 hook
+// 复制对象时不复制连接状态，新对象不在任何链表中
+template <class Tag = void>
+struct intrusive_list_hook : public intrusive_list_node
+{
+  intrusive_list_hook() noexcept
+  { prev = next = nullptr; }
+
+  intrusive_list_hook(const intrusive_list_hook&) noexcept
+  { prev = next = nullptr; }
+
+  intrusive_list_hook& operator=(const intrusive_list_hook&) noexcept
+  { return *this; }
+
+  ~intrusive_list_hook()
+  { MYSTL_DEBUG(!is_linked()); }
+
+  // 是否在某个链表中
+  bool is_linked() const noexcept
+  { return next != nullptr; }
+};
+
+// intrusive_list 的迭代器设计
+template <class T, class Tag, class Ref, class Ptr>
+struct intrusive_list_iterator : public iterator<bidirectional_iterator_tag, T>
+{
+  typedef intrusive_list_iterator<T, Tag, T&, T*>             iterator;
+  typedef intrusive_list_iterator<T, Tag, const T&, const T*> const_iterator;
+  typedef intrusive_list_iterator                             self;
+
+  typedef T                     value_type;
+  typedef Ptr                   pointer;
+  typedef Ref                   reference;
+  typedef ptrdiff_t             difference_type;
+  typedef intrusive_list_node*  node_ptr;
+  typedef intrusive_list_hook<Tag> hook_type;
+
+  node_ptr node_;  // 指向当前节点
+
+  // 构造、复制函数
+  intrusive_list_iterator() noexcept
+    :node_(nullptr) {}
+  explicit intrusive_list_iterator(node_ptr x) noexcept
+    :node_(x) {}
+  intrusive_list_iterator(const iterator& rhs) noexcept
+    :node_(rhs.node_) {}
+
+  self& operator=(const self& rhs) = default;
+
+  // 重载操作符
+  reference operator*()  const
+  { return *static_cast<T*>(static_cast<hook_type*>(node_)); }
+  pointer   operator->() const { return &(operator*()); }
+
+  self& operator++()
+  {
+    MYSTL_DEBUG(node_ != nullptr);
+    node_ = node_->next;
+    return *this;
+  }
+  self operator++(int)
+  {
+    self tmp = *this;
+    ++*this;
+    return tmp;
+  }
+  self& operator--()
+  {
+    MYSTL_DEBUG(node_ != nullptr);
+    node_ = node_->prev;
+    return *this;
+  }
+  self operator--(int)
+  {
+    self tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  // 重载比较操作符
+  bool operator==(const self& rhs) const { return node_ == rhs.node_; }
+  bool operator!=(const self& rhs) const { return node_ != rhs.node_; }
+};
+
+// 模板类: intrusive_list
+// 模板参数 T 代表元素类型，须以 intrusive_list_hook<Tag> 为基类，Tag 代表使用哪一个 hook
+template <class T, class Tag = void>
+class intrusive_list
+{
+public:
+  // intrusive_list 的嵌套型别定义
+  typedef T                                        value_type;
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  typedef intrusive_list_iterator<T, Tag, T&, T*>             iterator;
+  typedef intrusive_list_iterator<T, Tag, const T&, const T*> const_iterator;
+  typedef mystl::reverse_iterator<iterator>                   reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>             const_reverse_iterator;
+
+  typedef intrusive_list_hook<Tag>                 hook_type;
+  typedef intrusive_list_node*                     node_ptr;
+
+private:
+  intrusive_list_node head_;  // 哨兵节点
+  size_type           size_;  // 大小
+
+public:
+  // 构造、移动、析构函数，元素不属于容器，容器不能复制
+  intrusive_list() noexcept
+  { reset(); }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  intrusive_list(Iter first, Iter last) noexcept
+  {
+    reset();
+    insert(end(), first, last);
+  }
+
+  intrusive_list(const intrusive_list&) = delete;
+  intrusive_list& operator=(const intrusive_list&) = delete;
+
+  intrusive_list(intrusive_list&& rhs) noexcept
+  {
+    reset();
+    take(rhs);
+  }
+
+  intrusive_list& operator=(intrusive_list&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      clear();
+      take(rhs);
+    }
+    return *this;
+  }
+
+  ~intrusive_list()
+  { clear(); }
+
+public:
+  // 迭代器相关操作
+  iterator               begin()         noexcept
+  { return iterator(head_.next); }
+  const_iterator         begin()   const noexcept
+  { return const_iterator(head_.next); }
+  iterator               end()           noexcept
+  { return iterator(&head_); }
+  const_iterator         end()     const noexcept
+  { return const_iterator(const_cast<node_ptr>(&head_)); }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 由元素得到指向它的迭代器，元素须在本容器中
+  iterator               iterator_to(reference value) noexcept
+  { return iterator(node_of(value)); }
+  const_iterator         iterator_to(const_reference value) const noexcept
+  { return const_iterator(node_of(const_cast<reference>(value))); }
+
+  // 容量相关操作
+  bool      empty()    const noexcept
+  { return size_ == 0; }
+
+  size_type size()     const noexcept
+  { return size_; }
+
+  size_type max_size() const noexcept
+  { return static_cast<size_type>(-1); }
+
+  // 访问元素相关操作
+  reference       front()
+  {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+
+  const_reference front() const
+  {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+
+  reference       back()
+  {
+    MYSTL_DEBUG(!empty());
+    return *iterator(head_.prev);
+  }
+
+  const_reference back()  const
+  {
+    MYSTL_DEBUG(!empty());
+    return *const_iterator(head_.prev);
+  }
+
+  // 调整容器相关操作
+
+  // insert / push_front / push_back，元素不能已经在某个同一 Tag 的链表中
+
+  iterator insert(const_iterator pos, reference value) noexcept
+  {
+    node_ptr n = node_of(value);
+    MYSTL_DEBUG(!static_cast<hook_type*>(n)->is_linked());
+    list_link_nodes(pos.node_, n, n);
+    ++size_;
+    return iterator(n);
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void     insert(const_iterator pos, Iter first, Iter last) noexcept
+  {
+    for (; first != last; ++first)
+      insert(pos, *first);
+  }
+
+  void     push_front(reference value) noexcept
+  { insert(cbegin(), value); }
+
+  void     push_back(reference value) noexcept
+  { insert(cend(), value); }
+
+  // pop_front / pop_back / erase / clear，取下的元素不会被销毁
+
+  void     pop_front() noexcept
+  {
+    MYSTL_DEBUG(!empty());
+    erase(cbegin());
+  }
+
+  void     pop_back() noexcept
+  {
+    MYSTL_DEBUG(!empty());
+    erase(const_iterator(head_.prev));
+  }
+
+  iterator erase(const_iterator pos) noexcept
+  {
+    MYSTL_DEBUG(pos != cend());
+    node_ptr n = pos.node_;
+    node_ptr next = n->next;
+    list_unlink_nodes(n, n);
+    n->prev = n->next = nullptr;
+    --size_;
+    return iterator(next);
+  }
+
+  iterator erase(const_iterator first, const_iterator last) noexcept
+  {
+    while (first != last)
+      first = erase(first);
+    return iterator(last.node_);
+  }
+
+  void     clear() noexcept
+  {
+    node_ptr n = head_.next;
+    while (n != &head_)
+    {
+      node_ptr next = n->next;
+      n->prev = n->next = nullptr;
+      n = next;
+    }
+    reset();
+  }
+
+  void     swap(intrusive_list& rhs) noexcept
+  {
+    intrusive_list tmp(mystl::move(rhs));
+    rhs.take(*this);
+    take(tmp);
+  }
+
+  // intrusive_list 相关操作
+
+  // 把 other 的全部元素接合于 pos 之前
+  void splice(const_iterator pos, intrusive_list& other) noexcept
+  {
+    MYSTL_DEBUG(this != &other);
+    if (other.empty())
+      return;
+    node_ptr f = other.head_.next;
+    node_ptr l = other.head_.prev;
+    list_unlink_nodes(f, l);
+    list_link_nodes(pos.node_, f, l);
+    size_ += other.size_;
+    other.size_ = 0;
+  }
+
+  // 把 other 中 it 所指的元素接合于 pos 之前
+  void splice(const_iterator pos, intrusive_list& other, const_iterator it) noexcept
+  {
+    node_ptr n = it.node_;
+    if (pos.node_ == n || pos.node_ == n->next)
+      return;
+    list_unlink_nodes(n, n);
+    list_link_nodes(pos.node_, n, n);
+    --other.size_;
+    ++size_;
+  }
+
+  template <class UnaryPredicate>
+  void remove_if(UnaryPredicate pred)
+  {
+    for (auto it = begin(); it != end();)
+    {
+      if (pred(*it))
+        it = erase(it);
+      else
+        ++it;
+    }
+  }
+
+  void reverse() noexcept
+  {
+    node_ptr n = &head_;
+    do
+    {
+      mystl::swap(n->prev, n->next);
+      n = n->prev;
+    } while (n != &head_);
+  }
+
+private:
+  // helper functions
+
+  static node_ptr node_of(reference value) noexcept
+  { return static_cast<hook_type*>(mystl::address_of(value)); }
+
+  void reset() noexcept
+  {
+    head_.prev = head_.next = &head_;
+    size_ = 0;
+  }
+
+  // 接管 rhs 的所有元素，本容器须为空
+  void take(intrusive_list& rhs) noexcept
+  {
+    if (rhs.empty())
+      return;
+    head_ = rhs.head_;
+    head_.next->prev = &head_;
+    head_.prev->next = &head_;
+    size_ = rhs.size_;
+    rhs.reset();
+  }
+};
+
+/*****************************************************************************************/
+
+// 重载比较操作符
+template <class T, class Tag>
+bool operator==(const intrusive_list<T, Tag>& lhs, const intrusive_list<T, Tag>& rhs)
+{
+  return lhs.size() == rhs.size() && mystl::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin());
+}
+
+template <class T, class Tag>
+bool operator!=(const intrusive_list<T, Tag>& lhs, const intrusive_list<T, Tag>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, class Tag>
+void swap(intrusive_list<T, Tag>& lhs, intrusive_list<T, Tag>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_INTRUSIVE_LIST_H_
@@ -0,0 +1,109 @@
+#ifndef MYTINYSTL_INTRUSIVE_MAP_H_
+#define MYTINYSTL_INTRUSIVE_MAP_H_
+
+// 这个头文件包含两个模板类 intrusive_map 和 intrusive_multimap
+// intrusive_map      : 侵入式映射，键保存在元素对象中，由 KeyOfValue 取出，键值不允许重复
+// intrusive_multimap : 侵入式映射，键保存在元素对象中，由 KeyOfValue 取出，键值允许重复
+
+// notes:
+//
+// 1. 元素类型以 intrusive_tree_hook<Tag> 为基类，插入时不分配任何东西，容器只保存元素的地址
+// 2. KeyOfValue 须返回 const Key&，元素在容器中时不能修改它的键，其余部分可以通过迭代器修改
+// 3. 元素由使用者构造，所以没有 operator[]，查找使用 find / lower_bound / equal_range
+//
+// 异常保证：
+// 只有 Compare 与 KeyOfValue 可能抛出异常，insert 做强异常安全保证
+
+#include "intrusive_rb_tree.h"
+
+namespace mystl
+{
+
+// 模板类 intrusive_map，键值不允许重复
+// 参数一代表键值类型，参数二代表元素类型，参数三从元素中取出键，
+// 参数四代表使用哪一个 hook，参数五代表键值比较方式，缺省使用 mystl::less
+template <class Key, class T, class KeyOfValue, class Tag = void,
+          class Compare = mystl::less<Key>>
+class intrusive_map : public intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>
+{
+  typedef intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag> base_type;
+
+public:
+  typedef T                             mapped_type;
+  typedef typename base_type::iterator  iterator;
+  typedef typename base_type::reference reference;
+
+public:
+  intrusive_map() = default;
+
+  explicit intrusive_map(const Compare& comp)
+    :base_type(comp)
+  {
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  intrusive_map(Iter first, Iter last)
+  { insert(first, last); }
+
+  intrusive_map(intrusive_map&&) = default;
+  intrusive_map& operator=(intrusive_map&&) = default;
+
+  // 插入元素，已有相同的键时不插入，返回指向已有元素的迭代器与 false
+  mystl::pair<iterator, bool> insert(reference value)
+  { return this->insert_unique(value); }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void insert(Iter first, Iter last)
+  {
+    for (; first != last; ++first)
+      insert(*first);
+  }
+};
+
+// 模板类 intrusive_multimap，键值允许重复
+// 参数一代表键值类型，参数二代表元素类型，参数三从元素中取出键，
+// 参数四代表使用哪一个 hook，参数五代表键值比较方式，缺省使用 mystl::less
+template <class Key, class T, class KeyOfValue, class Tag = void,
+          class Compare = mystl::less<Key>>
+class intrusive_multimap : public intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>
+{
+  typedef intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag> base_type;
+
+public:
+  typedef T                             mapped_type;
+  typedef typename base_type::iterator  iterator;
+  typedef typename base_type::reference reference;
+
+public:
+  intrusive_multimap() = default;
+
+  explicit intrusive_multimap(const Compare& comp)
+    :base_type(comp)
+  {
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  intrusive_multimap(Iter first, Iter last)
+  { insert(first, last); }
+
+  intrusive_multimap(intrusive_multimap&&) = default;
+  intrusive_multimap& operator=(intrusive_multimap&&) = default;
+
+  // 插入元素，相同键值的元素按插入的先后排列
+  iterator insert(reference value)
+  { return this->insert_multi(value); }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void insert(Iter first, Iter last)
+  {
+    for (; first != last; ++first)
+      insert(*first);
+  }
+};
+
+} // namespace mystl
+#endif // !MYTINYSTL_INTRUSIVE_MAP_H_
@@ -0,0 +1,589 @@
+#ifndef MYTINYSTL_INTRUSIVE_RB_TREE_H_
+#define MYTINYSTL_INTRUSIVE_RB_TREE_H_
+
+// 这个头文件包含一个模板类 intrusive_rb_tree
+// intrusive_rb_tree : 侵入式红黑树，intrusive_set、intrusive_map 的底层机制
+
+// notes:
+//
+// 1. 元素类型以 intrusive_tree_hook<Tag> 为基类，hook 中保存父、左、右指针与颜色，
+//    插入时不分配任何东西；一个对象有几个不同 Tag 的 hook，就可以同时放进几棵树
+// 2. 树的形状与 rb_tree 相同：header 与根节点互为对方的父节点，header 的左右指向最小、最大节点，
+//    重新平衡直接使用 rb_tree.h 中的 rb_tree_insert_rebalance 与 rb_tree_erase_rebalance
+// 3. 键由 KeyOfValue 从元素中取出，元素在树中时不能修改键，也不能销毁或移动元素
+// 4. erase、clear 以及容器析构只把元素取下，不会销毁元素
+//
+// 异常保证：
+// 只有 Compare 可能抛出异常，插入时比较抛出异常容器不变
+
+#include "algobase.h"
+#include "functional.h"
+#include "iterator.h"
+#include "rb_tree.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// intrusive_rb_tree 的节点结构，成员与 rb_tree_node_base 相同
+
+struct intrusive_tree_node
+{
+  intrusive_tree_node* parent;  // 父节点
+  intrusive_tree_node* left;    // 左子节点
+  intrusive_tree_node* right;   // 右子节点
+  rb_tree_color_type   color;   // 节点颜色
+};
+
+// 模板类: intrusive_tree_hook
+// 元素以它为基类，Tag 区分同一个对象上的多个 hook
+// 复制对象时不复制连接状态，新对象不在任何树中
+template <class Tag = void>
+struct intrusive_tree_hook : public intrusive_tree_node
+{
+  intrusive_tree_hook() noexcept
+  { unlink(); }
+
+  intrusive_tree_hook(const intrusive_tree_hook&) noexcept
+  { unlink(); }
+
+  intrusive_tree_hook& operator=(const intrusive_tree_hook&) noexcept
+  { return *this; }
+
+  ~intrusive_tree_hook()
+  { MYSTL_DEBUG(!is_linked()); }
+
+  // 是否在某棵树中
+  bool is_linked() const noexcept
+  { return parent != nullptr; }
+
+  void unlink() noexcept
+  {
+    parent = left = right = nullptr;
+    color = rb_tree_red;
+  }
+};
+
+// intrusive_rb_tree 的迭代器设计，前进与后退的方式与 rb_tree_iterator_base 相同
+template <class T, class Tag, class Ref, class Ptr>
+struct intrusive_tree_iterator : public iterator<bidirectional_iterator_tag, T>
+{
+  typedef intrusive_tree_iterator<T, Tag, T&, T*>             iterator;
+  typedef intrusive_tree_iterator<T, Tag, const T&, const T*> const_iterator;
+  typedef intrusive_tree_iterator                             self;
+
+  typedef T                        value_type;
+  typedef Ptr                      pointer;
+  typedef Ref                      reference;
+  typedef ptrdiff_t                difference_type;
+  typedef intrusive_tree_node*     node_ptr;
+  typedef intrusive_tree_hook<Tag> hook_type;
+
+  node_ptr node_;  // 指向节点本身
+
+  // 构造、复制函数
+  intrusive_tree_iterator() noexcept
+    :node_(nullptr) {}
+  explicit intrusive_tree_iterator(node_ptr x) noexcept
+    :node_(x) {}
+  intrusive_tree_iterator(const iterator& rhs) noexcept
+    :node_(rhs.node_) {}
+
+  self& operator=(const self& rhs) = default;
+
+  // 重载操作符
+  reference operator*()  const
+  { return *static_cast<T*>(static_cast<hook_type*>(node_)); }
+  pointer   operator->() const { return &(operator*()); }
+
+  self& operator++()
+  {
+    if (node_->right != nullptr)
+    {
+      node_ = rb_tree_min(node_->right);
+    }
+    else
+    { // 如果没有右子节点
+      auto y = node_->parent;
+      while (y->right == node_)
+      {
+        node_ = y;
+        y = y->parent;
+      }
+      if (node_->right != y)  // 应对“寻找根节点的下一节点，而根节点没有右子节点”的特殊情况
+        node_ = y;
+    }
+    return *this;
+  }
+  self operator++(int)
+  {
+    self tmp = *this;
+    ++*this;
+    return tmp;
+  }
+  self& operator--()
+  {
+    if (node_->parent->parent == node_ && rb_tree_is_red(node_))
+    { // 如果 node_ 为 header
+      node_ = node_->right;
+    }
+    else if (node_->left != nullptr)
+    {
+      node_ = rb_tree_max(node_->left);
+    }
+    else
+    { // 非 header 节点，也无左子节点
+      auto y = node_->parent;
+      while (node_ == y->left)
+      {
+        node_ = y;
+        y = y->parent;
+      }
+      node_ = y;
+    }
+    return *this;
+  }
+  self operator--(int)
+  {
+    self tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  // 重载比较操作符
+  bool operator==(const self& rhs) const { return node_ == rhs.node_; }
+  bool operator!=(const self& rhs) const { return node_ != rhs.node_; }
+};
+
+// 模板类: intrusive_rb_tree
+// 参数一代表键值类型，参数二代表元素类型，参数三从元素中取出键，参数四代表键值比较方式，参数五代表使用哪一个 hook
+template <class Key, class T, class KeyOfValue, class Compare, class Tag>
+class intrusive_rb_tree
+{
+public:
+  // intrusive_rb_tree 的嵌套型别定义
+  typedef Key                                      key_type;
+  typedef T                                        value_type;
+  typedef Compare                                  key_compare;
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  typedef intrusive_tree_iterator<T, Tag, T&, T*>             iterator;
+  typedef intrusive_tree_iterator<T, Tag, const T&, const T*> const_iterator;
+  typedef mystl::reverse_iterator<iterator>                   reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>             const_reverse_iterator;
+
+  typedef intrusive_tree_hook<Tag>                 hook_type;
+  typedef intrusive_tree_node*                     node_ptr;
+
+private:
+  intrusive_tree_node header_;     // 特殊节点，与根节点互为对方的父节点
+  size_type           node_count_; // 节点数
+  key_compare         key_comp_;   // 节点键值比较的准则
+
+  node_ptr& root()      noexcept { return header_.parent; }
+  node_ptr& leftmost()  noexcept { return header_.left; }
+  node_ptr& rightmost() noexcept { return header_.right; }
+
+public:
+  // 构造、移动、析构函数，元素不属于容器，容器不能复制
+  intrusive_rb_tree()
+    :key_comp_()
+  { reset(); }
+
+  explicit intrusive_rb_tree(const key_compare& comp)
+    :key_comp_(comp)
+  { reset(); }
+
+  intrusive_rb_tree(const intrusive_rb_tree&) = delete;
+  intrusive_rb_tree& operator=(const intrusive_rb_tree&) = delete;
+
+  intrusive_rb_tree(intrusive_rb_tree&& rhs) noexcept
+    :key_comp_(mystl::move(rhs.key_comp_))
+  {
+    reset();
+    take(rhs);
+  }
+
+  intrusive_rb_tree& operator=(intrusive_rb_tree&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      clear();
+      key_comp_ = mystl::move(rhs.key_comp_);
+      take(rhs);
+    }
+    return *this;
+  }
+
+  ~intrusive_rb_tree()
+  { clear(); }
+
+public:
+  // 迭代器相关操作
+  iterator               begin()         noexcept
+  { return iterator(header_.left); }
+  const_iterator         begin()   const noexcept
+  { return const_iterator(header_.left); }
+  iterator               end()           noexcept
+  { return iterator(&header_); }
+  const_iterator         end()     const noexcept
+  { return const_iterator(const_cast<node_ptr>(&header_)); }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 由元素得到指向它的迭代器，元素须在本容器中
+  iterator               iterator_to(reference value) noexcept
+  { return iterator(node_of(value)); }
+  const_iterator         iterator_to(const_reference value) const noexcept
+  { return const_iterator(node_of(const_cast<reference>(value))); }
+
+  // 容量相关操作
+  bool      empty()    const noexcept { return node_count_ == 0; }
+  size_type size()     const noexcept { return node_count_; }
+  size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+  key_compare key_comp() const { return key_comp_; }
+
+  // erase / clear，取下的元素不会被销毁
+
+  iterator  erase(const_iterator pos) noexcept;
+  size_type erase(const key_type& key);
+  iterator  erase(const_iterator first, const_iterator last) noexcept;
+
+  void      clear() noexcept;
+
+  // 查找相关操作
+
+  iterator       find(const key_type& key)
+  { return iterator(find_node(key)); }
+  const_iterator find(const key_type& key) const
+  { return const_iterator(find_node(key)); }
+
+  size_type      count(const key_type& key) const
+  {
+    auto p = equal_range(key);
+    return static_cast<size_type>(mystl::distance(p.first, p.second));
+  }
+
+  iterator       lower_bound(const key_type& key)
+  { return iterator(lower_bound_node(key)); }
+  const_iterator lower_bound(const key_type& key) const
+  { return const_iterator(lower_bound_node(key)); }
+
+  iterator       upper_bound(const key_type& key)
+  { return iterator(upper_bound_node(key)); }
+  const_iterator upper_bound(const key_type& key) const
+  { return const_iterator(upper_bound_node(key)); }
+
+  mystl::pair<iterator, iterator>
+  equal_range(const key_type& key)
+  { return mystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key)); }
+  mystl::pair<const_iterator, const_iterator>
+  equal_range(const key_type& key) const
+  { return mystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key)); }
+
+  void swap(intrusive_rb_tree& rhs) noexcept
+  {
+    intrusive_rb_tree tmp(mystl::move(rhs));
+    rhs = mystl::move(*this);
+    *this = mystl::move(tmp);
+  }
+
+protected:
+  // 插入元素，键值允许重复
+  iterator                        insert_multi(reference value);
+  // 插入元素，键值不允许重复，已有相同的键时返回指向它的迭代器与 false
+  mystl::pair<iterator, bool>     insert_unique(reference value);
+
+private:
+  // helper functions
+
+  static node_ptr node_of(reference value) noexcept
+  { return static_cast<hook_type*>(mystl::address_of(value)); }
+
+  static const key_type& key_of(node_ptr x)
+  { return KeyOfValue()(*static_cast<T*>(static_cast<hook_type*>(x))); }
+
+  void      reset() noexcept
+  {
+    header_.color = rb_tree_red;  // header_ 节点颜色为红，与 root 区分
+    header_.parent = nullptr;
+    header_.left = header_.right = &header_;
+    node_count_ = 0;
+  }
+
+  // 接管 rhs 的所有节点，本容器须为空
+  void      take(intrusive_rb_tree& rhs) noexcept;
+
+  // 在 x 节点处连接节点 z，add_to_left 表示是否连接在左边
+  iterator  link_at(node_ptr x, node_ptr z, bool add_to_left) noexcept;
+
+  // 把以 x 为根的子树中的节点全部取下
+  static void unlink_subtree(node_ptr x) noexcept;
+
+  node_ptr  find_node(const key_type& key) const;
+  node_ptr  lower_bound_node(const key_type& key) const;
+  node_ptr  upper_bound_node(const key_type& key) const;
+};
+
+/*****************************************************************************************/
+
+// 删除 pos 位置的元素
+template <class Key, class T, class KeyOfValue, class Compare, class Tag>
+typename intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::iterator
+intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::
+erase(const_iterator pos) noexcept
+{
+  MYSTL_DEBUG(pos != cend());
+  node_ptr z = pos.node_;
+  iterator next(z);
+  ++next;
+  rb_tree_erase_rebalance(z, root(), leftmost(), rightmost());
+  static_cast<hook_type*>(z)->unlink();
+  --node_count_;
+  return next;
+}
+
+// 删除键值等于 key 的元素，返回删除的个数
+template <class Key, class T, class KeyOfValue, class Compare, class Tag>
+typename intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::size_type
+intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::
+erase(const key_type& key)
+{
+  auto p = equal_range(key);
+  size_type n = static_cast<size_type>(mystl::distance(p.first, p.second));
+  erase(p.first, p.second);
+  return n;
+}
+
+// 删除 [first, last) 区间内的元素
+template <class Key, class T, class KeyOfValue, class Compare, class Tag>
+typename intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::iterator
+intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::
+erase(const_iterator first, const_iterator last) noexcept
+{
+  if (first == cbegin() && last == cend())
+  {
+    clear();
+    return end();
+  }
+  while (first != last)
+    first = erase(first);
+  return iterator(last.node_);
+}
+
+// 清空 intrusive_rb_tree
+template <class Key, class T, class KeyOfValue, class Compare, class Tag>
+void intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::clear() noexcept
+{
+  if (node_count_ != 0)
+    unlink_subtree(root());
+  reset();
+}
+
+// 插入元素，键值允许重复，相同键值的元素按插入的先后排列
+template <class Key, class T, class KeyOfValue, class Compare, class Tag>
+typename intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::iterator
+intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::
+insert_multi(reference value)
+{
+  node_ptr z = node_of(value);
+  MYSTL_DEBUG(!static_cast<hook_type*>(z)->is_linked());
+  const key_type& key = KeyOfValue()(value);
+  node_ptr x = root();
+  node_ptr y = &header_;
+  bool add_to_left = true;
+  while (x != nullptr)
+  {
+    y = x;
+    add_to_left = key_comp_(key, key_of(x));
+    x = add_to_left ? x->left : x->right;
+  }
+  return link_at(y, z, add_to_left);
+}
+
+// 插入元素，键值不允许重复
+template <class Key, class T, class KeyOfValue, class Compare, class Tag>
+mystl::pair<typename intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::iterator, bool>
+intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::
+insert_unique(reference value)
+{
+  node_ptr z = node_of(value);
+  MYSTL_DEBUG(!static_cast<hook_type*>(z)->is_linked());
+  const key_type& key = KeyOfValue()(value);
+  node_ptr x = root();
+  node_ptr y = &header_;
+  bool add_to_left = true;  // 树为空时也在 header_ 左边插入
+  while (x != nullptr)
+  {
+    y = x;
+    add_to_left = key_comp_(key, key_of(x));
+    x = add_to_left ? x->left : x->right;
+  }
+  iterator j(y);  // 此时 y 为插入点的父节点
+  if (add_to_left)
+  {
+    if (y == &header_ || y == leftmost())
+      return mystl::make_pair(link_at(y, z, true), true);
+    --j;  // 如果存在重复节点，那么 --j 就是重复的值
+  }
+  if (key_comp_(key_of(j.node_), key))
+    return mystl::make_pair(link_at(y, z, add_to_left), true);
+  return mystl::make_pair(j, false);
+}
+
+/*****************************************************************************************/
+// helper function
+
+template <class Key, class T, class KeyOfValue, class Compare, class Tag>
+void intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::
+take(intrusive_rb_tree& rhs) noexcept
+{
+  if (rhs.node_count_ == 0)
+    return;
+  header_.parent = rhs.header_.parent;
+  header_.left = rhs.header_.left;
+  header_.right = rhs.header_.right;
+  header_.parent->parent = &header_;
+  node_count_ = rhs.node_count_;
+  rhs.reset();
+}
+
+template <class Key, class T, class KeyOfValue, class Compare, class Tag>
+typename intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::iterator
+intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::
+link_at(node_ptr x, node_ptr z, bool add_to_left) noexcept
+{
+  z->parent = x;
+  z->left = z->right = nullptr;
+  if (x == &header_)
+  {
+    root() = z;
+    leftmost() = z;
+    rightmost() = z;
+  }
+  else if (add_to_left)
+  {
+    x->left = z;
+    if (leftmost() == x)
+      leftmost() = z;
+  }
+  else
+  {
+    x->right = z;
+    if (rightmost() == x)
+      rightmost() = z;
+  }
+  rb_tree_insert_rebalance(z, root());
+  ++node_count_;
+  return iterator(z);
+}
+
+// 右子树递归处理，左子树循环处理，递归深度不超过树高
+template <class Key, class T, class KeyOfValue, class Compare, class Tag>
+void intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::
+unlink_subtree(node_ptr x) noexcept
+{
+  while (x != nullptr)
+  {
+    unlink_subtree(x->right);
+    auto y = x->left;
+    static_cast<hook_type*>(x)->unlink();
+    x = y;
+  }
+}
+
+template <class Key, class T, class KeyOfValue, class Compare, class Tag>
+typename intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::node_ptr
+intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::
+find_node(const key_type& key) const
+{
+  node_ptr j = lower_bound_node(key);
+  return (j == &header_ || key_comp_(key, key_of(j))) ? const_cast<node_ptr>(&header_) : j;
+}
+
+// 最后一个不小于 key 的节点
+template <class Key, class T, class KeyOfValue, class Compare, class Tag>
+typename intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::node_ptr
+intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::
+lower_bound_node(const key_type& key) const
+{
+  node_ptr x = header_.parent;
+  node_ptr y = const_cast<node_ptr>(&header_);
+  while (x != nullptr)
+  {
+    if (!key_comp_(key_of(x), key))
+    { // key <= x
+      y = x;
+      x = x->left;
+    }
+    else
+    {
+      x = x->right;
+    }
+  }
+  return y;
+}
+
+// 第一个大于 key 的节点
+template <class Key, class T, class KeyOfValue, class Compare, class Tag>
+typename intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::node_ptr
+intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>::
+upper_bound_node(const key_type& key) const
+{
+  node_ptr x = header_.parent;
+  node_ptr y = const_cast<node_ptr>(&header_);
+  while (x != nullptr)
+  {
+    if (key_comp_(key, key_of(x)))
+    { // key < x
+      y = x;
+      x = x->left;
+    }
+    else
+    {
+      x = x->right;
+    }
+  }
+  return y;
+}
+
+// 重载比较操作符
+template <class Key, class T, class KeyOfValue, class Compare, class Tag>
+bool operator==(const intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>& lhs,
+                const intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>& rhs)
+{
+  return lhs.size() == rhs.size() && mystl::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin());
+}
+
+template <class Key, class T, class KeyOfValue, class Compare, class Tag>
+bool operator!=(const intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>& lhs,
+                const intrusive_rb_tree<Key, T, KeyOfValue, Compare, Tag>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_INTRUSIVE_RB_TREE_H_
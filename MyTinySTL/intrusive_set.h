@@ -0,0 +1,108 @@
+#ifndef MYTINYSTL_INTRUSIVE_SET_H_
+#define MYTINYSTL_INTRUSIVE_SET_H_
+
+// 这个头文件包含两个模板类 intrusive_set 和 intrusive_multiset
+// intrusive_set      : 侵入式集合，元素即键值，键值不允许重复
+// intrusive_multiset : 侵入式集合，元素即键值，键值允许重复
+
+// notes:
+//
+// 1. 元素类型以 intrusive_tree_hook<Tag> 为基类，插入时不分配任何东西，容器只保存元素的地址
+// 2. 迭代器可以修改元素，但不能修改参与比较的部分
+//
+// 异常保证：
+// 只有 Compare 可能抛出异常，insert 做强异常安全保证
+
+#include "intrusive_rb_tree.h"
+
+namespace mystl
+{
+
+// 模板类 intrusive_set，键值不允许重复
+// 参数一代表元素类型，参数二代表使用哪一个 hook，参数三代表键值比较方式，缺省使用 mystl::less
+template <class T, class Tag = void, class Compare = mystl::less<T>>
+class intrusive_set : public intrusive_rb_tree<T, T, mystl::identity<T>, Compare, Tag>
+{
+  typedef intrusive_rb_tree<T, T, mystl::identity<T>, Compare, Tag> base_type;
+
+public:
+  typedef typename base_type::iterator  iterator;
+  typedef typename base_type::reference reference;
+  typedef Compare                       value_compare;
+
+public:
+  intrusive_set() = default;
+
+  explicit intrusive_set(const Compare& comp)
+    :base_type(comp)
+  {
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  intrusive_set(Iter first, Iter last)
+  { insert(first, last); }
+
+  intrusive_set(intrusive_set&&) = default;
+  intrusive_set& operator=(intrusive_set&&) = default;
+
+  value_compare value_comp() const { return this->key_comp(); }
+
+  // 插入元素，已有相同的键时不插入，返回指向已有元素的迭代器与 false
+  mystl::pair<iterator, bool> insert(reference value)
+  { return this->insert_unique(value); }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void insert(Iter first, Iter last)
+  {
+    for (; first != last; ++first)
+      insert(*first);
+  }
+};
+
+// 模板类 intrusive_multiset，键值允许重复
+// 参数一代表元素类型，参数二代表使用哪一个 hook，参数三代表键值比较方式，缺省使用 mystl::less
+template <class T, class Tag = void, class Compare = mystl::less<T>>
+class intrusive_multiset : public intrusive_rb_tree<T, T, mystl::identity<T>, Compare, Tag>
+{
+  typedef intrusive_rb_tree<T, T, mystl::identity<T>, Compare, Tag> base_type;
+
+public:
+  typedef typename base_type::iterator  iterator;
+  typedef typename base_type::reference reference;
+  typedef Compare                       value_compare;
+
+public:
+  intrusive_multiset() = default;
+
+  explicit intrusive_multiset(const Compare& comp)
+    :base_type(comp)
+  {
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  intrusive_multiset(Iter first, Iter last)
+  { insert(first, last); }
+
+  intrusive_multiset(intrusive_multiset&&) = default;
+  intrusive_multiset& operator=(intrusive_multiset&&) = default;
+
+  value_compare value_comp() const { return this->key_comp(); }
+
+  // 插入元素，相同键值的元素按插入的先后排列
+  iterator insert(reference value)
+  { return this->insert_multi(value); }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void insert(Iter first, Iter last)
+  {
+    for (; first != last; ++first)
+      insert(*first);
+  }
+};
+
+} // namespace mystl
+#endif // !MYTINYSTL_INTRUSIVE_SET_H_
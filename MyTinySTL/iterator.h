@@ -125,6 +125,25 @@ struct is_iterator :
 {
 };
 
+// 萃取分段迭代器：底层由若干段连续内存组成的容器（如 deque），其迭代器每次前进都要检查是否越过段的边界，
+// 为它提供特化版本后，copy / move / fill / find / for_each 等算法会逐段在原生指针上执行
+// 特化版本需要提供：
+//   segment_iterator / local_iterator : 段的迭代器与段内的迭代器
+//   segment(it) / local(it)            : 迭代器所在的段与段内位置
+//   begin(seg) / end(seg)              : 段的头尾
+//   compose(seg, local)                : 由段与段内位置还原出迭代器
+template <class Iterator>
+struct segmented_iterator_traits
+{
+  typedef m_false_type is_segmented_iterator;
+};
+
+template <class Iterator>
+struct is_segmented_iterator :
+  public segmented_iterator_traits<Iterator>::is_segmented_iterator
+{
+};
+
 // 萃取某个迭代器的 category
 template <class Iterator>
 typename iterator_traits<Iterator>::iterator_category
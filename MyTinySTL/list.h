@@ -6,6 +6,10 @@
 
 // notes:
 //
+// 1. 节点取自 counted_node_pool 的 slab，每个节点记录所在的 slab，slab 在最后一个节点归还时才释放，
+//    因此 splice 在两个容器之间直接转移节点，不需要移动元素，指向被接合元素的迭代器依然有效，两个容器的配置器必须相等
+// 2. 删除的节点挂在容器自己的自由链表上供之后的插入复用，clear 或析构时才归还
+//
 // 异常保证：
 // mystl::list<T> 满足基本异常保证，部分函数无异常保证，并对以下等函数做强异常安全保证：
 //   * emplace_front
@@ -19,6 +23,7 @@
 
 #include "iterator.h"
 #include "memory.h"
+#include "node_pool.h"
 #include "functional.h"
 #include "util.h"
 #include "exceptdef.h"
@@ -71,7 +76,8 @@ struct list_node : public list_node_base<T>
   typedef typename node_traits<T>::base_ptr base_ptr;
   typedef typename node_traits<T>::node_ptr node_ptr;
 
-  T value;  // 数据域
+  void* chunk;  // 所在的 slab，由节点池设置
+  T     value;  // 数据域
 
   list_node() = default;
   list_node(const T& v)
@@ -93,6 +99,26 @@ struct list_node : public list_node_base<T>
   }
 };
 
+// 双向链表的连接与断开，NodePtr 指向含有 prev、next 的节点，intrusive_list 也使用这两个函数
+
+// 在 pos 之前连接 [first, last] 的节点，这些节点已经依次相连
+template <class NodePtr>
+void list_link_nodes(NodePtr pos, NodePtr first, NodePtr last) noexcept
+{
+  pos->prev->next = first;
+  first->prev = pos->prev;
+  pos->prev = last;
+  last->next = pos;
+}
+
+// 把 [first, last] 的节点从所在的链表中断开，它们之间的连接保持不变
+template <class NodePtr>
+void list_unlink_nodes(NodePtr first, NodePtr last) noexcept
+{
+  first->prev->next = last->next;
+  last->next->prev = first->prev;
+}
+
 // list 的迭代器设计
 template <class T>
 struct list_iterator : public mystl::iterator<mystl::bidirectional_iterator_tag, T>
@@ -205,24 +231,29 @@ struct list_const_iterator : public iterator<bidirectional_iterator_tag, T>
 };
 
 // 模板类: list
-// 模板参数 T 代表数据类型
-template <class T>
-class list
+// 模板参数 T 代表数据类型，Alloc 代表空间配置器，缺省使用 mystl::allocator
+// 容器保存的是 rebind 到节点类型的配置器
+template <class T, class Alloc = mystl::allocator<T>>
+class list : private mystl::alloc_holder<
+  typename mystl::allocator_traits<Alloc>::template rebind_alloc<list_node<T>>>
 {
 public:
   // list 的嵌套型别定义
-  typedef mystl::allocator<T>                      allocator_type;
-  typedef mystl::allocator<T>                      data_allocator;
-  typedef mystl::allocator<list_node_base<T>>      base_allocator;
-  typedef mystl::allocator<list_node<T>>           node_allocator;
-
-  typedef typename allocator_type::value_type      value_type;
-  typedef typename allocator_type::pointer         pointer;
-  typedef typename allocator_type::const_pointer   const_pointer;
-  typedef typename allocator_type::reference       reference;
-  typedef typename allocator_type::const_reference const_reference;
-  typedef typename allocator_type::size_type       size_type;
-  typedef typename allocator_type::difference_type difference_type;
+  typedef Alloc                                    allocator_type;
+  typedef typename mystl::allocator_traits<Alloc>::template
+    rebind_alloc<list_node_base<T>>                base_allocator;
+  typedef typename mystl::allocator_traits<Alloc>::template
+    rebind_alloc<list_node<T>>                     node_allocator;
+  typedef mystl::allocator_traits<base_allocator>  base_alloc_traits;
+  typedef mystl::allocator_traits<node_allocator>  node_alloc_traits;
+
+  typedef T                                        value_type;
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
 
   typedef list_iterator<T>                         iterator;
   typedef list_const_iterator<T>                   const_iterator;
@@ -232,60 +263,108 @@ public:
   typedef typename node_traits<T>::base_ptr        base_ptr;
   typedef typename node_traits<T>::node_ptr        node_ptr;
 
-  allocator_type get_allocator() { return node_allocator(); }
+  allocator_type get_allocator() const { return allocator_type(this->get_alloc()); }
 
 private:
+  typedef mystl::alloc_holder<node_allocator>      base_holder;
+
   base_ptr  node_;  // 指向末尾节点
   size_type size_;  // 大小
+  mystl::counted_node_pool<list_node<T>, node_allocator> pool_;  // 节点池
 
 public:
   // 构造、复制、移动、析构函数
+  // 空的 list 只需要哨兵节点，不要求 T 可以默认构造或复制
   list() 
-  { fill_init(0, value_type()); }
+    :node_(create_sentinel()), size_(0)
+  {
+  }
+
+  explicit list(const allocator_type& alloc)
+    :base_holder(node_allocator(alloc)), node_(create_sentinel()), size_(0)
+  {
+  }
 
-  explicit list(size_type n) 
+  explicit list(size_type n, const allocator_type& alloc = allocator_type())
+    :base_holder(node_allocator(alloc))
   { fill_init(n, value_type()); }
 
-  list(size_type n, const T& value)
+  list(size_type n, const T& value, const allocator_type& alloc = allocator_type())
+    :base_holder(node_allocator(alloc))
   { fill_init(n, value); }
 
   template <class Iter, typename std::enable_if<
     mystl::is_input_iterator<Iter>::value, int>::type = 0>
-  list(Iter first, Iter last)
+  list(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+    :base_holder(node_allocator(alloc))
   { copy_init(first, last); }
 
-  list(std::initializer_list<T> ilist)
+  list(std::initializer_list<T> ilist, const allocator_type& alloc = allocator_type())
+    :base_holder(node_allocator(alloc))
   { copy_init(ilist.begin(), ilist.end()); }
 
   list(const list& rhs)
+    :base_holder(node_alloc_traits::select_on_container_copy_construction(rhs.get_alloc()))
+  { copy_init(rhs.cbegin(), rhs.cend()); }
+
+  list(const list& rhs, const allocator_type& alloc)
+    :base_holder(node_allocator(alloc))
   { copy_init(rhs.cbegin(), rhs.cend()); }
 
   list(list&& rhs) noexcept
-    :node_(rhs.node_), size_(rhs.size_)
+    :base_holder(mystl::move(rhs.get_alloc())), node_(rhs.node_), size_(rhs.size_),
+    pool_(mystl::move(rhs.pool_))
   {
     rhs.node_ = nullptr;
     rhs.size_ = 0;
   }
 
+  list(list&& rhs, const allocator_type& alloc)
+    :base_holder(node_allocator(alloc))
+  {
+    if (this->get_alloc() == rhs.get_alloc())
+    {
+      node_ = rhs.node_;
+      size_ = rhs.size_;
+      pool_.swap(rhs.pool_);
+      rhs.node_ = nullptr;
+      rhs.size_ = 0;
+    }
+    else
+    {
+      fill_init(0, value_type());
+      for (auto& value : rhs)
+        emplace_back(mystl::move(value));
+    }
+  }
+
   list& operator=(const list& rhs)
   {
     if (this != &rhs)
     {
+      if (node_alloc_traits::propagate_on_container_copy_assignment::value &&
+          this->get_alloc() != rhs.get_alloc())
+      { // 配置器要随之复制，旧节点必须先用旧的配置器释放
+        clear();
+        destroy_sentinel();
+        mystl::alloc_on_copy(this->get_alloc(), rhs.get_alloc());
+        node_ = create_sentinel();
+      }
       assign(rhs.begin(), rhs.end());
     }
     return *this;
   }
 
-  list& operator=(list&& rhs) noexcept
+  list& operator=(list&& rhs) noexcept(alloc_move_steals<node_allocator>::value)
   {
-    clear();
-    splice(end(), rhs);
+    if (this != &rhs)
+      move_assign(rhs, alloc_move_steals<node_allocator>());
     return *this;
   }
 
   list& operator=(std::initializer_list<T> ilist)
   {
-    list tmp(ilist.begin(), ilist.end());
+    list tmp(ilist.begin(), ilist.end(), get_allocator());
     swap(tmp);
     return *this;
   }
@@ -295,7 +374,7 @@ public:
     if (node_)
     {
       clear();
-      base_allocator::deallocate(node_);
+      destroy_sentinel();
       node_ = nullptr;
       size_ = 0;
     }
@@ -340,6 +419,16 @@ public:
   size_type max_size() const noexcept 
   { return static_cast<size_type>(-1); }
 
+  // 全部节点、池中空闲的节点、slab 头部与哨兵节点，节点中的指针和空闲的节点计入 overhead
+  // 与其他 list 共享的 slab，头部计入申请它的 list
+  memory_usage_info memory_usage() const noexcept
+  {
+    const size_type payload = size_ * sizeof(T);
+    const size_type sentinel = node_ == nullptr ? 0 : sizeof(*node_);
+    const size_type nodes = (size_ + pool_.idle_count()) * sizeof(list_node<T>);
+    return memory_usage_info{ payload, nodes + pool_.header_bytes() + sentinel - payload };
+  }
+
   // 访问元素相关操作
   reference       front() 
   { 
@@ -505,8 +594,12 @@ public:
 
   void     swap(list& rhs) noexcept
   {
+    MYSTL_DEBUG(node_alloc_traits::propagate_on_container_swap::value ||
+                this->get_alloc() == rhs.get_alloc());
+    mystl::alloc_on_swap(this->get_alloc(), rhs.get_alloc());
     mystl::swap(node_, rhs.node_);
     mystl::swap(size_, rhs.size_);
+    pool_.swap(rhs.pool_);
   }
 
   // list 相关操作
@@ -531,10 +624,10 @@ public:
   void merge(list& x, Compare comp);
 
   void sort()
-  { list_sort(begin(), end(), size(), mystl::less<T>()); }
+  { list_sort(mystl::less<T>()); }
   template <class Compared>
   void sort(Compared comp)
-  { list_sort(begin(), end(), size(), comp); }
+  { list_sort(comp); }
 
   void reverse();
 
@@ -545,6 +638,8 @@ private:
   template <class ...Args>
   node_ptr create_node(Args&& ...agrs);
   void     destroy_node(node_ptr p);
+  base_ptr create_sentinel();
+  void     destroy_sentinel();
 
   // initialize
   void      fill_init(size_type n, const value_type& value);
@@ -567,19 +662,28 @@ private:
   iterator  fill_insert(const_iterator pos, size_type n, const value_type& value);
   template <class Iter>
   iterator  copy_insert(const_iterator pos, size_type n, Iter first);
+  template <class Construct>
+  iterator  insert_run(const_iterator pos, size_type n, Construct construct);
 
   // sort
   template <class Compared>
-  iterator  list_sort(iterator first, iterator last, size_type n, Compared comp);
+  void      list_sort(Compared comp);
+  template <class Compared>
+  static void merge_chains(base_ptr& result, base_ptr first, base_ptr second, Compared& comp);
+  static base_ptr concat_chains(base_ptr first, base_ptr second) noexcept;
+  void      relink_chain(base_ptr head) noexcept;
 
+  // move assign
+  void      move_assign(list& rhs, m_true_type);
+  void      move_assign(list& rhs, m_false_type);
 };
 
 /*****************************************************************************************/
 
 // 删除 pos 处的元素
-template <class T>
-typename list<T>::iterator 
-list<T>::erase(const_iterator pos)
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator 
+list<T, Alloc>::erase(const_iterator pos)
 {
   MYSTL_DEBUG(pos != cend());
   auto n = pos.node_;
@@ -591,9 +695,9 @@ list<T>::erase(const_iterator pos)
 }
 
 // 删除 [first, last) 内的元素
-template <class T>
-typename list<T>::iterator 
-list<T>::erase(const_iterator first, const_iterator last)
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator 
+list<T, Alloc>::erase(const_iterator first, const_iterator last)
 {
   if (first != last)
   {
@@ -610,8 +714,8 @@ list<T>::erase(const_iterator first, const_iterator last)
 }
 
 // 清空 list
-template <class T>
-void list<T>::clear()
+template <class T, class Alloc>
+void list<T, Alloc>::clear()
 {
   if (size_ != 0)
   {
@@ -623,11 +727,13 @@ void list<T>::clear()
     node_->unlink();
     size_ = 0;
   }
+  // 归还空闲的节点，不再有节点的 slab 交还配置器
+  pool_.release(this->get_alloc());
 }
 
 // 重置容器大小
-template <class T>
-void list<T>::resize(size_type new_size, const value_type& value)
+template <class T, class Alloc>
+void list<T, Alloc>::resize(size_type new_size, const value_type& value)
 {
   auto i = begin();
   size_type len = 0;
@@ -647,8 +753,8 @@ void list<T>::resize(size_type new_size, const value_type& value)
 }
 
 // 将 list x 接合于 pos 之前
-template <class T>
-void list<T>::splice(const_iterator pos, list& x)
+template <class T, class Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list& x)
 {
   MYSTL_DEBUG(this != &x);
   if (!x.empty())
@@ -667,8 +773,8 @@ void list<T>::splice(const_iterator pos, list& x)
 }
 
 // 将 it 所指的节点接合于 pos 之前
-template <class T>
-void list<T>::splice(const_iterator pos, list& x, const_iterator it)
+template <class T, class Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list& x, const_iterator it)
 {
   if (pos.node_ != it.node_ && pos.node_ != it.node_->next)
   {
@@ -685,8 +791,8 @@ void list<T>::splice(const_iterator pos, list& x, const_iterator it)
 }
 
 // 将 list x 的 [first, last) 内的节点接合于 pos 之前
-template <class T>
-void list<T>::splice(const_iterator pos, list& x, const_iterator first, const_iterator last)
+template <class T, class Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list& x, const_iterator first, const_iterator last)
 {
   if (first != last && this != &x)
   {
@@ -704,9 +810,9 @@ void list<T>::splice(const_iterator pos, list& x, const_iterator first, const_it
 }
 
 // 将另一元操作 pred 为 true 的所有元素移除
-template <class T>
+template <class T, class Alloc>
 template <class UnaryPredicate>
-void list<T>::remove_if(UnaryPredicate pred)
+void list<T, Alloc>::remove_if(UnaryPredicate pred)
 {
   auto f = begin();
   auto l = end();
@@ -721,9 +827,9 @@ void list<T>::remove_if(UnaryPredicate pred)
 }
 
 // 移除 list 中满足 pred 为 true 重复元素
-template <class T>
+template <class T, class Alloc>
 template <class BinaryPredicate>
-void list<T>::unique(BinaryPredicate pred)
+void list<T, Alloc>::unique(BinaryPredicate pred)
 {
   auto i = begin();
   auto e = end();
@@ -745,9 +851,9 @@ void list<T>::unique(BinaryPredicate pred)
 }
 
 // 与另一个 list 合并，按照 comp 为 true 的顺序
-template <class T>
+template <class T, class Alloc>
 template <class Compare>
-void list<T>::merge(list& x, Compare comp)
+void list<T, Alloc>::merge(list& x, Compare comp)
 {
   if (this != &x)
   {
@@ -796,8 +902,8 @@ void list<T>::merge(list& x, Compare comp)
 }
 
 // 将 list 反转
-template <class T>
-void list<T>::reverse()
+template <class T, class Alloc>
+void list<T, Alloc>::reverse()
 {
   if (size_ <= 1)
   {
@@ -817,88 +923,97 @@ void list<T>::reverse()
 // helper function
 
 // 创建结点
-template <class T>
+template <class T, class Alloc>
 template <class ...Args>
-typename list<T>::node_ptr 
-list<T>::create_node(Args&& ...args)
+typename list<T, Alloc>::node_ptr 
+list<T, Alloc>::create_node(Args&& ...args)
 {
-  node_ptr p = node_allocator::allocate(1);
+  node_ptr p = pool_.allocate(this->get_alloc());
   try
   {
-    data_allocator::construct(mystl::address_of(p->value), mystl::forward<Args>(args)...);
+    node_alloc_traits::construct(this->get_alloc(), mystl::address_of(p->value),
+                                 mystl::forward<Args>(args)...);
     p->prev = nullptr;
     p->next = nullptr;
   }
   catch (...)
   {
-    node_allocator::deallocate(p);
+    pool_.deallocate(p);
     throw;
   }
   return p;
 }
 
 // 销毁结点
-template <class T>
-void list<T>::destroy_node(node_ptr p)
+template <class T, class Alloc>
+void list<T, Alloc>::destroy_node(node_ptr p)
 {
-  data_allocator::destroy(mystl::address_of(p->value));
-  node_allocator::deallocate(p);
+  node_alloc_traits::destroy(this->get_alloc(), mystl::address_of(p->value));
+  pool_.deallocate(p);
+}
+
+// 创建哨兵节点
+template <class T, class Alloc>
+typename list<T, Alloc>::base_ptr
+list<T, Alloc>::create_sentinel()
+{
+  base_allocator alloc(this->get_alloc());
+  base_ptr p = base_alloc_traits::allocate(alloc, 1);
+  p->unlink();
+  return p;
+}
+
+// 销毁哨兵节点
+template <class T, class Alloc>
+void list<T, Alloc>::destroy_sentinel()
+{
+  base_allocator alloc(this->get_alloc());
+  base_alloc_traits::deallocate(alloc, node_, 1);
 }
 
 // 用 n 个元素初始化容器
-template <class T>
-void list<T>::fill_init(size_type n, const value_type& value)
+template <class T, class Alloc>
+void list<T, Alloc>::fill_init(size_type n, const value_type& value)
 {
-  node_ = base_allocator::allocate(1);
-  node_->unlink();
-  size_ = n;
+  node_ = create_sentinel();
+  size_ = 0;
   try
   {
-    for (; n > 0; --n)
-    {
-      auto node = create_node(value);
-      link_nodes_at_back(node->as_base(), node->as_base());
-    }
+    fill_insert(node_, n, value);
   }
   catch (...)
   {
     clear();
-    base_allocator::deallocate(node_);
+    destroy_sentinel();
     node_ = nullptr;
     throw;
   }
 }
 
 // 以 [first, last) 初始化容器
-template <class T>
+template <class T, class Alloc>
 template <class Iter>
-void list<T>::copy_init(Iter first, Iter last)
+void list<T, Alloc>::copy_init(Iter first, Iter last)
 {
-  node_ = base_allocator::allocate(1);
-  node_->unlink();
-  size_type n = mystl::distance(first, last);
-  size_ = n;
+  node_ = create_sentinel();
+  size_ = 0;
   try
   {
-    for (; n > 0; --n, ++first)
-    {
-      auto node = create_node(*first);
-      link_nodes_at_back(node->as_base(), node->as_base());
-    }
+    copy_insert(node_, mystl::distance(first, last), first);
   }
   catch (...)
   {
     clear();
-    base_allocator::deallocate(node_);
+    destroy_sentinel();
     node_ = nullptr;
     throw;
   }
 }
 
 // 在 pos 处连接一个节点
-template <class T>
-typename list<T>::iterator 
-list<T>::link_iter_node(const_iterator pos, base_ptr link_node)
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator 
+list<T, Alloc>::link_iter_node(const_iterator pos, base_ptr link_node)
 {
   if (pos == node_->next)
   {
@@ -916,18 +1031,15 @@ list<T>::link_iter_node(const_iterator pos, base_ptr link_node)
 }
 
 // 在 pos 处连接 [first, last] 的结点
-template <class T>
-void list<T>::link_nodes(base_ptr pos, base_ptr first, base_ptr last)
+template <class T, class Alloc>
+void list<T, Alloc>::link_nodes(base_ptr pos, base_ptr first, base_ptr last)
 {
-  pos->prev->next = first;
-  first->prev = pos->prev;
-  pos->prev = last;
-  last->next = pos;
+  list_link_nodes(pos, first, last);
 }
 
 // 在头部连接 [first, last] 结点
-template <class T>
-void list<T>::link_nodes_at_front(base_ptr first, base_ptr last)
+template <class T, class Alloc>
+void list<T, Alloc>::link_nodes_at_front(base_ptr first, base_ptr last)
 {
   first->prev = node_;
   last->next = node_->next;
@@ -936,8 +1048,8 @@ void list<T>::link_nodes_at_front(base_ptr first, base_ptr last)
 }
 
 // 在尾部连接 [first, last] 结点
-template <class T>
-void list<T>::link_nodes_at_back(base_ptr first, base_ptr last)
+template <class T, class Alloc>
+void list<T, Alloc>::link_nodes_at_back(base_ptr first, base_ptr last)
 {
   last->next = node_;
   first->prev = node_->prev;
@@ -946,16 +1058,15 @@ void list<T>::link_nodes_at_back(base_ptr first, base_ptr last)
 }
 
 // 容器与 [first, last] 结点断开连接
-template <class T>
-void list<T>::unlink_nodes(base_ptr first, base_ptr last)
+template <class T, class Alloc>
+void list<T, Alloc>::unlink_nodes(base_ptr first, base_ptr last)
 {
-  first->prev->next = last->next;
-  last->next->prev = first->prev;
+  list_unlink_nodes(first, last);
 }
 
 // 用 n 个元素为容器赋值
-template <class T>
-void list<T>::fill_assign(size_type n, const value_type& value)
+template <class T, class Alloc>
+void list<T, Alloc>::fill_assign(size_type n, const value_type& value)
 {
   auto i = begin();
   auto e = end();
@@ -974,9 +1085,9 @@ void list<T>::fill_assign(size_type n, const value_type& value)
 }
 
 // 复制[f2, l2)为容器赋值
-template <class T>
+template <class T, class Alloc>
 template <class Iter>
-void list<T>::copy_assign(Iter f2, Iter l2)
+void list<T, Alloc>::copy_assign(Iter f2, Iter l2)
 {
   auto f1 = begin();
   auto l1 = end();
@@ -995,169 +1106,278 @@ void list<T>::copy_assign(Iter f2, Iter l2)
 }
 
 // 在 pos 处插入 n 个元素
-template <class T>
-typename list<T>::iterator 
-list<T>::fill_insert(const_iterator pos, size_type n, const value_type& value)
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator 
+list<T, Alloc>::fill_insert(const_iterator pos, size_type n, const value_type& value)
 {
-  iterator r(pos.node_);
-  if (n != 0)
-  {
-    const auto add_size = n;
-    auto node = create_node(value);
-    node->prev = nullptr;
-    r = iterator(node);
-    iterator end = r;
-    try
+  return insert_run(pos, n, [&](T* p)
+  {
+    node_alloc_traits::construct(this->get_alloc(), p, value);
+  });
+}
+
+// 在 pos 处插入 [first, last) 的元素
+template <class T, class Alloc>
+template <class Iter>
+typename list<T, Alloc>::iterator 
+list<T, Alloc>::copy_insert(const_iterator pos, size_type n, Iter first)
+{
+  return insert_run(pos, n, [&](T* p)
+  {
+    node_alloc_traits::construct(this->get_alloc(), p, *first);
+    ++first;
+  });
+}
+
+// 在 pos 处插入 n 个节点，节点取自节点池中一段连续的内存，
+// 依次构造元素的同时与前一个节点相连，最后整段一次连接到 pos 之前
+// 构造时抛出异常，已构造的元素被析构，全部节点归还节点池，容器不变
+template <class T, class Alloc>
+template <class Construct>
+typename list<T, Alloc>::iterator 
+list<T, Alloc>::insert_run(const_iterator pos, size_type n, Construct construct)
+{
+  if (n == 0)
+    return iterator(pos.node_);
+  node_ptr run = pool_.allocate_run(this->get_alloc(), n);
+  size_type i = 0;
+  try
+  {
+    for (; i < n; ++i)
     {
-      // 前面已经创建了一个节点，还需 n - 1 个
-      for (--n; n > 0; --n, ++end)
+      construct(mystl::address_of(run[i].value));
+      if (i != 0)
       {
-        auto next = create_node(value);
-        end.node_->next = next->as_base();  // link node
-        next->prev = end.node_;
+        run[i - 1].next = run[i].as_base();
+        run[i].prev = run[i - 1].as_base();
       }
-      size_ += add_size;
     }
-    catch (...)
+  }
+  catch (...)
+  {
+    for (size_type j = 0; j < n; ++j)
     {
-      auto enode = end.node_;
-      while (true)
-      {
-        auto prev = enode->prev;
-        destroy_node(enode->as_node());
-        if (prev == nullptr)
-          break;
-        enode = prev;
-      }
-      throw;
+      if (j < i)
+        node_alloc_traits::destroy(this->get_alloc(), mystl::address_of(run[j].value));
+      pool_.deallocate(run + j);
     }
-    link_nodes(pos.node_, r.node_, end.node_);
+    throw;
   }
-  return r;
+  link_nodes(pos.node_, run->as_base(), run[n - 1].as_base());
+  size_ += n;
+  return iterator(run);
 }
 
-// 在 pos 处插入 [first, last) 的元素
-template <class T>
-template <class Iter>
-typename list<T>::iterator 
-list<T>::copy_insert(const_iterator pos, size_type n, Iter first)
+// 对 list 进行非递归的归并排序
+// 先把节点取下形成以 nullptr 结尾的链，每条链头节点的 prev 指向它的尾节点
+// 用显式的栈模拟按长度对半划分的归并树：每一层只记录待排序的长度与已排好的左半部分，
+// 叶子直接从链上依次取下节点，不需要递归，也不需要按长度前进来寻找中点
+template <class T, class Alloc>
+template <class Compared>
+void list<T, Alloc>::list_sort(Compared comp)
 {
-  iterator r(pos.node_);
-  if (n != 0)
-  {
-    const auto add_size = n;
-    auto node = create_node(*first);
-    node->prev = nullptr;
-    r = iterator(node);
-    iterator end = r;
-    try
+  if (size_ < 2)
+    return;
+  base_ptr rest = node_->next;
+  node_->prev->next = nullptr;
+  // 每层至少减半，层数不超过 size_type 的位数加一
+  size_type len[sizeof(size_type) * 8 + 1];
+  base_ptr  left[sizeof(size_type) * 8 + 1] = {};
+  size_type depth = 0;
+  base_ptr cur = nullptr;
+  len[0] = size_;
+  try
+  {
+    while (true)
     {
-      for (--n, ++first; n > 0; --n, ++first, ++end)
+      while (len[depth] > 2)
+      { // 先处理左半部分
+        len[depth + 1] = len[depth] / 2;
+        ++depth;
+      }
+      // 叶子为一个或两个节点，直接从链上取下
+      cur = rest;
+      rest = rest->next;
+      if (len[depth] == 1)
       {
-        auto next = create_node(*first);
-        end.node_->next = next->as_base();  // link node
-        next->prev = end.node_;
+        cur->next = nullptr;
+        cur->prev = cur;
       }
-      size_ += add_size;
-    }
-    catch (...)
-    {
-      auto enode = end.node_;
-      while (true)
+      else
       {
-        auto prev = enode->prev;
-        destroy_node(enode->as_node());
-        if (prev == nullptr)
-          break;
-        enode = prev;
+        base_ptr second = rest;
+        rest = rest->next;
+        second->next = nullptr;
+        cur->prev = second;
+        if (comp(second->as_node()->value, cur->as_node()->value))
+        {
+          second->next = cur;
+          second->prev = cur;
+          cur->next = nullptr;
+          cur = second;
+        }
+      }
+      while (depth != 0 && left[depth - 1] != nullptr)
+      { // 右半部分已排好，与左半部分合并后继续向上
+        --depth;
+        base_ptr first = left[depth];
+        base_ptr second = cur;
+        left[depth] = cur = nullptr;
+        merge_chains(cur, first, second, comp);
       }
-      throw;
+      if (depth == 0)
+        break;
+      // 左半部分已排好，转去处理右半部分
+      left[depth - 1] = cur;
+      cur = nullptr;
+      len[depth] = len[depth - 1] - len[depth];
     }
-    link_nodes(pos.node_, r.node_, end.node_);
   }
-  return r;
+  catch (...)
+  { // 比较时抛出异常，把所有节点连回链表，元素的顺序不确定
+    for (auto chain : left)
+      cur = concat_chains(chain, cur);
+    relink_chain(concat_chains(rest, cur));
+    throw;
+  }
+  base_ptr last = cur->prev;
+  cur->prev = node_;
+  node_->next = cur;
+  last->next = node_;
+  node_->prev = last;
 }
 
-// 对 list 进行归并排序，返回一个迭代器指向区间最小元素的位置
-template <class T>
+// 合并两条有序的链，结果写入 result；second 中的节点只有严格小于 first 中的节点时才排在前面
+// 链中相邻的节点已经互相连接，只在两条链交替的位置修改 next 与 prev，合并后头节点的 prev 仍指向尾节点
+// 比较时抛出异常，result 为所有节点首尾相连的链
+template <class T, class Alloc>
 template <class Compared>
-typename list<T>::iterator 
-list<T>::list_sort(iterator f1, iterator l2, size_type n, Compared comp)
+void list<T, Alloc>::merge_chains(base_ptr& result, base_ptr first, base_ptr second,
+                                  Compared& comp)
 {
-  if (n < 2)
-    return f1;
-
-  if (n == 2)
+  if (first == nullptr || second == nullptr)
+  {
+    result = first != nullptr ? first : second;
+    return;
+  }
+  base_ptr first_last = first->prev;
+  base_ptr second_last = second->prev;
+  list_node_base<T> head;
+  base_ptr tail = &head;
+  try
   {
-    if (comp(*--l2, *f1))
+    while (true)
     {
-      auto ln = l2.node_;
-      unlink_nodes(ln, ln);
-      link_nodes(f1.node_, ln, ln);
-      return l2;
+      if (comp(second->as_node()->value, first->as_node()->value))
+      {
+        tail->next = second;
+        second->prev = tail;
+        do
+        {
+          tail = second;
+          second = second->next;
+        } while (second != nullptr && comp(second->as_node()->value, first->as_node()->value));
+        if (second == nullptr)
+        {
+          tail->next = first;
+          first->prev = tail;
+          tail = first_last;
+          break;
+        }
+      }
+      else
+      {
+        tail->next = first;
+        first->prev = tail;
+        do
+        {
+          tail = first;
+          first = first->next;
+        } while (first != nullptr && !comp(second->as_node()->value, first->as_node()->value));
+        if (first == nullptr)
+        {
+          tail->next = second;
+          second->prev = tail;
+          tail = second_last;
+          break;
+        }
+      }
     }
-    return f1;
-  }
-
-  auto n2 = n / 2;
-  auto l1 = f1;
-  mystl::advance(l1, n2);
-  auto result = f1 = list_sort(f1, l1, n2, comp);  // 前半段的最小位置
-  auto f2 = l1 = list_sort(l1, l2, n - n2, comp);  // 后半段的最小位置
-
-  // 把较小的一段区间移到前面
-  if (comp(*f2, *f1))
-  {
-    auto m = f2;
-    ++m;
-    for (; m != l2 && comp(*m, *f1); ++m)
-      ;
-    auto f = f2.node_;
-    auto l = m.node_->prev;
-    result = f2;
-    l1 = f2 = m;
-    unlink_nodes(f, l);
-    m = f1;
-    ++m;
-    link_nodes(f1.node_, f, l);
-    f1 = m;
   }
-  else
+  catch (...)
   {
-    ++f1;
+    tail->next = concat_chains(first, second);
+    result = head.next;
+    throw;
   }
+  result = head.next;
+  result->prev = tail;
+}
 
-  // 合并两段有序区间
-  while (f1 != l1 && f2 != l2)
+// 把 second 接到 first 的尾部
+template <class T, class Alloc>
+typename list<T, Alloc>::base_ptr
+list<T, Alloc>::concat_chains(base_ptr first, base_ptr second) noexcept
+{
+  if (first == nullptr)
+    return second;
+  base_ptr last = first;
+  while (last->next != nullptr)
+    last = last->next;
+  last->next = second;
+  return first;
+}
+
+// 把以 nullptr 结尾的单向链连回哨兵节点，并恢复各节点的 prev
+template <class T, class Alloc>
+void list<T, Alloc>::relink_chain(base_ptr head) noexcept
+{
+  base_ptr prev = node_;
+  for (base_ptr p = head; p != nullptr; p = p->next)
   {
-    if (comp(*f2, *f1))
-    {
-      auto m = f2;
-      ++m;
-      for (; m != l2 && comp(*m, *f1); ++m)
-        ;
-      auto f = f2.node_;
-      auto l = m.node_->prev;
-      if (l1 == f2)
-        l1 = m;
-      f2 = m;
-      unlink_nodes(f, l);
-      m = f1;
-      ++m;
-      link_nodes(f1.node_, f, l);
-      f1 = m;
-    }
-    else
-    {
-      ++f1;
-    }
+    prev->next = p;
+    p->prev = prev;
+    prev = p;
+  }
+  prev->next = node_;
+  node_->prev = prev;
+}
+
+// move_assign 函数，可以直接接管 rhs 的节点
+template <class T, class Alloc>
+void list<T, Alloc>::move_assign(list& rhs, m_true_type)
+{
+  clear();
+  if (this->get_alloc() != rhs.get_alloc())
+  { // 配置器会随之移动，哨兵节点要用旧的配置器释放
+    destroy_sentinel();
+    mystl::alloc_on_move(this->get_alloc(), rhs.get_alloc());
+    node_ = create_sentinel();
+  }
+  splice(end(), rhs);
+}
+
+// move_assign 函数，配置器不传播时，只有两者相等才能接管节点，否则逐个移动元素
+template <class T, class Alloc>
+void list<T, Alloc>::move_assign(list& rhs, m_false_type)
+{
+  if (this->get_alloc() == rhs.get_alloc())
+  {
+    clear();
+    splice(end(), rhs);
+  }
+  else
+  {
+    clear();
+    for (auto& value : rhs)
+      emplace_back(mystl::move(value));
+    rhs.clear();
   }
-  return result;
 }
 
 // 重载比较操作符
-template <class T>
-bool operator==(const list<T>& lhs, const list<T>& rhs)
+template <class T, class Alloc>
+bool operator==(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
   auto f1 = lhs.cbegin();
   auto f2 = rhs.cbegin();
@@ -1168,43 +1388,48 @@ bool operator==(const list<T>& lhs, const list<T>& rhs)
   return f1 == l1 && f2 == l2;
 }
 
-template <class T>
-bool operator<(const list<T>& lhs, const list<T>& rhs)
+template <class T, class Alloc>
+bool operator<(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
   return mystl::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
 }
 
-template <class T>
-bool operator!=(const list<T>& lhs, const list<T>& rhs)
+template <class T, class Alloc>
+bool operator!=(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class T>
-bool operator>(const list<T>& lhs, const list<T>& rhs)
+template <class T, class Alloc>
+bool operator>(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class T>
-bool operator<=(const list<T>& lhs, const list<T>& rhs)
+template <class T, class Alloc>
+bool operator<=(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class T>
-bool operator>=(const list<T>& lhs, const list<T>& rhs)
+template <class T, class Alloc>
+bool operator>=(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class T>
-void swap(list<T>& lhs, list<T>& rhs) noexcept
+template <class T, class Alloc>
+void swap(list<T, Alloc>& lhs, list<T, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
 
+// 哨兵节点在堆上，节点不会指向 list 对象本身，Alloc 可以平凡重定位时容器也可以平凡重定位
+template <class T, class Alloc>
+struct is_trivially_relocatable<list<T, Alloc>>
+  : m_bool_constant<is_trivially_relocatable<Alloc>::value> {};
+
 } // namespace mystl
 #endif // !MYTINYSTL_LIST_H_
 
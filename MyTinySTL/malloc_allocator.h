@@ -0,0 +1,125 @@
+#ifndef MYTINYSTL_MALLOC_ALLOCATOR_H_
+#define MYTINYSTL_MALLOC_ALLOCATOR_H_
+
+// 这个头文件包含一个模板类 malloc_allocator，直接使用 malloc、free 管理内存，
+// 并通过 allocate_at_least 把 malloc 上调的部分交给容器作为容量
+
+// notes:
+//
+// 1. 只有直接由 malloc 得到的内存才能查询实际可用的大小（glibc 的 malloc_usable_size，macOS 的 malloc_size），
+//    ::operator new 可能被程序替换，mystl::allocator 因此不做这种查询，需要利用这部分空间时选用 malloc_allocator
+// 2. 无法查询的平台上 allocate_at_least 返回请求的个数
+// 3. malloc 只保证 max_align_t 的对齐，对齐要求更高的类型不能使用 malloc_allocator
+
+#include <new>
+
+#include <cstddef>
+#include <cstdlib>
+
+#if defined(__linux__)
+#include <malloc.h>
+#define MYSTL_MALLOC_USABLE_SIZE(p) ::malloc_usable_size(p)
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define MYSTL_MALLOC_USABLE_SIZE(p) ::malloc_size(p)
+#endif
+
+#include "allocator.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// 模板类：malloc_allocator
+// 模板参数 T 代表数据类型
+template <class T>
+class malloc_allocator
+{
+  static_assert(alignof(T) <= alignof(std::max_align_t),
+                "malloc_allocator does not support over-aligned types");
+
+public:
+  typedef T            value_type;
+  typedef T*           pointer;
+  typedef const T*     const_pointer;
+  typedef T&           reference;
+  typedef const T&     const_reference;
+  typedef size_t       size_type;
+  typedef ptrdiff_t    difference_type;
+
+  typedef m_true_type  propagate_on_container_move_assignment;
+  typedef m_true_type  is_always_equal;
+
+  template <class U>
+  struct rebind
+  {
+    typedef malloc_allocator<U> other;
+  };
+
+public:
+  malloc_allocator() noexcept {}
+  template <class U>
+  malloc_allocator(const malloc_allocator<U>&) noexcept {}
+
+public:
+  static T*   allocate(size_type n);
+
+  // 申请至少 n 个元素的空间，返回实际可以容纳的个数，回收时可以给出其中任何一个个数
+  static allocation_result<T*> allocate_at_least(size_type n);
+
+  static void deallocate(T* ptr, size_type n) noexcept;
+
+  static size_type max_size() noexcept
+  { return static_cast<size_type>(-1) / sizeof(T); }
+};
+
+/*****************************************************************************************/
+
+template <class T, class U>
+bool operator==(const malloc_allocator<T>&, const malloc_allocator<U>&) noexcept
+{
+  return true;
+}
+
+template <class T, class U>
+bool operator!=(const malloc_allocator<T>&, const malloc_allocator<U>&) noexcept
+{
+  return false;
+}
+
+template <class T>
+T* malloc_allocator<T>::allocate(size_type n)
+{
+  if (n == 0)
+    return nullptr;
+  if (n > max_size())
+    throw std::bad_alloc();
+  void* p = std::malloc(n * sizeof(T));
+  if (p == nullptr)
+    throw std::bad_alloc();
+  return static_cast<T*>(p);
+}
+
+template <class T>
+allocation_result<T*> malloc_allocator<T>::allocate_at_least(size_type n)
+{
+  T* p = allocate(n);
+#ifdef MYSTL_MALLOC_USABLE_SIZE
+  if (p != nullptr)
+  {
+    const size_type count = MYSTL_MALLOC_USABLE_SIZE(p) / sizeof(T);
+    if (count > n)
+      return { p, count };
+  }
+#endif
+  return { p, n };
+}
+
+template <class T>
+void malloc_allocator<T>::deallocate(T* ptr, size_type /*n*/) noexcept
+{
+  std::free(ptr);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_MALLOC_ALLOCATOR_H_
@@ -20,7 +20,9 @@ namespace mystl
 
 // 模板类 map，键值不允许重复
 // 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less
-template <class Key, class T, class Compare = mystl::less<Key>>
+// 参数四代表空间配置器，缺省使用 mystl::allocator
+template <class Key, class T, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<mystl::pair<const Key, T>>>
 class map
 {
 public:
@@ -33,7 +35,7 @@ public:
   // 定义一个 functor，用来进行元素比较
   class value_compare : public binary_function <value_type, value_type, bool>
   {
-    friend class map<Key, T, Compare>;
+    friend class map<Key, T, Compare, Alloc>;
   private:
     Compare comp;
     value_compare(Compare c) : comp(c) {}
@@ -46,7 +48,7 @@ public:
 
 private:
   // 以 mystl::rb_tree 作为底层机制
-  typedef mystl::rb_tree<value_type, key_compare>  base_type;
+  typedef mystl::rb_tree<value_type, key_compare, Alloc> base_type;
   base_type tree_;
 
 public:
@@ -69,23 +71,40 @@ public:
 
   map() = default;
 
+  explicit map(const allocator_type& alloc)
+    :tree_(key_compare(), alloc)
+  {
+  }
+  explicit map(const key_compare& comp, const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  {
+  }
+
   template <class InputIterator>
-  map(InputIterator first, InputIterator last)
-    :tree_()
+  map(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type())
+    :tree_(key_compare(), alloc)
   { tree_.insert_unique(first, last); }
 
-  map(std::initializer_list<value_type> ilist) 
-    :tree_()
+  map(std::initializer_list<value_type> ilist, const allocator_type& alloc = allocator_type())
+    :tree_(key_compare(), alloc)
   { tree_.insert_unique(ilist.begin(), ilist.end()); }
 
   map(const map& rhs) 
     :tree_(rhs.tree_) 
   {
   }
+  map(const map& rhs, const allocator_type& alloc)
+    :tree_(rhs.tree_, alloc)
+  {
+  }
   map(map&& rhs) noexcept
     :tree_(mystl::move(rhs.tree_))
   {
   }
+  map(map&& rhs, const allocator_type& alloc)
+    :tree_(mystl::move(rhs.tree_), alloc)
+  {
+  }
 
   map& operator=(const map& rhs)
   { 
@@ -144,6 +163,7 @@ public:
   bool                   empty()    const noexcept { return tree_.empty(); }
   size_type              size()     const noexcept { return tree_.size(); }
   size_type              max_size() const noexcept { return tree_.max_size(); }
+  memory_usage_info      memory_usage() const noexcept { return tree_.memory_usage(); }
 
   // 访问元素相关
 
@@ -256,45 +276,45 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class T, class Compare>
-bool operator==(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator==(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator<(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
 {
   return lhs < rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator!=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator!=(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator>(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator<=(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator>=(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class Key, class T, class Compare>
-void swap(map<Key, T, Compare>& lhs, map<Key, T, Compare>& rhs) noexcept
+template <class Key, class T, class Compare, class Alloc>
+void swap(map<Key, T, Compare, Alloc>& lhs, map<Key, T, Compare, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
@@ -303,7 +323,9 @@ void swap(map<Key, T, Compare>& lhs, map<Key, T, Compare>& rhs) noexcept
 
 // 模板类 multimap，键值允许重复
 // 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less
-template <class Key, class T, class Compare = mystl::less<Key>>
+// 参数四代表空间配置器，缺省使用 mystl::allocator
+template <class Key, class T, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<mystl::pair<const Key, T>>>
 class multimap
 {
 public:
@@ -316,7 +338,7 @@ public:
   // 定义一个 functor，用来进行元素比较
   class value_compare : public binary_function <value_type, value_type, bool>
   {
-    friend class multimap<Key, T, Compare>;
+    friend class multimap<Key, T, Compare, Alloc>;
   private:
     Compare comp;
     value_compare(Compare c) : comp(c) {}
@@ -329,7 +351,7 @@ public:
 
 private:
   // 用 mystl::rb_tree 作为底层机制
-  typedef mystl::rb_tree<value_type, key_compare>  base_type;
+  typedef mystl::rb_tree<value_type, key_compare, Alloc> base_type;
   base_type tree_;
 
 public:
@@ -352,22 +374,39 @@ public:
 
   multimap() = default;
 
+  explicit multimap(const allocator_type& alloc)
+    :tree_(key_compare(), alloc)
+  {
+  }
+  explicit multimap(const key_compare& comp, const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  {
+  }
+
   template <class InputIterator>
-  multimap(InputIterator first, InputIterator last) 
-    :tree_() 
+  multimap(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type()) 
+    :tree_(key_compare(), alloc) 
   { tree_.insert_multi(first, last); }
-  multimap(std::initializer_list<value_type> ilist) 
-    :tree_() 
+  multimap(std::initializer_list<value_type> ilist, const allocator_type& alloc = allocator_type())
+    :tree_(key_compare(), alloc) 
   { tree_.insert_multi(ilist.begin(), ilist.end()); }
 
   multimap(const multimap& rhs)
     :tree_(rhs.tree_)
   {
   }
+  multimap(const multimap& rhs, const allocator_type& alloc)
+    :tree_(rhs.tree_, alloc)
+  {
+  }
   multimap(multimap&& rhs) noexcept
     :tree_(mystl::move(rhs.tree_))
   {
   }
+  multimap(multimap&& rhs, const allocator_type& alloc)
+    :tree_(mystl::move(rhs.tree_), alloc)
+  {
+  }
 
   multimap& operator=(const multimap& rhs) 
   { 
@@ -426,6 +465,7 @@ public:
   bool                   empty()    const noexcept { return tree_.empty(); }
   size_type              size()     const noexcept { return tree_.size(); }
   size_type              max_size() const noexcept { return tree_.max_size(); }
+  memory_usage_info      memory_usage() const noexcept { return tree_.memory_usage(); }
 
   // 插入删除操作
 
@@ -501,49 +541,60 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class T, class Compare>
-bool operator==(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator==(const multimap<Key, T, Compare, Alloc>& lhs, const multimap<Key, T, Compare, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator<(const multimap<Key, T, Compare, Alloc>& lhs, const multimap<Key, T, Compare, Alloc>& rhs)
 {
   return lhs < rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator!=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator!=(const multimap<Key, T, Compare, Alloc>& lhs, const multimap<Key, T, Compare, Alloc>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator>(const multimap<Key, T, Compare, Alloc>& lhs, const multimap<Key, T, Compare, Alloc>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator<=(const multimap<Key, T, Compare, Alloc>& lhs, const multimap<Key, T, Compare, Alloc>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator>=(const multimap<Key, T, Compare, Alloc>& lhs, const multimap<Key, T, Compare, Alloc>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class Key, class T, class Compare>
-void swap(multimap<Key, T, Compare>& lhs, multimap<Key, T, Compare>& rhs) noexcept
+template <class Key, class T, class Compare, class Alloc>
+void swap(multimap<Key, T, Compare, Alloc>& lhs, multimap<Key, T, Compare, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
 
+// 与 rb_tree 相同，Compare、Alloc 可以平凡重定位时容器也可以平凡重定位
+template <class Key, class T, class Compare, class Alloc>
+struct is_trivially_relocatable<map<Key, T, Compare, Alloc>>
+  : m_bool_constant<is_trivially_relocatable<Compare>::value &&
+    is_trivially_relocatable<Alloc>::value> {};
+
+template <class Key, class T, class Compare, class Alloc>
+struct is_trivially_relocatable<multimap<Key, T, Compare, Alloc>>
+  : m_bool_constant<is_trivially_relocatable<Compare>::value &&
+    is_trivially_relocatable<Alloc>::value> {};
+
 } // namespace mystl
 #endif // !MYTINYSTL_MAP_H_
 
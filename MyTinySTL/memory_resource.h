@@ -0,0 +1,725 @@
+#ifndef MYTINYSTL_MEMORY_RESOURCE_H_
+#define MYTINYSTL_MEMORY_RESOURCE_H_
+
+// 这个头文件包含 mystl::pmr 名字空间下的多态内存资源与配置器
+//
+// memory_resource               : 内存资源的抽象基类，通过虚函数分配、回收内存
+// new_delete_resource           : 使用 ::operator new / ::operator delete 的内存资源
+// null_memory_resource          : 任何分配请求都抛出 std::bad_alloc 的内存资源
+// monotonic_buffer_resource     : 单调增长的内存资源，以指针递增的方式分配，回收是空操作，release 时一次性释放
+// unsynchronized_pool_resource  : 不加锁的内存池资源，按大小分级维护自由链表，适合单线程内大量节点的分配与回收
+// polymorphic_allocator         : 以 memory_resource 为底层的配置器，类型不随内存资源改变
+
+// notes:
+//
+// 1. 内存资源不拥有、也不复制上游资源，使用者需要保证上游资源的生存期长于下游资源
+// 2. 配置器之间只有指向同一个内存资源（或内存资源判定相等）时才相等，容器交换时配置器不传播，
+//    拷贝构造时新容器使用缺省内存资源，与 std::pmr 的约定相同
+// 3. polymorphic_allocator 在构造元素时会把自身传给使用配置器的元素（如 pmr::string），
+//    对 mystl::pair 则分别传给两个成员，使得 pmr::map<pmr::string, pmr::string> 的全部内存都来自同一个资源
+// 4. 缺省内存资源可以由 set_default_resource 修改，修改本身是线程安全的，但各个资源本身不加锁
+
+#include <new>
+#include <atomic>
+#include <type_traits>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+namespace pmr
+{
+
+// 内存资源缺省的对齐要求
+enum { EMaxAlign = alignof(std::max_align_t) };
+
+// 把 n 上调到 align 的倍数，align 必须是 2 的幂
+inline size_t round_up(size_t n, size_t align) noexcept
+{
+  return (n + align - 1) & ~(align - 1);
+}
+
+// 抽象类 : memory_resource
+// 公有接口调用私有的虚函数 do_allocate、do_deallocate、do_is_equal，派生类改写这三个函数
+class memory_resource
+{
+public:
+  virtual ~memory_resource() {}
+
+  void* allocate(size_t bytes, size_t align = EMaxAlign)
+  { return do_allocate(bytes, align); }
+
+  void deallocate(void* p, size_t bytes, size_t align = EMaxAlign)
+  { do_deallocate(p, bytes, align); }
+
+  bool is_equal(const memory_resource& other) const noexcept
+  { return do_is_equal(other); }
+
+private:
+  virtual void* do_allocate(size_t bytes, size_t align) = 0;
+  virtual void  do_deallocate(void* p, size_t bytes, size_t align) = 0;
+  virtual bool  do_is_equal(const memory_resource& other) const noexcept = 0;
+};
+
+inline bool operator==(const memory_resource& lhs, const memory_resource& rhs) noexcept
+{
+  return &lhs == &rhs || lhs.is_equal(rhs);
+}
+
+inline bool operator!=(const memory_resource& lhs, const memory_resource& rhs) noexcept
+{
+  return !(lhs == rhs);
+}
+
+/*****************************************************************************************/
+// new_delete_resource 与 null_memory_resource
+
+// 使用 ::operator new 的内存资源
+// 对齐要求超过 max_align_t 时由 aligned_allocate 处理
+class new_delete_memory_resource : public memory_resource
+{
+private:
+  void* do_allocate(size_t bytes, size_t align) override
+  {
+    return mystl::aligned_allocate(bytes, align);
+  }
+
+  void do_deallocate(void* p, size_t, size_t align) override
+  {
+    mystl::aligned_deallocate(p, align);
+  }
+
+  bool do_is_equal(const memory_resource& other) const noexcept override
+  { return this == &other; }
+};
+
+// 不提供任何内存的资源，可以作为上游资源，保证下游资源只使用给定的缓冲区
+class null_memory_resource_type : public memory_resource
+{
+private:
+  void* do_allocate(size_t, size_t) override
+  { throw std::bad_alloc(); }
+
+  void do_deallocate(void*, size_t, size_t) override {}
+
+  bool do_is_equal(const memory_resource& other) const noexcept override
+  { return this == &other; }
+};
+
+// 函数内的静态变量保证各个翻译单元共享同一份，且不会在使用前析构
+inline memory_resource* new_delete_resource() noexcept
+{
+  static new_delete_memory_resource* r = ::new new_delete_memory_resource();
+  return r;
+}
+
+inline memory_resource* null_memory_resource() noexcept
+{
+  static null_memory_resource_type* r = ::new null_memory_resource_type();
+  return r;
+}
+
+inline std::atomic<memory_resource*>& default_resource_ref() noexcept
+{
+  static std::atomic<memory_resource*> r(new_delete_resource());
+  return r;
+}
+
+// 获取缺省内存资源
+inline memory_resource* get_default_resource() noexcept
+{
+  return default_resource_ref().load();
+}
+
+// 设置缺省内存资源，传入空指针时恢复为 new_delete_resource，返回原来的缺省资源
+inline memory_resource* set_default_resource(memory_resource* r) noexcept
+{
+  if (r == nullptr)
+    r = new_delete_resource();
+  return default_resource_ref().exchange(r);
+}
+
+/*****************************************************************************************/
+// monotonic_buffer_resource
+
+// 类 : monotonic_buffer_resource
+// 在当前缓冲区中递增指针分配内存，缓冲区不够时向上游申请更大的一块（每次翻倍）
+// deallocate 什么也不做，内存只在 release 或析构时一次性还给上游
+class monotonic_buffer_resource : public memory_resource
+{
+private:
+  // 向上游申请的每一块内存开头保存的信息，所有块串成单向链表
+  struct chunk
+  {
+    chunk* next;
+    size_t bytes;
+    size_t align;
+  };
+
+  enum { EInitSize = 1024 };
+
+  memory_resource* upstream_;
+  void*            init_buffer_;   // 构造时给定的初始缓冲区，不属于本资源
+  size_t           init_size_;
+  char*            cur_;           // 当前缓冲区中的可用空间 [cur_, cur_ + space_)
+  size_t           space_;
+  size_t           next_size_;     // 下一次向上游申请的大小
+  chunk*           chunks_;
+
+public:
+  explicit monotonic_buffer_resource(memory_resource* upstream = get_default_resource())
+    :upstream_(upstream), init_buffer_(nullptr), init_size_(0), cur_(nullptr), space_(0),
+    next_size_(EInitSize), chunks_(nullptr)
+  {
+  }
+
+  explicit monotonic_buffer_resource(size_t initial_size,
+                                     memory_resource* upstream = get_default_resource())
+    :upstream_(upstream), init_buffer_(nullptr), init_size_(0), cur_(nullptr), space_(0),
+    next_size_(initial_size == 0 ? 1 : initial_size), chunks_(nullptr)
+  {
+  }
+
+  monotonic_buffer_resource(void* buffer, size_t buffer_size,
+                            memory_resource* upstream = get_default_resource())
+    :upstream_(upstream), init_buffer_(buffer), init_size_(buffer_size),
+    cur_(static_cast<char*>(buffer)), space_(buffer_size),
+    next_size_(buffer_size < 2 ? static_cast<size_t>(EInitSize) : buffer_size * 2), chunks_(nullptr)
+  {
+  }
+
+  monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+  monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+  ~monotonic_buffer_resource() override
+  { release(); }
+
+  // 把向上游申请的全部内存归还，之后重新从初始缓冲区开始分配
+  void release() noexcept;
+
+  memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+private:
+  void* do_allocate(size_t bytes, size_t align) override;
+
+  void do_deallocate(void*, size_t, size_t) override {}
+
+  bool do_is_equal(const memory_resource& other) const noexcept override
+  { return this == &other; }
+
+  void new_chunk(size_t bytes, size_t align);
+};
+
+/*****************************************************************************************/
+
+inline void* monotonic_buffer_resource::do_allocate(size_t bytes, size_t align)
+{
+  if (bytes == 0)
+    bytes = 1;
+  size_t pad = static_cast<size_t>(-reinterpret_cast<uintptr_t>(cur_)) & (align - 1);
+  if (cur_ == nullptr || pad + bytes > space_)
+  {
+    new_chunk(bytes, align);
+    pad = static_cast<size_t>(-reinterpret_cast<uintptr_t>(cur_)) & (align - 1);
+  }
+  char* p = cur_ + pad;
+  cur_ = p + bytes;
+  space_ -= pad + bytes;
+  return p;
+}
+
+// 申请一块至少能放下 bytes 字节（按 align 对齐）的新缓冲区
+inline void monotonic_buffer_resource::new_chunk(size_t bytes, size_t align)
+{
+  const size_t chunk_align = align < static_cast<size_t>(EMaxAlign)
+    ? static_cast<size_t>(EMaxAlign) : align;
+  const size_t head = round_up(sizeof(chunk), chunk_align);
+  size_t size = next_size_;
+  if (size < bytes + align)
+    size = bytes + align;
+  size = round_up(size + head, EMaxAlign);
+  void* raw = upstream_->allocate(size, chunk_align);
+  chunk* c = static_cast<chunk*>(raw);
+  c->next = chunks_;
+  c->bytes = size;
+  c->align = chunk_align;
+  chunks_ = c;
+  cur_ = static_cast<char*>(raw) + head;
+  space_ = size - head;
+  // 下一块的大小翻倍
+  if (next_size_ < static_cast<size_t>(-1) / 4)
+    next_size_ = size * 2;
+}
+
+inline void monotonic_buffer_resource::release() noexcept
+{
+  while (chunks_ != nullptr)
+  {
+    chunk* next = chunks_->next;
+    upstream_->deallocate(chunks_, chunks_->bytes, chunks_->align);
+    chunks_ = next;
+  }
+  cur_ = static_cast<char*>(init_buffer_);
+  space_ = init_size_;
+  if (init_buffer_ != nullptr)
+    next_size_ = init_size_ < 2 ? static_cast<size_t>(EInitSize) : init_size_ * 2;
+}
+
+/*****************************************************************************************/
+// unsynchronized_pool_resource
+
+// 内存池的参数，为 0 时使用缺省值
+struct pool_options
+{
+  size_t max_blocks_per_chunk = 0;         // 每次向上游申请时最多切分出的区块数
+  size_t largest_required_pool_block = 0;  // 由内存池管理的最大区块，更大的请求直接转交上游
+};
+
+// 类 : unsynchronized_pool_resource
+// 区块大小按 2 的幂分级（8, 16, 32, ...），每一级维护一条自由链表和一串从上游申请的大块内存，
+// 每次申请的大块所含的区块数从 8 开始翻倍，直到 max_blocks_per_chunk
+// 超过 largest_required_pool_block 或对齐要求超过 max_align_t 的请求直接向上游申请，并记录下来以便 release
+// 不加锁，只能在一个线程中使用
+class unsynchronized_pool_resource : public memory_resource
+{
+private:
+  enum { EMinBlock = 8, EMinShift = 3, EFirstBlocks = 8 };
+  enum { EDefaultMaxBlocks = 1024, EDefaultLargest = 4096 };
+  enum { ELimitMaxBlocks = 1 << 16, ELimitLargest = 1 << 16 };
+
+  // 空闲区块
+  struct free_block
+  {
+    free_block* next;
+  };
+
+  // 向上游申请的大块内存的头部
+  struct chunk
+  {
+    chunk* next;
+    size_t bytes;
+  };
+
+  // 一个大小等级
+  struct pool
+  {
+    free_block* free_list;
+    chunk*      chunks;
+    char*       cur;          // 最近一块中尚未切分的部分 [cur, end)
+    char*       end;
+    size_t      next_blocks;  // 下一次申请的区块数
+  };
+
+  // 直接向上游申请的大块内存的头部，串成双向链表
+  struct large_block
+  {
+    large_block* prev;
+    large_block* next;
+    void*        raw;
+    size_t       bytes;
+    size_t       align;
+  };
+
+  memory_resource* upstream_;
+  pool_options     opts_;
+  pool*            pools_;
+  size_t           npools_;
+  large_block*     large_;
+
+public:
+  unsynchronized_pool_resource()
+    :unsynchronized_pool_resource(pool_options(), get_default_resource())
+  {
+  }
+
+  explicit unsynchronized_pool_resource(memory_resource* upstream)
+    :unsynchronized_pool_resource(pool_options(), upstream)
+  {
+  }
+
+  explicit unsynchronized_pool_resource(const pool_options& opts,
+                                        memory_resource* upstream = get_default_resource());
+
+  unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
+  unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&) = delete;
+
+  ~unsynchronized_pool_resource() override;
+
+  // 把向上游申请的全部内存归还，即使其中还有没有回收的区块
+  void release() noexcept;
+
+  memory_resource* upstream_resource() const noexcept { return upstream_; }
+  pool_options     options()           const noexcept { return opts_; }
+
+private:
+  void* do_allocate(size_t bytes, size_t align) override;
+  void  do_deallocate(void* p, size_t bytes, size_t align) override;
+
+  bool do_is_equal(const memory_resource& other) const noexcept override
+  { return this == &other; }
+
+  size_t pool_index(size_t bytes, size_t align) const noexcept;
+  size_t block_size(size_t index) const noexcept
+  { return static_cast<size_t>(EMinBlock) << index; }
+
+  void* refill(size_t index);
+  void* allocate_large(size_t bytes, size_t align);
+  void  deallocate_large(void* p);
+};
+
+/*****************************************************************************************/
+
+inline unsynchronized_pool_resource::
+unsynchronized_pool_resource(const pool_options& opts, memory_resource* upstream)
+  :upstream_(upstream), opts_(opts), pools_(nullptr), npools_(0), large_(nullptr)
+{
+  if (opts_.max_blocks_per_chunk == 0)
+    opts_.max_blocks_per_chunk = EDefaultMaxBlocks;
+  else if (opts_.max_blocks_per_chunk > static_cast<size_t>(ELimitMaxBlocks))
+    opts_.max_blocks_per_chunk = ELimitMaxBlocks;
+  if (opts_.largest_required_pool_block == 0)
+    opts_.largest_required_pool_block = EDefaultLargest;
+  else if (opts_.largest_required_pool_block > static_cast<size_t>(ELimitLargest))
+    opts_.largest_required_pool_block = ELimitLargest;
+  // 上调到 2 的幂
+  size_t largest = EMinBlock;
+  npools_ = 1;
+  while (largest < opts_.largest_required_pool_block)
+  {
+    largest <<= 1;
+    ++npools_;
+  }
+  opts_.largest_required_pool_block = largest;
+  pools_ = static_cast<pool*>(upstream_->allocate(npools_ * sizeof(pool), alignof(pool)));
+  for (size_t i = 0; i < npools_; ++i)
+  {
+    pools_[i].free_list = nullptr;
+    pools_[i].chunks = nullptr;
+    pools_[i].cur = nullptr;
+    pools_[i].end = nullptr;
+    pools_[i].next_blocks = EFirstBlocks < opts_.max_blocks_per_chunk
+      ? static_cast<size_t>(EFirstBlocks) : opts_.max_blocks_per_chunk;
+  }
+}
+
+inline unsynchronized_pool_resource::~unsynchronized_pool_resource()
+{
+  release();
+  upstream_->deallocate(pools_, npools_ * sizeof(pool), alignof(pool));
+}
+
+// 返回 bytes 对应的等级，不由内存池管理时返回 npools_
+inline size_t unsynchronized_pool_resource::pool_index(size_t bytes, size_t align) const noexcept
+{
+  if (align > static_cast<size_t>(EMaxAlign))
+    return npools_;
+  if (bytes < align)
+    bytes = align;
+  if (bytes > opts_.largest_required_pool_block)
+    return npools_;
+  size_t index = 0;
+  for (size_t n = (bytes - 1) >> EMinShift; n != 0; n >>= 1)
+    ++index;
+  return index;
+}
+
+inline void* unsynchronized_pool_resource::do_allocate(size_t bytes, size_t align)
+{
+  const size_t index = pool_index(bytes, align);
+  if (index == npools_)
+    return allocate_large(bytes, align);
+  pool& p = pools_[index];
+  free_block* b = p.free_list;
+  if (b == nullptr)
+    return refill(index);
+  p.free_list = b->next;
+  return b;
+}
+
+inline void unsynchronized_pool_resource::do_deallocate(void* ptr, size_t bytes, size_t align)
+{
+  const size_t index = pool_index(bytes, align);
+  if (index == npools_)
+  {
+    deallocate_large(ptr);
+    return;
+  }
+  free_block* b = static_cast<free_block*>(ptr);
+  b->next = pools_[index].free_list;
+  pools_[index].free_list = b;
+}
+
+// 自由链表为空，从最近一块的剩余部分切分，剩余部分不够时向上游申请新的一块
+inline void* unsynchronized_pool_resource::refill(size_t index)
+{
+  pool& p = pools_[index];
+  const size_t size = block_size(index);
+  if (p.cur == p.end)
+  {
+    const size_t head = round_up(sizeof(chunk), EMaxAlign);
+    const size_t bytes = head + p.next_blocks * size;
+    chunk* c = static_cast<chunk*>(upstream_->allocate(bytes, EMaxAlign));
+    c->next = p.chunks;
+    c->bytes = bytes;
+    p.chunks = c;
+    p.cur = reinterpret_cast<char*>(c) + head;
+    p.end = reinterpret_cast<char*>(c) + bytes;
+    if (p.next_blocks < opts_.max_blocks_per_chunk)
+    {
+      p.next_blocks *= 2;
+      if (p.next_blocks > opts_.max_blocks_per_chunk)
+        p.next_blocks = opts_.max_blocks_per_chunk;
+    }
+  }
+  void* result = p.cur;
+  p.cur += size;
+  return result;
+}
+
+inline void* unsynchronized_pool_resource::allocate_large(size_t bytes, size_t align)
+{
+  if (align < static_cast<size_t>(EMaxAlign))
+    align = EMaxAlign;
+  const size_t head = round_up(sizeof(large_block), align);
+  THROW_LENGTH_ERROR_IF(bytes > static_cast<size_t>(-1) - head,
+                        "unsynchronized_pool_resource's block too big");
+  void* raw = upstream_->allocate(head + bytes, align);
+  char* result = static_cast<char*>(raw) + head;
+  large_block* b = reinterpret_cast<large_block*>(result - sizeof(large_block));
+  b->raw = raw;
+  b->bytes = head + bytes;
+  b->align = align;
+  b->prev = nullptr;
+  b->next = large_;
+  if (large_ != nullptr)
+    large_->prev = b;
+  large_ = b;
+  return result;
+}
+
+inline void unsynchronized_pool_resource::deallocate_large(void* p)
+{
+  large_block* b = reinterpret_cast<large_block*>(static_cast<char*>(p) - sizeof(large_block));
+  if (b->prev != nullptr)
+    b->prev->next = b->next;
+  else
+    large_ = b->next;
+  if (b->next != nullptr)
+    b->next->prev = b->prev;
+  upstream_->deallocate(b->raw, b->bytes, b->align);
+}
+
+inline void unsynchronized_pool_resource::release() noexcept
+{
+  for (size_t i = 0; i < npools_; ++i)
+  {
+    pool& p = pools_[i];
+    while (p.chunks != nullptr)
+    {
+      chunk* next = p.chunks->next;
+      upstream_->deallocate(p.chunks, p.chunks->bytes, EMaxAlign);
+      p.chunks = next;
+    }
+    p.free_list = nullptr;
+    p.cur = nullptr;
+    p.end = nullptr;
+    p.next_blocks = EFirstBlocks < opts_.max_blocks_per_chunk
+      ? static_cast<size_t>(EFirstBlocks) : opts_.max_blocks_per_chunk;
+  }
+  while (large_ != nullptr)
+  {
+    large_block* next = large_->next;
+    upstream_->deallocate(large_->raw, large_->bytes, large_->align);
+    large_ = next;
+  }
+}
+
+/*****************************************************************************************/
+// polymorphic_allocator
+
+// uses_allocator : 类型 T 是否使用配置器 Alloc，即 T 定义了 allocator_type 且 Alloc 可以转换为它
+template <class T, class Alloc>
+struct uses_allocator
+{
+  template <class U>
+  static m_bool_constant<std::is_convertible<Alloc, typename U::allocator_type>::value> test(int);
+  template <class U>
+  static m_false_type test(...);
+  typedef decltype(test<T>(0)) type;
+  static constexpr bool value = type::value;
+};
+
+// 模板类 : polymorphic_allocator
+// 模板参数代表数据类型，所有内存都向构造时给定的 memory_resource 申请
+template <class T>
+class polymorphic_allocator
+{
+  template <class U> friend class polymorphic_allocator;
+
+public:
+  typedef T            value_type;
+  typedef T*           pointer;
+  typedef const T*     const_pointer;
+  typedef T&           reference;
+  typedef const T&     const_reference;
+  typedef size_t       size_type;
+  typedef ptrdiff_t    difference_type;
+
+  typedef m_false_type propagate_on_container_copy_assignment;
+  typedef m_false_type propagate_on_container_move_assignment;
+  typedef m_false_type propagate_on_container_swap;
+  typedef m_false_type is_always_equal;
+
+  template <class U>
+  struct rebind
+  {
+    typedef polymorphic_allocator<U> other;
+  };
+
+private:
+  memory_resource* resource_;
+
+public:
+  polymorphic_allocator() noexcept
+    :resource_(get_default_resource())
+  {
+  }
+
+  polymorphic_allocator(memory_resource* r) noexcept
+    :resource_(r)
+  {
+    MYSTL_DEBUG(r != nullptr);
+  }
+
+  template <class U>
+  polymorphic_allocator(const polymorphic_allocator<U>& other) noexcept
+    :resource_(other.resource_)
+  {
+  }
+
+public:
+  T* allocate(size_type n)
+  {
+    THROW_LENGTH_ERROR_IF(n > max_size(), "polymorphic_allocator<T>'s size too big");
+    return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* p, size_type n)
+  {
+    resource_->deallocate(p, n * sizeof(T), alignof(T));
+  }
+
+  // 构造元素，元素使用配置器时把本配置器作为最后一个参数传给它
+  template <class U, class... Args>
+  void construct(U* p, Args&& ...args)
+  {
+    typedef m_bool_constant<uses_allocator<U, polymorphic_allocator>::value &&
+      std::is_constructible<U, Args..., const polymorphic_allocator&>::value> use_alloc;
+    construct_aux(p, use_alloc(), mystl::forward<Args>(args)...);
+  }
+
+  // 对 pair 分别构造两个成员
+  template <class T1, class T2>
+  void construct(mystl::pair<T1, T2>* p)
+  {
+    typedef typename std::remove_cv<T1>::type first_type;
+    first_type* first = const_cast<first_type*>(mystl::address_of(p->first));
+    construct(first);
+    try
+    {
+      construct(mystl::address_of(p->second));
+    }
+    catch (...)
+    {
+      first->~first_type();
+      throw;
+    }
+  }
+
+  template <class T1, class T2, class U1, class U2>
+  void construct(mystl::pair<T1, T2>* p, U1&& a, U2&& b)
+  {
+    construct_pair(p, mystl::forward<U1>(a), mystl::forward<U2>(b));
+  }
+
+  template <class T1, class T2, class U1, class U2>
+  void construct(mystl::pair<T1, T2>* p, const mystl::pair<U1, U2>& x)
+  {
+    construct_pair(p, x.first, x.second);
+  }
+
+  template <class T1, class T2, class U1, class U2>
+  void construct(mystl::pair<T1, T2>* p, mystl::pair<U1, U2>&& x)
+  {
+    construct_pair(p, mystl::forward<U1>(x.first), mystl::forward<U2>(x.second));
+  }
+
+  template <class U>
+  void destroy(U* p)
+  {
+    p->~U();
+  }
+
+  size_type max_size() const noexcept
+  { return static_cast<size_type>(-1) / sizeof(T); }
+
+  // 拷贝构造容器时不沿用原来的内存资源
+  polymorphic_allocator select_on_container_copy_construction() const noexcept
+  { return polymorphic_allocator(); }
+
+  memory_resource* resource() const noexcept
+  { return resource_; }
+
+private:
+  template <class U, class... Args>
+  void construct_aux(U* p, m_true_type, Args&& ...args)
+  {
+    ::new (static_cast<void*>(p)) U(mystl::forward<Args>(args)..., *this);
+  }
+
+  template <class U, class... Args>
+  void construct_aux(U* p, m_false_type, Args&& ...args)
+  {
+    ::new (static_cast<void*>(p)) U(mystl::forward<Args>(args)...);
+  }
+
+  template <class T1, class T2, class U1, class U2>
+  void construct_pair(mystl::pair<T1, T2>* p, U1&& a, U2&& b)
+  {
+    typedef typename std::remove_cv<T1>::type first_type;
+    typedef typename std::remove_cv<T2>::type second_type;
+    first_type* first = const_cast<first_type*>(mystl::address_of(p->first));
+    second_type* second = const_cast<second_type*>(mystl::address_of(p->second));
+    construct(first, mystl::forward<U1>(a));
+    try
+    {
+      construct(second, mystl::forward<U2>(b));
+    }
+    catch (...)
+    {
+      first->~first_type();
+      throw;
+    }
+  }
+};
+
+template <class T1, class T2>
+bool operator==(const polymorphic_allocator<T1>& lhs, const polymorphic_allocator<T2>& rhs) noexcept
+{
+  return *lhs.resource() == *rhs.resource();
+}
+
+template <class T1, class T2>
+bool operator!=(const polymorphic_allocator<T1>& lhs, const polymorphic_allocator<T2>& rhs) noexcept
+{
+  return !(lhs == rhs);
+}
+
+} // namespace pmr
+} // namespace mystl
+#endif // !MYTINYSTL_MEMORY_RESOURCE_H_
@@ -0,0 +1,212 @@
+#ifndef MYTINYSTL_MMAP_ALLOCATOR_H_
+#define MYTINYSTL_MMAP_ALLOCATOR_H_
+
+// 这个头文件包含一个模板类 mmap_allocator，大块内存直接向系统映射匿名页，适合非常大的 vector
+//
+// mmap_allocator<T>        : 不小于 2MB 的请求使用 mmap，较小的请求使用 aligned_allocate
+// mmap_allocator<T, true>  : 同上，并对映射的内存调用 madvise(MADV_HUGEPAGE)，请求使用透明大页
+
+// notes:
+//
+// 1. mmap_allocator 提供 reallocate，vector 的元素可以平凡重定位时，扩容不再申请新空间再逐个移动，
+//    而是由 mremap 原地扩展映射，必要时由内核搬移页表，不复制数据，也不会同时占用新旧两份物理内存
+// 2. mremap 只在 Linux 上可用，其他类 Unix 系统上大块内存仍使用 mmap，但 reallocate 退化为申请、复制、释放，
+//    不支持 mmap 的平台上全部使用 ::operator new
+// 3. 映射的大小上调到页大小（使用大页时上调到 2MB）的整数倍，回收时按同样的规则计算，因此回收时必须给出与分配时相同的个数
+
+#include <new>
+
+#include <cstddef>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define MYSTL_HAS_MMAP 1
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+#define MYSTL_HAS_MREMAP 1
+#endif
+#endif
+
+#include "algobase.h"
+#include "allocator.h"
+#include "util.h"
+
+namespace mystl
+{
+
+// 使用 mmap 的最小请求大小以及大页的大小
+enum { EMmapThreshold = 2 * 1024 * 1024, EHugePageSize = 2 * 1024 * 1024 };
+
+// 模板类：mmap_allocator
+// 模板参数 T 代表数据类型，HugePage 代表是否请求透明大页
+template <class T, bool HugePage = false>
+class mmap_allocator
+{
+public:
+  typedef T            value_type;
+  typedef T*           pointer;
+  typedef const T*     const_pointer;
+  typedef T&           reference;
+  typedef const T&     const_reference;
+  typedef size_t       size_type;
+  typedef ptrdiff_t    difference_type;
+
+  typedef m_true_type  propagate_on_container_move_assignment;
+  typedef m_true_type  is_always_equal;
+
+  template <class U>
+  struct rebind
+  {
+    typedef mmap_allocator<U, HugePage> other;
+  };
+
+public:
+  mmap_allocator() noexcept {}
+  template <class U>
+  mmap_allocator(const mmap_allocator<U, HugePage>&) noexcept {}
+
+public:
+  static T*   allocate(size_type n);
+  static void deallocate(T* ptr, size_type n);
+
+  // 把 ptr 指向的 old_n 个元素的空间调整为 new_n 个，只能用于可以平凡重定位的类型
+  static T*   reallocate(T* ptr, size_type old_n, size_type new_n);
+
+  static size_type max_size() noexcept
+  { return static_cast<size_type>(-1) / sizeof(T); }
+
+private:
+  static bool      use_mmap(size_type bytes) noexcept
+  { return bytes >= static_cast<size_type>(EMmapThreshold); }
+
+  static size_type map_size(size_type bytes) noexcept;
+  static void*     map_pages(size_type bytes);
+  static void      advise(void* p, size_type len) noexcept;
+};
+
+/*****************************************************************************************/
+
+template <class T, bool HugePage>
+bool operator==(const mmap_allocator<T, HugePage>&, const mmap_allocator<T, HugePage>&) noexcept
+{
+  return true;
+}
+
+template <class T, bool HugePage>
+bool operator!=(const mmap_allocator<T, HugePage>&, const mmap_allocator<T, HugePage>&) noexcept
+{
+  return false;
+}
+
+template <class T, bool HugePage>
+T* mmap_allocator<T, HugePage>::allocate(size_type n)
+{
+  if (n == 0)
+    return nullptr;
+  if (n > max_size())
+    throw std::bad_alloc();
+  const size_type bytes = n * sizeof(T);
+#ifdef MYSTL_HAS_MMAP
+  if (use_mmap(bytes))
+    return static_cast<T*>(map_pages(bytes));
+#endif
+  return static_cast<T*>(mystl::aligned_allocate(bytes, alignof(T)));
+}
+
+template <class T, bool HugePage>
+void mmap_allocator<T, HugePage>::deallocate(T* ptr, size_type n)
+{
+  if (ptr == nullptr)
+    return;
+#ifdef MYSTL_HAS_MMAP
+  const size_type bytes = n * sizeof(T);
+  if (use_mmap(bytes))
+  {
+    ::munmap(ptr, map_size(bytes));
+    return;
+  }
+#else
+  (void)n;
+#endif
+  mystl::aligned_deallocate(ptr, alignof(T));
+}
+
+template <class T, bool HugePage>
+T* mmap_allocator<T, HugePage>::reallocate(T* ptr, size_type old_n, size_type new_n)
+{
+  if (ptr == nullptr)
+    return allocate(new_n);
+  if (new_n > max_size())
+    throw std::bad_alloc();
+  const size_type old_bytes = old_n * sizeof(T);
+  const size_type new_bytes = new_n * sizeof(T);
+#ifdef MYSTL_HAS_MREMAP
+  if (use_mmap(old_bytes) && use_mmap(new_bytes))
+  { // 两块都是映射的内存，由 mremap 调整映射，不复制数据
+    const size_type old_len = map_size(old_bytes);
+    const size_type new_len = map_size(new_bytes);
+    if (old_len == new_len)
+      return ptr;
+    void* p = ::mremap(ptr, old_len, new_len, MREMAP_MAYMOVE);
+    if (p == MAP_FAILED)
+      throw std::bad_alloc();
+    if (new_len > old_len)
+      advise(p, new_len);
+    return static_cast<T*>(p);
+  }
+#endif
+  T* p = allocate(new_n);
+  // 复制的字节数直接取两块大小中较小的一个，编译器可以看出它不超过新空间的大小
+  const size_type copy_bytes = mystl::min(old_bytes, new_bytes);
+  if (copy_bytes != 0)
+    std::memcpy(static_cast<void*>(p), static_cast<const void*>(ptr), copy_bytes);
+  deallocate(ptr, old_n);
+  return p;
+}
+
+// 映射的大小：上调到页大小的整数倍，使用大页时上调到 2MB 的整数倍
+template <class T, bool HugePage>
+typename mmap_allocator<T, HugePage>::size_type
+mmap_allocator<T, HugePage>::map_size(size_type bytes) noexcept
+{
+#ifdef MYSTL_HAS_MMAP
+  static const size_type page = HugePage
+    ? static_cast<size_type>(EHugePageSize)
+    : static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+  return (bytes + page - 1) / page * page;
+#else
+  return bytes;
+#endif
+}
+
+template <class T, bool HugePage>
+void* mmap_allocator<T, HugePage>::map_pages(size_type bytes)
+{
+#ifdef MYSTL_HAS_MMAP
+  const size_type len = map_size(bytes);
+  void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED)
+    throw std::bad_alloc();
+  advise(p, len);
+  return p;
+#else
+  return ::operator new(bytes);
+#endif
+}
+
+// 请求透明大页，系统不支持时忽略
+template <class T, bool HugePage>
+void mmap_allocator<T, HugePage>::advise(void* p, size_type len) noexcept
+{
+#if defined(MYSTL_HAS_MMAP) && defined(MADV_HUGEPAGE)
+  if (HugePage)
+    ::madvise(p, len, MADV_HUGEPAGE);
+#else
+  (void)p;
+  (void)len;
+#endif
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_MMAP_ALLOCATOR_H_
@@ -0,0 +1,593 @@
+#ifndef MYTINYSTL_MPMC_QUEUE_H_
+#define MYTINYSTL_MPMC_QUEUE_H_
+
+// 这个头文件包含一个模板类 mpmc_queue
+// mpmc_queue : 多生产者多消费者的有界队列，非阻塞的操作不加锁，阻塞的操作在队列已满（已空）时等待
+
+// notes:
+//
+// 1. 每个格子带有一个序号，生产者、消费者各自用一次 CAS 抢占位置，之后只与该格子的序号同步：
+//      序号 == pos      : 格子空闲，可以放入第 pos 个元素
+//      序号 == pos + 1  : 第 pos 个元素已经放好，可以取出
+//    取出后序号变为 pos + capacity，留给下一圈的生产者（Dmitry Vyukov 的有界 MPMC 队列）
+// 2. 容量向上取整为 2 的幂且至少为 2：容量为 1 时放入后的序号 pos + 1 与下一次放入的 pos 相同，
+//    格子会被当作空闲而覆盖；入队、出队的位置各自占据一个缓存行，避免生产者与消费者之间的伪共享
+// 3. try_push、try_pop 等在队列已满（已空）时立即返回；push、pop 等先自旋重试
+//    MPMC_QUEUE_SPIN_COUNT 次，之后在条件变量上等待，由成功的操作唤醒
+// 4. 只有存在等待的线程时，成功的操作才会加锁并通知，非阻塞的路径上没有锁
+// 5. try_push_n、try_pop_n 用一次 CAS 抢占一段连续的位置，分摊抢占的开销；
+//    从 *first 构造元素可能抛出异常时，try_push_n 退化为逐个放入
+// 6. 元素必须可以不抛出异常地移动构造；可能抛出异常的构造先在格子之外完成，再移动到格子中
+// 7. empty、size 并发时只是某一时刻的近似值
+//
+// 异常保证：
+// mystl::mpmc_queue<T> 对 try_emplace、try_push、emplace、push 做强异常安全保证；
+// 把元素交给调用者时（pop、try_pop_n 等中的赋值）抛出异常，本批次中尚未交出的元素被丢弃，队列仍然有效
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+#include "aligned_allocator.h"
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// 阻塞的操作进入等待之前的重试次数
+#ifndef MPMC_QUEUE_SPIN_COUNT
+#define MPMC_QUEUE_SPIN_COUNT 64
+#endif
+
+// mpmc_queue 的格子
+template <class T>
+struct mpmc_queue_cell
+{
+  std::atomic<size_t>                                        seq;
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+  T* value() noexcept { return static_cast<T*>(static_cast<void*>(&storage)); }
+};
+
+// 模板类: mpmc_queue
+// 模板参数 T 代表类型，Alloc 代表空间配置器
+// 队列保存的是 rebind 到格子类型的配置器
+template <class T, class Alloc = mystl::allocator<T>>
+class mpmc_queue : private mystl::alloc_holder<
+  typename mystl::allocator_traits<Alloc>::template rebind_alloc<mpmc_queue_cell<T>>>
+{
+  static_assert(std::is_nothrow_move_constructible<T>::value,
+                "mpmc_queue requires a nothrow move constructible T");
+public:
+  // mpmc_queue 的嵌套型别定义
+  typedef Alloc                                    allocator_type;
+  typedef typename mystl::allocator_traits<Alloc>::template
+    rebind_alloc<mpmc_queue_cell<T>>               cell_allocator;
+  typedef mystl::allocator_traits<cell_allocator>  cell_alloc_traits;
+
+  typedef T                                        value_type;
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  allocator_type get_allocator() const { return allocator_type(this->get_alloc()); }
+
+private:
+  typedef mystl::alloc_holder<cell_allocator>      base_holder;
+  typedef mpmc_queue_cell<T>                       cell;
+
+  // 所有线程都只读的部分
+  cell*                   buf_;           // 格子数组
+  size_type               mask_;          // 容量 - 1
+  char                    pad0_[ECacheLineSize];
+
+  std::atomic<size_type>  enqueue_pos_;   // 下一个放入的位置
+  char                    pad1_[ECacheLineSize];
+
+  std::atomic<size_type>  dequeue_pos_;   // 下一个取出的位置
+  char                    pad2_[ECacheLineSize];
+
+  // 等待中的线程数，每次成功的操作都会读取，很少写入
+  std::atomic<size_type>  push_waiters_;
+  std::atomic<size_type>  pop_waiters_;
+  char                    pad3_[ECacheLineSize];
+
+  // 只在等待与通知时使用
+  std::mutex              mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+
+public:
+  // 构造、析构函数
+  explicit mpmc_queue(size_type capacity, const allocator_type& alloc = allocator_type());
+
+  mpmc_queue(const mpmc_queue&) = delete;
+  mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+  ~mpmc_queue();
+
+public:
+  // 非阻塞的操作，队列已满（已空）时返回 false 或 0
+
+  template <class ...Args>
+  bool      try_emplace(Args&& ...args);
+
+  bool      try_push(const value_type& value)
+  { return try_emplace(value); }
+  bool      try_push(value_type&& value)
+  { return try_emplace(mystl::move(value)); }
+
+  bool      try_pop(value_type& value);
+
+  // 从 first 开始最多放入 n 个元素，返回实际放入的个数
+  template <class InputIter>
+  size_type try_push_n(InputIter first, size_type n);
+
+  // 最多取出 n 个元素，依次赋值到 result，返回实际取出的个数
+  template <class OutputIter>
+  size_type try_pop_n(OutputIter result, size_type n);
+
+  // 阻塞的操作
+
+  template <class ...Args>
+  void      emplace(Args&& ...args);
+
+  void      push(const value_type& value)
+  { emplace(value); }
+  void      push(value_type&& value)
+  { emplace(mystl::move(value)); }
+
+  void      pop(value_type& value);
+
+  // 放入全部 n 个元素
+  template <class InputIter>
+  void      push_n(InputIter first, size_type n);
+
+  // 至少取出一个、最多取出 n 个元素，返回实际取出的个数
+  template <class OutputIter>
+  size_type pop_n(OutputIter result, size_type n);
+
+  // 容量相关操作，并发时 empty 与 size 只是近似值
+  bool      empty()    const noexcept
+  { return size() == 0; }
+  size_type size()     const noexcept;
+  size_type capacity() const noexcept
+  { return mask_ + 1; }
+  size_type max_size() const noexcept
+  { return cell_alloc_traits::max_size(this->get_alloc()); }
+
+  memory_usage_info memory_usage() const noexcept
+  {
+    const size_type n = size();
+    return memory_usage_info{ n * sizeof(T), capacity() * sizeof(cell) - n * sizeof(T) };
+  }
+
+private:
+  // helper functions
+
+  size_type round_capacity(size_type n) const;
+
+  // 抢占最多 want 个连续的位置，返回抢到的个数，pos 为第一个位置
+  size_type claim_push(size_type want, size_type& pos) noexcept;
+  size_type claim_pop(size_type want, size_type& pos) noexcept;
+
+  // 把格子交还给另一侧
+  void      publish_push(size_type pos) noexcept
+  { buf_[pos & mask_].seq.store(pos + 1, std::memory_order_release); }
+  void      release_pop(size_type pos) noexcept;
+
+  // 不通知等待线程的操作
+  template <class ...Args>
+  bool      do_emplace(Args&& ...args);
+  template <class ...Args>
+  bool      do_emplace_dispatch(m_true_type, Args&& ...args);
+  template <class ...Args>
+  bool      do_emplace_dispatch(m_false_type, Args&& ...args);
+  template <class InputIter>
+  size_type do_push_n(InputIter& first, size_type n);
+  template <class InputIter>
+  size_type do_push_n_dispatch(InputIter& first, size_type n, m_true_type);
+  template <class InputIter>
+  size_type do_push_n_dispatch(InputIter& first, size_type n, m_false_type);
+  template <class OutputIter>
+  size_type do_pop_n(OutputIter& result, size_type n);
+  template <class OutputIter>
+  size_type pop_notify(OutputIter& result, size_type n, bool wait);
+
+  template <class ...Args>
+  void      emplace_dispatch(m_true_type, Args&& ...args);
+  template <class ...Args>
+  void      emplace_dispatch(m_false_type, Args&& ...args);
+
+  // 等待与通知
+  template <class Op>
+  size_type wait_until(std::atomic<size_type>& waiters, std::condition_variable& cv, Op op);
+  void      notify(std::atomic<size_type>& waiters, std::condition_variable& cv, size_type k);
+};
+
+/*****************************************************************************************/
+
+// 构造函数，第 i 个格子的序号为 i
+template <class T, class Alloc>
+mpmc_queue<T, Alloc>::mpmc_queue(size_type capacity, const allocator_type& alloc)
+  :base_holder(cell_allocator(alloc)), buf_(nullptr), mask_(0), enqueue_pos_(0),
+  dequeue_pos_(0), push_waiters_(0), pop_waiters_(0)
+{
+  const size_type cap = round_capacity(capacity);
+  buf_ = cell_alloc_traits::allocate(this->get_alloc(), cap);
+  for (size_type i = 0; i < cap; ++i)
+  {
+    cell_alloc_traits::construct(this->get_alloc(), buf_ + i);
+    buf_[i].seq.store(i, std::memory_order_relaxed);
+  }
+  mask_ = cap - 1;
+}
+
+// 析构函数，此时不应再有其他线程访问队列
+template <class T, class Alloc>
+mpmc_queue<T, Alloc>::~mpmc_queue()
+{
+  const size_type last = enqueue_pos_.load(std::memory_order_relaxed);
+  for (size_type pos = dequeue_pos_.load(std::memory_order_relaxed); pos != last; ++pos)
+    mystl::destroy(buf_[pos & mask_].value());
+  cell_alloc_traits::deallocate(this->get_alloc(), buf_, capacity());
+}
+
+template <class T, class Alloc>
+template <class ...Args>
+bool mpmc_queue<T, Alloc>::try_emplace(Args&& ...args)
+{
+  if (!do_emplace(mystl::forward<Args>(args)...))
+    return false;
+  notify(pop_waiters_, not_empty_, 1);
+  return true;
+}
+
+template <class T, class Alloc>
+bool mpmc_queue<T, Alloc>::try_pop(value_type& value)
+{
+  pointer result = mystl::address_of(value);
+  return pop_notify(result, 1, false) != 0;
+}
+
+template <class T, class Alloc>
+template <class InputIter>
+typename mpmc_queue<T, Alloc>::size_type
+mpmc_queue<T, Alloc>::try_push_n(InputIter first, size_type n)
+{
+  const size_type k = do_push_n(first, n);
+  if (k != 0)
+    notify(pop_waiters_, not_empty_, k);
+  return k;
+}
+
+template <class T, class Alloc>
+template <class OutputIter>
+typename mpmc_queue<T, Alloc>::size_type
+mpmc_queue<T, Alloc>::try_pop_n(OutputIter result, size_type n)
+{
+  return pop_notify(result, n, false);
+}
+
+// 构造可能抛出异常时，先在格子之外构造好，等待期间不会重复构造
+template <class T, class Alloc>
+template <class ...Args>
+void mpmc_queue<T, Alloc>::emplace(Args&& ...args)
+{
+  emplace_dispatch(m_bool_constant<std::is_nothrow_constructible<T, Args...>::value>(),
+                   mystl::forward<Args>(args)...);
+}
+
+template <class T, class Alloc>
+void mpmc_queue<T, Alloc>::pop(value_type& value)
+{
+  pointer result = mystl::address_of(value);
+  pop_notify(result, 1, true);
+}
+
+template <class T, class Alloc>
+template <class InputIter>
+void mpmc_queue<T, Alloc>::push_n(InputIter first, size_type n)
+{
+  while (n != 0)
+  {
+    const size_type k = wait_until(push_waiters_, not_full_,
+                                   [&]() { return do_push_n(first, n); });
+    notify(pop_waiters_, not_empty_, k);
+    n -= k;
+  }
+}
+
+template <class T, class Alloc>
+template <class OutputIter>
+typename mpmc_queue<T, Alloc>::size_type
+mpmc_queue<T, Alloc>::pop_n(OutputIter result, size_type n)
+{
+  return n == 0 ? 0 : pop_notify(result, n, true);
+}
+
+// 先读出队位置再读入队位置，保证结果不会是负数
+template <class T, class Alloc>
+typename mpmc_queue<T, Alloc>::size_type
+mpmc_queue<T, Alloc>::size() const noexcept
+{
+  const size_type h = dequeue_pos_.load(std::memory_order_acquire);
+  const size_type t = enqueue_pos_.load(std::memory_order_acquire);
+  const size_type n = t - h;
+  return n < capacity() ? n : capacity();
+}
+
+/*****************************************************************************************/
+// helper function
+
+// 容量至少为 2，向上取整为 2 的幂
+template <class T, class Alloc>
+typename mpmc_queue<T, Alloc>::size_type
+mpmc_queue<T, Alloc>::round_capacity(size_type n) const
+{
+  THROW_LENGTH_ERROR_IF(n > max_size() / 2, "mpmc_queue<T>'s capacity too big");
+  size_type cap = 2;
+  while (cap < n)
+    cap <<= 1;
+  return cap;
+}
+
+// 第一个格子决定队列是否已满：序号落后于 pos 说明上一圈的元素还没有被取走，
+// 序号超前说明 pos 已经被别的生产者抢走，重新读取入队位置；
+// 之后的格子只要序号恰好等于各自的位置就一并抢占，遇到第一个不满足的就停下
+template <class T, class Alloc>
+typename mpmc_queue<T, Alloc>::size_type
+mpmc_queue<T, Alloc>::claim_push(size_type want, size_type& pos) noexcept
+{
+  pos = enqueue_pos_.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    const size_type seq = buf_[pos & mask_].seq.load(std::memory_order_acquire);
+    const difference_type dif = static_cast<difference_type>(seq - pos);
+    if (dif < 0)
+      return 0;
+    if (dif > 0)
+    {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+      continue;
+    }
+    size_type k = 1;
+    while (k < want && buf_[(pos + k) & mask_].seq.load(std::memory_order_acquire) == pos + k)
+      ++k;
+    if (enqueue_pos_.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed))
+      return k;
+  }
+}
+
+// 与 claim_push 对称，格子的序号为 pos + 1 时可以取出
+template <class T, class Alloc>
+typename mpmc_queue<T, Alloc>::size_type
+mpmc_queue<T, Alloc>::claim_pop(size_type want, size_type& pos) noexcept
+{
+  pos = dequeue_pos_.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    const size_type seq = buf_[pos & mask_].seq.load(std::memory_order_acquire);
+    const difference_type dif = static_cast<difference_type>(seq - (pos + 1));
+    if (dif < 0)
+      return 0;
+    if (dif > 0)
+    {
+      pos = dequeue_pos_.load(std::memory_order_relaxed);
+      continue;
+    }
+    size_type k = 1;
+    while (k < want &&
+           buf_[(pos + k) & mask_].seq.load(std::memory_order_acquire) == pos + k + 1)
+      ++k;
+    if (dequeue_pos_.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed))
+      return k;
+  }
+}
+
+// 析构取出后的元素，把格子留给下一圈的生产者
+template <class T, class Alloc>
+void mpmc_queue<T, Alloc>::release_pop(size_type pos) noexcept
+{
+  cell& c = buf_[pos & mask_];
+  mystl::destroy(c.value());
+  c.seq.store(pos + capacity(), std::memory_order_release);
+}
+
+template <class T, class Alloc>
+template <class ...Args>
+bool mpmc_queue<T, Alloc>::do_emplace(Args&& ...args)
+{
+  return do_emplace_dispatch(m_bool_constant<std::is_nothrow_constructible<T, Args...>::value>(),
+                             mystl::forward<Args>(args)...);
+}
+
+// 构造不会抛出异常：抢到位置之后直接在格子中构造
+template <class T, class Alloc>
+template <class ...Args>
+bool mpmc_queue<T, Alloc>::do_emplace_dispatch(m_true_type, Args&& ...args)
+{
+  size_type pos;
+  if (claim_push(1, pos) == 0)
+    return false;
+  mystl::construct(buf_[pos & mask_].value(), mystl::forward<Args>(args)...);
+  publish_push(pos);
+  return true;
+}
+
+// 构造可能抛出异常：已经抢占的位置无法退回，先在格子之外构造好再移动进去
+template <class T, class Alloc>
+template <class ...Args>
+bool mpmc_queue<T, Alloc>::do_emplace_dispatch(m_false_type, Args&& ...args)
+{
+  value_type tmp(mystl::forward<Args>(args)...);
+  return do_emplace_dispatch(m_true_type(), mystl::move(tmp));
+}
+
+template <class T, class Alloc>
+template <class InputIter>
+typename mpmc_queue<T, Alloc>::size_type
+mpmc_queue<T, Alloc>::do_push_n(InputIter& first, size_type n)
+{
+  return do_push_n_dispatch(first, n, m_bool_constant<
+    std::is_nothrow_constructible<T, decltype(*first)>::value>());
+}
+
+// 构造不会抛出异常：一次抢占一段位置，逐个构造并交给消费者
+template <class T, class Alloc>
+template <class InputIter>
+typename mpmc_queue<T, Alloc>::size_type
+mpmc_queue<T, Alloc>::do_push_n_dispatch(InputIter& first, size_type n, m_true_type)
+{
+  size_type pos;
+  const size_type k = n == 0 ? 0 : claim_push(n, pos);
+  for (size_type i = 0; i < k; ++i, ++first)
+  {
+    mystl::construct(buf_[(pos + i) & mask_].value(), *first);
+    publish_push(pos + i);
+  }
+  return k;
+}
+
+// 构造可能抛出异常：逐个放入，每个元素先在格子之外构造
+template <class T, class Alloc>
+template <class InputIter>
+typename mpmc_queue<T, Alloc>::size_type
+mpmc_queue<T, Alloc>::do_push_n_dispatch(InputIter& first, size_type n, m_false_type)
+{
+  size_type k = 0;
+  for (; k < n; ++k, ++first)
+  {
+    if (!do_emplace(*first))
+      break;
+  }
+  return k;
+}
+
+// 赋值抛出异常时，把本批次剩余的格子析构并交还
+template <class T, class Alloc>
+template <class OutputIter>
+typename mpmc_queue<T, Alloc>::size_type
+mpmc_queue<T, Alloc>::do_pop_n(OutputIter& result, size_type n)
+{
+  size_type pos;
+  const size_type k = n == 0 ? 0 : claim_pop(n, pos);
+  size_type i = 0;
+  try
+  {
+    for (; i < k; ++i)
+    {
+      *result = mystl::move(*buf_[(pos + i) & mask_].value());
+      ++result;
+      release_pop(pos + i);
+    }
+  }
+  catch (...)
+  {
+    for (; i < k; ++i)
+      release_pop(pos + i);
+    throw;
+  }
+  return k;
+}
+
+// 取出元素后唤醒等待放入的线程；赋值抛出异常时格子同样已经交还，也要唤醒
+template <class T, class Alloc>
+template <class OutputIter>
+typename mpmc_queue<T, Alloc>::size_type
+mpmc_queue<T, Alloc>::pop_notify(OutputIter& result, size_type n, bool wait)
+{
+  size_type k = 0;
+  try
+  {
+    k = wait ? wait_until(pop_waiters_, not_empty_, [&]() { return do_pop_n(result, n); })
+             : do_pop_n(result, n);
+  }
+  catch (...)
+  {
+    notify(push_waiters_, not_full_, capacity());
+    throw;
+  }
+  if (k != 0)
+    notify(push_waiters_, not_full_, k);
+  return k;
+}
+
+template <class T, class Alloc>
+template <class ...Args>
+void mpmc_queue<T, Alloc>::emplace_dispatch(m_true_type, Args&& ...args)
+{
+  wait_until(push_waiters_, not_full_, [&]() {
+    return do_emplace(mystl::forward<Args>(args)...) ? size_type(1) : size_type(0);
+  });
+  notify(pop_waiters_, not_empty_, 1);
+}
+
+template <class T, class Alloc>
+template <class ...Args>
+void mpmc_queue<T, Alloc>::emplace_dispatch(m_false_type, Args&& ...args)
+{
+  value_type tmp(mystl::forward<Args>(args)...);
+  emplace_dispatch(m_true_type(), mystl::move(tmp));
+}
+
+// 先自旋重试，再登记为等待线程并在条件变量上等待；
+// 登记之后的 seq_cst 栅栏与 notify 中的栅栏配对，保证要么重试时看到对方的结果，要么对方看到等待线程
+template <class T, class Alloc>
+template <class Op>
+typename mpmc_queue<T, Alloc>::size_type
+mpmc_queue<T, Alloc>::wait_until(std::atomic<size_type>& waiters, std::condition_variable& cv,
+                                 Op op)
+{
+  for (int i = 0; i < MPMC_QUEUE_SPIN_COUNT; ++i)
+  {
+    const size_type k = op();
+    if (k != 0)
+      return k;
+    std::this_thread::yield();
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  waiters.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  size_type k = 0;
+  try
+  {
+    while ((k = op()) == 0)
+      cv.wait(lock);
+  }
+  catch (...)
+  {
+    waiters.fetch_sub(1, std::memory_order_relaxed);
+    throw;
+  }
+  waiters.fetch_sub(1, std::memory_order_relaxed);
+  return k;
+}
+
+// 只有存在等待线程时才加锁，加锁保证通知不会落在等待线程重试与进入等待之间
+template <class T, class Alloc>
+void mpmc_queue<T, Alloc>::notify(std::atomic<size_type>& waiters, std::condition_variable& cv,
+                                  size_type k)
+{
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (waiters.load(std::memory_order_relaxed) == 0)
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+  }
+  if (k == 1)
+    cv.notify_one();
+  else
+    cv.notify_all();
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_MPMC_QUEUE_H_
@@ -0,0 +1,443 @@
+#ifndef MYTINYSTL_NODE_POOL_H_
+#define MYTINYSTL_NODE_POOL_H_
+
+// 这个头文件包含两个模板类，供节点容器以 slab 为单位管理节点
+//
+// node_pool         : rb_tree、hashtable 使用，slab 属于容器，clear 时整体归还
+// counted_node_pool : list 使用，节点可以随 splice 转移到另一个 list，slab 按尚未归还的节点计数
+
+// notes:
+//
+// 1. 每个容器拥有自己的 node_pool，节点不是逐个向配置器申请，而是一次申请一个 slab（一段连续的节点），
+//    slab 的节点数从 8 开始翻倍，最多 64 个，相邻插入的节点在内存中也相邻，遍历时局部性更好
+// 2. 删除的节点挂在侵入式的自由链表上，之后插入的节点优先复用它们，不会归还配置器
+// 3. 容器 clear 或析构时，整个 slab 一次性归还配置器，此时池中不能再有存活的节点
+// 4. node_pool 不保存配置器，slab 的申请与释放都使用容器传入的配置器，
+//    因此容器的配置器发生传播（移动、交换）时，node_pool 必须随之移动、交换
+// 5. list 的 splice 可以把单个节点转移到另一个 list，node_pool 的 slab 不能随之转移，因此 list 使用 counted_node_pool：
+//    每个节点记录自己所在的 slab，slab 头部保存尚未归还的节点数（包括池中空闲的节点），
+//    哪个池把计数减为零，就由哪个池释放这个 slab，splice 不需要移动元素，也不会使迭代器失效
+// 6. 节点归还（release）时才修改 slab 的计数，计数是原子变量，两个 list 可以在不同的线程中各自释放同一个 slab 的节点；
+//    释放 slab 使用当前容器的配置器，splice 本来就要求两个 list 的配置器相等
+// 7. 批量插入已知个数的节点时使用 counted_node_pool::allocate_run，n 个节点取自同一个 slab 并且依次相邻，
+//    需要时单独申请一个恰好容纳它们的 slab，不受 EMaxSlabNodes 的限制
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+#include "allocator.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// 模板类 : node_pool
+// 参数一代表节点类型，参数二代表 rebind 到节点类型的配置器
+template <class Node, class NodeAlloc>
+class node_pool
+{
+public:
+  typedef Node                                node_type;
+  typedef NodeAlloc                           allocator_type;
+  typedef mystl::allocator_traits<NodeAlloc>  alloc_traits;
+  typedef size_t                              size_type;
+
+private:
+  // slab 的第一个节点位置用来保存 slab 的信息
+  struct slab
+  {
+    slab*     next;
+    size_type count;  // 不含头部的节点数
+  };
+
+  // 自由链表中的节点
+  struct free_node
+  {
+    free_node* next;
+  };
+
+  static_assert(sizeof(Node) >= sizeof(slab), "node is too small for node_pool");
+
+  enum { EMinSlabNodes = 8, EMaxSlabNodes = 64 };
+
+  slab*      slabs_;       // 所有 slab 串成的单向链表
+  free_node* free_;        // 回收节点的自由链表
+  Node*      cur_;         // 最近一个 slab 中尚未使用的节点 [cur_, end_)
+  Node*      end_;
+  size_type  next_count_;  // 下一个 slab 的节点数
+
+public:
+  node_pool() noexcept
+    :slabs_(nullptr), free_(nullptr), cur_(nullptr), end_(nullptr), next_count_(EMinSlabNodes)
+  {
+  }
+
+  node_pool(node_pool&& rhs) noexcept
+    :slabs_(rhs.slabs_), free_(rhs.free_), cur_(rhs.cur_), end_(rhs.end_),
+    next_count_(rhs.next_count_)
+  {
+    rhs.reset();
+  }
+
+  node_pool(const node_pool&) = delete;
+  node_pool& operator=(const node_pool&) = delete;
+
+  // 析构前必须已经用容器的配置器调用 release
+  ~node_pool() { MYSTL_DEBUG(slabs_ == nullptr); }
+
+public:
+  Node* allocate(NodeAlloc& a);
+  void  deallocate(Node* p) noexcept;
+
+  // 把所有 slab 归还配置器
+  void  release(NodeAlloc& a) noexcept;
+
+  // 接管 rhs 的全部 slab，rhs 的节点随后属于本池
+  void  merge(node_pool& rhs) noexcept;
+
+  void  swap(node_pool& rhs) noexcept;
+
+  size_type slab_count() const noexcept;
+
+  // 所有 slab 占用的字节数，包括 slab 头部与尚未使用的节点
+  size_type allocated_bytes() const noexcept;
+
+private:
+  void  new_slab(NodeAlloc& a, size_type n);
+
+  void  reset() noexcept
+  {
+    slabs_ = nullptr;
+    free_ = nullptr;
+    cur_ = nullptr;
+    end_ = nullptr;
+    next_count_ = EMinSlabNodes;
+  }
+};
+
+/*****************************************************************************************/
+
+// 分配一个节点，优先使用自由链表，其次使用最近一个 slab 的剩余部分
+template <class Node, class NodeAlloc>
+Node* node_pool<Node, NodeAlloc>::allocate(NodeAlloc& a)
+{
+  if (free_ != nullptr)
+  {
+    free_node* p = free_;
+    free_ = p->next;
+    return reinterpret_cast<Node*>(p);
+  }
+  if (cur_ == end_)
+    new_slab(a, next_count_);
+  return cur_++;
+}
+
+// 回收一个节点，节点上的元素必须已经析构
+template <class Node, class NodeAlloc>
+void node_pool<Node, NodeAlloc>::deallocate(Node* p) noexcept
+{
+  free_node* f = reinterpret_cast<free_node*>(p);
+  f->next = free_;
+  free_ = f;
+}
+
+template <class Node, class NodeAlloc>
+void node_pool<Node, NodeAlloc>::release(NodeAlloc& a) noexcept
+{
+  while (slabs_ != nullptr)
+  {
+    slab* next = slabs_->next;
+    alloc_traits::deallocate(a, reinterpret_cast<Node*>(slabs_), slabs_->count + 1);
+    slabs_ = next;
+  }
+  reset();
+}
+
+// rhs 最近一个 slab 中未使用的节点放入本池的自由链表
+template <class Node, class NodeAlloc>
+void node_pool<Node, NodeAlloc>::merge(node_pool& rhs) noexcept
+{
+  if (this == &rhs || rhs.slabs_ == nullptr)
+    return;
+  for (; rhs.cur_ != rhs.end_; ++rhs.cur_)
+    rhs.deallocate(rhs.cur_);
+  slab* last = rhs.slabs_;
+  while (last->next != nullptr)
+    last = last->next;
+  last->next = slabs_;
+  slabs_ = rhs.slabs_;
+  if (rhs.free_ != nullptr)
+  {
+    free_node* tail = rhs.free_;
+    while (tail->next != nullptr)
+      tail = tail->next;
+    tail->next = free_;
+    free_ = rhs.free_;
+  }
+  if (next_count_ < rhs.next_count_)
+    next_count_ = rhs.next_count_;
+  rhs.reset();
+}
+
+template <class Node, class NodeAlloc>
+void node_pool<Node, NodeAlloc>::swap(node_pool& rhs) noexcept
+{
+  mystl::swap(slabs_, rhs.slabs_);
+  mystl::swap(free_, rhs.free_);
+  mystl::swap(cur_, rhs.cur_);
+  mystl::swap(end_, rhs.end_);
+  mystl::swap(next_count_, rhs.next_count_);
+}
+
+template <class Node, class NodeAlloc>
+typename node_pool<Node, NodeAlloc>::size_type
+node_pool<Node, NodeAlloc>::slab_count() const noexcept
+{
+  size_type n = 0;
+  for (slab* s = slabs_; s != nullptr; s = s->next)
+    ++n;
+  return n;
+}
+
+template <class Node, class NodeAlloc>
+typename node_pool<Node, NodeAlloc>::size_type
+node_pool<Node, NodeAlloc>::allocated_bytes() const noexcept
+{
+  size_type n = 0;
+  for (slab* s = slabs_; s != nullptr; s = s->next)
+    n += s->count + 1;
+  return n * sizeof(Node);
+}
+
+// 申请一个有 n 个节点的新 slab，之后的 slab 节点数翻倍直到 EMaxSlabNodes
+template <class Node, class NodeAlloc>
+void node_pool<Node, NodeAlloc>::new_slab(NodeAlloc& a, size_type n)
+{
+  Node* p = alloc_traits::allocate(a, n + 1);
+  slab* s = reinterpret_cast<slab*>(p);
+  s->next = slabs_;
+  s->count = n;
+  slabs_ = s;
+  cur_ = p + 1;
+  end_ = p + 1 + n;
+  if (next_count_ < static_cast<size_type>(EMaxSlabNodes))
+    next_count_ *= 2;
+}
+
+/*****************************************************************************************/
+
+// 模板类 : counted_node_pool
+// 参数一代表节点类型，参数二代表 rebind 到节点类型的配置器
+// 节点类型需要一个 void* 类型的成员 chunk 保存所在的 slab，它不能位于节点开头，开头的指针用作自由链表的链接
+template <class Node, class NodeAlloc>
+class counted_node_pool
+{
+public:
+  typedef Node                                node_type;
+  typedef NodeAlloc                           allocator_type;
+  typedef mystl::allocator_traits<NodeAlloc>  alloc_traits;
+  typedef size_t                              size_type;
+
+private:
+  // slab 的第一个节点位置用来保存 slab 的信息
+  struct slab
+  {
+    std::atomic<size_type> live;   // 尚未归还的节点数
+    size_type              count;  // 不含头部的节点数
+  };
+
+  // 自由链表中的节点
+  struct free_node
+  {
+    free_node* next;
+  };
+
+  static_assert(sizeof(Node) >= sizeof(slab), "node is too small for counted_node_pool");
+
+  enum { EMinSlabNodes = 8, EMaxSlabNodes = 64 };
+
+  free_node* free_;        // 回收节点的自由链表，节点仍然计入各自 slab 的 live
+  slab*      slab_;        // 最近一个 slab
+  Node*      cur_;         // 最近一个 slab 中尚未使用的节点 [cur_, end_)
+  Node*      end_;
+  size_type  idle_;        // 自由链表中的节点数
+  size_type  slabs_;       // 上次 release 之后本池申请的 slab 数
+  size_type  next_count_;  // 下一个 slab 的节点数
+
+public:
+  counted_node_pool() noexcept
+    :free_(nullptr), slab_(nullptr), cur_(nullptr), end_(nullptr),
+    idle_(0), slabs_(0), next_count_(EMinSlabNodes)
+  {
+  }
+
+  counted_node_pool(counted_node_pool&& rhs) noexcept
+    :free_(rhs.free_), slab_(rhs.slab_), cur_(rhs.cur_), end_(rhs.end_),
+    idle_(rhs.idle_), slabs_(rhs.slabs_), next_count_(rhs.next_count_)
+  {
+    rhs.reset();
+  }
+
+  counted_node_pool(const counted_node_pool&) = delete;
+  counted_node_pool& operator=(const counted_node_pool&) = delete;
+
+  // 析构前必须已经用容器的配置器调用 release
+  ~counted_node_pool() { MYSTL_DEBUG(free_ == nullptr && cur_ == end_); }
+
+public:
+  Node* allocate(NodeAlloc& a);
+  void  deallocate(Node* p) noexcept;
+
+  // 分配 n 个连续的节点 [p, p + n)，不使用自由链表，供容器批量插入
+  Node* allocate_run(NodeAlloc& a, size_type n);
+
+  // 归还自由链表与最近一个 slab 中未使用的节点，计数减为零的 slab 交还配置器
+  void  release(NodeAlloc& a) noexcept;
+
+  void  swap(counted_node_pool& rhs) noexcept;
+
+  // 池中空闲的节点数
+  size_type idle_count() const noexcept
+  { return idle_ + static_cast<size_type>(end_ - cur_); }
+
+  // 本池申请的 slab 头部占用的字节数
+  size_type header_bytes() const noexcept
+  { return slabs_ * sizeof(Node); }
+
+private:
+  void  new_slab(NodeAlloc& a, size_type n);
+  static void put(NodeAlloc& a, slab* s, size_type n) noexcept;
+
+  static slab* slab_of(Node* p) noexcept
+  { return static_cast<slab*>(p->chunk); }
+
+  void  reset() noexcept
+  {
+    free_ = nullptr;
+    slab_ = nullptr;
+    cur_ = nullptr;
+    end_ = nullptr;
+    idle_ = 0;
+    slabs_ = 0;
+    next_count_ = EMinSlabNodes;
+  }
+};
+
+/*****************************************************************************************/
+
+// 分配一个节点，优先使用自由链表，其次使用最近一个 slab 的剩余部分
+template <class Node, class NodeAlloc>
+Node* counted_node_pool<Node, NodeAlloc>::allocate(NodeAlloc& a)
+{
+  if (free_ != nullptr)
+  {
+    free_node* p = free_;
+    free_ = p->next;
+    --idle_;
+    return reinterpret_cast<Node*>(p);
+  }
+  if (cur_ == end_)
+    new_slab(a, next_count_);
+  cur_->chunk = slab_;
+  return cur_++;
+}
+
+// 最近一个 slab 剩余的节点不够时，放入自由链表，再申请一个至少有 n 个节点的 slab
+template <class Node, class NodeAlloc>
+Node* counted_node_pool<Node, NodeAlloc>::allocate_run(NodeAlloc& a, size_type n)
+{
+  if (static_cast<size_type>(end_ - cur_) < n)
+  {
+    for (; cur_ != end_; ++cur_)
+    {
+      cur_->chunk = slab_;
+      deallocate(cur_);
+    }
+    new_slab(a, n > next_count_ ? n : next_count_);
+  }
+  Node* p = cur_;
+  for (; cur_ != p + n; ++cur_)
+    cur_->chunk = slab_;
+  return p;
+}
+
+// 回收一个节点，节点上的元素必须已经析构，节点可以来自另一个池
+template <class Node, class NodeAlloc>
+void counted_node_pool<Node, NodeAlloc>::deallocate(Node* p) noexcept
+{
+  free_node* f = reinterpret_cast<free_node*>(p);
+  f->next = free_;
+  free_ = f;
+  ++idle_;
+}
+
+// 自由链表中相邻的节点通常来自同一个 slab，合并起来一次修改计数
+template <class Node, class NodeAlloc>
+void counted_node_pool<Node, NodeAlloc>::release(NodeAlloc& a) noexcept
+{
+  slab* s = nullptr;
+  size_type n = 0;
+  while (free_ != nullptr)
+  {
+    slab* fs = slab_of(reinterpret_cast<Node*>(free_));
+    free_ = free_->next;
+    if (fs != s)
+    {
+      if (n != 0)
+        put(a, s, n);
+      s = fs;
+      n = 0;
+    }
+    ++n;
+  }
+  if (n != 0)
+    put(a, s, n);
+  if (cur_ != end_)
+    put(a, slab_, static_cast<size_type>(end_ - cur_));
+  reset();
+}
+
+template <class Node, class NodeAlloc>
+void counted_node_pool<Node, NodeAlloc>::swap(counted_node_pool& rhs) noexcept
+{
+  mystl::swap(free_, rhs.free_);
+  mystl::swap(slab_, rhs.slab_);
+  mystl::swap(cur_, rhs.cur_);
+  mystl::swap(end_, rhs.end_);
+  mystl::swap(idle_, rhs.idle_);
+  mystl::swap(slabs_, rhs.slabs_);
+  mystl::swap(next_count_, rhs.next_count_);
+}
+
+// 申请一个有 n 个节点的新 slab，全部节点先计入 live，之后的 slab 节点数翻倍直到 EMaxSlabNodes
+template <class Node, class NodeAlloc>
+void counted_node_pool<Node, NodeAlloc>::new_slab(NodeAlloc& a, size_type n)
+{
+  Node* p = alloc_traits::allocate(a, n + 1);
+  slab* s = ::new (static_cast<void*>(p)) slab;
+  s->live.store(n, std::memory_order_relaxed);
+  s->count = n;
+  slab_ = s;
+  cur_ = p + 1;
+  end_ = p + 1 + n;
+  ++slabs_;
+  if (next_count_ < static_cast<size_type>(EMaxSlabNodes))
+    next_count_ *= 2;
+}
+
+// 归还 slab s 中的 n 个节点，计数减为零时释放 slab
+template <class Node, class NodeAlloc>
+void counted_node_pool<Node, NodeAlloc>::put(NodeAlloc& a, slab* s, size_type n) noexcept
+{
+  if (s->live.fetch_sub(n, std::memory_order_acq_rel) == n)
+  {
+    const size_type count = s->count;
+    s->~slab();
+    alloc_traits::deallocate(a, reinterpret_cast<Node*>(s), count + 1);
+  }
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_NODE_POOL_H_
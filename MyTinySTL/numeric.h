@@ -46,10 +46,10 @@ OutputIter adjacent_difference(InputIter first, InputIter last, OutputIter resul
 {
   if (first == last)  return result;
   *result = *first;  // 记录第一个元素
-  auto value = *first;
+  typename iterator_traits<InputIter>::value_type value = *first;
   while (++first != last)
   {
-    auto tmp = *first;
+    typename iterator_traits<InputIter>::value_type tmp = *first;
     *++result = tmp - value;
     value = tmp;
   }
@@ -63,10 +63,10 @@ OutputIter adjacent_difference(InputIter first, InputIter last, OutputIter resul
 {
   if (first == last)  return result;
   *result = *first;  // 记录第一个元素
-  auto value = *first;
+  typename iterator_traits<InputIter>::value_type value = *first;
   while (++first != last)
   {
-    auto tmp = *first;
+    typename iterator_traits<InputIter>::value_type tmp = *first;
     *++result = binary_op(tmp, value);
     value = tmp;
   }
@@ -125,7 +125,7 @@ OutputIter partial_sum(InputIter first, InputIter last, OutputIter result)
 {
   if (first == last)  return result;
   *result = *first;  // 记录第一个元素
-  auto value = *first;
+  typename iterator_traits<InputIter>::value_type value = *first;
   while (++first != last)
   {
     value = value + *first;
@@ -141,7 +141,7 @@ OutputIter partial_sum(InputIter first, InputIter last, OutputIter result,
 {
   if (first == last)  return result;
   *result = *first;  //记录第一个元素
-  auto value = *first;
+  typename iterator_traits<InputIter>::value_type value = *first;
   while (++first != last)
   {
     value = binary_op(value, *first);
@@ -0,0 +1,76 @@
+#ifndef MYTINYSTL_PMR_H_
+#define MYTINYSTL_PMR_H_
+
+// 这个头文件为各个容器提供 mystl::pmr 名字空间下的别名，容器以 polymorphic_allocator 为配置器
+//
+// 例如请求处理中需要大量临时的 map 与 string 时：
+//
+//   mystl::pmr::monotonic_buffer_resource arena;
+//   mystl::pmr::map<mystl::pmr::string, int> m(&arena);
+//   ...
+//   arena.release();  // 全部内存一次性释放，无需逐个回收
+//
+// 注意：以 monotonic_buffer_resource 为资源时，容器析构仍会逐个调用元素的析构函数，
+// 但回收内存是空操作
+
+#include "memory_resource.h"
+#include "vector.h"
+#include "list.h"
+#include "deque.h"
+#include "map.h"
+#include "set.h"
+#include "unordered_map.h"
+#include "unordered_set.h"
+#include "astring.h"
+
+namespace mystl
+{
+namespace pmr
+{
+
+template <class T>
+using vector = mystl::vector<T, polymorphic_allocator<T>>;
+
+template <class T>
+using list = mystl::list<T, polymorphic_allocator<T>>;
+
+template <class T>
+using deque = mystl::deque<T, polymorphic_allocator<T>>;
+
+template <class Key, class T, class Compare = mystl::less<Key>>
+using map = mystl::map<Key, T, Compare, polymorphic_allocator<mystl::pair<const Key, T>>>;
+
+template <class Key, class T, class Compare = mystl::less<Key>>
+using multimap = mystl::multimap<Key, T, Compare, polymorphic_allocator<mystl::pair<const Key, T>>>;
+
+template <class Key, class Compare = mystl::less<Key>>
+using set = mystl::set<Key, Compare, polymorphic_allocator<Key>>;
+
+template <class Key, class Compare = mystl::less<Key>>
+using multiset = mystl::multiset<Key, Compare, polymorphic_allocator<Key>>;
+
+template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+using unordered_map = mystl::unordered_map<Key, T, Hash, KeyEqual,
+                                           polymorphic_allocator<mystl::pair<const Key, T>>>;
+
+template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+using unordered_multimap = mystl::unordered_multimap<Key, T, Hash, KeyEqual,
+                                                     polymorphic_allocator<mystl::pair<const Key, T>>>;
+
+template <class Key, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+using unordered_set = mystl::unordered_set<Key, Hash, KeyEqual, polymorphic_allocator<Key>>;
+
+template <class Key, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+using unordered_multiset = mystl::unordered_multiset<Key, Hash, KeyEqual, polymorphic_allocator<Key>>;
+
+template <class CharType, class CharTraits = mystl::char_traits<CharType>>
+using basic_string = mystl::basic_string<CharType, CharTraits, polymorphic_allocator<CharType>>;
+
+using string    = pmr::basic_string<char>;
+using wstring   = pmr::basic_string<wchar_t>;
+using u16string = pmr::basic_string<char16_t>;
+using u32string = pmr::basic_string<char32_t>;
+
+} // namespace pmr
+} // namespace mystl
+#endif // !MYTINYSTL_PMR_H_
@@ -11,6 +11,7 @@
 #include "functional.h"
 #include "iterator.h"
 #include "memory.h"
+#include "node_pool.h"
 #include "type_traits.h"
 #include "exceptdef.h"
 
@@ -707,9 +708,11 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root, NodePtr& leftmost, Nod
 }
 
 // 模板类 rb_tree
-// 参数一代表数据类型，参数二代表键值比较类型
-template <class T, class Compare>
-class rb_tree
+// 参数一代表数据类型，参数二代表键值比较类型，参数三代表空间配置器
+// 容器保存的是 rebind 到节点类型的配置器
+template <class T, class Compare, class Alloc = mystl::allocator<T>>
+class rb_tree : private mystl::alloc_holder<
+  typename mystl::allocator_traits<Alloc>::template rebind_alloc<rb_tree_node<T>>>
 {
 public:
   // rb_tree 的嵌套型别定义 
@@ -726,32 +729,39 @@ public:
   typedef typename tree_traits::value_type         value_type;
   typedef Compare                                  key_compare;
 
-  typedef mystl::allocator<T>                      allocator_type;
-  typedef mystl::allocator<T>                      data_allocator;
-  typedef mystl::allocator<base_type>              base_allocator;
-  typedef mystl::allocator<node_type>              node_allocator;
-
-  typedef typename allocator_type::pointer         pointer;
-  typedef typename allocator_type::const_pointer   const_pointer;
-  typedef typename allocator_type::reference       reference;
-  typedef typename allocator_type::const_reference const_reference;
-  typedef typename allocator_type::size_type       size_type;
-  typedef typename allocator_type::difference_type difference_type;
+  typedef Alloc                                    allocator_type;
+  typedef typename mystl::allocator_traits<Alloc>::template
+    rebind_alloc<base_type>                        base_allocator;
+  typedef typename mystl::allocator_traits<Alloc>::template
+    rebind_alloc<node_type>                        node_allocator;
+  typedef mystl::allocator_traits<base_allocator>  base_alloc_traits;
+  typedef mystl::allocator_traits<node_allocator>  node_alloc_traits;
+
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
 
   typedef rb_tree_iterator<T>                      iterator;
   typedef rb_tree_const_iterator<T>                const_iterator;
   typedef mystl::reverse_iterator<iterator>        reverse_iterator;
   typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
 
-  allocator_type get_allocator() const { return node_allocator(); }
+  allocator_type get_allocator() const { return allocator_type(this->get_alloc()); }
   key_compare    key_comp()      const { return key_comp_; }
 
 private:
+  typedef mystl::alloc_holder<node_allocator>      base_holder;
+
   // 用以下三个数据表现 rb tree
   base_ptr    header_;      // 特殊节点，与根节点互为对方的父节点
   size_type   node_count_;  // 节点数
   key_compare key_comp_;    // 节点键值比较的准则
 
+  mystl::node_pool<rb_tree_node<T>, node_allocator> pool_;  // 节点池
+
 private:
   // 以下三个函数用于取得根节点，最小节点和最大节点
   base_ptr& root()      const { return header_->parent; }
@@ -762,13 +772,26 @@ public:
   // 构造、复制、析构函数
   rb_tree() { rb_tree_init(); }
 
+  explicit rb_tree(const key_compare& comp, const allocator_type& alloc = allocator_type())
+    :base_holder(node_allocator(alloc)), key_comp_(comp)
+  { rb_tree_init(); }
+
   rb_tree(const rb_tree& rhs);
+  rb_tree(const rb_tree& rhs, const allocator_type& alloc);
   rb_tree(rb_tree&& rhs) noexcept;
+  rb_tree(rb_tree&& rhs, const allocator_type& alloc);
 
   rb_tree& operator=(const rb_tree& rhs);
-  rb_tree& operator=(rb_tree&& rhs);
+  rb_tree& operator=(rb_tree&& rhs) noexcept(alloc_move_steals<node_allocator>::value);
 
-  ~rb_tree() { clear(); }
+  ~rb_tree()
+  {
+    if (header_ != nullptr)
+    {
+      clear();
+      destroy_header();
+    }
+  }
 
 public:
   // 迭代器相关操作
@@ -806,6 +829,14 @@ public:
   size_type size()     const noexcept { return node_count_; }
   size_type max_size() const noexcept { return static_cast<size_type>(-1); }
 
+  // 节点池中的全部 slab 与 header，节点中的指针、颜色和未使用的节点计入 overhead
+  memory_usage_info memory_usage() const noexcept
+  {
+    const size_type payload = node_count_ * sizeof(T);
+    const size_type header = header_ == nullptr ? 0 : sizeof(*header_);
+    return memory_usage_info{ payload, pool_.allocated_bytes() + header - payload };
+  }
+
   // 插入删除相关操作
 
   // emplace
@@ -961,79 +992,112 @@ private:
   // copy tree / erase tree
   base_ptr copy_from(base_ptr x, base_ptr p);
   void     erase_since(base_ptr x);
+  void     copy_tree(const rb_tree& rhs);
+
+  // header
+  void     destroy_header();
+
+  // move assign
+  void     move_assign(rb_tree& rhs, m_true_type);
+  void     move_assign(rb_tree& rhs, m_false_type);
 };
 
 /*****************************************************************************************/
 
 // 复制构造函数
-template <class T, class Compare>
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+rb_tree<T, Compare, Alloc>::
 rb_tree(const rb_tree& rhs)
+  :base_holder(node_alloc_traits::select_on_container_copy_construction(rhs.get_alloc())),
+  key_comp_(rhs.key_comp_)
 {
   rb_tree_init();
-  if (rhs.node_count_ != 0)
-  {
-    root() = copy_from(rhs.root(), header_);
-    leftmost() = rb_tree_min(root());
-    rightmost() = rb_tree_max(root());
-  }
-  node_count_ = rhs.node_count_;
-  key_comp_ = rhs.key_comp_;
+  copy_tree(rhs);
+}
+
+// 使用另一个配置器的复制构造函数
+template <class T, class Compare, class Alloc>
+rb_tree<T, Compare, Alloc>::
+rb_tree(const rb_tree& rhs, const allocator_type& alloc)
+  :base_holder(node_allocator(alloc)),
+  key_comp_(rhs.key_comp_)
+{
+  rb_tree_init();
+  copy_tree(rhs);
 }
 
 // 移动构造函数
-template <class T, class Compare>
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+rb_tree<T, Compare, Alloc>::
 rb_tree(rb_tree&& rhs) noexcept
-  :header_(mystl::move(rhs.header_)),
+  :base_holder(mystl::move(rhs.get_alloc())),
+  header_(mystl::move(rhs.header_)),
   node_count_(rhs.node_count_),
-  key_comp_(rhs.key_comp_)
+  key_comp_(rhs.key_comp_),
+  pool_(mystl::move(rhs.pool_))
 {
   rhs.reset();
 }
 
+// 使用另一个配置器的移动构造函数，配置器不相等时只能逐个移动元素
+template <class T, class Compare, class Alloc>
+rb_tree<T, Compare, Alloc>::
+rb_tree(rb_tree&& rhs, const allocator_type& alloc)
+  :base_holder(node_allocator(alloc)),
+  key_comp_(rhs.key_comp_)
+{
+  if (this->get_alloc() == rhs.get_alloc())
+  {
+    header_ = rhs.header_;
+    node_count_ = rhs.node_count_;
+    pool_.swap(rhs.pool_);
+    rhs.reset();
+  }
+  else
+  {
+    rb_tree_init();
+    move_assign(rhs, m_false_type());
+  }
+}
+
 // 复制赋值操作符
-template <class T, class Compare>
-rb_tree<T, Compare>& 
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+rb_tree<T, Compare, Alloc>& 
+rb_tree<T, Compare, Alloc>::
 operator=(const rb_tree& rhs)
 {
   if (this != &rhs)
   {
     clear();
-
-    if (rhs.node_count_ != 0)
-    {
-      root() = copy_from(rhs.root(), header_);
-      leftmost() = rb_tree_min(root());
-      rightmost() = rb_tree_max(root());
+    if (node_alloc_traits::propagate_on_container_copy_assignment::value &&
+        this->get_alloc() != rhs.get_alloc())
+    { // 配置器要随之复制，header 必须先用旧的配置器释放
+      destroy_header();
+      mystl::alloc_on_copy(this->get_alloc(), rhs.get_alloc());
+      rb_tree_init();
     }
-
-    node_count_ = rhs.node_count_;
+    copy_tree(rhs);
     key_comp_ = rhs.key_comp_;
   }
   return *this;
 }
 
 // 移动赋值操作符
-template <class T, class Compare>
-rb_tree<T, Compare>&
-rb_tree<T, Compare>::
-operator=(rb_tree&& rhs)
+template <class T, class Compare, class Alloc>
+rb_tree<T, Compare, Alloc>&
+rb_tree<T, Compare, Alloc>::
+operator=(rb_tree&& rhs) noexcept(alloc_move_steals<node_allocator>::value)
 {
-  clear();
-  header_ = mystl::move(rhs.header_);
-  node_count_ = rhs.node_count_;
-  key_comp_ = rhs.key_comp_;
-  rhs.reset();
+  if (this != &rhs)
+    move_assign(rhs, alloc_move_steals<node_allocator>());
   return *this;
 }
 
 // 就地插入元素，键值允许重复
-template <class T, class Compare>
+template <class T, class Compare, class Alloc>
 template <class ...Args>
-typename rb_tree<T, Compare>::iterator 
-rb_tree<T, Compare>::
+typename rb_tree<T, Compare, Alloc>::iterator 
+rb_tree<T, Compare, Alloc>::
 emplace_multi(Args&& ...args)
 {
   THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
@@ -1043,10 +1107,10 @@ emplace_multi(Args&& ...args)
 }
 
 // 就地插入元素，键值不允许重复
-template <class T, class Compare>
+template <class T, class Compare, class Alloc>
 template <class ...Args>
-mystl::pair<typename rb_tree<T, Compare>::iterator, bool> 
-rb_tree<T, Compare>::
+mystl::pair<typename rb_tree<T, Compare, Alloc>::iterator, bool> 
+rb_tree<T, Compare, Alloc>::
 emplace_unique(Args&& ...args)
 {
   THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
@@ -1061,10 +1125,10 @@ emplace_unique(Args&& ...args)
 }
 
 // 就地插入元素，键值允许重复，当 hint 位置与插入位置接近时，插入操作的时间复杂度可以降低
-template <class T, class Compare>
+template <class T, class Compare, class Alloc>
 template <class ...Args>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
 emplace_multi_use_hint(iterator hint, Args&& ...args)
 {
   THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
@@ -1102,10 +1166,10 @@ emplace_multi_use_hint(iterator hint, Args&& ...args)
 }
 
 // 就地插入元素，键值不允许重复，当 hint 位置与插入位置接近时，插入操作的时间复杂度可以降低
-template<class T, class Compare>
+template <class T, class Compare, class Alloc>
 template<class ...Args>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
 emplace_unique_use_hint(iterator hint, Args&& ...args)
 {
   THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
@@ -1153,9 +1217,9 @@ emplace_unique_use_hint(iterator hint, Args&& ...args)
 }
 
 // 插入元素，节点键值允许重复
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
 insert_multi(const value_type& value)
 {
   THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
@@ -1164,9 +1228,9 @@ insert_multi(const value_type& value)
 }
 
 // 插入新值，节点键值不允许重复，返回一个 pair，若插入成功，pair 的第二参数为 true，否则为 false
-template <class T, class Compare>
-mystl::pair<typename rb_tree<T, Compare>::iterator, bool>
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+mystl::pair<typename rb_tree<T, Compare, Alloc>::iterator, bool>
+rb_tree<T, Compare, Alloc>::
 insert_unique(const value_type& value)
 {
   THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
@@ -1179,9 +1243,9 @@ insert_unique(const value_type& value)
 }
 
 // 删除 hint 位置的节点
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
 erase(iterator hint)
 {
   auto node = hint.node->get_node_ptr();
@@ -1195,9 +1259,9 @@ erase(iterator hint)
 }
 
 // 删除键值等于 key 的元素，返回删除的个数
-template <class T, class Compare>
-typename rb_tree<T, Compare>::size_type
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::size_type
+rb_tree<T, Compare, Alloc>::
 erase_multi(const key_type& key)
 {
   auto p = equal_range_multi(key);
@@ -1207,9 +1271,9 @@ erase_multi(const key_type& key)
 }
 
 // 删除键值等于 key 的元素，返回删除的个数
-template <class T, class Compare>
-typename rb_tree<T, Compare>::size_type
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::size_type
+rb_tree<T, Compare, Alloc>::
 erase_unique(const key_type& key)
 {
   auto it = find(key);
@@ -1222,8 +1286,8 @@ erase_unique(const key_type& key)
 }
 
 // 删除[first, last)区间内的元素
-template <class T, class Compare>
-void rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::
 erase(iterator first, iterator last)
 {
   if (first == begin() && last == end())
@@ -1238,8 +1302,8 @@ erase(iterator first, iterator last)
 }
 
 // 清空 rb tree
-template <class T, class Compare>
-void rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::
 clear()
 {
   if (node_count_ != 0)
@@ -1250,12 +1314,14 @@ clear()
     rightmost() = header_;
     node_count_ = 0;
   }
+  // 节点都已销毁，整个 slab 归还配置器
+  pool_.release(this->get_alloc());
 }
 
 // 查找键值为 k 的节点，返回指向它的迭代器
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
 find(const key_type& key)
 {
   auto y = header_;  // 最后一个不小于 key 的节点
@@ -1275,9 +1341,9 @@ find(const key_type& key)
   return (j == end() || key_comp_(key, value_traits::get_key(*j))) ? end() : j;
 }
 
-template <class T, class Compare>
-typename rb_tree<T, Compare>::const_iterator
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::const_iterator
+rb_tree<T, Compare, Alloc>::
 find(const key_type& key) const
 {
   auto y = header_;  // 最后一个不小于 key 的节点
@@ -1298,9 +1364,9 @@ find(const key_type& key) const
 }
 
 // 键值不小于 key 的第一个位置
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
 lower_bound(const key_type& key)
 {
   auto y = header_;
@@ -1319,9 +1385,9 @@ lower_bound(const key_type& key)
   return iterator(y);
 }
 
-template <class T, class Compare>
-typename rb_tree<T, Compare>::const_iterator
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::const_iterator
+rb_tree<T, Compare, Alloc>::
 lower_bound(const key_type& key) const
 {
   auto y = header_;
@@ -1341,9 +1407,9 @@ lower_bound(const key_type& key) const
 }
 
 // 键值不小于 key 的最后一个位置
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
 upper_bound(const key_type& key)
 {
   auto y = header_;
@@ -1362,9 +1428,9 @@ upper_bound(const key_type& key)
   return iterator(y);
 }
 
-template <class T, class Compare>
-typename rb_tree<T, Compare>::const_iterator
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::const_iterator
+rb_tree<T, Compare, Alloc>::
 upper_bound(const key_type& key) const
 {
   auto y = header_;
@@ -1384,15 +1450,19 @@ upper_bound(const key_type& key) const
 }
 
 // 交换 rb tree
-template <class T, class Compare>
-void rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::
 swap(rb_tree& rhs) noexcept
 {
   if (this != &rhs)
   {
+    MYSTL_DEBUG(node_alloc_traits::propagate_on_container_swap::value ||
+                this->get_alloc() == rhs.get_alloc());
+    mystl::alloc_on_swap(this->get_alloc(), rhs.get_alloc());
     mystl::swap(header_, rhs.header_);
     mystl::swap(node_count_, rhs.node_count_);
     mystl::swap(key_comp_, rhs.key_comp_);
+    pool_.swap(rhs.pool_);
   }
 }
 
@@ -1400,32 +1470,33 @@ swap(rb_tree& rhs) noexcept
 // helper function
 
 // 创建一个结点
-template <class T, class Compare>
+template <class T, class Compare, class Alloc>
 template <class ...Args>
-typename rb_tree<T, Compare>::node_ptr
-rb_tree<T, Compare>::
+typename rb_tree<T, Compare, Alloc>::node_ptr
+rb_tree<T, Compare, Alloc>::
 create_node(Args&&... args)
 {
-  auto tmp = node_allocator::allocate(1);
+  auto tmp = pool_.allocate(this->get_alloc());
   try
   {
-    data_allocator::construct(mystl::address_of(tmp->value), mystl::forward<Args>(args)...);
+    node_alloc_traits::construct(this->get_alloc(), mystl::address_of(tmp->value),
+                                 mystl::forward<Args>(args)...);
     tmp->left = nullptr;
     tmp->right = nullptr;
     tmp->parent = nullptr;
   }
   catch (...)
   {
-    node_allocator::deallocate(tmp);
+    pool_.deallocate(tmp);
     throw;
   }
   return tmp;
 }
 
 // 复制一个结点
-template <class T, class Compare>
-typename rb_tree<T, Compare>::node_ptr
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::node_ptr
+rb_tree<T, Compare, Alloc>::
 clone_node(base_ptr x)
 {
   node_ptr tmp = create_node(x->get_node_ptr()->value);
@@ -1436,20 +1507,21 @@ clone_node(base_ptr x)
 }
 
 // 销毁一个结点
-template <class T, class Compare>
-void rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::
 destroy_node(node_ptr p)
 {
-  data_allocator::destroy(&p->value);
-  node_allocator::deallocate(p);
+  node_alloc_traits::destroy(this->get_alloc(), &p->value);
+  pool_.deallocate(p);
 }
 
 // 初始化容器
-template <class T, class Compare>
-void rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::
 rb_tree_init()
 {
-  header_ = base_allocator::allocate(1);
+  base_allocator alloc(this->get_alloc());
+  header_ = base_alloc_traits::allocate(alloc, 1);
   header_->color = rb_tree_red;  // header_ 节点颜色为红，与 root 区分
   root() = nullptr;
   leftmost() = header_;
@@ -1457,18 +1529,27 @@ rb_tree_init()
   node_count_ = 0;
 }
 
+// 释放 header 节点
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::destroy_header()
+{
+  base_allocator alloc(this->get_alloc());
+  base_alloc_traits::deallocate(alloc, header_, 1);
+  header_ = nullptr;
+}
+
 // reset 函数
-template <class T, class Compare>
-void rb_tree<T, Compare>::reset()
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::reset()
 {
   header_ = nullptr;
   node_count_ = 0;
 }
 
 // get_insert_multi_pos 函数
-template <class T, class Compare>
-mystl::pair<typename rb_tree<T, Compare>::base_ptr, bool>
-rb_tree<T, Compare>::get_insert_multi_pos(const key_type& key)
+template <class T, class Compare, class Alloc>
+mystl::pair<typename rb_tree<T, Compare, Alloc>::base_ptr, bool>
+rb_tree<T, Compare, Alloc>::get_insert_multi_pos(const key_type& key)
 {
   auto x = root();
   auto y = header_;
@@ -1483,9 +1564,9 @@ rb_tree<T, Compare>::get_insert_multi_pos(const key_type& key)
 }
 
 // get_insert_unique_pos 函数
-template <class T, class Compare>
-mystl::pair<mystl::pair<typename rb_tree<T, Compare>::base_ptr, bool>, bool>
-rb_tree<T, Compare>::get_insert_unique_pos(const key_type& key)
+template <class T, class Compare, class Alloc>
+mystl::pair<mystl::pair<typename rb_tree<T, Compare, Alloc>::base_ptr, bool>, bool>
+rb_tree<T, Compare, Alloc>::get_insert_unique_pos(const key_type& key)
 { // 返回一个 pair，第一个值为一个 pair，包含插入点的父节点和一个 bool 表示是否在左边插入，
   // 第二个值为一个 bool，表示是否插入成功
   auto x = root();
@@ -1519,9 +1600,9 @@ rb_tree<T, Compare>::get_insert_unique_pos(const key_type& key)
 
 // insert_value_at 函数
 // x 为插入点的父节点， value 为要插入的值，add_to_left 表示是否在左边插入
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
 insert_value_at(base_ptr x, const value_type& value, bool add_to_left)
 {
   node_ptr node = create_node(value);
@@ -1552,9 +1633,9 @@ insert_value_at(base_ptr x, const value_type& value, bool add_to_left)
 
 // 在 x 节点处插入新的节点
 // x 为插入点的父节点， node 为要插入的节点，add_to_left 表示是否在左边插入
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::
 insert_node_at(base_ptr x, node_ptr node, bool add_to_left)
 {
   node->parent = x;
@@ -1583,9 +1664,9 @@ insert_node_at(base_ptr x, node_ptr node, bool add_to_left)
 }
 
 // 插入元素，键值允许重复，使用 hint
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator 
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator 
+rb_tree<T, Compare, Alloc>::
 insert_multi_use_hint(iterator hint, key_type key, node_ptr node)
 {
   // 在 hint 附近寻找可插入的位置
@@ -1610,9 +1691,9 @@ insert_multi_use_hint(iterator hint, key_type key, node_ptr node)
 }
 
 // 插入元素，键值不允许重复，使用 hint
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator 
-rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator 
+rb_tree<T, Compare, Alloc>::
 insert_unique_use_hint(iterator hint, key_type key, node_ptr node)
 {
   // 在 hint 附近寻找可插入的位置
@@ -1643,9 +1724,9 @@ insert_unique_use_hint(iterator hint, key_type key, node_ptr node)
 
 // copy_from 函数
 // 递归复制一颗树，节点从 x 开始，p 为 x 的父节点
-template <class T, class Compare>
-typename rb_tree<T, Compare>::base_ptr
-rb_tree<T, Compare>::copy_from(base_ptr x, base_ptr p)
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::base_ptr
+rb_tree<T, Compare, Alloc>::copy_from(base_ptr x, base_ptr p)
 {
   auto top = clone_node(x);
   top->parent = p;
@@ -1676,8 +1757,8 @@ rb_tree<T, Compare>::copy_from(base_ptr x, base_ptr p)
 
 // erase_since 函数
 // 从 x 节点开始删除该节点及其子树
-template <class T, class Compare>
-void rb_tree<T, Compare>::
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::
 erase_since(base_ptr x)
 {
   while (x != nullptr)
@@ -1689,50 +1770,107 @@ erase_since(base_ptr x)
   }
 }
 
+// copy_tree 函数，把 rhs 的结构复制到当前的空树上
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::
+copy_tree(const rb_tree& rhs)
+{
+  if (rhs.node_count_ != 0)
+  {
+    root() = copy_from(rhs.root(), header_);
+    leftmost() = rb_tree_min(root());
+    rightmost() = rb_tree_max(root());
+  }
+  node_count_ = rhs.node_count_;
+}
+
+// move_assign 函数，可以直接接管 rhs 的节点
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::
+move_assign(rb_tree& rhs, m_true_type)
+{
+  if (header_ != nullptr)
+  {
+    clear();
+    destroy_header();
+  }
+  mystl::alloc_on_move(this->get_alloc(), rhs.get_alloc());
+  header_ = rhs.header_;
+  node_count_ = rhs.node_count_;
+  key_comp_ = rhs.key_comp_;
+  pool_.swap(rhs.pool_);
+  rhs.reset();
+}
+
+// move_assign 函数，配置器不传播时，只有两者相等才能接管节点，否则逐个移动元素
+template <class T, class Compare, class Alloc>
+void rb_tree<T, Compare, Alloc>::
+move_assign(rb_tree& rhs, m_false_type)
+{
+  if (this->get_alloc() == rhs.get_alloc())
+  {
+    move_assign(rhs, m_true_type());
+  }
+  else
+  {
+    clear();
+    key_comp_ = rhs.key_comp_;
+    for (auto it = rhs.begin(); it != rhs.end(); ++it)
+      emplace_multi_use_hint(end(), mystl::move(*it));
+    rhs.clear();
+  }
+}
+
 // 重载比较操作符
-template <class T, class Compare>
-bool operator==(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc>
+bool operator==(const rb_tree<T, Compare, Alloc>& lhs, const rb_tree<T, Compare, Alloc>& rhs)
 {
   return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class T, class Compare>
-bool operator<(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc>
+bool operator<(const rb_tree<T, Compare, Alloc>& lhs, const rb_tree<T, Compare, Alloc>& rhs)
 {
   return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
-template <class T, class Compare>
-bool operator!=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc>
+bool operator!=(const rb_tree<T, Compare, Alloc>& lhs, const rb_tree<T, Compare, Alloc>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class T, class Compare>
-bool operator>(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc>
+bool operator>(const rb_tree<T, Compare, Alloc>& lhs, const rb_tree<T, Compare, Alloc>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class T, class Compare>
-bool operator<=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc>
+bool operator<=(const rb_tree<T, Compare, Alloc>& lhs, const rb_tree<T, Compare, Alloc>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class T, class Compare>
-bool operator>=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs)
+template <class T, class Compare, class Alloc>
+bool operator>=(const rb_tree<T, Compare, Alloc>& lhs, const rb_tree<T, Compare, Alloc>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class T, class Compare>
-void swap(rb_tree<T, Compare>& lhs, rb_tree<T, Compare>& rhs) noexcept
+template <class T, class Compare, class Alloc>
+void swap(rb_tree<T, Compare, Alloc>& lhs, rb_tree<T, Compare, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
 
+// header 节点在堆上，节点不会指向 rb_tree 对象本身，Compare、Alloc 可以平凡重定位时容器也可以平凡重定位
+template <class T, class Compare, class Alloc>
+struct is_trivially_relocatable<rb_tree<T, Compare, Alloc>>
+  : m_bool_constant<is_trivially_relocatable<Compare>::value &&
+    is_trivially_relocatable<Alloc>::value> {};
+
 } // namespace mystl
 #endif // !MYTINYSTL_RB_TREE_H_
 
@@ -20,7 +20,9 @@ namespace mystl
 
 // 模板类 set，键值不允许重复
 // 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less 
-template <class Key, class Compare = mystl::less<Key>>
+// 参数三代表空间配置器，缺省使用 mystl::allocator
+template <class Key, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<Key>>
 class set
 {
 public:
@@ -31,7 +33,7 @@ public:
 
 private:
   // 以 mystl::rb_tree 作为底层机制
-  typedef mystl::rb_tree<value_type, key_compare>  base_type;
+  typedef mystl::rb_tree<value_type, key_compare, Alloc> base_type;
   base_type tree_;
 
 public:
@@ -53,22 +55,39 @@ public:
   // 构造、复制、移动函数
   set() = default;
 
+  explicit set(const allocator_type& alloc)
+    :tree_(key_compare(), alloc)
+  {
+  }
+  explicit set(const key_compare& comp, const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  {
+  }
+
   template <class InputIterator>
-  set(InputIterator first, InputIterator last) 
-    :tree_() 
+  set(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type()) 
+    :tree_(key_compare(), alloc) 
   { tree_.insert_unique(first, last); }
-  set(std::initializer_list<value_type> ilist)
-    :tree_()
+  set(std::initializer_list<value_type> ilist, const allocator_type& alloc = allocator_type())
+    :tree_(key_compare(), alloc)
   { tree_.insert_unique(ilist.begin(), ilist.end()); }
 
   set(const set& rhs) 
     :tree_(rhs.tree_)
   {
   }
+  set(const set& rhs, const allocator_type& alloc)
+    :tree_(rhs.tree_, alloc)
+  {
+  }
   set(set&& rhs) noexcept
     :tree_(mystl::move(rhs.tree_))
   {
   }
+  set(set&& rhs, const allocator_type& alloc)
+    :tree_(mystl::move(rhs.tree_), alloc)
+  {
+  }
 
   set& operator=(const set& rhs)
   {
@@ -126,6 +145,7 @@ public:
   bool                   empty()    const noexcept { return tree_.empty(); }
   size_type              size()     const noexcept { return tree_.size(); }
   size_type              max_size() const noexcept { return tree_.max_size(); }
+  memory_usage_info      memory_usage() const noexcept { return tree_.memory_usage(); }
 
   // 插入删除操作
 
@@ -201,45 +221,45 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class Compare>
-bool operator==(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator==(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class Compare>
-bool operator<(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator<(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
 {
   return lhs < rhs;
 }
 
-template <class Key, class Compare>
-bool operator!=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator!=(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class Key, class Compare>
-bool operator>(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator>(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class Key, class Compare>
-bool operator<=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator<=(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class Key, class Compare>
-bool operator>=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator>=(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class Key, class Compare>
-void swap(set<Key, Compare>& lhs, set<Key, Compare>& rhs) noexcept
+template <class Key, class Compare, class Alloc>
+void swap(set<Key, Compare, Alloc>& lhs, set<Key, Compare, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
@@ -248,7 +268,9 @@ void swap(set<Key, Compare>& lhs, set<Key, Compare>& rhs) noexcept
 
 // 模板类 multiset，键值允许重复
 // 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less 
-template <class Key, class Compare = mystl::less<Key>>
+// 参数三代表空间配置器，缺省使用 mystl::allocator
+template <class Key, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<Key>>
 class multiset
 {
 public:
@@ -259,7 +281,7 @@ public:
 
 private:
   // 以 mystl::rb_tree 作为底层机制
-  typedef mystl::rb_tree<value_type, key_compare>  base_type;
+  typedef mystl::rb_tree<value_type, key_compare, Alloc> base_type;
   base_type tree_;  // 以 rb_tree 表现 multiset
 
 public:
@@ -281,22 +303,39 @@ public:
   // 构造、复制、移动函数
   multiset() = default;
 
+  explicit multiset(const allocator_type& alloc)
+    :tree_(key_compare(), alloc)
+  {
+  }
+  explicit multiset(const key_compare& comp, const allocator_type& alloc = allocator_type())
+    :tree_(comp, alloc)
+  {
+  }
+
   template <class InputIterator>
-  multiset(InputIterator first, InputIterator last) 
-    :tree_() 
+  multiset(InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type()) 
+    :tree_(key_compare(), alloc) 
   { tree_.insert_multi(first, last); }
-  multiset(std::initializer_list<value_type> ilist)
-    :tree_() 
+  multiset(std::initializer_list<value_type> ilist, const allocator_type& alloc = allocator_type())
+    :tree_(key_compare(), alloc) 
   { tree_.insert_multi(ilist.begin(), ilist.end()); }
 
   multiset(const multiset& rhs)
     :tree_(rhs.tree_)
   {
   }
+  multiset(const multiset& rhs, const allocator_type& alloc)
+    :tree_(rhs.tree_, alloc)
+  {
+  }
   multiset(multiset&& rhs) noexcept
     :tree_(mystl::move(rhs.tree_))
   {
   }
+  multiset(multiset&& rhs, const allocator_type& alloc)
+    :tree_(mystl::move(rhs.tree_), alloc)
+  {
+  }
 
   multiset& operator=(const multiset& rhs) 
   { 
@@ -354,6 +393,7 @@ public:
   bool                   empty()    const noexcept { return tree_.empty(); }
   size_type              size()     const noexcept { return tree_.size(); }
   size_type              max_size() const noexcept { return tree_.max_size(); }
+  memory_usage_info      memory_usage() const noexcept { return tree_.memory_usage(); }
 
   // 插入删除操作
 
@@ -429,49 +469,60 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class Compare>
-bool operator==(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator==(const multiset<Key, Compare, Alloc>& lhs, const multiset<Key, Compare, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class Compare>
-bool operator<(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator<(const multiset<Key, Compare, Alloc>& lhs, const multiset<Key, Compare, Alloc>& rhs)
 {
   return lhs < rhs;
 }
 
-template <class Key, class Compare>
-bool operator!=(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator!=(const multiset<Key, Compare, Alloc>& lhs, const multiset<Key, Compare, Alloc>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class Key, class Compare>
-bool operator>(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator>(const multiset<Key, Compare, Alloc>& lhs, const multiset<Key, Compare, Alloc>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class Key, class Compare>
-bool operator<=(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator<=(const multiset<Key, Compare, Alloc>& lhs, const multiset<Key, Compare, Alloc>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class Key, class Compare>
-bool operator>=(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator>=(const multiset<Key, Compare, Alloc>& lhs, const multiset<Key, Compare, Alloc>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class Key, class Compare>
-void swap(multiset<Key, Compare>& lhs, multiset<Key, Compare>& rhs) noexcept
+template <class Key, class Compare, class Alloc>
+void swap(multiset<Key, Compare, Alloc>& lhs, multiset<Key, Compare, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
 
+// 与 rb_tree 相同，Compare、Alloc 可以平凡重定位时容器也可以平凡重定位
+template <class Key, class Compare, class Alloc>
+struct is_trivially_relocatable<set<Key, Compare, Alloc>>
+  : m_bool_constant<is_trivially_relocatable<Compare>::value &&
+    is_trivially_relocatable<Alloc>::value> {};
+
+template <class Key, class Compare, class Alloc>
+struct is_trivially_relocatable<multiset<Key, Compare, Alloc>>
+  : m_bool_constant<is_trivially_relocatable<Compare>::value &&
+    is_trivially_relocatable<Alloc>::value> {};
+
 } // namespace mystl
 #endif // !MYTINYSTL_SET_H_
 
@@ -0,0 +1,852 @@
+#ifndef MYTINYSTL_SMALL_VECTOR_H_
+#define MYTINYSTL_SMALL_VECTOR_H_
+
+// 这个头文件包含一个模板类 small_vector
+// small_vector : 小向量，对象内部预留 N 个元素的空间，元素个数不超过 N 时不向配置器申请内存
+
+// notes:
+//
+// 1. small_vector 的接口与 mystl::vector 相同，另外提供 is_inline() 与 inline_capacity()
+// 2. 元素个数超过 N 时，元素搬移到堆上，容量至少翻倍；shrink_to_fit 在元素个数不超过 N 时把元素搬回对象内部
+// 3. 元素保存在对象内部时，移动与交换需要逐个搬移元素，复杂度为 O(N)；元素在堆上时只交换指针
+// 4. 元素可以平凡重定位时，扩容以及插入、删除时的搬移直接复制内存，
+//    否则逐个移动构造、析构元素，因此要求元素的移动构造函数不抛出异常
+// 5. 迭代器在扩容、移动、交换之后失效，即使元素个数没有超过 N 也是如此
+// 6. 对象内部的空间使 begin_ 指向对象自身，small_vector 不能平凡重定位
+//
+// 异常保证：
+// mystl::small_vector<T, N> 满足基本异常保证，对 emplace、emplace_back、push_back、reserve 做强异常安全保证
+
+#include <initializer_list>
+#include <type_traits>
+
+#include <cstring>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "algo.h"
+
+namespace mystl
+{
+
+// 模板类: small_vector
+// 模板参数 T 代表类型，N 代表对象内部预留的元素个数，Alloc 代表空间配置器，缺省使用 mystl::allocator
+template <class T, size_t N, class Alloc = mystl::allocator<T>>
+class small_vector : private mystl::alloc_holder<Alloc>
+{
+  static_assert(N > 0, "small_vector must reserve at least one inline element");
+  static_assert(std::is_same<T, typename Alloc::value_type>::value,
+                "Alloc::value_type must be the same as T");
+  static_assert(mystl::is_trivially_relocatable<T>::value ||
+                std::is_nothrow_move_constructible<T>::value,
+                "small_vector requires T to be nothrow move constructible");
+public:
+  // small_vector 的嵌套型别定义
+  typedef Alloc                                    allocator_type;
+  typedef mystl::allocator_traits<Alloc>           alloc_traits;
+
+  typedef T                                        value_type;
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef typename alloc_traits::size_type         size_type;
+  typedef typename alloc_traits::difference_type   difference_type;
+
+  typedef value_type*                              iterator;
+  typedef const value_type*                        const_iterator;
+  typedef mystl::reverse_iterator<iterator>        reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+  allocator_type get_allocator() const { return this->get_alloc(); }
+
+private:
+  typedef mystl::alloc_holder<Alloc>              base_holder;
+
+  // 元素可以平凡重定位时，搬移元素直接复制内存
+  typedef m_bool_constant<mystl::is_trivially_relocatable<T>::value> relocatable;
+
+  iterator begin_;  // 表示目前使用空间的头部
+  iterator end_;    // 表示目前使用空间的尾部
+  iterator cap_;    // 表示目前储存空间的尾部
+
+  // 对象内部的空间
+  typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buf_;
+
+public:
+  // 构造、复制、移动、析构函数
+  small_vector() noexcept
+  { init_inline(); }
+
+  explicit small_vector(const allocator_type& alloc) noexcept
+    :base_holder(alloc)
+  { init_inline(); }
+
+  explicit small_vector(size_type n, const allocator_type& alloc = allocator_type())
+    :base_holder(alloc)
+  {
+    init_inline();
+    resize(n);
+  }
+
+  small_vector(size_type n, const value_type& value, const allocator_type& alloc = allocator_type())
+    :base_holder(alloc)
+  {
+    init_inline();
+    fill_insert(end_, n, value);
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  small_vector(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+    :base_holder(alloc)
+  {
+    MYSTL_DEBUG(!(last < first));
+    init_inline();
+    copy_insert(end_, first, last, iterator_category(first));
+  }
+
+  small_vector(const small_vector& rhs)
+    :base_holder(alloc_traits::select_on_container_copy_construction(rhs.get_alloc()))
+  {
+    init_inline();
+    copy_insert(end_, rhs.begin_, rhs.end_, mystl::forward_iterator_tag{});
+  }
+
+  small_vector(const small_vector& rhs, const allocator_type& alloc)
+    :base_holder(alloc)
+  {
+    init_inline();
+    copy_insert(end_, rhs.begin_, rhs.end_, mystl::forward_iterator_tag{});
+  }
+
+  small_vector(small_vector&& rhs) noexcept
+    :base_holder(mystl::move(rhs.get_alloc()))
+  {
+    init_inline();
+    steal_or_relocate(rhs);
+  }
+
+  small_vector(std::initializer_list<value_type> ilist,
+               const allocator_type& alloc = allocator_type())
+    :base_holder(alloc)
+  {
+    init_inline();
+    copy_insert(end_, ilist.begin(), ilist.end(), mystl::forward_iterator_tag{});
+  }
+
+  small_vector& operator=(const small_vector& rhs);
+  small_vector& operator=(small_vector&& rhs) noexcept(alloc_move_steals<Alloc>::value);
+
+  small_vector& operator=(std::initializer_list<value_type> ilist)
+  {
+    assign(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  ~small_vector()
+  {
+    destroy_range(begin_, end_);
+    free_heap();
+  }
+
+public:
+
+  // 迭代器相关操作
+  iterator               begin()         noexcept
+  { return begin_; }
+  const_iterator         begin()   const noexcept
+  { return begin_; }
+  iterator               end()           noexcept
+  { return end_; }
+  const_iterator         end()     const noexcept
+  { return end_; }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 容量相关操作
+  bool      empty()    const noexcept
+  { return begin_ == end_; }
+  size_type size()     const noexcept
+  { return static_cast<size_type>(end_ - begin_); }
+  size_type max_size() const noexcept
+  { return static_cast<size_type>(-1) / sizeof(T); }
+  size_type capacity() const noexcept
+  { return static_cast<size_type>(cap_ - begin_); }
+  void      reserve(size_type n);
+  void      shrink_to_fit();
+
+  // 元素是否保存在对象内部
+  bool      is_inline() const noexcept
+  { return begin_ == inline_data(); }
+  static constexpr size_type inline_capacity() noexcept
+  { return N; }
+
+  // 只统计堆上的空间，元素保存在对象内部时为 0
+  memory_usage_info memory_usage() const noexcept
+  {
+    if (is_inline())
+      return memory_usage_info{ 0, 0 };
+    return memory_usage_info{ size() * sizeof(T), (capacity() - size()) * sizeof(T) };
+  }
+
+  // 访问元素相关操作
+  reference operator[](size_type n)
+  {
+    MYSTL_DEBUG(n < size());
+    return *(begin_ + n);
+  }
+  const_reference operator[](size_type n) const
+  {
+    MYSTL_DEBUG(n < size());
+    return *(begin_ + n);
+  }
+  reference at(size_type n)
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size()), "small_vector<T, N>::at() subscript out of range");
+    return (*this)[n];
+  }
+  const_reference at(size_type n) const
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size()), "small_vector<T, N>::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  reference front()
+  {
+    MYSTL_DEBUG(!empty());
+    return *begin_;
+  }
+  const_reference front() const
+  {
+    MYSTL_DEBUG(!empty());
+    return *begin_;
+  }
+  reference back()
+  {
+    MYSTL_DEBUG(!empty());
+    return *(end_ - 1);
+  }
+  const_reference back() const
+  {
+    MYSTL_DEBUG(!empty());
+    return *(end_ - 1);
+  }
+
+  pointer       data()       noexcept { return begin_; }
+  const_pointer data() const noexcept { return begin_; }
+
+  // 修改容器相关操作
+
+  // assign
+
+  void assign(size_type n, const value_type& value)
+  {
+    value_type tmp(value);
+    clear();
+    fill_insert(end_, n, tmp);
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void assign(Iter first, Iter last)
+  {
+    MYSTL_DEBUG(!(last < first));
+    clear();
+    copy_insert(end_, first, last, iterator_category(first));
+  }
+
+  void assign(std::initializer_list<value_type> il)
+  { assign(il.begin(), il.end()); }
+
+  // emplace / emplace_back
+
+  template <class... Args>
+  iterator emplace(const_iterator pos, Args&& ...args);
+
+  template <class... Args>
+  void emplace_back(Args&& ...args)
+  {
+    if (end_ != cap_)
+    {
+      alloc_traits::construct(this->get_alloc(), end_, mystl::forward<Args>(args)...);
+      ++end_;
+    }
+    else
+    {
+      grow_emplace_back(mystl::forward<Args>(args)...);
+    }
+  }
+
+  // push_back / pop_back
+
+  void push_back(const value_type& value)
+  { emplace_back(value); }
+  void push_back(value_type&& value)
+  { emplace_back(mystl::move(value)); }
+
+  void pop_back()
+  {
+    MYSTL_DEBUG(!empty());
+    --end_;
+    alloc_traits::destroy(this->get_alloc(), end_);
+  }
+
+  // insert
+
+  iterator insert(const_iterator pos, const value_type& value)
+  { return emplace(pos, value); }
+  iterator insert(const_iterator pos, value_type&& value)
+  { return emplace(pos, mystl::move(value)); }
+
+  iterator insert(const_iterator pos, size_type n, const value_type& value)
+  {
+    MYSTL_DEBUG(pos >= begin() && pos <= end());
+    return fill_insert(const_cast<iterator>(pos), n, value);
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  iterator insert(const_iterator pos, Iter first, Iter last)
+  {
+    MYSTL_DEBUG(pos >= begin() && pos <= end() && !(last < first));
+    return copy_insert(const_cast<iterator>(pos), first, last, iterator_category(first));
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+  { return insert(pos, ilist.begin(), ilist.end()); }
+
+  // erase / clear
+  iterator erase(const_iterator pos);
+  iterator erase(const_iterator first, const_iterator last);
+  void     clear() noexcept
+  {
+    destroy_range(begin_, end_);
+    end_ = begin_;
+  }
+
+  // resize / reverse
+  void     resize(size_type new_size);
+  void     resize(size_type new_size, const value_type& value);
+
+  void     reverse() { mystl::reverse(begin(), end()); }
+
+  // swap
+  void     swap(small_vector& rhs) noexcept;
+
+private:
+  // helper functions
+
+  pointer       inline_data()       noexcept
+  { return reinterpret_cast<pointer>(&buf_); }
+  const_pointer inline_data() const noexcept
+  { return reinterpret_cast<const_pointer>(&buf_); }
+
+  void      init_inline() noexcept
+  {
+    begin_ = end_ = inline_data();
+    cap_ = begin_ + N;
+  }
+
+  // 归还堆上的空间并回到对象内部的空间，元素必须已经析构或搬走
+  void      free_heap() noexcept
+  {
+    if (!is_inline())
+      alloc_traits::deallocate(this->get_alloc(), begin_, capacity());
+    init_inline();
+  }
+
+  void      destroy_range(iterator first, iterator last) noexcept
+  {
+    for (; first != last; ++first)
+      alloc_traits::destroy(this->get_alloc(), first);
+  }
+
+  // 把 [first, last) 搬移到 result，result 不在 (first, last) 之间；搬移后原位置不再有元素
+  void      relocate_forward(iterator first, iterator last, iterator result) noexcept;
+  // 把 [first, last) 搬移到以 result 结尾的位置，result 不在 [first, last) 之间
+  void      relocate_backward(iterator first, iterator last, iterator result) noexcept;
+
+  // 容量至少增加 add 个时的新容量
+  size_type grow_cap(size_type add) const;
+  void      reallocate(size_type new_cap);
+
+  // 在 pos 处空出 n 个未构造的位置，返回空位的起始位置，end_ 已包含空位
+  iterator  open_gap(iterator pos, size_type n);
+  void      close_gap(iterator gap, size_type n) noexcept;
+
+  template <class... Args>
+  void      grow_emplace_back(Args&& ...args);
+
+  iterator  fill_insert(iterator pos, size_type n, const value_type& value);
+  template <class IIter>
+  iterator  copy_insert(iterator pos, IIter first, IIter last, input_iterator_tag);
+  template <class FIter>
+  iterator  copy_insert(iterator pos, FIter first, FIter last, forward_iterator_tag);
+
+  // 接管 rhs 的元素，rhs 在堆上时直接接管空间，否则逐个搬移；本对象必须为空且位于对象内部
+  void      steal_or_relocate(small_vector& rhs) noexcept;
+};
+
+/*****************************************************************************************/
+
+// 复制赋值操作符
+template <class T, size_t N, class Alloc>
+small_vector<T, N, Alloc>&
+small_vector<T, N, Alloc>::operator=(const small_vector& rhs)
+{
+  if (this != &rhs)
+  {
+    if (alloc_traits::propagate_on_container_copy_assignment::value &&
+        this->get_alloc() != rhs.get_alloc())
+    { // 配置器要随之复制，旧空间必须先用旧的配置器释放
+      clear();
+      free_heap();
+    }
+    mystl::alloc_on_copy(this->get_alloc(), rhs.get_alloc());
+    assign(rhs.begin_, rhs.end_);
+  }
+  return *this;
+}
+
+// 移动赋值操作符
+template <class T, size_t N, class Alloc>
+small_vector<T, N, Alloc>&
+small_vector<T, N, Alloc>::operator=(small_vector&& rhs) noexcept(alloc_move_steals<Alloc>::value)
+{
+  if (this != &rhs)
+  {
+    clear();
+    if (alloc_move_steals<Alloc>::value || this->get_alloc() == rhs.get_alloc())
+    { // 可以接管 rhs 的空间
+      free_heap();
+      mystl::alloc_on_move(this->get_alloc(), rhs.get_alloc());
+      steal_or_relocate(rhs);
+    }
+    else
+    { // 配置器不相等且不传播，只能逐个搬移元素
+      reserve(rhs.size());
+      relocate_forward(rhs.begin_, rhs.end_, begin_);
+      end_ = begin_ + rhs.size();
+      rhs.end_ = rhs.begin_;
+    }
+  }
+  return *this;
+}
+
+// 预留空间大小，当原容量小于要求大小时，才会重新分配
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::reserve(size_type n)
+{
+  if (capacity() < n)
+  {
+    THROW_LENGTH_ERROR_IF(n > max_size(),
+                          "n can not larger than max_size() in small_vector<T, N>::reserve(n)");
+    reallocate(n);
+  }
+}
+
+// 放弃多余的容量，元素个数不超过 N 时搬回对象内部
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::shrink_to_fit()
+{
+  if (!is_inline() && end_ < cap_)
+    reallocate(size());
+}
+
+// 在 pos 位置就地构造元素
+template <class T, size_t N, class Alloc>
+template <class... Args>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::emplace(const_iterator pos, Args&& ...args)
+{
+  MYSTL_DEBUG(pos >= begin() && pos <= end());
+  iterator xpos = const_cast<iterator>(pos);
+  if (xpos == end_)
+  {
+    const size_type n = xpos - begin_;
+    emplace_back(mystl::forward<Args>(args)...);
+    return begin_ + n;
+  }
+  // 参数可能引用容器中的元素，先构造出新元素再搬移
+  value_type tmp(mystl::forward<Args>(args)...);
+  xpos = open_gap(xpos, 1);
+  alloc_traits::construct(this->get_alloc(), xpos, mystl::move(tmp));
+  return xpos;
+}
+
+// 删除 pos 位置上的元素
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::erase(const_iterator pos)
+{
+  MYSTL_DEBUG(pos >= begin() && pos < end());
+  iterator xpos = const_cast<iterator>(pos);
+  alloc_traits::destroy(this->get_alloc(), xpos);
+  relocate_forward(xpos + 1, end_, xpos);
+  --end_;
+  return xpos;
+}
+
+// 删除[first, last)上的元素
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::erase(const_iterator first, const_iterator last)
+{
+  MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+  iterator xfirst = const_cast<iterator>(first);
+  iterator xlast = const_cast<iterator>(last);
+  if (xfirst != xlast)
+  {
+    destroy_range(xfirst, xlast);
+    relocate_forward(xlast, end_, xfirst);
+    end_ -= xlast - xfirst;
+  }
+  return xfirst;
+}
+
+// 重置容器大小，新增的元素值初始化
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::resize(size_type new_size)
+{
+  if (new_size < size())
+  {
+    erase(begin_ + new_size, end_);
+    return;
+  }
+  reserve(new_size);
+  for (iterator new_end = begin_ + new_size; end_ != new_end; ++end_)
+    alloc_traits::construct(this->get_alloc(), end_);
+}
+
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::resize(size_type new_size, const value_type& value)
+{
+  if (new_size < size())
+    erase(begin_ + new_size, end_);
+  else
+    fill_insert(end_, new_size - size(), value);
+}
+
+// 与另一个 small_vector 交换
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::swap(small_vector& rhs) noexcept
+{
+  if (this == &rhs)
+    return;
+  MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value ||
+              this->get_alloc() == rhs.get_alloc());
+  mystl::alloc_on_swap(this->get_alloc(), rhs.get_alloc());
+  if (!is_inline() && !rhs.is_inline())
+  { // 都在堆上，只交换指针
+    mystl::swap(begin_, rhs.begin_);
+    mystl::swap(end_, rhs.end_);
+    mystl::swap(cap_, rhs.cap_);
+    return;
+  }
+  if (is_inline() && rhs.is_inline())
+  { // 都在对象内部，交换公共部分，多出的元素搬到较短的一方
+    small_vector& longer = size() < rhs.size() ? rhs : *this;
+    small_vector& shorter = size() < rhs.size() ? *this : rhs;
+    const size_type common = shorter.size();
+    mystl::swap_ranges(shorter.begin_, shorter.end_, longer.begin_);
+    relocate_forward(longer.begin_ + common, longer.end_, shorter.end_);
+    shorter.end_ = shorter.begin_ + longer.size();
+    longer.end_ = longer.begin_ + common;
+    return;
+  }
+  // 一方在堆上，另一方的元素搬进它的对象内部空间，再交出堆上的空间
+  small_vector& heap = is_inline() ? rhs : *this;
+  small_vector& local = is_inline() ? *this : rhs;
+  iterator hb = heap.begin_, he = heap.end_, hc = heap.cap_;
+  heap.init_inline();
+  relocate_forward(local.begin_, local.end_, heap.begin_);
+  heap.end_ = heap.begin_ + local.size();
+  local.begin_ = hb;
+  local.end_ = he;
+  local.cap_ = hc;
+}
+
+/*****************************************************************************************/
+// helper function
+
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::
+relocate_forward(iterator first, iterator last, iterator result) noexcept
+{
+  if (relocatable::value)
+  {
+    if (first != last)
+      std::memmove(static_cast<void*>(result), static_cast<const void*>(first),
+                   static_cast<size_t>(last - first) * sizeof(T));
+    return;
+  }
+  for (; first != last; ++first, ++result)
+  {
+    alloc_traits::construct(this->get_alloc(), result, mystl::move(*first));
+    alloc_traits::destroy(this->get_alloc(), first);
+  }
+}
+
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::
+relocate_backward(iterator first, iterator last, iterator result) noexcept
+{
+  if (relocatable::value)
+  {
+    if (first != last)
+      std::memmove(static_cast<void*>(result - (last - first)), static_cast<const void*>(first),
+                   static_cast<size_t>(last - first) * sizeof(T));
+    return;
+  }
+  while (first != last)
+  {
+    --last;
+    --result;
+    alloc_traits::construct(this->get_alloc(), result, mystl::move(*last));
+    alloc_traits::destroy(this->get_alloc(), last);
+  }
+}
+
+// 容量至少翻倍，对象内部的 N 个元素是第一次扩容的起点
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::size_type
+small_vector<T, N, Alloc>::grow_cap(size_type add) const
+{
+  const auto old_cap = capacity();
+  THROW_LENGTH_ERROR_IF(max_size() - size() < add, "small_vector<T, N>'s size too big");
+  if (max_size() - old_cap < old_cap)
+    return max_size();
+  return mystl::max(old_cap * 2, size() + add);
+}
+
+// 把元素搬到容量为 new_cap 的空间，new_cap 不超过 N 时搬回对象内部
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::reallocate(size_type new_cap)
+{
+  MYSTL_DEBUG(new_cap >= size());
+  const bool to_inline = new_cap <= N;
+  if (to_inline && is_inline())
+    return;
+  pointer new_begin = to_inline
+    ? inline_data()
+    : alloc_traits::allocate(this->get_alloc(), new_cap);
+  const auto len = size();
+  relocate_forward(begin_, end_, new_begin);
+  if (!is_inline())
+    alloc_traits::deallocate(this->get_alloc(), begin_, capacity());
+  begin_ = new_begin;
+  end_ = new_begin + len;
+  cap_ = new_begin + (to_inline ? N : new_cap);
+}
+
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::open_gap(iterator pos, size_type n)
+{
+  if (n == 0)
+    return pos;
+  if (static_cast<size_type>(cap_ - end_) >= n)
+  { // 备用空间足够，后面的元素向后搬移
+    relocate_backward(pos, end_, end_ + n);
+    end_ += n;
+    return pos;
+  }
+  // 备用空间不足，新空间中空位前后的元素分别搬移
+  const size_type xpos = pos - begin_;
+  const size_type len = size();
+  const size_type new_cap = grow_cap(n);
+  pointer new_begin = alloc_traits::allocate(this->get_alloc(), new_cap);
+  relocate_forward(begin_, pos, new_begin);
+  relocate_forward(pos, end_, new_begin + xpos + n);
+  if (!is_inline())
+    alloc_traits::deallocate(this->get_alloc(), begin_, capacity());
+  begin_ = new_begin;
+  end_ = new_begin + len + n;
+  cap_ = new_begin + new_cap;
+  return begin_ + xpos;
+}
+
+// 空位上的元素构造失败时，把后面的元素搬回来
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::close_gap(iterator gap, size_type n) noexcept
+{
+  relocate_forward(gap + n, end_, gap);
+  end_ -= n;
+}
+
+// 没有备用空间时在尾部构造元素：先在新空间中构造，参数引用旧元素时依然有效
+template <class T, size_t N, class Alloc>
+template <class... Args>
+void small_vector<T, N, Alloc>::grow_emplace_back(Args&& ...args)
+{
+  const size_type new_cap = grow_cap(1);
+  const size_type len = size();
+  pointer new_begin = alloc_traits::allocate(this->get_alloc(), new_cap);
+  try
+  {
+    alloc_traits::construct(this->get_alloc(), new_begin + len, mystl::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    alloc_traits::deallocate(this->get_alloc(), new_begin, new_cap);
+    throw;
+  }
+  relocate_forward(begin_, end_, new_begin);
+  if (!is_inline())
+    alloc_traits::deallocate(this->get_alloc(), begin_, capacity());
+  begin_ = new_begin;
+  end_ = new_begin + len + 1;
+  cap_ = new_begin + new_cap;
+}
+
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::fill_insert(iterator pos, size_type n, const value_type& value)
+{
+  if (n == 0)
+    return pos;
+  // value 可能是容器中的元素，先复制一份
+  value_type tmp(value);
+  iterator gap = open_gap(pos, n);
+  iterator cur = gap;
+  try
+  {
+    for (iterator last = gap + n; cur != last; ++cur)
+      alloc_traits::construct(this->get_alloc(), cur, tmp);
+  }
+  catch (...)
+  {
+    destroy_range(gap, cur);
+    close_gap(gap, n);
+    throw;
+  }
+  return gap;
+}
+
+template <class T, size_t N, class Alloc>
+template <class IIter>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::
+copy_insert(iterator pos, IIter first, IIter last, input_iterator_tag)
+{
+  const size_type xpos = pos - begin_;
+  for (size_type i = xpos; first != last; ++first, ++i)
+    emplace(begin_ + i, *first);
+  return begin_ + xpos;
+}
+
+template <class T, size_t N, class Alloc>
+template <class FIter>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::
+copy_insert(iterator pos, FIter first, FIter last, forward_iterator_tag)
+{
+  const size_type n = mystl::distance(first, last);
+  if (n == 0)
+    return pos;
+  iterator gap = open_gap(pos, n);
+  iterator cur = gap;
+  try
+  {
+    if (std::is_trivially_copy_constructible<T>::value)
+      cur = mystl::uninitialized_copy(first, last, gap);
+    else
+      for (; first != last; ++first, ++cur)
+        alloc_traits::construct(this->get_alloc(), cur, *first);
+  }
+  catch (...)
+  {
+    destroy_range(gap, cur);
+    close_gap(gap, n);
+    throw;
+  }
+  return gap;
+}
+
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::steal_or_relocate(small_vector& rhs) noexcept
+{
+  MYSTL_DEBUG(empty() && is_inline());
+  if (!rhs.is_inline())
+  {
+    begin_ = rhs.begin_;
+    end_ = rhs.end_;
+    cap_ = rhs.cap_;
+    rhs.init_inline();
+  }
+  else
+  {
+    relocate_forward(rhs.begin_, rhs.end_, begin_);
+    end_ = begin_ + rhs.size();
+    rhs.end_ = rhs.begin_;
+  }
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+
+template <class T, size_t N, class Alloc>
+bool operator==(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+  return lhs.size() == rhs.size() &&
+    mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, size_t N, class Alloc>
+bool operator<(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, size_t N, class Alloc>
+bool operator!=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T, size_t N, class Alloc>
+bool operator>(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T, size_t N, class Alloc>
+bool operator<=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T, size_t N, class Alloc>
+bool operator>=(const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, size_t N, class Alloc>
+void swap(small_vector<T, N, Alloc>& lhs, small_vector<T, N, Alloc>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_SMALL_VECTOR_H_
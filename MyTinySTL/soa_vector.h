@@ -0,0 +1,1021 @@
+#ifndef MYTINYSTL_SOA_VECTOR_H_
+#define MYTINYSTL_SOA_VECTOR_H_
+
+// 这个头文件包含一个模板类 soa_vector
+// soa_vector : 按列保存的向量（struct of arrays），每个字段保存在各自连续的数组中
+
+// notes:
+//
+// 1. soa_vector<Fields...> 的一行对应一个 soa_value<Fields...>，用 mystl::get<I>(row) 访问第 I 个字段，
+//    soa_value 按字段依次比较大小
+// 2. 迭代器是随机访问迭代器，解引用得到代理对象 soa_reference，它指向一行，可以读写、交换这一行的所有字段，
+//    因此 mystl::sort、find_if、accumulate 等算法可以直接使用；需要一行的副本时把代理对象转换为 value_type
+// 3. 迭代器与代理对象保存各列的起始地址，不依赖容器对象本身，swap 之后依然有效
+// 4. column<I>() 返回第 I 列的 soa_span，按列处理的循环直接在连续的数组上进行；每一列按缓存行对齐
+// 5. 字段类型必须可以无异常地移动构造、移动赋值，扩容时逐列搬移，可以平凡重定位的列直接复制内存；
+//    插入、删除时逐列平移各行，中途不会抛出异常，因此不会出现只平移了一部分列的行
+//
+// 异常保证：
+// mystl::soa_vector<Fields...> 满足基本异常保证，push_back、emplace_back、reserve、resize 满足强异常安全保证；
+// 在中间 insert 时，若新元素的字段赋值抛出异常，插入位置上留下一行被移走的元素，容器仍然有效
+
+#include <initializer_list>
+#include <type_traits>
+
+#include <cstring>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "algobase.h"
+#include "growth_policy.h"
+
+namespace mystl
+{
+
+// 每一列起始地址对齐的字节数
+#ifndef MYSTL_SOA_COLUMN_ALIGN
+#define MYSTL_SOA_COLUMN_ALIGN 64
+#endif
+
+template <class... Ts> struct soa_value;
+template <class... Ts> struct soa_columns;
+
+/*****************************************************************************************/
+// soa_columns
+// 每个字段一列，递归地保存各列的起始地址，以及对一行或若干行的逐列操作
+
+template <>
+struct soa_columns<>
+{
+  static constexpr size_t row_bytes() noexcept { return 0; }
+
+  void allocate(size_t) {}
+  void deallocate() noexcept {}
+  void copy_construct(const soa_columns&, size_t) {}
+  void relocate_to(soa_columns&, size_t, size_t, size_t) noexcept {}
+  void destroy(size_t, size_t) noexcept {}
+  void construct(size_t) {}
+  void construct(size_t, const soa_value<>&) {}
+  void construct(size_t, soa_value<>&&) {}
+  void construct_fields(size_t) {}
+  void assign(size_t, const soa_value<>&) const {}
+  void assign(size_t, soa_value<>&&) const {}
+  void assign_row(size_t, const soa_columns&, size_t) const {}
+  void swap_row(size_t, const soa_columns&, size_t) const {}
+  void open_row(size_t, size_t) noexcept {}
+  void close_rows(size_t, size_t, size_t) noexcept {}
+};
+
+template <class T, class... Ts>
+struct soa_columns<T, Ts...>
+{
+  typedef soa_columns<Ts...> tail_type;
+
+  T*        head;
+  tail_type tail;
+
+  soa_columns() noexcept
+    :head(nullptr), tail()
+  {
+  }
+
+  static constexpr size_t row_bytes() noexcept
+  { return sizeof(T) + tail_type::row_bytes(); }
+
+  static constexpr size_t column_align() noexcept
+  { return alignof(T) > MYSTL_SOA_COLUMN_ALIGN ? alignof(T) : MYSTL_SOA_COLUMN_ALIGN; }
+
+  // 每列申请 n 个元素的空间，失败时释放已申请的列
+  void allocate(size_t n)
+  {
+    head = static_cast<T*>(mystl::aligned_allocate(n * sizeof(T), column_align()));
+    try
+    {
+      tail.allocate(n);
+    }
+    catch (...)
+    {
+      mystl::aligned_deallocate(head, column_align());
+      head = nullptr;
+      throw;
+    }
+  }
+
+  void deallocate() noexcept
+  {
+    mystl::aligned_deallocate(head, column_align());
+    tail.deallocate();
+  }
+
+  // 在未初始化的空间上复制 src 的前 n 行，失败时析构已构造的部分
+  void copy_construct(const soa_columns& src, size_t n)
+  {
+    size_t i = 0;
+    try
+    {
+      for (; i < n; ++i)
+        mystl::construct(head + i, src.head[i]);
+      tail.copy_construct(src.tail, n);
+    }
+    catch (...)
+    {
+      mystl::destroy(head, head + i);
+      throw;
+    }
+  }
+
+  // 把从 first 开始的 n 行搬到 dst 从 dst_first 开始的未初始化空间
+  void relocate_to(soa_columns& dst, size_t first, size_t dst_first, size_t n) noexcept
+  {
+    if (mystl::is_trivially_relocatable<T>::value)
+    {
+      if (n != 0)
+        std::memcpy(static_cast<void*>(dst.head + dst_first),
+                    static_cast<const void*>(head + first), n * sizeof(T));
+    }
+    else
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        mystl::construct(dst.head + dst_first + i, mystl::move(head[first + i]));
+        mystl::destroy(head + first + i);
+      }
+    }
+    tail.relocate_to(dst.tail, first, dst_first, n);
+  }
+
+  void destroy(size_t first, size_t last) noexcept
+  {
+    mystl::destroy(head + first, head + last);
+    tail.destroy(first, last);
+  }
+
+  // 在第 i 行构造，某一列失败时析构这一行已构造的列
+  void construct(size_t i)
+  {
+    mystl::construct(head + i);
+    try { tail.construct(i); }
+    catch (...) { mystl::destroy(head + i); throw; }
+  }
+
+  void construct(size_t i, const soa_value<T, Ts...>& value)
+  {
+    mystl::construct(head + i, value.head);
+    try { tail.construct(i, value.tail); }
+    catch (...) { mystl::destroy(head + i); throw; }
+  }
+
+  void construct(size_t i, soa_value<T, Ts...>&& value)
+  {
+    mystl::construct(head + i, mystl::move(value.head));
+    try { tail.construct(i, mystl::move(value.tail)); }
+    catch (...) { mystl::destroy(head + i); throw; }
+  }
+
+  // 每个参数构造一列
+  template <class U, class... Us>
+  void construct_fields(size_t i, U&& u, Us&& ...us)
+  {
+    static_assert(sizeof...(Us) == sizeof...(Ts), "one argument per field is required");
+    mystl::construct(head + i, mystl::forward<U>(u));
+    try { tail.construct_fields(i, mystl::forward<Us>(us)...); }
+    catch (...) { mystl::destroy(head + i); throw; }
+  }
+
+  // 改写已有的第 i 行
+  void assign(size_t i, const soa_value<T, Ts...>& value) const
+  {
+    head[i] = value.head;
+    tail.assign(i, value.tail);
+  }
+
+  void assign(size_t i, soa_value<T, Ts...>&& value) const
+  {
+    head[i] = mystl::move(value.head);
+    tail.assign(i, mystl::move(value.tail));
+  }
+
+  void assign_row(size_t i, const soa_columns& src, size_t j) const
+  {
+    head[i] = src.head[j];
+    tail.assign_row(i, src.tail, j);
+  }
+
+  void swap_row(size_t i, const soa_columns& rhs, size_t j) const
+  {
+    mystl::swap(head[i], rhs.head[j]);
+    tail.swap_row(i, rhs.tail, j);
+  }
+
+  // 共有 n 行，把 [pos, n) 后移一行，空出第 pos 行（仍是已构造的对象）
+  void open_row(size_t pos, size_t n) noexcept
+  {
+    mystl::construct(head + n, mystl::move(head[n - 1]));
+    mystl::move_backward(head + pos, head + n - 1, head + n);
+    tail.open_row(pos, n);
+  }
+
+  // 共有 n 行，删除 [first, last)，后面的行前移
+  void close_rows(size_t first, size_t last, size_t n) noexcept
+  {
+    mystl::move(head + last, head + n, head + first);
+    mystl::destroy(head + n - (last - first), head + n);
+    tail.close_rows(first, last, n);
+  }
+};
+
+/*****************************************************************************************/
+// soa_value
+// soa_vector 的一行，按字段递归保存
+
+template <>
+struct soa_value<>
+{
+  typedef soa_columns<> columns_type;
+
+  soa_value() noexcept {}
+  soa_value(const columns_type&, size_t) noexcept {}
+
+  friend bool operator==(const soa_value&, const soa_value&) noexcept { return true; }
+  friend bool operator<(const soa_value&, const soa_value&) noexcept { return false; }
+};
+
+template <class T, class... Ts>
+struct soa_value<T, Ts...>
+{
+  typedef soa_columns<T, Ts...> columns_type;
+
+  T                head;
+  soa_value<Ts...> tail;
+
+  soa_value()
+    :head(), tail()
+  {
+  }
+
+  soa_value(const T& h, const Ts& ...t)
+    :head(h), tail(t...)
+  {
+  }
+
+  // 复制 columns 的第 i 行
+  soa_value(const columns_type& columns, size_t i)
+    :head(columns.head[i]), tail(columns.tail, i)
+  {
+  }
+
+  // 代理对象通过转换为 soa_value 参与比较
+  friend bool operator==(const soa_value& lhs, const soa_value& rhs)
+  {
+    return lhs.head == rhs.head && lhs.tail == rhs.tail;
+  }
+
+  friend bool operator<(const soa_value& lhs, const soa_value& rhs)
+  {
+    return lhs.head < rhs.head || (!(rhs.head < lhs.head) && lhs.tail < rhs.tail);
+  }
+
+  friend bool operator!=(const soa_value& lhs, const soa_value& rhs)
+  { return !(lhs == rhs); }
+  friend bool operator>(const soa_value& lhs, const soa_value& rhs)
+  { return rhs < lhs; }
+  friend bool operator<=(const soa_value& lhs, const soa_value& rhs)
+  { return !(rhs < lhs); }
+  friend bool operator>=(const soa_value& lhs, const soa_value& rhs)
+  { return !(lhs < rhs); }
+};
+
+// soa_at : 第 I 个字段的类型，以及在 soa_value、soa_columns 中的位置
+template <size_t I, class Value>
+struct soa_at;
+
+template <class T, class... Ts>
+struct soa_at<0, soa_value<T, Ts...>>
+{
+  typedef T type;
+
+  static T* column(const soa_columns<T, Ts...>& c) noexcept
+  { return c.head; }
+  static T& field(soa_value<T, Ts...>& v) noexcept
+  { return v.head; }
+  static const T& field(const soa_value<T, Ts...>& v) noexcept
+  { return v.head; }
+};
+
+template <size_t I, class T, class... Ts>
+struct soa_at<I, soa_value<T, Ts...>>
+{
+  static_assert(I <= sizeof...(Ts), "field index out of range");
+  typedef soa_at<I - 1, soa_value<Ts...>> next;
+  typedef typename next::type             type;
+
+  static type* column(const soa_columns<T, Ts...>& c) noexcept
+  { return next::column(c.tail); }
+  static type& field(soa_value<T, Ts...>& v) noexcept
+  { return next::field(v.tail); }
+  static const type& field(const soa_value<T, Ts...>& v) noexcept
+  { return next::field(v.tail); }
+};
+
+template <size_t I, class... Ts>
+typename soa_at<I, soa_value<Ts...>>::type& get(soa_value<Ts...>& v) noexcept
+{
+  return soa_at<I, soa_value<Ts...>>::field(v);
+}
+
+template <size_t I, class... Ts>
+const typename soa_at<I, soa_value<Ts...>>::type& get(const soa_value<Ts...>& v) noexcept
+{
+  return soa_at<I, soa_value<Ts...>>::field(v);
+}
+
+/*****************************************************************************************/
+// soa_reference
+// 指向 soa_vector 一行的代理对象，赋值与 swap 改写所指的行，Const 为 true 时只读
+
+template <class Value, bool Const>
+class soa_reference
+{
+  template <class, bool> friend class soa_reference;
+public:
+  typedef typename Value::columns_type columns_type;
+
+  template <size_t I>
+  struct field
+  {
+    typedef typename soa_at<I, Value>::type                     value_type;
+    typedef typename std::conditional<Const,
+      const value_type&, value_type&>::type                     reference;
+  };
+
+private:
+  columns_type cols_;
+  size_t       idx_;
+
+public:
+  soa_reference(const columns_type& cols, size_t idx) noexcept
+    :cols_(cols), idx_(idx)
+  {
+  }
+
+  // 复制代理对象本身，指向同一行
+  soa_reference(const soa_reference&) = default;
+
+  // 可写的代理对象可以转换为只读的代理对象
+  template <bool C, typename std::enable_if<Const && !C, int>::type = 0>
+  soa_reference(const soa_reference<Value, C>& rhs) noexcept
+    :cols_(rhs.cols_), idx_(rhs.idx_)
+  {
+  }
+
+  // 赋值改写所指的行，而不是让代理对象指向另一行
+  soa_reference& operator=(const soa_reference& rhs)
+  {
+    static_assert(!Const, "can not assign through a const soa_reference");
+    cols_.assign_row(idx_, rhs.cols_, rhs.idx_);
+    return *this;
+  }
+
+  template <bool C>
+  soa_reference& operator=(const soa_reference<Value, C>& rhs)
+  {
+    static_assert(!Const, "can not assign through a const soa_reference");
+    cols_.assign_row(idx_, rhs.cols_, rhs.idx_);
+    return *this;
+  }
+
+  soa_reference& operator=(const Value& value)
+  {
+    static_assert(!Const, "can not assign through a const soa_reference");
+    cols_.assign(idx_, value);
+    return *this;
+  }
+
+  soa_reference& operator=(Value&& value)
+  {
+    static_assert(!Const, "can not assign through a const soa_reference");
+    cols_.assign(idx_, mystl::move(value));
+    return *this;
+  }
+
+  operator Value() const
+  { return Value(cols_, idx_); }
+
+  template <size_t I>
+  typename field<I>::reference get() const noexcept
+  { return soa_at<I, Value>::column(cols_)[idx_]; }
+
+  // 交换两个代理对象所指的行，mystl::iter_swap 通过它交换元素
+  void swap(const soa_reference& rhs) const
+  {
+    static_assert(!Const, "can not swap through a const soa_reference");
+    cols_.swap_row(idx_, rhs.cols_, rhs.idx_);
+  }
+
+  friend void swap(const soa_reference& lhs, const soa_reference& rhs)
+  { lhs.swap(rhs); }
+};
+
+template <size_t I, class Value, bool Const>
+typename soa_reference<Value, Const>::template field<I>::reference
+get(const soa_reference<Value, Const>& r) noexcept
+{
+  return r.template get<I>();
+}
+
+/*****************************************************************************************/
+// soa_iterator
+// soa_vector 的随机访问迭代器，解引用得到 soa_reference
+
+template <class Value, bool Const>
+class soa_iterator
+  : public mystl::iterator<mystl::random_access_iterator_tag, Value, ptrdiff_t,
+                           void, soa_reference<Value, Const>>
+{
+  template <class, bool> friend class soa_iterator;
+public:
+  typedef soa_reference<Value, Const>  reference;
+  typedef typename Value::columns_type columns_type;
+  typedef ptrdiff_t                    difference_type;
+  typedef soa_iterator                 self;
+
+private:
+  columns_type cols_;
+  size_t       idx_;
+
+public:
+  soa_iterator() noexcept
+    :cols_(), idx_(0)
+  {
+  }
+
+  soa_iterator(const columns_type& cols, size_t idx) noexcept
+    :cols_(cols), idx_(idx)
+  {
+  }
+
+  template <bool C, typename std::enable_if<Const && !C, int>::type = 0>
+  soa_iterator(const soa_iterator<Value, C>& rhs) noexcept
+    :cols_(rhs.cols_), idx_(rhs.idx_)
+  {
+  }
+
+  // 在容器中的下标
+  size_t index() const noexcept { return idx_; }
+
+  reference operator*() const noexcept
+  { return reference(cols_, idx_); }
+  reference operator[](difference_type n) const noexcept
+  { return reference(cols_, idx_ + n); }
+
+  self& operator++() noexcept { ++idx_; return *this; }
+  self  operator++(int) noexcept { self tmp = *this; ++idx_; return tmp; }
+  self& operator--() noexcept { --idx_; return *this; }
+  self  operator--(int) noexcept { self tmp = *this; --idx_; return tmp; }
+
+  self& operator+=(difference_type n) noexcept { idx_ += n; return *this; }
+  self& operator-=(difference_type n) noexcept { idx_ -= n; return *this; }
+  self  operator+(difference_type n) const noexcept { return self(cols_, idx_ + n); }
+  self  operator-(difference_type n) const noexcept { return self(cols_, idx_ - n); }
+  friend self operator+(difference_type n, const self& it) noexcept { return it + n; }
+
+  difference_type operator-(const self& rhs) const noexcept
+  { return static_cast<difference_type>(idx_) - static_cast<difference_type>(rhs.idx_); }
+
+  bool operator==(const self& rhs) const noexcept { return idx_ == rhs.idx_; }
+  bool operator!=(const self& rhs) const noexcept { return idx_ != rhs.idx_; }
+  bool operator< (const self& rhs) const noexcept { return idx_ < rhs.idx_; }
+  bool operator> (const self& rhs) const noexcept { return idx_ > rhs.idx_; }
+  bool operator<=(const self& rhs) const noexcept { return idx_ <= rhs.idx_; }
+  bool operator>=(const self& rhs) const noexcept { return idx_ >= rhs.idx_; }
+};
+
+/*****************************************************************************************/
+// soa_span
+// 一列的连续区间，不拥有元素
+
+template <class T>
+class soa_span
+{
+public:
+  typedef T                                       value_type;
+  typedef T*                                      pointer;
+  typedef T&                                      reference;
+  typedef T*                                      iterator;
+  typedef size_t                                  size_type;
+
+private:
+  T*        data_;
+  size_type size_;
+
+public:
+  soa_span(T* data, size_type n) noexcept
+    :data_(data), size_(n)
+  {
+  }
+
+  iterator  begin() const noexcept { return data_; }
+  iterator  end()   const noexcept { return data_ + size_; }
+  pointer   data()  const noexcept { return data_; }
+  size_type size()  const noexcept { return size_; }
+  bool      empty() const noexcept { return size_ == 0; }
+
+  reference operator[](size_type n) const
+  {
+    MYSTL_DEBUG(n < size_);
+    return data_[n];
+  }
+};
+
+/*****************************************************************************************/
+
+// 所有字段都可以无异常地移动构造、移动赋值
+template <class... Ts>
+struct soa_nothrow_movable : m_true_type {};
+
+template <class T, class... Ts>
+struct soa_nothrow_movable<T, Ts...>
+  : m_bool_constant<std::is_nothrow_move_constructible<T>::value &&
+                    std::is_nothrow_move_assignable<T>::value &&
+                    soa_nothrow_movable<Ts...>::value> {};
+
+// 模板类: soa_vector
+// 模板参数 Fields 代表每一列的类型
+template <class... Fields>
+class soa_vector
+{
+  static_assert(sizeof...(Fields) > 0, "soa_vector needs at least one field");
+  static_assert(soa_nothrow_movable<Fields...>::value,
+                "the fields of soa_vector must be nothrow move constructible and assignable");
+public:
+  // soa_vector 的嵌套型别定义
+  typedef soa_value<Fields...>                     value_type;
+  typedef soa_reference<value_type, false>         reference;
+  typedef soa_reference<value_type, true>          const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  typedef soa_iterator<value_type, false>          iterator;
+  typedef soa_iterator<value_type, true>           const_iterator;
+  typedef mystl::reverse_iterator<iterator>        reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+  // 第 I 列的元素类型
+  template <size_t I>
+  struct field
+  {
+    typedef typename soa_at<I, value_type>::type type;
+  };
+
+private:
+  typedef soa_columns<Fields...>                   columns_type;
+
+  columns_type cols_;  // 各列的起始地址
+  size_type    size_;  // 行数
+  size_type    cap_;   // 每列的容量
+
+public:
+  // 构造、复制、移动、析构函数
+  soa_vector() noexcept
+    :cols_(), size_(0), cap_(0)
+  {
+  }
+
+  explicit soa_vector(size_type n)
+    :cols_(), size_(0), cap_(0)
+  { resize(n); }
+
+  soa_vector(size_type n, const value_type& value)
+    :cols_(), size_(0), cap_(0)
+  { resize(n, value); }
+
+  soa_vector(std::initializer_list<value_type> ilist)
+    :cols_(), size_(0), cap_(0)
+  {
+    reserve(ilist.size());
+    for (auto& row : ilist)
+      push_back(row);
+  }
+
+  soa_vector(const soa_vector& rhs)
+    :cols_(), size_(0), cap_(0)
+  {
+    if (rhs.size_ == 0)
+      return;
+    cols_.allocate(rhs.size_);
+    cap_ = rhs.size_;
+    try
+    {
+      cols_.copy_construct(rhs.cols_, rhs.size_);
+    }
+    catch (...)
+    {
+      release();
+      throw;
+    }
+    size_ = rhs.size_;
+  }
+
+  soa_vector(soa_vector&& rhs) noexcept
+    :cols_(rhs.cols_), size_(rhs.size_), cap_(rhs.cap_)
+  {
+    rhs.cols_ = columns_type();
+    rhs.size_ = 0;
+    rhs.cap_ = 0;
+  }
+
+  soa_vector& operator=(const soa_vector& rhs)
+  {
+    if (this != &rhs)
+    {
+      soa_vector tmp(rhs);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  soa_vector& operator=(soa_vector&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      clear();
+      release();
+      cols_ = rhs.cols_;
+      size_ = rhs.size_;
+      cap_ = rhs.cap_;
+      rhs.cols_ = columns_type();
+      rhs.size_ = 0;
+      rhs.cap_ = 0;
+    }
+    return *this;
+  }
+
+  soa_vector& operator=(std::initializer_list<value_type> ilist)
+  {
+    soa_vector tmp(ilist);
+    swap(tmp);
+    return *this;
+  }
+
+  ~soa_vector()
+  {
+    clear();
+    release();
+  }
+
+public:
+  // 迭代器相关操作
+  iterator               begin()         noexcept
+  { return iterator(cols_, 0); }
+  const_iterator         begin()   const noexcept
+  { return const_iterator(cols_, 0); }
+  iterator               end()           noexcept
+  { return iterator(cols_, size_); }
+  const_iterator         end()     const noexcept
+  { return const_iterator(cols_, size_); }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+
+  // 容量相关操作
+  bool      empty()    const noexcept
+  { return size_ == 0; }
+  size_type size()     const noexcept
+  { return size_; }
+  size_type max_size() const noexcept
+  { return static_cast<size_type>(-1) / columns_type::row_bytes(); }
+  size_type capacity() const noexcept
+  { return cap_; }
+  void      reserve(size_type n)
+  {
+    THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size() in soa_vector<Fields...>::reserve(n)");
+    if (n > cap_)
+      reallocate(n);
+  }
+  void      shrink_to_fit()
+  {
+    if (size_ < cap_)
+      reallocate(size_);
+  }
+  memory_usage_info memory_usage() const noexcept
+  {
+    return memory_usage_info{ size_ * columns_type::row_bytes(),
+                              (cap_ - size_) * columns_type::row_bytes() };
+  }
+
+  // 访问元素相关操作
+  reference operator[](size_type n)
+  {
+    MYSTL_DEBUG(n < size_);
+    return reference(cols_, n);
+  }
+  const_reference operator[](size_type n) const
+  {
+    MYSTL_DEBUG(n < size_);
+    return const_reference(cols_, n);
+  }
+  reference at(size_type n)
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size_), "soa_vector<Fields...>::at() subscript out of range");
+    return (*this)[n];
+  }
+  const_reference at(size_type n) const
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size_), "soa_vector<Fields...>::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  reference front()
+  {
+    MYSTL_DEBUG(!empty());
+    return (*this)[0];
+  }
+  const_reference front() const
+  {
+    MYSTL_DEBUG(!empty());
+    return (*this)[0];
+  }
+  reference back()
+  {
+    MYSTL_DEBUG(!empty());
+    return (*this)[size_ - 1];
+  }
+  const_reference back() const
+  {
+    MYSTL_DEBUG(!empty());
+    return (*this)[size_ - 1];
+  }
+
+  // 第 I 列的连续区间
+  template <size_t I>
+  soa_span<typename field<I>::type> column() noexcept
+  { return soa_span<typename field<I>::type>(soa_at<I, value_type>::column(cols_), size_); }
+
+  template <size_t I>
+  soa_span<const typename field<I>::type> column() const noexcept
+  { return soa_span<const typename field<I>::type>(soa_at<I, value_type>::column(cols_), size_); }
+
+  // 修改容器相关操作
+
+  void push_back(const value_type& value)
+  { append(m_true_type(), value); }
+  void push_back(value_type&& value)
+  { append(m_true_type(), mystl::move(value)); }
+
+  // 每个参数构造一个字段
+  template <class... Args>
+  reference emplace_back(Args&& ...args)
+  {
+    static_assert(sizeof...(Args) == sizeof...(Fields), "one argument per field is required");
+    append(m_false_type(), mystl::forward<Args>(args)...);
+    return back();
+  }
+
+  void pop_back()
+  {
+    MYSTL_DEBUG(!empty());
+    --size_;
+    cols_.destroy(size_, size_ + 1);
+  }
+
+  iterator insert(const_iterator pos, const value_type& value)
+  { return insert_row(pos.index(), value); }
+  iterator insert(const_iterator pos, value_type&& value)
+  { return insert_row(pos.index(), mystl::move(value)); }
+
+  iterator erase(const_iterator pos)
+  { return erase(pos, pos + 1); }
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    MYSTL_DEBUG(first.index() <= last.index() && last.index() <= size_);
+    if (first != last)
+    {
+      cols_.close_rows(first.index(), last.index(), size_);
+      size_ -= last - first;
+    }
+    return iterator(cols_, first.index());
+  }
+
+  void clear() noexcept
+  {
+    cols_.destroy(0, size_);
+    size_ = 0;
+  }
+
+  void resize(size_type new_size)
+  { resize_aux(new_size, m_false_type()); }
+  void resize(size_type new_size, const value_type& value)
+  { resize_aux(new_size, m_true_type(), value); }
+
+  void swap(soa_vector& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      mystl::swap(cols_, rhs.cols_);
+      mystl::swap(size_, rhs.size_);
+      mystl::swap(cap_, rhs.cap_);
+    }
+  }
+
+private:
+  // helper functions
+
+  void release() noexcept
+  {
+    if (cap_ != 0)
+      cols_.deallocate();
+    cols_ = columns_type();
+    cap_ = 0;
+  }
+
+  size_type next_cap(size_type add) const
+  {
+    THROW_LENGTH_ERROR_IF(add > max_size() - size_, "soa_vector<Fields...>'s size too big");
+    return mystl::vector_growth::next_capacity(cap_, add, max_size());
+  }
+
+  // 接管新申请的各列，把已有的行搬过去；gap 之后的行后移一行，空出第 gap 行
+  void adopt(columns_type& new_cols, size_type new_cap, size_type gap) noexcept
+  {
+    cols_.relocate_to(new_cols, 0, 0, gap);
+    cols_.relocate_to(new_cols, gap, gap + 1, size_ - gap);
+    release();
+    cols_ = new_cols;
+    cap_ = new_cap;
+  }
+
+  void reallocate(size_type new_cap)
+  {
+    columns_type new_cols;
+    if (new_cap != 0)
+      new_cols.allocate(new_cap);
+    cols_.relocate_to(new_cols, 0, 0, size_);
+    release();
+    cols_ = new_cols;
+    cap_ = new_cap;
+  }
+
+  template <class... Args>
+  static void construct_row(columns_type& cols, size_type i, m_true_type, Args&& ...args)
+  { cols.construct(i, mystl::forward<Args>(args)...); }
+
+  template <class... Args>
+  static void construct_row(columns_type& cols, size_type i, m_false_type, Args&& ...args)
+  { cols.construct_fields(i, mystl::forward<Args>(args)...); }
+
+  // 没有参数时每个字段值初始化
+  static void construct_row(columns_type& cols, size_type i, m_false_type)
+  { cols.construct(i); }
+
+  // 在尾部构造一行，Whole 为 m_true_type 时参数是整行，否则每个参数构造一个字段
+  // 空间不足时先在新空间上构造，参数可以引用容器中的元素
+  template <class Whole, class... Args>
+  void append(Whole whole, Args&& ...args)
+  {
+    if (size_ != cap_)
+    {
+      construct_row(cols_, size_, whole, mystl::forward<Args>(args)...);
+      ++size_;
+      return;
+    }
+    const size_type new_cap = next_cap(1);
+    columns_type new_cols;
+    new_cols.allocate(new_cap);
+    try
+    {
+      construct_row(new_cols, size_, whole, mystl::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      new_cols.deallocate();
+      throw;
+    }
+    adopt(new_cols, new_cap, size_);
+    ++size_;
+  }
+
+  template <class V>
+  iterator insert_row(size_type pos, V&& value)
+  {
+    MYSTL_DEBUG(pos <= size_);
+    if (pos == size_)
+    {
+      append(m_true_type(), mystl::forward<V>(value));
+    }
+    else if (size_ == cap_)
+    {
+      const size_type new_cap = next_cap(1);
+      columns_type new_cols;
+      new_cols.allocate(new_cap);
+      try
+      {
+        new_cols.construct(pos, mystl::forward<V>(value));
+      }
+      catch (...)
+      {
+        new_cols.deallocate();
+        throw;
+      }
+      adopt(new_cols, new_cap, pos);
+      ++size_;
+    }
+    else
+    {
+      cols_.open_row(pos, size_);
+      ++size_;
+      cols_.assign(pos, mystl::forward<V>(value));
+    }
+    return iterator(cols_, pos);
+  }
+
+  template <class Whole, class... Args>
+  void resize_aux(size_type new_size, Whole whole, const Args& ...args)
+  {
+    if (new_size < size_)
+    {
+      cols_.destroy(new_size, size_);
+      size_ = new_size;
+      return;
+    }
+    reserve(new_size);
+    const size_type old_size = size_;
+    try
+    {
+      for (; size_ < new_size; ++size_)
+        construct_row(cols_, size_, whole, args...);
+    }
+    catch (...)
+    {
+      cols_.destroy(old_size, size_);
+      size_ = old_size;
+      throw;
+    }
+  }
+};
+
+/*****************************************************************************************/
+// 重载比较操作符
+
+template <class... Fields>
+bool operator==(const soa_vector<Fields...>& lhs, const soa_vector<Fields...>& rhs)
+{
+  return lhs.size() == rhs.size() &&
+    mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class... Fields>
+bool operator<(const soa_vector<Fields...>& lhs, const soa_vector<Fields...>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class... Fields>
+bool operator!=(const soa_vector<Fields...>& lhs, const soa_vector<Fields...>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class... Fields>
+bool operator>(const soa_vector<Fields...>& lhs, const soa_vector<Fields...>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class... Fields>
+bool operator<=(const soa_vector<Fields...>& lhs, const soa_vector<Fields...>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class... Fields>
+bool operator>=(const soa_vector<Fields...>& lhs, const soa_vector<Fields...>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class... Fields>
+void swap(soa_vector<Fields...>& lhs, soa_vector<Fields...>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+// 只保存各列的地址与大小，可以平凡重定位
+template <class... Fields>
+struct is_trivially_relocatable<soa_vector<Fields...>> : m_true_type {};
+
+} // namespace mystl
+#endif // !MYTINYSTL_SOA_VECTOR_H_
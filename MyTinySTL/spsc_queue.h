@@ -0,0 +1,318 @@
+#ifndef MYTINYSTL_SPSC_QUEUE_H_
+#define MYTINYSTL_SPSC_QUEUE_H_
+
+// 这个头文件包含一个模板类 spsc_queue
+// spsc_queue : 单生产者单消费者的有界无锁队列，用于两个线程之间传递元素
+
+// notes:
+//
+// 1. 只允许一个线程调用生产者一侧的函数（try_push、try_emplace、try_push_n），
+//    另一个线程调用消费者一侧的函数（front、pop、try_pop、try_pop_n），两侧都不加锁
+// 2. 容量向上取整为 2 的幂，head、tail 是只增不减的计数，取下标时与 capacity - 1 做与运算
+// 3. 生产者只写 tail，消费者只写 head，两者以 release 写入、以 acquire 读取；
+//    两侧各自缓存一份对方的计数，只有在缓存的值显示队列已满（已空）时才重新读取对方的原子变量
+// 4. head、tail 以及各自的缓存分别占据不同的缓存行，避免两个线程之间的伪共享
+// 5. try_push_n、try_pop_n 一次传递多个元素，整批只做一次原子写入，用来分摊同步的开销
+// 6. empty、size 可以在任意线程调用，并发时只是某一时刻的近似值
+//
+// 异常保证：
+// mystl::spsc_queue<T> 对 try_emplace、try_push、try_push_n、try_pop 做强异常安全保证，
+// try_pop_n 在元素的移动赋值抛出异常时只保证队列仍然有效，没有元素被弹出
+
+#include <atomic>
+
+#include "aligned_allocator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "algobase.h"
+
+namespace mystl
+{
+
+// 模板类: spsc_queue
+// 模板参数 T 代表类型，Alloc 代表空间配置器
+template <class T, class Alloc = mystl::allocator<T>>
+class spsc_queue : private mystl::alloc_holder<Alloc>
+{
+  static_assert(std::is_same<T, typename Alloc::value_type>::value,
+                "Alloc::value_type must be the same as T");
+public:
+  // spsc_queue 的嵌套型别定义
+  typedef Alloc                                    allocator_type;
+  typedef mystl::allocator_traits<Alloc>           alloc_traits;
+
+  typedef T                                        value_type;
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  allocator_type get_allocator() const { return this->get_alloc(); }
+
+private:
+  typedef mystl::alloc_holder<Alloc>               base_holder;
+
+  // 两个线程都只读的部分
+  pointer                buf_;           // 缓冲区
+  size_type              mask_;          // 容量 - 1
+  char                   pad0_[ECacheLineSize];
+
+  // 生产者独占的部分
+  std::atomic<size_type> tail_;          // 已经放入的元素总数
+  size_type              cached_head_;   // 生产者最近一次读到的 head_
+  char                   pad1_[ECacheLineSize];
+
+  // 消费者独占的部分
+  std::atomic<size_type> head_;          // 已经取出的元素总数
+  size_type              cached_tail_;   // 消费者最近一次读到的 tail_
+  char                   pad2_[ECacheLineSize];
+
+public:
+  // 构造、析构函数
+  explicit spsc_queue(size_type capacity, const allocator_type& alloc = allocator_type())
+    :base_holder(alloc), buf_(nullptr), mask_(0), tail_(0), cached_head_(0),
+    head_(0), cached_tail_(0)
+  {
+    const size_type cap = round_capacity(capacity);
+    buf_ = alloc_traits::allocate(this->get_alloc(), cap);
+    mask_ = cap - 1;
+  }
+
+  spsc_queue(const spsc_queue&) = delete;
+  spsc_queue& operator=(const spsc_queue&) = delete;
+
+  ~spsc_queue();
+
+public:
+  // 生产者一侧的操作，队列已满时返回 false
+
+  template <class ...Args>
+  bool      try_emplace(Args&& ...args);
+
+  bool      try_push(const value_type& value)
+  { return try_emplace(value); }
+  bool      try_push(value_type&& value)
+  { return try_emplace(mystl::move(value)); }
+
+  // 从 first 开始最多放入 n 个元素，返回实际放入的个数
+  template <class InputIter>
+  size_type try_push_n(InputIter first, size_type n);
+
+  // 消费者一侧的操作，队列为空时 front 返回 nullptr，try_pop 返回 false
+
+  pointer   front() noexcept;
+  void      pop() noexcept;
+
+  bool      try_pop(value_type& value);
+
+  // 最多取出 n 个元素，依次移动赋值到 result，返回实际取出的个数
+  template <class OutputIter>
+  size_type try_pop_n(OutputIter result, size_type n);
+
+  // 容量相关操作，并发时 empty 与 size 只是近似值
+  bool      empty()    const noexcept
+  { return size() == 0; }
+  size_type size()     const noexcept;
+  size_type capacity() const noexcept
+  { return mask_ + 1; }
+  size_type max_size() const noexcept
+  { return alloc_traits::max_size(this->get_alloc()); }
+
+  memory_usage_info memory_usage() const noexcept
+  {
+    const size_type n = size();
+    return memory_usage_info{ n * sizeof(T), (capacity() - n) * sizeof(T) };
+  }
+
+private:
+  // helper functions
+
+  size_type round_capacity(size_type n) const;
+
+  // 生产者、消费者各自取得可用的空位、元素个数，必要时重新读取对方的计数
+  size_type producer_free(size_type t, size_type want) noexcept;
+  size_type consumer_avail(size_type h, size_type want) noexcept;
+
+  template <class InputIter>
+  void      construct_range(pointer dst, InputIter& first, size_type n);
+};
+
+/*****************************************************************************************/
+
+// 析构函数，此时不应再有其他线程访问队列
+template <class T, class Alloc>
+spsc_queue<T, Alloc>::~spsc_queue()
+{
+  const size_type t = tail_.load(std::memory_order_relaxed);
+  for (size_type h = head_.load(std::memory_order_relaxed); h != t; ++h)
+    alloc_traits::destroy(this->get_alloc(), buf_ + (h & mask_));
+  alloc_traits::deallocate(this->get_alloc(), buf_, capacity());
+}
+
+// 在队尾就地构造元素
+template <class T, class Alloc>
+template <class ...Args>
+bool spsc_queue<T, Alloc>::try_emplace(Args&& ...args)
+{
+  const size_type t = tail_.load(std::memory_order_relaxed);
+  if (producer_free(t, 1) == 0)
+    return false;
+  alloc_traits::construct(this->get_alloc(), buf_ + (t & mask_), mystl::forward<Args>(args)...);
+  tail_.store(t + 1, std::memory_order_release);
+  return true;
+}
+
+// 批量放入元素，空位最多分成两段连续的空间
+template <class T, class Alloc>
+template <class InputIter>
+typename spsc_queue<T, Alloc>::size_type
+spsc_queue<T, Alloc>::try_push_n(InputIter first, size_type n)
+{
+  const size_type t = tail_.load(std::memory_order_relaxed);
+  const size_type k = producer_free(t, n);
+  if (k == 0)
+    return 0;
+  const size_type idx = t & mask_;
+  const size_type n1 = mystl::min(k, capacity() - idx);
+  construct_range(buf_ + idx, first, n1);
+  try
+  {
+    construct_range(buf_, first, k - n1);
+  }
+  catch (...)
+  {
+    mystl::destroy(buf_ + idx, buf_ + idx + n1);
+    throw;
+  }
+  tail_.store(t + k, std::memory_order_release);
+  return k;
+}
+
+// 返回队首元素的地址
+template <class T, class Alloc>
+typename spsc_queue<T, Alloc>::pointer
+spsc_queue<T, Alloc>::front() noexcept
+{
+  const size_type h = head_.load(std::memory_order_relaxed);
+  return consumer_avail(h, 1) == 0 ? nullptr : buf_ + (h & mask_);
+}
+
+// 弹出队首元素，队列不能为空
+template <class T, class Alloc>
+void spsc_queue<T, Alloc>::pop() noexcept
+{
+  const size_type h = head_.load(std::memory_order_relaxed);
+  MYSTL_DEBUG(consumer_avail(h, 1) != 0);
+  alloc_traits::destroy(this->get_alloc(), buf_ + (h & mask_));
+  head_.store(h + 1, std::memory_order_release);
+}
+
+// 把队首元素移动到 value 并弹出
+template <class T, class Alloc>
+bool spsc_queue<T, Alloc>::try_pop(value_type& value)
+{
+  const size_type h = head_.load(std::memory_order_relaxed);
+  if (consumer_avail(h, 1) == 0)
+    return false;
+  pointer p = buf_ + (h & mask_);
+  value = mystl::move(*p);
+  alloc_traits::destroy(this->get_alloc(), p);
+  head_.store(h + 1, std::memory_order_release);
+  return true;
+}
+
+// 批量取出元素，先全部移动再统一析构，移动中途抛出异常时不弹出任何元素
+template <class T, class Alloc>
+template <class OutputIter>
+typename spsc_queue<T, Alloc>::size_type
+spsc_queue<T, Alloc>::try_pop_n(OutputIter result, size_type n)
+{
+  const size_type h = head_.load(std::memory_order_relaxed);
+  const size_type k = consumer_avail(h, n);
+  if (k == 0)
+    return 0;
+  const size_type idx = h & mask_;
+  const size_type n1 = mystl::min(k, capacity() - idx);
+  result = mystl::move(buf_ + idx, buf_ + idx + n1, result);
+  mystl::move(buf_, buf_ + (k - n1), result);
+  mystl::destroy(buf_ + idx, buf_ + idx + n1);
+  mystl::destroy(buf_, buf_ + (k - n1));
+  head_.store(h + k, std::memory_order_release);
+  return k;
+}
+
+// 先读 head 再读 tail，保证结果不会是负数
+template <class T, class Alloc>
+typename spsc_queue<T, Alloc>::size_type
+spsc_queue<T, Alloc>::size() const noexcept
+{
+  const size_type h = head_.load(std::memory_order_acquire);
+  const size_type t = tail_.load(std::memory_order_acquire);
+  const size_type n = t - h;
+  return n < capacity() ? n : capacity();
+}
+
+/*****************************************************************************************/
+// helper function
+
+// 容量至少为 1，向上取整为 2 的幂
+template <class T, class Alloc>
+typename spsc_queue<T, Alloc>::size_type
+spsc_queue<T, Alloc>::round_capacity(size_type n) const
+{
+  THROW_LENGTH_ERROR_IF(n > max_size() / 2, "spsc_queue<T>'s capacity too big");
+  size_type cap = 1;
+  while (cap < n)
+    cap <<= 1;
+  return cap;
+}
+
+template <class T, class Alloc>
+typename spsc_queue<T, Alloc>::size_type
+spsc_queue<T, Alloc>::producer_free(size_type t, size_type want) noexcept
+{
+  size_type free = capacity() - (t - cached_head_);
+  if (free < want)
+  {
+    cached_head_ = head_.load(std::memory_order_acquire);
+    free = capacity() - (t - cached_head_);
+  }
+  return free < want ? free : want;
+}
+
+template <class T, class Alloc>
+typename spsc_queue<T, Alloc>::size_type
+spsc_queue<T, Alloc>::consumer_avail(size_type h, size_type want) noexcept
+{
+  size_type avail = cached_tail_ - h;
+  if (avail < want)
+  {
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+    avail = cached_tail_ - h;
+  }
+  return avail < want ? avail : want;
+}
+
+// 在 dst 开始的 n 个位置上依次构造 *first，first 随之前进；抛出异常时析构已构造的元素
+template <class T, class Alloc>
+template <class InputIter>
+void spsc_queue<T, Alloc>::construct_range(pointer dst, InputIter& first, size_type n)
+{
+  size_type i = 0;
+  try
+  {
+    for (; i < n; ++i, ++first)
+      alloc_traits::construct(this->get_alloc(), dst + i, *first);
+  }
+  catch (...)
+  {
+    mystl::destroy(dst, dst + i);
+    throw;
+  }
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_SPSC_QUEUE_H_
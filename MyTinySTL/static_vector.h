@@ -0,0 +1,675 @@
+#ifndef MYTINYSTL_STATIC_VECTOR_H_
+#define MYTINYSTL_STATIC_VECTOR_H_
+
+// 这个头文件包含一个模板类 static_vector
+// static_vector : 定长向量，元素保存在对象内部，最多 N 个，从不申请内存
+
+// notes:
+//
+// 1. static_vector 的接口与 mystl::vector 相同，容量固定为 N，reserve 与 shrink_to_fit 不改变容量
+// 2. 超出容量时 push_back、emplace_back、insert、resize 等抛出 std::length_error，容器保持不变；
+//    try_push_back、try_emplace_back 在容器已满时返回 false，不抛出异常
+// 3. 元素可以平凡重定位时，插入、删除、移动时的搬移直接复制内存，
+//    否则插入时先在尾部构造，再用 rotate 移到插入位置
+// 4. 对象本身不含指向自身的指针，元素可以平凡重定位时 static_vector 也可以平凡重定位
+//
+// 异常保证：
+// mystl::static_vector<T, N> 满足基本异常保证，对 emplace_back、push_back 以及容量不足时的所有插入做强异常安全保证
+
+#include <initializer_list>
+#include <type_traits>
+
+#include <cstring>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "algo.h"
+
+namespace mystl
+{
+
+// 模板类: static_vector
+// 模板参数 T 代表类型，N 代表容量
+template <class T, size_t N>
+class static_vector
+{
+  static_assert(N > 0, "static_vector must have a capacity of at least one element");
+public:
+  // static_vector 的嵌套型别定义
+  typedef T                                        value_type;
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  typedef value_type*                              iterator;
+  typedef const value_type*                        const_iterator;
+  typedef mystl::reverse_iterator<iterator>        reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+private:
+  // 元素可以平凡重定位时，搬移元素直接复制内存
+  typedef m_bool_constant<mystl::is_trivially_relocatable<T>::value> relocatable;
+
+  size_type size_;  // 元素个数
+  typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buf_;
+
+public:
+  // 构造、复制、移动、析构函数
+  static_vector() noexcept
+    :size_(0)
+  {
+  }
+
+  explicit static_vector(size_type n)
+    :size_(0)
+  { resize(n); }
+
+  static_vector(size_type n, const value_type& value)
+    :size_(0)
+  {
+    check_room(0, n);
+    fill_back(n, value);
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  static_vector(Iter first, Iter last)
+    :size_(0)
+  {
+    MYSTL_DEBUG(!(last < first));
+    insert(end(), first, last);
+  }
+
+  static_vector(const static_vector& rhs)
+    :size_(0)
+  { insert(end(), rhs.begin(), rhs.end()); }
+
+  static_vector(static_vector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+    :size_(0)
+  { take(rhs, relocatable()); }
+
+  static_vector(std::initializer_list<value_type> ilist)
+    :size_(0)
+  { insert(end(), ilist.begin(), ilist.end()); }
+
+  static_vector& operator=(const static_vector& rhs)
+  {
+    if (this != &rhs)
+      assign(rhs.begin(), rhs.end());
+    return *this;
+  }
+
+  static_vector& operator=(static_vector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+  {
+    if (this != &rhs)
+    {
+      clear();
+      take(rhs, relocatable());
+    }
+    return *this;
+  }
+
+  static_vector& operator=(std::initializer_list<value_type> ilist)
+  {
+    assign(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  ~static_vector()
+  { mystl::destroy(begin(), end()); }
+
+public:
+
+  // 迭代器相关操作
+  iterator               begin()         noexcept
+  { return data(); }
+  const_iterator         begin()   const noexcept
+  { return data(); }
+  iterator               end()           noexcept
+  { return data() + size_; }
+  const_iterator         end()     const noexcept
+  { return data() + size_; }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 容量相关操作
+  bool      empty()    const noexcept
+  { return size_ == 0; }
+  bool      full()     const noexcept
+  { return size_ == N; }
+  size_type size()     const noexcept
+  { return size_; }
+  static constexpr size_type max_size() noexcept
+  { return N; }
+  static constexpr size_type capacity() noexcept
+  { return N; }
+  void      reserve(size_type n)
+  { THROW_LENGTH_ERROR_IF(n > N, "n can not larger than N in static_vector<T, N>::reserve(n)"); }
+  void      shrink_to_fit() noexcept {}
+  // 不申请任何内存
+  memory_usage_info memory_usage() const noexcept
+  { return memory_usage_info{ 0, 0 }; }
+
+  // 访问元素相关操作
+  reference operator[](size_type n)
+  {
+    MYSTL_DEBUG(n < size());
+    return *(begin() + n);
+  }
+  const_reference operator[](size_type n) const
+  {
+    MYSTL_DEBUG(n < size());
+    return *(begin() + n);
+  }
+  reference at(size_type n)
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size()), "static_vector<T, N>::at() subscript out of range");
+    return (*this)[n];
+  }
+  const_reference at(size_type n) const
+  {
+    THROW_OUT_OF_RANGE_IF(!(n < size()), "static_vector<T, N>::at() subscript out of range");
+    return (*this)[n];
+  }
+
+  reference front()
+  {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+  const_reference front() const
+  {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+  reference back()
+  {
+    MYSTL_DEBUG(!empty());
+    return *(end() - 1);
+  }
+  const_reference back() const
+  {
+    MYSTL_DEBUG(!empty());
+    return *(end() - 1);
+  }
+
+  pointer       data()       noexcept { return reinterpret_cast<pointer>(&buf_); }
+  const_pointer data() const noexcept { return reinterpret_cast<const_pointer>(&buf_); }
+
+  // 修改容器相关操作
+
+  // assign
+
+  void assign(size_type n, const value_type& value)
+  {
+    check_room(0, n);
+    value_type tmp(value);
+    clear();
+    fill_back(n, tmp);
+  }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void assign(Iter first, Iter last)
+  {
+    MYSTL_DEBUG(!(last < first));
+    clear();
+    insert(end(), first, last);
+  }
+
+  void assign(std::initializer_list<value_type> il)
+  { assign(il.begin(), il.end()); }
+
+  // emplace / emplace_back
+
+  template <class... Args>
+  iterator emplace(const_iterator pos, Args&& ...args);
+
+  template <class... Args>
+  reference emplace_back(Args&& ...args)
+  {
+    check_room(size_, 1);
+    construct_back(mystl::forward<Args>(args)...);
+    return back();
+  }
+
+  // 容器已满时返回 false，不抛出异常
+  template <class... Args>
+  bool try_emplace_back(Args&& ...args)
+  {
+    if (full())
+      return false;
+    construct_back(mystl::forward<Args>(args)...);
+    return true;
+  }
+
+  // push_back / pop_back
+
+  void push_back(const value_type& value)
+  { emplace_back(value); }
+  void push_back(value_type&& value)
+  { emplace_back(mystl::move(value)); }
+
+  bool try_push_back(const value_type& value)
+  { return try_emplace_back(value); }
+  bool try_push_back(value_type&& value)
+  { return try_emplace_back(mystl::move(value)); }
+
+  void pop_back()
+  {
+    MYSTL_DEBUG(!empty());
+    --size_;
+    mystl::destroy(end());
+  }
+
+  // insert
+
+  iterator insert(const_iterator pos, const value_type& value)
+  { return emplace(pos, value); }
+  iterator insert(const_iterator pos, value_type&& value)
+  { return emplace(pos, mystl::move(value)); }
+
+  iterator insert(const_iterator pos, size_type n, const value_type& value);
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  iterator insert(const_iterator pos, Iter first, Iter last)
+  {
+    MYSTL_DEBUG(pos >= begin() && pos <= end() && !(last < first));
+    return copy_insert(const_cast<iterator>(pos), first, last, iterator_category(first));
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+  { return insert(pos, ilist.begin(), ilist.end()); }
+
+  // erase / clear
+  iterator erase(const_iterator pos)
+  { return erase(pos, pos + 1); }
+  iterator erase(const_iterator first, const_iterator last);
+  void     clear() noexcept
+  {
+    mystl::destroy(begin(), end());
+    size_ = 0;
+  }
+
+  // resize / reverse
+  void     resize(size_type new_size);
+  void     resize(size_type new_size, const value_type& value);
+  // 新增的元素默认初始化，平凡默认构造的元素不写入任何值
+  void     resize_default_init(size_type new_size);
+
+  void     reverse() { mystl::reverse(begin(), end()); }
+
+  // swap
+  void     swap(static_vector& rhs);
+
+private:
+  // helper functions
+
+  // 已有 used 个元素时还能放下 n 个，否则抛出 length_error
+  static void check_room(size_type used, size_type n)
+  { THROW_LENGTH_ERROR_IF(n > N - used, "static_vector<T, N>'s size too big"); }
+
+  static void move_bytes(pointer dst, const_pointer src, size_type n) noexcept
+  {
+    if (n != 0)
+      std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+  }
+
+  template <class... Args>
+  void     construct_back(Args&& ...args)
+  {
+    mystl::construct(end(), mystl::forward<Args>(args)...);
+    ++size_;
+  }
+
+  // 在尾部追加 n 个 value，失败时删除已追加的部分
+  void     fill_back(size_type n, const value_type& value);
+
+  // 把尾部从 old_size 开始追加的元素旋转到 pos，追加失败时删除已追加的部分
+  iterator rotate_into(iterator pos, size_type old_size);
+
+  template <class IIter>
+  iterator copy_insert(iterator pos, IIter first, IIter last, input_iterator_tag);
+  template <class FIter>
+  iterator copy_insert(iterator pos, FIter first, FIter last, forward_iterator_tag);
+
+  void     take(static_vector& rhs, m_true_type) noexcept;
+  void     take(static_vector& rhs, m_false_type);
+};
+
+/*****************************************************************************************/
+
+// 在 pos 位置就地构造元素
+template <class T, size_t N>
+template <class... Args>
+typename static_vector<T, N>::iterator
+static_vector<T, N>::emplace(const_iterator pos, Args&& ...args)
+{
+  MYSTL_DEBUG(pos >= begin() && pos <= end());
+  check_room(size_, 1);
+  iterator xpos = const_cast<iterator>(pos);
+  if (xpos == end())
+  {
+    construct_back(mystl::forward<Args>(args)...);
+    return xpos;
+  }
+  if (relocatable::value)
+  { // 参数可能引用容器中的元素，先构造出新元素再后移
+    value_type tmp(mystl::forward<Args>(args)...);
+    const size_type after = end() - xpos;
+    move_bytes(xpos + 1, xpos, after);
+    try
+    {
+      mystl::construct(xpos, mystl::move(tmp));
+    }
+    catch (...)
+    {
+      move_bytes(xpos, xpos + 1, after);
+      throw;
+    }
+    ++size_;
+    return xpos;
+  }
+  const size_type old_size = size_;
+  construct_back(mystl::forward<Args>(args)...);
+  return rotate_into(xpos, old_size);
+}
+
+// 在 pos 处插入 n 个 value
+template <class T, size_t N>
+typename static_vector<T, N>::iterator
+static_vector<T, N>::insert(const_iterator pos, size_type n, const value_type& value)
+{
+  MYSTL_DEBUG(pos >= begin() && pos <= end());
+  check_room(size_, n);
+  iterator xpos = const_cast<iterator>(pos);
+  if (n == 0)
+    return xpos;
+  value_type tmp(value);  // value 可能是容器中的元素
+  if (relocatable::value)
+  {
+    const size_type after = end() - xpos;
+    move_bytes(xpos + n, xpos, after);
+    iterator cur = xpos;
+    try
+    {
+      for (; cur != xpos + n; ++cur)
+        mystl::construct(cur, tmp);
+    }
+    catch (...)
+    {
+      mystl::destroy(xpos, cur);
+      move_bytes(xpos, xpos + n, after);
+      throw;
+    }
+    size_ += n;
+    return xpos;
+  }
+  const size_type old_size = size_;
+  fill_back(n, tmp);
+  return rotate_into(xpos, old_size);
+}
+
+// 删除[first, last)上的元素
+template <class T, size_t N>
+typename static_vector<T, N>::iterator
+static_vector<T, N>::erase(const_iterator first, const_iterator last)
+{
+  MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+  iterator xfirst = const_cast<iterator>(first);
+  iterator xlast = const_cast<iterator>(last);
+  if (xfirst == xlast)
+    return xfirst;
+  if (relocatable::value)
+  {
+    mystl::destroy(xfirst, xlast);
+    move_bytes(xfirst, xlast, end() - xlast);
+  }
+  else
+  {
+    iterator new_end = mystl::move(xlast, end(), xfirst);
+    mystl::destroy(new_end, end());
+  }
+  size_ -= xlast - xfirst;
+  return xfirst;
+}
+
+// 重置容器大小，新增的元素值初始化
+template <class T, size_t N>
+void static_vector<T, N>::resize(size_type new_size)
+{
+  if (new_size < size_)
+  {
+    erase(begin() + new_size, end());
+    return;
+  }
+  check_room(0, new_size);
+  const size_type old_size = size_;
+  try
+  {
+    while (size_ < new_size)
+      construct_back();
+  }
+  catch (...)
+  {
+    erase(begin() + old_size, end());
+    throw;
+  }
+}
+
+template <class T, size_t N>
+void static_vector<T, N>::resize(size_type new_size, const value_type& value)
+{
+  if (new_size < size_)
+    erase(begin() + new_size, end());
+  else
+    insert(end(), new_size - size_, value);
+}
+
+template <class T, size_t N>
+void static_vector<T, N>::resize_default_init(size_type new_size)
+{
+  if (new_size < size_)
+  {
+    erase(begin() + new_size, end());
+    return;
+  }
+  check_room(0, new_size);
+  mystl::uninitialized_default_construct_n(end(), new_size - size_);
+  size_ = new_size;
+}
+
+// 交换公共部分，多出的元素搬到较短的一方
+template <class T, size_t N>
+void static_vector<T, N>::swap(static_vector& rhs)
+{
+  if (this == &rhs)
+    return;
+  static_vector& longer = size_ < rhs.size_ ? rhs : *this;
+  static_vector& shorter = size_ < rhs.size_ ? *this : rhs;
+  const size_type common = shorter.size_;
+  mystl::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+  if (relocatable::value)
+  {
+    move_bytes(shorter.end(), longer.begin() + common, longer.size_ - common);
+    shorter.size_ = longer.size_;
+    longer.size_ = common;
+    return;
+  }
+  for (iterator it = longer.begin() + common; it != longer.end(); ++it)
+    shorter.construct_back(mystl::move(*it));
+  longer.erase(longer.begin() + common, longer.end());
+}
+
+/*****************************************************************************************/
+// helper function
+
+template <class T, size_t N>
+void static_vector<T, N>::fill_back(size_type n, const value_type& value)
+{
+  const size_type old_size = size_;
+  try
+  {
+    for (; n > 0; --n)
+      construct_back(value);
+  }
+  catch (...)
+  {
+    erase(begin() + old_size, end());
+    throw;
+  }
+}
+
+template <class T, size_t N>
+typename static_vector<T, N>::iterator
+static_vector<T, N>::rotate_into(iterator pos, size_type old_size)
+{
+  mystl::rotate(pos, begin() + old_size, end());
+  return pos;
+}
+
+template <class T, size_t N>
+template <class IIter>
+typename static_vector<T, N>::iterator
+static_vector<T, N>::copy_insert(iterator pos, IIter first, IIter last, input_iterator_tag)
+{
+  const size_type old_size = size_;
+  try
+  {
+    for (; first != last; ++first)
+    {
+      check_room(size_, 1);
+      construct_back(*first);
+    }
+  }
+  catch (...)
+  {
+    erase(begin() + old_size, end());
+    throw;
+  }
+  return rotate_into(pos, old_size);
+}
+
+template <class T, size_t N>
+template <class FIter>
+typename static_vector<T, N>::iterator
+static_vector<T, N>::copy_insert(iterator pos, FIter first, FIter last, forward_iterator_tag)
+{
+  const size_type n = mystl::distance(first, last);
+  check_room(size_, n);
+  if (n == 0)
+    return pos;
+  // 先追加到尾部再旋转，[first, last) 引用容器自身的元素时也正确
+  const size_type old_size = size_;
+  if (std::is_trivially_copyable<T>::value)
+  {
+    mystl::uninitialized_copy(first, last, end());
+    size_ += n;
+    return rotate_into(pos, old_size);
+  }
+  try
+  {
+    for (; first != last; ++first)
+      construct_back(*first);
+  }
+  catch (...)
+  {
+    erase(begin() + old_size, end());
+    throw;
+  }
+  return rotate_into(pos, old_size);
+}
+
+// 接管 rhs 的元素：可以平凡重定位时直接复制内存，rhs 变为空
+template <class T, size_t N>
+void static_vector<T, N>::take(static_vector& rhs, m_true_type) noexcept
+{
+  move_bytes(data(), rhs.data(), rhs.size_);
+  size_ = rhs.size_;
+  rhs.size_ = 0;
+}
+
+template <class T, size_t N>
+void static_vector<T, N>::take(static_vector& rhs, m_false_type)
+{
+  for (auto& x : rhs)
+    construct_back(mystl::move(x));
+  rhs.clear();
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+
+template <class T, size_t N>
+bool operator==(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+  return lhs.size() == rhs.size() &&
+    mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, size_t N>
+bool operator<(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, size_t N>
+bool operator!=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T, size_t N>
+bool operator>(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T, size_t N>
+bool operator<=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T, size_t N>
+bool operator>=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, size_t N>
+void swap(static_vector<T, N>& lhs, static_vector<T, N>& rhs)
+{
+  lhs.swap(rhs);
+}
+
+// 元素保存在对象内部，但没有指向自身的指针，元素可以平凡重定位时容器也可以平凡重定位
+template <class T, size_t N>
+struct is_trivially_relocatable<static_vector<T, N>>
+  : m_bool_constant<is_trivially_relocatable<T>::value> {};
+
+} // namespace mystl
+#endif // !MYTINYSTL_STATIC_VECTOR_H_
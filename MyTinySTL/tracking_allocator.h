@@ -0,0 +1,204 @@
+#ifndef MYTINYSTL_TRACKING_ALLOCATOR_H_
+#define MYTINYSTL_TRACKING_ALLOCATOR_H_
+
+// 这个头文件包含一个类 allocation_stats 和一个模板类 tracking_allocator，用于统计容器的内存分配
+//
+// allocation_stats   : 记录累计分配的字节数、存活字节数、峰值、分配与回收次数以及按大小分级的直方图
+// tracking_allocator : 配置器适配器，把请求转交给底层配置器，同时把每次分配与回收记入一个 allocation_stats
+
+// notes:
+//
+// 1. 多个容器可以共用同一个 allocation_stats，用来统计一组容器的总占用；
+//    默认构造的 tracking_allocator 记入全局的 default_allocation_stats()
+// 2. allocation_stats 不加锁，共用同一个 allocation_stats 的容器不能在多个线程中同时修改
+// 3. tracking_allocator 在复制、移动、交换容器时总是随之传播，保证内存由记录它的 allocation_stats 回收，
+//    底层配置器跟随 tracking_allocator 一起传播
+// 4. 直方图第 i 格统计大小在 (2^(i-1), 2^i] 之间的请求，最后一格统计其余更大的请求
+
+#include <cstddef>
+
+#include "allocator.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// 类 : allocation_stats
+class allocation_stats
+{
+public:
+  enum { EHistogramSize = 32 };
+
+  size_t allocated_bytes;               // 累计分配的字节数
+  size_t deallocated_bytes;             // 累计回收的字节数
+  size_t live_bytes;                    // 当前存活的字节数
+  size_t peak_bytes;                    // 存活字节数的峰值
+  size_t allocations;                   // 分配次数
+  size_t deallocations;                 // 回收次数
+  size_t histogram[EHistogramSize];     // 按请求大小分级的分配次数
+
+public:
+  allocation_stats() noexcept { reset(); }
+
+  void reset() noexcept
+  {
+    allocated_bytes = 0;
+    deallocated_bytes = 0;
+    live_bytes = 0;
+    peak_bytes = 0;
+    allocations = 0;
+    deallocations = 0;
+    for (size_t i = 0; i < EHistogramSize; ++i)
+      histogram[i] = 0;
+  }
+
+  void record_allocate(size_t bytes) noexcept
+  {
+    allocated_bytes += bytes;
+    live_bytes += bytes;
+    if (live_bytes > peak_bytes)
+      peak_bytes = live_bytes;
+    ++allocations;
+    ++histogram[histogram_index(bytes)];
+  }
+
+  void record_deallocate(size_t bytes) noexcept
+  {
+    deallocated_bytes += bytes;
+    live_bytes -= bytes;
+    ++deallocations;
+  }
+
+  // 大小为 bytes 的请求记入直方图的哪一格
+  static size_t histogram_index(size_t bytes) noexcept
+  {
+    size_t i = 0;
+    while (i + 1 < EHistogramSize && (static_cast<size_t>(1) << i) < bytes)
+      ++i;
+    return i;
+  }
+};
+
+// 默认构造的 tracking_allocator 使用的全局统计
+inline allocation_stats& default_allocation_stats() noexcept
+{
+  static allocation_stats stats;
+  return stats;
+}
+
+// 模板类：tracking_allocator
+// 模板参数 T 代表数据类型，Alloc 代表实际分配内存的配置器
+template <class T, class Alloc = mystl::allocator<T>>
+class tracking_allocator
+{
+  template <class U, class A> friend class tracking_allocator;
+
+public:
+  typedef T            value_type;
+  typedef T*           pointer;
+  typedef const T*     const_pointer;
+  typedef T&           reference;
+  typedef const T&     const_reference;
+  typedef size_t       size_type;
+  typedef ptrdiff_t    difference_type;
+  typedef Alloc        inner_allocator_type;
+
+  typedef m_true_type  propagate_on_container_copy_assignment;
+  typedef m_true_type  propagate_on_container_move_assignment;
+  typedef m_true_type  propagate_on_container_swap;
+  typedef m_false_type is_always_equal;
+
+  template <class U>
+  struct rebind
+  {
+    typedef tracking_allocator<U, typename mystl::alloc_rebind<Alloc, U>::type> other;
+  };
+
+private:
+  typedef mystl::allocator_traits<Alloc> inner_traits;
+
+  Alloc             alloc_;  // 底层配置器
+  allocation_stats* stats_;  // 记录分配的统计
+
+public:
+  tracking_allocator() noexcept
+    :alloc_(), stats_(&default_allocation_stats())
+  {
+  }
+
+  explicit tracking_allocator(allocation_stats* stats, const Alloc& alloc = Alloc()) noexcept
+    :alloc_(alloc), stats_(stats)
+  {
+    MYSTL_DEBUG(stats != nullptr);
+  }
+
+  template <class U, class A>
+  tracking_allocator(const tracking_allocator<U, A>& other) noexcept
+    :alloc_(other.alloc_), stats_(other.stats_)
+  {
+  }
+
+public:
+  T* allocate(size_type n)
+  {
+    T* p = inner_traits::allocate(alloc_, n);
+    stats_->record_allocate(n * sizeof(T));
+    return p;
+  }
+
+  // 底层配置器多给出的空间同样记入统计
+  allocation_result<T*> allocate_at_least(size_type n)
+  {
+    auto r = inner_traits::allocate_at_least(alloc_, n);
+    stats_->record_allocate(r.count * sizeof(T));
+    return { r.ptr, r.count };
+  }
+
+  void deallocate(T* p, size_type n)
+  {
+    if (p == nullptr)
+      return;
+    stats_->record_deallocate(n * sizeof(T));
+    inner_traits::deallocate(alloc_, p, n);
+  }
+
+  template <class U, class... Args>
+  void construct(U* p, Args&& ...args)
+  {
+    inner_traits::construct(alloc_, p, mystl::forward<Args>(args)...);
+  }
+
+  template <class U>
+  void destroy(U* p)
+  {
+    inner_traits::destroy(alloc_, p);
+  }
+
+  size_type max_size() const noexcept
+  { return inner_traits::max_size(alloc_); }
+
+  tracking_allocator select_on_container_copy_construction() const
+  { return tracking_allocator(stats_, inner_traits::select_on_container_copy_construction(alloc_)); }
+
+  allocation_stats*    stats() const noexcept { return stats_; }
+  const Alloc&         inner_allocator() const noexcept { return alloc_; }
+};
+
+/*****************************************************************************************/
+
+// 记入同一个统计且底层配置器相等时才相等
+template <class T1, class A1, class T2, class A2>
+bool operator==(const tracking_allocator<T1, A1>& lhs, const tracking_allocator<T2, A2>& rhs) noexcept
+{
+  return lhs.stats() == rhs.stats() && lhs.inner_allocator() == rhs.inner_allocator();
+}
+
+template <class T1, class A1, class T2, class A2>
+bool operator!=(const tracking_allocator<T1, A1>& lhs, const tracking_allocator<T2, A2>& rhs) noexcept
+{
+  return !(lhs == rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_TRACKING_ALLOCATOR_H_
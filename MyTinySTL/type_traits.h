@@ -39,6 +39,19 @@ struct is_pair : mystl::m_false_type {};
 template <class T1, class T2>
 struct is_pair<mystl::pair<T1, T2>> : mystl::m_true_type {};
 
+// is_trivially_relocatable
+// 把对象按字节复制到新的地址，并且不再对原来的对象调用析构函数，效果等同于移动构造后再析构原对象时，
+// 称该类型可以平凡重定位，容器搬移这样的元素时可以直接使用 memcpy / memmove
+// 平凡可复制的类型总是可以平凡重定位；不保存指向自身的指针的类型也可以，
+// 用户可以为这样的类型特化本模板，mystl 的容器与 pair 已经特化
+
+template <class T>
+struct is_trivially_relocatable : m_bool_constant<std::is_trivially_copyable<T>::value> {};
+
+template <class T1, class T2>
+struct is_trivially_relocatable<mystl::pair<T1, T2>>
+  : m_bool_constant<is_trivially_relocatable<T1>::value && is_trivially_relocatable<T2>::value> {};
+
 } // namespace mystl
 
 #endif // !MYTINYSTL_TYPE_TRAITS_H_
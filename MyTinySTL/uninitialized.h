@@ -251,6 +251,50 @@ ForwardIter uninitialized_move_n(InputIter first, Size n, ForwardIter result)
                                         value_type>{});
 }
 
+/*****************************************************************************************/
+// uninitialized_default_construct_n
+// 在以 first 为起始处的空间上默认初始化 n 个元素，返回构造结束的位置
+// 平凡默认构造的元素不写入任何值，内容不确定
+/*****************************************************************************************/
+template <class ForwardIter, class Size>
+ForwardIter 
+unchecked_uninit_default_construct_n(ForwardIter first, Size n, std::true_type)
+{
+  mystl::advance(first, n);
+  return first;
+}
+
+template <class ForwardIter, class Size>
+ForwardIter
+unchecked_uninit_default_construct_n(ForwardIter first, Size n, std::false_type)
+{
+  typedef typename iterator_traits<ForwardIter>::value_type value_type;
+  auto cur = first;
+  try
+  {
+    for (; n > 0; --n, ++cur)
+    {
+      ::new (static_cast<void*>(&*cur)) value_type;
+    }
+  }
+  catch (...)
+  {
+    for (; first != cur; ++first)
+      mystl::destroy(&*first);
+    throw;
+  }
+  return cur;
+}
+
+template <class ForwardIter, class Size>
+ForwardIter uninitialized_default_construct_n(ForwardIter first, Size n)
+{
+  return mystl::unchecked_uninit_default_construct_n(first, n,
+                                                     std::is_trivially_default_constructible<
+                                                     typename iterator_traits<ForwardIter>::
+                                                     value_type>{});
+}
+
 } // namespace mystl
 #endif // !MYTINYSTL_UNINITIALIZED_H_
 
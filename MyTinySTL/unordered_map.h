@@ -20,12 +20,14 @@ namespace mystl
 // 模板类 unordered_map，键值不允许重复
 // 参数一代表键值类型，参数二代表实值类型，参数三代表哈希函数，缺省使用 mystl::hash
 // 参数四代表键值比较方式，缺省使用 mystl::equal_to
-template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+// 参数五代表空间配置器，缺省使用 mystl::allocator
+template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>,
+          class Alloc = mystl::allocator<mystl::pair<const Key, T>>>
 class unordered_map
 {
 private:
   // 使用 hashtable 作为底层机制
-  typedef hashtable<mystl::pair<const Key, T>, Hash, KeyEqual> base_type;
+  typedef hashtable<mystl::pair<const Key, T>, Hash, KeyEqual, Alloc> base_type;
   base_type ht_;
 
 public:
@@ -60,10 +62,16 @@ public:
   {
   }
 
+  explicit unordered_map(const allocator_type& alloc)
+    :ht_(100, Hash(), KeyEqual(), alloc)
+  {
+  }
+
   explicit unordered_map(size_type bucket_count,
                          const Hash& hash = Hash(),
-                         const KeyEqual& equal = KeyEqual())
-    :ht_(bucket_count, hash, equal)
+                         const KeyEqual& equal = KeyEqual(),
+                         const allocator_type& alloc = allocator_type())
+    :ht_(bucket_count, hash, equal, alloc)
   {
   }
 
@@ -71,8 +79,9 @@ public:
   unordered_map(InputIterator first, InputIterator last,
                 const size_type bucket_count = 100,
                 const Hash& hash = Hash(),
-                const KeyEqual& equal = KeyEqual())
-    : ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal)
+                const KeyEqual& equal = KeyEqual(),
+                const allocator_type& alloc = allocator_type())
+    :ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal, alloc)
   {
     for (; first != last; ++first)
       ht_.insert_unique_noresize(*first);
@@ -81,8 +90,9 @@ public:
   unordered_map(std::initializer_list<value_type> ilist,
                 const size_type bucket_count = 100,
                 const Hash& hash = Hash(),
-                const KeyEqual& equal = KeyEqual())
-    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal)
+                const KeyEqual& equal = KeyEqual(),
+                const allocator_type& alloc = allocator_type())
+    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal, alloc)
   {
     for (auto first = ilist.begin(), last = ilist.end(); first != last; ++first)
       ht_.insert_unique_noresize(*first);
@@ -92,10 +102,18 @@ public:
     :ht_(rhs.ht_) 
   {
   }
+  unordered_map(const unordered_map& rhs, const allocator_type& alloc)
+    :ht_(rhs.ht_, alloc)
+  {
+  }
   unordered_map(unordered_map&& rhs) noexcept
     :ht_(mystl::move(rhs.ht_)) 
   {
   }
+  unordered_map(unordered_map&& rhs, const allocator_type& alloc)
+    :ht_(mystl::move(rhs.ht_), alloc)
+  {
+  }
 
   unordered_map& operator=(const unordered_map& rhs) 
   { 
@@ -140,6 +158,7 @@ public:
   bool      empty()    const noexcept { return ht_.empty(); }
   size_type size()     const noexcept { return ht_.size(); }
   size_type max_size() const noexcept { return ht_.max_size(); }
+  memory_usage_info memory_usage() const noexcept { return ht_.memory_usage(); }
 
   // 修改容器操作
 
@@ -270,33 +289,33 @@ public:
 public:
   friend bool operator==(const unordered_map& lhs, const unordered_map& rhs)
   {
-    return lhs.ht_.equal_range_unique(rhs.ht_);
+    return lhs.ht_.equal_to_unique(rhs.ht_);
   }
   friend bool operator!=(const unordered_map& lhs, const unordered_map& rhs)
   {
-    return !lhs.ht_.equal_range_unique(rhs.ht_);
+    return !lhs.ht_.equal_to_unique(rhs.ht_);
   }
 };
 
 // 重载比较操作符
-template <class Key, class T, class Hash, class KeyEqual>
-bool operator==(const unordered_map<Key, T, Hash, KeyEqual>& lhs,
-                const unordered_map<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+bool operator==(const unordered_map<Key, T, Hash, KeyEqual, Alloc>& lhs,
+                const unordered_map<Key, T, Hash, KeyEqual, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class T, class Hash, class KeyEqual>
-bool operator!=(const unordered_map<Key, T, Hash, KeyEqual>& lhs,
-                const unordered_map<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+bool operator!=(const unordered_map<Key, T, Hash, KeyEqual, Alloc>& lhs,
+                const unordered_map<Key, T, Hash, KeyEqual, Alloc>& rhs)
 {
   return lhs != rhs;
 }
 
 // 重载 mystl 的 swap
-template <class Key, class T, class Hash, class KeyEqual>
-void swap(unordered_map<Key, T, Hash, KeyEqual>& lhs,
-          unordered_map<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void swap(unordered_map<Key, T, Hash, KeyEqual, Alloc>& lhs,
+          unordered_map<Key, T, Hash, KeyEqual, Alloc>& rhs)
 {
   lhs.swap(rhs);
 }
@@ -306,12 +325,14 @@ void swap(unordered_map<Key, T, Hash, KeyEqual>& lhs,
 // 模板类 unordered_multimap，键值允许重复
 // 参数一代表键值类型，参数二代表实值类型，参数三代表哈希函数，缺省使用 mystl::hash
 // 参数四代表键值比较方式，缺省使用 mystl::equal_to
-template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+// 参数五代表空间配置器，缺省使用 mystl::allocator
+template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>,
+          class Alloc = mystl::allocator<mystl::pair<const Key, T>>>
 class unordered_multimap
 {
 private:
   // 使用 hashtable 作为底层机制
-  typedef hashtable<pair<const Key, T>, Hash, KeyEqual> base_type;
+  typedef hashtable<pair<const Key, T>, Hash, KeyEqual, Alloc> base_type;
   base_type ht_;
 
 public:
@@ -345,10 +366,16 @@ public:
   {
   }
 
+  explicit unordered_multimap(const allocator_type& alloc)
+    :ht_(100, Hash(), KeyEqual(), alloc)
+  {
+  }
+
   explicit unordered_multimap(size_type bucket_count,
                               const Hash& hash = Hash(),
-                              const KeyEqual& equal = KeyEqual())
-    :ht_(bucket_count, hash, equal) 
+                              const KeyEqual& equal = KeyEqual(),
+                              const allocator_type& alloc = allocator_type())
+    :ht_(bucket_count, hash, equal, alloc) 
   {
   }
 
@@ -356,8 +383,9 @@ public:
   unordered_multimap(InputIterator first, InputIterator last,
                      const size_type bucket_count = 100,
                      const Hash& hash = Hash(),
-                     const KeyEqual& equal = KeyEqual())
-    :ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal)
+                     const KeyEqual& equal = KeyEqual(),
+                     const allocator_type& alloc = allocator_type())
+    :ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal, alloc)
   {
     for (; first != last; ++first)
       ht_.insert_multi_noresize(*first);
@@ -366,8 +394,9 @@ public:
   unordered_multimap(std::initializer_list<value_type> ilist,
                      const size_type bucket_count = 100,
                      const Hash& hash = Hash(),
-                     const KeyEqual& equal = KeyEqual())
-    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal)
+                     const KeyEqual& equal = KeyEqual(),
+                     const allocator_type& alloc = allocator_type())
+    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal, alloc)
   {
     for (auto first = ilist.begin(), last = ilist.end(); first != last; ++first)
       ht_.insert_multi_noresize(*first);
@@ -377,10 +406,18 @@ public:
     :ht_(rhs.ht_) 
   {
   }
+  unordered_multimap(const unordered_multimap& rhs, const allocator_type& alloc)
+    :ht_(rhs.ht_, alloc)
+  {
+  }
   unordered_multimap(unordered_multimap&& rhs) noexcept
     :ht_(mystl::move(rhs.ht_))
   {
   }
+  unordered_multimap(unordered_multimap&& rhs, const allocator_type& alloc)
+    :ht_(mystl::move(rhs.ht_), alloc)
+  {
+  }
 
   unordered_multimap& operator=(const unordered_multimap& rhs)
   { 
@@ -425,6 +462,7 @@ public:
   bool      empty()    const noexcept { return ht_.empty(); }
   size_type size()     const noexcept { return ht_.size(); }
   size_type max_size() const noexcept { return ht_.max_size(); }
+  memory_usage_info memory_usage() const noexcept { return ht_.memory_usage(); }
 
   // 修改容器相关
 
@@ -527,37 +565,50 @@ public:
 public:
   friend bool operator==(const unordered_multimap& lhs, const unordered_multimap& rhs)
   {
-    return lhs.ht_.equal_range_multi(rhs.ht_);
+    return lhs.ht_.equal_to_multi(rhs.ht_);
   }
   friend bool operator!=(const unordered_multimap& lhs, const unordered_multimap& rhs)
   {
-    return !lhs.ht_.equal_range_multi(rhs.ht_);
+    return !lhs.ht_.equal_to_multi(rhs.ht_);
   }
 };
 
 // 重载比较操作符
-template <class Key, class T, class Hash, class KeyEqual>
-bool operator==(const unordered_multimap<Key, T, Hash, KeyEqual>& lhs,
-                const unordered_multimap<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+bool operator==(const unordered_multimap<Key, T, Hash, KeyEqual, Alloc>& lhs,
+                const unordered_multimap<Key, T, Hash, KeyEqual, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class T, class Hash, class KeyEqual>
-bool operator!=(const unordered_multimap<Key, T, Hash, KeyEqual>& lhs,
-                const unordered_multimap<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+bool operator!=(const unordered_multimap<Key, T, Hash, KeyEqual, Alloc>& lhs,
+                const unordered_multimap<Key, T, Hash, KeyEqual, Alloc>& rhs)
 {
   return lhs != rhs;
 }
 
 // 重载 mystl 的 swap
-template <class Key, class T, class Hash, class KeyEqual>
-void swap(unordered_multimap<Key, T, Hash, KeyEqual>& lhs,
-          unordered_multimap<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void swap(unordered_multimap<Key, T, Hash, KeyEqual, Alloc>& lhs,
+          unordered_multimap<Key, T, Hash, KeyEqual, Alloc>& rhs)
 {
   lhs.swap(rhs);
 }
 
+// 与 hashtable 相同，Hash、KeyEqual、Alloc 可以平凡重定位时容器也可以平凡重定位
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+struct is_trivially_relocatable<unordered_map<Key, T, Hash, KeyEqual, Alloc>>
+  : m_bool_constant<is_trivially_relocatable<Hash>::value &&
+    is_trivially_relocatable<KeyEqual>::value &&
+    is_trivially_relocatable<Alloc>::value> {};
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+struct is_trivially_relocatable<unordered_multimap<Key, T, Hash, KeyEqual, Alloc>>
+  : m_bool_constant<is_trivially_relocatable<Hash>::value &&
+    is_trivially_relocatable<KeyEqual>::value &&
+    is_trivially_relocatable<Alloc>::value> {};
+
 } // namespace mystl
 #endif // !MYTINYSTL_UNORDERED_MAP_H_
 
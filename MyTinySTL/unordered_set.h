@@ -20,12 +20,14 @@ namespace mystl
 // 模板类 unordered_set，键值不允许重复
 // 参数一代表键值类型，参数二代表哈希函数，缺省使用 mystl::hash，
 // 参数三代表键值比较方式，缺省使用 mystl::equal_to
-template <class Key, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+// 参数四代表空间配置器，缺省使用 mystl::allocator
+template <class Key, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>,
+          class Alloc = mystl::allocator<Key>>
 class unordered_set
 {
 private:
   // 使用 hashtable 作为底层机制
-  typedef hashtable<Key, Hash, KeyEqual> base_type;
+  typedef hashtable<Key, Hash, KeyEqual, Alloc> base_type;
   base_type ht_;
 
 public:
@@ -58,10 +60,16 @@ public:
   {
   }
 
+  explicit unordered_set(const allocator_type& alloc)
+    :ht_(100, Hash(), KeyEqual(), alloc)
+  {
+  }
+
   explicit unordered_set(size_type bucket_count,
                          const Hash& hash = Hash(),
-                         const KeyEqual& equal = KeyEqual())
-    :ht_(bucket_count, hash, equal)
+                         const KeyEqual& equal = KeyEqual(),
+                         const allocator_type& alloc = allocator_type())
+    :ht_(bucket_count, hash, equal, alloc)
   {
   }
 
@@ -69,8 +77,9 @@ public:
   unordered_set(InputIterator first, InputIterator last,
                 const size_type bucket_count = 100,
                 const Hash& hash = Hash(),
-                const KeyEqual& equal = KeyEqual())
-    : ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal)
+                const KeyEqual& equal = KeyEqual(),
+                const allocator_type& alloc = allocator_type())
+    :ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal, alloc)
   {
     for (; first != last; ++first)
       ht_.insert_unique_noresize(*first);
@@ -79,8 +88,9 @@ public:
   unordered_set(std::initializer_list<value_type> ilist,
                 const size_type bucket_count = 100,
                 const Hash& hash = Hash(),
-                const KeyEqual& equal = KeyEqual())
-    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal)
+                const KeyEqual& equal = KeyEqual(),
+                const allocator_type& alloc = allocator_type())
+    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal, alloc)
   {
     for (auto first = ilist.begin(), last = ilist.end(); first != last; ++first)
       ht_.insert_unique_noresize(*first);
@@ -90,10 +100,18 @@ public:
     :ht_(rhs.ht_)
   {
   }
+  unordered_set(const unordered_set& rhs, const allocator_type& alloc)
+    :ht_(rhs.ht_, alloc)
+  {
+  }
   unordered_set(unordered_set&& rhs) noexcept
     : ht_(mystl::move(rhs.ht_))
   {
   }
+  unordered_set(unordered_set&& rhs, const allocator_type& alloc)
+    :ht_(mystl::move(rhs.ht_), alloc)
+  {
+  }
 
   unordered_set& operator=(const unordered_set& rhs)
   {
@@ -138,6 +156,7 @@ public:
   bool      empty()    const noexcept { return ht_.empty(); }
   size_type size()     const noexcept { return ht_.size(); }
   size_type max_size() const noexcept { return ht_.max_size(); }
+  memory_usage_info memory_usage() const noexcept { return ht_.memory_usage(); }
 
   // 修改容器操作
 
@@ -241,33 +260,33 @@ public:
 public:
   friend bool operator==(const unordered_set& lhs, const unordered_set& rhs)
   {
-    return lhs.ht_.equal_range_unique(rhs.ht_);
+    return lhs.ht_.equal_to_unique(rhs.ht_);
   }
   friend bool operator!=(const unordered_set& lhs, const unordered_set& rhs)
   {
-    return !lhs.ht_.equal_range_unique(rhs.ht_);
+    return !lhs.ht_.equal_to_unique(rhs.ht_);
   }
 };
 
 // 重载比较操作符
 template <class Key, class Hash, class KeyEqual, class Alloc>
-bool operator==(const unordered_set<Key, Hash, KeyEqual>& lhs,
-                const unordered_set<Key, Hash, KeyEqual>& rhs)
+bool operator==(const unordered_set<Key, Hash, KeyEqual, Alloc>& lhs,
+                const unordered_set<Key, Hash, KeyEqual, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
 template <class Key, class Hash, class KeyEqual, class Alloc>
-bool operator!=(const unordered_set<Key, Hash, KeyEqual>& lhs,
-                const unordered_set<Key, Hash, KeyEqual>& rhs)
+bool operator!=(const unordered_set<Key, Hash, KeyEqual, Alloc>& lhs,
+                const unordered_set<Key, Hash, KeyEqual, Alloc>& rhs)
 {
   return lhs != rhs;
 }
 
 // 重载 mystl 的 swap
 template <class Key, class Hash, class KeyEqual, class Alloc>
-void swap(unordered_set<Key, Hash, KeyEqual>& lhs,
-          unordered_set<Key, Hash, KeyEqual>& rhs)
+void swap(unordered_set<Key, Hash, KeyEqual, Alloc>& lhs,
+          unordered_set<Key, Hash, KeyEqual, Alloc>& rhs)
 {
   lhs.swap(rhs);
 }
@@ -277,12 +296,14 @@ void swap(unordered_set<Key, Hash, KeyEqual>& lhs,
 // 模板类 unordered_multiset，键值允许重复
 // 参数一代表键值类型，参数二代表哈希函数，缺省使用 mystl::hash，
 // 参数三代表键值比较方式，缺省使用 mystl::equal_to
-template <class Key, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+// 参数四代表空间配置器，缺省使用 mystl::allocator
+template <class Key, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>,
+          class Alloc = mystl::allocator<Key>>
 class unordered_multiset
 {
 private:
   // 使用 hashtable 作为底层机制
-  typedef hashtable<Key, Hash, KeyEqual> base_type;
+  typedef hashtable<Key, Hash, KeyEqual, Alloc> base_type;
   base_type ht_;
 
 public:
@@ -315,10 +336,16 @@ public:
   {
   }
 
+  explicit unordered_multiset(const allocator_type& alloc)
+    :ht_(100, Hash(), KeyEqual(), alloc)
+  {
+  }
+
   explicit unordered_multiset(size_type bucket_count,
                               const Hash& hash = Hash(),
-                              const KeyEqual& equal = KeyEqual())
-    :ht_(bucket_count, hash, equal)
+                              const KeyEqual& equal = KeyEqual(),
+                              const allocator_type& alloc = allocator_type())
+    :ht_(bucket_count, hash, equal, alloc)
   {
   }
 
@@ -326,8 +353,9 @@ public:
   unordered_multiset(InputIterator first, InputIterator last,
                      const size_type bucket_count = 100,
                      const Hash& hash = Hash(),
-                     const KeyEqual& equal = KeyEqual())
-    : ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal)
+                     const KeyEqual& equal = KeyEqual(),
+                     const allocator_type& alloc = allocator_type())
+    :ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal, alloc)
   {
     for (; first != last; ++first)
       ht_.insert_multi_noresize(*first);
@@ -336,8 +364,9 @@ public:
   unordered_multiset(std::initializer_list<value_type> ilist,
                      const size_type bucket_count = 100,
                      const Hash& hash = Hash(),
-                     const KeyEqual& equal = KeyEqual())
-    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal)
+                     const KeyEqual& equal = KeyEqual(),
+                     const allocator_type& alloc = allocator_type())
+    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal, alloc)
   {
     for (auto first = ilist.begin(), last = ilist.end(); first != last; ++first)
       ht_.insert_multi_noresize(*first);
@@ -347,10 +376,18 @@ public:
     :ht_(rhs.ht_)
   {
   }
+  unordered_multiset(const unordered_multiset& rhs, const allocator_type& alloc)
+    :ht_(rhs.ht_, alloc)
+  {
+  }
   unordered_multiset(unordered_multiset&& rhs) noexcept
     : ht_(mystl::move(rhs.ht_))
   {
   }
+  unordered_multiset(unordered_multiset&& rhs, const allocator_type& alloc)
+    :ht_(mystl::move(rhs.ht_), alloc)
+  {
+  }
 
   unordered_multiset& operator=(const unordered_multiset& rhs)
   {
@@ -396,6 +433,7 @@ public:
   bool      empty()    const noexcept { return ht_.empty(); }
   size_type size()     const noexcept { return ht_.size(); }
   size_type max_size() const noexcept { return ht_.max_size(); }
+  memory_usage_info memory_usage() const noexcept { return ht_.memory_usage(); }
 
   // 修改容器相关
 
@@ -498,37 +536,50 @@ public:
 public:
   friend bool operator==(const unordered_multiset& lhs, const unordered_multiset& rhs)
   {
-    return lhs.ht_.equal_range_multi(rhs.ht_);
+    return lhs.ht_.equal_to_multi(rhs.ht_);
   }
   friend bool operator!=(const unordered_multiset& lhs, const unordered_multiset& rhs)
   {
-    return !lhs.ht_.equal_range_multi(rhs.ht_);
+    return !lhs.ht_.equal_to_multi(rhs.ht_);
   }
 };
 
 // 重载比较操作符
 template <class Key, class Hash, class KeyEqual, class Alloc>
-bool operator==(const unordered_multiset<Key, Hash, KeyEqual>& lhs,
-                const unordered_multiset<Key, Hash, KeyEqual>& rhs)
+bool operator==(const unordered_multiset<Key, Hash, KeyEqual, Alloc>& lhs,
+                const unordered_multiset<Key, Hash, KeyEqual, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
 template <class Key, class Hash, class KeyEqual, class Alloc>
-bool operator!=(const unordered_multiset<Key, Hash, KeyEqual>& lhs,
-                const unordered_multiset<Key, Hash, KeyEqual>& rhs)
+bool operator!=(const unordered_multiset<Key, Hash, KeyEqual, Alloc>& lhs,
+                const unordered_multiset<Key, Hash, KeyEqual, Alloc>& rhs)
 {
   return lhs != rhs;
 }
 
 // 重载 mystl 的 swap
 template <class Key, class Hash, class KeyEqual, class Alloc>
-void swap(unordered_multiset<Key, Hash, KeyEqual>& lhs,
-          unordered_multiset<Key, Hash, KeyEqual>& rhs)
+void swap(unordered_multiset<Key, Hash, KeyEqual, Alloc>& lhs,
+          unordered_multiset<Key, Hash, KeyEqual, Alloc>& rhs)
 {
   lhs.swap(rhs);
 }
 
+// 与 hashtable 相同，Hash、KeyEqual、Alloc 可以平凡重定位时容器也可以平凡重定位
+template <class Key, class Hash, class KeyEqual, class Alloc>
+struct is_trivially_relocatable<unordered_set<Key, Hash, KeyEqual, Alloc>>
+  : m_bool_constant<is_trivially_relocatable<Hash>::value &&
+    is_trivially_relocatable<KeyEqual>::value &&
+    is_trivially_relocatable<Alloc>::value> {};
+
+template <class Key, class Hash, class KeyEqual, class Alloc>
+struct is_trivially_relocatable<unordered_multiset<Key, Hash, KeyEqual, Alloc>>
+  : m_bool_constant<is_trivially_relocatable<Hash>::value &&
+    is_trivially_relocatable<KeyEqual>::value &&
+    is_trivially_relocatable<Alloc>::value> {};
+
 } // namespace mystl
 #endif // !MYTINYSTL_UNORDERED_SET_H_
 
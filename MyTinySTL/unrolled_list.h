@@ -0,0 +1,1011 @@
+#ifndef MYTINYSTL_UNROLLED_LIST_H_
+#define MYTINYSTL_UNROLLED_LIST_H_
+
+// 这个头文件包含一个模板类 unrolled_list
+// unrolled_list : 展开链表，每个节点保存一小段连续的元素，遍历时大部分步进只是下标加一
+
+// notes:
+//
+// 1. 每个节点最多保存 N 个元素，缺省让元素部分约占一条 cache line，节点之间是双向链表
+// 2. 在迭代器处插入、删除只搬移所在节点中的元素，节点已满时对半分裂，
+//    删除后相邻两个节点的元素合计不超过 N / 2 时合并，因此都是 O(N) 即均摊 O(1)
+// 3. 迭代器失效规则：
+//    * 插入使插入位置所在节点（分裂时还有新节点）中元素的迭代器、指针与引用失效
+//    * 删除使被删除元素所在节点以及与之合并的相邻节点中元素的迭代器、指针与引用失效
+//    * 其余节点中元素的迭代器、指针与引用，以及 end() 始终有效
+// 4. 元素要求 nothrow 移动构造，节点内以及节点之间的搬移不会失败；
+//    元素可以平凡重定位时，搬移直接复制内存
+// 5. 哨兵节点保存在容器对象内部，容器不能平凡重定位
+//
+// 异常保证：
+// mystl::unrolled_list<T> 满足基本异常保证，对以下函数做强异常安全保证：
+//   * emplace_front
+//   * emplace_back
+//   * emplace
+//   * push_front
+//   * push_back
+//   * insert 插入单个元素时
+
+#include <initializer_list>
+#include <type_traits>
+
+#include <cstring>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "algobase.h"
+
+namespace mystl
+{
+
+// 缺省每个节点保存的元素个数：元素部分约占 64 字节，至少 4 个
+template <class T>
+struct unrolled_list_node_size
+{
+  static constexpr size_t value = sizeof(T) < 16 ? 64 / sizeof(T) : 4;
+};
+
+// unrolled_list 的节点结构
+
+struct unrolled_node_base
+{
+  unrolled_node_base* prev;   // 前一节点
+  unrolled_node_base* next;   // 下一节点
+  size_t              count;  // 节点中的元素个数，哨兵节点为 0
+};
+
+template <class T, size_t N>
+struct unrolled_node : public unrolled_node_base
+{
+  typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buf;  // 元素存放的位置
+
+  T* data() noexcept
+  { return static_cast<T*>(static_cast<void*>(&buf)); }
+};
+
+// unrolled_list 的迭代器设计，由所在节点与节点中的下标组成
+// 指向元素的迭代器下标总小于节点中的元素个数，end() 指向哨兵节点，下标为 0
+template <class T, size_t N, class Ref, class Ptr>
+struct unrolled_list_iterator : public iterator<bidirectional_iterator_tag, T>
+{
+  typedef unrolled_list_iterator<T, N, T&, T*>             iterator;
+  typedef unrolled_list_iterator<T, N, const T&, const T*> const_iterator;
+  typedef unrolled_list_iterator                           self;
+
+  typedef T                    value_type;
+  typedef Ptr                  pointer;
+  typedef Ref                  reference;
+  typedef size_t               size_type;
+  typedef ptrdiff_t            difference_type;
+  typedef unrolled_node_base*  base_ptr;
+  typedef unrolled_node<T, N>* node_ptr;
+
+  base_ptr  node_;  // 所在节点
+  size_type idx_;   // 节点中的下标
+
+  // 构造、复制函数
+  unrolled_list_iterator() noexcept
+    :node_(nullptr), idx_(0) {}
+  unrolled_list_iterator(base_ptr n, size_type i) noexcept
+    :node_(n), idx_(i) {}
+  unrolled_list_iterator(const iterator& rhs) noexcept
+    :node_(rhs.node_), idx_(rhs.idx_) {}
+
+  self& operator=(const self& rhs) = default;
+
+  // 重载操作符
+  reference operator*()  const { return static_cast<node_ptr>(node_)->data()[idx_]; }
+  pointer   operator->() const { return &(operator*()); }
+
+  self& operator++()
+  {
+    MYSTL_DEBUG(node_ != nullptr && idx_ < node_->count);
+    if (++idx_ == node_->count)
+    {
+      node_ = node_->next;
+      idx_ = 0;
+    }
+    return *this;
+  }
+  self operator++(int)
+  {
+    self tmp = *this;
+    ++*this;
+    return tmp;
+  }
+  self& operator--()
+  {
+    MYSTL_DEBUG(node_ != nullptr);
+    if (idx_ == 0)
+    {
+      node_ = node_->prev;
+      idx_ = node_->count;
+    }
+    --idx_;
+    return *this;
+  }
+  self operator--(int)
+  {
+    self tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  // 重载比较操作符
+  bool operator==(const self& rhs) const { return node_ == rhs.node_ && idx_ == rhs.idx_; }
+  bool operator!=(const self& rhs) const { return !(*this == rhs); }
+};
+
+// 模板类: unrolled_list
+// 模板参数 T 代表数据类型，N 代表每个节点最多保存的元素个数，Alloc 代表空间配置器，缺省使用 mystl::allocator
+// 容器保存的是 rebind 到节点类型的配置器
+template <class T, size_t N = unrolled_list_node_size<T>::value,
+          class Alloc = mystl::allocator<T>>
+class unrolled_list : private mystl::alloc_holder<
+  typename mystl::allocator_traits<Alloc>::template rebind_alloc<unrolled_node<T, N>>>
+{
+  static_assert(N > 0, "unrolled_list must hold at least one element per node");
+  static_assert(std::is_nothrow_move_constructible<T>::value,
+                "unrolled_list requires nothrow move constructible elements");
+public:
+  // unrolled_list 的嵌套型别定义
+  typedef Alloc                                    allocator_type;
+  typedef typename mystl::allocator_traits<Alloc>::template
+    rebind_alloc<unrolled_node<T, N>>              node_allocator;
+  typedef mystl::allocator_traits<node_allocator>  node_alloc_traits;
+
+  typedef T                                        value_type;
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  typedef unrolled_list_iterator<T, N, T&, T*>             iterator;
+  typedef unrolled_list_iterator<T, N, const T&, const T*> const_iterator;
+  typedef mystl::reverse_iterator<iterator>                reverse_iterator;
+  typedef mystl::reverse_iterator<const_iterator>          const_reverse_iterator;
+
+  typedef unrolled_node_base*                      base_ptr;
+  typedef unrolled_node<T, N>*                     node_ptr;
+
+  static constexpr size_type node_capacity = N;
+
+  allocator_type get_allocator() const { return allocator_type(this->get_alloc()); }
+
+private:
+  typedef mystl::alloc_holder<node_allocator>      base_holder;
+  // 元素可以平凡重定位时，搬移元素直接复制内存
+  typedef m_bool_constant<mystl::is_trivially_relocatable<T>::value> relocatable;
+
+  unrolled_node_base head_;   // 哨兵节点
+  size_type          size_;   // 元素个数
+  size_type          nodes_;  // 节点个数
+
+public:
+  // 构造、复制、移动、析构函数
+  unrolled_list()
+  { reset(); }
+
+  explicit unrolled_list(const allocator_type& alloc)
+    :base_holder(node_allocator(alloc))
+  { reset(); }
+
+  explicit unrolled_list(size_type n, const allocator_type& alloc = allocator_type())
+    :base_holder(node_allocator(alloc))
+  { default_init(n); }
+
+  unrolled_list(size_type n, const value_type& value,
+                const allocator_type& alloc = allocator_type())
+    :base_holder(node_allocator(alloc))
+  { fill_init(n, value); }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  unrolled_list(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+    :base_holder(node_allocator(alloc))
+  { copy_init(first, last); }
+
+  unrolled_list(std::initializer_list<T> ilist, const allocator_type& alloc = allocator_type())
+    :base_holder(node_allocator(alloc))
+  { copy_init(ilist.begin(), ilist.end()); }
+
+  unrolled_list(const unrolled_list& rhs)
+    :base_holder(node_alloc_traits::select_on_container_copy_construction(rhs.get_alloc()))
+  { copy_init(rhs.cbegin(), rhs.cend()); }
+
+  unrolled_list(const unrolled_list& rhs, const allocator_type& alloc)
+    :base_holder(node_allocator(alloc))
+  { copy_init(rhs.cbegin(), rhs.cend()); }
+
+  unrolled_list(unrolled_list&& rhs) noexcept
+    :base_holder(mystl::move(rhs.get_alloc()))
+  {
+    reset();
+    take(rhs);
+  }
+
+  unrolled_list(unrolled_list&& rhs, const allocator_type& alloc)
+    :base_holder(node_allocator(alloc))
+  {
+    reset();
+    if (this->get_alloc() == rhs.get_alloc())
+    {
+      take(rhs);
+    }
+    else
+    {
+      try
+      {
+        for (auto& value : rhs)
+          emplace_back(mystl::move(value));
+      }
+      catch (...)
+      {
+        clear();
+        throw;
+      }
+    }
+  }
+
+  unrolled_list& operator=(const unrolled_list& rhs)
+  {
+    if (this != &rhs)
+    {
+      if (node_alloc_traits::propagate_on_container_copy_assignment::value &&
+          this->get_alloc() != rhs.get_alloc())
+      { // 配置器要随之复制，旧节点必须先用旧的配置器释放
+        clear();
+        mystl::alloc_on_copy(this->get_alloc(), rhs.get_alloc());
+      }
+      assign(rhs.begin(), rhs.end());
+    }
+    return *this;
+  }
+
+  unrolled_list& operator=(unrolled_list&& rhs) noexcept(alloc_move_steals<node_allocator>::value)
+  {
+    if (this != &rhs)
+      move_assign(rhs, alloc_move_steals<node_allocator>());
+    return *this;
+  }
+
+  unrolled_list& operator=(std::initializer_list<T> ilist)
+  {
+    assign(ilist.begin(), ilist.end());
+    return *this;
+  }
+
+  ~unrolled_list()
+  { clear(); }
+
+public:
+  // 迭代器相关操作
+  iterator               begin()         noexcept
+  { return iterator(head_.next, 0); }
+  const_iterator         begin()   const noexcept
+  { return const_iterator(head_.next, 0); }
+  iterator               end()           noexcept
+  { return iterator(&head_, 0); }
+  const_iterator         end()     const noexcept
+  { return const_iterator(const_cast<base_ptr>(&head_), 0); }
+
+  reverse_iterator       rbegin()        noexcept
+  { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin()  const noexcept
+  { return const_reverse_iterator(end()); }
+  reverse_iterator       rend()          noexcept
+  { return reverse_iterator(begin()); }
+  const_reverse_iterator rend()    const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_iterator         cbegin()  const noexcept
+  { return begin(); }
+  const_iterator         cend()    const noexcept
+  { return end(); }
+  const_reverse_iterator crbegin() const noexcept
+  { return rbegin(); }
+  const_reverse_iterator crend()   const noexcept
+  { return rend(); }
+
+  // 容量相关操作
+  bool      empty()      const noexcept
+  { return size_ == 0; }
+
+  size_type size()       const noexcept
+  { return size_; }
+
+  size_type max_size()   const noexcept
+  { return static_cast<size_type>(-1); }
+
+  // 节点个数
+  size_type node_count() const noexcept
+  { return nodes_; }
+
+  // 所有节点占用的空间，节点中的指针、计数与空闲的位置计入 overhead
+  memory_usage_info memory_usage() const noexcept
+  {
+    const size_type payload = size_ * sizeof(T);
+    return memory_usage_info{ payload, nodes_ * sizeof(unrolled_node<T, N>) - payload };
+  }
+
+  // 访问元素相关操作
+  reference       front()
+  {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+
+  const_reference front() const
+  {
+    MYSTL_DEBUG(!empty());
+    return *begin();
+  }
+
+  reference       back()
+  {
+    MYSTL_DEBUG(!empty());
+    return data_of(head_.prev)[head_.prev->count - 1];
+  }
+
+  const_reference back()  const
+  {
+    MYSTL_DEBUG(!empty());
+    return data_of(head_.prev)[head_.prev->count - 1];
+  }
+
+  // 调整容器相关操作
+
+  // assign
+
+  void     assign(size_type n, const value_type& value)
+  { fill_assign(n, value); }
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  void     assign(Iter first, Iter last)
+  { copy_assign(first, last); }
+
+  void     assign(std::initializer_list<T> ilist)
+  { copy_assign(ilist.begin(), ilist.end()); }
+
+  // emplace_front / emplace_back / emplace
+
+  template <class ...Args>
+  void     emplace_front(Args&& ...args)
+  { emplace(cbegin(), mystl::forward<Args>(args)...); }
+
+  template <class ...Args>
+  void     emplace_back(Args&& ...args)
+  { emplace(cend(), mystl::forward<Args>(args)...); }
+
+  template <class ...Args>
+  iterator emplace(const_iterator pos, Args&& ...args);
+
+  // insert
+
+  iterator insert(const_iterator pos, const value_type& value)
+  { return emplace(pos, value); }
+
+  iterator insert(const_iterator pos, value_type&& value)
+  { return emplace(pos, mystl::move(value)); }
+
+  iterator insert(const_iterator pos, size_type n, const value_type& value);
+
+  template <class Iter, typename std::enable_if<
+    mystl::is_input_iterator<Iter>::value, int>::type = 0>
+  iterator insert(const_iterator pos, Iter first, Iter last);
+
+  iterator insert(const_iterator pos, std::initializer_list<T> ilist)
+  { return insert(pos, ilist.begin(), ilist.end()); }
+
+  // push_front / push_back
+
+  void push_front(const value_type& value)
+  { emplace(cbegin(), value); }
+
+  void push_front(value_type&& value)
+  { emplace(cbegin(), mystl::move(value)); }
+
+  void push_back(const value_type& value)
+  { emplace(cend(), value); }
+
+  void push_back(value_type&& value)
+  { emplace(cend(), mystl::move(value)); }
+
+  // pop_front / pop_back
+
+  void pop_front()
+  {
+    MYSTL_DEBUG(!empty());
+    erase(cbegin());
+  }
+
+  void pop_back()
+  {
+    MYSTL_DEBUG(!empty());
+    erase(const_iterator(head_.prev, head_.prev->count - 1));
+  }
+
+  // erase / clear
+
+  iterator erase(const_iterator pos);
+  iterator erase(const_iterator first, const_iterator last);
+
+  void     clear() noexcept;
+
+  // resize
+
+  void     resize(size_type new_size);
+  void     resize(size_type new_size, const value_type& value);
+
+  void     swap(unrolled_list& rhs) noexcept;
+
+  // unrolled_list 相关操作
+
+  void remove(const value_type& value)
+  { remove_if([&](const value_type& v) { return v == value; }); }
+  template <class UnaryPredicate>
+  void remove_if(UnaryPredicate pred);
+
+private:
+  // helper functions
+
+  static pointer data_of(base_ptr p) noexcept
+  { return static_cast<node_ptr>(p)->data(); }
+
+  // 把 [src, src + n) 的元素搬到 dst，原位置的元素随之结束生命期，两段区间可以重叠
+  static void relocate_elems(pointer dst, pointer src, size_type n, m_true_type) noexcept
+  {
+    if (n != 0)
+      std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+  }
+  static void relocate_elems(pointer dst, pointer src, size_type n, m_false_type) noexcept;
+
+  // 空链表
+  void      reset() noexcept
+  {
+    head_.prev = head_.next = &head_;
+    head_.count = 0;
+    size_ = 0;
+    nodes_ = 0;
+  }
+
+  // 接管 rhs 的所有节点，本容器须为空
+  void      take(unrolled_list& rhs) noexcept;
+
+  // 哨兵节点换了位置后，让首尾节点重新指向它
+  void      fix_head() noexcept;
+
+  // create / destroy node
+  base_ptr  create_node_after(base_ptr pos);
+  void      destroy_node(base_ptr p) noexcept;
+
+  // 在节点 p 的下标 i 处构造元素，p 中须有空位
+  template <class ...Args>
+  void      construct_in_node(base_ptr p, size_type i, Args&& ...args);
+
+  // 把已满的节点 p 的后一半元素搬到新节点中
+  void      split_node(base_ptr p);
+
+  // 节点 p 中删除元素后，合并过空的节点，返回原来下标 i 处的位置
+  iterator  rebalance(base_ptr p, size_type i) noexcept;
+
+  // initialize
+  void      default_init(size_type n);
+  void      fill_init(size_type n, const value_type& value);
+  template <class Iter>
+  void      copy_init(Iter first, Iter last);
+
+  // assign
+  void      fill_assign(size_type n, const value_type& value);
+  template <class Iter>
+  void      copy_assign(Iter first, Iter last);
+
+  // move assign
+  void      move_assign(unrolled_list& rhs, m_true_type) noexcept;
+  void      move_assign(unrolled_list& rhs, m_false_type);
+};
+
+/*****************************************************************************************/
+
+template <class T, size_t N, class Alloc>
+constexpr typename unrolled_list<T, N, Alloc>::size_type unrolled_list<T, N, Alloc>::node_capacity;
+
+// 在 pos 处就地构造元素
+template <class T, size_t N, class Alloc>
+template <class ...Args>
+typename unrolled_list<T, N, Alloc>::iterator
+unrolled_list<T, N, Alloc>::emplace(const_iterator pos, Args&& ...args)
+{
+  THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "unrolled_list<T>'s size too big");
+  base_ptr p = pos.node_;
+  size_type i = pos.idx_;
+  if (p == &head_ || (i == 0 && p->count == N))
+  { // 插在节点 p 之前：前一个节点有空位时追加到它的尾部，否则新建一个节点
+    base_ptr prev = p->prev;
+    if (prev != &head_ && prev->count < N)
+    {
+      i = prev->count;
+      construct_in_node(prev, i, mystl::forward<Args>(args)...);
+      return iterator(prev, i);
+    }
+    base_ptr q = create_node_after(prev);
+    try
+    {
+      construct_in_node(q, 0, mystl::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      destroy_node(q);
+      throw;
+    }
+    return iterator(q, 0);
+  }
+  if (p->count == N)
+  { // 参数可能引用 p 中的元素，先构造出新元素再分裂
+    value_type tmp(mystl::forward<Args>(args)...);
+    split_node(p);
+    if (i > p->count)
+    {
+      i -= p->count;
+      p = p->next;
+    }
+    construct_in_node(p, i, mystl::move(tmp));
+    return iterator(p, i);
+  }
+  construct_in_node(p, i, mystl::forward<Args>(args)...);
+  return iterator(p, i);
+}
+
+// 在 pos 处插入 n 个 value
+template <class T, size_t N, class Alloc>
+typename unrolled_list<T, N, Alloc>::iterator
+unrolled_list<T, N, Alloc>::insert(const_iterator pos, size_type n, const value_type& value)
+{
+  THROW_LENGTH_ERROR_IF(size_ > max_size() - n, "unrolled_list<T>'s size too big");
+  if (n == 0)
+    return iterator(pos.node_, pos.idx_);
+  value_type tmp(value);  // value 可能是容器中的元素
+  // 第一个新元素所在的节点可能在之后的插入中分裂，最后从插入位置往回找
+  iterator r(pos.node_, pos.idx_);
+  for (size_type i = 0; i < n; ++i)
+  {
+    r = emplace(r, tmp);
+    ++r;
+  }
+  for (; n > 0; --n)
+    --r;
+  return r;
+}
+
+// 在 pos 处插入 [first, last) 内的元素
+template <class T, size_t N, class Alloc>
+template <class Iter, typename std::enable_if<
+  mystl::is_input_iterator<Iter>::value, int>::type>
+typename unrolled_list<T, N, Alloc>::iterator
+unrolled_list<T, N, Alloc>::insert(const_iterator pos, Iter first, Iter last)
+{
+  iterator r(pos.node_, pos.idx_);
+  if (first == last)
+    return r;
+  // 第一个新元素所在的节点可能在之后的插入中分裂，最后从插入位置往回找
+  size_type n = 0;
+  for (; first != last; ++first, ++n)
+  {
+    r = emplace(r, *first);
+    ++r;
+  }
+  for (; n > 0; --n)
+    --r;
+  return r;
+}
+
+// 删除 pos 处的元素
+template <class T, size_t N, class Alloc>
+typename unrolled_list<T, N, Alloc>::iterator
+unrolled_list<T, N, Alloc>::erase(const_iterator pos)
+{
+  MYSTL_DEBUG(pos != cend());
+  base_ptr p = pos.node_;
+  const size_type i = pos.idx_;
+  pointer d = data_of(p);
+  node_alloc_traits::destroy(this->get_alloc(), d + i);
+  relocate_elems(d + i, d + i + 1, p->count - i - 1, relocatable());
+  --p->count;
+  --size_;
+  return rebalance(p, i);
+}
+
+// 删除 [first, last) 内的元素
+template <class T, size_t N, class Alloc>
+typename unrolled_list<T, N, Alloc>::iterator
+unrolled_list<T, N, Alloc>::erase(const_iterator first, const_iterator last)
+{
+  // 合并会搬移 last 所在节点的元素，先按节点算出要删除的个数
+  size_type n = 0;
+  for (base_ptr p = first.node_; p != last.node_; p = p->next)
+    n += p->count;
+  n = n + last.idx_ - first.idx_;
+  base_ptr p = first.node_;
+  size_type i = first.idx_;
+  while (n > 0)
+  { // 每次删除一个节点中连续的一段
+    const size_type k = mystl::min(n, p->count - i);
+    pointer d = data_of(p);
+    mystl::destroy(d + i, d + i + k);
+    relocate_elems(d + i, d + i + k, p->count - i - k, relocatable());
+    p->count -= k;
+    size_ -= k;
+    n -= k;
+    iterator r = rebalance(p, i);
+    p = r.node_;
+    i = r.idx_;
+  }
+  return iterator(p, i);
+}
+
+// 清空容器，释放所有节点
+template <class T, size_t N, class Alloc>
+void unrolled_list<T, N, Alloc>::clear() noexcept
+{
+  base_ptr p = head_.next;
+  while (p != &head_)
+  {
+    base_ptr next = p->next;
+    pointer d = data_of(p);
+    mystl::destroy(d, d + p->count);
+    node_alloc_traits::deallocate(this->get_alloc(), static_cast<node_ptr>(p), 1);
+    p = next;
+  }
+  reset();
+}
+
+// 重置容器大小，新增的元素值初始化
+template <class T, size_t N, class Alloc>
+void unrolled_list<T, N, Alloc>::resize(size_type new_size)
+{
+  while (size_ > new_size)
+    pop_back();
+  while (size_ < new_size)
+    emplace_back();
+}
+
+template <class T, size_t N, class Alloc>
+void unrolled_list<T, N, Alloc>::resize(size_type new_size, const value_type& value)
+{
+  if (new_size < size_)
+  {
+    while (size_ > new_size)
+      pop_back();
+  }
+  else
+  {
+    insert(cend(), new_size - size_, value);
+  }
+}
+
+// 与另一个 unrolled_list 交换
+template <class T, size_t N, class Alloc>
+void unrolled_list<T, N, Alloc>::swap(unrolled_list& rhs) noexcept
+{
+  MYSTL_DEBUG(node_alloc_traits::propagate_on_container_swap::value ||
+              this->get_alloc() == rhs.get_alloc());
+  mystl::alloc_on_swap(this->get_alloc(), rhs.get_alloc());
+  mystl::swap(head_, rhs.head_);
+  mystl::swap(size_, rhs.size_);
+  mystl::swap(nodes_, rhs.nodes_);
+  fix_head();
+  rhs.fix_head();
+}
+
+// 删除 pred 为 true 的所有元素
+template <class T, size_t N, class Alloc>
+template <class UnaryPredicate>
+void unrolled_list<T, N, Alloc>::remove_if(UnaryPredicate pred)
+{
+  iterator it = begin();
+  while (it != end())
+  {
+    if (pred(*it))
+      it = erase(it);
+    else
+      ++it;
+  }
+}
+
+/*****************************************************************************************/
+// helper function
+
+// 逐个移动构造后销毁原元素，目标在前时从前往后搬，否则从后往前搬
+template <class T, size_t N, class Alloc>
+void unrolled_list<T, N, Alloc>::
+relocate_elems(pointer dst, pointer src, size_type n, m_false_type) noexcept
+{
+  if (dst < src)
+  {
+    for (size_type i = 0; i < n; ++i)
+    {
+      mystl::construct(dst + i, mystl::move(src[i]));
+      mystl::destroy(src + i);
+    }
+  }
+  else
+  {
+    for (size_type i = n; i > 0; --i)
+    {
+      mystl::construct(dst + i - 1, mystl::move(src[i - 1]));
+      mystl::destroy(src + i - 1);
+    }
+  }
+}
+
+template <class T, size_t N, class Alloc>
+void unrolled_list<T, N, Alloc>::take(unrolled_list& rhs) noexcept
+{
+  if (rhs.nodes_ == 0)
+    return;
+  head_ = rhs.head_;
+  size_ = rhs.size_;
+  nodes_ = rhs.nodes_;
+  fix_head();
+  rhs.reset();
+}
+
+template <class T, size_t N, class Alloc>
+void unrolled_list<T, N, Alloc>::fix_head() noexcept
+{
+  if (nodes_ == 0)
+  {
+    head_.prev = head_.next = &head_;
+  }
+  else
+  {
+    head_.next->prev = &head_;
+    head_.prev->next = &head_;
+  }
+}
+
+// 在 pos 之后连接一个空节点
+template <class T, size_t N, class Alloc>
+typename unrolled_list<T, N, Alloc>::base_ptr
+unrolled_list<T, N, Alloc>::create_node_after(base_ptr pos)
+{
+  node_ptr q = node_alloc_traits::allocate(this->get_alloc(), 1);
+  ::new (static_cast<void*>(q)) unrolled_node<T, N>;
+  q->count = 0;
+  q->prev = pos;
+  q->next = pos->next;
+  pos->next->prev = q;
+  pos->next = q;
+  ++nodes_;
+  return q;
+}
+
+// 断开并释放一个节点，其中的元素已经销毁或搬走
+template <class T, size_t N, class Alloc>
+void unrolled_list<T, N, Alloc>::destroy_node(base_ptr p) noexcept
+{
+  p->prev->next = p->next;
+  p->next->prev = p->prev;
+  node_alloc_traits::deallocate(this->get_alloc(), static_cast<node_ptr>(p), 1);
+  --nodes_;
+}
+
+template <class T, size_t N, class Alloc>
+template <class ...Args>
+void unrolled_list<T, N, Alloc>::construct_in_node(base_ptr p, size_type i, Args&& ...args)
+{
+  MYSTL_DEBUG(p->count < N && i <= p->count);
+  pointer d = data_of(p);
+  if (i == p->count)
+  {
+    node_alloc_traits::construct(this->get_alloc(), d + i, mystl::forward<Args>(args)...);
+  }
+  else
+  { // 参数可能引用要后移的元素，先构造出新元素
+    value_type tmp(mystl::forward<Args>(args)...);
+    relocate_elems(d + i + 1, d + i, p->count - i, relocatable());
+    mystl::construct(d + i, mystl::move(tmp));
+  }
+  ++p->count;
+  ++size_;
+}
+
+template <class T, size_t N, class Alloc>
+void unrolled_list<T, N, Alloc>::split_node(base_ptr p)
+{
+  MYSTL_DEBUG(p->count == N);
+  base_ptr q = create_node_after(p);
+  const size_type keep = N - N / 2;
+  relocate_elems(data_of(q), data_of(p) + keep, N / 2, relocatable());
+  q->count = N / 2;
+  p->count = keep;
+}
+
+template <class T, size_t N, class Alloc>
+typename unrolled_list<T, N, Alloc>::iterator
+unrolled_list<T, N, Alloc>::rebalance(base_ptr p, size_type i) noexcept
+{
+  if (p->count == 0)
+  {
+    base_ptr next = p->next;
+    destroy_node(p);
+    return iterator(next, 0);
+  }
+  base_ptr next = p->next;
+  if (next != &head_ && p->count + next->count <= N / 2)
+  { // 后一个节点并入 p
+    relocate_elems(data_of(p) + p->count, data_of(next), next->count, relocatable());
+    p->count += next->count;
+    destroy_node(next);
+  }
+  base_ptr prev = p->prev;
+  if (prev != &head_ && prev->count + p->count <= N / 2)
+  { // p 并入前一个节点
+    relocate_elems(data_of(prev) + prev->count, data_of(p), p->count, relocatable());
+    i += prev->count;
+    prev->count += p->count;
+    destroy_node(p);
+    p = prev;
+  }
+  if (i == p->count)
+    return iterator(p->next, 0);
+  return iterator(p, i);
+}
+
+// 用 n 个值初始化的元素初始化容器
+template <class T, size_t N, class Alloc>
+void unrolled_list<T, N, Alloc>::default_init(size_type n)
+{
+  reset();
+  try
+  {
+    for (; n > 0; --n)
+      emplace_back();
+  }
+  catch (...)
+  {
+    clear();
+    throw;
+  }
+}
+
+// 用 n 个元素初始化容器
+template <class T, size_t N, class Alloc>
+void unrolled_list<T, N, Alloc>::fill_init(size_type n, const value_type& value)
+{
+  reset();
+  try
+  {
+    for (; n > 0; --n)
+      emplace_back(value);
+  }
+  catch (...)
+  {
+    clear();
+    throw;
+  }
+}
+
+// 以 [first, last) 初始化容器
+template <class T, size_t N, class Alloc>
+template <class Iter>
+void unrolled_list<T, N, Alloc>::copy_init(Iter first, Iter last)
+{
+  reset();
+  try
+  {
+    for (; first != last; ++first)
+      emplace_back(*first);
+  }
+  catch (...)
+  {
+    clear();
+    throw;
+  }
+}
+
+// 用 n 个元素为容器赋值
+template <class T, size_t N, class Alloc>
+void unrolled_list<T, N, Alloc>::fill_assign(size_type n, const value_type& value)
+{
+  iterator cur = begin();
+  for (; n > 0 && cur != end(); --n, ++cur)
+    *cur = value;
+  if (n > 0)
+    insert(cend(), n, value);
+  else
+    erase(cur, cend());
+}
+
+// 用 [first, last) 为容器赋值
+template <class T, size_t N, class Alloc>
+template <class Iter>
+void unrolled_list<T, N, Alloc>::copy_assign(Iter first, Iter last)
+{
+  iterator cur = begin();
+  for (; first != last && cur != end(); ++first, ++cur)
+    *cur = *first;
+  if (first == last)
+    erase(cur, cend());
+  else
+    insert(cend(), first, last);
+}
+
+// move_assign 函数，配置器会随之移动或者总是相等，直接接管 rhs 的节点
+template <class T, size_t N, class Alloc>
+void unrolled_list<T, N, Alloc>::move_assign(unrolled_list& rhs, m_true_type) noexcept
+{
+  clear();
+  mystl::alloc_on_move(this->get_alloc(), rhs.get_alloc());
+  take(rhs);
+}
+
+// move_assign 函数，配置器不传播时，只有两者相等才能接管节点，否则逐个移动元素
+template <class T, size_t N, class Alloc>
+void unrolled_list<T, N, Alloc>::move_assign(unrolled_list& rhs, m_false_type)
+{
+  if (this->get_alloc() == rhs.get_alloc())
+  {
+    clear();
+    take(rhs);
+  }
+  else
+  {
+    clear();
+    for (auto& value : rhs)
+      emplace_back(mystl::move(value));
+    rhs.clear();
+  }
+}
+
+// 重载比较操作符
+template <class T, size_t N, class Alloc>
+bool operator==(const unrolled_list<T, N, Alloc>& lhs, const unrolled_list<T, N, Alloc>& rhs)
+{
+  return lhs.size() == rhs.size() && mystl::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin());
+}
+
+template <class T, size_t N, class Alloc>
+bool operator<(const unrolled_list<T, N, Alloc>& lhs, const unrolled_list<T, N, Alloc>& rhs)
+{
+  return mystl::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+}
+
+template <class T, size_t N, class Alloc>
+bool operator!=(const unrolled_list<T, N, Alloc>& lhs, const unrolled_list<T, N, Alloc>& rhs)
+{
+  return !(lhs == rhs);
+}
+
+template <class T, size_t N, class Alloc>
+bool operator>(const unrolled_list<T, N, Alloc>& lhs, const unrolled_list<T, N, Alloc>& rhs)
+{
+  return rhs < lhs;
+}
+
+template <class T, size_t N, class Alloc>
+bool operator<=(const unrolled_list<T, N, Alloc>& lhs, const unrolled_list<T, N, Alloc>& rhs)
+{
+  return !(rhs < lhs);
+}
+
+template <class T, size_t N, class Alloc>
+bool operator>=(const unrolled_list<T, N, Alloc>& lhs, const unrolled_list<T, N, Alloc>& rhs)
+{
+  return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, size_t N, class Alloc>
+void swap(unrolled_list<T, N, Alloc>& lhs, unrolled_list<T, N, Alloc>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYTINYSTL_UNROLLED_LIST_H_
@@ -2,7 +2,8 @@
 #define MYTINYSTL_VECTOR_H_
 
 // 这个头文件包含一个模板类 vector
-// vector : 向量
+// vector         : 向量，扩容的方式由模板参数 Growth 决定，缺省使用 vector_growth（1.5 倍增长，初始容量 16）
+// aligned_vector : 以 aligned_allocator 为配置器的向量，元素的起始地址按指定的边界（默认 64 字节）对齐
 
 // notes:
 //
@@ -18,6 +19,10 @@
 
 #include <initializer_list>
 
+#include <cstring>
+
+#include "aligned_allocator.h"
+#include "growth_policy.h"
 #include "iterator.h"
 #include "memory.h"
 #include "util.h"
@@ -38,32 +43,44 @@ namespace mystl
 #endif // min
 
 // 模板类: vector 
-// 模板参数 T 代表类型
-template <class T>
-class vector
+// 模板参数 T 代表类型，Alloc 代表空间配置器，缺省使用 mystl::allocator，Growth 代表扩容策略
+template <class T, class Alloc = mystl::allocator<T>, class Growth = mystl::vector_growth>
+class vector : private mystl::alloc_holder<Alloc>
 {
   static_assert(!std::is_same<bool, T>::value, "vector<bool> is abandoned in mystl");
+  static_assert(std::is_same<T, typename Alloc::value_type>::value,
+                "Alloc::value_type must be the same as T");
 public:
   // vector 的嵌套型别定义
-  typedef mystl::allocator<T>                      allocator_type;
-  typedef mystl::allocator<T>                      data_allocator;
-
-  typedef typename allocator_type::value_type      value_type;
-  typedef typename allocator_type::pointer         pointer;
-  typedef typename allocator_type::const_pointer   const_pointer;
-  typedef typename allocator_type::reference       reference;
-  typedef typename allocator_type::const_reference const_reference;
-  typedef typename allocator_type::size_type       size_type;
-  typedef typename allocator_type::difference_type difference_type;
+  typedef Alloc                                    allocator_type;
+  typedef mystl::allocator_traits<Alloc>           alloc_traits;
+  typedef Growth                                   growth_policy_type;
+
+  typedef T                                        value_type;
+  typedef T*                                       pointer;
+  typedef const T*                                 const_pointer;
+  typedef T&                                       reference;
+  typedef const T&                                 const_reference;
+  typedef typename alloc_traits::size_type         size_type;
+  typedef typename alloc_traits::difference_type   difference_type;
 
   typedef value_type*                              iterator;
   typedef const value_type*                        const_iterator;
   typedef mystl::reverse_iterator<iterator>        reverse_iterator;
   typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
 
-  allocator_type get_allocator() { return data_allocator(); }
+  allocator_type get_allocator() const { return this->get_alloc(); }
 
 private:
+  typedef mystl::alloc_holder<Alloc>              base_holder;
+
+  // 元素可以平凡重定位时，重新分配以及插入、删除时的搬移直接复制内存，不需要逐个移动、析构元素
+  typedef m_bool_constant<mystl::is_trivially_relocatable<T>::value> relocatable;
+
+  // 元素可以平凡重定位且配置器提供 reallocate 时，扩容可以原地调整空间
+  typedef m_bool_constant<relocatable::value &&
+    alloc_traits::has_reallocate::value>          realloc_in_place;
+
   iterator begin_;  // 表示目前使用空间的头部
   iterator end_;    // 表示目前使用空间的尾部
   iterator cap_;    // 表示目前储存空间的尾部
@@ -73,27 +90,42 @@ public:
   vector() noexcept
   { try_init(); }
 
-  explicit vector(size_type n)
+  explicit vector(const allocator_type& alloc) noexcept
+    :base_holder(alloc)
+  { try_init(); }
+
+  explicit vector(size_type n, const allocator_type& alloc = allocator_type())
+    :base_holder(alloc)
   { fill_init(n, value_type()); }
 
-  vector(size_type n, const value_type& value)
+  vector(size_type n, const value_type& value, const allocator_type& alloc = allocator_type())
+    :base_holder(alloc)
   { fill_init(n, value); }
 
   template <class Iter, typename std::enable_if<
     mystl::is_input_iterator<Iter>::value, int>::type = 0>
-  vector(Iter first, Iter last)
+  vector(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+    :base_holder(alloc)
   {
     MYSTL_DEBUG(!(last < first));
     range_init(first, last);
   }
 
   vector(const vector& rhs)
+    :base_holder(alloc_traits::select_on_container_copy_construction(rhs.get_alloc()))
+  {
+    range_init(rhs.begin_, rhs.end_);
+  }
+
+  vector(const vector& rhs, const allocator_type& alloc)
+    :base_holder(alloc)
   {
     range_init(rhs.begin_, rhs.end_);
   }
 
   vector(vector&& rhs) noexcept
-    :begin_(rhs.begin_),
+    :base_holder(mystl::move(rhs.get_alloc())),
+    begin_(rhs.begin_),
     end_(rhs.end_),
     cap_(rhs.cap_)
   {
@@ -102,17 +134,21 @@ public:
     rhs.cap_ = nullptr;
   }
 
-  vector(std::initializer_list<value_type> ilist)
+  vector(vector&& rhs, const allocator_type& alloc);
+
+  vector(std::initializer_list<value_type> ilist,
+         const allocator_type& alloc = allocator_type())
+    :base_holder(alloc)
   {
     range_init(ilist.begin(), ilist.end());
   }
 
   vector& operator=(const vector& rhs);
-  vector& operator=(vector&& rhs) noexcept;
+  vector& operator=(vector&& rhs) noexcept(alloc_move_steals<Alloc>::value);
 
   vector& operator=(std::initializer_list<value_type> ilist)
   {
-    vector tmp(ilist.begin(), ilist.end());
+    vector tmp(ilist.begin(), ilist.end(), this->get_alloc());
     swap(tmp);
     return *this;
   }
@@ -163,6 +199,9 @@ public:
   size_type capacity() const noexcept
   { return static_cast<size_type>(cap_ - begin_); }
   void      reserve(size_type n);
+  // 未使用的容量计入 overhead
+  memory_usage_info memory_usage() const noexcept
+  { return memory_usage_info{ size() * sizeof(T), (capacity() - size()) * sizeof(T) }; }
   void      shrink_to_fit();
 
   // 访问元素相关操作
@@ -178,12 +217,12 @@ public:
   }
   reference at(size_type n)
   {
-    THROW_OUT_OF_RANGE_IF(!(n < size()), "vector<T>::at() subscript out of range");
+    THROW_OUT_OF_RANGE_IF(!(n < size()), "vector<T, Alloc, Growth>::at() subscript out of range");
     return (*this)[n];
   }
   const_reference at(size_type n) const
   {
-    THROW_OUT_OF_RANGE_IF(!(n < size()), "vector<T>::at() subscript out of range");
+    THROW_OUT_OF_RANGE_IF(!(n < size()), "vector<T, Alloc, Growth>::at() subscript out of range");
     return (*this)[n];
   }
 
@@ -273,6 +312,8 @@ public:
   // resize / reverse
   void     resize(size_type new_size) { return resize(new_size, value_type()); }
   void     resize(size_type new_size, const value_type& value);
+  // 新增的元素默认初始化，平凡默认构造的元素不写入任何值，适合随后整体覆盖的缓冲区
+  void     resize_default_init(size_type new_size);
 
   void     reverse() { mystl::reverse(begin(), end()); }
 
@@ -296,6 +337,14 @@ private:
   // calculate the growth size
   size_type get_new_cap(size_type add_size);
 
+  // 申请至少 n 个元素的空间，n 更新为实际可以容纳的个数
+  pointer   allocate_space(size_type& n)
+  {
+    auto r = alloc_traits::allocate_at_least(this->get_alloc(), n);
+    n = r.count;
+    return r.ptr;
+  }
+
   // assign
 
   void      fill_assign(size_type n, const value_type& value);
@@ -312,6 +361,34 @@ private:
   void      reallocate_emplace(iterator pos, Args&& ...args);
   void      reallocate_insert(iterator pos, const value_type& value);
 
+  template <class... Args>
+  void      emplace_shift(iterator pos, m_true_type, Args&& ...args);
+  template <class... Args>
+  void      emplace_shift(iterator pos, m_false_type, Args&& ...args);
+
+  bool      try_realloc(size_type new_cap)
+  { return try_realloc_aux(new_cap, realloc_in_place()); }
+  bool      try_realloc_aux(size_type new_cap, m_true_type);
+  bool      try_realloc_aux(size_type, m_false_type) { return false; }
+
+  template <class... Args>
+  bool      realloc_emplace(m_true_type, iterator pos, Args&& ...args);
+  template <class... Args>
+  bool      realloc_emplace(m_false_type, iterator, Args&& ...) { return false; }
+
+  // relocate
+
+  void      relocate_around(iterator new_begin, size_type new_cap, iterator pos, size_type n);
+  void      relocate_around_aux(iterator new_begin, iterator pos, size_type n, m_true_type) noexcept;
+  void      relocate_around_aux(iterator new_begin, iterator pos, size_type n, m_false_type);
+  void      shift_emplace(iterator pos, value_type& value);
+
+  static void move_bytes(iterator dst, const_iterator src, size_type n) noexcept
+  {
+    if (n != 0)
+      std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+  }
+
   // insert
 
   iterator  fill_insert(iterator pos, size_type n, const value_type& value);
@@ -321,73 +398,99 @@ private:
   // shrink_to_fit
 
   void      reinsert(size_type size);
+
+  // move assign
+  void      move_assign(vector& rhs, m_true_type);
+  void      move_assign(vector& rhs, m_false_type);
 };
 
 /*****************************************************************************************/
 
 // 复制赋值操作符
-template <class T>
-vector<T>& vector<T>::operator=(const vector& rhs)
+template <class T, class Alloc, class Growth>
+vector<T, Alloc, Growth>& vector<T, Alloc, Growth>::operator=(const vector& rhs)
 {
   if (this != &rhs)
   {
+    if (alloc_traits::propagate_on_container_copy_assignment::value &&
+        this->get_alloc() != rhs.get_alloc())
+    { // 配置器要随之复制，旧空间必须先用旧的配置器释放
+      destroy_and_recover(begin_, end_, cap_ - begin_);
+      begin_ = end_ = cap_ = nullptr;
+    }
+    mystl::alloc_on_copy(this->get_alloc(), rhs.get_alloc());
     const auto len = rhs.size();
     if (len > capacity())
     { 
-      vector tmp(rhs.begin(), rhs.end());
+      vector tmp(rhs.begin(), rhs.end(), this->get_alloc());
       swap(tmp);
     }
     else if (size() >= len)
     {
       auto i = mystl::copy(rhs.begin(), rhs.end(), begin());
-      data_allocator::destroy(i, end_);
+      mystl::destroy(i, end_);
       end_ = begin_ + len;
     }
     else
     { 
       mystl::copy(rhs.begin(), rhs.begin() + size(), begin_);
       mystl::uninitialized_copy(rhs.begin() + size(), rhs.end(), end_);
-      cap_ = end_ = begin_ + len;
+      end_ = begin_ + len;
     }
   }
   return *this;
 }
 
 // 移动赋值操作符
-template <class T>
-vector<T>& vector<T>::operator=(vector&& rhs) noexcept
+template <class T, class Alloc, class Growth>
+vector<T, Alloc, Growth>& vector<T, Alloc, Growth>::operator=(vector&& rhs)
+noexcept(alloc_move_steals<Alloc>::value)
 {
-  destroy_and_recover(begin_, end_, cap_ - begin_);
-  begin_ = rhs.begin_;
-  end_ = rhs.end_;
-  cap_ = rhs.cap_;
-  rhs.begin_ = nullptr;
-  rhs.end_ = nullptr;
-  rhs.cap_ = nullptr;
+  if (this != &rhs)
+    move_assign(rhs, alloc_move_steals<Alloc>());
   return *this;
 }
 
+// 使用另一个配置器的移动构造函数，配置器不相等时只能逐个移动元素
+template <class T, class Alloc, class Growth>
+vector<T, Alloc, Growth>::vector(vector&& rhs, const allocator_type& alloc)
+  :base_holder(alloc)
+{
+  if (this->get_alloc() == rhs.get_alloc())
+  {
+    begin_ = rhs.begin_;
+    end_ = rhs.end_;
+    cap_ = rhs.cap_;
+    rhs.begin_ = nullptr;
+    rhs.end_ = nullptr;
+    rhs.cap_ = nullptr;
+  }
+  else
+  {
+    const size_type n = rhs.size();
+    init_space(n, mystl::max(n, static_cast<size_type>(Growth::initial_capacity())));
+    mystl::uninitialized_move(rhs.begin_, rhs.end_, begin_);
+  }
+}
+
 // 预留空间大小，当原容量小于要求大小时，才会重新分配
-template <class T>
-void vector<T>::reserve(size_type n)
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::reserve(size_type n)
 {
   if (capacity() < n)
   {
     THROW_LENGTH_ERROR_IF(n > max_size(),
                           "n can not larger than max_size() in vector<T>::reserve(n)");
-    const auto old_size = size();
-    auto tmp = data_allocator::allocate(n);
-    mystl::uninitialized_move(begin_, end_, tmp);
-    data_allocator::deallocate(begin_, cap_ - begin_);
-    begin_ = tmp;
-    end_ = tmp + old_size;
-    cap_ = begin_ + n;
+    if (try_realloc(n))
+      return;
+    auto tmp = allocate_space(n);
+    relocate_around(tmp, n, end_, 0);
   }
 }
 
 // 放弃多余的容量
-template <class T>
-void vector<T>::shrink_to_fit()
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::shrink_to_fit()
 {
   if (end_ < cap_)
   {
@@ -396,27 +499,22 @@ void vector<T>::shrink_to_fit()
 }
 
 // 在 pos 位置就地构造元素，避免额外的复制或移动开销
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class ...Args>
-typename vector<T>::iterator
-vector<T>::emplace(const_iterator pos, Args&& ...args)
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::emplace(const_iterator pos, Args&& ...args)
 {
   MYSTL_DEBUG(pos >= begin() && pos <= end());
   iterator xpos = const_cast<iterator>(pos);
   const size_type n = xpos - begin_;
   if (end_ != cap_ && xpos == end_)
   {
-    data_allocator::construct(mystl::address_of(*end_), mystl::forward<Args>(args)...);
+    alloc_traits::construct(this->get_alloc(), mystl::address_of(*end_), mystl::forward<Args>(args)...);
     ++end_;
   }
   else if (end_ != cap_)
   {
-    auto new_end = end_;
-    data_allocator::construct(mystl::address_of(*end_), *(end_ - 1));
-    ++new_end;
-    mystl::copy_backward(xpos, end_ - 1, end_);
-    *xpos = value_type(mystl::forward<Args>(args)...);
-    end_ = new_end;
+    emplace_shift(xpos, relocatable(), mystl::forward<Args>(args)...);
   }
   else
   {
@@ -426,13 +524,13 @@ vector<T>::emplace(const_iterator pos, Args&& ...args)
 }
 
 // 在尾部就地构造元素，避免额外的复制或移动开销
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class ...Args>
-void vector<T>::emplace_back(Args&& ...args)
+void vector<T, Alloc, Growth>::emplace_back(Args&& ...args)
 {
   if (end_ < cap_)
   {
-    data_allocator::construct(mystl::address_of(*end_), mystl::forward<Args>(args)...);
+    alloc_traits::construct(this->get_alloc(), mystl::address_of(*end_), mystl::forward<Args>(args)...);
     ++end_;
   }
   else
@@ -442,12 +540,12 @@ void vector<T>::emplace_back(Args&& ...args)
 }
 
 // 在尾部插入元素
-template <class T>
-void vector<T>::push_back(const value_type& value)
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::push_back(const value_type& value)
 {
   if (end_ != cap_)
   {
-    data_allocator::construct(mystl::address_of(*end_), value);
+    alloc_traits::construct(this->get_alloc(), mystl::address_of(*end_), value);
     ++end_;
   }
   else
@@ -457,36 +555,30 @@ void vector<T>::push_back(const value_type& value)
 }
 
 // 弹出尾部元素
-template <class T>
-void vector<T>::pop_back()
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::pop_back()
 {
   MYSTL_DEBUG(!empty());
-  data_allocator::destroy(end_ - 1);
+  alloc_traits::destroy(this->get_alloc(), end_ - 1);
   --end_;
 }
 
 // 在 pos 处插入元素
-template <class T>
-typename vector<T>::iterator
-vector<T>::insert(const_iterator pos, const value_type& value)
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::insert(const_iterator pos, const value_type& value)
 {
   MYSTL_DEBUG(pos >= begin() && pos <= end());
   iterator xpos = const_cast<iterator>(pos);
   const size_type n = pos - begin_;
   if (end_ != cap_ && xpos == end_)
   {
-    data_allocator::construct(mystl::address_of(*end_), value);
+    alloc_traits::construct(this->get_alloc(), mystl::address_of(*end_), value);
     ++end_;
   }
   else if (end_ != cap_)
   {
-    auto new_end = end_;
-    data_allocator::construct(mystl::address_of(*end_), *(end_ - 1));
-    ++new_end;
-    auto value_copy = value;  // 避免元素因以下复制操作而被改变
-    mystl::copy_backward(xpos, end_ - 1, end_);
-    *xpos = mystl::move(value_copy);
-    end_ = new_end;
+    emplace_shift(xpos, relocatable(), value);
   }
   else
   {
@@ -496,34 +588,50 @@ vector<T>::insert(const_iterator pos, const value_type& value)
 }
 
 // 删除 pos 位置上的元素
-template <class T>
-typename vector<T>::iterator
-vector<T>::erase(const_iterator pos)
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::erase(const_iterator pos)
 {
   MYSTL_DEBUG(pos >= begin() && pos < end());
   iterator xpos = begin_ + (pos - begin());
-  mystl::move(xpos + 1, end_, xpos);
-  data_allocator::destroy(end_ - 1);
+  if (relocatable::value)
+  { // 析构被删除的元素，后面的元素直接前移
+    alloc_traits::destroy(this->get_alloc(), xpos);
+    move_bytes(xpos, xpos + 1, end_ - xpos - 1);
+  }
+  else
+  {
+    mystl::move(xpos + 1, end_, xpos);
+    alloc_traits::destroy(this->get_alloc(), end_ - 1);
+  }
   --end_;
   return xpos;
 }
 
 // 删除[first, last)上的元素
-template <class T>
-typename vector<T>::iterator
-vector<T>::erase(const_iterator first, const_iterator last)
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::erase(const_iterator first, const_iterator last)
 {
   MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
   const auto n = first - begin();
   iterator r = begin_ + (first - begin());
-  data_allocator::destroy(mystl::move(r + (last - first), end_, r), end_);
+  if (relocatable::value)
+  {
+    mystl::destroy(r, r + (last - first));
+    move_bytes(r, r + (last - first), end_ - r - (last - first));
+  }
+  else
+  {
+    mystl::destroy(mystl::move(r + (last - first), end_, r), end_);
+  }
   end_ = end_ - (last - first);
   return begin_ + n;
 }
 
 // 重置容器大小
-template <class T>
-void vector<T>::resize(size_type new_size, const value_type& value)
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::resize(size_type new_size, const value_type& value)
 {
   if (new_size < size())
   {
@@ -535,12 +643,28 @@ void vector<T>::resize(size_type new_size, const value_type& value)
   }
 }
 
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::resize_default_init(size_type new_size)
+{
+  if (new_size <= size())
+  {
+    erase(begin() + new_size, end());
+    return;
+  }
+  if (new_size > capacity())
+    reserve(get_new_cap(new_size - size()));
+  end_ = mystl::uninitialized_default_construct_n(end_, new_size - size());
+}
+
 // 与另一个 vector 交换
-template <class T>
-void vector<T>::swap(vector<T>& rhs) noexcept
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::swap(vector<T, Alloc, Growth>& rhs) noexcept
 {
   if (this != &rhs)
   {
+    MYSTL_DEBUG(alloc_traits::propagate_on_container_swap::value ||
+                this->get_alloc() == rhs.get_alloc());
+    mystl::alloc_on_swap(this->get_alloc(), rhs.get_alloc());
     mystl::swap(begin_, rhs.begin_);
     mystl::swap(end_, rhs.end_);
     mystl::swap(cap_, rhs.cap_);
@@ -551,14 +675,15 @@ void vector<T>::swap(vector<T>& rhs) noexcept
 // helper function
 
 // try_init 函数，若分配失败则忽略，不抛出异常
-template <class T>
-void vector<T>::try_init() noexcept
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::try_init() noexcept
 {
   try
   {
-    begin_ = data_allocator::allocate(16);
+    size_type cap = Growth::initial_capacity();
+    begin_ = cap == 0 ? nullptr : allocate_space(cap);
     end_ = begin_;
-    cap_ = begin_ + 16;
+    cap_ = begin_ + cap;
   }
   catch (...)
   {
@@ -569,12 +694,12 @@ void vector<T>::try_init() noexcept
 }
 
 // init_space 函数
-template <class T>
-void vector<T>::init_space(size_type size, size_type cap)
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::init_space(size_type size, size_type cap)
 {
   try
   {
-    begin_ = data_allocator::allocate(cap);
+    begin_ = allocate_space(cap);
     end_ = begin_ + size;
     cap_ = begin_ + cap;
   }
@@ -588,64 +713,57 @@ void vector<T>::init_space(size_type size, size_type cap)
 }
 
 // fill_init 函数
-template <class T>
-void vector<T>::
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::
 fill_init(size_type n, const value_type& value)
 {
-  const size_type init_size = mystl::max(static_cast<size_type>(16), n);
+  const size_type init_size = mystl::max(static_cast<size_type>(Growth::initial_capacity()), n);
   init_space(n, init_size);
   mystl::uninitialized_fill_n(begin_, n, value);
 }
 
 // range_init 函数
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class Iter>
-void vector<T>::
+void vector<T, Alloc, Growth>::
 range_init(Iter first, Iter last)
 {
   const size_type init_size = mystl::max(static_cast<size_type>(last - first),
-                                         static_cast<size_type>(16));
+                                         static_cast<size_type>(Growth::initial_capacity()));
   init_space(static_cast<size_type>(last - first), init_size);
   mystl::uninitialized_copy(first, last, begin_);
 }
 
 // destroy_and_recover 函数
-template <class T>
-void vector<T>::
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::
 destroy_and_recover(iterator first, iterator last, size_type n)
 {
-  data_allocator::destroy(first, last);
-  data_allocator::deallocate(first, n);
+  mystl::destroy(first, last);
+  if (first != nullptr)
+    alloc_traits::deallocate(this->get_alloc(), first, n);
 }
 
 // get_new_cap 函数
-template <class T>
-typename vector<T>::size_type 
-vector<T>::
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::size_type 
+vector<T, Alloc, Growth>::
 get_new_cap(size_type add_size)
 {
   const auto old_size = capacity();
   THROW_LENGTH_ERROR_IF(old_size > max_size() - add_size,
                         "vector<T>'s size too big");
-  if (old_size > max_size() - old_size / 2)
-  {
-    return old_size + add_size > max_size() - 16
-      ? old_size + add_size : old_size + add_size + 16;
-  }
-  const size_type new_size = old_size == 0
-    ? mystl::max(add_size, static_cast<size_type>(16))
-    : mystl::max(old_size + old_size / 2, old_size + add_size);
-  return new_size;
+  return Growth::next_capacity(old_size, add_size, max_size());
 }
 
 // fill_assign 函数
-template <class T>
-void vector<T>::
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::
 fill_assign(size_type n, const value_type& value)
 {
   if (n > capacity())
   {
-    vector tmp(n, value);
+    vector tmp(n, value, this->get_alloc());
     swap(tmp);
   }
   else if (n > size())
@@ -660,9 +778,9 @@ fill_assign(size_type n, const value_type& value)
 }
 
 // copy_assign 函数
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class IIter>
-void vector<T>::
+void vector<T, Alloc, Growth>::
 copy_assign(IIter first, IIter last, input_iterator_tag)
 {
   auto cur = begin_;
@@ -681,21 +799,21 @@ copy_assign(IIter first, IIter last, input_iterator_tag)
 }
 
 // 用 [first, last) 为容器赋值
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class FIter>
-void vector<T>::
+void vector<T, Alloc, Growth>::
 copy_assign(FIter first, FIter last, forward_iterator_tag)
 {
   const size_type len = mystl::distance(first, last);
   if (len > capacity())
   {
-    vector tmp(first, last);
+    vector tmp(first, last, this->get_alloc());
     swap(tmp);
   }
   else if (size() >= len)
   {
     auto new_end = mystl::copy(first, last, begin_);
-    data_allocator::destroy(new_end, end_);
+    mystl::destroy(new_end, end_);
     end_ = new_end;
   }
   else
@@ -709,73 +827,190 @@ copy_assign(FIter first, FIter last, forward_iterator_tag)
 }
 
 // 重新分配空间并在 pos 处就地构造元素
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class ...Args>
-void vector<T>::
+void vector<T, Alloc, Growth>::
 reallocate_emplace(iterator pos, Args&& ...args)
 {
-  const auto new_size = get_new_cap(1);
-  auto new_begin = data_allocator::allocate(new_size);
-  auto new_end = new_begin;
+  if (realloc_emplace(realloc_in_place(), pos, mystl::forward<Args>(args)...))
+    return;
+  auto new_size = get_new_cap(1);
+  auto new_begin = allocate_space(new_size);
   try
+  { // 先构造新元素，参数可能引用容器中的元素
+    alloc_traits::construct(this->get_alloc(), new_begin + (pos - begin_), mystl::forward<Args>(args)...);
+  }
+  catch (...)
   {
-    new_end = mystl::uninitialized_move(begin_, pos, new_begin);
-    data_allocator::construct(mystl::address_of(*new_end), mystl::forward<Args>(args)...);
-    ++new_end;
-    new_end = mystl::uninitialized_move(pos, end_, new_end);
+    alloc_traits::deallocate(this->get_alloc(), new_begin, new_size);
+    throw;
+  }
+  relocate_around(new_begin, new_size, pos, 1);
+}
+
+// 重新分配空间并在 pos 处插入元素
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::reallocate_insert(iterator pos, const value_type& value)
+{
+  if (realloc_emplace(realloc_in_place(), pos, value))
+    return;
+  auto new_size = get_new_cap(1);
+  auto new_begin = allocate_space(new_size);
+  try
+  {
+    alloc_traits::construct(this->get_alloc(), new_begin + (pos - begin_), value);
   }
   catch (...)
   {
-    data_allocator::deallocate(new_begin, new_size);
+    alloc_traits::deallocate(this->get_alloc(), new_begin, new_size);
     throw;
   }
-  destroy_and_recover(begin_, end_, cap_ - begin_);
-  begin_ = new_begin;
+  relocate_around(new_begin, new_size, pos, 1);
+}
+
+// emplace_shift 函数，备用空间足够时在 pos 处构造元素，可以平凡重定位时直接后移后面的元素
+template <class T, class Alloc, class Growth>
+template <class ...Args>
+void vector<T, Alloc, Growth>::emplace_shift(iterator pos, m_true_type, Args&& ...args)
+{
+  value_type tmp(mystl::forward<Args>(args)...);  // 参数可能引用容器中的元素
+  shift_emplace(pos, tmp);
+}
+
+template <class T, class Alloc, class Growth>
+template <class ...Args>
+void vector<T, Alloc, Growth>::emplace_shift(iterator pos, m_false_type, Args&& ...args)
+{
+  value_type tmp(mystl::forward<Args>(args)...);  // 避免元素因以下复制操作而被改变
+  auto new_end = end_;
+  alloc_traits::construct(this->get_alloc(), mystl::address_of(*end_), *(end_ - 1));
+  ++new_end;
+  mystl::copy_backward(pos, end_ - 1, end_);
+  *pos = mystl::move(tmp);
   end_ = new_end;
-  cap_ = new_begin + new_size;
 }
 
-// 重新分配空间并在 pos 处插入元素
-template <class T>
-void vector<T>::reallocate_insert(iterator pos, const value_type& value)
+// shift_emplace 函数，把 [pos, end_) 按字节后移一位，再用 value 移动构造 pos 处的元素
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::shift_emplace(iterator pos, value_type& value)
 {
-  const auto new_size = get_new_cap(1);
-  auto new_begin = data_allocator::allocate(new_size);
-  auto new_end = new_begin;
-  const value_type& value_copy = value;
+  move_bytes(pos + 1, pos, end_ - pos);
   try
   {
-    new_end = mystl::uninitialized_move(begin_, pos, new_begin);
-    data_allocator::construct(mystl::address_of(*new_end), value_copy);
-    ++new_end;
-    new_end = mystl::uninitialized_move(pos, end_, new_end);
+    alloc_traits::construct(this->get_alloc(), pos, mystl::move(value));
   }
   catch (...)
   {
-    data_allocator::deallocate(new_begin, new_size);
+    move_bytes(pos, pos + 1, end_ - pos);
     throw;
   }
-  destroy_and_recover(begin_, end_, cap_ - begin_);
+  ++end_;
+}
+
+// relocate_around 函数，新空间的 [pos - begin_, pos - begin_ + n) 处已经构造了新元素，
+// 把原有的元素搬到它们的两侧并换用新空间；搬移失败时析构新元素、回收新空间，原有元素不变
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::
+relocate_around(iterator new_begin, size_type new_cap, iterator pos, size_type n)
+{
+  const size_type old_size = size();
+  const size_type xpos = pos - begin_;
+  try
+  {
+    relocate_around_aux(new_begin, pos, n, relocatable());
+  }
+  catch (...)
+  {
+    mystl::destroy(new_begin + xpos, new_begin + xpos + n);
+    alloc_traits::deallocate(this->get_alloc(), new_begin, new_cap);
+    throw;
+  }
+  // 按字节搬走的元素不能再析构
+  destroy_and_recover(begin_, relocatable::value ? begin_ : end_, cap_ - begin_);
   begin_ = new_begin;
-  end_ = new_end;
-  cap_ = new_begin + new_size;
+  end_ = new_begin + old_size + n;
+  cap_ = new_begin + new_cap;
+}
+
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::
+relocate_around_aux(iterator new_begin, iterator pos, size_type n, m_true_type) noexcept
+{
+  move_bytes(new_begin, begin_, pos - begin_);
+  move_bytes(new_begin + (pos - begin_) + n, pos, end_ - pos);
+}
+
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::
+relocate_around_aux(iterator new_begin, iterator pos, size_type n, m_false_type)
+{
+  auto mid = mystl::uninitialized_move(begin_, pos, new_begin);
+  try
+  {
+    mystl::uninitialized_move(pos, end_, mid + n);
+  }
+  catch (...)
+  {
+    mystl::destroy(new_begin, mid);
+    throw;
+  }
+}
+
+// try_realloc_aux 函数，由配置器原地把容量调整为 new_cap
+template <class T, class Alloc, class Growth>
+bool vector<T, Alloc, Growth>::try_realloc_aux(size_type new_cap, m_true_type)
+{
+  const size_type old_size = size();
+  begin_ = alloc_traits::reallocate(this->get_alloc(), begin_, capacity(), new_cap);
+  end_ = begin_ + old_size;
+  cap_ = begin_ + new_cap;
+  return true;
+}
+
+// realloc_emplace 函数，原地扩容后在 pos 处构造元素
+template <class T, class Alloc, class Growth>
+template <class ...Args>
+bool vector<T, Alloc, Growth>::
+realloc_emplace(m_true_type, iterator pos, Args&& ...args)
+{
+  value_type tmp(mystl::forward<Args>(args)...);  // 参数可能引用容器中的元素，扩容前先构造
+  const size_type xpos = pos - begin_;
+  try_realloc_aux(get_new_cap(1), m_true_type());
+  shift_emplace(begin_ + xpos, tmp);
+  return true;
 }
 
 // fill_insert 函数
-template <class T>
-typename vector<T>::iterator 
-vector<T>::
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator 
+vector<T, Alloc, Growth>::
 fill_insert(iterator pos, size_type n, const value_type& value)
 {
   if (n == 0)
     return pos;
   const size_type xpos = pos - begin_;
   const value_type value_copy = value;  // 避免被覆盖
+  if (static_cast<size_type>(cap_ - end_) < n && try_realloc(get_new_cap(n)))
+    pos = begin_ + xpos;
   if (static_cast<size_type>(cap_ - end_) >= n)
   { // 如果备用空间大于等于增加的空间
     const size_type after_elems = end_ - pos;
     auto old_end = end_;
-    if (after_elems > n)
+    if (relocatable::value)
+    { // 后面的元素直接后移，空出的位置上构造新元素
+      move_bytes(pos + n, pos, after_elems);
+      try
+      {
+        mystl::uninitialized_fill_n(pos, n, value_copy);
+      }
+      catch (...)
+      {
+        move_bytes(pos, pos + n, after_elems);
+        throw;
+      }
+      end_ += n;
+    }
+    else if (after_elems > n)
     {
       mystl::uninitialized_copy(end_ - n, end_, end_);
       end_ += n;
@@ -791,42 +1026,56 @@ fill_insert(iterator pos, size_type n, const value_type& value)
   }
   else
   { // 如果备用空间不足
-    const auto new_size = get_new_cap(n);
-    auto new_begin = data_allocator::allocate(new_size);
-    auto new_end = new_begin;
+    auto new_size = get_new_cap(n);
+    auto new_begin = allocate_space(new_size);
     try
     {
-      new_end = mystl::uninitialized_move(begin_, pos, new_begin);
-      new_end = mystl::uninitialized_fill_n(new_end, n, value);
-      new_end = mystl::uninitialized_move(pos, end_, new_end);
+      mystl::uninitialized_fill_n(new_begin + xpos, n, value_copy);
     }
     catch (...)
     {
-      destroy_and_recover(new_begin, new_end, new_size);
+      alloc_traits::deallocate(this->get_alloc(), new_begin, new_size);
       throw;
     }
-    data_allocator::deallocate(begin_, cap_ - begin_);
-    begin_ = new_begin;
-    end_ = new_end;
-    cap_ = begin_ + new_size;
+    relocate_around(new_begin, new_size, pos, n);
   }
   return begin_ + xpos;
 }
 
 // copy_insert 函数
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class IIter>
-void vector<T>::
+void vector<T, Alloc, Growth>::
 copy_insert(iterator pos, IIter first, IIter last)
 {
   if (first == last)
     return;
   const auto n = mystl::distance(first, last);
+  if ((cap_ - end_) < n)
+  {
+    const auto xpos = pos - begin_;
+    if (try_realloc(get_new_cap(n)))
+      pos = begin_ + xpos;
+  }
   if ((cap_ - end_) >= n)
   { // 如果备用空间大小足够
     const auto after_elems = end_ - pos;
     auto old_end = end_;
-    if (after_elems > n)
+    if (relocatable::value)
+    {
+      move_bytes(pos + n, pos, after_elems);
+      try
+      {
+        mystl::uninitialized_copy(first, last, pos);
+      }
+      catch (...)
+      {
+        move_bytes(pos, pos + n, after_elems);
+        throw;
+      }
+      end_ += n;
+    }
+    else if (after_elems > n)
     {
       end_ = mystl::uninitialized_copy(end_ - n, end_, end_);
       mystl::move_backward(pos, old_end - n, old_end);
@@ -843,94 +1092,119 @@ copy_insert(iterator pos, IIter first, IIter last)
   }
   else
   { // 备用空间不足
-    const auto new_size = get_new_cap(n);
-    auto new_begin = data_allocator::allocate(new_size);
-    auto new_end = new_begin;
+    auto new_size = get_new_cap(n);
+    auto new_begin = allocate_space(new_size);
     try
     {
-      new_end = mystl::uninitialized_move(begin_, pos, new_begin);
-      new_end = mystl::uninitialized_copy(first, last, new_end);
-      new_end = mystl::uninitialized_move(pos, end_, new_end);
+      mystl::uninitialized_copy(first, last, new_begin + (pos - begin_));
     }
     catch (...)
     {
-      destroy_and_recover(new_begin, new_end, new_size);
+      alloc_traits::deallocate(this->get_alloc(), new_begin, new_size);
       throw;
     }
-    data_allocator::deallocate(begin_, cap_ - begin_);
-    begin_ = new_begin;
-    end_ = new_end;
-    cap_ = begin_ + new_size;
+    relocate_around(new_begin, new_size, pos, n);
   }
 }
 
-// reinsert 函数
-template <class T>
-void vector<T>::reinsert(size_type size)
+// move_assign 函数，可以直接接管 rhs 的空间
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::move_assign(vector& rhs, m_true_type)
 {
-  auto new_begin = data_allocator::allocate(size);
-  try
+  destroy_and_recover(begin_, end_, cap_ - begin_);
+  mystl::alloc_on_move(this->get_alloc(), rhs.get_alloc());
+  begin_ = rhs.begin_;
+  end_ = rhs.end_;
+  cap_ = rhs.cap_;
+  rhs.begin_ = nullptr;
+  rhs.end_ = nullptr;
+  rhs.cap_ = nullptr;
+}
+
+// move_assign 函数，配置器不传播时，只有两者相等才能接管空间，否则逐个移动元素
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::move_assign(vector& rhs, m_false_type)
+{
+  if (this->get_alloc() == rhs.get_alloc())
   {
-    mystl::uninitialized_move(begin_, end_, new_begin);
+    move_assign(rhs, m_true_type());
   }
-  catch (...)
+  else
   {
-    data_allocator::deallocate(new_begin, size);
-    throw;
+    clear();
+    reserve(rhs.size());
+    end_ = mystl::uninitialized_move(rhs.begin_, rhs.end_, begin_);
+    rhs.clear();
   }
-  data_allocator::deallocate(begin_, cap_ - begin_);
-  begin_ = new_begin;
-  end_ = begin_ + size;
-  cap_ = begin_ + size;
+}
+
+// reinsert 函数
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::reinsert(size_type size)
+{
+  if (size != 0 && try_realloc(size))
+    return;
+  auto new_begin = allocate_space(size);
+  relocate_around(new_begin, size, end_, 0);
 }
 
 /*****************************************************************************************/
 // 重载比较操作符
 
-template <class T>
-bool operator==(const vector<T>& lhs, const vector<T>& rhs)
+template <class T, class Alloc, class Growth>
+bool operator==(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
   return lhs.size() == rhs.size() &&
     mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class T>
-bool operator<(const vector<T>& lhs, const vector<T>& rhs)
+template <class T, class Alloc, class Growth>
+bool operator<(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
-  return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), lhs.end());
+  return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
-template <class T>
-bool operator!=(const vector<T>& lhs, const vector<T>& rhs)
+template <class T, class Alloc, class Growth>
+bool operator!=(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class T>
-bool operator>(const vector<T>& lhs, const vector<T>& rhs)
+template <class T, class Alloc, class Growth>
+bool operator>(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class T>
-bool operator<=(const vector<T>& lhs, const vector<T>& rhs)
+template <class T, class Alloc, class Growth>
+bool operator<=(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class T>
-bool operator>=(const vector<T>& lhs, const vector<T>& rhs)
+template <class T, class Alloc, class Growth>
+bool operator>=(const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class T>
-void swap(vector<T>& lhs, vector<T>& rhs)
+template <class T, class Alloc, class Growth>
+void swap(vector<T, Alloc, Growth>& lhs, vector<T, Alloc, Growth>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
 
+// 模板别名 : aligned_vector
+// data() 返回的地址是 Align 的倍数，每次重新分配后依然如此
+template <class T, size_t Align = ECacheLineSize>
+using aligned_vector = vector<T, aligned_allocator<T, Align>>;
+
+// 元素保存在堆上，对象本身不含指向自身的指针，Alloc 可以平凡重定位时容器也可以平凡重定位
+template <class T, class Alloc, class Growth>
+struct is_trivially_relocatable<vector<T, Alloc, Growth>>
+  : m_bool_constant<is_trivially_relocatable<Alloc>::value> {};
+
 } // namespace mystl
 #endif // !MYTINYSTL_VECTOR_H_
 
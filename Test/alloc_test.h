@@ -0,0 +1,783 @@
+﻿#ifndef MYTINYSTL_ALLOC_TEST_H_
+#define MYTINYSTL_ALLOC_TEST_H_
+
+// alloc test : 测试 alloc 内存池、pool_allocator、mmap_allocator、aligned_allocator、malloc_allocator、
+//              tracking_allocator 的接口和性能，
+//              容器对有状态配置器的支持，以及容器的 memory_usage
+
+#include <thread>
+#include <vector>
+
+#include "../MyTinySTL/aligned_allocator.h"
+#include "../MyTinySTL/alloc.h"
+#include "../MyTinySTL/astring.h"
+#include "../MyTinySTL/deque.h"
+#include "../MyTinySTL/list.h"
+#include "../MyTinySTL/malloc_allocator.h"
+#include "../MyTinySTL/map.h"
+#include "../MyTinySTL/mmap_allocator.h"
+#include "../MyTinySTL/tracking_allocator.h"
+#include "../MyTinySTL/unordered_map.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace alloc_test
+{
+
+TEST(alloc_size_class_test)
+{
+  // 每个大小的区块都能写满，而且同时存活的区块互不重叠
+  std::vector<char*> blocks;
+  for (size_t n = 1; n <= 5000; n += 37)
+  {
+    char* p = static_cast<char*>(mystl::alloc::allocate(n));
+    for (size_t i = 0; i < n; ++i)
+      p[i] = static_cast<char>(n);
+    blocks.push_back(p);
+  }
+  bool ok = true;
+  size_t k = 0;
+  for (size_t n = 1; n <= 5000; n += 37, ++k)
+  {
+    for (size_t i = 0; i < n; ++i)
+      ok = ok && blocks[k][i] == static_cast<char>(n);
+    mystl::alloc::deallocate(blocks[k], n);
+  }
+  EXPECT_TRUE(ok);
+}
+
+TEST(alloc_reuse_test)
+{
+  // 刚回收的区块会被同一线程马上复用
+  void* p1 = mystl::alloc::allocate(24);
+  mystl::alloc::deallocate(p1, 24);
+  void* p2 = mystl::alloc::allocate(20);
+  EXPECT_TRUE(p1 == p2);
+  mystl::alloc::deallocate(p2, 20);
+}
+
+TEST(alloc_reallocate_test)
+{
+  char* p = static_cast<char*>(mystl::alloc::allocate(10));
+  for (int i = 0; i < 10; ++i)
+    p[i] = static_cast<char>(i);
+  p = static_cast<char*>(mystl::alloc::reallocate(p, 10, 300));
+  bool ok = true;
+  for (int i = 0; i < 10; ++i)
+    ok = ok && p[i] == static_cast<char>(i);
+  p = static_cast<char*>(mystl::alloc::reallocate(p, 300, 8000));
+  for (int i = 0; i < 10; ++i)
+    ok = ok && p[i] == static_cast<char>(i);
+  mystl::alloc::deallocate(p, 8000);
+  EXPECT_TRUE(ok);
+}
+
+TEST(alloc_cross_thread_test)
+{
+  // 一个线程分配，另一个线程回收，再由多个线程同时分配回收
+  const size_t n = 10000;
+  std::vector<int*> v(n);
+  std::thread producer([&v, n]() {
+    for (size_t i = 0; i < n; ++i)
+    {
+      v[i] = mystl::pool_allocator<int>::allocate();
+      *v[i] = static_cast<int>(i);
+    }
+  });
+  producer.join();
+  bool ok = true;
+  std::thread consumer([&v, &ok, n]() {
+    for (size_t i = 0; i < n; ++i)
+    {
+      ok = ok && *v[i] == static_cast<int>(i);
+      mystl::pool_allocator<int>::deallocate(v[i]);
+    }
+  });
+  consumer.join();
+  EXPECT_TRUE(ok);
+
+  std::vector<std::thread> workers;
+  std::vector<int> result(4, 1);
+  for (int t = 0; t < 4; ++t)
+  {
+    workers.push_back(std::thread([&result, t]() {
+      std::vector<double*> mine;
+      for (int round = 0; round < 50; ++round)
+      {
+        for (int i = 0; i < 200; ++i)
+        {
+          mine.push_back(mystl::pool_allocator<double>::allocate());
+          *mine.back() = t * 1000 + i;
+        }
+        for (int i = 0; i < 200; ++i)
+        {
+          if (*mine[i] != t * 1000 + i)
+            result[t] = 0;
+          mystl::pool_allocator<double>::deallocate(mine[i]);
+        }
+        mine.clear();
+      }
+    }));
+  }
+  for (auto& w : workers)
+    w.join();
+  EXPECT_EQ(4, result[0] + result[1] + result[2] + result[3]);
+}
+
+TEST(alloc_free_only_thread_test)
+{
+  // 只回收不分配的线程退出时，缓存中的区块全部归还中心链表
+  const size_t n = 100;
+  std::vector<void*> v(n);
+  for (size_t i = 0; i < n; ++i)
+    v[i] = mystl::alloc::allocate(200);
+  const size_t before = mystl::alloc::central_free_count(200);
+  std::thread consumer([&v, n]() {
+    for (size_t i = 0; i < n; ++i)
+      mystl::alloc::deallocate(v[i], 200);
+  });
+  consumer.join();
+  EXPECT_EQ(before + n, mystl::alloc::central_free_count(200));
+}
+
+TEST(pool_allocator_test)
+{
+  struct alignas(16) line { char c[48]; };
+  int* p = mystl::pool_allocator<int>::allocate(100);
+  for (int i = 0; i < 100; ++i)
+    mystl::pool_allocator<int>::construct(p + i, i);
+  EXPECT_EQ(99, p[99]);
+  mystl::pool_allocator<int>::destroy(p, p + 100);
+  mystl::pool_allocator<int>::deallocate(p, 100);
+  EXPECT_TRUE(mystl::pool_allocator<int>::allocate(0) == nullptr);
+  // 对齐要求超过 8 字节的类型不走内存池
+  line* l = mystl::pool_allocator<line>::allocate();
+  EXPECT_EQ(0u, reinterpret_cast<size_t>(l) % 16);
+  mystl::pool_allocator<line>::deallocate(l);
+}
+
+// 有状态的配置器：记录编号和仍未归还的区块数，编号不同的配置器互不相等，缺省不传播
+template <class T>
+class tagged_allocator
+{
+public:
+  typedef T value_type;
+
+  int   id;
+  long* live;
+
+  tagged_allocator(int i, long* l) noexcept : id(i), live(l) {}
+  template <class U>
+  tagged_allocator(const tagged_allocator<U>& rhs) noexcept : id(rhs.id), live(rhs.live) {}
+
+  T* allocate(size_t n)
+  {
+    ++*live;
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+  void deallocate(T* p, size_t)
+  {
+    --*live;
+    ::operator delete(p);
+  }
+};
+
+template <class T, class U>
+bool operator==(const tagged_allocator<T>& lhs, const tagged_allocator<U>& rhs)
+{
+  return lhs.id == rhs.id;
+}
+
+template <class T, class U>
+bool operator!=(const tagged_allocator<T>& lhs, const tagged_allocator<U>& rhs)
+{
+  return lhs.id != rhs.id;
+}
+
+// 在复制、移动赋值和交换时都会传播的版本
+template <class T>
+class tagged_prop_allocator : public tagged_allocator<T>
+{
+public:
+  typedef m_true_type propagate_on_container_copy_assignment;
+  typedef m_true_type propagate_on_container_move_assignment;
+  typedef m_true_type propagate_on_container_swap;
+
+  tagged_prop_allocator(int i, long* l) noexcept : tagged_allocator<T>(i, l) {}
+  template <class U>
+  tagged_prop_allocator(const tagged_prop_allocator<U>& rhs) noexcept
+    : tagged_allocator<T>(rhs.id, rhs.live) {}
+};
+
+// 对一种容器检查：配置器的保存、复制构造、不传播时的复制/移动赋值，以及所有区块都被归还
+template <class Container, class Alloc, class Fill>
+bool stateful_alloc_check(Fill fill)
+{
+  long live = 0;
+  bool ok = true;
+  {
+    Container a{Alloc(1, &live)};
+    fill(a);
+    ok = ok && a.get_allocator().id == 1 && live > 0;
+    Container b(a);
+    ok = ok && b.get_allocator().id == 1 && b == a;
+    Container c{Alloc(2, &live)};
+    c = a;
+    ok = ok && c.get_allocator().id == 2 && c == a;
+    Container d{Alloc(3, &live)};
+    d = mystl::move(c);  // 配置器不相等，只能逐个移动元素
+    ok = ok && d.get_allocator().id == 3 && d == a;
+    Container e(mystl::move(d));
+    ok = ok && e.get_allocator().id == 3 && e == a;
+    Container f(a, Alloc(4, &live));
+    ok = ok && f.get_allocator().id == 4 && f == a;
+  }
+  return ok && live == 0;
+}
+
+TEST(stateful_allocator_test)
+{
+  typedef tagged_allocator<int> int_alloc;
+  typedef tagged_allocator<char> char_alloc;
+  typedef tagged_allocator<mystl::pair<const int, int>> pair_alloc;
+  EXPECT_TRUE((stateful_alloc_check<mystl::vector<int, int_alloc>, int_alloc>(
+    [](mystl::vector<int, int_alloc>& c) { for (int i = 0; i < 100; ++i) c.push_back(i); })));
+  EXPECT_TRUE((stateful_alloc_check<mystl::list<int, int_alloc>, int_alloc>(
+    [](mystl::list<int, int_alloc>& c) { for (int i = 0; i < 100; ++i) c.push_back(i); })));
+  EXPECT_TRUE((stateful_alloc_check<mystl::deque<int, int_alloc>, int_alloc>(
+    [](mystl::deque<int, int_alloc>& c) { for (int i = 0; i < 1000; ++i) c.push_front(i); })));
+  typedef mystl::basic_string<char, mystl::char_traits<char>, char_alloc> tagged_string;
+  EXPECT_TRUE((stateful_alloc_check<tagged_string, char_alloc>(
+    [](tagged_string& c) { for (int i = 0; i < 100; ++i) c.append(1, static_cast<char>('a' + i % 26)); })));
+  typedef mystl::map<int, int, mystl::less<int>, pair_alloc> tagged_map;
+  EXPECT_TRUE((stateful_alloc_check<tagged_map, pair_alloc>(
+    [](tagged_map& c) { for (int i = 0; i < 100; ++i) c[i] = i; })));
+  typedef mystl::unordered_map<int, int, mystl::hash<int>, mystl::equal_to<int>, pair_alloc> tagged_umap;
+  EXPECT_TRUE((stateful_alloc_check<tagged_umap, pair_alloc>(
+    [](tagged_umap& c) { for (int i = 0; i < 1000; ++i) c[i] = i; })));
+}
+
+TEST(allocator_propagation_test)
+{
+  // 空的配置器不占用容器的空间
+  EXPECT_EQ(3 * sizeof(int*), sizeof(mystl::vector<int>));
+  EXPECT_EQ(3 * sizeof(int*) + sizeof(tagged_allocator<int>),
+            sizeof(mystl::vector<int, tagged_allocator<int>>));
+  typedef tagged_prop_allocator<int> prop_alloc;
+  long live = 0;
+  {
+    mystl::vector<int, prop_alloc> a(10, 1, prop_alloc(1, &live));
+    mystl::vector<int, prop_alloc> b(20, 2, prop_alloc(2, &live));
+    a.swap(b);
+    EXPECT_EQ(2, a.get_allocator().id);
+    EXPECT_EQ(1, b.get_allocator().id);
+    EXPECT_EQ(20u, a.size());
+    a = b;
+    EXPECT_EQ(1, a.get_allocator().id);
+    mystl::list<int, prop_alloc> l1(5, 1, prop_alloc(3, &live));
+    mystl::list<int, prop_alloc> l2(5, 2, prop_alloc(4, &live));
+    l1 = mystl::move(l2);
+    EXPECT_EQ(4, l1.get_allocator().id);
+    EXPECT_EQ(2, l1.front());
+  }
+  EXPECT_EQ(0, live);
+}
+
+TEST(pool_node_allocator_test)
+{
+  // 节点容器按需选用内存池作为节点配置器
+  mystl::map<int, int, mystl::less<int>, mystl::pool_allocator<mystl::pair<const int, int>>> m;
+  mystl::list<int, mystl::pool_allocator<int>> l;
+  for (int i = 0; i < 1000; ++i)
+  {
+    m[i] = i * 2;
+    l.push_back(i);
+  }
+  EXPECT_EQ(1000u, m.size());
+  EXPECT_EQ(1998, m[999]);
+  EXPECT_EQ(999, l.back());
+  m.clear();
+  l.clear();
+  EXPECT_TRUE(m.empty());
+}
+
+TEST(node_pool_test)
+{
+  typedef tagged_allocator<int> int_alloc;
+  typedef tagged_allocator<mystl::pair<const int, int>> pair_alloc;
+  long live = 0;
+  {
+    // 节点按 slab 申请，删除的节点被复用，clear 时 slab 全部归还
+    mystl::map<int, int, mystl::less<int>, pair_alloc> m(mystl::less<int>(), pair_alloc(1, &live));
+    for (int i = 0; i < 1000; ++i)
+      m[i] = i;
+    const long slabs = live;
+    EXPECT_TRUE(slabs < 1000 / 32);
+    for (int i = 0; i < 1000; i += 2)
+      m.erase(i);
+    for (int i = 0; i < 500; ++i)
+      m[1000 + i] = i;
+    EXPECT_EQ(slabs, live);
+    EXPECT_EQ(1000u, m.size());
+    m.clear();
+    EXPECT_EQ(1, live);  // 只剩 header
+
+    mystl::unordered_map<int, int, mystl::hash<int>, mystl::equal_to<int>, pair_alloc>
+      um(16, mystl::hash<int>(), mystl::equal_to<int>(), pair_alloc(1, &live));
+    for (int i = 0; i < 1000; ++i)
+      um[i] = i;
+    for (int i = 0; i < 1000; ++i)
+      um.erase(i);
+    um.clear();
+    EXPECT_EQ(2, live);  // map 的 header 与 bucket 数组
+
+    // list 相邻插入的节点在内存中相邻
+    mystl::list<int, int_alloc> l1(int_alloc(1, &live));
+    mystl::list<int, int_alloc> l2(int_alloc(1, &live));
+    for (int i = 0; i < 10; ++i)
+      l2.push_back(i);
+    auto it = l2.begin();
+    const char* p0 = reinterpret_cast<const char*>(&*it);
+    const char* p1 = reinterpret_cast<const char*>(&*++it);
+    EXPECT_EQ(sizeof(mystl::list_node<int>), static_cast<size_t>(p1 - p0));
+    EXPECT_EQ(6, live);  // 两个哨兵节点与 8、16 个节点的两个 slab
+
+    // 接合到另一个 list 的节点留在原来的 slab 中，slab 在它的最后一个节点归还时才释放
+    l1.splice(l1.begin(), l2, l2.begin());
+    l1.splice(l1.end(), l2, l2.begin(), ++(++l2.begin()));
+    EXPECT_EQ(0, l1.front());
+    EXPECT_EQ(3u, l1.size());
+    l2.clear();
+    EXPECT_EQ(5, live);
+    l1.erase(l1.begin());
+    EXPECT_EQ(5, live);
+    l1.clear();
+    EXPECT_EQ(4, live);
+
+    // 两个 list 在不同的线程中归还同一个 slab 的节点
+    for (int i = 0; i < 8; ++i)
+      l2.push_back(i);
+    l1.splice(l1.end(), l2, l2.begin(), ++(++(++(++l2.begin()))));
+    std::thread t([&l1] { l1.clear(); });
+    l2.clear();
+    t.join();
+    EXPECT_EQ(4, live);
+  }
+  EXPECT_EQ(0, live);
+}
+
+TEST(mmap_allocator_test)
+{
+  typedef mystl::mmap_allocator<int> int_alloc;
+  EXPECT_TRUE(mystl::allocator_traits<int_alloc>::has_reallocate::value);
+  EXPECT_TRUE(!mystl::allocator_traits<mystl::allocator<int>>::has_reallocate::value);
+
+  // 小块与大块之间来回调整，内容保持不变
+  int* p = int_alloc::allocate(1000);
+  for (int i = 0; i < 1000; ++i)
+    p[i] = i;
+  p = int_alloc::reallocate(p, 1000, 1 << 20);
+  EXPECT_EQ(999, p[999]);
+  p[(1 << 20) - 1] = 7;
+  p = int_alloc::reallocate(p, 1 << 20, 1 << 22);
+  EXPECT_EQ(999, p[999]);
+  EXPECT_EQ(7, p[(1 << 20) - 1]);
+  p = int_alloc::reallocate(p, 1 << 22, 100);
+  EXPECT_EQ(99, p[99]);
+  int_alloc::deallocate(p, 100);
+
+  // 平凡可复制的元素原地扩容
+  mystl::vector<int, mystl::mmap_allocator<int, true>> v;
+  for (int i = 0; i < (1 << 21); ++i)
+    v.push_back(i);
+  v.insert(v.begin(), v[10]);
+  v.emplace(v.begin() + 1, 5);
+  v.insert(v.begin(), 3, -1);
+  EXPECT_EQ((1u << 21) + 5, v.size());
+  EXPECT_EQ(-1, v[2]);
+  EXPECT_EQ(10, v[3]);
+  EXPECT_EQ(5, v[4]);
+  EXPECT_EQ((1 << 21) - 1, v.back());
+  v.resize(100);
+  v.shrink_to_fit();
+  EXPECT_EQ(100u, v.capacity());
+  v.reserve(1 << 20);
+  EXPECT_EQ(94, v[99]);
+
+  // 不能平凡复制、但可以平凡重定位的元素同样原地扩容
+  mystl::vector<mystl::string, mystl::mmap_allocator<mystl::string>> sv;
+  for (int i = 0; i < 100000; ++i)
+    sv.push_back("abc");
+  EXPECT_EQ(100000u, sv.size());
+  EXPECT_EQ(0, sv.back().compare("abc"));
+}
+
+// 对齐要求超过 max_align_t 的类型
+struct alignas(128) over_aligned
+{
+  int value;
+};
+
+template <class T>
+bool is_aligned(const T* p, size_t align)
+{
+  return reinterpret_cast<uintptr_t>(p) % align == 0;
+}
+
+TEST(aligned_allocator_test)
+{
+  for (size_t n = 1; n < 100; n += 7)
+  {
+    float* p = mystl::aligned_allocator<float>::allocate(n);
+    EXPECT_TRUE(is_aligned(p, 64));
+    mystl::aligned_allocator<float>::deallocate(p, n);
+    char* q = mystl::aligned_allocator<char, 4096>::allocate(n);
+    EXPECT_TRUE(is_aligned(q, 4096));
+    mystl::aligned_allocator<char, 4096>::deallocate(q, n);
+  }
+  EXPECT_EQ(128u, (mystl::aligned_allocator<over_aligned, 16>::alignment));
+
+  // 每次重新分配后依然对齐
+  mystl::aligned_vector<float> v;
+  bool aligned = true;
+  for (int i = 0; i < 10000; ++i)
+  {
+    v.push_back(static_cast<float>(i));
+    aligned = aligned && is_aligned(v.data(), 64);
+  }
+  v.shrink_to_fit();
+  EXPECT_TRUE(aligned && is_aligned(v.data(), 64));
+  mystl::aligned_vector<double, 32> v32(100, 1.0);
+  EXPECT_TRUE(is_aligned(v32.data(), 32));
+
+  // 默认的配置器与 pool_allocator 也要满足类型本身的对齐要求
+  mystl::vector<over_aligned> ov(10);
+  EXPECT_TRUE(is_aligned(ov.data(), 128));
+  mystl::allocator<over_aligned>::deallocate(mystl::allocator<over_aligned>::allocate());
+  over_aligned* po = mystl::pool_allocator<over_aligned>::allocate(3);
+  EXPECT_TRUE(is_aligned(po, 128));
+  mystl::pool_allocator<over_aligned>::deallocate(po, 3);
+  mystl::deque<over_aligned> od(100);
+  aligned = true;
+  for (auto& x : od)
+    aligned = aligned && is_aligned(&x, 128);
+  EXPECT_TRUE(aligned);
+}
+
+TEST(tracking_allocator_test)
+{
+  mystl::allocation_stats stats;
+  typedef mystl::tracking_allocator<int> int_alloc;
+  int_alloc a(&stats);
+  int* p = a.allocate(10);
+  int* q = a.allocate(1000);
+  EXPECT_EQ(4040u, stats.allocated_bytes);
+  EXPECT_EQ(4040u, stats.live_bytes);
+  EXPECT_EQ(2u, stats.allocations);
+  EXPECT_EQ(1u, stats.histogram[mystl::allocation_stats::histogram_index(40)]);
+  EXPECT_EQ(1u, stats.histogram[12]);
+  a.deallocate(q, 1000);
+  EXPECT_EQ(40u, stats.live_bytes);
+  EXPECT_EQ(4040u, stats.peak_bytes);
+  a.deallocate(p, 10);
+  EXPECT_EQ(0u, stats.live_bytes);
+  EXPECT_EQ(2u, stats.deallocations);
+  EXPECT_EQ(6u, mystl::allocation_stats::histogram_index(64));
+  EXPECT_EQ(7u, mystl::allocation_stats::histogram_index(65));
+
+  mystl::allocation_stats other;
+  EXPECT_TRUE(a == mystl::tracking_allocator<double>(a));
+  EXPECT_TRUE(a != int_alloc(&other));
+
+  // 容器析构后全部内存都已回收
+  stats.reset();
+  {
+    mystl::map<int, int, mystl::less<int>,
+      mystl::tracking_allocator<mystl::pair<const int, int>, mystl::pool_allocator<int>>>
+      m{ mystl::tracking_allocator<mystl::pair<const int, int>, mystl::pool_allocator<int>>(&stats) };
+    for (int i = 0; i < 1000; ++i)
+      m[i] = i;
+    EXPECT_TRUE(stats.live_bytes > 1000 * sizeof(mystl::pair<const int, int>));
+  }
+  EXPECT_EQ(0u, stats.live_bytes);
+  EXPECT_EQ(stats.allocations, stats.deallocations);
+}
+
+// 容器通过 tracking_allocator 申请的内存应与 memory_usage 报告的一致
+TEST(memory_usage_test)
+{
+  mystl::allocation_stats stats;
+
+  mystl::vector<int, mystl::tracking_allocator<int>> v{ mystl::tracking_allocator<int>(&stats) };
+  for (int i = 0; i < 100; ++i)
+    v.push_back(i);
+  EXPECT_EQ(100 * sizeof(int), v.memory_usage().payload);
+  EXPECT_EQ((v.capacity() - 100) * sizeof(int), v.memory_usage().overhead);
+  EXPECT_EQ(stats.live_bytes, v.memory_usage().total());
+
+  stats.reset();
+  mystl::deque<int, mystl::tracking_allocator<int>> d{ mystl::tracking_allocator<int>(&stats) };
+  for (int i = 0; i < 10000; ++i)
+  {
+    d.push_back(i);
+    d.push_front(i);
+  }
+  EXPECT_EQ(20000 * sizeof(int), d.memory_usage().payload);
+  EXPECT_EQ(stats.live_bytes, d.memory_usage().total());
+  d.erase(d.begin(), d.begin() + 15000);
+  d.shrink_to_fit();
+  EXPECT_EQ(stats.live_bytes, d.memory_usage().total());
+
+  stats.reset();
+  mystl::list<int, mystl::tracking_allocator<int>> l{ mystl::tracking_allocator<int>(&stats) };
+  for (int i = 0; i < 100; ++i)
+    l.push_back(i);
+  EXPECT_EQ(100 * sizeof(int), l.memory_usage().payload);
+  EXPECT_TRUE(l.memory_usage().overhead >= 100 * 2 * sizeof(void*));
+  EXPECT_EQ(stats.live_bytes, l.memory_usage().total());
+
+  stats.reset();
+  typedef mystl::tracking_allocator<mystl::pair<const int, int>> pair_alloc;
+  mystl::map<int, int, mystl::less<int>, pair_alloc> m{ pair_alloc(&stats) };
+  for (int i = 0; i < 100; ++i)
+    m[i] = i;
+  EXPECT_EQ(100 * sizeof(mystl::pair<const int, int>), m.memory_usage().payload);
+  EXPECT_EQ(stats.live_bytes, m.memory_usage().total());
+
+  stats.reset();
+  mystl::unordered_map<int, int, mystl::hash<int>, mystl::equal_to<int>, pair_alloc>
+    um{ pair_alloc(&stats) };
+  for (int i = 0; i < 100; ++i)
+    um[i] = i;
+  EXPECT_EQ(100 * sizeof(mystl::pair<const int, int>), um.memory_usage().payload);
+  EXPECT_TRUE(um.memory_usage().overhead >= um.bucket_count() * sizeof(void*));
+  EXPECT_EQ(stats.live_bytes, um.memory_usage().total());
+
+  stats.reset();
+  mystl::basic_string<char, mystl::char_traits<char>, mystl::tracking_allocator<char>>
+    s{ mystl::tracking_allocator<char>(&stats) };
+  s.append(100, 'a');
+  EXPECT_EQ(100u, s.memory_usage().payload);
+  EXPECT_EQ(stats.live_bytes, s.memory_usage().total());
+
+  mystl::vector<int> empty;
+  EXPECT_EQ(0u, empty.memory_usage().payload);
+  EXPECT_EQ(empty.capacity() * sizeof(int), empty.memory_usage().overhead);
+}
+
+TEST(growth_policy_test)
+{
+  typedef mystl::growth_policy<3, 2, 16> g15;
+  EXPECT_EQ(16u, g15::next_capacity(0, 1, 1000));
+  EXPECT_EQ(40u, g15::next_capacity(0, 40, 1000));
+  EXPECT_EQ(24u, g15::next_capacity(16, 1, 1000));
+  EXPECT_EQ(30u, g15::next_capacity(16, 14, 1000));
+  EXPECT_EQ(1000u, g15::next_capacity(900, 1, 1000));
+  EXPECT_EQ(32u, mystl::double_growth::next_capacity(16, 1, 1000));
+  EXPECT_EQ(20u, mystl::compact_growth::next_capacity(16, 1, 1000));
+  EXPECT_EQ(2u, mystl::compact_growth::next_capacity(1, 1, 1000));
+  size_t huge = static_cast<size_t>(-1);
+  EXPECT_EQ(huge, mystl::double_growth::next_capacity(huge / 2 + 1, 1, huge));
+
+  // 容器按策略增长，每次扩容后的容量不小于策略给出的值
+  mystl::vector<int, mystl::allocator<int>, mystl::double_growth> v;
+  size_t reallocs = 0;
+  for (int i = 0; i < 10000; ++i)
+  {
+    const size_t old_cap = v.capacity();
+    v.push_back(i);
+    if (v.capacity() != old_cap)
+    {
+      ++reallocs;
+      EXPECT_TRUE(v.capacity() >= old_cap * 2);
+    }
+  }
+  EXPECT_TRUE(reallocs <= 10);
+  mystl::vector<int, mystl::allocator<int>, mystl::compact_growth> cv(100, 1);
+  const size_t cv_cap = cv.capacity();
+  while (cv.capacity() == cv_cap)
+    cv.push_back(1);
+  EXPECT_TRUE(cv.capacity() >= cv_cap * 5 / 4 && cv.capacity() < cv_cap * 3 / 2);
+
+  typedef mystl::basic_string<char, mystl::char_traits<char>,
+    mystl::allocator<char>, mystl::growth_policy<2, 1, 8>> small_string;
+  small_string s;
+  EXPECT_TRUE(s.capacity() >= 8 && s.capacity() < 32);
+  s.append(100, 'a');
+  EXPECT_EQ(100u, s.size());
+  EXPECT_TRUE(s.capacity() >= 100);
+}
+
+// 配置器多给出的空间作为容量使用，回收时按实际的容量归还
+TEST(allocate_at_least_test)
+{
+  typedef mystl::malloc_allocator<int> int_alloc;
+  for (size_t n = 1; n < 200; n += 13)
+  {
+    auto r = int_alloc::allocate_at_least(n);
+    EXPECT_TRUE(r.count >= n);
+    for (size_t i = 0; i < r.count; ++i)
+      r.ptr[i] = static_cast<int>(i);
+    int_alloc::deallocate(r.ptr, r.count);
+  }
+  mystl::vector<int, int_alloc> mv;
+  for (int i = 0; i < 1000; ++i)
+    mv.push_back(i);
+  EXPECT_EQ(999, mv.back());
+  EXPECT_TRUE(mv.capacity() >= mv.size());
+
+  // ::operator new 可能被替换，mystl::allocator 不查询实际的大小
+  auto ar = mystl::allocator<int>::allocate_at_least(5);
+  EXPECT_EQ(5u, ar.count);
+  mystl::allocator<int>::deallocate(ar.ptr, ar.count);
+
+  // 没有 allocate_at_least 的配置器得到的就是请求的个数
+  mystl::pool_allocator<int> pa;
+  auto r = mystl::allocator_traits<mystl::pool_allocator<int>>::allocate_at_least(pa, 3);
+  EXPECT_EQ(3u, r.count);
+  pa.deallocate(r.ptr, r.count);
+
+  mystl::allocation_stats stats;
+  {
+    mystl::vector<char, mystl::tracking_allocator<char>> v{ mystl::tracking_allocator<char>(&stats) };
+    for (int i = 0; i < 1000; ++i)
+      v.push_back('a');
+    EXPECT_EQ(stats.live_bytes, v.capacity());
+    mystl::basic_string<char, mystl::char_traits<char>, mystl::tracking_allocator<char>>
+      s{ mystl::tracking_allocator<char>(&stats) };
+    s.append(1000, 'a');
+    EXPECT_EQ(stats.live_bytes, v.capacity() + s.capacity());
+  }
+  EXPECT_EQ(0u, stats.live_bytes);
+}
+
+// 用 push_back 把 vector 增长到 count 个元素
+template <class Alloc, class Growth = mystl::vector_growth>
+void vector_growth_test(size_t count)
+{
+  char buf[10];
+  clock_t start = clock();
+  {
+    mystl::vector<size_t, Alloc, Growth> v;
+    for (size_t i = 0; i < count; ++i)
+      v.push_back(i);
+  }
+  clock_t end = clock();
+  int n = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+  std::snprintf(buf, sizeof(buf), "%d", n);
+  std::string t = buf;
+  t += "ms    |";
+  std::cout << std::setw(WIDE) << t;
+}
+
+// 反复分配、回收单个节点大小的内存
+template <class Alloc>
+void alloc_churn_test(size_t count)
+{
+  typedef typename Alloc::value_type node;
+  char buf[10];
+  std::vector<node*> live(1024);
+  clock_t start = clock();
+  for (size_t i = 0; i < count; ++i)
+  {
+    const size_t k = i & 1023;
+    if (i >= 1024)
+      Alloc::deallocate(live[k]);
+    live[k] = Alloc::allocate();
+  }
+  for (size_t k = 0; k < 1024 && k < count; ++k)
+    Alloc::deallocate(live[k]);
+  clock_t end = clock();
+  int n = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+  std::snprintf(buf, sizeof(buf), "%d", n);
+  std::string t = buf;
+  t += "ms    |";
+  std::cout << std::setw(WIDE) << t;
+}
+
+void alloc_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------------ Run container test : alloc -----------------]" << std::endl;
+#if PERFORMANCE_TEST_ON
+  struct node { void* link[2]; int value; };
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|   allocate node     |";
+#if LARGER_TEST_DATA_ON
+  TEST_LEN(SCALE_LL(LEN1), SCALE_LL(LEN2), SCALE_LL(LEN3), WIDE);
+  std::cout << "|      allocator      |";
+  alloc_churn_test<mystl::allocator<node>>(SCALE_LL(LEN1));
+  alloc_churn_test<mystl::allocator<node>>(SCALE_LL(LEN2));
+  alloc_churn_test<mystl::allocator<node>>(SCALE_LL(LEN3));
+  std::cout << "\n|    pool_allocator   |";
+  alloc_churn_test<mystl::pool_allocator<node>>(SCALE_LL(LEN1));
+  alloc_churn_test<mystl::pool_allocator<node>>(SCALE_LL(LEN2));
+  alloc_churn_test<mystl::pool_allocator<node>>(SCALE_LL(LEN3));
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|    vector growth    |";
+  TEST_LEN(SCALE_LLL(LEN1), SCALE_LLL(LEN2), SCALE_LLL(LEN3), WIDE);
+  std::cout << "|      allocator      |";
+  vector_growth_test<mystl::allocator<size_t>>(SCALE_LLL(LEN1));
+  vector_growth_test<mystl::allocator<size_t>>(SCALE_LLL(LEN2));
+  vector_growth_test<mystl::allocator<size_t>>(SCALE_LLL(LEN3));
+  std::cout << "\n|    mmap_allocator   |";
+  vector_growth_test<mystl::mmap_allocator<size_t>>(SCALE_LLL(LEN1));
+  vector_growth_test<mystl::mmap_allocator<size_t>>(SCALE_LLL(LEN2));
+  vector_growth_test<mystl::mmap_allocator<size_t>>(SCALE_LLL(LEN3));
+  std::cout << "\n|    double_growth    |";
+  vector_growth_test<mystl::allocator<size_t>, mystl::double_growth>(SCALE_LLL(LEN1));
+  vector_growth_test<mystl::allocator<size_t>, mystl::double_growth>(SCALE_LLL(LEN2));
+  vector_growth_test<mystl::allocator<size_t>, mystl::double_growth>(SCALE_LLL(LEN3));
+  std::cout << "\n|   compact_growth    |";
+  vector_growth_test<mystl::allocator<size_t>, mystl::compact_growth>(SCALE_LLL(LEN1));
+  vector_growth_test<mystl::allocator<size_t>, mystl::compact_growth>(SCALE_LLL(LEN2));
+  vector_growth_test<mystl::allocator<size_t>, mystl::compact_growth>(SCALE_LLL(LEN3));
+#else
+  TEST_LEN(SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3), WIDE);
+  std::cout << "|      allocator      |";
+  alloc_churn_test<mystl::allocator<node>>(SCALE_L(LEN1));
+  alloc_churn_test<mystl::allocator<node>>(SCALE_L(LEN2));
+  alloc_churn_test<mystl::allocator<node>>(SCALE_L(LEN3));
+  std::cout << "\n|    pool_allocator   |";
+  alloc_churn_test<mystl::pool_allocator<node>>(SCALE_L(LEN1));
+  alloc_churn_test<mystl::pool_allocator<node>>(SCALE_L(LEN2));
+  alloc_churn_test<mystl::pool_allocator<node>>(SCALE_L(LEN3));
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|    vector growth    |";
+  TEST_LEN(SCALE_LL(LEN1), SCALE_LL(LEN2), SCALE_LL(LEN3), WIDE);
+  std::cout << "|      allocator      |";
+  vector_growth_test<mystl::allocator<size_t>>(SCALE_LL(LEN1));
+  vector_growth_test<mystl::allocator<size_t>>(SCALE_LL(LEN2));
+  vector_growth_test<mystl::allocator<size_t>>(SCALE_LL(LEN3));
+  std::cout << "\n|    mmap_allocator   |";
+  vector_growth_test<mystl::mmap_allocator<size_t>>(SCALE_LL(LEN1));
+  vector_growth_test<mystl::mmap_allocator<size_t>>(SCALE_LL(LEN2));
+  vector_growth_test<mystl::mmap_allocator<size_t>>(SCALE_LL(LEN3));
+  std::cout << "\n|    double_growth    |";
+  vector_growth_test<mystl::allocator<size_t>, mystl::double_growth>(SCALE_LL(LEN1));
+  vector_growth_test<mystl::allocator<size_t>, mystl::double_growth>(SCALE_LL(LEN2));
+  vector_growth_test<mystl::allocator<size_t>, mystl::double_growth>(SCALE_LL(LEN3));
+  std::cout << "\n|   compact_growth    |";
+  vector_growth_test<mystl::allocator<size_t>, mystl::compact_growth>(SCALE_LL(LEN1));
+  vector_growth_test<mystl::allocator<size_t>, mystl::compact_growth>(SCALE_LL(LEN2));
+  vector_growth_test<mystl::allocator<size_t>, mystl::compact_growth>(SCALE_LL(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------------------ End container test : alloc -----------------]" << std::endl;
+}
+
+} // namespace alloc_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_ALLOC_TEST_H_
+
@@ -0,0 +1,367 @@
+#ifndef MYTINYSTL_CIRCULAR_BUFFER_TEST_H_
+#define MYTINYSTL_CIRCULAR_BUFFER_TEST_H_
+
+// circular_buffer test : 测试 circular_buffer 的接口，以及作为队列、滑动窗口的性能
+
+#include <cstdlib>
+#include <deque>
+#include <stdexcept>
+
+#include "../MyTinySTL/astring.h"
+#include "../MyTinySTL/circular_buffer.h"
+#include "../MyTinySTL/deque.h"
+#include "../MyTinySTL/queue.h"
+#include "../MyTinySTL/stack.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace circular_buffer_test
+{
+
+typedef mystl::circular_buffer<int> ring;
+
+template <class Ring, class Ref>
+bool same(const Ring& r, const Ref& v)
+{
+  if (r.size() != v.size())
+    return false;
+  for (size_t i = 0; i < v.size(); ++i)
+  {
+    if (r[i] != v[i] || *(r.begin() + i) != v[i])
+      return false;
+  }
+  // 反向遍历也要一致
+  size_t i = v.size();
+  for (auto it = r.rbegin(); it != r.rend(); ++it)
+  {
+    if (*it != v[--i])
+      return false;
+  }
+  return true;
+}
+
+TEST(circular_buffer_modify_test)
+{
+  int a[] = { 1,2,3,4,5 };
+  ring r1;
+  ring r2(4, 7);
+  ring r3(a, a + 5);
+  ring r4{ 1,2,3 };
+  EXPECT_TRUE(r1.empty());
+  EXPECT_EQ(4, r2.size());
+  EXPECT_TRUE(r2.full());
+  EXPECT_EQ(5, r3.back());
+  EXPECT_EQ(3, r4.capacity());
+
+  // 与 std::deque 对照，随机地在两端插入、弹出
+  std::deque<int> ref;
+  std::srand(11);
+  bool ok = true;
+  for (int step = 0; step < 5000; ++step)
+  {
+    const int op = std::rand() % 6;
+    if (op < 2 || ref.empty())
+    {
+      r1.push_back(step);
+      ref.push_back(step);
+    }
+    else if (op < 4)
+    {
+      r1.emplace_front(step);
+      ref.push_front(step);
+    }
+    else if (op == 4)
+    {
+      r1.pop_front();
+      ref.pop_front();
+    }
+    else
+    {
+      r1.pop_back();
+      ref.pop_back();
+    }
+    ok = ok && r1.size() == ref.size() && (ref.empty() ||
+      (r1.front() == ref.front() && r1.back() == ref.back()));
+  }
+  EXPECT_TRUE(ok);
+  EXPECT_TRUE(same(r1, ref));
+
+  // 回绕之后扩容，元素的顺序不变
+  ring r5;
+  r5.reserve(4);
+  r5.push_back(1);
+  r5.push_back(2);
+  r5.push_back(3);
+  r5.pop_front();
+  r5.pop_front();
+  r5.push_back(4);
+  r5.push_back(5);
+  r5.push_back(6);
+  EXPECT_EQ(4, r5.capacity());
+  EXPECT_EQ(2, r5.array_two().second);
+  r5.push_front(r5.back());
+  mystl::vector<int> expect{ 6,3,4,5,6 };
+  EXPECT_TRUE(same(r5, expect));
+  EXPECT_TRUE(r5.capacity() > 4);
+
+  r5.pop_front();
+  r5.push_back(7);
+  expect = { 3,4,5,6,7 };
+  EXPECT_TRUE(same(r5, expect));
+  EXPECT_EQ(4, r5.at(1));
+  bool thrown = false;
+  try { r5.at(5); }
+  catch (const std::out_of_range&) { thrown = true; }
+  EXPECT_TRUE(thrown);
+
+  ring r6(r5);
+  EXPECT_TRUE(r6 == r5);
+  EXPECT_EQ(r5.capacity(), r6.capacity());
+  r6.back() = 8;
+  EXPECT_TRUE(r5 < r6);
+  r6 = { 9,9 };
+  EXPECT_EQ(2, r6.size());
+  r6.swap(r5);
+  EXPECT_EQ(5, r6.size());
+  ring r7(mystl::move(r6));
+  EXPECT_TRUE(r6.empty());
+  EXPECT_EQ(0, r6.capacity());
+  r6 = mystl::move(r7);
+  EXPECT_TRUE(same(r6, expect));
+  r6.clear();
+  EXPECT_TRUE(r6.empty());
+  EXPECT_TRUE(r6.begin() == r6.end());
+}
+
+TEST(circular_buffer_policy_test)
+{
+  // 覆盖最旧的元素：保留最近的 4 个
+  ring w(mystl::circular_buffer_policy::overwrite, 4);
+  EXPECT_EQ(4, w.capacity());
+  for (int i = 0; i < 10; ++i)
+    w.push_back(i);
+  mystl::vector<int> expect{ 6,7,8,9 };
+  EXPECT_TRUE(same(w, expect));
+  EXPECT_EQ(4, w.capacity());
+  // 在头部插入时覆盖尾部
+  w.push_front(5);
+  expect = { 5,6,7,8 };
+  EXPECT_TRUE(same(w, expect));
+  // 插入的值引用将被覆盖的元素
+  w.push_back(w.front());
+  expect = { 6,7,8,5 };
+  EXPECT_TRUE(same(w, expect));
+  EXPECT_FALSE(w.try_push_back(1));
+  w.pop_front();
+  EXPECT_TRUE(w.try_push_back(1));
+  EXPECT_TRUE(w.full());
+
+  // 缩小容量时丢弃最旧的元素
+  w.set_capacity(2);
+  expect = { 5,1 };
+  EXPECT_TRUE(same(w, expect));
+
+  // 定长：已满时抛出异常，容器保持不变
+  ring f(mystl::circular_buffer_policy::fixed, 3);
+  f.push_back(1);
+  f.push_back(2);
+  f.push_front(0);
+  bool thrown = false;
+  try { f.push_back(3); }
+  catch (const std::length_error&) { thrown = true; }
+  EXPECT_TRUE(thrown);
+  thrown = false;
+  try { f.emplace_front(3); }
+  catch (const std::length_error&) { thrown = true; }
+  EXPECT_TRUE(thrown);
+  expect = { 0,1,2 };
+  EXPECT_TRUE(same(f, expect));
+  EXPECT_FALSE(f.try_emplace_front(3));
+  f.set_policy(mystl::circular_buffer_policy::grow);
+  f.push_back(3);
+  EXPECT_EQ(4, f.size());
+
+  // 容量为 0 时覆盖模式丢弃新元素
+  ring z(mystl::circular_buffer_policy::overwrite, 0);
+  z.push_back(1);
+  EXPECT_TRUE(z.empty());
+}
+
+TEST(circular_buffer_segment_test)
+{
+  // 元素回绕在缓冲区的两端
+  ring r(mystl::circular_buffer_policy::overwrite, 8);
+  for (int i = 0; i < 13; ++i)
+    r.push_back(i);
+  EXPECT_EQ(3, r.array_one().second);
+  EXPECT_EQ(5, r.array_two().second);
+  EXPECT_EQ(5, *r.array_one().first);
+  EXPECT_EQ(8, *r.array_two().first);
+
+  const int n = static_cast<int>(r.size());
+  bool ok = true;
+  for (int i = 0; i <= n; ++i)
+  {
+    for (int j = i; j <= n; ++j)
+    {
+      int out[8] = {};
+      int* e = mystl::copy(r.begin() + i, r.begin() + j, out);
+      ok = ok && e == out + (j - i);
+      for (int k = i; k < j; ++k)
+        ok = ok && out[k - i] == r[k];
+      for (int k = i; k < j; ++k)
+        ok = ok && mystl::find(r.cbegin() + i, r.cbegin() + j, r[k]) == r.cbegin() + k;
+      ok = ok && mystl::find(r.begin() + i, r.begin() + j, 100) == r.begin() + j;
+
+      // 原生指针输入，分段输出
+      ring t(r);
+      auto it = mystl::copy(out, e, t.begin() + (n - (j - i)));
+      ok = ok && it == t.end();
+      for (int k = i; k < j; ++k)
+        ok = ok && t[n - j + k] == r[k];
+    }
+  }
+  EXPECT_TRUE(ok);
+
+  int sum = 0;
+  mystl::for_each(r.begin(), r.end(), [&](int x) { sum += x; });
+  EXPECT_EQ(5 + 6 + 7 + 8 + 9 + 10 + 11 + 12, sum);
+  mystl::sort(r.begin(), r.end(), mystl::greater<int>());
+  EXPECT_EQ(12, r.front());
+  EXPECT_EQ(5, r.back());
+
+  // linearize 之后只有一段
+  const int* p = r.linearize();
+  EXPECT_EQ(0, r.array_two().second);
+  EXPECT_EQ(12, p[0]);
+  EXPECT_EQ(5, p[7]);
+}
+
+TEST(circular_buffer_adapter_test)
+{
+  mystl::queue<int, ring> q;
+  for (int i = 0; i < 100; ++i)
+  {
+    q.push(i);
+    if (i % 3 == 0)
+      q.pop();
+  }
+  EXPECT_EQ(66, q.size());
+  EXPECT_EQ(34, q.front());
+  EXPECT_EQ(99, q.back());
+  mystl::queue<int, ring> q2(q);
+  EXPECT_TRUE(q2 == q);
+
+  mystl::stack<int, ring> s;
+  for (int i = 0; i < 10; ++i)
+    s.push(i);
+  s.pop();
+  EXPECT_EQ(8, s.top());
+  EXPECT_EQ(9, s.size());
+}
+
+TEST(circular_buffer_nontrivial_test)
+{
+  mystl::circular_buffer<mystl::string> r(mystl::circular_buffer_policy::overwrite, 3);
+  for (int i = 0; i < 5; ++i)
+    r.emplace_back(10, static_cast<char>('a' + i));
+  EXPECT_EQ(0, r.front().compare("cccccccccc"));
+  r.emplace_front("front");
+  EXPECT_EQ(0, r.back().compare("dddddddddd"));
+  r.set_policy(mystl::circular_buffer_policy::grow);
+  r.push_back(r.front());
+  r.emplace_front(3, 'x');
+  EXPECT_EQ(5, r.size());
+  EXPECT_EQ(0, r[0].compare("xxx"));
+  EXPECT_EQ(0, r[1].compare("front"));
+  EXPECT_EQ(0, r[4].compare("front"));
+  mystl::circular_buffer<mystl::string> c(r);
+  EXPECT_TRUE(c == r);
+  c.set_capacity(2);
+  EXPECT_EQ(0, c[0].compare("dddddddddd"));
+  r.pop_back();
+  r.pop_front();
+  r.shrink_to_fit();
+  EXPECT_EQ(3, r.capacity());
+  EXPECT_EQ(3 * sizeof(mystl::string), r.memory_usage().payload);
+}
+
+// 保持 window 个元素的队列，每次在尾部插入、在头部弹出
+template <class Queue>
+void sliding_window(size_t count, size_t window)
+{
+  Queue q;
+  long long sum = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    q.push(static_cast<int>(i));
+    if (q.size() > window)
+    {
+      sum += q.front();
+      q.pop();
+    }
+  }
+  volatile long long sink = sum;
+  (void)sink;
+}
+
+#define CIRCULAR_BUFFER_TEST(queue, count) do {           \
+  char buf[10];                                           \
+  clock_t start = clock();                                \
+  sliding_window<queue>(count, 1000);                     \
+  clock_t end = clock();                                  \
+  int n = static_cast<int>(static_cast<double>(end - start) \
+      / CLOCKS_PER_SEC * 1000);                           \
+  std::snprintf(buf, sizeof(buf), "%d", n);               \
+  std::string t = buf;                                    \
+  t += "ms    |";                                         \
+  std::cout << std::setw(WIDE) << t;                      \
+} while(0)
+
+typedef mystl::queue<int, mystl::deque<int>> deque_queue;
+typedef mystl::queue<int, ring>              ring_queue;
+
+void circular_buffer_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------- Run container test : circular_buffer ------------]" << std::endl;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "| queue, 1000 window  |";
+#if LARGER_TEST_DATA_ON
+  TEST_LEN(SCALE_LL(LEN1), SCALE_LL(LEN2), SCALE_LL(LEN3), WIDE);
+  std::cout << "|    queue<deque>     |";
+  CIRCULAR_BUFFER_TEST(deque_queue, SCALE_LL(LEN1));
+  CIRCULAR_BUFFER_TEST(deque_queue, SCALE_LL(LEN2));
+  CIRCULAR_BUFFER_TEST(deque_queue, SCALE_LL(LEN3));
+  std::cout << "\n|  queue<ring_buffer> |";
+  CIRCULAR_BUFFER_TEST(ring_queue, SCALE_LL(LEN1));
+  CIRCULAR_BUFFER_TEST(ring_queue, SCALE_LL(LEN2));
+  CIRCULAR_BUFFER_TEST(ring_queue, SCALE_LL(LEN3));
+#else
+  TEST_LEN(SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3), WIDE);
+  std::cout << "|    queue<deque>     |";
+  CIRCULAR_BUFFER_TEST(deque_queue, SCALE_L(LEN1));
+  CIRCULAR_BUFFER_TEST(deque_queue, SCALE_L(LEN2));
+  CIRCULAR_BUFFER_TEST(deque_queue, SCALE_L(LEN3));
+  std::cout << "\n|  queue<ring_buffer> |";
+  CIRCULAR_BUFFER_TEST(ring_queue, SCALE_L(LEN1));
+  CIRCULAR_BUFFER_TEST(ring_queue, SCALE_L(LEN2));
+  CIRCULAR_BUFFER_TEST(ring_queue, SCALE_L(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------------- End container test : circular_buffer ------------]" << std::endl;
+}
+
+} // namespace circular_buffer_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_CIRCULAR_BUFFER_TEST_H_
@@ -1,11 +1,17 @@
 ﻿#ifndef MYTINYSTL_DEQUE_TEST_H_
 #define MYTINYSTL_DEQUE_TEST_H_
 
-// deque test : 测试 deque 的接口和 push_front/push_back 的性能
+// deque test : 测试 deque 的接口和 push_front/push_back/sort/copy/FIFO 的性能
 
+#include <algorithm>
 #include <deque>
+#include <vector>
 
+#include "../MyTinySTL/algorithm.h"
+#include "../MyTinySTL/astring.h"
 #include "../MyTinySTL/deque.h"
+#include "../MyTinySTL/tracking_allocator.h"
+#include "../MyTinySTL/vector.h"
 #include "test.h"
 
 namespace mystl
@@ -15,6 +21,368 @@ namespace test
 namespace deque_test
 {
 
+TEST(deque_move_assign_leak_test)
+{
+  mystl::deque<int> warm(10, 1);
+  const size_t before = heap_in_use();
+  for (int i = 0; i < 1000; ++i)
+  {
+    mystl::deque<int> d(10, 1);
+    mystl::deque<int> e(20, 2);
+    d = std::move(e);
+    EXPECT_EQ(20, d.size());
+  }
+  EXPECT_TRUE(heap_in_use() <= before + 4096);
+}
+
+TEST(deque_clear_release_test)
+{
+  mystl::deque<int> d(10, 1);
+  const size_t before = heap_in_use();
+  for (int i = 0; i < 100000; ++i)
+    d.push_back(i);
+  d.clear();
+  EXPECT_TRUE(d.empty());
+  EXPECT_TRUE(heap_in_use() <= before + 4096);
+}
+
+TEST(deque_erase_across_buffers_test)
+{
+  live_counted::count() = 0;
+  {
+    mystl::deque<live_counted> d;
+    for (int i = 0; i < 3000; ++i)
+      d.push_back(live_counted(i));
+    d.erase(d.begin() + 1500, d.end());
+    EXPECT_EQ(1500, d.size());
+    EXPECT_EQ(1500, live_counted::count());
+    d.erase(d.begin(), d.begin() + 1400);
+    EXPECT_EQ(100, d.size());
+    EXPECT_EQ(100, live_counted::count());
+    EXPECT_EQ(1400, d.front().value);
+  }
+  EXPECT_EQ(0, live_counted::count());
+}
+
+TEST(deque_reuse_spare_buffer_test)
+{
+  mystl::deque<int> warm(10, 1);
+  const size_t before = heap_in_use();
+  for (int i = 0; i < 100; ++i)
+  {
+    mystl::deque<int> d;
+    for (int j = 0; j < 3000; ++j)
+      d.push_back(j);
+    d.erase(d.begin() + 500, d.end());  // 尾部留下空闲的缓冲区
+    for (int j = 0; j < 2500; ++j)
+      d.push_back(j);
+    d.erase(d.begin(), d.begin() + 2500);  // 头部留下空闲的缓冲区
+    for (int j = 0; j < 2500; ++j)
+      d.push_front(j);
+    for (int j = 0; j < 50000; ++j)  // map 重新配置
+      d.push_back(j);
+  }
+  EXPECT_TRUE(heap_in_use() <= before + 4096);
+}
+
+struct s12 { int a, b, c; };
+struct s24 { double a, b, c; };
+struct s300 { char a[300]; };
+
+TEST(deque_buffer_size_test)
+{
+  // 缺省的缓冲区大小为 2 的幂，且不超过 4096 字节
+  EXPECT_EQ(1024, mystl::deque_buf_size<int>::value);
+  EXPECT_EQ(256, mystl::deque_buf_size<s12>::value);
+  EXPECT_EQ(128, mystl::deque_buf_size<s24>::value);
+  EXPECT_EQ(16, mystl::deque_buf_size<s300>::value);
+  EXPECT_EQ(256, (mystl::deque<s12>::buffer_size));
+  EXPECT_EQ(3, (mystl::deque<int, mystl::allocator<int>, 3>::buffer_size));
+
+  // 指定不是 2 的幂的缓冲区大小，与 vector 对照
+  mystl::deque<int, mystl::allocator<int>, 3> d;
+  std::vector<int> v;
+  for (int i = 0; i < 50; ++i)
+  {
+    if (i % 3 == 0)
+    {
+      d.push_front(i);
+      v.insert(v.begin(), i);
+    }
+    else
+    {
+      d.push_back(i);
+      v.push_back(i);
+    }
+  }
+  d.insert(d.begin() + 7, 4, -1);
+  v.insert(v.begin() + 7, 4, -1);
+  d.erase(d.begin() + 20, d.begin() + 25);
+  v.erase(v.begin() + 20, v.begin() + 25);
+  EXPECT_EQ(v.size(), d.size());
+  bool same = true;
+  for (size_t i = 0; i < v.size(); ++i)
+    same = same && d[i] == v[i] && *(d.begin() + i) == v[i] && *(d.end() - (v.size() - i)) == v[i];
+  EXPECT_TRUE(same);
+
+  // 跨越多个缓冲区向前、向后移动迭代器
+  const int n = static_cast<int>(d.size());
+  bool moves = true;
+  for (int i = 0; i < n; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      auto it = d.begin() + i;
+      it += j - i;
+      moves = moves && *it == v[j] && (it - d.begin()) == j && (d.begin() + i) - it == i - j;
+    }
+  }
+  EXPECT_TRUE(moves);
+
+  mystl::sort(d.begin(), d.end());
+  std::sort(v.begin(), v.end());
+  EXPECT_TRUE(std::equal(v.begin(), v.end(), d.begin()));
+}
+
+TEST(deque_segmented_algo_test)
+{
+  // 每个缓冲区 3 个元素，区间的两端落在缓冲区的各个位置
+  typedef mystl::deque<int, mystl::allocator<int>, 3> small_deque;
+  small_deque d;
+  for (int i = 0; i < 20; ++i)
+    d.push_back(i);
+  d.push_front(-1);
+  const int n = static_cast<int>(d.size());
+  bool ok = true;
+  for (int i = 0; i <= n; ++i)
+  {
+    for (int j = i; j <= n; ++j)
+    {
+      // 分段输入，原生指针输出
+      int out[32] = {};
+      int* e = mystl::copy(d.begin() + i, d.begin() + j, out);
+      ok = ok && e == out + (j - i);
+      for (int k = i; k < j; ++k)
+        ok = ok && out[k - i] == d[k];
+
+      // 原生指针输入，分段输出
+      small_deque t(static_cast<size_t>(n), 0);
+      auto r = mystl::copy(out, e, t.begin() + (n - (j - i)));
+      ok = ok && r == t.end();
+      for (int k = i; k < j; ++k)
+        ok = ok && t[n - j + k] == d[k];
+
+      // 两端都是分段迭代器
+      small_deque u(static_cast<size_t>(n), 0);
+      r = mystl::move(d.begin() + i, d.begin() + j, u.begin() + 1);
+      ok = ok && (r - u.begin()) == j - i + 1 && mystl::equal(u.begin() + 1, r, d.begin() + i);
+
+      // 查找每个位置上的值，以及不存在的值
+      for (int k = i; k < j; ++k)
+        ok = ok && mystl::find(d.begin() + i, d.begin() + j, d[k]) == d.begin() + k;
+      ok = ok && mystl::find(d.begin() + i, d.begin() + j, 100) == d.begin() + j;
+
+      int sum = 0, expect = 0;
+      mystl::for_each(d.cbegin() + i, d.cbegin() + j, [&](int x) { sum += x; });
+      for (int k = i; k < j; ++k)
+        expect += d[k];
+      ok = ok && sum == expect;
+
+      small_deque f(d);
+      mystl::fill(f.begin() + i, f.begin() + j, 7);
+      for (int k = 0; k < n; ++k)
+        ok = ok && f[k] == (k >= i && k < j ? 7 : d[k]);
+    }
+  }
+  EXPECT_TRUE(ok);
+
+  // 在同一个 deque 内整体左移，与 erase 的用法一致
+  small_deque s(d);
+  auto last = mystl::copy(s.begin() + 5, s.end(), s.begin() + 1);
+  EXPECT_TRUE(last == s.end() - 4);
+  EXPECT_EQ(4, s[1]);
+  EXPECT_EQ(19, *(last - 1));
+
+  // 单字节类型的 fill 走 memset，非平凡类型逐个赋值
+  mystl::deque<char, mystl::allocator<char>, 4> c(10, 'a');
+  mystl::fill(c.begin() + 1, c.end() - 1, 'b');
+  EXPECT_EQ('a', c.front());
+  EXPECT_EQ('b', c[1]);
+  EXPECT_EQ('b', c[8]);
+  EXPECT_EQ('a', c.back());
+  mystl::deque<mystl::string, mystl::allocator<mystl::string>, 2> sd(5, mystl::string("x"));
+  mystl::vector<mystl::string> sv(5);
+  mystl::copy(sd.begin(), sd.end(), sv.begin());
+  EXPECT_EQ(0, sv[4].compare("x"));
+  mystl::fill(sd.begin() + 1, sd.end(), mystl::string("yy"));
+  EXPECT_EQ(0, sd[0].compare("x"));
+  EXPECT_EQ(0, sd[4].compare("yy"));
+}
+
+TEST(deque_spare_buffer_test)
+{
+  typedef mystl::tracking_allocator<int> alloc_type;
+  typedef mystl::deque<int, alloc_type, 4> small_deque;
+  mystl::allocation_stats stats;
+
+  // 作为 FIFO 队列使用，稳定后不再申请内存
+  {
+    small_deque q{ alloc_type(&stats) };
+    for (int i = 0; i < 10; ++i)
+      q.push_back(i);
+    int head = 0;
+    for (int i = 10; i < 1000; ++i)
+    {
+      q.push_back(i);
+      EXPECT_EQ(head++, q.front());
+      q.pop_front();
+    }
+    const size_t allocations = stats.allocations;
+    bool ok = true;
+    for (int i = 1000; i < 20000; ++i)
+    {
+      q.push_back(i);
+      ok = ok && q.front() == head++;
+      q.pop_front();
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(allocations, stats.allocations);
+    EXPECT_EQ(10, q.size());
+    EXPECT_EQ(19999, q.back());
+    EXPECT_EQ(stats.live_bytes, q.memory_usage().total());
+
+    // 在缓冲区边界来回
+    for (int k = 0; k < 100; ++k)
+    {
+      q.push_back(k);
+      q.push_back(k);
+      q.pop_back();
+      q.pop_back();
+      q.push_front(k);
+      q.pop_front();
+    }
+    EXPECT_EQ(allocations, stats.allocations);
+    q.shrink_to_fit();
+    EXPECT_EQ(stats.live_bytes, q.memory_usage().total());
+  }
+  EXPECT_EQ(0, stats.live_bytes);
+
+  // 预留之后，头尾插入都不再申请内存，另一端的预留在 map 重新分配时也会保留
+  stats.reset();
+  {
+    small_deque d{ alloc_type(&stats) };
+    d.reserve_front(100);
+    d.reserve_back(300);
+    const size_t allocations = stats.allocations;
+    for (int i = 0; i < 100; ++i)
+      d.push_front(-i);
+    for (int i = 0; i < 300; ++i)
+      d.push_back(i);
+    EXPECT_EQ(allocations, stats.allocations);
+    EXPECT_EQ(400, d.size());
+    EXPECT_EQ(-99, d.front());
+    EXPECT_EQ(299, d.back());
+    bool ok = true;
+    for (int i = 0; i < 400; ++i)
+      ok = ok && d[i] == (i < 100 ? i - 99 : i - 100);
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(stats.live_bytes, d.memory_usage().total());
+
+    small_deque e(mystl::move(d));
+    e.clear();
+    EXPECT_EQ(stats.live_bytes, e.memory_usage().total());
+  }
+  EXPECT_EQ(0, stats.live_bytes);
+}
+
+#define DEQUE_SORT_DO_TEST(mode, count) do {                 \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  mode::deque<int> d;                                        \
+  char buf[10];                                              \
+  for (size_t i = 0; i < count; ++i)                         \
+    d.push_back(rand());                                     \
+  start = clock();                                           \
+  mode::sort(d.begin(), d.end());                            \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define DEQUE_SORT_TEST(len1, len2, len3)                    \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|         std         |";                    \
+  DEQUE_SORT_DO_TEST(std, len1);                             \
+  DEQUE_SORT_DO_TEST(std, len2);                             \
+  DEQUE_SORT_DO_TEST(std, len3);                             \
+  std::cout << "\n|        mystl        |";                  \
+  DEQUE_SORT_DO_TEST(mystl, len1);                           \
+  DEQUE_SORT_DO_TEST(mystl, len2);                           \
+  DEQUE_SORT_DO_TEST(mystl, len3);
+
+// 把 count 个元素的 deque 整体拷贝到 vector
+#define DEQUE_COPY_DO_TEST(mode, count) do {                 \
+  clock_t start, end;                                        \
+  mode::deque<int> d(count, 1);                              \
+  mode::vector<int> v(count);                                \
+  char buf[10];                                              \
+  start = clock();                                           \
+  mode::copy(d.begin(), d.end(), v.begin());                 \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define DEQUE_COPY_TEST(len1, len2, len3)                    \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|         std         |";                    \
+  DEQUE_COPY_DO_TEST(std, len1);                             \
+  DEQUE_COPY_DO_TEST(std, len2);                             \
+  DEQUE_COPY_DO_TEST(std, len3);                             \
+  std::cout << "\n|        mystl        |";                  \
+  DEQUE_COPY_DO_TEST(mystl, len1);                           \
+  DEQUE_COPY_DO_TEST(mystl, len2);                           \
+  DEQUE_COPY_DO_TEST(mystl, len3);
+
+// 作为 FIFO 队列，保持 1000 个元素，每次在尾部插入、在头部弹出
+#define DEQUE_FIFO_DO_TEST(mode, count) do {                 \
+  clock_t start, end;                                        \
+  mode::deque<int> d(1000, 1);                               \
+  char buf[10];                                              \
+  start = clock();                                           \
+  for (size_t i = 0; i < count; ++i)                         \
+  {                                                          \
+    d.push_back(static_cast<int>(i));                        \
+    d.pop_front();                                           \
+  }                                                          \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define DEQUE_FIFO_TEST(len1, len2, len3)                    \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|         std         |";                    \
+  DEQUE_FIFO_DO_TEST(std, len1);                             \
+  DEQUE_FIFO_DO_TEST(std, len2);                             \
+  DEQUE_FIFO_DO_TEST(std, len3);                             \
+  std::cout << "\n|        mystl        |";                  \
+  DEQUE_FIFO_DO_TEST(mystl, len1);                           \
+  DEQUE_FIFO_DO_TEST(mystl, len2);                           \
+  DEQUE_FIFO_DO_TEST(mystl, len3);
+
 void deque_test()
 {
   std::cout << "[===============================================================]" << std::endl;
@@ -87,6 +455,30 @@ void deque_test()
   CON_TEST_P1(deque<int>, push_back, rand(), SCALE_LL(LEN1), SCALE_LL(LEN2), SCALE_LL(LEN3));
 #else
   CON_TEST_P1(deque<int>, push_back, rand(), SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|         sort        |";
+#if LARGER_TEST_DATA_ON
+  DEQUE_SORT_TEST(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  DEQUE_SORT_TEST(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|   copy to vector    |";
+#if LARGER_TEST_DATA_ON
+  DEQUE_COPY_TEST(SCALE_LL(LEN1), SCALE_LL(LEN2), SCALE_LL(LEN3));
+#else
+  DEQUE_COPY_TEST(SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  push_back+pop_front|";
+#if LARGER_TEST_DATA_ON
+  DEQUE_FIFO_TEST(SCALE_LL(LEN1), SCALE_LL(LEN2), SCALE_LL(LEN3));
+#else
+  DEQUE_FIFO_TEST(SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
 #endif
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
@@ -0,0 +1,204 @@
+#ifndef MYTINYSTL_DYNAMIC_BITSET_TEST_H_
+#define MYTINYSTL_DYNAMIC_BITSET_TEST_H_
+
+// dynamic_bitset test : 测试 dynamic_bitset 的接口，以及按字处理过滤掩码的性能
+
+#include "../MyTinySTL/dynamic_bitset.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace dynamic_bitset_test
+{
+
+typedef mystl::dynamic_bitset<> bitset_type;
+
+TEST(dynamic_bitset_bit_test)
+{
+  EXPECT_EQ(0, mystl::bit_popcount(0));
+  EXPECT_EQ(64, mystl::bit_popcount(~uint64_t(0)));
+  EXPECT_EQ(3, mystl::bit_popcount(0x8000000000010001ULL));
+  EXPECT_EQ(0, mystl::bit_ctz(1));
+  EXPECT_EQ(63, mystl::bit_ctz(0x8000000000000000ULL));
+  EXPECT_EQ(16, mystl::bit_ctz(0x30000ULL));
+}
+
+TEST(dynamic_bitset_modify_test)
+{
+  bitset_type b(130);
+  EXPECT_EQ(130, b.size());
+  EXPECT_EQ(3, b.num_blocks());
+  EXPECT_TRUE(b.none());
+  b.set(0);
+  b.set(63);
+  b[64] = true;
+  b.set(129);
+  EXPECT_EQ(4, b.count());
+  EXPECT_TRUE(b.test(64));
+  EXPECT_TRUE(!b.test(65));
+  b.flip(64);
+  b.reset(0);
+  EXPECT_EQ(2, b.count());
+  EXPECT_TRUE(!b[64]);
+
+  b.flip();
+  EXPECT_EQ(128, b.count());
+  b.set();
+  EXPECT_TRUE(b.all());
+  EXPECT_EQ(130, b.count());
+  b.fill(false);
+  EXPECT_TRUE(b.none());
+
+  bitset_type ones(70, true);
+  EXPECT_TRUE(ones.all());
+  EXPECT_EQ(70, ones.count());
+  ones.resize(200, true);
+  EXPECT_EQ(200, ones.count());
+  ones.resize(65);
+  EXPECT_EQ(65, ones.count());
+  ones.resize(130);
+  EXPECT_EQ(65, ones.count());
+  EXPECT_TRUE(!ones.all());
+  ones.pop_back();
+  ones.push_back(true);
+  EXPECT_TRUE(ones[129]);
+  EXPECT_EQ(66, ones.count());
+
+  bitset_type p;
+  for (int i = 0; i < 100; ++i)
+    p.push_back(i % 3 == 0);
+  EXPECT_EQ(34, p.count());
+  while (p.size() > 64)
+    p.pop_back();
+  EXPECT_EQ(1, p.num_blocks());
+  EXPECT_EQ(22, p.count());
+
+  bool thrown = false;
+  try { p.test(64); }
+  catch (const std::out_of_range&) { thrown = true; }
+  EXPECT_TRUE(thrown);
+}
+
+TEST(dynamic_bitset_find_test)
+{
+  bitset_type b(300);
+  EXPECT_EQ(bitset_type::npos, b.find_first());
+  b.set(5);
+  b.set(64);
+  b.set(200);
+  b.set(299);
+  EXPECT_EQ(5, b.find_first());
+  EXPECT_EQ(64, b.find_next(5));
+  EXPECT_EQ(200, b.find_next(64));
+  EXPECT_EQ(299, b.find_next(200));
+  EXPECT_EQ(bitset_type::npos, b.find_next(299));
+  size_t n = 0;
+  for (size_t i = b.find_first(); i != bitset_type::npos; i = b.find_next(i))
+    ++n;
+  EXPECT_EQ(b.count(), n);
+}
+
+TEST(dynamic_bitset_logic_test)
+{
+  bitset_type a(100), b(100);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    a[i] = i % 2 == 0;
+    b[i] = i % 3 == 0;
+  }
+  EXPECT_EQ(17, (a & b).count());
+  EXPECT_EQ(67, (a | b).count());
+  EXPECT_EQ(50, (a ^ b).count());
+  EXPECT_EQ(33, (a - b).count());
+  EXPECT_EQ(50, (~a).count());
+  EXPECT_TRUE((a ^ a).none());
+  bitset_type c(a);
+  EXPECT_TRUE(c == a);
+  c &= b;
+  EXPECT_TRUE(c != a);
+  c.swap(a);
+  EXPECT_EQ(17, a.count());
+  bitset_type d(mystl::move(c));
+  EXPECT_EQ(50, d.count());
+  EXPECT_TRUE(c.empty());
+
+  // 1 亿行的掩码只需要 1/8 的内存
+  bitset_type mask(100000000);
+  EXPECT_EQ(12500000, mask.memory_usage().payload);
+}
+
+// 用 count 行的两个过滤掩码求交集并计数
+template <class Mask>
+size_t filter_rows(Mask& a, Mask& b, size_t count);
+
+template <>
+size_t filter_rows(mystl::vector<char>& a, mystl::vector<char>& b, size_t count)
+{
+  for (size_t i = 0; i < count; ++i)
+    a[i] = static_cast<char>(a[i] & b[i]);
+  size_t n = 0;
+  for (size_t i = 0; i < count; ++i)
+    n += a[i] != 0;
+  return n;
+}
+
+template <>
+size_t filter_rows(bitset_type& a, bitset_type& b, size_t)
+{
+  a &= b;
+  return a.count();
+}
+
+#define FILTER_TEST(mask, count) do {                     \
+  char buf[10];                                           \
+  mask a(count), b(count);                                \
+  for (size_t i = 0; i < count; ++i) {                    \
+    a[i] = i % 2 == 0;                                    \
+    b[i] = i % 3 == 0;                                    \
+  }                                                       \
+  size_t sum = 0;                                         \
+  clock_t start = clock();                                \
+  for (int pass = 0; pass < 10; ++pass)                   \
+    sum += filter_rows(a, b, count);                      \
+  clock_t end = clock();                                  \
+  volatile size_t sink = sum;                             \
+  (void)sink;                                             \
+  int n = static_cast<int>(static_cast<double>(end - start) \
+      / CLOCKS_PER_SEC * 1000);                           \
+  std::snprintf(buf, sizeof(buf), "%d", n);               \
+  std::string t = buf;                                    \
+  t += "ms    |";                                         \
+  std::cout << std::setw(WIDE) << t;                      \
+} while(0)
+
+void dynamic_bitset_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------- Run container test : dynamic_bitset -------------]" << std::endl;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  and + count (x10)  |";
+  TEST_LEN(SCALE_LL(LEN1), SCALE_LL(LEN2), SCALE_LL(LEN3), WIDE);
+  std::cout << "|    vector<char>     |";
+  FILTER_TEST(mystl::vector<char>, SCALE_LL(LEN1));
+  FILTER_TEST(mystl::vector<char>, SCALE_LL(LEN2));
+  FILTER_TEST(mystl::vector<char>, SCALE_LL(LEN3));
+  std::cout << "\n|   dynamic_bitset    |";
+  FILTER_TEST(bitset_type, SCALE_LL(LEN1));
+  FILTER_TEST(bitset_type, SCALE_LL(LEN2));
+  FILTER_TEST(bitset_type, SCALE_LL(LEN3));
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------------- End container test : dynamic_bitset -------------]" << std::endl;
+}
+
+} // namespace dynamic_bitset_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_DYNAMIC_BITSET_TEST_H_
@@ -0,0 +1,316 @@
+#ifndef MYTINYSTL_FORWARD_LIST_TEST_H_
+#define MYTINYSTL_FORWARD_LIST_TEST_H_
+
+// forward_list test : 测试 forward_list 的接口与 push_front, sort 的性能
+
+#include <algorithm>
+#include <forward_list>
+#include <vector>
+
+#include "../MyTinySTL/forward_list.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace forward_list_test
+{
+
+// 一个辅助测试函数
+bool is_odd(int x) { return x & 1; }
+
+// 只比较高位，用来检查排序的稳定性
+struct high_less
+{
+  bool operator()(int a, int b) const { return a / 100 < b / 100; }
+};
+
+// 比较若干次后抛出异常
+struct throwing_less
+{
+  int* budget;
+  bool operator()(int a, int b) const
+  {
+    if ((*budget)-- == 0)
+      throw 0;
+    return a < b;
+  }
+};
+
+template <class List>
+bool same(const List& l, std::initializer_list<int> ilist)
+{
+  auto it = ilist.begin();
+  for (auto& x : l)
+  {
+    if (it == ilist.end() || x != *it++)
+      return false;
+  }
+  return it == ilist.end() && l.size() == ilist.size();
+}
+
+TEST(forward_list_modify_test)
+{
+  mystl::forward_list<int> l{ 1,2,3 };
+  auto it = l.insert_after(l.before_begin(), 0);
+  EXPECT_EQ(0, *it);
+  it = l.insert_after(l.begin(), 2, 9);
+  EXPECT_EQ(9, *it);
+  ++it;
+  EXPECT_EQ(1, *it);
+  int a[] = { 7,8 };
+  it = l.insert_after(it, a, a + 2);
+  EXPECT_EQ(8, *it);
+  EXPECT_TRUE(it == l.insert_after(it, a, a));
+  EXPECT_TRUE(same(l, { 0,9,9,1,7,8,2,3 }));
+
+  it = l.erase_after(l.begin());
+  EXPECT_EQ(9, *it);
+  it = l.erase_after(it, l.end());
+  EXPECT_TRUE(it == l.end());
+  EXPECT_TRUE(same(l, { 0,9 }));
+  l.emplace_front(5);
+  l.pop_front();
+  l.resize(4, 1);
+  EXPECT_TRUE(same(l, { 0,9,1,1 }));
+  l.resize(1);
+  EXPECT_TRUE(same(l, { 0 }));
+
+  mystl::forward_list<int> l2(3, 4);
+  l.splice_after(l.before_begin(), l2);
+  EXPECT_TRUE(l2.empty());
+  EXPECT_EQ(0, l2.size());
+  EXPECT_TRUE(same(l, { 4,4,4,0 }));
+  l2.splice_after(l2.before_begin(), l, l.begin());
+  EXPECT_TRUE(same(l2, { 4 }));
+  EXPECT_EQ(3, l.size());
+  auto last = l.begin();
+  ++last;
+  ++last;
+  l2.splice_after(l2.begin(), l, l.before_begin(), last);
+  EXPECT_TRUE(same(l2, { 4,4,4 }));
+  EXPECT_TRUE(same(l, { 0 }));
+
+  l = { 3,1,2,2,5,5,5,4 };
+  l.unique();
+  EXPECT_TRUE(same(l, { 3,1,2,5,4 }));
+  l.remove_if(is_odd);
+  EXPECT_TRUE(same(l, { 2,4 }));
+  l2 = { 1,3,5 };
+  l.merge(l2);
+  EXPECT_TRUE(same(l, { 1,2,3,4,5 }));
+  EXPECT_TRUE(l2.empty());
+  l.reverse();
+  EXPECT_TRUE(same(l, { 5,4,3,2,1 }));
+
+  mystl::forward_list<int> l3(mystl::move(l));
+  EXPECT_TRUE(l.empty());
+  EXPECT_EQ(5, l3.front());
+  l.assign(2, 6);
+  l.swap(l3);
+  EXPECT_TRUE(same(l3, { 6,6 }));
+  EXPECT_TRUE(l < l3);
+  l3 = l;
+  EXPECT_TRUE(l3 == l);
+  l3.clear();
+  EXPECT_TRUE(l3.begin() == l3.end());
+}
+
+TEST(forward_list_sort_test)
+{
+  // 各种长度，包括非 2 的幂，相同高位的元素保持原来的顺序
+  for (int n = 0; n < 70; ++n)
+  {
+    mystl::forward_list<int> l;
+    std::vector<int> v;
+    for (int i = 0; i < n; ++i)
+      v.push_back((i * 37 % 7) * 100 + i);
+    l.insert_after(l.before_begin(), v.data(), v.data() + v.size());
+    std::stable_sort(v.begin(), v.end(), high_less());
+    l.sort(high_less());
+    bool ok = true;
+    auto it = l.begin();
+    for (auto x : v)
+      ok = ok && it != l.end() && *it++ == x;
+    EXPECT_TRUE(ok && it == l.end());
+  }
+
+  mystl::forward_list<int> l;
+  for (int i = 0; i < 1000; ++i)
+    l.push_front(i * 7919 % 1000);
+  l.sort(mystl::greater<int>());
+  int prev = 1000;
+  bool sorted = true;
+  for (auto x : l)
+  {
+    sorted = sorted && x == prev - 1;
+    prev = x;
+  }
+  EXPECT_TRUE(sorted);
+
+  // 比较抛出异常时不丢失节点
+  for (int budget = 0; budget < 60; budget += 7)
+  {
+    mystl::forward_list<int> t;
+    for (int i = 0; i < 40; ++i)
+      t.push_front(i);
+    int b = budget;
+    try
+    {
+      t.sort(throwing_less{ &b });
+    }
+    catch (int)
+    {
+    }
+    std::vector<int> w;
+    for (auto x : t)
+      w.push_back(x);
+    std::sort(w.begin(), w.end());
+    bool all = w.size() == 40;
+    for (int i = 0; all && i < 40; ++i)
+      all = w[i] == i;
+    EXPECT_TRUE(all);
+    EXPECT_EQ(40, t.size());
+  }
+}
+
+TEST(forward_list_uncounted_test)
+{
+  // 不保存大小时容器只有一个指针
+  typedef mystl::forward_list<int, mystl::allocator<int>, false> slist;
+  EXPECT_EQ(sizeof(void*), sizeof(slist));
+  EXPECT_EQ(sizeof(void*) + sizeof(size_t), sizeof(mystl::forward_list<int>));
+  EXPECT_TRUE(mystl::is_trivially_relocatable<slist>::value);
+
+  slist l{ 5,3,1 };
+  slist l2{ 4,2 };
+  EXPECT_EQ(3, l.size());
+  l.splice_after(l.before_begin(), l2, l2.before_begin(), l2.end());
+  EXPECT_TRUE(l2.empty());
+  EXPECT_TRUE(same(l, { 4,2,5,3,1 }));
+  l.sort();
+  EXPECT_TRUE(same(l, { 1,2,3,4,5 }));
+  l.resize(2);
+  EXPECT_EQ(2, l.size());
+  EXPECT_EQ(2 * sizeof(int), l.memory_usage().payload);
+}
+
+#define FORWARD_LIST_SORT_DO_TEST(mode, count) do {          \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  mode::forward_list<int> l;                                 \
+  char buf[10];                                              \
+  for (size_t i = 0; i < count; ++i)                         \
+    l.push_front(rand());                                    \
+  start = clock();                                           \
+  l.sort();                                                  \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define FORWARD_LIST_SORT_TEST(len1, len2, len3)             \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|         std         |";                    \
+  FORWARD_LIST_SORT_DO_TEST(std, len1);                      \
+  FORWARD_LIST_SORT_DO_TEST(std, len2);                      \
+  FORWARD_LIST_SORT_DO_TEST(std, len3);                      \
+  std::cout << "\n|        mystl        |";                  \
+  FORWARD_LIST_SORT_DO_TEST(mystl, len1);                    \
+  FORWARD_LIST_SORT_DO_TEST(mystl, len2);                    \
+  FORWARD_LIST_SORT_DO_TEST(mystl, len3);
+
+void forward_list_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[-------------- Run container test : forward_list --------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 1,2,3,4,5 };
+  mystl::forward_list<int> l1;
+  mystl::forward_list<int> l2(5);
+  mystl::forward_list<int> l3(5, 1);
+  mystl::forward_list<int> l4(a, a + 5);
+  mystl::forward_list<int> l5(l2);
+  mystl::forward_list<int> l6(std::move(l2));
+  mystl::forward_list<int> l7{ 1,2,3,4,5,6,7,8,9 };
+  mystl::forward_list<int> l8;
+  l8 = l3;
+  mystl::forward_list<int> l9;
+  l9 = std::move(l3);
+
+  FUN_AFTER(l1, l1.assign(8, 8));
+  FUN_AFTER(l1, l1.assign(a, a + 5));
+  FUN_AFTER(l1, l1.assign({ 1,2,3,4,5,6 }));
+  FUN_AFTER(l1, l1.insert_after(l1.before_begin(), 6));
+  FUN_AFTER(l1, l1.insert_after(l1.begin(), 2, 7));
+  FUN_AFTER(l1, l1.insert_after(l1.before_begin(), a, a + 5));
+  FUN_AFTER(l1, l1.push_front(1));
+  FUN_AFTER(l1, l1.emplace_after(l1.begin(), 1));
+  FUN_AFTER(l1, l1.emplace_front(0));
+  FUN_VALUE(l1.size());
+  FUN_AFTER(l1, l1.pop_front());
+  FUN_AFTER(l1, l1.erase_after(l1.begin()));
+  FUN_AFTER(l1, l1.erase_after(l1.before_begin(), l1.end()));
+  FUN_VALUE(l1.size());
+  FUN_AFTER(l1, l1.resize(10));
+  FUN_AFTER(l1, l1.resize(5, 1));
+  FUN_AFTER(l1, l1.resize(8, 2));
+  FUN_VALUE(l1.size());
+  FUN_AFTER(l1, l1.splice_after(l1.before_begin(), l4));
+  FUN_AFTER(l1, l1.splice_after(l1.begin(), l5, l5.begin()));
+  FUN_AFTER(l1, l1.splice_after(l1.before_begin(), l6, l6.before_begin(), l6.end()));
+  FUN_VALUE(l1.size());
+  FUN_AFTER(l1, l1.remove(0));
+  FUN_AFTER(l1, l1.remove_if(is_odd));
+  FUN_VALUE(l1.size());
+  FUN_AFTER(l1, l1.assign({ 9,5,3,3,7,1,3,2,2,0,10 }));
+  FUN_AFTER(l1, l1.sort());
+  FUN_AFTER(l1, l1.unique());
+  FUN_AFTER(l1, l1.unique([&](int a, int b) {return b == a + 1; }));
+  FUN_AFTER(l1, l1.merge(l7));
+  FUN_AFTER(l1, l1.sort(mystl::greater<int>()));
+  FUN_AFTER(l1, l1.merge(l8, mystl::greater<int>()));
+  FUN_AFTER(l1, l1.reverse());
+  FUN_AFTER(l1, l1.clear());
+  FUN_AFTER(l1, l1.swap(l9));
+  FUN_VALUE(*l1.begin());
+  FUN_VALUE(l1.front());
+  std::cout << std::boolalpha;
+  FUN_VALUE(l1.empty());
+  std::cout << std::noboolalpha;
+  FUN_VALUE(l1.size());
+  FUN_VALUE(l1.max_size());
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|     push_front      |";
+#if LARGER_TEST_DATA_ON
+  CON_TEST_P1(forward_list<int>, push_front, rand(), SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
+#else
+  CON_TEST_P1(forward_list<int>, push_front, rand(), SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|         sort        |";
+#if LARGER_TEST_DATA_ON
+  FORWARD_LIST_SORT_TEST(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  FORWARD_LIST_SORT_TEST(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[-------------- End container test : forward_list --------------]" << std::endl;
+}
+
+} // namespace forward_list_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_FORWARD_LIST_TEST_H_
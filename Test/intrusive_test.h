@@ -0,0 +1,424 @@
+#ifndef MYTINYSTL_INTRUSIVE_TEST_H_
+#define MYTINYSTL_INTRUSIVE_TEST_H_
+
+// intrusive test : 测试 intrusive_list、intrusive_set、intrusive_map 的接口与插入、删除的性能
+
+#include <cstdlib>
+
+#include "../MyTinySTL/intrusive_list.h"
+#include "../MyTinySTL/intrusive_map.h"
+#include "../MyTinySTL/intrusive_set.h"
+#include "../MyTinySTL/list.h"
+#include "../MyTinySTL/set.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace intrusive_test
+{
+
+struct lru_tag {};
+struct id_tag {};
+
+// 同一个对象可以同时在两个链表、两棵树中
+struct item : public mystl::intrusive_list_hook<>,
+              public mystl::intrusive_list_hook<lru_tag>,
+              public mystl::intrusive_tree_hook<>,
+              public mystl::intrusive_tree_hook<id_tag>
+{
+  int id;
+  int value;
+
+  item() :id(0), value(0) {}
+  item(int i, int v) :id(i), value(v) {}
+
+  bool operator<(const item& rhs) const { return value < rhs.value; }
+};
+
+struct item_id
+{
+  const int& operator()(const item& x) const { return x.id; }
+};
+
+typedef mystl::intrusive_list<item>                         item_list;
+typedef mystl::intrusive_list<item, lru_tag>                lru_list;
+typedef mystl::intrusive_multiset<item>                     value_set;
+typedef mystl::intrusive_map<int, item, item_id, id_tag>    id_map;
+
+template <class Container>
+bool values_are(const Container& c, std::initializer_list<int> ilist)
+{
+  if (c.size() != ilist.size())
+    return false;
+  auto it = ilist.begin();
+  for (auto& x : c)
+  {
+    if (x.value != *it++)
+      return false;
+  }
+  // 反向遍历也要一致
+  auto rit = ilist.end();
+  for (auto i = c.end(); i != c.begin();)
+  {
+    if ((--i)->value != *--rit)
+      return false;
+  }
+  return true;
+}
+
+TEST(intrusive_list_test)
+{
+  item a[6] = { {0,0}, {1,1}, {2,2}, {3,3}, {4,4}, {5,5} };
+  item_list l1;
+  item_list l2(a, a + 3);
+  EXPECT_TRUE(l1.empty());
+  EXPECT_EQ(3, l2.size());
+  EXPECT_TRUE(values_are(l2, { 0,1,2 }));
+
+  l1.push_back(a[4]);
+  l1.push_front(a[3]);
+  l1.insert(l1.end(), a[5]);
+  EXPECT_TRUE(values_are(l1, { 3,4,5 }));
+  EXPECT_EQ(&a[3], &l1.front());
+  EXPECT_EQ(&a[5], &l1.back());
+  EXPECT_TRUE(a[4].intrusive_list_hook<>::is_linked());
+
+  // 由元素直接得到迭代器并删除
+  auto it = l1.erase(l1.iterator_to(a[4]));
+  EXPECT_EQ(&a[5], &*it);
+  EXPECT_FALSE(a[4].intrusive_list_hook<>::is_linked());
+  l1.pop_front();
+  l1.pop_back();
+  EXPECT_TRUE(l1.empty());
+
+  l1.push_back(a[3]);
+  l1.push_back(a[4]);
+  l1.splice(l1.begin(), l2);
+  EXPECT_TRUE(l2.empty());
+  EXPECT_TRUE(values_are(l1, { 0,1,2,3,4 }));
+  l2.splice(l2.end(), l1, l1.iterator_to(a[2]));
+  EXPECT_EQ(4, l1.size());
+  EXPECT_EQ(1, l2.size());
+  l1.reverse();
+  EXPECT_TRUE(values_are(l1, { 4,3,1,0 }));
+  l1.remove_if([](const item& x) { return x.value % 2 == 1; });
+  EXPECT_TRUE(values_are(l1, { 4,0 }));
+
+  item_list l3(mystl::move(l1));
+  EXPECT_TRUE(l1.empty());
+  EXPECT_TRUE(values_are(l3, { 4,0 }));
+  l3.swap(l2);
+  EXPECT_TRUE(values_are(l3, { 2 }));
+  EXPECT_TRUE(values_are(l2, { 4,0 }));
+  l2 = mystl::move(l3);
+  EXPECT_TRUE(values_are(l2, { 2 }));
+  EXPECT_FALSE(a[0].intrusive_list_hook<>::is_linked());
+  l2.clear();
+  EXPECT_TRUE(l2.begin() == l2.end());
+  EXPECT_FALSE(a[2].intrusive_list_hook<>::is_linked());
+}
+
+TEST(intrusive_set_test)
+{
+  item a[8];
+  const int values[] = { 5,3,8,1,3,9,2,5 };
+  for (int i = 0; i < 8; ++i)
+    a[i] = item(i, values[i]);
+
+  mystl::intrusive_set<item, id_tag> s;
+  value_set ms(a, a + 8);
+  for (int i = 0; i < 8; ++i)
+    s.insert(a[i]);
+  EXPECT_EQ(6, s.size());
+  EXPECT_TRUE(values_are(s, { 1,2,3,5,8,9 }));
+  EXPECT_TRUE(values_are(ms, { 1,2,3,3,5,5,8,9 }));
+  // 重复的键值没有插入，返回已有的元素
+  EXPECT_FALSE(a[4].intrusive_tree_hook<id_tag>::is_linked());
+  auto r = s.insert(a[4]);
+  EXPECT_FALSE(r.second);
+  EXPECT_EQ(&a[1], &*r.first);
+  EXPECT_FALSE(a[4].intrusive_tree_hook<id_tag>::is_linked());
+  s.clear();
+
+  // 相同键值按插入顺序排列
+  EXPECT_EQ(2, ms.count(item(0, 3)));
+  auto range = ms.equal_range(item(0, 5));
+  EXPECT_EQ(&a[0], &*range.first);
+  EXPECT_EQ(&a[7], &*++range.first);
+  EXPECT_EQ(&a[2], &*ms.upper_bound(item(0, 5)));
+  EXPECT_TRUE(ms.find(item(0, 4)) == ms.end());
+  EXPECT_EQ(&a[5], &*ms.lower_bound(item(0, 9)));
+
+  EXPECT_EQ(2, ms.erase(item(0, 3)));
+  ms.erase(ms.iterator_to(a[0]));
+  EXPECT_TRUE(values_are(ms, { 1,2,5,8,9 }));
+  EXPECT_FALSE(a[1].intrusive_tree_hook<>::is_linked());
+  auto it = ms.erase(ms.begin(), ms.find(item(0, 8)));
+  EXPECT_EQ(&a[2], &*it);
+  value_set ms2(mystl::move(ms));
+  EXPECT_TRUE(ms.empty());
+  EXPECT_TRUE(values_are(ms2, { 8,9 }));
+  ms.insert(a[3]);
+  ms.swap(ms2);
+  EXPECT_TRUE(values_are(ms, { 8,9 }));
+  EXPECT_TRUE(values_are(ms2, { 1 }));
+}
+
+TEST(intrusive_map_test)
+{
+  item a[5] = { {30,0}, {10,1}, {20,2}, {10,3}, {40,4} };
+  id_map m;
+  mystl::intrusive_multimap<int, item, item_id, id_tag> mm;
+  for (auto& x : a)
+  {
+    if (!m.insert(x).second)
+      mm.insert(x);
+  }
+  EXPECT_EQ(4, m.size());
+  EXPECT_TRUE(values_are(m, { 1,2,0,4 }));
+  EXPECT_TRUE(values_are(mm, { 3 }));
+  EXPECT_EQ(&a[2], &*m.find(20));
+  EXPECT_TRUE(m.find(25) == m.end());
+  EXPECT_EQ(1, m.count(40));
+  // 通过迭代器修改键以外的部分
+  m.find(40)->value = 7;
+  EXPECT_EQ(7, a[4].value);
+  EXPECT_EQ(1, m.erase(10));
+  EXPECT_EQ(0, m.erase(10));
+  EXPECT_FALSE(a[1].intrusive_tree_hook<id_tag>::is_linked());
+  EXPECT_TRUE(values_are(m, { 2,0,7 }));
+}
+
+TEST(intrusive_multi_hook_test)
+{
+  // 一个对象同时在 list、lru list、multiset、map 中，从其中一个删除不影响其他
+  mystl::vector<item> pool;
+  pool.reserve(100);
+  for (int i = 0; i < 100; ++i)
+    pool.push_back(item(i, (i * 37) % 100));
+  item_list order;
+  lru_list lru;
+  value_set by_value;
+  id_map by_id;
+  for (auto& x : pool)
+  {
+    order.push_back(x);
+    lru.push_front(x);
+    by_value.insert(x);
+    by_id.insert(x);
+  }
+  EXPECT_EQ(100, order.size());
+  EXPECT_EQ(100, lru.size());
+  // 树的中序遍历有序
+  int prev = -1;
+  bool sorted = true;
+  for (auto& x : by_value)
+  {
+    sorted = sorted && prev < x.value;
+    prev = x.value;
+  }
+  EXPECT_TRUE(sorted);
+  EXPECT_EQ(0, by_id.begin()->id);
+  EXPECT_EQ(99, by_id.rbegin()->id);
+
+  // 按 lru 顺序删除偶数 id 的元素，其他容器中也一并取下
+  for (auto it = lru.begin(); it != lru.end();)
+  {
+    item& x = *it;
+    if (x.id % 2 == 0)
+    {
+      it = lru.erase(it);
+      order.erase(order.iterator_to(x));
+      by_value.erase(by_value.iterator_to(x));
+      by_id.erase(by_id.iterator_to(x));
+    }
+    else
+    {
+      ++it;
+    }
+  }
+  EXPECT_EQ(50, order.size());
+  EXPECT_EQ(50, by_value.size());
+  EXPECT_EQ(50, by_id.size());
+  EXPECT_EQ(99, lru.front().id);
+  EXPECT_EQ(1, order.front().id);
+  EXPECT_TRUE(by_id.find(42) == by_id.end());
+  EXPECT_EQ(&pool[43], &*by_id.find(43));
+  EXPECT_EQ(1, by_value.begin()->value);
+
+  // 随机删除、重新插入，与中序遍历的结果对照
+  std::srand(17);
+  for (int step = 0; step < 2000; ++step)
+  {
+    item& x = pool[std::rand() % 100];
+    if (x.intrusive_tree_hook<>::is_linked())
+      by_value.erase(by_value.iterator_to(x));
+    else
+      by_value.insert(x);
+  }
+  size_t n = 0;
+  prev = -1;
+  sorted = true;
+  for (auto& x : pool)
+    n += x.intrusive_tree_hook<>::is_linked();
+  for (auto& x : by_value)
+  {
+    sorted = sorted && prev < x.value;
+    prev = x.value;
+  }
+  EXPECT_TRUE(sorted);
+  EXPECT_EQ(n, by_value.size());
+  by_value.clear();
+  by_id.clear();
+  order.clear();
+  lru.clear();
+}
+
+// 性能测试使用只有一个 hook 的元素，大小与 list、rb_tree 的节点相同
+struct list_elem : public mystl::intrusive_list_hook<>
+{
+  int value;
+  bool operator<(const list_elem& rhs) const { return value < rhs.value; }
+};
+
+struct tree_elem : public mystl::intrusive_tree_hook<>
+{
+  int value;
+  bool operator<(const tree_elem& rhs) const { return value < rhs.value; }
+};
+
+// 插入 n 个元素并全部删除，intrusive 容器的元素事先准备好
+template <class T>
+struct container_ops;
+
+template <>
+struct container_ops<mystl::list<int>>
+{
+  typedef list_elem elem_type;
+  static void run(mystl::vector<elem_type>& pool)
+  {
+    mystl::list<int> l;
+    for (auto& x : pool)
+      l.push_back(x.value);
+    while (!l.empty())
+      l.pop_front();
+  }
+};
+
+template <>
+struct container_ops<mystl::intrusive_list<list_elem>>
+{
+  typedef list_elem elem_type;
+  static void run(mystl::vector<elem_type>& pool)
+  {
+    mystl::intrusive_list<list_elem> l;
+    for (auto& x : pool)
+      l.push_back(x);
+    while (!l.empty())
+      l.pop_front();
+  }
+};
+
+template <>
+struct container_ops<mystl::multiset<int>>
+{
+  typedef tree_elem elem_type;
+  static void run(mystl::vector<elem_type>& pool)
+  {
+    mystl::multiset<int> s;
+    for (auto& x : pool)
+      s.insert(x.value);
+    while (!s.empty())
+      s.erase(s.begin());
+  }
+};
+
+template <>
+struct container_ops<mystl::intrusive_multiset<tree_elem>>
+{
+  typedef tree_elem elem_type;
+  static void run(mystl::vector<elem_type>& pool)
+  {
+    mystl::intrusive_multiset<tree_elem> s;
+    for (auto& x : pool)
+      s.insert(x);
+    while (!s.empty())
+      s.erase(s.begin());
+  }
+};
+
+#define INTRUSIVE_TEST(con, count) do {                   \
+  mystl::vector<container_ops<con>::elem_type> pool(count); \
+  for (size_t i = 0; i < pool.size(); ++i)                \
+    pool[i].value = std::rand();                          \
+  char buf[10];                                           \
+  clock_t start = clock();                                \
+  container_ops<con>::run(pool);                          \
+  clock_t end = clock();                                  \
+  int n = static_cast<int>(static_cast<double>(end - start) \
+      / CLOCKS_PER_SEC * 1000);                           \
+  std::snprintf(buf, sizeof(buf), "%d", n);               \
+  std::string t = buf;                                    \
+  t += "ms    |";                                         \
+  std::cout << std::setw(WIDE) << t;                      \
+} while(0)
+
+void intrusive_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[-------------- Run container test : intrusive -----------------]" << std::endl;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|   insert + erase    |";
+#if LARGER_TEST_DATA_ON
+  TEST_LEN(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3), WIDE);
+  std::cout << "|        list         |";
+  INTRUSIVE_TEST(mystl::list<int>, SCALE_M(LEN1));
+  INTRUSIVE_TEST(mystl::list<int>, SCALE_M(LEN2));
+  INTRUSIVE_TEST(mystl::list<int>, SCALE_M(LEN3));
+  std::cout << "\n|   intrusive_list    |";
+  INTRUSIVE_TEST(mystl::intrusive_list<list_elem>, SCALE_M(LEN1));
+  INTRUSIVE_TEST(mystl::intrusive_list<list_elem>, SCALE_M(LEN2));
+  INTRUSIVE_TEST(mystl::intrusive_list<list_elem>, SCALE_M(LEN3));
+  std::cout << "\n|      multiset       |";
+  INTRUSIVE_TEST(mystl::multiset<int>, SCALE_S(LEN1));
+  INTRUSIVE_TEST(mystl::multiset<int>, SCALE_S(LEN2));
+  INTRUSIVE_TEST(mystl::multiset<int>, SCALE_S(LEN3));
+  std::cout << "\n| intrusive_multiset  |";
+  INTRUSIVE_TEST(mystl::intrusive_multiset<tree_elem>, SCALE_S(LEN1));
+  INTRUSIVE_TEST(mystl::intrusive_multiset<tree_elem>, SCALE_S(LEN2));
+  INTRUSIVE_TEST(mystl::intrusive_multiset<tree_elem>, SCALE_S(LEN3));
+#else
+  TEST_LEN(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3), WIDE);
+  std::cout << "|        list         |";
+  INTRUSIVE_TEST(mystl::list<int>, SCALE_S(LEN1));
+  INTRUSIVE_TEST(mystl::list<int>, SCALE_S(LEN2));
+  INTRUSIVE_TEST(mystl::list<int>, SCALE_S(LEN3));
+  std::cout << "\n|   intrusive_list    |";
+  INTRUSIVE_TEST(mystl::intrusive_list<list_elem>, SCALE_S(LEN1));
+  INTRUSIVE_TEST(mystl::intrusive_list<list_elem>, SCALE_S(LEN2));
+  INTRUSIVE_TEST(mystl::intrusive_list<list_elem>, SCALE_S(LEN3));
+  std::cout << "\n|      multiset       |";
+  INTRUSIVE_TEST(mystl::multiset<int>, SCALE_SS(LEN1));
+  INTRUSIVE_TEST(mystl::multiset<int>, SCALE_SS(LEN2));
+  INTRUSIVE_TEST(mystl::multiset<int>, SCALE_SS(LEN3));
+  std::cout << "\n| intrusive_multiset  |";
+  INTRUSIVE_TEST(mystl::intrusive_multiset<tree_elem>, SCALE_SS(LEN1));
+  INTRUSIVE_TEST(mystl::intrusive_multiset<tree_elem>, SCALE_SS(LEN2));
+  INTRUSIVE_TEST(mystl::intrusive_multiset<tree_elem>, SCALE_SS(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[-------------- End container test : intrusive -----------------]" << std::endl;
+}
+
+} // namespace intrusive_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_INTRUSIVE_TEST_H_
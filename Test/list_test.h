@@ -3,7 +3,9 @@
 
 // list test : 测试 list 的接口与 insert, sort 的性能
 
+#include <algorithm>
 #include <list>
+#include <vector>
 
 #include "../MyTinySTL/list.h"
 #include "test.h"
@@ -18,6 +20,225 @@ namespace list_test
 // 一个辅助测试函数
 bool is_odd(int x) { return x & 1; }
 
+// 只比较高位，用来检查排序的稳定性
+struct high_less
+{
+  bool operator()(int a, int b) const { return a / 100 < b / 100; }
+};
+
+// 比较若干次后抛出异常
+struct throwing_less
+{
+  int* budget;
+  bool operator()(int a, int b) const
+  {
+    if ((*budget)-- == 0)
+      throw 0;
+    return a < b;
+  }
+};
+
+// 正反两个方向遍历，检查节点之间的链接
+template <class List>
+bool links_ok(const List& l)
+{
+  size_t n = 0;
+  for (auto it = l.begin(); it != l.end(); ++it)
+    ++n;
+  if (n != l.size())
+    return false;
+  for (auto it = l.end(); it != l.begin(); --it)
+    --n;
+  return n == 0;
+}
+
+TEST(list_sort_test)
+{
+  // 各种长度，包括非 2 的幂
+  for (int n = 0; n < 70; ++n)
+  {
+    mystl::list<int> l;
+    std::vector<int> v;
+    for (int i = 0; i < n; ++i)
+    {
+      int x = (i * 7919 + 13) % 10 * 100 + i;
+      l.push_back(x);
+      v.push_back(x);
+    }
+    l.sort(high_less());
+    std::stable_sort(v.begin(), v.end(), high_less());
+    EXPECT_TRUE(links_ok(l));
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), l.begin()));
+  }
+
+  mystl::list<int> l;
+  std::vector<int> v;
+  for (int i = 0; i < 1000; ++i)
+  {
+    int x = (i * 7919) % 1009;
+    l.push_back(x);
+    v.push_back(x);
+  }
+  l.sort(mystl::greater<int>());
+  std::sort(v.begin(), v.end(), std::greater<int>());
+  EXPECT_TRUE(links_ok(l));
+  EXPECT_TRUE(std::equal(v.begin(), v.end(), l.begin()));
+
+  // 比较时抛出异常，元素不会丢失
+  for (int k = 0; k < 2000; k += 97)
+  {
+    int budget = k;
+    throwing_less comp{ &budget };
+    mystl::list<int> t(l.begin(), l.end());
+    try
+    {
+      t.sort(comp);
+    }
+    catch (int)
+    {
+    }
+    EXPECT_TRUE(links_ok(t));
+    std::vector<int> w;
+    for (auto x : t)
+      w.push_back(x);
+    std::sort(w.begin(), w.end(), std::greater<int>());
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), w.begin()));
+  }
+}
+
+// 复制若干次后抛出异常
+struct throwing_copy
+{
+  static int budget;
+  int value;
+
+  throwing_copy(int v) :value(v) {}
+  throwing_copy(const throwing_copy& rhs) :value(rhs.value)
+  {
+    if (budget-- == 0)
+      throw 0;
+  }
+};
+
+int throwing_copy::budget = -1;
+
+TEST(list_batch_insert_test)
+{
+  // 批量插入的节点在内存中依次相邻
+  mystl::list<int> l(3, 0);
+  int a[100];
+  for (int i = 0; i < 100; ++i)
+    a[i] = i;
+  auto it = l.insert(++l.begin(), a, a + 100);
+  EXPECT_EQ(0, *it);
+  auto first = &*it;
+  bool adjacent = true;
+  for (int i = 0; i < 100; ++i, ++it)
+    adjacent = adjacent && *it == i &&
+      &*it == first + i * (sizeof(mystl::list_node<int>) / sizeof(int));
+  EXPECT_TRUE(adjacent);
+  EXPECT_EQ(0, *it);
+  it = l.insert(l.end(), 50, 7);
+  EXPECT_EQ(7, *it);
+  EXPECT_EQ(153, l.size());
+  EXPECT_TRUE(links_ok(l));
+  EXPECT_EQ(7, l.back());
+
+  // 批量插入的一部分节点接合到另一个 list，原来的 list 清空之后它们依然有效
+  mystl::list<int> l2;
+  auto sfirst = l.begin();
+  mystl::advance(sfirst, 11);
+  auto slast = sfirst;
+  mystl::advance(slast, 20);
+  l2.splice(l2.end(), l, sfirst, slast);
+  l.clear();
+  EXPECT_EQ(20, l2.size());
+  EXPECT_EQ(10, l2.front());
+  EXPECT_EQ(29, l2.back());
+  EXPECT_TRUE(links_ok(l2));
+
+  // 构造元素时抛出异常，容器不变
+  mystl::list<throwing_copy> t(5, throwing_copy(1));
+  std::vector<throwing_copy> src(20, throwing_copy(2));
+  throwing_copy::budget = 10;
+  try
+  {
+    t.insert(++t.begin(), src.data(), src.data() + src.size());
+  }
+  catch (int)
+  {
+  }
+  throwing_copy::budget = 3;
+  try
+  {
+    t.insert(t.end(), 8, throwing_copy(3));
+  }
+  catch (int)
+  {
+  }
+  throwing_copy::budget = -1;
+  EXPECT_EQ(5, t.size());
+  EXPECT_TRUE(links_ok(t));
+  t.insert(t.begin(), 3, throwing_copy(4));
+  EXPECT_EQ(8, t.size());
+  EXPECT_EQ(4, t.front().value);
+  EXPECT_EQ(1, t.back().value);
+}
+
+// 不能复制也不能移动，splice 只能转移节点
+struct pinned
+{
+  int value;
+  explicit pinned(int v) :value(v) {}
+  pinned(const pinned&) = delete;
+  pinned& operator=(const pinned&) = delete;
+};
+
+TEST(list_splice_test)
+{
+  mystl::list<pinned> l1;
+  mystl::list<pinned> l2;
+  for (int i = 0; i < 5; ++i)
+  {
+    l1.emplace_back(i);
+    l2.emplace_back(10 + i);
+  }
+
+  // 被接合的元素留在原来的节点中，指向它们的迭代器与地址依然有效
+  auto it = l2.begin();
+  const pinned* addr = &*it;
+  l1.splice(l1.begin(), l2, it);
+  EXPECT_TRUE(it == l1.begin());
+  EXPECT_TRUE(addr == &l1.front());
+  EXPECT_EQ(6, l1.size());
+  EXPECT_EQ(4, l2.size());
+
+  auto first = l2.begin();
+  auto last = first;
+  ++last;
+  ++last;
+  const pinned* addr2 = &*last;
+  l1.splice(l1.end(), l2, first, last);
+  EXPECT_EQ(11, first->value);
+  EXPECT_EQ(12, (++first)->value);
+  EXPECT_TRUE(++first == l1.end());
+  EXPECT_TRUE(addr2 == &l2.front());
+  EXPECT_EQ(8, l1.size());
+  EXPECT_EQ(2, l2.size());
+  EXPECT_TRUE(links_ok(l1));
+  EXPECT_TRUE(links_ok(l2));
+
+  // 接合之后各自删除元素，节点由当前所在的容器释放
+  l2.erase(l2.begin());
+  l1.erase(l1.begin());
+  l2.splice(l2.begin(), l1);
+  EXPECT_EQ(8, l2.size());
+  EXPECT_TRUE(l1.empty());
+  EXPECT_EQ(0, l2.front().value);
+  EXPECT_EQ(14, l2.back().value);
+  EXPECT_TRUE(links_ok(l2));
+}
+
 void list_test()
 {
   std::cout << "[===============================================================]" << std::endl;
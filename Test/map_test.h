@@ -42,6 +42,21 @@ namespace map_test
     std::cout << " " << str << " : <" << it.first << "," << it.second << ">\n"; \
 } while(0)
 
+TEST(map_header_leak_test)
+{
+  mystl::map<int, int> warm;
+  warm[1] = 1;
+  const size_t before = heap_in_use();
+  for (int i = 0; i < 1000; ++i)
+  {
+    mystl::map<int, int> m;
+    mystl::map<int, int> n;
+    n[i] = i;
+    m = std::move(n);
+  }
+  EXPECT_TRUE(heap_in_use() <= before + 4096);
+}
+
 void map_test()
 {
   std::cout << "[===============================================================]" << std::endl;
@@ -0,0 +1,547 @@
+#ifndef MYTINYSTL_MPMC_QUEUE_TEST_H_
+#define MYTINYSTL_MPMC_QUEUE_TEST_H_
+
+// mpmc_queue test : 测试 mpmc_queue 的接口，以及与加锁的 queue 在多个生产者、消费者之间传递元素的性能
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../MyTinySTL/astring.h"
+#include "../MyTinySTL/mpmc_queue.h"
+#include "../MyTinySTL/queue.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace mpmc_queue_test
+{
+
+// 记录存活个数的元素，复制次数用完时抛出异常
+struct counted
+{
+  static int live;
+  static int copy_budget;
+  int value;
+
+  counted(int v) : value(v) { ++live; }
+  counted(const counted& rhs) : value(rhs.value)
+  {
+    if (copy_budget-- == 0)
+      throw 0;
+    ++live;
+  }
+  counted(counted&& rhs) noexcept : value(rhs.value) { ++live; }
+  counted& operator=(const counted& rhs)
+  {
+    if (copy_budget-- == 0)
+      throw 0;
+    value = rhs.value;
+    return *this;
+  }
+  counted& operator=(counted&& rhs) noexcept { value = rhs.value; return *this; }
+  ~counted() { --live; }
+};
+
+int counted::live = 0;
+int counted::copy_budget = -1;
+
+// 赋值第 n 次时抛出异常的输出迭代器
+struct throwing_output
+{
+  std::vector<int>* out;
+  int*              budget;
+
+  throwing_output& operator*() { return *this; }
+  throwing_output& operator++() { return *this; }
+  throwing_output& operator=(int x)
+  {
+    if ((*budget)-- == 0)
+      throw 0;
+    out->push_back(x);
+    return *this;
+  }
+};
+
+TEST(mpmc_queue_basic_test)
+{
+  // 容量为 0、1 时取整为 2，连续放入两个元素后仍能按顺序取出
+  for (int n = 0; n < 2; ++n)
+  {
+    mystl::mpmc_queue<int> q0(n);
+    EXPECT_EQ(2, q0.capacity());
+    EXPECT_TRUE(q0.try_push(10));
+    EXPECT_TRUE(q0.try_push(11));
+    EXPECT_FALSE(q0.try_push(12));
+    int y = -1;
+    EXPECT_TRUE(q0.try_pop(y));
+    EXPECT_EQ(10, y);
+    EXPECT_TRUE(q0.try_pop(y));
+    EXPECT_EQ(11, y);
+    EXPECT_FALSE(q0.try_pop(y));
+  }
+
+  mystl::mpmc_queue<int> q1(5);
+  EXPECT_EQ(8, q1.capacity());
+  EXPECT_TRUE(q1.empty());
+  int x = -1;
+  EXPECT_FALSE(q1.try_pop(x));
+  EXPECT_EQ(-1, x);
+
+  for (int i = 0; i < 8; ++i)
+    EXPECT_TRUE(q1.try_push(i));
+  EXPECT_FALSE(q1.try_push(8));
+  EXPECT_FALSE(q1.try_emplace(8));
+  EXPECT_EQ(8, q1.size());
+  EXPECT_EQ(8 * sizeof(int), q1.memory_usage().payload);
+  for (int i = 0; i < 8; ++i)
+  {
+    EXPECT_TRUE(q1.try_pop(x));
+    EXPECT_EQ(i, x);
+  }
+  EXPECT_TRUE(q1.empty());
+  EXPECT_EQ(0, q1.memory_usage().payload);
+
+  // 位置回绕很多圈之后依然保持先进先出
+  bool ok = true;
+  int next_in = 0, next_out = 0;
+  for (int round = 0; round < 1000; ++round)
+  {
+    const int n = round % 7 + 1;
+    for (int i = 0; i < n; ++i)
+      ok = ok && q1.try_emplace(next_in++);
+    for (int i = 0; i < n; ++i)
+      ok = ok && q1.try_pop(x) && x == next_out++;
+  }
+  EXPECT_TRUE(ok);
+
+  // 单线程下阻塞的操作在不需要等待时直接完成
+  q1.push(1);
+  q1.emplace(2);
+  q1.pop(x);
+  EXPECT_EQ(1, x);
+  q1.pop(x);
+  EXPECT_EQ(2, x);
+}
+
+TEST(mpmc_queue_batch_test)
+{
+  mystl::mpmc_queue<int> q(8);
+  std::vector<int> src;
+  for (int i = 0; i < 20; ++i)
+    src.push_back(i);
+
+  EXPECT_EQ(5, q.try_push_n(src.begin(), 5));
+  EXPECT_EQ(3, q.try_push_n(src.begin() + 5, 10));
+  EXPECT_EQ(0, q.try_push_n(src.begin() + 8, 10));
+  EXPECT_EQ(0, q.try_push_n(src.begin(), 0));
+
+  int out[16] = { 0 };
+  EXPECT_EQ(6, q.try_pop_n(out, 6));
+  EXPECT_EQ(0, out[0]);
+  EXPECT_EQ(5, out[5]);
+  EXPECT_EQ(6, q.try_push_n(src.begin() + 8, 6));
+  EXPECT_EQ(8, q.try_pop_n(out, 16));
+  for (int i = 0; i < 8; ++i)
+    EXPECT_EQ(6 + i, out[i]);
+  EXPECT_EQ(0, q.try_pop_n(out, 16));
+
+  std::list<int> l(src.begin(), src.begin() + 7);
+  q.push_n(l.begin(), l.size());
+  std::vector<int> v;
+  EXPECT_EQ(7, q.pop_n(std::back_inserter(v), 100));
+  EXPECT_CON_EQ(l, v);
+  EXPECT_EQ(0, q.pop_n(out, 0));
+
+  // 复制可能抛出异常的元素逐个放入
+  mystl::mpmc_queue<mystl::string> qs(4);
+  std::vector<mystl::string> words = { "a", "bb", "a string longer than the short buffer", "dd", "e" };
+  EXPECT_EQ(4, qs.try_push_n(words.begin(), words.size()));
+  mystl::string s;
+  EXPECT_TRUE(qs.try_pop(s));
+  EXPECT_EQ(mystl::string("a"), s);
+  EXPECT_EQ(1, qs.try_push_n(words.begin() + 4, 1));
+  std::vector<mystl::string> got(4);
+  EXPECT_EQ(4, qs.try_pop_n(got.begin(), 4));
+  EXPECT_EQ(words[2], got[1]);
+  EXPECT_EQ(mystl::string("e"), got[3]);
+}
+
+TEST(mpmc_queue_exception_test)
+{
+  {
+    mystl::mpmc_queue<counted> q(4);
+    counted c(7);
+    const int base = counted::live;
+
+    // 复制在抢占位置之前完成，抛出异常时队列不变
+    counted::copy_budget = 0;
+    bool thrown = false;
+    try
+    {
+      q.try_push(c);
+    }
+    catch (...)
+    {
+      thrown = true;
+    }
+    EXPECT_TRUE(thrown);
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(base, counted::live);
+
+    // 逐个放入时，抛出异常之前放入的元素保留
+    std::vector<counted> src(6, counted(1));
+    counted::copy_budget = 2;
+    thrown = false;
+    try
+    {
+      q.try_push_n(src.begin(), src.size());
+    }
+    catch (...)
+    {
+      thrown = true;
+    }
+    counted::copy_budget = -1;
+    EXPECT_TRUE(thrown);
+    EXPECT_EQ(2, q.size());
+    EXPECT_EQ(2, q.try_push_n(src.begin(), src.size()));
+    EXPECT_FALSE(q.try_push(c));
+
+    // 析构时销毁队列中剩余的元素
+    EXPECT_EQ(base + 6 + 4, counted::live);
+  }
+  EXPECT_EQ(0, counted::live);
+
+  // 交出元素时抛出异常，本批次剩余的元素被丢弃，队列仍然可用
+  mystl::mpmc_queue<int> q(8);
+  for (int i = 0; i < 6; ++i)
+    q.push(i);
+  std::vector<int> out;
+  int budget = 2;
+  throwing_output it = { &out, &budget };
+  bool thrown = false;
+  try
+  {
+    q.try_pop_n(it, 5);
+  }
+  catch (...)
+  {
+    thrown = true;
+  }
+  EXPECT_TRUE(thrown);
+  EXPECT_EQ(2, out.size());
+  EXPECT_EQ(1, q.size());
+  int x = 0;
+  EXPECT_TRUE(q.try_pop(x));
+  EXPECT_EQ(5, x);
+  std::vector<int> eight(8, 1);
+  EXPECT_EQ(8, q.try_push_n(eight.begin(), eight.size()));
+  EXPECT_FALSE(q.try_push(0));
+}
+
+TEST(mpmc_queue_blocking_test)
+{
+  // 队列已满时 push 等待，已空时 pop 等待，由另一侧的操作唤醒
+  mystl::mpmc_queue<int> q(2);
+  q.push(0);
+  q.push(1);
+  std::atomic<bool> pushed(false);
+  std::thread producer([&q, &pushed]() {
+    q.push(2);
+    pushed = true;
+    int more[3] = { 3, 4, 5 };
+    q.push_n(more, 3);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(pushed.load());
+  int x = -1;
+  bool ok = true;
+  for (int i = 0; i < 6; ++i)
+  {
+    q.pop(x);
+    ok = ok && x == i;
+  }
+  producer.join();
+  EXPECT_TRUE(ok);
+  EXPECT_TRUE(pushed.load());
+
+  std::vector<int> got;
+  std::thread consumer([&q, &got]() {
+    int v;
+    q.pop(v);
+    got.push_back(v);
+    int buf[8];
+    size_t n = 0;
+    while (n < 3)
+      n += q.pop_n(buf, 8);
+    got.push_back(static_cast<int>(n));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  q.push(42);
+  for (int i = 0; i < 3; ++i)
+    q.push(i);
+  consumer.join();
+  EXPECT_EQ(2, got.size());
+  EXPECT_EQ(42, got[0]);
+  EXPECT_EQ(3, got[1]);
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(mpmc_queue_thread_test)
+{
+  // 4 个生产者与 4 个消费者，混合使用非阻塞、阻塞与批量操作；
+  // 每个元素恰好被取出一次，同一个消费者看到的同一个生产者的元素保持先后顺序
+  const int producers = 4, consumers = 4, per_producer = 50000;
+  const int total = producers * per_producer;
+  mystl::mpmc_queue<int> q(64);
+  std::vector<std::atomic<int>> seen(total);
+  for (auto& s : seen)
+    s.store(0);
+  std::atomic<int> consumed(0);
+  std::atomic<int> order_errors(0);
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p)
+  {
+    threads.push_back(std::thread([&q, p, per_producer]() {
+      int next = p * per_producer;
+      const int last = next + per_producer;
+      int batch[17];
+      while (next < last)
+      {
+        if (p % 2 == 0 && next % 3 == 0)
+        {
+          int n = 0;
+          for (; n < 17 && next + n < last; ++n)
+            batch[n] = next + n;
+          q.push_n(batch, n);
+          next += n;
+        }
+        else if (p % 2 == 1 && next % 5 == 0)
+        {
+          q.push(next++);
+        }
+        else if (q.try_push(next))
+        {
+          ++next;
+        }
+        else
+        {
+          std::this_thread::yield();
+        }
+      }
+    }));
+  }
+  for (int c = 0; c < consumers; ++c)
+  {
+    threads.push_back(std::thread([&, c]() {
+      std::vector<int> last_seen(producers, -1);
+      int buf[13];
+      while (consumed.load() < total)
+      {
+        size_t k = 0;
+        if (c % 2 == 0)
+        {
+          k = q.try_pop_n(buf, 13);
+        }
+        else if (q.try_pop(buf[0]))
+        {
+          k = 1;
+        }
+        if (k == 0)
+          std::this_thread::yield();
+        for (size_t i = 0; i < k; ++i)
+        {
+          const int v = buf[i];
+          const int p = v / per_producer;
+          if (v <= last_seen[p])
+            ++order_errors;
+          last_seen[p] = v;
+          seen[v].fetch_add(1);
+        }
+        consumed.fetch_add(static_cast<int>(k));
+      }
+    }));
+  }
+  for (auto& t : threads)
+    t.join();
+
+  bool once = true;
+  for (auto& s : seen)
+    once = once && s.load() == 1;
+  EXPECT_TRUE(once);
+  EXPECT_EQ(0, order_errors.load());
+  EXPECT_EQ(total, consumed.load());
+  EXPECT_TRUE(q.empty());
+}
+
+// 由 producers 个生产者、同样多的消费者传递 count 个元素，返回经过的毫秒数
+template <class Pass>
+long long transfer(size_t count, int producers, Pass pass)
+{
+  auto start = std::chrono::steady_clock::now();
+  pass(count, producers);
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+// 启动生产者、消费者线程并等待它们结束
+template <class Produce, class Consume>
+void run_threads(int producers, Produce produce, Consume consume)
+{
+  std::vector<std::thread> threads;
+  for (int i = 0; i < producers; ++i)
+  {
+    threads.push_back(std::thread(produce, i));
+    threads.push_back(std::thread(consume));
+  }
+  for (auto& t : threads)
+    t.join();
+}
+
+// 用互斥量保护的 mystl::queue
+void locked_queue_pass(size_t count, int producers)
+{
+  mystl::queue<int> q;
+  std::mutex m;
+  std::atomic<size_t> consumed(0);
+  const size_t each = count / producers;
+  run_threads(producers, [&](int) {
+    for (size_t i = 0; i < each; ++i)
+    {
+      std::lock_guard<std::mutex> lock(m);
+      q.push(static_cast<int>(i));
+    }
+  }, [&]() {
+    while (consumed.load(std::memory_order_relaxed) < each * producers)
+    {
+      bool popped = false;
+      {
+        std::lock_guard<std::mutex> lock(m);
+        if (!q.empty())
+        {
+          q.pop();
+          popped = true;
+        }
+      }
+      if (popped)
+        consumed.fetch_add(1, std::memory_order_relaxed);
+      else
+        std::this_thread::yield();
+    }
+  });
+}
+
+void mpmc_pass(size_t count, int producers)
+{
+  mystl::mpmc_queue<int> q(1024);
+  std::atomic<size_t> consumed(0);
+  const size_t each = count / producers;
+  run_threads(producers, [&](int) {
+    for (size_t i = 0; i < each; ++i)
+    {
+      while (!q.try_push(static_cast<int>(i)))
+        std::this_thread::yield();
+    }
+  }, [&]() {
+    int x;
+    while (consumed.load(std::memory_order_relaxed) < each * producers)
+    {
+      if (q.try_pop(x))
+        consumed.fetch_add(1, std::memory_order_relaxed);
+      else
+        std::this_thread::yield();
+    }
+  });
+}
+
+void mpmc_batch_pass(size_t count, int producers)
+{
+  mystl::mpmc_queue<int> q(1024);
+  std::atomic<size_t> consumed(0);
+  const size_t each = count / producers;
+  run_threads(producers, [&](int) {
+    int buf[32];
+    for (size_t i = 0; i < each; )
+    {
+      const size_t n = each - i < 32 ? each - i : 32;
+      for (size_t j = 0; j < n; ++j)
+        buf[j] = static_cast<int>(i + j);
+      for (size_t done = 0; done < n; )
+      {
+        const size_t k = q.try_push_n(buf + done, n - done);
+        done += k;
+        if (k == 0)
+          std::this_thread::yield();
+      }
+      i += n;
+    }
+  }, [&]() {
+    int buf[32];
+    while (consumed.load(std::memory_order_relaxed) < each * producers)
+    {
+      const size_t k = q.try_pop_n(buf, 32);
+      if (k != 0)
+        consumed.fetch_add(k, std::memory_order_relaxed);
+      else
+        std::this_thread::yield();
+    }
+  });
+}
+
+#define MPMC_QUEUE_TEST(pass, count, producers) do {       \
+  char buf[10];                                           \
+  int n = static_cast<int>(transfer(count, producers, pass)); \
+  std::snprintf(buf, sizeof(buf), "%d", n);               \
+  std::string t = buf;                                    \
+  t += "ms    |";                                         \
+  std::cout << std::setw(WIDE) << t;                      \
+} while(0)
+
+#define MPMC_QUEUE_ROW(count, producers) do {             \
+  MPMC_QUEUE_TEST(locked_queue_pass, count, producers);   \
+  MPMC_QUEUE_TEST(mpmc_pass, count, producers);           \
+  MPMC_QUEUE_TEST(mpmc_batch_pass, count, producers);     \
+  std::cout << std::endl;                                 \
+} while(0)
+
+void mpmc_queue_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[--------------- Run container test : mpmc_queue ---------------]" << std::endl;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+#if LARGER_TEST_DATA_ON
+  std::cout << "| " << SCALE_L(LEN2) << " ints, wall  |";
+#else
+  std::cout << "| " << SCALE_M(LEN2) << " ints, wall  |";
+#endif
+  std::cout << " mutex+queue |  mpmc_queue | mpmc, batch |" << std::endl;
+  const int threads[] = { 1, 2, 4, 8 };
+  for (int p : threads)
+  {
+    char label[32];
+    std::snprintf(label, sizeof(label), "|  %d + %d threads", p, p);
+    std::cout << std::setw(22) << std::left << label << std::right << "|";
+#if LARGER_TEST_DATA_ON
+    MPMC_QUEUE_ROW(SCALE_L(LEN2), p);
+#else
+    MPMC_QUEUE_ROW(SCALE_M(LEN2), p);
+#endif
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[--------------- End container test : mpmc_queue ---------------]" << std::endl;
+}
+
+} // namespace mpmc_queue_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_MPMC_QUEUE_TEST_H_
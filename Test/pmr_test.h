@@ -0,0 +1,313 @@
+#ifndef MYTINYSTL_PMR_TEST_H_
+#define MYTINYSTL_PMR_TEST_H_
+
+// pmr test : 测试 memory_resource、polymorphic_allocator 的接口，以及 pmr 容器在内存资源上分配的性能
+
+#include <map>
+#include <string>
+
+#include "../MyTinySTL/pmr.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace pmr_test
+{
+
+// 记录分配情况的内存资源，实际内存来自 new_delete_resource
+class counting_resource : public mystl::pmr::memory_resource
+{
+public:
+  long allocs = 0;
+  long deallocs = 0;
+  long live_bytes = 0;
+
+private:
+  void* do_allocate(size_t bytes, size_t align) override
+  {
+    ++allocs;
+    live_bytes += static_cast<long>(bytes);
+    return mystl::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t align) override
+  {
+    ++deallocs;
+    live_bytes -= static_cast<long>(bytes);
+    mystl::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+
+  bool do_is_equal(const mystl::pmr::memory_resource& other) const noexcept override
+  { return this == &other; }
+};
+
+inline bool is_aligned(void* p, size_t align)
+{
+  return (reinterpret_cast<uintptr_t>(p) & (align - 1)) == 0;
+}
+
+TEST(new_delete_resource_test)
+{
+  mystl::pmr::memory_resource* r = mystl::pmr::new_delete_resource();
+  EXPECT_TRUE(r == mystl::pmr::get_default_resource());
+  EXPECT_TRUE(*r == *mystl::pmr::new_delete_resource());
+  EXPECT_TRUE(*r != *mystl::pmr::null_memory_resource());
+  void* p = r->allocate(100, 128);
+  EXPECT_TRUE(is_aligned(p, 128));
+  r->deallocate(p, 100, 128);
+  bool thrown = false;
+  try
+  {
+    mystl::pmr::null_memory_resource()->allocate(8);
+  }
+  catch (const std::bad_alloc&)
+  {
+    thrown = true;
+  }
+  EXPECT_TRUE(thrown);
+}
+
+TEST(monotonic_buffer_resource_test)
+{
+  counting_resource up;
+  {
+    mystl::pmr::monotonic_buffer_resource mr(&up);
+    EXPECT_TRUE(mr.upstream_resource() == &up);
+    size_t aligns[] = { 1, 2, 4, 8, 16, 32, 64 };
+    for (int i = 0; i < 100; ++i)
+    {
+      const size_t a = aligns[i % 7];
+      void* p = mr.allocate(static_cast<size_t>(i % 13) + 1, a);
+      EXPECT_TRUE(is_aligned(p, a));
+      mr.deallocate(p, static_cast<size_t>(i % 13) + 1, a);
+    }
+    EXPECT_EQ(0, up.deallocs);
+    mr.allocate(100000);
+    const long n = up.allocs;
+    EXPECT_TRUE(n > 1);
+    mr.release();
+    EXPECT_EQ(n, up.deallocs);
+    EXPECT_EQ(0, up.live_bytes);
+    mr.allocate(16);
+  }
+  EXPECT_EQ(0, up.live_bytes);
+  EXPECT_EQ(up.allocs, up.deallocs);
+
+  // 给定初始缓冲区，用完后才向上游申请
+  alignas(16) char buf[256];
+  mystl::pmr::monotonic_buffer_resource mr(buf, sizeof(buf), mystl::pmr::null_memory_resource());
+  char* p = static_cast<char*>(mr.allocate(200, 1));
+  EXPECT_TRUE(p >= buf && p + 200 <= buf + sizeof(buf));
+  bool thrown = false;
+  try
+  {
+    mr.allocate(100, 1);
+  }
+  catch (const std::bad_alloc&)
+  {
+    thrown = true;
+  }
+  EXPECT_TRUE(thrown);
+  mr.release();
+  EXPECT_TRUE(mr.allocate(200, 1) == p);
+}
+
+TEST(unsynchronized_pool_resource_test)
+{
+  counting_resource up;
+  {
+    mystl::pmr::pool_options opts;
+    opts.max_blocks_per_chunk = 64;
+    opts.largest_required_pool_block = 500;
+    mystl::pmr::unsynchronized_pool_resource mr(opts, &up);
+    EXPECT_EQ(64, mr.options().max_blocks_per_chunk);
+    EXPECT_EQ(512, mr.options().largest_required_pool_block);
+
+    // 回收的区块被下一次同等大小的请求复用
+    void* p = mr.allocate(24, 8);
+    mr.deallocate(p, 24, 8);
+    EXPECT_TRUE(mr.allocate(30, 8) == p);
+
+    void* blocks[1000];
+    for (int i = 0; i < 1000; ++i)
+    {
+      blocks[i] = mr.allocate(static_cast<size_t>(i % 64) + 1, 8);
+      EXPECT_TRUE(is_aligned(blocks[i], 8));
+    }
+    for (int i = 0; i < 1000; i += 2)
+      mr.deallocate(blocks[i], static_cast<size_t>(i % 64) + 1, 8);
+    const long n = up.allocs;
+    for (int i = 0; i < 1000; i += 2)
+      blocks[i] = mr.allocate(static_cast<size_t>(i % 64) + 1, 8);
+    EXPECT_EQ(n, up.allocs);
+
+    // 大块与高对齐的请求直接转交上游
+    void* big = mr.allocate(10000, 8);
+    void* over = mr.allocate(64, 256);
+    EXPECT_TRUE(is_aligned(over, 256));
+    EXPECT_EQ(n + 2, up.allocs);
+    mr.deallocate(big, 10000, 8);
+    EXPECT_EQ(1, up.deallocs);
+    mr.allocate(20000, 8);
+
+    mr.release();
+    EXPECT_EQ(up.allocs - 1, up.deallocs);  // 只剩等级表本身
+  }
+  EXPECT_EQ(0, up.live_bytes);
+}
+
+TEST(polymorphic_allocator_test)
+{
+  counting_resource def;
+  mystl::pmr::memory_resource* old = mystl::pmr::set_default_resource(&def);
+  {
+    counting_resource up;
+    mystl::pmr::monotonic_buffer_resource arena(&up);
+    mystl::pmr::polymorphic_allocator<int> a(&arena);
+    mystl::pmr::polymorphic_allocator<double> b(a);
+    EXPECT_TRUE(a == b);
+    EXPECT_TRUE(b.resource() == &arena);
+    EXPECT_TRUE(a != mystl::pmr::polymorphic_allocator<int>());
+
+    mystl::pmr::vector<int> v(&arena);
+    for (int i = 0; i < 1000; ++i)
+      v.push_back(i);
+    EXPECT_EQ(999, v.back());
+
+    // 嵌套的 pmr::string 也在 arena 上分配
+    mystl::pmr::map<mystl::pmr::string, mystl::pmr::string> m(&arena);
+    m.emplace("key1", "value1");
+    m.emplace("key2", "value2");
+    m.insert(mystl::make_pair(mystl::pmr::string("key3", &arena), mystl::pmr::string("value3", &arena)));
+    EXPECT_EQ(3, m.size());
+    EXPECT_TRUE(m.begin()->first.get_allocator() == a);
+    EXPECT_TRUE(m.begin()->second.get_allocator() == a);
+    EXPECT_EQ(0, m.begin()->second.compare("value1"));
+
+    mystl::pmr::unordered_map<mystl::pmr::string, int> um(&arena);
+    for (int i = 0; i < 100; ++i)
+    {
+      char buf[16];
+      std::snprintf(buf, sizeof(buf), "k%d", i);
+      um.emplace(buf, i);
+    }
+    EXPECT_EQ(100, um.size());
+    EXPECT_EQ(42, um.find(mystl::pmr::string("k42", &arena))->second);
+    EXPECT_EQ(0, def.allocs);
+
+    // 拷贝构造的容器使用缺省资源
+    mystl::pmr::vector<int> v2(v);
+    EXPECT_TRUE(v2.get_allocator().resource() == &def);
+    EXPECT_TRUE(v2 == v);
+    mystl::pmr::list<int> l(&arena);
+    l.push_back(1);
+    EXPECT_EQ(1, l.front());
+    mystl::pmr::deque<int> d(&arena);
+    d.push_front(1);
+    EXPECT_EQ(1, d.front());
+  }
+  EXPECT_EQ(0, def.live_bytes);
+  mystl::pmr::set_default_resource(old);
+  EXPECT_TRUE(mystl::pmr::get_default_resource() == old);
+}
+
+// 模拟请求处理：每一轮构建一个小 map 后丢弃
+template <class Map, class String>
+void map_build_std(size_t count)
+{
+  for (size_t i = 0; i < count; i += 64)
+  {
+    Map m;
+    for (size_t j = 0; j < 64; ++j)
+      m.emplace(String("request-header-key-") + String(1, static_cast<char>('a' + j % 26)),
+                static_cast<int>(j));
+  }
+}
+
+void map_build_mystl(size_t count)
+{
+  map_build_std<mystl::map<mystl::string, int>, mystl::string>(count);
+}
+
+void map_build_pmr(size_t count)
+{
+  char buf[16384];
+  mystl::pmr::monotonic_buffer_resource arena(buf, sizeof(buf));
+  for (size_t i = 0; i < count; i += 64)
+  {
+    {
+      mystl::pmr::map<mystl::pmr::string, int> m(&arena);
+      for (size_t j = 0; j < 64; ++j)
+      {
+        mystl::pmr::string key("request-header-key-", &arena);
+        key.push_back(static_cast<char>('a' + j % 26));
+        m.emplace(mystl::move(key), static_cast<int>(j));
+      }
+    }
+    arena.release();
+  }
+}
+
+#define PMR_MAP_TEST(fun, count) do {                     \
+  char buf[10];                                           \
+  clock_t start = clock();                                \
+  fun(count);                                             \
+  clock_t end = clock();                                  \
+  int n = static_cast<int>(static_cast<double>(end - start) \
+      / CLOCKS_PER_SEC * 1000);                           \
+  std::snprintf(buf, sizeof(buf), "%d", n);               \
+  std::string t = buf;                                    \
+  t += "ms    |";                                         \
+  std::cout << std::setw(WIDE) << t;                      \
+} while(0)
+
+void pmr_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------------- Run container test : pmr ------------------]" << std::endl;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  build map<string>  |";
+#if LARGER_TEST_DATA_ON
+  TEST_LEN(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3), WIDE);
+  std::cout << "|         std         |";
+  PMR_MAP_TEST((map_build_std<std::map<std::string, int>, std::string>), SCALE_M(LEN1));
+  PMR_MAP_TEST((map_build_std<std::map<std::string, int>, std::string>), SCALE_M(LEN2));
+  PMR_MAP_TEST((map_build_std<std::map<std::string, int>, std::string>), SCALE_M(LEN3));
+  std::cout << "\n|        mystl        |";
+  PMR_MAP_TEST(map_build_mystl, SCALE_M(LEN1));
+  PMR_MAP_TEST(map_build_mystl, SCALE_M(LEN2));
+  PMR_MAP_TEST(map_build_mystl, SCALE_M(LEN3));
+  std::cout << "\n|   mystl monotonic   |";
+  PMR_MAP_TEST(map_build_pmr, SCALE_M(LEN1));
+  PMR_MAP_TEST(map_build_pmr, SCALE_M(LEN2));
+  PMR_MAP_TEST(map_build_pmr, SCALE_M(LEN3));
+#else
+  TEST_LEN(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3), WIDE);
+  std::cout << "|         std         |";
+  PMR_MAP_TEST((map_build_std<std::map<std::string, int>, std::string>), SCALE_S(LEN1));
+  PMR_MAP_TEST((map_build_std<std::map<std::string, int>, std::string>), SCALE_S(LEN2));
+  PMR_MAP_TEST((map_build_std<std::map<std::string, int>, std::string>), SCALE_S(LEN3));
+  std::cout << "\n|        mystl        |";
+  PMR_MAP_TEST(map_build_mystl, SCALE_S(LEN1));
+  PMR_MAP_TEST(map_build_mystl, SCALE_S(LEN2));
+  PMR_MAP_TEST(map_build_mystl, SCALE_S(LEN3));
+  std::cout << "\n|   mystl monotonic   |";
+  PMR_MAP_TEST(map_build_pmr, SCALE_S(LEN1));
+  PMR_MAP_TEST(map_build_pmr, SCALE_S(LEN2));
+  PMR_MAP_TEST(map_build_pmr, SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------------------- End container test : pmr ------------------]" << std::endl;
+}
+
+} // namespace pmr_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_PMR_TEST_H_
@@ -0,0 +1,330 @@
+#ifndef MYTINYSTL_RELOCATE_TEST_H_
+#define MYTINYSTL_RELOCATE_TEST_H_
+
+// relocate test : 测试 is_trivially_relocatable，以及 vector、deque 按字节搬移元素的正确性与性能
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "../MyTinySTL/astring.h"
+#include "../MyTinySTL/deque.h"
+#include "../MyTinySTL/list.h"
+#include "../MyTinySTL/map.h"
+#include "../MyTinySTL/unordered_map.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace relocate_test
+{
+
+// 保存指向自身的指针，不能平凡重定位
+struct self_ref
+{
+  self_ref* self;
+  int       value;
+
+  self_ref(int v = 0) : self(this), value(v) {}
+  self_ref(const self_ref& rhs) : self(this), value(rhs.value) {}
+  self_ref& operator=(const self_ref& rhs) { value = rhs.value; return *this; }
+  ~self_ref() { self = nullptr; }
+
+  bool ok() const { return self == this; }
+};
+
+// 拥有一块堆内存的句柄，移动时会被计数，特化后可以平凡重定位
+struct handle
+{
+  static int moves;
+  static int live;
+
+  int* p;
+
+  handle(int v = 0) : p(new int(v)) { ++live; }
+  handle(const handle& rhs) : p(new int(*rhs.p)) { ++live; }
+  handle(handle&& rhs) noexcept : p(rhs.p) { rhs.p = nullptr; ++moves; ++live; }
+  handle& operator=(const handle& rhs) { *p = *rhs.p; return *this; }
+  handle& operator=(handle&& rhs) noexcept
+  {
+    mystl::swap(p, rhs.p);
+    ++moves;
+    return *this;
+  }
+  ~handle() { delete p; --live; }
+
+  int value() const { return *p; }
+};
+
+int handle::moves = 0;
+int handle::live = 0;
+
+} // namespace relocate_test
+} // namespace test
+
+template <>
+struct is_trivially_relocatable<test::relocate_test::handle> : m_true_type {};
+
+namespace test
+{
+namespace relocate_test
+{
+
+TEST(is_trivially_relocatable_test)
+{
+  EXPECT_TRUE(mystl::is_trivially_relocatable<int>::value);
+  EXPECT_TRUE((mystl::is_trivially_relocatable<mystl::pair<int, double>>::value));
+  EXPECT_TRUE(mystl::is_trivially_relocatable<mystl::string>::value);
+  EXPECT_TRUE(mystl::is_trivially_relocatable<mystl::vector<mystl::string>>::value);
+  EXPECT_TRUE(mystl::is_trivially_relocatable<mystl::deque<int>>::value);
+  EXPECT_TRUE(mystl::is_trivially_relocatable<mystl::list<int>>::value);
+  EXPECT_TRUE((mystl::is_trivially_relocatable<mystl::map<int, mystl::string>>::value));
+  EXPECT_TRUE((mystl::is_trivially_relocatable<mystl::unordered_map<int, int>>::value));
+  EXPECT_TRUE((mystl::is_trivially_relocatable<mystl::pair<mystl::string, handle>>::value));
+  EXPECT_TRUE(!mystl::is_trivially_relocatable<self_ref>::value);
+  EXPECT_TRUE((!mystl::is_trivially_relocatable<mystl::pair<int, self_ref>>::value));
+}
+
+// 与 std::vector<std::string> 做同样的操作，比较结果
+template <class V1, class V2>
+bool same_strings(const V1& lhs, const V2& rhs)
+{
+  if (lhs.size() != rhs.size())
+    return false;
+  auto j = rhs.begin();
+  for (auto i = lhs.begin(); i != lhs.end(); ++i, ++j)
+  {
+    if (std::string(i->c_str()) != *j)
+      return false;
+  }
+  return true;
+}
+
+template <class MyContainer, class StdContainer>
+void string_sequence_ops(MyContainer& a, StdContainer& b)
+{
+  for (int i = 0; i < 300; ++i)
+  {
+    const std::string s = "string-" + std::to_string(i * 7919 % 1000);
+    switch (i % 6)
+    {
+    case 0:
+    case 1:
+      a.push_back(mystl::string(s.c_str()));
+      b.push_back(s);
+      break;
+    case 2:
+      a.insert(a.begin() + i % (a.size() + 1), mystl::string(s.c_str()));
+      b.insert(b.begin() + i % (b.size() + 1), s);
+      break;
+    case 3:
+      a.insert(a.begin() + a.size() / 3, 5, mystl::string(s.c_str()));
+      b.insert(b.begin() + b.size() / 3, 5, s);
+      break;
+    case 4:
+      a.erase(a.begin() + i % a.size());
+      b.erase(b.begin() + i % b.size());
+      break;
+    default:
+      a.erase(a.begin() + a.size() / 2, a.begin() + a.size() / 2 + 3);
+      b.erase(b.begin() + b.size() / 2, b.begin() + b.size() / 2 + 3);
+      break;
+    }
+  }
+  // 插入容器自身的元素
+  a.insert(a.begin() + 1, a[a.size() - 1]);
+  b.insert(b.begin() + 1, b[b.size() - 1]);
+  a.emplace(a.begin() + a.size() / 2, a.front());
+  b.emplace(b.begin() + b.size() / 2, b.front());
+}
+
+TEST(vector_relocate_test)
+{
+  mystl::vector<mystl::string> a;
+  std::vector<std::string> b;
+  string_sequence_ops(a, b);
+  mystl::string arr[] = { "x", "y", "z" };
+  a.insert(a.begin() + 7, arr, arr + 3);
+  b.insert(b.begin() + 7, { "x", "y", "z" });
+  EXPECT_TRUE(same_strings(a, b));
+  a.shrink_to_fit();
+  a.reserve(a.size() * 3);
+  EXPECT_TRUE(same_strings(a, b));
+
+  // 可以平凡重定位的元素在扩容、插入、删除时不会被逐个移动
+  handle::moves = 0;
+  {
+    mystl::vector<handle> h;
+    for (int i = 0; i < 1000; ++i)
+      h.emplace_back(i);
+    h.insert(h.begin(), handle(-1));
+    h.erase(h.begin() + 10, h.begin() + 20);
+    h.erase(h.begin());
+    h.shrink_to_fit();
+    EXPECT_TRUE(handle::moves <= 2);  // 只有插入临时对象时的移动
+    EXPECT_EQ(990, handle::live);
+    EXPECT_EQ(0, h[0].value());
+    EXPECT_EQ(20, h[10].value());
+    EXPECT_EQ(999, h.back().value());
+  }
+  EXPECT_EQ(0, handle::live);
+
+  // 不能平凡重定位的元素仍然逐个移动
+  mystl::vector<self_ref> s;
+  for (int i = 0; i < 100; ++i)
+    s.insert(s.begin() + i / 2, self_ref(i));
+  s.erase(s.begin() + 3, s.begin() + 9);
+  bool ok = true;
+  for (auto& x : s)
+    ok = ok && x.ok();
+  EXPECT_TRUE(ok);
+}
+
+TEST(deque_relocate_test)
+{
+  mystl::deque<mystl::string> a;
+  std::deque<std::string> b;
+  string_sequence_ops(a, b);
+  EXPECT_TRUE(same_strings(a, b));
+  for (int i = 0; i < 2000; ++i)
+  {
+    a.insert(a.begin() + a.size() / 4, mystl::string("front"));
+    b.insert(b.begin() + b.size() / 4, std::string("front"));
+    a.insert(a.end() - a.size() / 4, mystl::string("back"));
+    b.insert(b.end() - b.size() / 4, std::string("back"));
+  }
+  EXPECT_TRUE(same_strings(a, b));
+  a.erase(a.begin() + 100, a.begin() + 1500);
+  b.erase(b.begin() + 100, b.begin() + 1500);
+  a.erase(a.end() - 1500, a.end() - 100);
+  b.erase(b.end() - 1500, b.end() - 100);
+  EXPECT_TRUE(same_strings(a, b));
+
+  handle::moves = 0;
+  {
+    mystl::deque<handle> h;
+    for (int i = 0; i < 1000; ++i)
+      h.emplace_back(i);
+    h.emplace(h.begin() + 300, -1);
+    h.erase(h.begin() + 10, h.begin() + 20);
+    h.erase(h.begin() + 700);
+    EXPECT_EQ(1, handle::moves);  // 只有把临时对象移入空位时的一次移动
+    EXPECT_EQ(990, handle::live);
+    EXPECT_EQ(-1, h[290].value());
+    EXPECT_EQ(999, h.back().value());
+  }
+  EXPECT_EQ(0, handle::live);
+
+  mystl::deque<self_ref> s;
+  for (int i = 0; i < 1000; ++i)
+    s.insert(s.begin() + i / 2, self_ref(i));
+  s.erase(s.begin() + 3, s.begin() + 90);
+  bool ok = true;
+  for (auto& x : s)
+    ok = ok && x.ok();
+  EXPECT_TRUE(ok);
+}
+
+// 声明了移动构造函数的字符串包装，不能平凡重定位，用于对比
+struct moved_string
+{
+  mystl::string s;
+
+  moved_string(const char* p = "") : s(p) {}
+  moved_string(const moved_string& rhs) : s(rhs.s) {}
+  moved_string(moved_string&& rhs) noexcept : s(mystl::move(rhs.s)) {}
+  moved_string& operator=(const moved_string& rhs) { s = rhs.s; return *this; }
+  moved_string& operator=(moved_string&& rhs) noexcept { s = mystl::move(rhs.s); return *this; }
+};
+
+// 先增长到 count 个元素，再从中间逐个删除 200 个
+template <class Container, class Value>
+void grow_and_erase(size_t count)
+{
+  Container c;
+  for (size_t i = 0; i < count; ++i)
+    c.push_back(Value("relocate"));
+  for (size_t i = 0; i < count / 2 && i < 200; ++i)
+    c.erase(c.begin() + c.size() / 2);
+}
+
+#define RELOCATE_TEST(con, val, count) do {               \
+  char buf[10];                                           \
+  clock_t start = clock();                                \
+  grow_and_erase<con, val>(count);                        \
+  clock_t end = clock();                                  \
+  int n = static_cast<int>(static_cast<double>(end - start) \
+      / CLOCKS_PER_SEC * 1000);                           \
+  std::snprintf(buf, sizeof(buf), "%d", n);               \
+  std::string t = buf;                                    \
+  t += "ms    |";                                         \
+  std::cout << std::setw(WIDE) << t;                      \
+} while(0)
+
+void relocate_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[----------------- Run container test : relocate ---------------]" << std::endl;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|vector<string> erase |";
+#if LARGER_TEST_DATA_ON
+  TEST_LEN(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3), WIDE);
+  std::cout << "|         move        |";
+  RELOCATE_TEST(mystl::vector<moved_string>, moved_string, SCALE_M(LEN1));
+  RELOCATE_TEST(mystl::vector<moved_string>, moved_string, SCALE_M(LEN2));
+  RELOCATE_TEST(mystl::vector<moved_string>, moved_string, SCALE_M(LEN3));
+  std::cout << "\n|       relocate      |";
+  RELOCATE_TEST(mystl::vector<mystl::string>, mystl::string, SCALE_M(LEN1));
+  RELOCATE_TEST(mystl::vector<mystl::string>, mystl::string, SCALE_M(LEN2));
+  RELOCATE_TEST(mystl::vector<mystl::string>, mystl::string, SCALE_M(LEN3));
+#else
+  TEST_LEN(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3), WIDE);
+  std::cout << "|         move        |";
+  RELOCATE_TEST(mystl::vector<moved_string>, moved_string, SCALE_S(LEN1));
+  RELOCATE_TEST(mystl::vector<moved_string>, moved_string, SCALE_S(LEN2));
+  RELOCATE_TEST(mystl::vector<moved_string>, moved_string, SCALE_S(LEN3));
+  std::cout << "\n|       relocate      |";
+  RELOCATE_TEST(mystl::vector<mystl::string>, mystl::string, SCALE_S(LEN1));
+  RELOCATE_TEST(mystl::vector<mystl::string>, mystl::string, SCALE_S(LEN2));
+  RELOCATE_TEST(mystl::vector<mystl::string>, mystl::string, SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|deque<string> erase  |";
+#if LARGER_TEST_DATA_ON
+  TEST_LEN(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3), WIDE);
+  std::cout << "|         move        |";
+  RELOCATE_TEST(mystl::deque<moved_string>, moved_string, SCALE_M(LEN1));
+  RELOCATE_TEST(mystl::deque<moved_string>, moved_string, SCALE_M(LEN2));
+  RELOCATE_TEST(mystl::deque<moved_string>, moved_string, SCALE_M(LEN3));
+  std::cout << "\n|       relocate      |";
+  RELOCATE_TEST(mystl::deque<mystl::string>, mystl::string, SCALE_M(LEN1));
+  RELOCATE_TEST(mystl::deque<mystl::string>, mystl::string, SCALE_M(LEN2));
+  RELOCATE_TEST(mystl::deque<mystl::string>, mystl::string, SCALE_M(LEN3));
+#else
+  TEST_LEN(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3), WIDE);
+  std::cout << "|         move        |";
+  RELOCATE_TEST(mystl::deque<moved_string>, moved_string, SCALE_S(LEN1));
+  RELOCATE_TEST(mystl::deque<moved_string>, moved_string, SCALE_S(LEN2));
+  RELOCATE_TEST(mystl::deque<moved_string>, moved_string, SCALE_S(LEN3));
+  std::cout << "\n|       relocate      |";
+  RELOCATE_TEST(mystl::deque<mystl::string>, mystl::string, SCALE_S(LEN1));
+  RELOCATE_TEST(mystl::deque<mystl::string>, mystl::string, SCALE_S(LEN2));
+  RELOCATE_TEST(mystl::deque<mystl::string>, mystl::string, SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[----------------- End container test : relocate ---------------]" << std::endl;
+}
+
+} // namespace relocate_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_RELOCATE_TEST_H_
@@ -0,0 +1,202 @@
+#ifndef MYTINYSTL_SMALL_VECTOR_TEST_H_
+#define MYTINYSTL_SMALL_VECTOR_TEST_H_
+
+// small_vector test : 测试 small_vector 的接口，以及大量短小向量的构造性能
+
+#include <vector>
+
+#include "../MyTinySTL/astring.h"
+#include "../MyTinySTL/small_vector.h"
+#include "../MyTinySTL/tracking_allocator.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace small_vector_test
+{
+
+TEST(small_vector_inline_test)
+{
+  allocation_stats stats;
+  typedef tracking_allocator<int> alloc_type;
+  mystl::small_vector<int, 8, alloc_type> v((alloc_type(&stats)));
+  EXPECT_TRUE(v.is_inline());
+  EXPECT_EQ(8, v.capacity());
+  for (int i = 0; i < 8; ++i)
+    v.push_back(i);
+  EXPECT_TRUE(v.is_inline());
+  EXPECT_EQ(0, stats.allocations);
+  EXPECT_EQ(0, v.memory_usage().total());
+  v.push_back(8);
+  EXPECT_TRUE(!v.is_inline());
+  EXPECT_EQ(1, stats.allocations);
+  EXPECT_EQ(16, v.capacity());
+  for (int i = 0; i < 9; ++i)
+    EXPECT_EQ(i, v[i]);
+  v.erase(v.begin() + 4, v.end());
+  v.shrink_to_fit();
+  EXPECT_TRUE(v.is_inline());
+  EXPECT_EQ(0, stats.live_bytes);
+  EXPECT_EQ(3, v.back());
+}
+
+TEST(small_vector_modify_test)
+{
+  int a[] = { 1,2,3,4,5 };
+  mystl::small_vector<int, 4> v1;
+  mystl::small_vector<int, 4> v2(10, 1);
+  mystl::small_vector<int, 4> v3(a, a + 5);
+  mystl::small_vector<int, 4> v4{ 1,2,3 };
+  mystl::vector<int> expect;
+  EXPECT_EQ(10, v2.size());
+  EXPECT_EQ(5, v3.size());
+  EXPECT_TRUE(v4.is_inline());
+
+  v1.assign(a, a + 3);
+  v1.emplace(v1.begin(), 0);
+  v1.insert(v1.begin() + 2, 2, 7);
+  v1.insert(v1.end(), a, a + 2);
+  v1.push_back(v1[0]);
+  expect = { 0,1,7,7,2,3,1,2,0 };
+  EXPECT_TRUE(mystl::equal(v1.begin(), v1.end(), expect.begin()));
+  EXPECT_EQ(expect.size(), v1.size());
+
+  v1.erase(v1.begin() + 1);
+  v1.erase(v1.begin(), v1.begin() + 2);
+  v1.pop_back();
+  expect = { 7,2,3,1,2 };
+  EXPECT_TRUE(mystl::equal(v1.begin(), v1.end(), expect.begin()));
+
+  v1.resize(2);
+  v1.resize(4, 9);
+  v1.reverse();
+  expect = { 9,9,2,7 };
+  EXPECT_TRUE(mystl::equal(v1.begin(), v1.end(), expect.begin()));
+  EXPECT_EQ(4, v1.size());
+
+  // 插入的值引用自身的元素，扩容后依然正确
+  v1.insert(v1.begin(), 3, v1.back());
+  expect = { 7,7,7,9,9,2,7 };
+  EXPECT_TRUE(mystl::equal(v1.begin(), v1.end(), expect.begin()));
+
+  v1.clear();
+  EXPECT_TRUE(v1.empty());
+  v1 = { 5,6 };
+  EXPECT_EQ(2, v1.size());
+  EXPECT_EQ(6, v1.at(1));
+}
+
+TEST(small_vector_move_swap_test)
+{
+  // 都在对象内部
+  mystl::small_vector<mystl::string, 4> a{ "a", "b", "c" };
+  mystl::small_vector<mystl::string, 4> b{ "x" };
+  a.swap(b);
+  EXPECT_EQ(1, a.size());
+  EXPECT_EQ(3, b.size());
+  EXPECT_EQ(0, a[0].compare("x"));
+  EXPECT_EQ(0, b[2].compare("c"));
+
+  // 一方在堆上
+  mystl::small_vector<mystl::string, 4> c{ "1", "2", "3", "4", "5", "6" };
+  EXPECT_TRUE(!c.is_inline());
+  mystl::swap(a, c);
+  EXPECT_TRUE(!a.is_inline());
+  EXPECT_TRUE(c.is_inline());
+  EXPECT_EQ(6, a.size());
+  EXPECT_EQ(0, c[0].compare("x"));
+
+  // 移动：堆上的空间直接接管，对象内部的元素逐个搬移
+  const mystl::string* p = a.data();
+  mystl::small_vector<mystl::string, 4> d(mystl::move(a));
+  EXPECT_EQ(p, d.data());
+  EXPECT_TRUE(a.empty());
+  EXPECT_TRUE(a.is_inline());
+  mystl::small_vector<mystl::string, 4> e;
+  e = mystl::move(b);
+  EXPECT_EQ(3, e.size());
+  EXPECT_TRUE(b.empty());
+  EXPECT_EQ(0, e[1].compare("b"));
+
+  mystl::small_vector<mystl::string, 4> f(d);
+  EXPECT_TRUE(f == d);
+  f.back() = "z";
+  EXPECT_TRUE(d < f);
+  f = e;
+  EXPECT_TRUE(f == e);
+}
+
+typedef mystl::small_vector<int, 8> small_vector8;
+
+// 构造 count 个短小的向量，每个向量有 len 个元素
+template <class Vec>
+void small_lists(size_t count, int len)
+{
+  size_t sum = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    Vec v;
+    for (int j = 0; j < len; ++j)
+      v.push_back(j);
+    sum += v.size();
+  }
+  volatile size_t sink = sum;
+  (void)sink;
+}
+
+#define SMALL_VECTOR_TEST(vec, count) do {                \
+  char buf[10];                                           \
+  clock_t start = clock();                                \
+  small_lists<vec>(count, 5);                             \
+  clock_t end = clock();                                  \
+  int n = static_cast<int>(static_cast<double>(end - start) \
+      / CLOCKS_PER_SEC * 1000);                           \
+  std::snprintf(buf, sizeof(buf), "%d", n);               \
+  std::string t = buf;                                    \
+  t += "ms    |";                                         \
+  std::cout << std::setw(WIDE) << t;                      \
+} while(0)
+
+void small_vector_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[--------------- Run container test : small_vector -------------]" << std::endl;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  5 ints per vector  |";
+#if LARGER_TEST_DATA_ON
+  TEST_LEN(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3), WIDE);
+  std::cout << "|       vector        |";
+  SMALL_VECTOR_TEST(mystl::vector<int>, SCALE_M(LEN1));
+  SMALL_VECTOR_TEST(mystl::vector<int>, SCALE_M(LEN2));
+  SMALL_VECTOR_TEST(mystl::vector<int>, SCALE_M(LEN3));
+  std::cout << "\n|   small_vector<8>   |";
+  SMALL_VECTOR_TEST(small_vector8, SCALE_M(LEN1));
+  SMALL_VECTOR_TEST(small_vector8, SCALE_M(LEN2));
+  SMALL_VECTOR_TEST(small_vector8, SCALE_M(LEN3));
+#else
+  TEST_LEN(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3), WIDE);
+  std::cout << "|       vector        |";
+  SMALL_VECTOR_TEST(mystl::vector<int>, SCALE_S(LEN1));
+  SMALL_VECTOR_TEST(mystl::vector<int>, SCALE_S(LEN2));
+  SMALL_VECTOR_TEST(mystl::vector<int>, SCALE_S(LEN3));
+  std::cout << "\n|   small_vector<8>   |";
+  SMALL_VECTOR_TEST(small_vector8, SCALE_S(LEN1));
+  SMALL_VECTOR_TEST(small_vector8, SCALE_S(LEN2));
+  SMALL_VECTOR_TEST(small_vector8, SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[--------------- End container test : small_vector -------------]" << std::endl;
+}
+
+} // namespace small_vector_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_SMALL_VECTOR_TEST_H_
@@ -0,0 +1,314 @@
+#ifndef MYTINYSTL_SOA_VECTOR_TEST_H_
+#define MYTINYSTL_SOA_VECTOR_TEST_H_
+
+// soa_vector test : 测试 soa_vector 的接口、代理迭代器与算法的配合，以及按列扫描的性能
+
+#include <cstdint>
+
+#include "../MyTinySTL/algorithm.h"
+#include "../MyTinySTL/astring.h"
+#include "../MyTinySTL/numeric.h"
+#include "../MyTinySTL/soa_vector.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace soa_vector_test
+{
+
+typedef mystl::soa_vector<int, double> soa_id_price;
+
+TEST(soa_vector_basic_test)
+{
+  soa_id_price v;
+  EXPECT_TRUE(v.empty());
+  for (int i = 0; i < 20; ++i)
+    v.emplace_back(i, i * 0.5);
+  v.push_back(soa_id_price::value_type(100, 1.5));
+  EXPECT_EQ(21, v.size());
+  EXPECT_EQ(100, mystl::get<0>(v.back()));
+  EXPECT_EQ(2.5, v[5].get<1>());
+  EXPECT_EQ(0, mystl::get<0>(v.front()));
+
+  // 每一列连续并且按缓存行对齐
+  auto ids = v.column<0>();
+  auto prices = v.column<1>();
+  EXPECT_EQ(21, ids.size());
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(ids.data()) % MYSTL_SOA_COLUMN_ALIGN);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(prices.data()) % MYSTL_SOA_COLUMN_ALIGN);
+  EXPECT_EQ(7, ids[7]);
+  prices[3] = 9.0;
+  EXPECT_EQ(9.0, mystl::get<1>(v[3]));
+
+  // 通过代理对象改写一行
+  v[0] = soa_id_price::value_type(-1, -1.0);
+  v[1] = v[2];
+  EXPECT_EQ(-1, mystl::get<0>(v[0]));
+  EXPECT_EQ(2, mystl::get<0>(v[1]));
+  soa_id_price::value_type row = v[4];
+  EXPECT_EQ(4, mystl::get<0>(row));
+  EXPECT_EQ(2.0, mystl::get<1>(row));
+
+  v.insert(v.begin() + 2, soa_id_price::value_type(50, 5.0));
+  EXPECT_EQ(50, mystl::get<0>(v[2]));
+  EXPECT_EQ(2, mystl::get<0>(v[3]));
+  v.erase(v.begin(), v.begin() + 2);
+  EXPECT_EQ(50, mystl::get<0>(v[0]));
+  EXPECT_EQ(20, v.size());
+  v.pop_back();
+  v.resize(25);
+  EXPECT_EQ(0, mystl::get<0>(v.back()));
+  v.resize(3);
+  v.shrink_to_fit();
+  EXPECT_EQ(3, v.capacity());
+  EXPECT_EQ(3 * (sizeof(int) + sizeof(double)), v.memory_usage().total());
+
+  // 插入时重新分配
+  v.insert(v.begin(), soa_id_price::value_type(7, 7.0));
+  EXPECT_EQ(4, v.size());
+  EXPECT_EQ(7, mystl::get<0>(v[0]));
+  EXPECT_EQ(50, mystl::get<0>(v[1]));
+
+  soa_id_price w{ { 1, 1.0 }, { 2, 2.0 } };
+  EXPECT_EQ(2, w.size());
+  EXPECT_TRUE(w != v);
+  soa_id_price c(v);
+  EXPECT_TRUE(c == v);
+  // 迭代器保存各列的地址，swap 之后依然指向原来的元素
+  auto it = c.begin();
+  c.swap(w);
+  EXPECT_EQ(7, mystl::get<0>(*it));
+  EXPECT_EQ(2, c.size());
+  soa_id_price m(mystl::move(w));
+  EXPECT_TRUE(w.empty());
+  EXPECT_TRUE(m == v);
+  m = c;
+  EXPECT_TRUE(m == c);
+  bool thrown = false;
+  try { m.at(2); }
+  catch (const std::out_of_range&) { thrown = true; }
+  EXPECT_TRUE(thrown);
+}
+
+TEST(soa_vector_algorithm_test)
+{
+  mystl::soa_vector<int, int> v;
+  mystl::vector<int> expect;
+  for (int i = 0; i < 1000; ++i)
+  {
+    int key = (i * 7919) % 1009;
+    v.emplace_back(key, -key);
+    expect.push_back(key);
+  }
+
+  // 按整行排序，第二列随行移动
+  mystl::sort(v.begin(), v.end());
+  mystl::sort(expect.begin(), expect.end());
+  EXPECT_CON_EQ(expect, v.column<0>());
+  bool rows_kept = true;
+  for (size_t i = 0; i < v.size(); ++i)
+    rows_kept = rows_kept && v[i].get<1>() == -v[i].get<0>();
+  EXPECT_TRUE(rows_kept);
+
+  typedef mystl::soa_vector<int, int>::value_type row_type;
+  mystl::sort(v.begin(), v.end(), [](const row_type& a, const row_type& b)
+              { return mystl::get<1>(a) < mystl::get<1>(b); });
+  EXPECT_TRUE(mystl::is_sorted(v.column<1>().begin(), v.column<1>().end()));
+  EXPECT_EQ(expect.back(), mystl::get<0>(v[0]));
+
+  typedef mystl::soa_vector<int, int>::const_reference cref;
+  auto it = mystl::find_if(v.begin(), v.end(), [](cref r) { return mystl::get<0>(r) == 500; });
+  EXPECT_TRUE(it != v.end());
+  EXPECT_EQ(-500, mystl::get<1>(*it));
+
+  long long sum = mystl::accumulate(v.begin(), v.end(), 0LL,
+                                    [](long long s, cref r) { return s + mystl::get<0>(r); });
+  EXPECT_EQ(mystl::accumulate(expect.begin(), expect.end(), 0LL), sum);
+
+  mystl::reverse(v.begin(), v.end());
+  EXPECT_TRUE(mystl::is_sorted(v.column<0>().begin(), v.column<0>().end()));
+  mystl::make_heap(v.begin(), v.end());
+  mystl::sort_heap(v.begin(), v.end());
+  EXPECT_CON_EQ(expect, v.column<0>());
+}
+
+TEST(soa_vector_rotate_numeric_test)
+{
+  typedef mystl::soa_vector<int, int>::value_type row_type;
+  mystl::soa_vector<int, int> v;
+  for (int i = 9; i >= 0; --i)
+    v.emplace_back(i, i * 10);
+
+  // 随机访问版本的 rotate 用一个临时的行保存被覆盖的元素
+  mystl::rotate(v.begin(), v.begin() + 3, v.end());
+  int rotated[] = { 6,5,4,3,2,1,0,9,8,7 };
+  EXPECT_CON_EQ(rotated, v.column<0>());
+  bool rows_kept = true;
+  for (size_t i = 0; i < v.size(); ++i)
+    rows_kept = rows_kept && v[i].get<1>() == v[i].get<0>() * 10;
+  EXPECT_TRUE(rows_kept);
+
+  // 数值算法保存的中间结果是行的副本，不能通过代理对象改写源区间
+  auto add = [](const row_type& a, const row_type& b)
+  { return row_type(mystl::get<0>(a) + mystl::get<0>(b), mystl::get<1>(a) + mystl::get<1>(b)); };
+  auto sub = [](const row_type& a, const row_type& b)
+  { return row_type(mystl::get<0>(a) - mystl::get<0>(b), mystl::get<1>(a) - mystl::get<1>(b)); };
+  mystl::vector<row_type> out(v.size());
+  mystl::partial_sum(v.begin(), v.end(), out.begin(), add);
+  EXPECT_CON_EQ(rotated, v.column<0>());
+  EXPECT_EQ(45, mystl::get<0>(out.back()));
+  EXPECT_EQ(450, mystl::get<1>(out.back()));
+  EXPECT_EQ(45, mystl::get<0>(mystl::accumulate(v.begin(), v.end(), row_type(0, 0), add)));
+
+  mystl::adjacent_difference(v.begin(), v.end(), out.begin(), sub);
+  EXPECT_CON_EQ(rotated, v.column<0>());
+  EXPECT_EQ(6, mystl::get<0>(out[0]));
+  EXPECT_EQ(-1, mystl::get<0>(out[1]));
+  EXPECT_EQ(9, mystl::get<0>(out[7]));
+}
+
+TEST(soa_vector_nontrivial_test)
+{
+  mystl::soa_vector<mystl::string, int> v;
+  v.emplace_back("pear", 3);
+  v.emplace_back("apple", 1);
+  v.push_back({ mystl::string("fig"), 2 });
+  v.insert(v.begin() + 1, { mystl::string("kiwi"), 4 });
+  for (int i = 0; i < 40; ++i)
+    v.emplace_back(mystl::string(10, static_cast<char>('a' + i % 26)), i);
+  EXPECT_EQ(44, v.size());
+  mystl::sort(v.begin(), v.begin() + 4);
+  EXPECT_EQ(0, v[0].get<0>().compare("apple"));
+  EXPECT_EQ(0, v[3].get<0>().compare("pear"));
+  EXPECT_EQ(3, v[3].get<1>());
+  v.erase(v.begin() + 4, v.end());
+  mystl::soa_vector<mystl::string, int> c(v);
+  EXPECT_TRUE(c == v);
+  c[0].get<0>() = "zebra";
+  EXPECT_TRUE(v < c);
+  c.clear();
+  EXPECT_TRUE(c.empty());
+}
+
+// 复制赋值会抛出异常，移动不会
+struct throw_on_copy
+{
+  int value;
+  throw_on_copy(int v = 0) :value(v) {}
+  throw_on_copy(const throw_on_copy& rhs) :value(rhs.value) {}
+  throw_on_copy(throw_on_copy&& rhs) noexcept :value(rhs.value) {}
+  throw_on_copy& operator=(const throw_on_copy&) { throw 1; }
+  throw_on_copy& operator=(throw_on_copy&& rhs) noexcept
+  { value = rhs.value; return *this; }
+};
+
+TEST(soa_vector_insert_throw_test)
+{
+  mystl::soa_vector<int, throw_on_copy> v;
+  for (int i = 0; i < 5; ++i)
+    v.emplace_back(i, throw_on_copy(i * 10));
+  const mystl::soa_vector<int, throw_on_copy>::value_type row(7, throw_on_copy(70));
+  bool thrown = false;
+  try
+  {
+    v.insert(v.begin() + 2, row);
+  }
+  catch (int)
+  {
+    thrown = true;
+  }
+  EXPECT_TRUE(thrown);
+  // 两列平移的行数相同，插入位置之后的行保持完整
+  EXPECT_EQ(6, v.size());
+  EXPECT_EQ(v.column<0>().size(), v.column<1>().size());
+  bool rows_kept = true;
+  for (size_t i = 3; i < v.size(); ++i)
+    rows_kept = rows_kept && v[i].get<1>().value == v[i].get<0>() * 10;
+  EXPECT_TRUE(rows_kept);
+  EXPECT_EQ(4, v.back().get<0>());
+}
+
+// 扫描一个字段的记录
+struct record
+{
+  int    id;
+  double price;
+  double qty;
+  long long ts;
+};
+
+// 对 count 条记录的 price 求和 passes 次
+void aos_scan(size_t count, int passes)
+{
+  char buf[10];
+  mystl::vector<record> v(count);
+  for (size_t i = 0; i < count; ++i)
+    v[i].price = static_cast<double>(i & 7);
+  double sum = 0.0;
+  clock_t start = clock();
+  for (int p = 0; p < passes; ++p)
+    for (size_t i = 0; i < count; ++i)
+      sum += v[i].price;
+  clock_t end = clock();
+  volatile double sink = sum;
+  (void)sink;
+  int n = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+  std::snprintf(buf, sizeof(buf), "%d", n);
+  std::string t = buf;
+  t += "ms    |";
+  std::cout << std::setw(WIDE) << t;
+}
+
+void soa_scan(size_t count, int passes)
+{
+  char buf[10];
+  mystl::soa_vector<int, double, double, long long> v(count);
+  auto prices = v.column<1>();
+  for (size_t i = 0; i < count; ++i)
+    prices[i] = static_cast<double>(i & 7);
+  double sum = 0.0;
+  clock_t start = clock();
+  for (int p = 0; p < passes; ++p)
+    for (size_t i = 0; i < count; ++i)
+      sum += prices[i];
+  clock_t end = clock();
+  volatile double sink = sum;
+  (void)sink;
+  int n = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+  std::snprintf(buf, sizeof(buf), "%d", n);
+  std::string t = buf;
+  t += "ms    |";
+  std::cout << std::setw(WIDE) << t;
+}
+
+void soa_vector_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[--------------- Run container test : soa_vector ---------------]" << std::endl;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "| scan 1 of 4 fields  |";
+  TEST_LEN(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3), WIDE);
+  std::cout << "|   vector<record>    |";
+  aos_scan(SCALE_S(LEN1), 20);
+  aos_scan(SCALE_S(LEN2), 20);
+  aos_scan(SCALE_S(LEN3), 20);
+  std::cout << "\n|     soa_vector      |";
+  soa_scan(SCALE_S(LEN1), 20);
+  soa_scan(SCALE_S(LEN2), 20);
+  soa_scan(SCALE_S(LEN3), 20);
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[--------------- End container test : soa_vector ---------------]" << std::endl;
+}
+
+} // namespace soa_vector_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_SOA_VECTOR_TEST_H_
@@ -0,0 +1,394 @@
+#ifndef MYTINYSTL_SPSC_QUEUE_TEST_H_
+#define MYTINYSTL_SPSC_QUEUE_TEST_H_
+
+// spsc_queue test : 测试 spsc_queue 的接口，以及与加锁的 queue 在两个线程之间传递元素的性能
+
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../MyTinySTL/astring.h"
+#include "../MyTinySTL/queue.h"
+#include "../MyTinySTL/spsc_queue.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace spsc_queue_test
+{
+
+// 记录存活个数的元素，复制次数用完时抛出异常
+struct counted
+{
+  static int live;
+  static int copy_budget;
+  int value;
+
+  counted(int v) : value(v) { ++live; }
+  counted(const counted& rhs) : value(rhs.value)
+  {
+    if (copy_budget-- == 0)
+      throw 0;
+    ++live;
+  }
+  counted& operator=(const counted& rhs) { value = rhs.value; return *this; }
+  ~counted() { --live; }
+};
+
+int counted::live = 0;
+int counted::copy_budget = -1;
+
+TEST(spsc_queue_basic_test)
+{
+  mystl::spsc_queue<int> q0(0);
+  mystl::spsc_queue<int> q1(5);
+  mystl::spsc_queue<int> q2(8);
+  EXPECT_EQ(1, q0.capacity());
+  EXPECT_EQ(8, q1.capacity());
+  EXPECT_EQ(8, q2.capacity());
+  EXPECT_TRUE(q1.empty());
+  EXPECT_TRUE(q1.front() == nullptr);
+  int x = -1;
+  EXPECT_FALSE(q1.try_pop(x));
+  EXPECT_EQ(-1, x);
+
+  for (int i = 0; i < 8; ++i)
+    EXPECT_TRUE(q1.try_push(i));
+  EXPECT_FALSE(q1.try_push(8));
+  EXPECT_EQ(8, q1.size());
+  EXPECT_EQ(8 * sizeof(int), q1.memory_usage().payload);
+  EXPECT_EQ(0, q1.memory_usage().overhead);
+  for (int i = 0; i < 8; ++i)
+  {
+    EXPECT_EQ(i, *q1.front());
+    q1.pop();
+  }
+  EXPECT_TRUE(q1.empty());
+
+  // 下标回绕很多次之后依然保持先进先出
+  bool ok = true;
+  int next_in = 0, next_out = 0;
+  for (int round = 0; round < 1000; ++round)
+  {
+    const int n = round % 7 + 1;
+    for (int i = 0; i < n; ++i)
+      ok = ok && q1.try_emplace(next_in++);
+    for (int i = 0; i < n; ++i)
+      ok = ok && q1.try_pop(x) && x == next_out++;
+  }
+  EXPECT_TRUE(ok);
+  EXPECT_TRUE(q1.empty());
+  EXPECT_EQ(0, q1.memory_usage().payload);
+}
+
+TEST(spsc_queue_batch_test)
+{
+  mystl::spsc_queue<int> q(8);
+  std::vector<int> src;
+  for (int i = 0; i < 20; ++i)
+    src.push_back(i);
+
+  // 空位不够时只放入一部分
+  EXPECT_EQ(5, q.try_push_n(src.begin(), 5));
+  EXPECT_EQ(3, q.try_push_n(src.begin() + 5, 10));
+  EXPECT_EQ(0, q.try_push_n(src.begin() + 8, 10));
+  EXPECT_EQ(8, q.size());
+
+  // 元素不够时只取出一部分，跨过缓冲区末尾的批次也保持顺序
+  int out[16] = { 0 };
+  EXPECT_EQ(6, q.try_pop_n(out, 6));
+  EXPECT_EQ(0, out[0]);
+  EXPECT_EQ(5, out[5]);
+  EXPECT_EQ(6, q.try_push_n(src.begin() + 8, 6));
+  EXPECT_EQ(8, q.try_pop_n(out, 16));
+  for (int i = 0; i < 8; ++i)
+    EXPECT_EQ(6 + i, out[i]);
+  EXPECT_EQ(0, q.try_pop_n(out, 16));
+
+  // 输入迭代器与输出迭代器不必是指针
+  std::list<int> l(src.begin(), src.begin() + 7);
+  EXPECT_EQ(7, q.try_push_n(l.begin(), l.size()));
+  std::vector<int> v;
+  EXPECT_EQ(7, q.try_pop_n(std::back_inserter(v), 100));
+  EXPECT_CON_EQ(l, v);
+
+  mystl::spsc_queue<mystl::string> qs(4);
+  std::vector<mystl::string> words = { "a", "bb", "a string longer than the short buffer", "dd", "e" };
+  EXPECT_EQ(4, qs.try_push_n(words.begin(), words.size()));
+  mystl::string s;
+  EXPECT_TRUE(qs.try_pop(s));
+  EXPECT_EQ(mystl::string("a"), s);
+  EXPECT_EQ(1, qs.try_push_n(words.begin() + 4, 1));
+  std::vector<mystl::string> got(4);
+  EXPECT_EQ(4, qs.try_pop_n(got.begin(), 4));
+  EXPECT_EQ(words[2], got[1]);
+  EXPECT_EQ(mystl::string("e"), got[3]);
+}
+
+TEST(spsc_queue_exception_test)
+{
+  {
+    mystl::spsc_queue<counted> q(8);
+    std::vector<counted> src;
+    for (int i = 0; i < 8; ++i)
+      src.push_back(counted(i));
+    const int base = counted::live;
+
+    // 让批次跨过缓冲区末尾，在第二段中途抛出异常，已经构造的元素全部析构
+    EXPECT_EQ(6, q.try_push_n(src.begin(), 6));
+    counted tmp(0);
+    for (int i = 0; i < 6; ++i)
+      EXPECT_TRUE(q.try_pop(tmp));
+    EXPECT_EQ(base + 1, counted::live);
+    counted::copy_budget = 4;
+    bool thrown = false;
+    try
+    {
+      q.try_push_n(src.begin(), 8);
+    }
+    catch (...)
+    {
+      thrown = true;
+    }
+    counted::copy_budget = -1;
+    EXPECT_TRUE(thrown);
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(base + 1, counted::live);
+
+    counted::copy_budget = 0;
+    thrown = false;
+    try
+    {
+      q.try_push(src[0]);
+    }
+    catch (...)
+    {
+      thrown = true;
+    }
+    counted::copy_budget = -1;
+    EXPECT_TRUE(thrown);
+    EXPECT_TRUE(q.empty());
+
+    // 析构时销毁队列中剩余的元素
+    EXPECT_EQ(5, q.try_push_n(src.begin(), 5));
+    EXPECT_EQ(base + 6, counted::live);
+  }
+  EXPECT_EQ(0, counted::live);
+}
+
+TEST(spsc_queue_thread_test)
+{
+  // 容量很小，两个线程频繁遇到已满、已空；单个与批量的操作交替进行
+  const int n = 200000;
+  mystl::spsc_queue<int> q(64);
+  bool ok = true;
+  std::thread consumer([&q, &ok, n]() {
+    int expect = 0;
+    int buf[37];
+    while (expect < n)
+    {
+      size_t k = 0;
+      if (expect % 3 == 0)
+      {
+        k = q.try_pop_n(buf, 37);
+      }
+      else if (q.try_pop(buf[0]))
+      {
+        k = 1;
+      }
+      if (k == 0)
+        std::this_thread::yield();
+      for (size_t i = 0; i < k; ++i)
+        ok = ok && buf[i] == expect++;
+    }
+  });
+  int next = 0;
+  std::vector<int> batch;
+  while (next < n)
+  {
+    size_t k = 0;
+    if (next % 2 == 0)
+    {
+      batch.clear();
+      for (int i = 0; i < 29 && next + i < n; ++i)
+        batch.push_back(next + i);
+      k = q.try_push_n(batch.begin(), batch.size());
+    }
+    else if (q.try_push(next))
+    {
+      k = 1;
+    }
+    if (k == 0)
+      std::this_thread::yield();
+    next += static_cast<int>(k);
+  }
+  consumer.join();
+  EXPECT_TRUE(ok);
+  EXPECT_TRUE(q.empty());
+}
+
+// 在两个线程之间传递 count 个元素，消费者用 sum 校验
+template <class Pass>
+long long transfer(size_t count, Pass pass)
+{
+  long long sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  pass(count, sum);
+  auto end = std::chrono::steady_clock::now();
+  volatile long long sink = sum;
+  (void)sink;
+  return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+// 用互斥量保护的 mystl::queue
+void locked_queue_pass(size_t count, long long& sum)
+{
+  mystl::queue<int> q;
+  std::mutex m;
+  std::thread consumer([&]() {
+    for (size_t got = 0; got < count; )
+    {
+      bool popped = false;
+      {
+        std::lock_guard<std::mutex> lock(m);
+        if (!q.empty())
+        {
+          sum += q.front();
+          q.pop();
+          popped = true;
+        }
+      }
+      if (popped)
+        ++got;
+      else
+        std::this_thread::yield();
+    }
+  });
+  for (size_t i = 0; i < count; ++i)
+  {
+    std::lock_guard<std::mutex> lock(m);
+    q.push(static_cast<int>(i));
+  }
+  consumer.join();
+}
+
+void spsc_pass(size_t count, long long& sum)
+{
+  mystl::spsc_queue<int> q(1024);
+  std::thread consumer([&]() {
+    int x;
+    for (size_t got = 0; got < count; )
+    {
+      if (q.try_pop(x))
+      {
+        sum += x;
+        ++got;
+      }
+      else
+      {
+        std::this_thread::yield();
+      }
+    }
+  });
+  for (size_t i = 0; i < count; ++i)
+  {
+    while (!q.try_push(static_cast<int>(i)))
+      std::this_thread::yield();
+  }
+  consumer.join();
+}
+
+void spsc_batch_pass(size_t count, long long& sum)
+{
+  mystl::spsc_queue<int> q(1024);
+  std::thread consumer([&]() {
+    int buf[64];
+    for (size_t got = 0; got < count; )
+    {
+      const size_t k = q.try_pop_n(buf, 64);
+      for (size_t i = 0; i < k; ++i)
+        sum += buf[i];
+      got += k;
+      if (k == 0)
+        std::this_thread::yield();
+    }
+  });
+  int buf[64];
+  for (size_t i = 0; i < count; )
+  {
+    const size_t n = count - i < 64 ? count - i : 64;
+    for (size_t j = 0; j < n; ++j)
+      buf[j] = static_cast<int>(i + j);
+    for (size_t done = 0; done < n; )
+    {
+      const size_t k = q.try_push_n(buf + done, n - done);
+      done += k;
+      if (k == 0)
+        std::this_thread::yield();
+    }
+    i += n;
+  }
+  consumer.join();
+}
+
+#define SPSC_QUEUE_TEST(pass, count) do {                 \
+  char buf[10];                                           \
+  int n = static_cast<int>(transfer(count, pass));        \
+  std::snprintf(buf, sizeof(buf), "%d", n);               \
+  std::string t = buf;                                    \
+  t += "ms    |";                                         \
+  std::cout << std::setw(WIDE) << t;                      \
+} while(0)
+
+void spsc_queue_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[--------------- Run container test : spsc_queue ---------------]" << std::endl;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|   2 threads, wall   |";
+#if LARGER_TEST_DATA_ON
+  TEST_LEN(SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3), WIDE);
+  std::cout << "|  mutex + queue<int> |";
+  SPSC_QUEUE_TEST(locked_queue_pass, SCALE_L(LEN1));
+  SPSC_QUEUE_TEST(locked_queue_pass, SCALE_L(LEN2));
+  SPSC_QUEUE_TEST(locked_queue_pass, SCALE_L(LEN3));
+  std::cout << "\n|  spsc_queue<int>    |";
+  SPSC_QUEUE_TEST(spsc_pass, SCALE_L(LEN1));
+  SPSC_QUEUE_TEST(spsc_pass, SCALE_L(LEN2));
+  SPSC_QUEUE_TEST(spsc_pass, SCALE_L(LEN3));
+  std::cout << "\n|  spsc, batch of 64  |";
+  SPSC_QUEUE_TEST(spsc_batch_pass, SCALE_L(LEN1));
+  SPSC_QUEUE_TEST(spsc_batch_pass, SCALE_L(LEN2));
+  SPSC_QUEUE_TEST(spsc_batch_pass, SCALE_L(LEN3));
+#else
+  TEST_LEN(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3), WIDE);
+  std::cout << "|  mutex + queue<int> |";
+  SPSC_QUEUE_TEST(locked_queue_pass, SCALE_M(LEN1));
+  SPSC_QUEUE_TEST(locked_queue_pass, SCALE_M(LEN2));
+  SPSC_QUEUE_TEST(locked_queue_pass, SCALE_M(LEN3));
+  std::cout << "\n|  spsc_queue<int>    |";
+  SPSC_QUEUE_TEST(spsc_pass, SCALE_M(LEN1));
+  SPSC_QUEUE_TEST(spsc_pass, SCALE_M(LEN2));
+  SPSC_QUEUE_TEST(spsc_pass, SCALE_M(LEN3));
+  std::cout << "\n|  spsc, batch of 64  |";
+  SPSC_QUEUE_TEST(spsc_batch_pass, SCALE_M(LEN1));
+  SPSC_QUEUE_TEST(spsc_batch_pass, SCALE_M(LEN2));
+  SPSC_QUEUE_TEST(spsc_batch_pass, SCALE_M(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[--------------- End container test : spsc_queue ---------------]" << std::endl;
+}
+
+} // namespace spsc_queue_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_SPSC_QUEUE_TEST_H_
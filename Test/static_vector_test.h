@@ -0,0 +1,205 @@
+#ifndef MYTINYSTL_STATIC_VECTOR_TEST_H_
+#define MYTINYSTL_STATIC_VECTOR_TEST_H_
+
+// static_vector test : 测试 static_vector 的接口，以及定长短小向量的构造性能
+
+#include <stdexcept>
+
+#include "../MyTinySTL/astring.h"
+#include "../MyTinySTL/static_vector.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace static_vector_test
+{
+
+TEST(static_vector_overflow_test)
+{
+  mystl::static_vector<int, 4> v{ 1,2,3 };
+  EXPECT_EQ(4, v.capacity());
+  EXPECT_EQ(0, v.memory_usage().total());
+  EXPECT_TRUE(v.try_push_back(4));
+  EXPECT_TRUE(v.full());
+  EXPECT_TRUE(!v.try_push_back(5));
+  EXPECT_TRUE(!v.try_emplace_back(5));
+
+  bool thrown = false;
+  try { v.push_back(5); }
+  catch (const std::length_error&) { thrown = true; }
+  EXPECT_TRUE(thrown);
+
+  // 插入失败时容器保持不变
+  int a[] = { 7,8 };
+  thrown = false;
+  v.pop_back();
+  try { v.insert(v.begin(), a, a + 2); }
+  catch (const std::length_error&) { thrown = true; }
+  EXPECT_TRUE(thrown);
+  EXPECT_EQ(3, v.size());
+  EXPECT_EQ(1, v.front());
+  EXPECT_EQ(3, v.back());
+
+  thrown = false;
+  try { v.resize(5); }
+  catch (const std::length_error&) { thrown = true; }
+  EXPECT_TRUE(thrown);
+  EXPECT_EQ(3, v.size());
+}
+
+TEST(static_vector_modify_test)
+{
+  int a[] = { 1,2,3,4,5 };
+  mystl::static_vector<int, 16> v1;
+  mystl::static_vector<int, 16> v2(10, 1);
+  mystl::static_vector<int, 16> v3(a, a + 5);
+  mystl::vector<int> expect;
+  EXPECT_EQ(10, v2.size());
+  EXPECT_EQ(5, v3.size());
+
+  v1.assign(a, a + 3);
+  v1.emplace(v1.begin(), 0);
+  v1.insert(v1.begin() + 2, 2, 7);
+  v1.insert(v1.end(), a, a + 2);
+  v1.push_back(v1[0]);
+  expect = { 0,1,7,7,2,3,1,2,0 };
+  EXPECT_TRUE(mystl::equal(v1.begin(), v1.end(), expect.begin()));
+  EXPECT_EQ(expect.size(), v1.size());
+
+  v1.erase(v1.begin() + 1);
+  v1.erase(v1.begin(), v1.begin() + 2);
+  v1.pop_back();
+  expect = { 7,2,3,1,2 };
+  EXPECT_TRUE(mystl::equal(v1.begin(), v1.end(), expect.begin()));
+
+  // 插入的范围引用自身的元素
+  v1.insert(v1.begin() + 1, v1.begin(), v1.begin() + 2);
+  v1.insert(v1.begin(), 2, v1.back());
+  expect = { 2,2,7,7,2,2,3,1,2 };
+  EXPECT_TRUE(mystl::equal(v1.begin(), v1.end(), expect.begin()));
+
+  v1.resize(2);
+  v1.resize(4, 9);
+  v1.reverse();
+  expect = { 9,9,2,2 };
+  EXPECT_TRUE(mystl::equal(v1.begin(), v1.end(), expect.begin()));
+  v1.resize_default_init(6);
+  EXPECT_EQ(6, v1.size());
+
+  v1.clear();
+  EXPECT_TRUE(v1.empty());
+  v1 = { 5,6 };
+  EXPECT_EQ(2, v1.size());
+  EXPECT_EQ(6, v1.at(1));
+  EXPECT_TRUE(v1 != v3);
+  EXPECT_TRUE(v3 < v1);
+}
+
+TEST(static_vector_nontrivial_test)
+{
+  mystl::static_vector<mystl::string, 6> a{ "a", "b", "c" };
+  mystl::static_vector<mystl::string, 6> b{ "x" };
+  a.insert(a.begin() + 1, "m");
+  a.emplace(a.begin(), 3, 'z');
+  EXPECT_EQ(5, a.size());
+  EXPECT_EQ(0, a[0].compare("zzz"));
+  EXPECT_EQ(0, a[2].compare("m"));
+  a.erase(a.begin(), a.begin() + 2);
+  EXPECT_EQ(0, a[0].compare("m"));
+
+  a.swap(b);
+  EXPECT_EQ(1, a.size());
+  EXPECT_EQ(3, b.size());
+  EXPECT_EQ(0, a[0].compare("x"));
+  EXPECT_EQ(0, b[2].compare("c"));
+  mystl::swap(a, b);
+  EXPECT_EQ(3, a.size());
+  EXPECT_EQ(0, b[0].compare("x"));
+
+  mystl::static_vector<mystl::string, 6> c(mystl::move(a));
+  EXPECT_EQ(3, c.size());
+  EXPECT_TRUE(a.empty());
+  mystl::static_vector<mystl::string, 6> d(c);
+  EXPECT_TRUE(d == c);
+  d.back() = "z";
+  EXPECT_TRUE(c < d);
+  d = mystl::move(b);
+  EXPECT_EQ(1, d.size());
+  d = c;
+  EXPECT_TRUE(d == c);
+}
+
+typedef mystl::static_vector<int, 8> static_vector8;
+
+// 构造 count 个短小的向量，每个向量有 len 个元素
+template <class Vec>
+void packet_lists(size_t count, int len)
+{
+  size_t sum = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    Vec v;
+    for (int j = 0; j < len; ++j)
+      v.push_back(j);
+    sum += v.size();
+  }
+  volatile size_t sink = sum;
+  (void)sink;
+}
+
+#define STATIC_VECTOR_TEST(vec, count) do {               \
+  char buf[10];                                           \
+  clock_t start = clock();                                \
+  packet_lists<vec>(count, 3);                            \
+  clock_t end = clock();                                  \
+  int n = static_cast<int>(static_cast<double>(end - start) \
+      / CLOCKS_PER_SEC * 1000);                           \
+  std::snprintf(buf, sizeof(buf), "%d", n);               \
+  std::string t = buf;                                    \
+  t += "ms    |";                                         \
+  std::cout << std::setw(WIDE) << t;                      \
+} while(0)
+
+void static_vector_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[-------------- Run container test : static_vector -------------]" << std::endl;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  3 ints per vector  |";
+#if LARGER_TEST_DATA_ON
+  TEST_LEN(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3), WIDE);
+  std::cout << "|       vector        |";
+  STATIC_VECTOR_TEST(mystl::vector<int>, SCALE_M(LEN1));
+  STATIC_VECTOR_TEST(mystl::vector<int>, SCALE_M(LEN2));
+  STATIC_VECTOR_TEST(mystl::vector<int>, SCALE_M(LEN3));
+  std::cout << "\n|  static_vector<8>   |";
+  STATIC_VECTOR_TEST(static_vector8, SCALE_M(LEN1));
+  STATIC_VECTOR_TEST(static_vector8, SCALE_M(LEN2));
+  STATIC_VECTOR_TEST(static_vector8, SCALE_M(LEN3));
+#else
+  TEST_LEN(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3), WIDE);
+  std::cout << "|       vector        |";
+  STATIC_VECTOR_TEST(mystl::vector<int>, SCALE_S(LEN1));
+  STATIC_VECTOR_TEST(mystl::vector<int>, SCALE_S(LEN2));
+  STATIC_VECTOR_TEST(mystl::vector<int>, SCALE_S(LEN3));
+  std::cout << "\n|  static_vector<8>   |";
+  STATIC_VECTOR_TEST(static_vector8, SCALE_S(LEN1));
+  STATIC_VECTOR_TEST(static_vector8, SCALE_S(LEN2));
+  STATIC_VECTOR_TEST(static_vector8, SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[-------------- End container test : static_vector -------------]" << std::endl;
+}
+
+} // namespace static_vector_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_STATIC_VECTOR_TEST_H_
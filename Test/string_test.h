@@ -15,6 +15,75 @@ namespace test
 namespace string_test
 {
 
+TEST(string_reserve_leak_test)
+{
+  mystl::string warm("abc");
+  warm.reserve(100);
+  const size_t before = heap_in_use();
+  for (int i = 0; i < 1000; ++i)
+  {
+    mystl::string str("abc");
+    str.reserve(100);
+    str.reserve(200);
+    str.shrink_to_fit();
+  }
+  EXPECT_TRUE(heap_in_use() <= before + 4096);
+}
+
+TEST(string_default_capacity_test)
+{
+  mystl::string str;
+  EXPECT_TRUE(str.capacity() > 0);
+  const char* p = str.data();
+  str.append("abc");
+  EXPECT_EQ(p, str.data());  // 默认分配的空间足够，不需要重新分配
+  EXPECT_EQ(0, str.compare("abc"));
+}
+
+TEST(string_replace_grow_test)
+{
+  const char* long_str = "0123456789012345678901234567890123456789";
+  mystl::string s1("hello world");
+  s1.replace(0, 5, long_str);
+  EXPECT_EQ(0, s1.compare("0123456789012345678901234567890123456789 world"));
+
+  mystl::string s2("hello world");
+  s2.replace(6, 5, 40, 'x');
+  EXPECT_EQ(0, s2.compare("hello xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"));
+
+  mystl::string s3("hello world");
+  s3.replace(s3.begin(), s3.begin() + 5, long_str, long_str + 40);
+  EXPECT_EQ(0, s3.compare("0123456789012345678901234567890123456789 world"));
+
+  mystl::string s4("hello world");
+  s4.replace(0, 5, long_str + 10);
+  EXPECT_EQ(0, s4.compare("012345678901234567890123456789 world"));
+}
+
+TEST(string_resize_and_overwrite_test)
+{
+  mystl::string s("abc");
+  s.resize_default_init(100);
+  EXPECT_EQ(100u, s.size());
+  EXPECT_EQ('c', s[2]);
+  s.resize_default_init(3);
+  EXPECT_EQ(0, s.compare("abc"));
+
+  // 直接写入缓冲区，返回值作为新的长度
+  s.resize_and_overwrite(1000, [](char* p, size_t n)
+  {
+    for (size_t i = 3; i < n; ++i)
+      p[i] = 'x';
+    return n - 10;
+  });
+  EXPECT_EQ(990u, s.size());
+  EXPECT_TRUE(s.capacity() >= 1000);
+  EXPECT_EQ('b', s[1]);
+  EXPECT_EQ('x', s[989]);
+  s.resize_and_overwrite(2, [](char* p, size_t) { p[0] = 'q'; return 1; });
+  EXPECT_EQ(0, s.compare("q"));
+}
+
 void string_test()
 {
   std::cout << "[===============================================================]" << std::endl;
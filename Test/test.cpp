@@ -10,6 +10,7 @@
 
 #include "algorithm_performance_test.h"
 #include "algorithm_test.h"
+#include "alloc_test.h"
 #include "vector_test.h"
 #include "list_test.h"
 #include "deque_test.h"
@@ -20,6 +21,18 @@
 #include "unordered_map_test.h"
 #include "unordered_set_test.h"
 #include "string_test.h"
+#include "pmr_test.h"
+#include "relocate_test.h"
+#include "small_vector_test.h"
+#include "static_vector_test.h"
+#include "soa_vector_test.h"
+#include "dynamic_bitset_test.h"
+#include "unrolled_list_test.h"
+#include "intrusive_test.h"
+#include "forward_list_test.h"
+#include "circular_buffer_test.h"
+#include "spsc_queue_test.h"
+#include "mpmc_queue_test.h"
 
 int main()
 {
@@ -29,6 +42,7 @@ int main()
 
   RUN_ALL_TESTS();
   algorithm_performance_test::algorithm_performance_test();
+  alloc_test::alloc_test();
   vector_test::vector_test();
   list_test::list_test();
   deque_test::deque_test();
@@ -44,6 +58,18 @@ int main()
   unordered_set_test::unordered_set_test();
   unordered_set_test::unordered_multiset_test();
   string_test::string_test();
+  pmr_test::pmr_test();
+  relocate_test::relocate_test();
+  small_vector_test::small_vector_test();
+  static_vector_test::static_vector_test();
+  soa_vector_test::soa_vector_test();
+  dynamic_bitset_test::dynamic_bitset_test();
+  unrolled_list_test::unrolled_list_test();
+  intrusive_test::intrusive_test();
+  forward_list_test::forward_list_test();
+  circular_buffer_test::circular_buffer_test();
+  spsc_queue_test::spsc_queue_test();
+  mpmc_queue_test::mpmc_queue_test();
 
 #if defined(_MSC_VER) && defined(_DEBUG)
   _CrtDumpMemoryLeaks();
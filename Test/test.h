@@ -14,6 +14,11 @@
 
 #include "Lib/redbud/io/color.h"
 
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define MYSTL_TEST_HEAP_INFO 1
+#endif
+
 namespace mystl
 {
 namespace test
@@ -560,6 +565,32 @@ EXPECT_CON_EQ(v1, v3)   ok
   std::cout << " " << fun_name << " : " << fun << "\n";  \
 } while(0)
 
+/*****************************************************************************************/
+// 检查内存泄漏用的辅助工具
+
+// 记录存活对象的个数，容器销毁以后应当回到 0
+struct live_counted
+{
+  int value;
+
+  live_counted(int v = 0) :value(v) { ++count(); }
+  live_counted(const live_counted& rhs) :value(rhs.value) { ++count(); }
+  live_counted& operator=(const live_counted& rhs) { value = rhs.value; return *this; }
+  ~live_counted() { --count(); }
+
+  static int& count() { static int n = 0; return n; }
+};
+
+// 当前堆上正在使用的字节数，不支持的平台上总是返回 0
+inline size_t heap_in_use()
+{
+#if defined(MYSTL_TEST_HEAP_INFO)
+  return mallinfo2().uordblks;
+#else
+  return 0;
+#endif
+}
+
 // 输出测试数量级
 void test_len(size_t len1, size_t len2, size_t len3, size_t wide)
 {
@@ -16,6 +16,51 @@ namespace test
 namespace unordered_map_test
 {
 
+TEST(unordered_map_equality_test)
+{
+  mystl::unordered_map<int, int> m1{ PAIR(1, 1), PAIR(2, 2) };
+  mystl::unordered_map<int, int> m2{ PAIR(2, 2), PAIR(1, 1) };
+  mystl::unordered_map<int, int> m3{ PAIR(1, 1), PAIR(2, 3) };
+  EXPECT_TRUE(m1 == m2);
+  EXPECT_TRUE(m1 != m3);
+
+  mystl::unordered_multimap<int, int> mm1{ PAIR(1, 1), PAIR(1, 2), PAIR(2, 2) };
+  mystl::unordered_multimap<int, int> mm2{ PAIR(2, 2), PAIR(1, 2), PAIR(1, 1) };
+  mystl::unordered_multimap<int, int> mm3{ PAIR(1, 1), PAIR(2, 2), PAIR(2, 2) };
+  EXPECT_TRUE(mm1 == mm2);
+  EXPECT_TRUE(mm1 != mm3);
+}
+
+TEST(unordered_map_rehash_test)
+{
+  live_counted::count() = 0;
+  {
+    mystl::unordered_map<int, live_counted> m;
+    for (int i = 0; i < 1000; ++i)
+      m.emplace(i, live_counted(i));
+    EXPECT_EQ(1000, live_counted::count());
+    m.rehash(5000);
+    EXPECT_EQ(1000, live_counted::count());
+    EXPECT_EQ(1000, m.size());
+    EXPECT_EQ(999, m.find(999)->second.value);
+  }
+  EXPECT_EQ(0, live_counted::count());
+}
+
+TEST(unordered_map_emplace_existing_key_test)
+{
+  live_counted::count() = 0;
+  {
+    mystl::unordered_map<int, live_counted> m;
+    m.emplace(1, live_counted(1));
+    auto res = m.emplace(1, live_counted(2));
+    EXPECT_FALSE(res.second);
+    EXPECT_EQ(1, res.first->second.value);
+    EXPECT_EQ(1, live_counted::count());
+  }
+  EXPECT_EQ(0, live_counted::count());
+}
+
 void unordered_map_test()
 {
   std::cout << "[===============================================================]" << std::endl;
@@ -16,6 +16,21 @@ namespace test
 namespace unordered_set_test
 {
 
+TEST(unordered_set_equality_test)
+{
+  mystl::unordered_set<int> s1{ 1,2,3 };
+  mystl::unordered_set<int> s2{ 3,2,1 };
+  mystl::unordered_set<int> s3{ 1,2,4 };
+  EXPECT_TRUE(s1 == s2);
+  EXPECT_TRUE(s1 != s3);
+
+  mystl::unordered_multiset<int> m1{ 1,1,2,3 };
+  mystl::unordered_multiset<int> m2{ 3,1,2,1 };
+  mystl::unordered_multiset<int> m3{ 1,2,2,3 };
+  EXPECT_TRUE(m1 == m2);
+  EXPECT_TRUE(m1 != m3);
+}
+
 void unordered_set_test()
 {
   std::cout << "[===============================================================]" << std::endl;
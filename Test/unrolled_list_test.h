@@ -0,0 +1,269 @@
+#ifndef MYTINYSTL_UNROLLED_LIST_TEST_H_
+#define MYTINYSTL_UNROLLED_LIST_TEST_H_
+
+// unrolled_list test : 测试 unrolled_list 的接口，以及遍历的性能
+
+#include <cstdlib>
+
+#include "../MyTinySTL/astring.h"
+#include "../MyTinySTL/list.h"
+#include "../MyTinySTL/unrolled_list.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace unrolled_list_test
+{
+
+// 每个节点 4 个元素，便于触发分裂与合并
+typedef mystl::unrolled_list<int, 4> small_ulist;
+
+template <class List, class Vec>
+bool same(const List& l, const Vec& v)
+{
+  if (l.size() != v.size())
+    return false;
+  auto it = v.begin();
+  for (auto& x : l)
+  {
+    if (x != *it++)
+      return false;
+  }
+  // 反向遍历也要一致
+  auto rit = v.end();
+  for (auto i = l.end(); i != l.begin();)
+  {
+    if (*--i != *--rit)
+      return false;
+  }
+  return true;
+}
+
+template <class List>
+typename List::iterator nth(List& l, size_t n)
+{
+  auto it = l.begin();
+  for (; n > 0; --n)
+    ++it;
+  return it;
+}
+
+TEST(unrolled_list_modify_test)
+{
+  int a[] = { 1,2,3,4,5 };
+  small_ulist l1;
+  small_ulist l2(10, 1);
+  small_ulist l3(a, a + 5);
+  small_ulist l4{ 1,2,3 };
+  EXPECT_EQ(10, l2.size());
+  EXPECT_EQ(3, l2.node_count());
+  EXPECT_EQ(5, l3.back());
+  EXPECT_EQ(1, l4.front());
+
+  l1.assign(a, a + 3);
+  l1.push_front(0);
+  l1.insert(nth(l1, 2), 2, 7);
+  l1.emplace(l1.end(), 9);
+  l1.insert(l1.end(), a, a + 2);
+  l1.push_back(l1.front());
+  mystl::vector<int> expect{ 0,1,7,7,2,3,9,1,2,0 };
+  EXPECT_TRUE(same(l1, expect));
+
+  auto it = l1.erase(nth(l1, 1));
+  EXPECT_EQ(7, *it);
+  it = l1.erase(l1.begin(), nth(l1, 3));
+  EXPECT_EQ(2, *it);
+  l1.pop_back();
+  l1.pop_front();
+  expect = { 3,9,1,2 };
+  EXPECT_TRUE(same(l1, expect));
+
+  l1.resize(2);
+  l1.resize(5, 4);
+  expect = { 3,9,4,4,4 };
+  EXPECT_TRUE(same(l1, expect));
+  l1.remove(4);
+  EXPECT_EQ(2, l1.size());
+
+  small_ulist l5(l3);
+  EXPECT_TRUE(l5 == l3);
+  l5.back() = 6;
+  EXPECT_TRUE(l3 < l5);
+  l5 = { 8,9 };
+  EXPECT_EQ(2, l5.size());
+  l5.swap(l3);
+  EXPECT_EQ(5, l5.size());
+  EXPECT_EQ(8, l3.front());
+  small_ulist l6(mystl::move(l5));
+  EXPECT_TRUE(l5.empty());
+  EXPECT_EQ(0, l5.node_count());
+  EXPECT_EQ(5, l6.size());
+  l5 = mystl::move(l6);
+  EXPECT_EQ(5, l5.size());
+  l5.clear();
+  EXPECT_TRUE(l5.empty());
+  EXPECT_TRUE(l5.begin() == l5.end());
+}
+
+TEST(unrolled_list_random_test)
+{
+  // 与 vector 对照，随机地在各处插入、删除
+  small_ulist l;
+  mystl::vector<int> v;
+  std::srand(7);
+  for (int step = 0; step < 4000; ++step)
+  {
+    const int op = std::rand() % 10;
+    const size_t n = v.size();
+    if (op < 6 || n == 0)
+    {
+      const size_t i = std::rand() % (n + 1);
+      auto it = l.insert(nth(l, i), step);
+      v.insert(v.begin() + i, step);
+      EXPECT_EQ(step, *it);
+    }
+    else if (op < 9)
+    {
+      const size_t i = std::rand() % n;
+      auto it = l.erase(nth(l, i));
+      v.erase(v.begin() + i);
+      EXPECT_TRUE(i == v.size() ? it == l.end() : *it == v[i]);
+    }
+    else
+    {
+      const size_t i = std::rand() % n;
+      const size_t j = i + std::rand() % (n - i + 1);
+      auto it = l.erase(nth(l, i), nth(l, j));
+      v.erase(v.begin() + i, v.begin() + j);
+      EXPECT_TRUE(i == v.size() ? it == l.end() : *it == v[i]);
+    }
+  }
+  EXPECT_TRUE(same(l, v));
+  // 合并保证相邻两个节点合计多于 N / 2 个元素
+  EXPECT_TRUE(l.node_count() <= l.size() + 1);
+
+  // 整体插入后返回第一个新元素
+  const size_t mid = v.size() / 2;
+  mystl::vector<int> w(v);
+  auto it = l.insert(nth(l, mid), w.begin(), w.end());
+  v.insert(v.begin() + mid, w.begin(), w.end());
+  EXPECT_EQ(v[mid], *it);
+  EXPECT_TRUE(same(l, v));
+}
+
+TEST(unrolled_list_stability_test)
+{
+  mystl::unrolled_list<int, 8> l;
+  for (int i = 0; i < 64; ++i)
+    l.push_back(i);
+  EXPECT_EQ(8, l.node_count());
+  // 在第一个节点中插入、删除，其他节点中元素的引用不受影响
+  int& far = *nth(l, 40);
+  auto far_it = nth(l, 50);
+  l.insert(nth(l, 3), 100);
+  l.erase(l.begin());
+  l.erase(nth(l, 1));
+  EXPECT_EQ(40, far);
+  EXPECT_EQ(50, *far_it);
+  EXPECT_TRUE(far_it == nth(l, 49));
+  auto e = l.end();
+  l.push_back(64);
+  EXPECT_TRUE(e == l.end());
+  EXPECT_EQ(64 * sizeof(int), l.memory_usage().payload);
+}
+
+TEST(unrolled_list_nontrivial_test)
+{
+  mystl::unrolled_list<mystl::string, 4> l;
+  for (int i = 0; i < 20; ++i)
+    l.emplace_back(10, static_cast<char>('a' + i));
+  l.insert(nth(l, 2), "xyz");
+  l.emplace_front("front");
+  // 插入的值引用自身的元素，搬移后依然正确
+  l.insert(nth(l, 1), l.back());
+  l.insert(nth(l, 3), 3, *nth(l, 3));
+  EXPECT_EQ(0, l.front().compare("front"));
+  EXPECT_EQ(0, nth(l, 1)->compare("tttttttttt"));
+  EXPECT_EQ(0, nth(l, 3)->compare("bbbbbbbbbb"));
+  EXPECT_EQ(0, nth(l, 6)->compare("bbbbbbbbbb"));
+  EXPECT_EQ(26, l.size());
+  l.erase(nth(l, 2), nth(l, 20));
+  EXPECT_EQ(8, l.size());
+  EXPECT_EQ(0, l.back().compare("tttttttttt"));
+  mystl::unrolled_list<mystl::string, 4> c = l;
+  EXPECT_TRUE(c == l);
+}
+
+// 构造 n 个元素，再遍历求和 10 次
+template <class List>
+void traverse(size_t n)
+{
+  List l;
+  for (size_t i = 0; i < n; ++i)
+    l.push_back(static_cast<int>(i));
+  long long sum = 0;
+  for (int k = 0; k < 10; ++k)
+  {
+    for (auto x : l)
+      sum += x;
+  }
+  volatile long long sink = sum;
+  (void)sink;
+}
+
+#define UNROLLED_LIST_TEST(list, count) do {              \
+  char buf[10];                                           \
+  clock_t start = clock();                                \
+  traverse<list>(count);                                  \
+  clock_t end = clock();                                  \
+  int n = static_cast<int>(static_cast<double>(end - start) \
+      / CLOCKS_PER_SEC * 1000);                           \
+  std::snprintf(buf, sizeof(buf), "%d", n);               \
+  std::string t = buf;                                    \
+  t += "ms    |";                                         \
+  std::cout << std::setw(WIDE) << t;                      \
+} while(0)
+
+void unrolled_list_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[-------------- Run container test : unrolled_list -------------]" << std::endl;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "| push_back + sum x10 |";
+#if LARGER_TEST_DATA_ON
+  TEST_LEN(SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3), WIDE);
+  std::cout << "|        list         |";
+  UNROLLED_LIST_TEST(mystl::list<int>, SCALE_L(LEN1));
+  UNROLLED_LIST_TEST(mystl::list<int>, SCALE_L(LEN2));
+  UNROLLED_LIST_TEST(mystl::list<int>, SCALE_L(LEN3));
+  std::cout << "\n|    unrolled_list    |";
+  UNROLLED_LIST_TEST(mystl::unrolled_list<int>, SCALE_L(LEN1));
+  UNROLLED_LIST_TEST(mystl::unrolled_list<int>, SCALE_L(LEN2));
+  UNROLLED_LIST_TEST(mystl::unrolled_list<int>, SCALE_L(LEN3));
+#else
+  TEST_LEN(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3), WIDE);
+  std::cout << "|        list         |";
+  UNROLLED_LIST_TEST(mystl::list<int>, SCALE_M(LEN1));
+  UNROLLED_LIST_TEST(mystl::list<int>, SCALE_M(LEN2));
+  UNROLLED_LIST_TEST(mystl::list<int>, SCALE_M(LEN3));
+  std::cout << "\n|    unrolled_list    |";
+  UNROLLED_LIST_TEST(mystl::unrolled_list<int>, SCALE_M(LEN1));
+  UNROLLED_LIST_TEST(mystl::unrolled_list<int>, SCALE_M(LEN2));
+  UNROLLED_LIST_TEST(mystl::unrolled_list<int>, SCALE_M(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[-------------- End container test : unrolled_list -------------]" << std::endl;
+}
+
+} // namespace unrolled_list_test
+} // namespace test
+} // namespace mystl
+#endif // !MYTINYSTL_UNROLLED_LIST_TEST_H_
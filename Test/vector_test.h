@@ -5,6 +5,8 @@
 
 #include <vector>
 
+#include <cstring>
+
 #include "../MyTinySTL/vector.h"
 #include "test.h"
 
@@ -15,6 +17,73 @@ namespace test
 namespace vector_test
 {
 
+TEST(vector_less_test)
+{
+  mystl::vector<int> v1{ 1,2,3 };
+  mystl::vector<int> v2{ 1,2,3,4 };
+  mystl::vector<int> v3{ 1,2 };
+  mystl::vector<int> v4{ 1,3 };
+  EXPECT_TRUE(v1 < v2);
+  EXPECT_TRUE(v3 < v1);
+  EXPECT_TRUE(v1 < v4);
+  EXPECT_TRUE(v4 > v2);
+  mystl::vector<int> v5(v1);
+  EXPECT_TRUE(v1 >= v5);
+  EXPECT_TRUE(v5 >= v1);
+  EXPECT_TRUE(v1 >= v3);
+}
+
+TEST(vector_resize_default_init_test)
+{
+  mystl::vector<int> v{ 1,2,3 };
+  v.resize_default_init(1000);
+  EXPECT_EQ(1000u, v.size());
+  EXPECT_EQ(3, v[2]);
+  for (size_t i = 3; i < v.size(); ++i)
+    v[i] = static_cast<int>(i);
+  EXPECT_EQ(999, v.back());
+  v.resize_default_init(2);
+  EXPECT_EQ(2u, v.size());
+  EXPECT_EQ(2, v.back());
+
+  // 非平凡的类型依然调用默认构造函数
+  mystl::vector<mystl::vector<int>> vv(2);
+  vv[0].push_back(1);
+  vv.resize_default_init(50);
+  EXPECT_EQ(50u, vv.size());
+  EXPECT_EQ(1u, vv[0].size());
+  EXPECT_TRUE(vv[49].empty());
+}
+
+// 反复把 count 字节的缓冲区扩到指定大小后整体覆盖，模拟 read() 或解压
+template <bool DefaultInit>
+void buffer_fill_test(size_t count)
+{
+  char buf[10];
+  static const size_t block = 1 << 20;
+  mystl::vector<char> src(block, 'x');
+  size_t sum = 0;
+  clock_t start = clock();
+  for (size_t done = 0; done < count; done += block)
+  {
+    mystl::vector<char> v;
+    if (DefaultInit)
+      v.resize_default_init(block);
+    else
+      v.resize(block);
+    std::memcpy(v.data(), src.data(), block);
+    sum += static_cast<size_t>(v[done & (block - 1)]);
+  }
+  clock_t end = clock();
+  volatile size_t sink = sum;
+  (void)sink;
+  int n = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+  std::snprintf(buf, sizeof(buf), "%d", n);
+  std::string t = buf;
+  t += "ms    |";
+  std::cout << std::setw(WIDE) << t;
+}
+
 void vector_test()
 {
   std::cout << "[===============================================================]\n";
@@ -100,6 +169,18 @@ void vector_test()
 #else
   CON_TEST_P1(vector<int>, push_back, rand(), SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
 #endif
+  std::cout << "\n";
+  std::cout << "|---------------------|-------------|-------------|-------------|\n";
+  std::cout << "| 1MB buffer (bytes)  |";
+  TEST_LEN(SCALE_LLL(LEN1), SCALE_LLL(LEN2), SCALE_LLL(LEN3), WIDE);
+  std::cout << "|        resize       |";
+  buffer_fill_test<false>(SCALE_LLL(LEN1));
+  buffer_fill_test<false>(SCALE_LLL(LEN2));
+  buffer_fill_test<false>(SCALE_LLL(LEN3));
+  std::cout << "\n| resize_default_init |";
+  buffer_fill_test<true>(SCALE_LLL(LEN1));
+  buffer_fill_test<true>(SCALE_LLL(LEN2));
+  buffer_fill_test<true>(SCALE_LLL(LEN3));
   std::cout << "\n";
   std::cout << "|---------------------|-------------|-------------|-------------|\n";
   PASSED;